@@ -17,6 +17,7 @@ set(CPP_FILES
   mitkPlaneFit.cpp
   mitkPlaneLandmarkProjector.cpp
   mitkPointLocator.cpp
+  mitkPointCloudKdTree.cpp
   mitkSegmentationSink.cpp
   mitkSimpleHistogram.cpp
   mitkSimpleUnstructuredGridHistogram.cpp
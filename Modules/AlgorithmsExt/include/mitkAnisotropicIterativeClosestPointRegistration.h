@@ -28,10 +28,10 @@ found in the LICENSE file.
 
 // forward declarations
 class vtkPoints;
-class vtkKdTreePointLocator;
 
 namespace mitk
 {
+  class PointCloudKdTree;
   class Surface;
   class WeightedPointTransform;
 
@@ -56,7 +56,8 @@ namespace mitk
     * vertices. In addition vtkCleanPolyData can be used to ensure a correct
     * Surface representation.
     *
-    * \note The correspondence search is accelerated when OpenMP is enabled.
+    * \note The correspondence search runs in parallel on the number of threads set by
+    * SetNumberOfThreads() (all available threads by default).
     *
     * \b Example:
     *
@@ -156,6 +157,12 @@ namespace mitk
     /** Amount of iterations used by the algorithm.*/
     unsigned int m_NumberOfIterations;
 
+    /** Tolerance of the transformation update for early termination. Default is 0 (disabled).*/
+    double m_TransformTolerance;
+
+    /** Number of threads of the correspondence search. Default is 0 (all available threads).*/
+    unsigned int m_NumberOfThreads;
+
     /** Moving surface that is transformed on the fixed surface.*/
     itk::SmartPointer<Surface> m_MovingSurface;
     /** The fixed / target surface.*/
@@ -184,7 +191,7 @@ namespace mitk
       * the help of a kd tree. The correspondences are searched in a given radius
       * in the euklidian space. Every correspondence found in this radius is
       * weighted based on the covariance matrices and the best weighting will be
-      * used as a correspondence.
+      * used as a correspondence. The moving points are processed in parallel.
       *
       * @param X The moving point set.
       * @param Z The returned correspondences from the fixed point set.
@@ -199,7 +206,7 @@ namespace mitk
       */
     void ComputeCorrespondences(vtkPoints *X,
                                 vtkPoints *Z,
-                                vtkKdTreePointLocator *Y,
+                                const PointCloudKdTree *Y,
                                 const CovarianceMatrixList &sigma_X,
                                 const CovarianceMatrixList &sigma_Y,
                                 CovarianceMatrixList &sigma_Z,
@@ -245,6 +252,20 @@ namespace mitk
       /** Get the number of iterations used by the algorithm.*/
       itkGetMacro(NumberOfIterations, unsigned int);
 
+      /**
+        * Early termination: the algorithm stops as soon as an iteration changes the
+        * transformation by less than the tolerance, measured as the Frobenius norm of
+        * the difference of the rotation update to the identity plus the length of the
+        * translation update. This saves the last iterations, in which the FRE only
+        * changes marginally. The default value 0.0 disables early termination.
+        */
+      itkSetMacro(TransformTolerance, double);
+      itkGetConstMacro(TransformTolerance, double);
+
+      /** Set the number of threads of the correspondence search. 0 (default) uses all available threads.*/
+      itkSetMacro(NumberOfThreads, unsigned int);
+      itkGetConstMacro(NumberOfThreads, unsigned int);
+
       /**
         * Factor that trimms the point set in percent for
         * partial overlapping surfaces. E.g. 0.4 will use 40 precent
@@ -0,0 +1,131 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkPointCloudKdTree_h
+#define mitkPointCloudKdTree_h
+
+#include "MitkAlgorithmsExtExports.h"
+#include <mitkCommon.h>
+
+#include <itkObject.h>
+#include <vtkType.h>
+
+#include <vector>
+
+class vtkPoints;
+
+namespace mitk
+{
+  /**
+   * \ingroup AnisotropicRegistration
+   *
+   * @brief Kd tree for radius and k nearest neighbour queries on a static point cloud.
+   *
+   * The points are copied into contiguous arrays in tree order when SetPoints() is called. All queries are
+   * const, do not allocate memory apart from growing the result buffers passed by the caller and can be run
+   * concurrently from any number of threads. Thus, a thread that reuses its result buffers for many queries
+   * runs without any allocation.
+   *
+   * In contrast to the ANN based PointLocator, which keeps the search state in global variables, the tree is
+   * reentrant.
+   */
+  class MITKALGORITHMSEXT_EXPORT PointCloudKdTree : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(PointCloudKdTree, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef vtkIdType IdType;
+    typedef std::vector<IdType> IdList;
+
+    /**
+     * Copies the points and builds the tree. Ids of query results are the ids of the points in @a points.
+     */
+    void SetPoints(vtkPoints *points);
+
+    /**
+     * Copies the points of the contiguous array @a coordinates (x0, y0, z0, x1, ...) and builds the tree.
+     */
+    void SetPoints(const double *coordinates, IdType numberOfPoints);
+
+    IdType GetNumberOfPoints() const { return static_cast<IdType>(m_Ids.size()); }
+
+    /** Returns the coordinates of the point with the given id.*/
+    const double *GetPoint(IdType id) const { return &m_Coordinates[3 * id]; }
+
+    /**
+     * Finds all points whose distance to @a point is not larger than @a radius.
+     * @param point The query point.
+     * @param radius The search radius.
+     * @param result Cleared and filled with the ids of the points found, in no particular order.
+     */
+    void FindPointsWithinRadius(const double point[3], double radius, IdList &result) const;
+
+    /**
+     * Finds the @a k nearest points of @a point, ordered by increasing distance. If the tree contains less
+     * than @a k points, all points are returned.
+     * @param point The query point.
+     * @param k The number of neighbours.
+     * @param ids Ids of the neighbours.
+     * @param squaredDistances Squared distances of the neighbours.
+     */
+    void FindKNearestPoints(const double point[3],
+                            unsigned int k,
+                            IdList &ids,
+                            std::vector<double> &squaredDistances) const;
+
+    /**
+     * Finds the @a k nearest points of every point of the contiguous array @a points in parallel.
+     *
+     * The neighbours of the i-th query point are stored at positions i * k to i * k + k - 1 of @a ids and
+     * @a squaredDistances, ordered by increasing distance. Unused positions (if the tree contains less than
+     * @a k points) are filled with -1 and infinity.
+     *
+     * @param numberOfThreads Number of threads, 0 means the OpenMP default.
+     */
+    void FindKNearestPoints(const double *points,
+                            IdType numberOfPoints,
+                            unsigned int k,
+                            IdList &ids,
+                            std::vector<double> &squaredDistances,
+                            unsigned int numberOfThreads = 0) const;
+
+  protected:
+    PointCloudKdTree();
+    ~PointCloudKdTree() override;
+
+    /** Maximum number of points in a leaf.*/
+    static const IdType LeafSize = 16;
+
+    /** Node of the tree. Leaves have the axis 3, the children of inner nodes are stored next to each other.*/
+    struct Node
+    {
+      double split;
+      IdType begin;
+      IdType end;
+      IdType children;
+      unsigned int axis;
+    };
+
+    void BuildNode(std::size_t nodeIndex, IdType begin, IdType end);
+
+    /** Coordinates of the points in the order of their ids.*/
+    std::vector<double> m_Coordinates;
+    /** Coordinates of the points in tree order.*/
+    std::vector<double> m_TreeCoordinates;
+    /** Ids of the points in tree order.*/
+    IdList m_Ids;
+    std::vector<Node> m_Nodes;
+  };
+}
+
+#endif
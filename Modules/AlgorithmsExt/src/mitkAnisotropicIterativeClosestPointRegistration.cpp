@@ -13,18 +13,23 @@ found in the LICENSE file.
 // MITK
 #include "mitkAnisotropicIterativeClosestPointRegistration.h"
 #include "mitkAnisotropicRegistrationCommon.h"
+#include "mitkPointCloudKdTree.h"
 #include "mitkWeightedPointTransform.h"
 #include <mitkProgressBar.h>
 #include <mitkSurface.h>
 // VTK
-#include <vtkIdList.h>
-#include <vtkKdTree.h>
-#include <vtkKdTreePointLocator.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
-// STL pair
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <utility>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /** \brief Comperator implementation used to sort the CorrespondenceList in the
   *        trimmed version of the AnisotropicIterativeClosestPointRegistration.
   */
@@ -35,6 +40,45 @@ struct AICPComperator
   bool operator()(const Correspondence &a, const Correspondence &b) { return (a.second < b.second); }
 } AICPComp;
 
+namespace
+{
+  /**
+    * Squared distance of x and y weighted with the weight matrix W of the covariance
+    * matrices (see AnisotropicRegistrationCommon::CalculateWeightMatrix()). Since
+    * W = (sigma_X + sigma_Y)^(-1/2) is symmetric, |W (x - y)|^2 equals
+    * (x - y)^T (sigma_X + sigma_Y)^(-1) (x - y), which is computed by the closed
+    * form inverse of the symmetric 3x3 matrix instead of a singular value decomposition.
+    */
+  inline double WeightedSquaredDistance(const itk::Matrix<double, 3, 3> &sigma_X,
+                                        const itk::Matrix<double, 3, 3> &sigma_Y,
+                                        const double *x,
+                                        const double *y)
+  {
+    const double a = sigma_X[0][0] + sigma_Y[0][0];
+    const double b = sigma_X[0][1] + sigma_Y[0][1];
+    const double c = sigma_X[0][2] + sigma_Y[0][2];
+    const double d = sigma_X[1][1] + sigma_Y[1][1];
+    const double e = sigma_X[1][2] + sigma_Y[1][2];
+    const double f = sigma_X[2][2] + sigma_Y[2][2];
+
+    // cofactors
+    const double A = d * f - e * e;
+    const double B = c * e - b * f;
+    const double C = b * e - c * d;
+    const double D = a * f - c * c;
+    const double E = b * c - a * e;
+    const double F = a * d - b * b;
+
+    const double det = a * A + b * B + c * C;
+
+    const double v0 = x[0] - y[0];
+    const double v1 = x[1] - y[1];
+    const double v2 = x[2] - y[2];
+
+    return (A * v0 * v0 + D * v1 * v1 + F * v2 * v2 + 2.0 * (B * v0 * v1 + C * v0 * v2 + E * v1 * v2)) / det;
+  }
+}
+
 mitk::AnisotropicIterativeClosestPointRegistration::AnisotropicIterativeClosestPointRegistration()
   : m_MaxIterations(1000),
     m_Threshold(0.000001),
@@ -44,6 +88,8 @@ mitk::AnisotropicIterativeClosestPointRegistration::AnisotropicIterativeClosestP
     m_FRE(0.0),
     m_TrimmFactor(0.0),
     m_NumberOfIterations(0),
+    m_TransformTolerance(0.0),
+    m_NumberOfThreads(0),
     m_MovingSurface(nullptr),
     m_FixedSurface(nullptr),
     m_WeightedPointTransform(mitk::WeightedPointTransform::New())
@@ -56,75 +102,65 @@ mitk::AnisotropicIterativeClosestPointRegistration::~AnisotropicIterativeClosest
 
 void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(vtkPoints *X,
                                                                                 vtkPoints *Z,
-                                                                                vtkKdTreePointLocator *Y,
+                                                                                const PointCloudKdTree *Y,
                                                                                 const CovarianceMatrixList &sigma_X,
                                                                                 const CovarianceMatrixList &sigma_Y,
                                                                                 CovarianceMatrixList &sigma_Z,
                                                                                 CorrespondenceList &correspondences,
                                                                                 const double radius)
 {
-  typedef itk::Matrix<double, 3, 3> WeightMatrix;
+  const int numberOfPoints = static_cast<int>(X->GetNumberOfPoints());
+  std::vector<vtkIdType> bestIds(numberOfPoints);
+
+#ifdef _OPENMP
+  const int threads = m_NumberOfThreads > 0 ? static_cast<int>(m_NumberOfThreads) : omp_get_max_threads();
+#endif
 
-#pragma omp parallel for
-  for (int i = 0; i < X->GetNumberOfPoints(); ++i)
+#pragma omp parallel num_threads(threads)
   {
-    vtkIdType bestIdx = 0;
-    mitk::Vector3D x;
-    mitk::Vector3D y;
-    double bestDist = std::numeric_limits<double>::max();
-    vtkIdList *ids = vtkIdList::New();
-    double r = radius;
-    double p[3];
-    // get point
-    X->GetPoint(i, p);
-    // fill vector
-    x[0] = p[0];
-    x[1] = p[1];
-    x[2] = p[2];
-
-    // double the radius till we find at least one point
-    while (ids->GetNumberOfIds() <= 0)
-    {
-      Y->FindPointsWithinRadius(r, p, ids);
-      r *= 2.0;
-    }
+    // candidates of the radius search, reused for all points of this thread
+    PointCloudKdTree::IdList ids;
 
-    // loop over the points in the sphere and find the point with the
-    // minimal weighted squared distance
-    for (vtkIdType j = 0; j < ids->GetNumberOfIds(); ++j)
+#pragma omp for schedule(dynamic, 256)
+    for (int i = 0; i < numberOfPoints; ++i)
     {
-      // get id
-      const vtkIdType id = ids->GetId(j);
-      // compute weightmatrix
-      WeightMatrix m = mitk::AnisotropicRegistrationCommon::CalculateWeightMatrix(sigma_X[i], sigma_Y[id]);
-      // point of the fixed data set
-      Y->GetDataSet()->GetPoint(id, p);
-
-      // fill mitk vector
-      y[0] = p[0];
-      y[1] = p[1];
-      y[2] = p[2];
-
-      const mitk::Vector3D res = m * (x - y);
-
-      const double dist = res[0] * res[0] + res[1] * res[1] + res[2] * res[2];
+      vtkIdType bestIdx = 0;
+      double bestDist = std::numeric_limits<double>::max();
+      double r = radius;
+      double x[3];
+      // get point
+      X->GetPoint(i, x);
+
+      // double the radius till we find at least one point
+      do
+      {
+        Y->FindPointsWithinRadius(x, r, ids);
+        r *= 2.0;
+      } while (ids.empty());
 
-      if (dist < bestDist)
+      // loop over the points in the sphere and find the point with the
+      // minimal weighted squared distance
+      for (const auto id : ids)
       {
-        bestDist = dist;
-        bestIdx = id;
-      }
-    }
+        const double dist = WeightedSquaredDistance(sigma_X[i], sigma_Y[id], x, Y->GetPoint(id));
 
-    // save correspondences of the fixed point set
-    Y->GetDataSet()->GetPoint(bestIdx, p);
-    Z->SetPoint(i, p);
-    sigma_Z[i] = sigma_Y[bestIdx];
+        if (dist < bestDist)
+        {
+          bestDist = dist;
+          bestIdx = id;
+        }
+      }
 
-    Correspondence _pair(i, bestDist);
-    correspondences[i] = _pair;
+      bestIds[i] = bestIdx;
+      correspondences[i] = Correspondence(i, bestDist);
+    }
+  }
 
-    ids->Delete();
+  // save correspondences of the fixed point set
+  for (int i = 0; i < numberOfPoints; ++i)
+  {
+    Z->SetPoint(i, Y->GetPoint(bestIds[i]));
+    sigma_Z[i] = sigma_Y[bestIds[i]];
   }
 }
 
@@ -133,6 +169,7 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
   unsigned int k = 0;
   unsigned int numberOfTrimmedPoints = 0;
   double diff = 0.0;
+  bool converged = false;
   double FRE_new = std::numeric_limits<double>::max();
   // Moving pointset
   vtkPoints *X = vtkPoints::New();
@@ -156,9 +193,13 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
   CovarianceMatrixList Sigma_Z_sorted;
 
   // create kdtree for correspondence search
-  vtkKdTreePointLocator *Y = vtkKdTreePointLocator::New();
-  Y->SetDataSet(m_FixedSurface->GetVtkPolyData());
-  Y->BuildLocator();
+  PointCloudKdTree::Pointer Y = PointCloudKdTree::New();
+  Y->SetPoints(m_FixedSurface->GetVtkPolyData()->GetPoints());
+
+  if (Y->GetNumberOfPoints() == 0)
+  {
+    mitkThrow() << "The fixed surface does not contain any points.";
+  }
 
   // initialize local variables
   // copy the moving pointset to prevent to modify it
@@ -220,7 +261,14 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
       // distance, if trimming is enabled
       if (m_TrimmFactor > 0.0)
       {
-        std::sort(distanceList.begin(), distanceList.end(), AICPComp);
+        // only the best correspondences are needed, their order does not matter
+        if (numberOfTrimmedPoints < distanceList.size())
+        {
+          std::nth_element(distanceList.begin(),
+                           distanceList.begin() + numberOfTrimmedPoints,
+                           distanceList.end(),
+                           AICPComp);
+        }
         // map correspondences to the data arrays
         for (unsigned int i = 0; i < numberOfTrimmedPoints; ++i)
         {
@@ -281,6 +329,24 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
     // update FRE
     m_FRE = FRE_new;
 
+    // early termination if the transformation hardly changes anymore
+    if (m_TransformTolerance > 0.0)
+    {
+      double change = 0.0;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+          const double delta = RotationNew[i][j] - (i == j ? 1.0 : 0.0);
+          change += delta * delta;
+        }
+      }
+      change = std::sqrt(change) + TranslationNew.GetNorm();
+
+      converged = change < m_TransformTolerance;
+      MITK_DEBUG << "transform change:" << change;
+    }
+
     // update the progressbar. Just use the half every 2nd iteration
     // to use a simulated endless progress bar since we don't have
     // a fixed amount of iterations
@@ -288,7 +354,7 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
     stepSize = (stepSize == 0) ? 1 : stepSize;
     mitk::ProgressBar::GetInstance()->Progress(stepSize);
 
-  } while (diff > m_Threshold && k < m_MaxIterations);
+  } while (diff > m_Threshold && k < m_MaxIterations && !converged);
 
   m_NumberOfIterations = k;
 
@@ -298,7 +364,6 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
     mitk::ProgressBar::GetInstance()->Progress(steps);
 
   // free memory
-  Y->Delete();
   Z->Delete();
   X->Delete();
   X_sorted->Delete();
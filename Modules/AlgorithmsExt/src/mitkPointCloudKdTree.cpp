@@ -0,0 +1,355 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkPointCloudKdTree.h"
+
+#include <mitkExceptionMacro.h>
+
+#include <vtkPoints.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+  /** The tree is balanced, thus 128 levels suffice for any number of points.*/
+  const unsigned int MaximumDepth = 128;
+
+  inline double SquaredDistance(const double *a, const double *b)
+  {
+    const double dx = a[0] - b[0];
+    const double dy = a[1] - b[1];
+    const double dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+  }
+
+  /** Max heap of the k best candidates, kept in the result arrays of a query.*/
+  class NeighbourHeap
+  {
+  public:
+    NeighbourHeap(unsigned int k, mitk::PointCloudKdTree::IdType *ids, double *squaredDistances)
+      : m_K(k), m_Size(0), m_Ids(ids), m_SquaredDistances(squaredDistances)
+    {
+    }
+
+    double GetWorstSquaredDistance() const
+    {
+      return m_Size < m_K ? std::numeric_limits<double>::infinity() : m_SquaredDistances[0];
+    }
+
+    void Insert(mitk::PointCloudKdTree::IdType id, double squaredDistance)
+    {
+      if (m_Size < m_K)
+      {
+        // sift up
+        unsigned int i = m_Size++;
+        while (i > 0)
+        {
+          const unsigned int parent = (i - 1) / 2;
+          if (m_SquaredDistances[parent] >= squaredDistance)
+            break;
+          m_Ids[i] = m_Ids[parent];
+          m_SquaredDistances[i] = m_SquaredDistances[parent];
+          i = parent;
+        }
+        m_Ids[i] = id;
+        m_SquaredDistances[i] = squaredDistance;
+      }
+      else if (squaredDistance < m_SquaredDistances[0])
+      {
+        // replace the root and sift down
+        unsigned int i = 0;
+        for (;;)
+        {
+          unsigned int child = 2 * i + 1;
+          if (child >= m_Size)
+            break;
+          if (child + 1 < m_Size && m_SquaredDistances[child + 1] > m_SquaredDistances[child])
+            ++child;
+          if (m_SquaredDistances[child] <= squaredDistance)
+            break;
+          m_Ids[i] = m_Ids[child];
+          m_SquaredDistances[i] = m_SquaredDistances[child];
+          i = child;
+        }
+        m_Ids[i] = id;
+        m_SquaredDistances[i] = squaredDistance;
+      }
+    }
+
+    /** Sorts the candidates by increasing distance and returns their number.*/
+    unsigned int Sort()
+    {
+      // heap sort in place: repeatedly move the largest candidate behind the heap
+      for (unsigned int size = m_Size; size > 1; --size)
+      {
+        const auto id = m_Ids[size - 1];
+        const double squaredDistance = m_SquaredDistances[size - 1];
+        m_Ids[size - 1] = m_Ids[0];
+        m_SquaredDistances[size - 1] = m_SquaredDistances[0];
+
+        unsigned int i = 0;
+        for (;;)
+        {
+          unsigned int child = 2 * i + 1;
+          if (child >= size - 1)
+            break;
+          if (child + 1 < size - 1 && m_SquaredDistances[child + 1] > m_SquaredDistances[child])
+            ++child;
+          if (m_SquaredDistances[child] <= squaredDistance)
+            break;
+          m_Ids[i] = m_Ids[child];
+          m_SquaredDistances[i] = m_SquaredDistances[child];
+          i = child;
+        }
+        m_Ids[i] = id;
+        m_SquaredDistances[i] = squaredDistance;
+      }
+      return m_Size;
+    }
+
+  private:
+    unsigned int m_K;
+    unsigned int m_Size;
+    mitk::PointCloudKdTree::IdType *m_Ids;
+    double *m_SquaredDistances;
+  };
+}
+
+mitk::PointCloudKdTree::PointCloudKdTree()
+{
+}
+
+mitk::PointCloudKdTree::~PointCloudKdTree()
+{
+}
+
+void mitk::PointCloudKdTree::SetPoints(vtkPoints *points)
+{
+  if (nullptr == points)
+    mitkThrow() << "No points given to the kd tree.";
+
+  const IdType numberOfPoints = points->GetNumberOfPoints();
+  std::vector<double> coordinates(3 * numberOfPoints);
+
+  for (IdType i = 0; i < numberOfPoints; ++i)
+    points->GetPoint(i, &coordinates[3 * i]);
+
+  this->SetPoints(coordinates.data(), numberOfPoints);
+}
+
+void mitk::PointCloudKdTree::SetPoints(const double *coordinates, IdType numberOfPoints)
+{
+  m_Coordinates.assign(coordinates, coordinates + 3 * numberOfPoints);
+
+  m_Ids.resize(numberOfPoints);
+  std::iota(m_Ids.begin(), m_Ids.end(), IdType(0));
+
+  m_Nodes.clear();
+  m_Nodes.reserve(2 * (numberOfPoints / LeafSize + 1));
+  m_Nodes.resize(1);
+  this->BuildNode(0, 0, numberOfPoints);
+
+  m_TreeCoordinates.resize(3 * numberOfPoints);
+  for (IdType i = 0; i < numberOfPoints; ++i)
+    std::copy_n(&m_Coordinates[3 * m_Ids[i]], 3, &m_TreeCoordinates[3 * i]);
+
+  this->Modified();
+}
+
+void mitk::PointCloudKdTree::BuildNode(std::size_t nodeIndex, IdType begin, IdType end)
+{
+  Node node;
+  node.split = 0.0;
+  node.begin = begin;
+  node.end = end;
+  node.children = 0;
+  node.axis = 3;
+
+  if (end - begin > LeafSize)
+  {
+    // split along the axis of the largest extent at the median
+    double lower[3] = {std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::max()};
+    double upper[3] = {std::numeric_limits<double>::lowest(),
+                       std::numeric_limits<double>::lowest(),
+                       std::numeric_limits<double>::lowest()};
+
+    for (IdType i = begin; i < end; ++i)
+    {
+      const double *p = &m_Coordinates[3 * m_Ids[i]];
+      for (unsigned int d = 0; d < 3; ++d)
+      {
+        lower[d] = std::min(lower[d], p[d]);
+        upper[d] = std::max(upper[d], p[d]);
+      }
+    }
+
+    unsigned int axis = 0;
+    for (unsigned int d = 1; d < 3; ++d)
+    {
+      if (upper[d] - lower[d] > upper[axis] - lower[axis])
+        axis = d;
+    }
+
+    const IdType middle = begin + (end - begin) / 2;
+    std::nth_element(m_Ids.begin() + begin,
+                     m_Ids.begin() + middle,
+                     m_Ids.begin() + end,
+                     [this, axis](IdType a, IdType b) {
+                       return m_Coordinates[3 * a + axis] < m_Coordinates[3 * b + axis];
+                     });
+
+    node.axis = axis;
+    node.split = m_Coordinates[3 * m_Ids[middle] + axis];
+    node.children = static_cast<IdType>(m_Nodes.size());
+
+    m_Nodes.resize(m_Nodes.size() + 2);
+    m_Nodes[nodeIndex] = node;
+
+    this->BuildNode(node.children, begin, middle);
+    this->BuildNode(node.children + 1, middle, end);
+  }
+  else
+  {
+    m_Nodes[nodeIndex] = node;
+  }
+}
+
+void mitk::PointCloudKdTree::FindPointsWithinRadius(const double point[3], double radius, IdList &result) const
+{
+  result.clear();
+
+  if (m_Nodes.empty() || m_Ids.empty())
+    return;
+
+  const double squaredRadius = radius * radius;
+
+  IdType stack[MaximumDepth];
+  unsigned int stackSize = 0;
+  stack[stackSize++] = 0;
+
+  while (stackSize > 0)
+  {
+    const Node &node = m_Nodes[stack[--stackSize]];
+
+    if (3 == node.axis)
+    {
+      for (IdType i = node.begin; i < node.end; ++i)
+      {
+        if (SquaredDistance(point, &m_TreeCoordinates[3 * i]) <= squaredRadius)
+          result.push_back(m_Ids[i]);
+      }
+      continue;
+    }
+
+    // points equal to the split value may be in both children
+    if (point[node.axis] - radius <= node.split)
+      stack[stackSize++] = node.children;
+    if (point[node.axis] + radius >= node.split)
+      stack[stackSize++] = node.children + 1;
+  }
+}
+
+void mitk::PointCloudKdTree::FindKNearestPoints(const double point[3],
+                                                unsigned int k,
+                                                IdList &ids,
+                                                std::vector<double> &squaredDistances) const
+{
+  k = static_cast<unsigned int>(std::min<IdType>(k, this->GetNumberOfPoints()));
+  ids.resize(k);
+  squaredDistances.resize(k);
+
+  if (0 == k)
+    return;
+
+  NeighbourHeap heap(k, ids.data(), squaredDistances.data());
+
+  struct Entry
+  {
+    IdType node;
+    double squaredDistance;
+  };
+
+  Entry stack[MaximumDepth];
+  unsigned int stackSize = 0;
+  stack[stackSize++] = {0, 0.0};
+
+  while (stackSize > 0)
+  {
+    const Entry entry = stack[--stackSize];
+    if (entry.squaredDistance > heap.GetWorstSquaredDistance())
+      continue;
+
+    const Node &node = m_Nodes[entry.node];
+
+    if (3 == node.axis)
+    {
+      for (IdType i = node.begin; i < node.end; ++i)
+        heap.Insert(m_Ids[i], SquaredDistance(point, &m_TreeCoordinates[3 * i]));
+      continue;
+    }
+
+    // descend into the child of the query point first, the other one is pruned by the distance to the plane
+    const double difference = point[node.axis] - node.split;
+    const IdType nearChild = difference < 0.0 ? node.children : node.children + 1;
+    const IdType farChild = difference < 0.0 ? node.children + 1 : node.children;
+
+    stack[stackSize++] = {farChild, std::max(entry.squaredDistance, difference * difference)};
+    stack[stackSize++] = {nearChild, entry.squaredDistance};
+  }
+
+  heap.Sort();
+}
+
+void mitk::PointCloudKdTree::FindKNearestPoints(const double *points,
+                                                IdType numberOfPoints,
+                                                unsigned int k,
+                                                IdList &ids,
+                                                std::vector<double> &squaredDistances,
+                                                unsigned int numberOfThreads) const
+{
+  ids.assign(numberOfPoints * k, -1);
+  squaredDistances.assign(numberOfPoints * k, std::numeric_limits<double>::infinity());
+
+  if (0 == k || m_Ids.empty())
+    return;
+
+  const int numberOfQueries = static_cast<int>(numberOfPoints);
+
+#ifdef _OPENMP
+  const int threads = numberOfThreads > 0 ? static_cast<int>(numberOfThreads) : omp_get_max_threads();
+#endif
+
+#pragma omp parallel num_threads(threads)
+  {
+    // result buffers of this thread, reused for all of its queries
+    IdList neighbourIds;
+    std::vector<double> neighbourDistances;
+
+#pragma omp for schedule(dynamic, 256)
+    for (int i = 0; i < numberOfQueries; ++i)
+    {
+      this->FindKNearestPoints(points + 3 * i, k, neighbourIds, neighbourDistances);
+      std::copy(neighbourIds.begin(), neighbourIds.end(), ids.begin() + static_cast<std::size_t>(i) * k);
+      std::copy(neighbourDistances.begin(),
+                neighbourDistances.end(),
+                squaredDistances.begin() + static_cast<std::size_t>(i) * k);
+    }
+  }
+}
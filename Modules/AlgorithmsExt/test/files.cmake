@@ -6,6 +6,7 @@ set(MODULE_TESTS
   mitkSimpleHistogramTest.cpp
   mitkCovarianceMatrixCalculatorTest.cpp
   mitkAnisotropicIterativeClosestPointRegistrationTest.cpp
+  mitkPointCloudKdTreeTest.cpp
   mitkUnstructuredGridClusteringFilterTest.cpp
   mitkUnstructuredGridToUnstructuredGridFilterTest.cpp
   mitkCropTimestepsImageFilterTest.cpp
@@ -14,3 +15,9 @@ set(MODULE_TESTS
 set(MODULE_CUSTOM_TESTS
   mitkLabeledImageToSurfaceFilterTest.cpp
 )
+
+# Benchmarks are built into the test driver, but not registered with ctest.
+# Run them explicitly, e.g. MitkAlgorithmsExtTestDriver mitkAnisotropicIterativeClosestPointRegistrationBenchmarkTest
+set(MODULE_CUSTOM_TESTS ${MODULE_CUSTOM_TESTS}
+  mitkAnisotropicIterativeClosestPointRegistrationBenchmarkTest.cpp
+)
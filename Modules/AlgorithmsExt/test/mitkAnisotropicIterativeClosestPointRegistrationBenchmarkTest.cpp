@@ -0,0 +1,161 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Benchmark, not part of the ctest set. Run it explicitly:
+//   MitkAlgorithmsExtTestDriver mitkAnisotropicIterativeClosestPointRegistrationBenchmarkTest
+
+#include <mitkSurface.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+#include <vtkCleanPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTransformPolyDataFilter.h>
+#include <vtkTransform.h>
+
+#include <chrono>
+#include <cmath>
+
+#include "mitkAnisotropicIterativeClosestPointRegistration.h"
+#include "mitkCovarianceMatrixCalculator.h"
+
+/**
+ * Reports the run time of A-ICP on one and on all threads and the number of iterations
+ * with and without early termination, on the synthetic surfaces of
+ * mitkAnisotropicIterativeClosestPointRegistrationTest.
+ */
+class mitkAnisotropicIterativeClosestPointRegistrationBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkAnisotropicIterativeClosestPointRegistrationBenchmarkTestSuite);
+  MITK_TEST(Threads);
+  MITK_TEST(EarlyTermination);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Matrix<double, 3, 3> Matrix3x3;
+  typedef std::vector<Matrix3x3> CovarianceMatrixList;
+
+  /** A deformed ellipsoid without symmetries with 2 * resolution * resolution vertices.*/
+  static mitk::Surface::Pointer CreateSyntheticSurface(unsigned int resolution)
+  {
+    auto sphere = vtkSmartPointer<vtkSphereSource>::New();
+    sphere->SetRadius(1.0);
+    sphere->SetThetaResolution(2 * resolution);
+    sphere->SetPhiResolution(resolution);
+    sphere->Update();
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->DeepCopy(sphere->GetOutput());
+
+    vtkPoints *points = polyData->GetPoints();
+    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+      double p[3];
+      points->GetPoint(i, p);
+      const double factor = 1.0 + 0.15 * p[0] * p[1] + 0.05 * std::sin(4.0 * p[2]) + 0.05 * p[0];
+      points->SetPoint(i, 60.0 * factor * p[0], 40.0 * factor * p[1], 30.0 * factor * p[2]);
+    }
+
+    auto cleaner = vtkSmartPointer<vtkCleanPolyData>::New();
+    cleaner->SetInputData(polyData);
+    cleaner->Update();
+
+    auto surface = mitk::Surface::New();
+    surface->SetVtkPolyData(cleaner->GetOutput());
+    return surface;
+  }
+
+  static mitk::Surface::Pointer CreateTransformedSurface(const mitk::Surface *surface)
+  {
+    auto transform = vtkSmartPointer<vtkTransform>::New();
+    transform->Translate(2.0, -1.5, 3.0);
+    transform->RotateWXYZ(6.0, 1.0, 1.0, 0.5);
+
+    auto filter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+    filter->SetInputData(surface->GetVtkPolyData());
+    filter->SetTransform(transform);
+    filter->Update();
+
+    auto result = mitk::Surface::New();
+    result->SetVtkPolyData(filter->GetOutput());
+    return result;
+  }
+
+  static mitk::AnisotropicIterativeClosestPointRegistration::Pointer CreateRegistration(mitk::Surface *moving,
+                                                                                        mitk::Surface *fixed)
+  {
+    mitk::CovarianceMatrixCalculator::Pointer matrixCalculator = mitk::CovarianceMatrixCalculator::New();
+
+    matrixCalculator->SetInputSurface(moving);
+    matrixCalculator->ComputeCovarianceMatrices();
+    CovarianceMatrixList sigmasMoving = matrixCalculator->GetCovarianceMatrices();
+    const double meanVarX = matrixCalculator->GetMeanVariance();
+
+    matrixCalculator->SetInputSurface(fixed);
+    matrixCalculator->ComputeCovarianceMatrices();
+    CovarianceMatrixList sigmasFixed = matrixCalculator->GetCovarianceMatrices();
+    const double meanVarY = matrixCalculator->GetMeanVariance();
+
+    auto aICP = mitk::AnisotropicIterativeClosestPointRegistration::New();
+    aICP->SetMovingSurface(moving);
+    aICP->SetFixedSurface(fixed);
+    aICP->SetCovarianceMatricesMovingSurface(sigmasMoving);
+    aICP->SetCovarianceMatricesFixedSurface(sigmasFixed);
+    aICP->SetFRENormalizationFactor(sqrt(meanVarX + meanVarY));
+    aICP->SetThreshold(0.000001);
+    aICP->SetSearchRadius(10.0);
+    return aICP;
+  }
+
+public:
+  void Threads()
+  {
+    auto moving = CreateSyntheticSurface(100);
+    auto fixed = CreateTransformedSurface(moving);
+
+    double times[2];
+    const unsigned int numberOfThreads[2] = {1, 0};
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      auto aICP = CreateRegistration(moving, fixed);
+      aICP->SetMaxIterations(5);
+      aICP->SetNumberOfThreads(numberOfThreads[i]);
+
+      const auto start = std::chrono::steady_clock::now();
+      aICP->Update();
+      times[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    MITK_INFO << "5 A-ICP iterations on " << moving->GetVtkPolyData()->GetNumberOfPoints()
+              << " points: " << times[0] << " ms on one thread, " << times[1] << " ms on all threads";
+  }
+
+  void EarlyTermination()
+  {
+    auto moving = CreateSyntheticSurface(40);
+    auto fixed = CreateTransformedSurface(moving);
+
+    auto aICP = CreateRegistration(moving, fixed);
+    aICP->Update();
+
+    auto earlyAICP = CreateRegistration(moving, fixed);
+    earlyAICP->SetTransformTolerance(1e-3);
+    earlyAICP->Update();
+
+    MITK_INFO << "A-ICP on " << moving->GetVtkPolyData()->GetNumberOfPoints() << " points: "
+              << aICP->GetNumberOfIterations() << " iterations (FRE " << aICP->GetFRE() << "), with early termination "
+              << earlyAICP->GetNumberOfIterations() << " iterations (FRE " << earlyAICP->GetFRE() << ")";
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkAnisotropicIterativeClosestPointRegistrationBenchmark)
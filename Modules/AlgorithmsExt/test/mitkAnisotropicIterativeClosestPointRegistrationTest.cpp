@@ -15,22 +15,31 @@ found in the LICENSE file.
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 #include <vtkCleanPolyData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkTransform.h>
 
+#include <cmath>
+
 #include "mitkAnisotropicIterativeClosestPointRegistration.h"
 #include "mitkAnisotropicRegistrationCommon.h"
 #include "mitkCovarianceMatrixCalculator.h"
 
 /**
  * Test to verify the results of the A-ICP registration.
- * The test runs the standard A-ICP and the trimmed variant.
+ * The test runs the standard A-ICP and the trimmed variant, as well as
+ * registrations of synthetic surfaces with a known transformation.
  */
 class mitkAnisotropicIterativeClosestPointRegistrationTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkAnisotropicIterativeClosestPointRegistrationTestSuite);
   MITK_TEST(testAicpRegistration);
   MITK_TEST(testTrimmedAicpregistration);
+  MITK_TEST(testParallelAicpRegistrationIsDeterministic);
+  MITK_TEST(testSyntheticSurfaceWithKnownTransform);
+  MITK_TEST(testEarlyTermination);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -49,6 +58,101 @@ private:
 
   double m_FRENormalizationFactor;
 
+  /**
+   * Creates a closed surface without symmetries: a deformed ellipsoid with
+   * 2 * resolution * resolution vertices.
+   */
+  static mitk::Surface::Pointer CreateSyntheticSurface(unsigned int resolution)
+  {
+    auto sphere = vtkSmartPointer<vtkSphereSource>::New();
+    sphere->SetRadius(1.0);
+    sphere->SetThetaResolution(2 * resolution);
+    sphere->SetPhiResolution(resolution);
+    sphere->Update();
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->DeepCopy(sphere->GetOutput());
+
+    vtkPoints *points = polyData->GetPoints();
+    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+      double p[3];
+      points->GetPoint(i, p);
+      const double factor = 1.0 + 0.15 * p[0] * p[1] + 0.05 * std::sin(4.0 * p[2]) + 0.05 * p[0];
+      points->SetPoint(i, 60.0 * factor * p[0], 40.0 * factor * p[1], 30.0 * factor * p[2]);
+    }
+
+    auto cleaner = vtkSmartPointer<vtkCleanPolyData>::New();
+    cleaner->SetInputData(polyData);
+    cleaner->Update();
+
+    auto surface = mitk::Surface::New();
+    surface->SetVtkPolyData(cleaner->GetOutput());
+    return surface;
+  }
+
+  /** Returns a rigid transformation of 6 degrees and about 4 mm.*/
+  static vtkSmartPointer<vtkTransform> CreateKnownTransform()
+  {
+    auto transform = vtkSmartPointer<vtkTransform>::New();
+    transform->Translate(2.0, -1.5, 3.0);
+    transform->RotateWXYZ(6.0, 1.0, 1.0, 0.5);
+    return transform;
+  }
+
+  static mitk::Surface::Pointer TransformSurface(const mitk::Surface *surface, vtkTransform *transform)
+  {
+    auto filter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+    filter->SetInputData(surface->GetVtkPolyData());
+    filter->SetTransform(transform);
+    filter->Update();
+
+    auto result = mitk::Surface::New();
+    result->SetVtkPolyData(filter->GetOutput());
+    return result;
+  }
+
+  static mitk::AnisotropicIterativeClosestPointRegistration::Pointer CreateRegistration(mitk::Surface *moving,
+                                                                                        mitk::Surface *fixed)
+  {
+    mitk::CovarianceMatrixCalculator::Pointer matrixCalculator = mitk::CovarianceMatrixCalculator::New();
+
+    matrixCalculator->SetInputSurface(moving);
+    matrixCalculator->ComputeCovarianceMatrices();
+    CovarianceMatrixList sigmasMoving = matrixCalculator->GetCovarianceMatrices();
+    const double meanVarX = matrixCalculator->GetMeanVariance();
+
+    matrixCalculator->SetInputSurface(fixed);
+    matrixCalculator->ComputeCovarianceMatrices();
+    CovarianceMatrixList sigmasFixed = matrixCalculator->GetCovarianceMatrices();
+    const double meanVarY = matrixCalculator->GetMeanVariance();
+
+    auto aICP = mitk::AnisotropicIterativeClosestPointRegistration::New();
+    aICP->SetMovingSurface(moving);
+    aICP->SetFixedSurface(fixed);
+    aICP->SetCovarianceMatricesMovingSurface(sigmasMoving);
+    aICP->SetCovarianceMatricesFixedSurface(sigmasFixed);
+    aICP->SetFRENormalizationFactor(sqrt(meanVarX + meanVarY));
+    aICP->SetThreshold(0.000001);
+    aICP->SetSearchRadius(10.0);
+    return aICP;
+  }
+
+  static void AssertTransformEquals(vtkTransform *expected,
+                                    const mitk::AnisotropicIterativeClosestPointRegistration *aICP,
+                                    double rotationTolerance,
+                                    double translationTolerance)
+  {
+    vtkMatrix4x4 *matrix = expected->GetMatrix();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int j = 0; j < 3; ++j)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(matrix->GetElement(i, j), aICP->GetRotation()[i][j], rotationTolerance);
+
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(matrix->GetElement(i, 3), aICP->GetTranslation()[i], translationTolerance);
+    }
+  }
+
 public:
   /**
    * @brief Setup Always call this method before each Test-case to ensure
@@ -163,6 +267,69 @@ public:
     CPPUNIT_ASSERT_MESSAGE("mitkAnisotropicIterativeClosestPointRegistrationTest:AicpRegistration Test TRE",
                            mitk::Equal(tre, expTRE, 0.01));
   }
+
+  void testParallelAicpRegistrationIsDeterministic()
+  {
+    mitk::AnisotropicIterativeClosestPointRegistration::Pointer results[2];
+    const unsigned int numberOfThreads[2] = {1, 0};
+
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      results[i] = mitk::AnisotropicIterativeClosestPointRegistration::New();
+      results[i]->SetMovingSurface(m_MovingSurface);
+      results[i]->SetFixedSurface(m_FixedSurface);
+      results[i]->SetCovarianceMatricesMovingSurface(m_SigmasMovingSurface);
+      results[i]->SetCovarianceMatricesFixedSurface(m_SigmasFixedSurface);
+      results[i]->SetFRENormalizationFactor(m_FRENormalizationFactor);
+      results[i]->SetTrimmFactor(0.8);
+      results[i]->SetMaxIterations(10);
+      results[i]->SetNumberOfThreads(numberOfThreads[i]);
+      results[i]->Update();
+    }
+
+    // the correspondences of every point are computed independently, thus the results are identical
+    CPPUNIT_ASSERT_EQUAL(results[0]->GetNumberOfIterations(), results[1]->GetNumberOfIterations());
+    CPPUNIT_ASSERT_EQUAL(results[0]->GetFRE(), results[1]->GetFRE());
+    CPPUNIT_ASSERT(results[0]->GetRotation() == results[1]->GetRotation());
+    CPPUNIT_ASSERT(results[0]->GetTranslation() == results[1]->GetTranslation());
+  }
+
+  void testSyntheticSurfaceWithKnownTransform()
+  {
+    auto transform = CreateKnownTransform();
+    auto moving = CreateSyntheticSurface(40);
+    auto fixed = TransformSurface(moving, transform);
+
+    auto aICP = CreateRegistration(moving, fixed);
+    aICP->Update();
+
+    AssertTransformEquals(transform, aICP, 1e-3, 1e-2);
+
+    // the trimmed version registers the subset of the best correspondences
+    aICP = CreateRegistration(moving, fixed);
+    aICP->SetTrimmFactor(0.6);
+    aICP->Update();
+
+    AssertTransformEquals(transform, aICP, 1e-3, 1e-2);
+  }
+
+  void testEarlyTermination()
+  {
+    auto transform = CreateKnownTransform();
+    auto moving = CreateSyntheticSurface(40);
+    auto fixed = TransformSurface(moving, transform);
+
+    auto aICP = CreateRegistration(moving, fixed);
+    aICP->Update();
+    const unsigned int numberOfIterations = aICP->GetNumberOfIterations();
+
+    auto earlyAICP = CreateRegistration(moving, fixed);
+    earlyAICP->SetTransformTolerance(1e-3);
+    earlyAICP->Update();
+
+    CPPUNIT_ASSERT(earlyAICP->GetNumberOfIterations() <= numberOfIterations);
+    AssertTransformEquals(transform, earlyAICP, 1e-2, 1e-1);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkAnisotropicIterativeClosestPointRegistration)
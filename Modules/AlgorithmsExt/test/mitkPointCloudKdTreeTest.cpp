@@ -0,0 +1,232 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include "mitkPointCloudKdTree.h"
+
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+
+/**
+ * Compares the queries of the PointCloudKdTree with a brute force search.
+ */
+class mitkPointCloudKdTreeTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPointCloudKdTreeTestSuite);
+  MITK_TEST(FindPointsWithinRadius_EqualsBruteForce);
+  MITK_TEST(FindKNearestPoints_EqualsBruteForce);
+  MITK_TEST(FindKNearestPoints_Batched_EqualsSingleQueries);
+  MITK_TEST(FindKNearestPoints_MoreNeighboursThanPoints);
+  MITK_TEST(Queries_WithDuplicatePoints);
+  MITK_TEST(Queries_OnEmptyTree);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::vector<double> m_Coordinates;
+  std::vector<double> m_Queries;
+  mitk::PointCloudKdTree::Pointer m_Tree;
+
+  static std::vector<double> CreateRandomCoordinates(unsigned int numberOfPoints, unsigned int seed)
+  {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(-100.0, 100.0);
+
+    std::vector<double> coordinates(3 * numberOfPoints);
+    for (auto &coordinate : coordinates)
+      coordinate = distribution(generator);
+
+    // a flat cluster to get degenerated splits, too
+    for (unsigned int i = 0; i < numberOfPoints / 10; ++i)
+      coordinates[3 * i + 2] = 5.0;
+
+    return coordinates;
+  }
+
+  static double SquaredDistance(const double *a, const double *b)
+  {
+    return (a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]);
+  }
+
+  /** Returns the squared distances and ids of all points ordered by distance.*/
+  std::vector<std::pair<double, vtkIdType>> SortByDistance(const double *query) const
+  {
+    std::vector<std::pair<double, vtkIdType>> result;
+    for (vtkIdType id = 0; id < static_cast<vtkIdType>(m_Coordinates.size() / 3); ++id)
+      result.emplace_back(SquaredDistance(query, &m_Coordinates[3 * id]), id);
+
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Coordinates = CreateRandomCoordinates(5000, 1);
+    m_Queries = CreateRandomCoordinates(200, 2);
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    for (std::size_t i = 0; i < m_Coordinates.size(); i += 3)
+      points->InsertNextPoint(&m_Coordinates[i]);
+
+    m_Tree = mitk::PointCloudKdTree::New();
+    m_Tree->SetPoints(points);
+  }
+
+  void tearDown() override { m_Tree = nullptr; }
+
+  void FindPointsWithinRadius_EqualsBruteForce()
+  {
+    CPPUNIT_ASSERT_EQUAL(vtkIdType(5000), m_Tree->GetNumberOfPoints());
+
+    mitk::PointCloudKdTree::IdList ids;
+
+    for (double radius : {0.0, 3.0, 17.5, 400.0})
+    {
+      for (std::size_t q = 0; q < m_Queries.size(); q += 3)
+      {
+        const double *query = &m_Queries[q];
+
+        mitk::PointCloudKdTree::IdList expected;
+        for (const auto &candidate : this->SortByDistance(query))
+        {
+          if (candidate.first <= radius * radius)
+            expected.push_back(candidate.second);
+        }
+
+        m_Tree->FindPointsWithinRadius(query, radius, ids);
+
+        std::sort(expected.begin(), expected.end());
+        std::sort(ids.begin(), ids.end());
+        CPPUNIT_ASSERT_MESSAGE("Points within radius are found", expected == ids);
+      }
+    }
+
+    // the query point itself is found with radius 0
+    m_Tree->FindPointsWithinRadius(&m_Coordinates[3 * 42], 0.0, ids);
+    CPPUNIT_ASSERT(std::find(ids.begin(), ids.end(), 42) != ids.end());
+  }
+
+  void FindKNearestPoints_EqualsBruteForce()
+  {
+    mitk::PointCloudKdTree::IdList ids;
+    std::vector<double> squaredDistances;
+
+    for (unsigned int k : {1u, 5u, 64u})
+    {
+      for (std::size_t q = 0; q < m_Queries.size(); q += 3)
+      {
+        const auto expected = this->SortByDistance(&m_Queries[q]);
+
+        m_Tree->FindKNearestPoints(&m_Queries[q], k, ids, squaredDistances);
+
+        CPPUNIT_ASSERT_EQUAL(std::size_t(k), ids.size());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(k), squaredDistances.size());
+
+        for (unsigned int i = 0; i < k; ++i)
+        {
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i].first, squaredDistances[i], 1e-9);
+          const double distanceOfId = SquaredDistance(&m_Queries[q], m_Tree->GetPoint(ids[i]));
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i].first, distanceOfId, 1e-9);
+        }
+      }
+    }
+  }
+
+  void FindKNearestPoints_Batched_EqualsSingleQueries()
+  {
+    const unsigned int k = 8;
+    const auto numberOfQueries = static_cast<vtkIdType>(m_Queries.size() / 3);
+
+    mitk::PointCloudKdTree::IdList batchIds;
+    std::vector<double> batchDistances;
+    mitk::PointCloudKdTree::IdList ids;
+    std::vector<double> squaredDistances;
+
+    for (unsigned int threads : {1u, 0u})
+    {
+      m_Tree->FindKNearestPoints(m_Queries.data(), numberOfQueries, k, batchIds, batchDistances, threads);
+      CPPUNIT_ASSERT_EQUAL(std::size_t(numberOfQueries * k), batchIds.size());
+
+      for (vtkIdType q = 0; q < numberOfQueries; ++q)
+      {
+        m_Tree->FindKNearestPoints(&m_Queries[3 * q], k, ids, squaredDistances);
+        CPPUNIT_ASSERT(std::equal(ids.begin(), ids.end(), batchIds.begin() + q * k));
+        CPPUNIT_ASSERT(std::equal(squaredDistances.begin(), squaredDistances.end(), batchDistances.begin() + q * k));
+      }
+    }
+  }
+
+  void FindKNearestPoints_MoreNeighboursThanPoints()
+  {
+    const double coordinates[] = {0, 0, 0, 1, 0, 0, 3, 0, 0};
+    auto tree = mitk::PointCloudKdTree::New();
+    tree->SetPoints(coordinates, 3);
+
+    mitk::PointCloudKdTree::IdList ids;
+    std::vector<double> squaredDistances;
+    const double query[] = {2.9, 0, 0};
+
+    tree->FindKNearestPoints(query, 5, ids, squaredDistances);
+    CPPUNIT_ASSERT(mitk::PointCloudKdTree::IdList({2, 1, 0}) == ids);
+
+    tree->FindKNearestPoints(query, 1, 5, ids, squaredDistances);
+    CPPUNIT_ASSERT(mitk::PointCloudKdTree::IdList({2, 1, 0, -1, -1}) == ids);
+    CPPUNIT_ASSERT(std::isinf(squaredDistances[4]));
+  }
+
+  void Queries_WithDuplicatePoints()
+  {
+    std::vector<double> coordinates;
+    for (unsigned int i = 0; i < 100; ++i)
+      coordinates.insert(coordinates.end(), {1.0, 2.0, 3.0});
+
+    auto tree = mitk::PointCloudKdTree::New();
+    tree->SetPoints(coordinates.data(), 100);
+
+    mitk::PointCloudKdTree::IdList ids;
+    tree->FindPointsWithinRadius(coordinates.data(), 0.0, ids);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(100), ids.size());
+
+    std::vector<double> squaredDistances;
+    tree->FindKNearestPoints(coordinates.data(), 10, ids, squaredDistances);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(10), ids.size());
+    CPPUNIT_ASSERT_EQUAL(0.0, squaredDistances.back());
+  }
+
+  void Queries_OnEmptyTree()
+  {
+    auto tree = mitk::PointCloudKdTree::New();
+    tree->SetPoints(nullptr, 0);
+
+    const double query[] = {0, 0, 0};
+    mitk::PointCloudKdTree::IdList ids(3, 7);
+    std::vector<double> squaredDistances;
+
+    tree->FindPointsWithinRadius(query, 100.0, ids);
+    CPPUNIT_ASSERT(ids.empty());
+
+    tree->FindKNearestPoints(query, 3, ids, squaredDistances);
+    CPPUNIT_ASSERT(ids.empty());
+
+    CPPUNIT_ASSERT_THROW(tree->SetPoints(static_cast<vtkPoints *>(nullptr)), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPointCloudKdTree)
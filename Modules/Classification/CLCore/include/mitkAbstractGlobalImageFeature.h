@@ -22,6 +22,7 @@ found in the LICENSE file.
 #include <mitkCommandLineParser.h>
 
 #include <mitkIntensityQuantifier.h>
+#include <mitkTextureMatrixCache.h>
 
 // STD Includes
 
@@ -225,6 +226,19 @@ public:
   itkSetMacro(MorphMask, mitk::Image::Pointer);
   itkGetConstMacro(MorphMask, mitk::Image::Pointer);
 
+  /** Cache that shares the texture matrices of an image and mask between feature classes. It is only used
+  * if it was set up for the image and mask passed to CalculateFeatures(), see TextureMatrixCache::SetInput().*/
+  itkSetMacro(TextureMatrixCache, TextureMatrixCache::Pointer);
+  itkGetConstMacro(TextureMatrixCache, TextureMatrixCache::Pointer);
+
+  /** Announces all texture matrices the feature class will request from a cache, so that the cache can calculate
+  * them together with the matrices of other feature classes. The default implementation announces nothing.*/
+  virtual void AnnounceTextureMatrices(TextureMatrixCache* cache) const;
+
+  /** Indicates if the feature class can be calculated concurrently with other feature classes on the same image
+  * and mask. Feature classes that pass the input to VTK pipelines (e.g. via Image::GetVtkImageData()) return false.*/
+  virtual bool IsConcurrentCalculationSupported() const { return true; }
+
   itkSetMacro(Bins, int);
   itkSetMacro(UseBins, bool);
   itkGetConstMacro(UseBins, bool);
@@ -270,6 +284,9 @@ protected:
   /**Initializes the quantifier gigen the quantifier relevant variables and the passed arguments.*/
   void InitializeQuantifier(const Image* image, const Image* mask, unsigned int defaultBins = 256);
 
+  /** Returns the texture matrix cache if it was set up for the passed image and mask, otherwise nullptr.*/
+  TextureMatrixCache* GetTextureMatrixCache(const Image* image, const Image* mask) const;
+
   /** Helper that encodes the quantifier parameters in a string (e.g. used for the legacy feature name)*/
   std::string QuantifierParameterString() const;
 
@@ -316,6 +333,7 @@ private:
   ParametersType m_Parameters; // Parameter setting
 
   mitk::Image::Pointer m_MorphMask = nullptr;
+  TextureMatrixCache::Pointer m_TextureMatrixCache;
 
 
   IntensityQuantifier::Pointer m_Quantifier;
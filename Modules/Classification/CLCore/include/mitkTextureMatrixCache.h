@@ -0,0 +1,169 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkTextureMatrixCache_h
+#define mitkTextureMatrixCache_h
+
+#include <MitkCLCoreExports.h>
+
+#include <mitkImage.h>
+
+// Eigen
+#include <Eigen/Dense>
+
+// STD Includes
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * \brief Calculates the texture matrices of one image and mask once and shares them between feature classes.
+  *
+  * Texture feature classes (e.g. GIFCooccurenceMatrix2, GIFGreyLevelSizeZone and
+  * GIFNeighbouringGreyLevelDependenceFeature) normally quantize the image on their own and traverse it once
+  * per offset. If they are given a cache (see AbstractGlobalImageFeature::SetTextureMatrixCache) they request
+  * their matrices from it instead:
+  * - The image is cropped to the bounding box of the mask once.
+  * - The cropped image is quantized once for every quantization (minimum, maximum and number of bins).
+  * - All matrices announced for a quantization and direction (see AddCooccurrenceRange(), AddSizeZoneMatrix()
+  *   and AddDependenceRange()) are calculated together in a single traversal of the quantized image.
+  *   Matrices that were not announced are calculated on request.
+  *
+  * The matrices are identical to the ones the feature classes calculate themselves. The grey level of a voxel is
+  * its bin index floor((intensity - minimum) / binsize) with binsize = (maximum - minimum) / bins. Only the
+  * co-occurrence matrices clamp it to [0, bins - 1], the indices of the sparse matrices are not clamped.
+  * Voxels outside of the mask or with a NaN intensity are ignored.
+  *
+  * All Get methods are thread safe. Concurrent requests for the same quantization and direction wait for a single
+  * calculation, requests for different ones are calculated concurrently. SetInput() and the Add methods must not
+  * be called while matrices are requested.
+  */
+  class MITKCLCORE_EXPORT TextureMatrixCache : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(TextureMatrixCache, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** Offset between two voxels (x, y, z). The z component of offsets in 2D images is 0.*/
+    using OffsetType = std::array<int, 3>;
+    /** Sparse matrix that maps (row, column) of a matrix to its value.*/
+    using SparseMatrixType = std::map<std::pair<int, int>, double>;
+
+    /** Neighbouring grey level dependence matrix (grey level x number of dependent neighbours) and the statistics
+    * of the neighbourhoods, as calculated by GIFNeighbouringGreyLevelDependenceFeature.*/
+    struct DependenceMatrixType
+    {
+      SparseMatrixType Matrix;
+      int NeighbourhoodSize = 0;
+      unsigned long NumberOfNeighbourVoxels = 0;
+      unsigned long NumberOfDependenceNeighbourVoxels = 0;
+      unsigned long NumberOfNeighbourhoods = 0;
+      unsigned long NumberOfCompleteNeighbourhoods = 0;
+    };
+
+    /** Sets the image and the mask the matrices are calculated for and clears all calculated matrices.
+    * The image is cropped to the mask when the first matrix is requested.*/
+    void SetInput(const Image* image, const Image* mask);
+    /** Indicates if the cache was set up for the passed image and mask.*/
+    bool IsInput(const Image* image, const Image* mask) const;
+
+    /** Announces the co-occurrence matrices of all offsets of the 8- (2D) or 26-neighbourhood (3D) scaled by range.*/
+    void AddCooccurrenceRange(double range);
+    /** Announces the grey level size zone matrix.*/
+    void AddSizeZoneMatrix();
+    /** Announces the neighbouring grey level dependence matrix of the given range and coarseness alpha.*/
+    void AddDependenceRange(int range, int alpha);
+
+    /** Returns the symmetric co-occurrence matrix (bins x bins) of all voxel pairs (voxel, voxel + offset)
+    * within the mask.*/
+    Eigen::MatrixXd GetCooccurrenceMatrix(double minimum, double maximum, int bins, unsigned int direction, const OffsetType& offset);
+    /** Returns the number of zones per grey level (row) and zone size - 1 (column). Zones are connected
+    * by the neighbourhood offsets of the direction.*/
+    SparseMatrixType GetSizeZoneMatrix(double minimum, double maximum, int bins, unsigned int direction);
+    /** Returns the neighbouring grey level dependence matrix of the given range and coarseness alpha.*/
+    DependenceMatrixType GetDependenceMatrix(double minimum, double maximum, int bins, unsigned int direction, int range, int alpha);
+
+    /** Returns the offsets of the co-occurrence matrices for the given image dimension, direction and range
+    * in the order used by GIFCooccurenceMatrix2. Direction 0 uses all offsets, direction n > 1 only those
+    * within the plane perpendicular to axis n - 2 and direction 1 none.*/
+    static std::vector<OffsetType> GetCooccurrenceOffsets(unsigned int dimension, unsigned int direction, double range);
+    /** Returns the offsets that connect the voxels of a grey level size zone (each pair of opposite offsets
+    * is represented by one of them).*/
+    static std::vector<OffsetType> GetSizeZoneOffsets(unsigned int dimension, unsigned int direction);
+
+  protected:
+    TextureMatrixCache();
+    ~TextureMatrixCache() override;
+
+  private:
+    /** Voxels of the cropped image and their intensities (NaN outside of the mask), x runs fastest.*/
+    struct CroppedImageType
+    {
+      unsigned int Dimension = 3;
+      OffsetType Size = { { 0, 0, 0 } };
+      std::vector<double> Intensities;
+    };
+
+    struct QuantizationType
+    {
+      double Minimum;
+      double Maximum;
+      int Bins;
+
+      bool operator<(const QuantizationType& other) const;
+    };
+
+    /** Matrices that are calculated in one traversal.*/
+    struct RequestType
+    {
+      std::set<OffsetType> Cooccurrence;
+      bool SizeZone = false;
+      std::set<std::pair<int, int>> Dependence;
+    };
+
+    /** Calculated matrices of a quantization and direction.*/
+    struct MatricesType
+    {
+      std::mutex Mutex;
+      std::map<OffsetType, Eigen::MatrixXd> Cooccurrence;
+      bool HasSizeZone = false;
+      SparseMatrixType SizeZone;
+      std::map<std::pair<int, int>, DependenceMatrixType> Dependence;
+    };
+
+    const CroppedImageType& GetCroppedImage();
+    std::shared_ptr<const std::vector<int>> GetGreyLevels(const QuantizationType& quantization);
+    std::shared_ptr<MatricesType> GetMatrices(const QuantizationType& quantization, unsigned int direction);
+    /** Calculates the requested matrices together with all announced matrices that are still missing.*/
+    void CalculateMatrices(const QuantizationType& quantization, unsigned int direction, RequestType request, MatricesType& matrices);
+
+    Image::ConstPointer m_Image;
+    Image::ConstPointer m_Mask;
+
+    std::set<double> m_CooccurrenceRanges;
+    bool m_SizeZoneMatrix;
+    std::set<std::pair<int, int>> m_DependenceRanges;
+
+    std::mutex m_Mutex;
+    std::unique_ptr<std::once_flag> m_CropFlag;
+    CroppedImageType m_CroppedImage;
+    std::map<QuantizationType, std::shared_ptr<const std::vector<int>>> m_GreyLevels;
+    std::map<std::pair<QuantizationType, unsigned int>, std::shared_ptr<MatricesType>> m_Matrices;
+  };
+}
+
+#endif //mitkTextureMatrixCache_h
@@ -297,6 +297,17 @@ void  mitk::AbstractGlobalImageFeature::InitializeQuantifier(const Image* image,
     m_Quantifier->InitializeByImageRegion(image, mask, defaultBins);
 }
 
+mitk::TextureMatrixCache* mitk::AbstractGlobalImageFeature::GetTextureMatrixCache(const Image* image, const Image* mask) const
+{
+  if (m_TextureMatrixCache.IsNotNull() && m_TextureMatrixCache->IsInput(image, mask))
+    return m_TextureMatrixCache;
+  return nullptr;
+}
+
+void mitk::AbstractGlobalImageFeature::AnnounceTextureMatrices(TextureMatrixCache*) const
+{
+}
+
 std::string mitk::AbstractGlobalImageFeature::GenerateLegacyFeatureName(const FeatureID& id) const
 {
   std::string output;
@@ -0,0 +1,519 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTextureMatrixCache.h>
+
+// STD
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <tuple>
+
+// ITK
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+
+// MITK
+#include <mitkExceptionMacro.h>
+#include <mitkImageAccessByItk.h>
+#include <mitkImageCast.h>
+
+namespace
+{
+  typedef mitk::TextureMatrixCache::OffsetType OffsetType;
+  typedef mitk::TextureMatrixCache::SparseMatrixType SparseMatrixType;
+  typedef mitk::TextureMatrixCache::DependenceMatrixType DependenceMatrixType;
+
+  /** Grey level of voxels that are outside of the mask or NaN.*/
+  const int OutsideOfMask = std::numeric_limits<int>::min();
+
+  /** Matrices that are calculated in one traversal of the quantized image.*/
+  struct TraversalType
+  {
+    std::vector<OffsetType> CooccurrenceOffsets;
+    std::vector<Eigen::MatrixXd> Cooccurrence;
+
+    std::vector<OffsetType> SizeZoneOffsets;
+    SparseMatrixType SizeZone;
+
+    std::vector<std::pair<int, int>> Dependences;
+    std::vector<DependenceMatrixType> DependenceMatrices;
+  };
+
+  std::size_t FindRoot(std::vector<std::size_t>& parents, std::size_t index)
+  {
+    while (parents[index] != index)
+    {
+      parents[index] = parents[parents[index]];
+      index = parents[index];
+    }
+    return index;
+  }
+
+  void Traverse(unsigned int dimension, const OffsetType& size, const std::vector<int>& greyLevels, int bins, unsigned int direction, TraversalType& traversal)
+  {
+    const long sizeX = size[0];
+    const long sizeY = size[1];
+    const long sizeZ = size[2];
+    const std::size_t numberOfVoxels = greyLevels.size();
+
+    auto isInside = [&](long x, long y, long z) {
+      return x >= 0 && y >= 0 && z >= 0 && x < sizeX && y < sizeY && z < sizeZ;
+    };
+    auto toIndex = [&](long x, long y, long z) {
+      return static_cast<std::size_t>(x + sizeX * (y + sizeY * z));
+    };
+    auto clampToBins = [bins](int level) {
+      return std::max(0, std::min(level, bins - 1));
+    };
+
+    traversal.Cooccurrence.assign(traversal.CooccurrenceOffsets.size(), Eigen::MatrixXd::Zero(bins, bins));
+
+    // Size zones are the connected components of voxels with the same grey level
+    const bool sizeZone = !traversal.SizeZoneOffsets.empty();
+    std::vector<std::size_t> parents;
+    if (sizeZone)
+    {
+      parents.resize(numberOfVoxels);
+      std::iota(parents.begin(), parents.end(), 0);
+    }
+
+    // The dependence counts are accumulated densely (grey level x dependent neighbours)
+    int minimumLevel = std::numeric_limits<int>::max();
+    int maximumLevel = std::numeric_limits<int>::lowest();
+    for (auto level : greyLevels)
+    {
+      if (level != OutsideOfMask)
+      {
+        minimumLevel = std::min(minimumLevel, level);
+        maximumLevel = std::max(maximumLevel, level);
+      }
+    }
+
+    std::vector<OffsetType> radii;
+    std::vector<std::vector<double>> dependenceCounts;
+    traversal.DependenceMatrices.assign(traversal.Dependences.size(), DependenceMatrixType());
+    for (std::size_t k = 0; k < traversal.Dependences.size(); ++k)
+    {
+      const int range = traversal.Dependences[k].first;
+      OffsetType radius = { { range, range, dimension > 2 ? range : 0 } };
+      if (direction > 1 && direction - 2 < dimension)
+        radius[direction - 2] = 0;
+      radii.push_back(radius);
+
+      traversal.DependenceMatrices[k].NeighbourhoodSize = (2 * radius[0] + 1) * (2 * radius[1] + 1) * (2 * radius[2] + 1) - 1;
+      if (minimumLevel <= maximumLevel)
+        dependenceCounts.emplace_back(static_cast<std::size_t>(maximumLevel - minimumLevel + 1) * (traversal.DependenceMatrices[k].NeighbourhoodSize + 1), 0.0);
+      else
+        dependenceCounts.emplace_back();
+    }
+
+    for (long z = 0; z < sizeZ; ++z)
+    {
+      for (long y = 0; y < sizeY; ++y)
+      {
+        for (long x = 0; x < sizeX; ++x)
+        {
+          const std::size_t index = toIndex(x, y, z);
+          const int level = greyLevels[index];
+          if (level == OutsideOfMask)
+            continue;
+
+          for (std::size_t k = 0; k < traversal.CooccurrenceOffsets.size(); ++k)
+          {
+            const auto& offset = traversal.CooccurrenceOffsets[k];
+            if (!isInside(x + offset[0], y + offset[1], z + offset[2]))
+              continue;
+            const int neighbourLevel = greyLevels[toIndex(x + offset[0], y + offset[1], z + offset[2])];
+            if (neighbourLevel == OutsideOfMask)
+              continue;
+
+            const int i = clampToBins(level);
+            const int j = clampToBins(neighbourLevel);
+            traversal.Cooccurrence[k](i, j) += 1;
+            traversal.Cooccurrence[k](j, i) += 1;
+          }
+
+          if (sizeZone)
+          {
+            for (const auto& offset : traversal.SizeZoneOffsets)
+            {
+              if (!isInside(x + offset[0], y + offset[1], z + offset[2]))
+                continue;
+              const std::size_t neighbour = toIndex(x + offset[0], y + offset[1], z + offset[2]);
+              if (greyLevels[neighbour] != level)
+                continue;
+
+              const std::size_t root = FindRoot(parents, index);
+              const std::size_t neighbourRoot = FindRoot(parents, neighbour);
+              if (root != neighbourRoot)
+                parents[std::max(root, neighbourRoot)] = std::min(root, neighbourRoot);
+            }
+          }
+
+          for (std::size_t k = 0; k < traversal.Dependences.size(); ++k)
+          {
+            const auto& radius = radii[k];
+            const int alpha = traversal.Dependences[k].second;
+            auto& dependence = traversal.DependenceMatrices[k];
+
+            int sameValues = 0;
+            bool completeNeighbourhood = true;
+            for (long dz = -radius[2]; dz <= radius[2]; ++dz)
+            {
+              for (long dy = -radius[1]; dy <= radius[1]; ++dy)
+              {
+                for (long dx = -radius[0]; dx <= radius[0]; ++dx)
+                {
+                  if (dx == 0 && dy == 0 && dz == 0)
+                    continue;
+                  if (!isInside(x + dx, y + dy, z + dz))
+                  {
+                    completeNeighbourhood = false;
+                    continue;
+                  }
+                  const int neighbourLevel = greyLevels[toIndex(x + dx, y + dy, z + dz)];
+                  if (neighbourLevel == OutsideOfMask)
+                  {
+                    completeNeighbourhood = false;
+                    continue;
+                  }
+
+                  ++dependence.NumberOfNeighbourVoxels;
+                  if (std::abs(level - neighbourLevel) <= alpha)
+                  {
+                    ++dependence.NumberOfDependenceNeighbourVoxels;
+                    ++sameValues;
+                  }
+                }
+              }
+            }
+
+            dependenceCounts[k][static_cast<std::size_t>(level - minimumLevel) * (dependence.NeighbourhoodSize + 1) + sameValues] += 1;
+            ++dependence.NumberOfNeighbourhoods;
+            if (completeNeighbourhood)
+              ++dependence.NumberOfCompleteNeighbourhoods;
+          }
+        }
+      }
+    }
+
+    if (sizeZone)
+    {
+      std::vector<std::size_t> zoneSizes(numberOfVoxels, 0);
+      for (std::size_t i = 0; i < numberOfVoxels; ++i)
+      {
+        if (greyLevels[i] != OutsideOfMask)
+          ++zoneSizes[FindRoot(parents, i)];
+      }
+      for (std::size_t i = 0; i < numberOfVoxels; ++i)
+      {
+        if (greyLevels[i] != OutsideOfMask && parents[i] == i)
+          traversal.SizeZone[std::make_pair(greyLevels[i], static_cast<int>(zoneSizes[i]) - 1)] += 1;
+      }
+    }
+
+    for (std::size_t k = 0; k < traversal.Dependences.size(); ++k)
+    {
+      const int columns = traversal.DependenceMatrices[k].NeighbourhoodSize + 1;
+      for (std::size_t i = 0; i < dependenceCounts[k].size(); ++i)
+      {
+        if (dependenceCounts[k][i] > 0)
+          traversal.DependenceMatrices[k].Matrix[std::make_pair(minimumLevel + static_cast<int>(i / columns), static_cast<int>(i % columns))] = dependenceCounts[k][i];
+      }
+    }
+  }
+
+  std::vector<OffsetType> GetNeighbourhoodOffsets(unsigned int dimension, unsigned int direction, double range)
+  {
+    std::vector<OffsetType> offsets;
+
+    // Offsets of the neighbourhood with radius 1 that precede its center (x runs fastest, like itk::Neighborhood)
+    int numberOfOffsets = 1;
+    for (unsigned int i = 0; i < dimension; ++i)
+      numberOfOffsets *= 3;
+
+    for (int d = 0; d < numberOfOffsets / 2; ++d)
+    {
+      OffsetType offset = { { 0, 0, 0 } };
+      bool useOffset = true;
+      int position = d;
+      for (unsigned int i = 0; i < dimension; ++i)
+      {
+        itk::OffsetValueType value = position % 3 - 1;
+        position /= 3;
+        value *= range;
+        offset[i] = static_cast<int>(value);
+        if (direction == i + 2 && value != 0)
+          useOffset = false;
+      }
+      if (useOffset)
+        offsets.push_back(offset);
+    }
+    return offsets;
+  }
+}
+
+template<typename TPixel, unsigned int VImageDimension>
+static void
+CropImageToMask(const itk::Image<TPixel, VImageDimension>* itkImage, const mitk::Image* mask, unsigned int& dimension, OffsetType& size, std::vector<double>& intensities)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+  typedef itk::Image<unsigned short, VImageDimension> MaskType;
+
+  typename MaskType::Pointer maskImage = MaskType::New();
+  mitk::CastToItkImage(mask, maskImage);
+
+  // Bounding box of the mask
+  const auto maskRegion = maskImage->GetLargestPossibleRegion();
+  typename MaskType::IndexType lower;
+  typename MaskType::IndexType upper;
+  bool emptyMask = true;
+  itk::ImageRegionConstIteratorWithIndex<MaskType> maskIter(maskImage, maskRegion);
+  for (; !maskIter.IsAtEnd(); ++maskIter)
+  {
+    if (maskIter.Get() < 1)
+      continue;
+    const auto index = maskIter.GetIndex();
+    if (emptyMask)
+    {
+      lower = index;
+      upper = index;
+      emptyMask = false;
+    }
+    for (unsigned int i = 0; i < VImageDimension; ++i)
+    {
+      lower[i] = std::min(lower[i], index[i]);
+      upper[i] = std::max(upper[i], index[i]);
+    }
+  }
+
+  dimension = VImageDimension;
+  size.fill(emptyMask ? 0 : 1);
+  intensities.clear();
+  if (emptyMask)
+    return;
+
+  typename MaskType::RegionType cropRegion;
+  cropRegion.SetIndex(lower);
+  for (unsigned int i = 0; i < VImageDimension; ++i)
+  {
+    cropRegion.SetSize(i, upper[i] - lower[i] + 1);
+    size[i] = static_cast<int>(cropRegion.GetSize(i));
+  }
+
+  // Image and mask are traversed in parallel, like in the feature classes
+  typename ImageType::RegionType imageRegion(itkImage->GetLargestPossibleRegion().GetIndex() + (lower - maskRegion.GetIndex()), cropRegion.GetSize());
+  if (!itkImage->GetLargestPossibleRegion().IsInside(imageRegion))
+    mitkThrow() << "Image and mask of the texture matrix cache do not match.";
+
+  itk::ImageRegionConstIterator<ImageType> imageIter(itkImage, imageRegion);
+  itk::ImageRegionConstIterator<MaskType> cropIter(maskImage, cropRegion);
+  intensities.reserve(cropRegion.GetNumberOfPixels());
+  for (; !cropIter.IsAtEnd(); ++cropIter, ++imageIter)
+  {
+    const double intensity = imageIter.Get();
+    intensities.push_back(cropIter.Get() > 0 ? intensity : std::numeric_limits<double>::quiet_NaN());
+  }
+}
+
+bool mitk::TextureMatrixCache::QuantizationType::operator<(const QuantizationType& other) const
+{
+  return std::tie(Minimum, Maximum, Bins) < std::tie(other.Minimum, other.Maximum, other.Bins);
+}
+
+mitk::TextureMatrixCache::TextureMatrixCache() :
+  m_SizeZoneMatrix(false), m_CropFlag(new std::once_flag)
+{
+}
+
+mitk::TextureMatrixCache::~TextureMatrixCache()
+{
+}
+
+void mitk::TextureMatrixCache::SetInput(const Image* image, const Image* mask)
+{
+  m_Image = image;
+  m_Mask = mask;
+  m_CropFlag.reset(new std::once_flag);
+  m_CroppedImage = CroppedImageType();
+  m_GreyLevels.clear();
+  m_Matrices.clear();
+  this->Modified();
+}
+
+bool mitk::TextureMatrixCache::IsInput(const Image* image, const Image* mask) const
+{
+  return nullptr != image && m_Image.GetPointer() == image && m_Mask.GetPointer() == mask;
+}
+
+void mitk::TextureMatrixCache::AddCooccurrenceRange(double range)
+{
+  m_CooccurrenceRanges.insert(range);
+}
+
+void mitk::TextureMatrixCache::AddSizeZoneMatrix()
+{
+  m_SizeZoneMatrix = true;
+}
+
+void mitk::TextureMatrixCache::AddDependenceRange(int range, int alpha)
+{
+  m_DependenceRanges.insert(std::make_pair(range, alpha));
+}
+
+Eigen::MatrixXd mitk::TextureMatrixCache::GetCooccurrenceMatrix(double minimum, double maximum, int bins, unsigned int direction, const OffsetType& offset)
+{
+  const QuantizationType quantization = { minimum, maximum, bins };
+  auto matrices = this->GetMatrices(quantization, direction);
+
+  std::lock_guard<std::mutex> lock(matrices->Mutex);
+  if (0 == matrices->Cooccurrence.count(offset))
+  {
+    RequestType request;
+    request.Cooccurrence.insert(offset);
+    this->CalculateMatrices(quantization, direction, request, *matrices);
+  }
+  return matrices->Cooccurrence[offset];
+}
+
+mitk::TextureMatrixCache::SparseMatrixType mitk::TextureMatrixCache::GetSizeZoneMatrix(double minimum, double maximum, int bins, unsigned int direction)
+{
+  const QuantizationType quantization = { minimum, maximum, bins };
+  auto matrices = this->GetMatrices(quantization, direction);
+
+  std::lock_guard<std::mutex> lock(matrices->Mutex);
+  if (!matrices->HasSizeZone)
+  {
+    RequestType request;
+    request.SizeZone = true;
+    this->CalculateMatrices(quantization, direction, request, *matrices);
+  }
+  return matrices->SizeZone;
+}
+
+mitk::TextureMatrixCache::DependenceMatrixType mitk::TextureMatrixCache::GetDependenceMatrix(double minimum, double maximum, int bins, unsigned int direction, int range, int alpha)
+{
+  const QuantizationType quantization = { minimum, maximum, bins };
+  auto matrices = this->GetMatrices(quantization, direction);
+  const auto dependence = std::make_pair(range, alpha);
+
+  std::lock_guard<std::mutex> lock(matrices->Mutex);
+  if (0 == matrices->Dependence.count(dependence))
+  {
+    RequestType request;
+    request.Dependence.insert(dependence);
+    this->CalculateMatrices(quantization, direction, request, *matrices);
+  }
+  return matrices->Dependence[dependence];
+}
+
+std::vector<mitk::TextureMatrixCache::OffsetType> mitk::TextureMatrixCache::GetCooccurrenceOffsets(unsigned int dimension, unsigned int direction, double range)
+{
+  // Direction 1 excludes all offsets in GIFCooccurenceMatrix2
+  if (direction == 1)
+    return std::vector<OffsetType>();
+  return GetNeighbourhoodOffsets(dimension, direction, range);
+}
+
+std::vector<mitk::TextureMatrixCache::OffsetType> mitk::TextureMatrixCache::GetSizeZoneOffsets(unsigned int dimension, unsigned int direction)
+{
+  // Direction 1 connects zones along z only in GIFGreyLevelSizeZone
+  if (direction == 1)
+    return { { { 0, 0, 1 } } };
+  return GetNeighbourhoodOffsets(dimension, direction, 1.0);
+}
+
+const mitk::TextureMatrixCache::CroppedImageType& mitk::TextureMatrixCache::GetCroppedImage()
+{
+  std::call_once(*m_CropFlag, [this]() {
+    if (m_Image.IsNull() || m_Mask.IsNull())
+      mitkThrow() << "Texture matrices requested without input image and mask.";
+    AccessByItk_n(m_Image.GetPointer(), CropImageToMask, (m_Mask.GetPointer(), m_CroppedImage.Dimension, m_CroppedImage.Size, m_CroppedImage.Intensities));
+  });
+  return m_CroppedImage;
+}
+
+std::shared_ptr<const std::vector<int>> mitk::TextureMatrixCache::GetGreyLevels(const QuantizationType& quantization)
+{
+  const auto& croppedImage = this->GetCroppedImage();
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto& greyLevels = m_GreyLevels[quantization];
+  if (nullptr == greyLevels)
+  {
+    // Same binning as the holders of the feature classes
+    const double binsize = (quantization.Maximum - quantization.Minimum) / (quantization.Bins);
+    auto levels = std::make_shared<std::vector<int>>();
+    levels->reserve(croppedImage.Intensities.size());
+    for (auto intensity : croppedImage.Intensities)
+    {
+      if (intensity != intensity)
+        levels->push_back(OutsideOfMask);
+      else
+        levels->push_back(static_cast<int>(std::floor((intensity - quantization.Minimum) / binsize)));
+    }
+    greyLevels = levels;
+  }
+  return greyLevels;
+}
+
+std::shared_ptr<mitk::TextureMatrixCache::MatricesType> mitk::TextureMatrixCache::GetMatrices(const QuantizationType& quantization, unsigned int direction)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto& matrices = m_Matrices[std::make_pair(quantization, direction)];
+  if (nullptr == matrices)
+    matrices = std::make_shared<MatricesType>();
+  return matrices;
+}
+
+void mitk::TextureMatrixCache::CalculateMatrices(const QuantizationType& quantization, unsigned int direction, RequestType request, MatricesType& matrices)
+{
+  const auto greyLevels = this->GetGreyLevels(quantization);
+  const auto& croppedImage = this->GetCroppedImage();
+
+  // Everything announced but not yet calculated is calculated in the same traversal
+  for (auto range : m_CooccurrenceRanges)
+  {
+    for (const auto& offset : GetCooccurrenceOffsets(croppedImage.Dimension, direction, range))
+      request.Cooccurrence.insert(offset);
+  }
+  request.SizeZone = request.SizeZone || m_SizeZoneMatrix;
+  request.Dependence.insert(m_DependenceRanges.begin(), m_DependenceRanges.end());
+
+  TraversalType traversal;
+  for (const auto& offset : request.Cooccurrence)
+  {
+    if (0 == matrices.Cooccurrence.count(offset))
+      traversal.CooccurrenceOffsets.push_back(offset);
+  }
+  if (request.SizeZone && !matrices.HasSizeZone)
+    traversal.SizeZoneOffsets = GetSizeZoneOffsets(croppedImage.Dimension, direction);
+  for (const auto& dependence : request.Dependence)
+  {
+    if (0 == matrices.Dependence.count(dependence))
+      traversal.Dependences.push_back(dependence);
+  }
+
+  Traverse(croppedImage.Dimension, croppedImage.Size, *greyLevels, quantization.Bins, direction, traversal);
+
+  for (std::size_t k = 0; k < traversal.CooccurrenceOffsets.size(); ++k)
+    matrices.Cooccurrence[traversal.CooccurrenceOffsets[k]] = std::move(traversal.Cooccurrence[k]);
+  if (!traversal.SizeZoneOffsets.empty())
+  {
+    matrices.SizeZone = std::move(traversal.SizeZone);
+    matrices.HasSizeZone = true;
+  }
+  for (std::size_t k = 0; k < traversal.Dependences.size(); ++k)
+    matrices.Dependence[traversal.Dependences[k]] = std::move(traversal.DependenceMatrices[k]);
+}
@@ -45,6 +45,7 @@ found in the LICENSE file.
 
 #include <mitkCLResultWriter.h>
 #include <mitkCLResultXMLWriter.h>
+#include <mitkGlobalImageFeatureEngine.h>
 #include <mitkVersion.h>
 
 #include <iostream>
@@ -359,7 +360,7 @@ void SaveSliceOrImageAsPNG(mitk::Image::Pointer image, mitk::Image::Pointer mask
   }
 }
 
-int main(int argc, char* argv[])
+static std::vector<mitk::AbstractGlobalImageFeature::Pointer> CreateFeatureCalculators()
 {
   // Commented : Updated to a common interface, include, if possible, mask is type unsigned short, uses Quantification, Comments
   //                                 Name follows standard scheme with Class Name::Feature Name
@@ -399,6 +400,13 @@ int main(int argc, char* argv[])
   features.push_back(ipCalculator.GetPointer());
   features.push_back(ngtdCalculator.GetPointer());
 
+  return features;
+}
+
+int main(int argc, char* argv[])
+{
+  auto features = CreateFeatureCalculators();
+
   mitkCommandLineParser parser;
   parser.setArgumentPrefix("--", "-");
   mitk::cl::GlobalImageFeaturesParameter param;
@@ -416,6 +424,7 @@ int main(int argc, char* argv[])
   parser.addArgument("slice-wise", "slice", mitkCommandLineParser::String, "Int", "Allows to specify if the image is processed slice-wise (number giving direction) ", us::Any());
   parser.addArgument("output-mode", "omode", mitkCommandLineParser::Int, "Int", "Defines the format of the output. 0: (Default) results of an image / slice are written in a single row;"
     " 1: results of an image / slice are written in a single column; 2: store the result of on image as structured radiomocs report (XML).");
+  parser.addArgument("threads", "threads", mitkCommandLineParser::Int, "Int", "Number of threads used to calculate the features. 0: (Default) one thread per core; 1: sequential calculation.", us::Any());
 
   // Miniapp Infos
   parser.setCategory("Classification Tools");
@@ -582,28 +591,46 @@ int main(int argc, char* argv[])
   }
 
   log << " Configure features -";
-  for (auto cFeature : features)
+  // Every image / slice is calculated with its own instances of the feature classes
+  auto configureFeatures = [&](const std::vector<mitk::AbstractGlobalImageFeature::Pointer>& featureVector)
   {
-    if (param.defineGlobalMinimumIntensity)
-    {
-      cFeature->SetMinimumIntensity(param.globalMinimumIntensity);
-      cFeature->SetUseMinimumIntensity(true);
-    }
-    if (param.defineGlobalMaximumIntensity)
-    {
-      cFeature->SetMaximumIntensity(param.globalMaximumIntensity);
-      cFeature->SetUseMaximumIntensity(true);
-    }
-    if (param.defineGlobalNumberOfBins)
+    for (auto cFeature : featureVector)
     {
-      cFeature->SetBins(param.globalNumberOfBins);
-      MITK_INFO << param.globalNumberOfBins;
+      if (param.defineGlobalMinimumIntensity)
+      {
+        cFeature->SetMinimumIntensity(param.globalMinimumIntensity);
+        cFeature->SetUseMinimumIntensity(true);
+      }
+      if (param.defineGlobalMaximumIntensity)
+      {
+        cFeature->SetMaximumIntensity(param.globalMaximumIntensity);
+        cFeature->SetUseMaximumIntensity(true);
+      }
+      if (param.defineGlobalNumberOfBins)
+      {
+        cFeature->SetBins(param.globalNumberOfBins);
+      }
+      cFeature->SetParameters(parsedArgs);
+      cFeature->SetDirection(direction);
+      cFeature->SetEncodeParametersInFeaturePrefix(param.encodeParameter);
     }
-    cFeature->SetParameters(parsedArgs);
-    cFeature->SetDirection(direction);
-    cFeature->SetEncodeParametersInFeaturePrefix(param.encodeParameter);
+  };
+
+  unsigned int numberOfThreads = 0;
+  if (parsedArgs.count("threads"))
+  {
+    numberOfThreads = us::any_cast<int>(parsedArgs["threads"]);
   }
 
+  mitk::GlobalImageFeatureEngine::Pointer engine = mitk::GlobalImageFeatureEngine::New();
+  engine->SetNumberOfThreads(numberOfThreads);
+  engine->SetFeatureFactory([&]()
+  {
+    auto caseFeatures = CreateFeatureCalculators();
+    configureFeatures(caseFeatures);
+    return caseFeatures;
+  });
+
   bool addDescription = parsedArgs.count("description");
   mitk::cl::FeatureResultWriter writer(param.outputPath, writeDirection);
 
@@ -639,6 +666,21 @@ int main(int argc, char* argv[])
 
   std::vector<mitk::AbstractGlobalImageFeature::FeatureListType> allStats;
 
+  log << " Calculating features -";
+  std::vector<mitk::GlobalImageFeatureEngine::CaseType> cases;
+  if (sliceWise)
+  {
+    for (std::size_t i = 0; i < floatVector.size(); ++i)
+    {
+      cases.push_back({ floatVector[i].GetPointer(), maskVector[i].GetPointer(), maskNoNaNVector[i].GetPointer(), morphMaskVector[i] });
+    }
+  }
+  else
+  {
+    cases.push_back({ cImage.GetPointer(), cMask.GetPointer(), cMaskNoNaN.GetPointer(), cMorphMask });
+  }
+  auto caseStats = engine->CalculateFeatures(cases, !param.calculateAllFeatures);
+
   log << " Begin Processing -";
   while (imageToProcess)
   {
@@ -668,14 +710,7 @@ int main(int argc, char* argv[])
       mitk::IOUtil::Save(cMask, param.analysisMaskPath);
     }
 
-    mitk::AbstractGlobalImageFeature::FeatureListType stats;
-
-    for (auto cFeature : features)
-    {
-      log << " Calculating " << cFeature->GetFeatureClassName() << " -";
-      cFeature->SetMorphMask(cMorphMask);
-      cFeature->CalculateAndAppendFeatures(cImage, cMask, cMaskNoNaN, stats, !param.calculateAllFeatures);
-    }
+    mitk::AbstractGlobalImageFeature::FeatureListType stats = caseStats[currentSlice];
 
     for (std::size_t i = 0; i < stats.size(); ++i)
     {
@@ -28,6 +28,8 @@ set(CPP_FILES
   GlobalImageFeatures/mitkGIFIntensityVolumeHistogramFeatures.cpp
   GlobalImageFeatures/mitkGIFNeighbourhoodGreyToneDifferenceFeatures.cpp
   GlobalImageFeatures/mitkGIFCurvatureStatistic.cpp
+  GlobalImageFeatures/mitkGlobalImageFeatureEngine.cpp
+  GlobalImageFeatures/mitkShapeFeatureKernel.cpp
 
   MiniAppUtils/mitkGlobalImageFeaturesParameter.cpp
   MiniAppUtils/mitkSplitParameterToVector.cpp
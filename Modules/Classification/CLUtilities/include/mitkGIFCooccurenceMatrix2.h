@@ -146,6 +146,7 @@ namespace mitk
       void SetRange(double range);
 
     void AddArguments(mitkCommandLineParser& parser) const override;
+    void AnnounceTextureMatrices(TextureMatrixCache* cache) const override;
 
   protected:
     std::string GenerateLegacyFeatureEncoding(const FeatureID& id) const override;
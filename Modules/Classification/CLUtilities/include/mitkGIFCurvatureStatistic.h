@@ -89,6 +89,7 @@ namespace mitk
     using Superclass::CalculateFeatures;
 
     void AddArguments(mitkCommandLineParser &parser) const override;
+    bool IsConcurrentCalculationSupported() const override { return false; }
 
   protected:
 
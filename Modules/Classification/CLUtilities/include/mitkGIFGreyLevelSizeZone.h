@@ -102,6 +102,7 @@ namespace mitk
       using Superclass::CalculateFeatures;
 
       void AddArguments(mitkCommandLineParser& parser) const override;
+      void AnnounceTextureMatrices(TextureMatrixCache* cache) const override;
 
     protected:
 
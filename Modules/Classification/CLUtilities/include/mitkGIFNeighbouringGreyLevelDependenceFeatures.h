@@ -132,6 +132,7 @@ namespace mitk
     itkSetMacro(Alpha, int);
 
     void AddArguments(mitkCommandLineParser& parser) const override;
+    void AnnounceTextureMatrices(TextureMatrixCache* cache) const override;
 
   protected:
     std::string GenerateLegacyFeatureEncoding(const FeatureID& id) const override;
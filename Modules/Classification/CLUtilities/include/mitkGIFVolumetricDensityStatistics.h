@@ -113,6 +113,7 @@ namespace mitk
     using Superclass::CalculateFeatures;
 
     void AddArguments(mitkCommandLineParser& parser) const override;
+    bool IsConcurrentCalculationSupported() const override { return false; }
 
   protected:
 
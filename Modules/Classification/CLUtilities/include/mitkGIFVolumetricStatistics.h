@@ -84,7 +84,11 @@ namespace mitk
   * - <b>Volumetric Features::Spherical disproportion (mesh based)</b>: Sphericity is measure of how sphere-like a shape is:
   * \f[ F_{spherical\_disproportion} = \frac{A}{4\pi R^2}= \frac{A}{\left(36\pi V^2\right)^{1/3}} \f]
   * - <b>Volumetric Features:: Maximum 3D diameter</b>: This is the largest distance between the centers of two voxels that
-  * are masked.
+  * are masked. It is searched among the vertices of the convex hull of the masked voxels (see ShapeFeatureKernel).
+  * - <b>Volumetric Features::Maximum 2D diameter (axial plane)</b>:
+  * - <b>Volumetric Features::Maximum 2D diameter (coronal plane)</b>:
+  * - <b>Volumetric Features::Maximum 2D diameter (sagittal plane)</b>: The largest distance between the centers of two
+  * masked voxels that are within the same x-y (axial), x-z (coronal) or y-z (sagittal) plane of the image.
   * - <b>Volumetric Features::Bounding box volume</b>: The bounding box volume is the volume of the smallest axis-aligned box
   * that encapuslates all voxel centres.
   * - <b>Volumetric Features::Centre of mass shift</b>:
@@ -118,6 +122,7 @@ namespace mitk
       using Superclass::CalculateFeatures;
 
       void AddArguments(mitkCommandLineParser& parser) const override;
+      bool IsConcurrentCalculationSupported() const override { return false; }
 
   protected:
 
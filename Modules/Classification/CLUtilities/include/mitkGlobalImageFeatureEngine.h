@@ -0,0 +1,89 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkGlobalImageFeatureEngine_h
+#define mitkGlobalImageFeatureEngine_h
+
+#include "MitkCLUtilitiesExports.h"
+
+#include <mitkAbstractGlobalImageFeature.h>
+
+#include <functional>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * \brief Calculates the features of several feature classes and cases (e.g. an image or its slices) concurrently.
+  *
+  * Each case gets its own, identically configured feature class instances from the feature factory, because
+  * feature classes keep per-calculation state (e.g. their quantifier). The feature classes of all cases are
+  * calculated by a pool of worker threads. Within a case the texture feature classes share a
+  * TextureMatrixCache, so the image is cropped and quantized once and all announced texture matrices
+  * of a quantization are calculated in one traversal (see AbstractGlobalImageFeature::AnnounceTextureMatrices).
+  *
+  * Feature classes that do not support concurrent calculation (see
+  * AbstractGlobalImageFeature::IsConcurrentCalculationSupported()) are calculated one after another.
+  *
+  * The resulting feature list of a case is identical to calling CalculateAndAppendFeatures() of each
+  * feature class in the order of the factory. The first exception thrown by a feature class is rethrown
+  * after all workers finished.
+  */
+  class MITKCLUTILITIES_EXPORT GlobalImageFeatureEngine : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(GlobalImageFeatureEngine, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    using FeatureListType = AbstractGlobalImageFeature::FeatureListType;
+    using FeatureVectorType = std::vector<AbstractGlobalImageFeature::Pointer>;
+    /** Creates a configured instance of every feature class that should be calculated. It is called once per case.*/
+    using FeatureFactoryType = std::function<FeatureVectorType()>;
+
+    /** Input of the feature classes for one case, see AbstractGlobalImageFeature::CalculateAndAppendFeatures().*/
+    struct CaseType
+    {
+      Image::ConstPointer image;
+      Image::ConstPointer mask;
+      Image::ConstPointer maskNoNaN;
+      Image::Pointer morphMask;
+    };
+
+    void SetFeatureFactory(const FeatureFactoryType& factory);
+
+    /** Number of worker threads. 0 (default) uses one thread per hardware thread, 1 calculates sequentially.*/
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /** Indicates if the texture feature classes of a case share a TextureMatrixCache (default true).*/
+    itkSetMacro(UseTextureMatrixCache, bool);
+    itkGetConstMacro(UseTextureMatrixCache, bool);
+    itkBooleanMacro(UseTextureMatrixCache);
+
+    /** Calculates the features of one case. If checkParameterActivation is true, only feature classes that are
+    * activated by their parameters are calculated.*/
+    FeatureListType CalculateFeatures(const CaseType& inputCase, bool checkParameterActivation = true);
+    /** Calculates the features of all cases and returns them in the order of the cases.*/
+    std::vector<FeatureListType> CalculateFeatures(const std::vector<CaseType>& cases, bool checkParameterActivation = true);
+
+  protected:
+    GlobalImageFeatureEngine();
+    ~GlobalImageFeatureEngine() override;
+
+  private:
+    FeatureFactoryType m_FeatureFactory;
+    unsigned int m_NumberOfThreads;
+    bool m_UseTextureMatrixCache;
+  };
+}
+
+#endif //mitkGlobalImageFeatureEngine_h
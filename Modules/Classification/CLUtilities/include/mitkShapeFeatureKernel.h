@@ -0,0 +1,109 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkShapeFeatureKernel_h
+#define mitkShapeFeatureKernel_h
+
+#include <MitkCLUtilitiesExports.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  * \brief Collects the voxels of a 3D mask in one pass and calculates diameters and principal moments from them.
+  *
+  * The voxels are passed by their index (relative to the start of the image region) in arbitrary order. The kernel
+  * only keeps the first and last voxel of every row along each image axis and the moments of the voxel positions,
+  * so its memory does not depend on the number of voxels:
+  * - The maximum 3D diameter is the largest distance between two voxel centres. It is always found between two
+  *   vertices of the convex hull of the voxel centres, which is calculated with exact integer arithmetic in index
+  *   space (index space and physical space only differ by an affine transform, so both have the same hull
+  *   vertices). Only the vertices are compared with each other instead of all border voxels.
+  * - The maximum 2D diameter of a plane is the largest distance between two voxel centres within a single slice.
+  *   It is calculated on the convex polygon of each slice with rotating calipers.
+  * - The principal moments are the eigenvalues of the sample covariance matrix of the voxel positions
+  *   (index * spacing), as used for the PCA based features.
+  */
+  class MITKCLUTILITIES_EXPORT ShapeFeatureKernel
+  {
+  public:
+    using IndexType = std::array<int, 3>;
+    using Index2DType = std::array<int, 2>;
+
+    ShapeFeatureKernel(const std::array<unsigned int, 3>& size, const std::array<double, 3>& spacing);
+
+    /** Adds a voxel of the mask. validIntensity indicates if the image has a valid (non NaN) intensity at the voxel,
+    * only those voxels contribute to the corrected principal moments.*/
+    void AddVoxel(const IndexType& index, bool validIntensity);
+
+    std::size_t GetNumberOfVoxels() const;
+
+    /** Returns the vertices of the convex hull of all added voxels.*/
+    std::vector<IndexType> GetConvexHullVertices() const;
+
+    /** Returns the largest distance between two voxel centres (using the spacing) within one slice perpendicular to
+    * the given axis. Axis 2 are the x-y planes (axial), axis 1 the x-z planes (coronal) and axis 0 the y-z planes
+    * (sagittal) of a standard oriented image.*/
+    double GetMaximumPlaneDiameter(unsigned int normalAxis) const;
+
+    /** Returns the eigenvalues of the covariance matrix of the voxel positions in ascending order. If corrected is true,
+    * only voxels with a valid intensity are used.*/
+    std::array<double, 3> GetPrincipalMoments(bool corrected) const;
+
+    /** Returns the vertices of the convex hull of the points. Duplicate points are allowed. If all points are coplanar,
+    * the vertices of the convex polygon are returned, if they are collinear the two end points.*/
+    static std::vector<IndexType> ComputeConvexHull(std::vector<IndexType> points);
+    /** Returns the vertices of the convex hull of the 2D points in counterclockwise order without collinear vertices.*/
+    static std::vector<Index2DType> ComputeConvexHull2D(std::vector<Index2DType> points);
+    /** Returns the largest distance between two vertices of a convex polygon (counterclockwise, as returned by
+    * ComputeConvexHull2D). The coordinates are scaled by spacingX and spacingY to calculate the distance.*/
+    static double ComputeConvexPolygonDiameter(const std::vector<Index2DType>& polygon, double spacingX, double spacingY);
+
+  private:
+    /** First and last voxel of a row.*/
+    struct RowType
+    {
+      int Minimum = -1;
+      int Maximum = -1;
+
+      void Add(int value);
+      bool IsEndpoint(int value) const { return value == Minimum || value == Maximum; }
+    };
+
+    /** Sums of the positions (relative to the first voxel) and of their products.*/
+    struct MomentsType
+    {
+      std::int64_t Count = 0;
+      std::array<std::int64_t, 3> Sum = { { 0, 0, 0 } };
+      std::array<std::int64_t, 6> ProductSum = { { 0, 0, 0, 0, 0, 0 } };
+
+      void Add(const std::array<std::int64_t, 3>& position);
+    };
+
+    std::array<unsigned int, 3> m_Size;
+    std::array<double, 3> m_Spacing;
+
+    // Rows along x (indexed by y, z), y (indexed by x, z) and z (indexed by x, y)
+    std::vector<RowType> m_RowsX;
+    std::vector<RowType> m_RowsY;
+    std::vector<RowType> m_RowsZ;
+
+    IndexType m_FirstIndex;
+    MomentsType m_Moments;
+    MomentsType m_CorrectedMoments;
+  };
+}
+
+#endif //mitkShapeFeatureKernel_h
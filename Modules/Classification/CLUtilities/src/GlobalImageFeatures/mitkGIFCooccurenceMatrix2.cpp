@@ -37,6 +37,7 @@ namespace mitk
     double MaximumIntensity;
     int Bins;
     FeatureID id;
+    TextureMatrixCache* TextureMatrices;
   };
 
   struct CoocurenceMatrixHolder
@@ -433,7 +434,10 @@ CalculateCoocurenceFeatures(const itk::Image<TPixel, VImageDimension>* itkImage,
   int numberOfBins = config.Bins;
 
   typename MaskType::Pointer maskImage = MaskType::New();
-  mitk::CastToItkImage(mask, maskImage);
+  if (nullptr == config.TextureMatrices)
+  {
+    mitk::CastToItkImage(mask, maskImage);
+  }
 
   //Find possible directions
   std::vector < itk::Offset<VImageDimension> > offsetVector;
@@ -483,7 +487,19 @@ CalculateCoocurenceFeatures(const itk::Image<TPixel, VImageDimension>* itkImage,
     offset = offsetVector[i];
     mitk::CoocurenceMatrixHolder holder(rangeMin, rangeMax, numberOfBins);
     mitk::CoocurenceMatrixFeatures coocResults;
-    CalculateCoOcMatrix<TPixel, VImageDimension>(itkImage, maskImage, offset, config.range, holder);
+    if (nullptr != config.TextureMatrices)
+    {
+      mitk::TextureMatrixCache::OffsetType cacheOffset = { { 0, 0, 0 } };
+      for (unsigned int d = 0; d < VImageDimension; ++d)
+      {
+        cacheOffset[d] = offset[d];
+      }
+      holder.m_Matrix = config.TextureMatrices->GetCooccurrenceMatrix(rangeMin, rangeMax, numberOfBins, config.direction, cacheOffset);
+    }
+    else
+    {
+      CalculateCoOcMatrix<TPixel, VImageDimension>(itkImage, maskImage, offset, config.range, holder);
+    }
     holderOverall.m_Matrix += holder.m_Matrix;
     CalculateFeatures(holder, coocResults);
     resultVector.push_back(coocResults);
@@ -663,6 +679,7 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFCooccurenceMatrix2::D
     config.MaximumIntensity = GetQuantifier()->GetMaximum();
     config.Bins = GetQuantifier()->GetBins();
     config.id = this->CreateTemplateFeatureID(std::to_string(range), { {GetOptionPrefix() + "::range", range} });
+    config.TextureMatrices = this->GetTextureMatrixCache(image, mask);
 
     AccessByItk_3(image, CalculateCoocurenceFeatures, mask, featureList, config);
 
@@ -672,6 +689,14 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFCooccurenceMatrix2::D
   return featureList;
 }
 
+void mitk::GIFCooccurenceMatrix2::AnnounceTextureMatrices(TextureMatrixCache* cache) const
+{
+  for (const auto& range : m_Ranges)
+  {
+    cache->AddCooccurrenceRange(range);
+  }
+}
+
 mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFCooccurenceMatrix2::CalculateFeatures(const Image* image, const Image*, const Image* maskNoNAN)
 {
   return Superclass::CalculateFeatures(image, maskNoNAN);
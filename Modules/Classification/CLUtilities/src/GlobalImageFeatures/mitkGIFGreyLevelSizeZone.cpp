@@ -32,6 +32,7 @@ namespace mitk
     double MaximumIntensity;
     int Bins;
     FeatureID id;
+    TextureMatrixCache* TextureMatrices;
   };
 
   struct GreyLevelSizeZoneMatrixHolder
@@ -338,6 +339,26 @@ CalculateGreyLevelSizeZoneFeatures(const itk::Image<TPixel, VImageDimension>* it
   double rangeMax = config.MaximumIntensity;
   int numberOfBins = config.Bins;
 
+  if (nullptr != config.TextureMatrices)
+  {
+    auto sizeZoneMatrix = config.TextureMatrices->GetSizeZoneMatrix(rangeMin, rangeMax, numberOfBins, config.direction);
+    int largestRegion = 0;
+    for (const auto& entry : sizeZoneMatrix)
+    {
+      largestRegion = std::max<int>(entry.first.second + 1, largestRegion);
+    }
+    mitk::GreyLevelSizeZoneMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins, largestRegion);
+    for (const auto& entry : sizeZoneMatrix)
+    {
+      holderOverall.m_Matrix(entry.first.first, entry.first.second) += entry.second;
+    }
+    mitk::GreyLevelSizeZoneFeatures overallFeature;
+    CalculateFeatures(holderOverall, overallFeature);
+
+    MatrixFeaturesTo(overallFeature, config, featureList);
+    return;
+  }
+
   typename MaskType::Pointer maskImage = MaskType::New();
   mitk::CastToItkImage(mask, maskImage);
 
@@ -415,6 +436,7 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFGreyLevelSizeZone::Do
   config.MaximumIntensity = GetQuantifier()->GetMaximum();
   config.Bins = GetQuantifier()->GetBins();
   config.id = this->CreateTemplateFeatureID();
+  config.TextureMatrices = this->GetTextureMatrixCache(image, mask);
 
   AccessByItk_3(image, CalculateGreyLevelSizeZoneFeatures, mask, featureList, config);
 
@@ -423,6 +445,11 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFGreyLevelSizeZone::Do
   return featureList;
 }
 
+void mitk::GIFGreyLevelSizeZone::AnnounceTextureMatrices(TextureMatrixCache* cache) const
+{
+  cache->AddSizeZoneMatrix();
+}
+
 mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFGreyLevelSizeZone::CalculateFeatures(const Image* image, const Image*, const Image* maskNoNAN)
 {
   return Superclass::CalculateFeatures(image, maskNoNAN);
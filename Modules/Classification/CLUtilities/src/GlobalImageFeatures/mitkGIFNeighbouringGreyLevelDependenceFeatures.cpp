@@ -36,6 +36,7 @@ struct GIFNeighbouringGreyLevelDependenceFeatureConfiguration
   double MaximumIntensity;
   int Bins;
   mitk::FeatureID id;
+  mitk::TextureMatrixCache* TextureMatrices;
 };
 
 namespace mitk
@@ -399,9 +400,6 @@ CalculateCoocurenceFeatures(const itk::Image<TPixel, VImageDimension>* itkImage,
   double rangeMax = config.MaximumIntensity;
   int numberOfBins = config.Bins;
 
-  typename MaskType::Pointer maskImage = MaskType::New();
-  mitk::CastToItkImage(mask, maskImage);
-
   std::vector<mitk::NGLDMMatrixFeatures> resultVector;
   int numberofDependency = 37;
   if (VImageDimension == 2)
@@ -409,7 +407,25 @@ CalculateCoocurenceFeatures(const itk::Image<TPixel, VImageDimension>* itkImage,
 
   mitk::NGLDMMatrixHolder holderOverall(rangeMin, rangeMax, numberOfBins, numberofDependency);
   mitk::NGLDMMatrixFeatures overallFeature;
-  CalculateNGLDMMatrix<TPixel, VImageDimension>(itkImage, maskImage, config.alpha, config.range, config.direction, holderOverall);
+  if (nullptr != config.TextureMatrices)
+  {
+    auto dependence = config.TextureMatrices->GetDependenceMatrix(rangeMin, rangeMax, numberOfBins, config.direction, static_cast<int>(config.range), config.alpha);
+    for (const auto& entry : dependence.Matrix)
+    {
+      holderOverall.m_Matrix(entry.first.first, entry.first.second) += entry.second;
+    }
+    holderOverall.m_NeighbourhoodSize = dependence.NeighbourhoodSize;
+    holderOverall.m_NumberOfNeighbourVoxels = dependence.NumberOfNeighbourVoxels;
+    holderOverall.m_NumberOfDependenceNeighbourVoxels = dependence.NumberOfDependenceNeighbourVoxels;
+    holderOverall.m_NumberOfNeighbourhoods = dependence.NumberOfNeighbourhoods;
+    holderOverall.m_NumberOfCompleteNeighbourhoods = dependence.NumberOfCompleteNeighbourhoods;
+  }
+  else
+  {
+    typename MaskType::Pointer maskImage = MaskType::New();
+    mitk::CastToItkImage(mask, maskImage);
+    CalculateNGLDMMatrix<TPixel, VImageDimension>(itkImage, maskImage, config.alpha, config.range, config.direction, holderOverall);
+  }
   LocalCalculateFeatures(holderOverall, overallFeature);
 
   MatrixFeaturesTo(overallFeature, config, featureList);
@@ -465,6 +481,7 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFNeighbouringGreyLevel
     config.Bins = GetQuantifier()->GetBins();
 
     config.id = this->CreateTemplateFeatureID(std::to_string(range), { {GetOptionPrefix() + "::range", range} });
+    config.TextureMatrices = this->GetTextureMatrixCache(image, mask);
 
     AccessByItk_3(image, CalculateCoocurenceFeatures, mask, featureList, config);
     MITK_INFO << "Finished calculating NGLD with range " << range << "....";
@@ -473,6 +490,14 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFNeighbouringGreyLevel
   return featureList;
 }
 
+void mitk::GIFNeighbouringGreyLevelDependenceFeature::AnnounceTextureMatrices(TextureMatrixCache* cache) const
+{
+  for (const auto& range : m_Ranges)
+  {
+    cache->AddDependenceRange(static_cast<int>(range), m_Alpha);
+  }
+}
+
 mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFNeighbouringGreyLevelDependenceFeature::CalculateFeatures(const Image* image, const Image*, const Image* maskNoNAN)
 {
   return Superclass::CalculateFeatures(image, maskNoNAN);
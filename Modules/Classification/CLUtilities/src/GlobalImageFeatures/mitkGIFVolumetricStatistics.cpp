@@ -16,8 +16,7 @@ found in the LICENSE file.
 #include <mitkITKImageImport.h>
 #include <mitkImageCast.h>
 #include <mitkImageAccessByItk.h>
-#include <mitkPixelTypeMultiplex.h>
-#include <mitkImagePixelReadAccessor.h>
+#include <mitkShapeFeatureKernel.h>
 
 // ITK
 #include <itkLabelStatisticsImageFilter.h>
@@ -27,9 +26,6 @@ found in the LICENSE file.
 #include <vtkSmartPointer.h>
 #include <vtkImageMarchingCubes.h>
 #include <vtkMassProperties.h>
-#include <vtkDoubleArray.h>
-#include <vtkPCAStatistics.h>
-#include <vtkTable.h>
 
 // STL
 #include <vnl/vnl_math.h>
@@ -64,7 +60,7 @@ void
 
 template<typename TPixel, unsigned int VImageDimension>
 void
-  CalculateLargestDiameter(const itk::Image<TPixel, VImageDimension>* mask, const mitk::Image* valueImage, mitk::GIFVolumetricStatistics::FeatureListType & featureList, mitk::FeatureID featureID)
+  CalculateLargestDiameter(const itk::Image<TPixel, VImageDimension>* mask, const mitk::Image* valueImage, mitk::GIFVolumetricStatistics::FeatureListType & featureList, mitk::FeatureID featureID, mitk::ShapeFeatureKernel& shapeKernel)
 {
   typedef itk::Image<double, VImageDimension> ValueImageType;
 
@@ -78,7 +74,7 @@ void
     radius[i] = 1;
   itk::ConstNeighborhoodIterator<ImageType> iterator(radius, mask, mask->GetRequestedRegion());
   itk::NeighborhoodIterator<ValueImageType> valueIter(radius, itkValueImage, itkValueImage->GetRequestedRegion());
-  std::vector<PointType> borderPoints;
+  auto regionIndex = mask->GetLargestPossibleRegion().GetIndex();
 
   unsigned int maskDimensionX = mask->GetLargestPossibleRegion().GetSize()[0];
   unsigned int maskDimensionY = mask->GetLargestPossibleRegion().GetSize()[1];
@@ -167,23 +163,18 @@ void
       ++numberOfPoints;
     }
 
-    bool border = false;
+    mitk::ShapeFeatureKernel::IndexType kernelIndex = { { 0, 0, 0 } };
+    for (unsigned int i = 0; i < VImageDimension && i < 3; ++i)
+      kernelIndex[i] = static_cast<int>(iterator.GetIndex()[i] - regionIndex[i]);
+    shapeKernel.AddVoxel(kernelIndex, intensityValue == intensityValue);
+
     for (int i = 0; i < (int)(iterator.Size()); ++i)
     {
       if (iterator.GetPixel(i) == 0 || ( ! iterator.IndexInBounds(i)))
       {
-        border = true;
         surface += directionSurface[i];
-        //break;
       }
     }
-    if (border)
-    {
-      auto centerIndex = iterator.GetIndex();
-      PointType centerPoint;
-      mask->TransformIndexToPhysicalPoint(centerIndex, centerPoint );
-      borderPoints.push_back(centerPoint);
-    }
     ++iterator;
     ++valueIter;
   }
@@ -194,14 +185,26 @@ void
   auto differenceOfCentersUncorrected = (normalCenterVectorUncorrected - weightedCenterVector).GetNorm();
   auto differenceOfCenters = (normalCenterVector - weightedCenterVector).GetNorm();
 
+  //
+  // The largest distance between two masked voxels is found between two vertices of their convex hull
+  //
+  std::vector<PointType> hullPoints;
+  for (const auto& vertex : shapeKernel.GetConvexHullVertices())
+  {
+    auto hullIndex = regionIndex;
+    for (unsigned int i = 0; i < VImageDimension && i < 3; ++i)
+      hullIndex[i] += vertex[i];
+    PointType hullPoint;
+    mask->TransformIndexToPhysicalPoint(hullIndex, hullPoint);
+    hullPoints.push_back(hullPoint);
+  }
+
   double longestDiameter = 0;
-  unsigned long numberOfBorderPoints = borderPoints.size();
-  for (int i = 0; i < (int)numberOfBorderPoints; ++i)
+  for (std::size_t i = 0; i < hullPoints.size(); ++i)
   {
-    auto point = borderPoints[i];
-    for (int j = i; j < (int)numberOfBorderPoints; ++j)
+    for (std::size_t j = i + 1; j < hullPoints.size(); ++j)
     {
-      double newDiameter=point.EuclideanDistanceTo(borderPoints[j]);
+      double newDiameter = hullPoints[i].EuclideanDistanceTo(hullPoints[j]);
       if (newDiameter > longestDiameter)
         longestDiameter = newDiameter;
     }
@@ -244,7 +247,10 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFVolumetricStatistics:
   auto featureID = this->CreateTemplateFeatureID();
 
   AccessByItk_3(image, CalculateVolumeStatistic, mask, featureList, featureID);
-  AccessByItk_3(mask, CalculateLargestDiameter, image, featureList, featureID);
+  std::array<unsigned int, 3> maskSize = { { mask->GetDimension(0), mask->GetDimension(1), mask->GetDimension(2) } };
+  std::array<double, 3> maskSpacing = { { mask->GetGeometry()->GetSpacing()[0], mask->GetGeometry()->GetSpacing()[1], mask->GetGeometry()->GetSpacing()[2] } };
+  mitk::ShapeFeatureKernel shapeKernel(maskSize, maskSpacing);
+  AccessByItk_n(mask, CalculateLargestDiameter, (image, featureList, featureID, shapeKernel));
 
   vtkSmartPointer<vtkImageMarchingCubes> mesher = vtkSmartPointer<vtkImageMarchingCubes>::New();
   vtkSmartPointer<vtkMassProperties> stats = vtkSmartPointer<vtkMassProperties>::New();
@@ -286,121 +292,11 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFVolumetricStatistics:
   double asphericityMesh = std::pow(1.0 / compactness2MeshMesh, (1.0 / 3.0)) - 1;
   double asphericityPixel = std::pow(1.0 / compactness2Pixel, (1.0 / 3.0)) - 1;
 
-  //Calculate center of mass shift
-  int xx = mask->GetDimensions()[0];
-  int yy = mask->GetDimensions()[1];
-  int zz = mask->GetDimensions()[2];
-
-  double xd = mask->GetGeometry()->GetSpacing()[0];
-  double yd = mask->GetGeometry()->GetSpacing()[1];
-  double zd = mask->GetGeometry()->GetSpacing()[2];
-
-  vtkSmartPointer<vtkDoubleArray> dataset1Arr = vtkSmartPointer<vtkDoubleArray>::New();
-  vtkSmartPointer<vtkDoubleArray> dataset2Arr = vtkSmartPointer<vtkDoubleArray>::New();
-  vtkSmartPointer<vtkDoubleArray> dataset3Arr = vtkSmartPointer<vtkDoubleArray>::New();
-  dataset1Arr->SetNumberOfComponents(1);
-  dataset2Arr->SetNumberOfComponents(1);
-  dataset3Arr->SetNumberOfComponents(1);
-  dataset1Arr->SetName("M1");
-  dataset2Arr->SetName("M2");
-  dataset3Arr->SetName("M3");
-
-  vtkSmartPointer<vtkDoubleArray> dataset1ArrU = vtkSmartPointer<vtkDoubleArray>::New();
-  vtkSmartPointer<vtkDoubleArray> dataset2ArrU = vtkSmartPointer<vtkDoubleArray>::New();
-  vtkSmartPointer<vtkDoubleArray> dataset3ArrU = vtkSmartPointer<vtkDoubleArray>::New();
-  dataset1ArrU->SetNumberOfComponents(1);
-  dataset2ArrU->SetNumberOfComponents(1);
-  dataset3ArrU->SetNumberOfComponents(1);
-  dataset1ArrU->SetName("M1");
-  dataset2ArrU->SetName("M2");
-  dataset3ArrU->SetName("M3");
-
-  for (int x = 0; x < xx; x++)
-  {
-    for (int y = 0; y < yy; y++)
-    {
-      for (int z = 0; z < zz; z++)
-      {
-        itk::Image<int, 3>::IndexType index;
-
-        index[0] = x;
-        index[1] = y;
-        index[2] = z;
-
-        mitk::ScalarType pxImage;
-        mitk::ScalarType pxMask;
-
-        mitkPixelTypeMultiplex5(
-          mitk::FastSinglePixelAccess,
-          image->GetChannelDescriptor().GetPixelType(),
-          image,
-          image->GetVolumeData(),
-          index,
-          pxImage,
-          0);
-
-        mitkPixelTypeMultiplex5(
-          mitk::FastSinglePixelAccess,
-          mask->GetChannelDescriptor().GetPixelType(),
-          mask,
-          mask->GetVolumeData(),
-          index,
-          pxMask,
-          0);
-
-        //Check if voxel is contained in segmentation
-        if (pxMask > 0)
-        {
-          dataset1ArrU->InsertNextValue(x * xd);
-          dataset2ArrU->InsertNextValue(y * yd);
-          dataset3ArrU->InsertNextValue(z * zd);
-
-          if (pxImage == pxImage)
-          {
-            dataset1Arr->InsertNextValue(x * xd);
-            dataset2Arr->InsertNextValue(y * yd);
-            dataset3Arr->InsertNextValue(z * zd);
-          }
-        }
-      }
-    }
-  }
-
-  vtkSmartPointer<vtkTable> datasetTable = vtkSmartPointer<vtkTable>::New();
-  datasetTable->AddColumn(dataset1Arr);
-  datasetTable->AddColumn(dataset2Arr);
-  datasetTable->AddColumn(dataset3Arr);
-
-  vtkSmartPointer<vtkTable> datasetTableU = vtkSmartPointer<vtkTable>::New();
-  datasetTableU->AddColumn(dataset1ArrU);
-  datasetTableU->AddColumn(dataset2ArrU);
-  datasetTableU->AddColumn(dataset3ArrU);
-
-  vtkSmartPointer<vtkPCAStatistics> pcaStatistics = vtkSmartPointer<vtkPCAStatistics>::New();
-  pcaStatistics->SetInputData(vtkStatisticsAlgorithm::INPUT_DATA, datasetTable);
-  pcaStatistics->SetColumnStatus("M1", 1);
-  pcaStatistics->SetColumnStatus("M2", 1);
-  pcaStatistics->SetColumnStatus("M3", 1);
-  pcaStatistics->RequestSelectedColumns();
-  pcaStatistics->SetDeriveOption(true);
-  pcaStatistics->Update();
-
-  vtkSmartPointer<vtkDoubleArray> eigenvalues = vtkSmartPointer<vtkDoubleArray>::New();
-  pcaStatistics->GetEigenvalues(eigenvalues);
-
-  pcaStatistics->SetInputData(vtkStatisticsAlgorithm::INPUT_DATA, datasetTableU);
-  pcaStatistics->Update();
-  vtkSmartPointer<vtkDoubleArray> eigenvaluesU = vtkSmartPointer<vtkDoubleArray>::New();
-  pcaStatistics->GetEigenvalues(eigenvaluesU);
-
-  std::vector<double> eigen_val(3);
-  std::vector<double> eigen_valUC(3);
-  eigen_val[2] = eigenvalues->GetValue(0);
-  eigen_val[1] = eigenvalues->GetValue(1);
-  eigen_val[0] = eigenvalues->GetValue(2);
-  eigen_valUC[2] = eigenvaluesU->GetValue(0);
-  eigen_valUC[1] = eigenvaluesU->GetValue(1);
-  eigen_valUC[0] = eigenvaluesU->GetValue(2);
+  //
+  // The PCA uses the voxel positions collected while searching the largest diameter
+  //
+  std::array<double, 3> eigen_val = shapeKernel.GetPrincipalMoments(true);
+  std::array<double, 3> eigen_valUC = shapeKernel.GetPrincipalMoments(false);
 
   double major = 4 * sqrt(eigen_val[2]);
   double minor = 4 * sqrt(eigen_val[1]);
@@ -444,6 +340,9 @@ mitk::AbstractGlobalImageFeature::FeatureListType mitk::GIFVolumetricStatistics:
   featureList.push_back(std::make_pair(mitk::CreateFeatureID(featureID, "PCA Least axis length (uncorrected)"), leastUC));
   featureList.push_back(std::make_pair(mitk::CreateFeatureID(featureID, "PCA Elongation (uncorrected)"), elongationUC));
   featureList.push_back(std::make_pair(mitk::CreateFeatureID(featureID, "PCA Flatness (uncorrected)"), flatnessUC));
+  featureList.push_back(std::make_pair(mitk::CreateFeatureID(featureID, "Maximum 2D diameter (axial plane)"), shapeKernel.GetMaximumPlaneDiameter(2)));
+  featureList.push_back(std::make_pair(mitk::CreateFeatureID(featureID, "Maximum 2D diameter (coronal plane)"), shapeKernel.GetMaximumPlaneDiameter(1)));
+  featureList.push_back(std::make_pair(mitk::CreateFeatureID(featureID, "Maximum 2D diameter (sagittal plane)"), shapeKernel.GetMaximumPlaneDiameter(0)));
 
   MITK_INFO << "Finished calculating volumetric features....";
 
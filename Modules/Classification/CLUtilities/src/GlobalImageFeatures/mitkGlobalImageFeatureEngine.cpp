@@ -0,0 +1,180 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkGlobalImageFeatureEngine.h>
+
+// MITK
+#include <mitkExceptionMacro.h>
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+  /** Feature classes, results and shared texture matrices of one case.*/
+  struct CaseStateType
+  {
+    mitk::GlobalImageFeatureEngine::FeatureVectorType Features;
+    std::vector<mitk::GlobalImageFeatureEngine::FeatureListType> Results;
+    mitk::TextureMatrixCache::Pointer Cache;
+    std::atomic<std::size_t> RemainingTasks;
+  };
+
+  bool IsActivated(const mitk::AbstractGlobalImageFeature* feature, bool checkParameterActivation)
+  {
+    return !checkParameterActivation || feature->GetParameters().count(feature->GetLongName()) > 0;
+  }
+}
+
+mitk::GlobalImageFeatureEngine::GlobalImageFeatureEngine() :
+  m_NumberOfThreads(0), m_UseTextureMatrixCache(true)
+{
+}
+
+mitk::GlobalImageFeatureEngine::~GlobalImageFeatureEngine()
+{
+}
+
+void mitk::GlobalImageFeatureEngine::SetFeatureFactory(const FeatureFactoryType& factory)
+{
+  m_FeatureFactory = factory;
+  this->Modified();
+}
+
+mitk::GlobalImageFeatureEngine::FeatureListType mitk::GlobalImageFeatureEngine::CalculateFeatures(const CaseType& inputCase, bool checkParameterActivation)
+{
+  return this->CalculateFeatures(std::vector<CaseType>({ inputCase }), checkParameterActivation).front();
+}
+
+std::vector<mitk::GlobalImageFeatureEngine::FeatureListType> mitk::GlobalImageFeatureEngine::CalculateFeatures(const std::vector<CaseType>& cases, bool checkParameterActivation)
+{
+  if (!m_FeatureFactory)
+    mitkThrow() << "No feature factory set.";
+
+  // Setting up the feature classes is cheap, the texture matrix caches crop the image lazily
+  std::vector<std::unique_ptr<CaseStateType>> states;
+  std::vector<std::pair<std::size_t, std::size_t>> tasks;
+  for (std::size_t caseIndex = 0; caseIndex < cases.size(); ++caseIndex)
+  {
+    const auto& inputCase = cases[caseIndex];
+    if (inputCase.image.IsNull() || inputCase.mask.IsNull())
+      mitkThrow() << "Case " << caseIndex << " has no image or mask.";
+
+    std::unique_ptr<CaseStateType> state(new CaseStateType);
+    state->Features = m_FeatureFactory();
+    state->Results.resize(state->Features.size());
+
+    if (m_UseTextureMatrixCache)
+    {
+      state->Cache = TextureMatrixCache::New();
+      state->Cache->SetInput(inputCase.image, inputCase.maskNoNaN.IsNotNull() ? inputCase.maskNoNaN : inputCase.mask);
+    }
+
+    std::size_t numberOfTasks = 0;
+    for (std::size_t featureIndex = 0; featureIndex < state->Features.size(); ++featureIndex)
+    {
+      auto& feature = state->Features[featureIndex];
+      if (!IsActivated(feature, checkParameterActivation))
+        continue;
+
+      if (state->Cache.IsNotNull())
+      {
+        feature->AnnounceTextureMatrices(state->Cache);
+        feature->SetTextureMatrixCache(state->Cache);
+      }
+      tasks.emplace_back(caseIndex, featureIndex);
+      ++numberOfTasks;
+    }
+    state->RemainingTasks = numberOfTasks;
+    states.push_back(std::move(state));
+  }
+
+  std::atomic<std::size_t> nextTask(0);
+  std::atomic<bool> cancelled(false);
+  std::exception_ptr exception;
+  std::mutex exceptionMutex;
+  std::mutex sequentialMutex;
+
+  auto worker = [&]() {
+    while (!cancelled)
+    {
+      const std::size_t taskIndex = nextTask++;
+      if (taskIndex >= tasks.size())
+        break;
+
+      const auto& inputCase = cases[tasks[taskIndex].first];
+      auto& state = *states[tasks[taskIndex].first];
+      auto& feature = state.Features[tasks[taskIndex].second];
+
+      // Feature classes that do not support concurrent calculation run one after another
+      std::unique_lock<std::mutex> sequentialLock(sequentialMutex, std::defer_lock);
+      if (!feature->IsConcurrentCalculationSupported())
+        sequentialLock.lock();
+
+      try
+      {
+        feature->SetMorphMask(inputCase.morphMask);
+        feature->CalculateAndAppendFeatures(inputCase.image, inputCase.mask, inputCase.maskNoNaN, state.Results[tasks[taskIndex].second], checkParameterActivation);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if (!exception)
+          exception = std::current_exception();
+        cancelled = true;
+      }
+      if (sequentialLock.owns_lock())
+        sequentialLock.unlock();
+
+      // The last feature class of a case releases its texture matrices
+      if (0 == --state.RemainingTasks)
+      {
+        for (auto& caseFeature : state.Features)
+          caseFeature->SetTextureMatrixCache(nullptr);
+        state.Cache = nullptr;
+      }
+    }
+  };
+
+  unsigned int numberOfThreads = m_NumberOfThreads > 0 ? m_NumberOfThreads : std::thread::hardware_concurrency();
+  numberOfThreads = static_cast<unsigned int>(std::min<std::size_t>(std::max(numberOfThreads, 1u), std::max<std::size_t>(tasks.size(), 1)));
+
+  if (numberOfThreads == 1)
+  {
+    worker();
+  }
+  else
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads);
+    for (unsigned int t = 0; t < numberOfThreads; ++t)
+      threads.emplace_back(worker);
+    for (auto& thread : threads)
+      thread.join();
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+
+  std::vector<FeatureListType> results(cases.size());
+  for (std::size_t caseIndex = 0; caseIndex < cases.size(); ++caseIndex)
+  {
+    for (const auto& featureResult : states[caseIndex]->Results)
+      results[caseIndex].insert(results[caseIndex].end(), featureResult.begin(), featureResult.end());
+  }
+  return results;
+}
@@ -0,0 +1,531 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkShapeFeatureKernel.h>
+
+// Eigen
+#include <Eigen/Dense>
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+
+namespace
+{
+  using IndexType = mitk::ShapeFeatureKernel::IndexType;
+  using Index2DType = mitk::ShapeFeatureKernel::Index2DType;
+  using VectorType = std::array<std::int64_t, 3>;
+
+  VectorType Difference(const IndexType& a, const IndexType& b)
+  {
+    return { { std::int64_t(a[0]) - b[0], std::int64_t(a[1]) - b[1], std::int64_t(a[2]) - b[2] } };
+  }
+
+  VectorType Cross(const VectorType& u, const VectorType& v)
+  {
+    return { { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] } };
+  }
+
+  std::int64_t Dot(const VectorType& u, const IndexType& p)
+  {
+    return u[0] * p[0] + u[1] * p[1] + u[2] * p[2];
+  }
+
+  double SquaredNorm(const VectorType& u)
+  {
+    return double(u[0]) * u[0] + double(u[1]) * u[1] + double(u[2]) * u[2];
+  }
+
+  std::int64_t Cross2D(const Index2DType& o, const Index2DType& a, const Index2DType& b)
+  {
+    return (std::int64_t(a[0]) - o[0]) * (std::int64_t(b[1]) - o[1]) - (std::int64_t(a[1]) - o[1]) * (std::int64_t(b[0]) - o[0]);
+  }
+
+  /** Triangle of the hull, counterclockwise seen from outside.*/
+  struct FaceType
+  {
+    std::array<int, 3> Vertices;
+    /** Face across the edge (Vertices[i], Vertices[(i + 1) % 3]).*/
+    std::array<int, 3> Neighbours;
+    VectorType Normal;
+    std::int64_t Offset;
+    bool Alive;
+    unsigned int VisitStamp;
+    bool Visible;
+    /** Points that are strictly above the face and not yet part of the hull.*/
+    std::vector<int> Outside;
+  };
+
+  /** Incremental 3D hull (quickhull) with exact integer orientation tests. Each point outside of the current hull is
+  * assigned to one face it is above of. The farthest point of a face is added by replacing all faces it is above of
+  * with a cone of new faces to the horizon, the points of the removed faces are reassigned to the new faces.*/
+  class ConvexHull3D
+  {
+  public:
+    explicit ConvexHull3D(const std::vector<IndexType>& points) : m_Points(points), m_Stamp(0) {}
+
+    std::vector<IndexType> Compute(const std::array<int, 4>& simplex)
+    {
+      // Orient the simplex so that every face is counterclockwise seen from outside
+      std::array<int, 4> s = simplex;
+      {
+        FaceType probe = this->CreateFace(s[0], s[1], s[2]);
+        if (this->Height(probe, s[3]) > 0)
+          std::swap(s[1], s[2]);
+      }
+      const std::array<std::array<int, 3>, 4> simplexFaces = { { { { s[0], s[1], s[2] } }, { { s[0], s[3], s[1] } }, { { s[1], s[3], s[2] } }, { { s[2], s[3], s[0] } } } };
+      for (const auto& vertices : simplexFaces)
+        m_Faces.push_back(this->CreateFace(vertices[0], vertices[1], vertices[2]));
+      for (std::size_t f = 0; f < 4; ++f)
+      {
+        for (int i = 0; i < 3; ++i)
+        {
+          const int a = m_Faces[f].Vertices[i];
+          const int b = m_Faces[f].Vertices[(i + 1) % 3];
+          for (std::size_t g = 0; g < 4; ++g)
+          {
+            for (int j = 0; j < 3; ++j)
+            {
+              if (m_Faces[g].Vertices[j] == b && m_Faces[g].Vertices[(j + 1) % 3] == a)
+                m_Faces[f].Neighbours[i] = static_cast<int>(g);
+            }
+          }
+        }
+      }
+
+      for (int p = 0; p < static_cast<int>(m_Points.size()); ++p)
+      {
+        if (std::find(s.begin(), s.end(), p) != s.end())
+          continue;
+        for (auto& face : m_Faces)
+        {
+          if (this->Height(face, p) > 0)
+          {
+            face.Outside.push_back(p);
+            break;
+          }
+        }
+      }
+
+      std::vector<int> pending = { 0, 1, 2, 3 };
+      while (!pending.empty())
+      {
+        const int f = pending.back();
+        pending.pop_back();
+        if (!m_Faces[f].Alive || m_Faces[f].Outside.empty())
+          continue;
+        this->AddPoint(f, pending);
+      }
+
+      std::vector<bool> isVertex(m_Points.size(), false);
+      for (const auto& face : m_Faces)
+      {
+        if (face.Alive)
+        {
+          for (auto v : face.Vertices)
+            isVertex[v] = true;
+        }
+      }
+      std::vector<IndexType> vertices;
+      for (std::size_t p = 0; p < m_Points.size(); ++p)
+      {
+        if (isVertex[p])
+          vertices.push_back(m_Points[p]);
+      }
+      return vertices;
+    }
+
+  private:
+    FaceType CreateFace(int a, int b, int c) const
+    {
+      FaceType face;
+      face.Vertices = { { a, b, c } };
+      face.Neighbours = { { -1, -1, -1 } };
+      face.Normal = Cross(Difference(m_Points[b], m_Points[a]), Difference(m_Points[c], m_Points[a]));
+      face.Offset = Dot(face.Normal, m_Points[a]);
+      face.Alive = true;
+      face.VisitStamp = 0;
+      face.Visible = false;
+      return face;
+    }
+
+    std::int64_t Height(const FaceType& face, int p) const
+    {
+      return Dot(face.Normal, m_Points[p]) - face.Offset;
+    }
+
+    void AddPoint(int startFace, std::vector<int>& pending)
+    {
+      // The farthest point of the face is a vertex of the final hull
+      auto& outside = m_Faces[startFace].Outside;
+      int eye = outside.front();
+      std::int64_t maximumHeight = this->Height(m_Faces[startFace], eye);
+      for (auto p : outside)
+      {
+        const std::int64_t height = this->Height(m_Faces[startFace], p);
+        if (height > maximumHeight)
+        {
+          maximumHeight = height;
+          eye = p;
+        }
+      }
+
+      // The faces the point is strictly above of are connected
+      ++m_Stamp;
+      std::vector<int> visibleFaces = { startFace };
+      m_Faces[startFace].VisitStamp = m_Stamp;
+      m_Faces[startFace].Visible = true;
+      for (std::size_t i = 0; i < visibleFaces.size(); ++i)
+      {
+        for (auto n : m_Faces[visibleFaces[i]].Neighbours)
+        {
+          if (m_Faces[n].VisitStamp == m_Stamp)
+            continue;
+          m_Faces[n].VisitStamp = m_Stamp;
+          m_Faces[n].Visible = this->Height(m_Faces[n], eye) > 0;
+          if (m_Faces[n].Visible)
+            visibleFaces.push_back(n);
+        }
+      }
+
+      // Connect the point to every edge of the horizon
+      std::vector<int> newFaces;
+      std::unordered_map<int, int> faceByStart;
+      std::unordered_map<int, int> faceByEnd;
+      for (auto v : visibleFaces)
+      {
+        for (int i = 0; i < 3; ++i)
+        {
+          const int n = m_Faces[v].Neighbours[i];
+          if (m_Faces[n].Visible)
+            continue;
+          const int a = m_Faces[v].Vertices[i];
+          const int b = m_Faces[v].Vertices[(i + 1) % 3];
+          const int newFace = static_cast<int>(m_Faces.size());
+          m_Faces.push_back(this->CreateFace(a, b, eye));
+          m_Faces[newFace].Neighbours[0] = n;
+          for (auto& neighbour : m_Faces[n].Neighbours)
+          {
+            if (neighbour == v)
+              neighbour = newFace;
+          }
+          faceByStart[a] = newFace;
+          faceByEnd[b] = newFace;
+          newFaces.push_back(newFace);
+        }
+      }
+      for (auto f : newFaces)
+      {
+        m_Faces[f].Neighbours[1] = faceByStart[m_Faces[f].Vertices[1]];
+        m_Faces[f].Neighbours[2] = faceByEnd[m_Faces[f].Vertices[0]];
+      }
+
+      // Points that are not above any of the new faces are inside of the hull
+      for (auto v : visibleFaces)
+      {
+        m_Faces[v].Alive = false;
+        m_Faces[v].Visible = false;
+        std::vector<int> points;
+        points.swap(m_Faces[v].Outside);
+        for (auto p : points)
+        {
+          if (p == eye)
+            continue;
+          for (auto f : newFaces)
+          {
+            if (this->Height(m_Faces[f], p) > 0)
+            {
+              m_Faces[f].Outside.push_back(p);
+              break;
+            }
+          }
+        }
+      }
+      for (auto f : newFaces)
+      {
+        if (!m_Faces[f].Outside.empty())
+          pending.push_back(f);
+      }
+    }
+
+    const std::vector<IndexType>& m_Points;
+    std::vector<FaceType> m_Faces;
+    unsigned int m_Stamp;
+  };
+}
+
+void mitk::ShapeFeatureKernel::RowType::Add(int value)
+{
+  if (Minimum < 0 || value < Minimum)
+    Minimum = value;
+  if (value > Maximum)
+    Maximum = value;
+}
+
+void mitk::ShapeFeatureKernel::MomentsType::Add(const std::array<std::int64_t, 3>& position)
+{
+  ++Count;
+  for (int i = 0; i < 3; ++i)
+    Sum[i] += position[i];
+  ProductSum[0] += position[0] * position[0];
+  ProductSum[1] += position[0] * position[1];
+  ProductSum[2] += position[0] * position[2];
+  ProductSum[3] += position[1] * position[1];
+  ProductSum[4] += position[1] * position[2];
+  ProductSum[5] += position[2] * position[2];
+}
+
+mitk::ShapeFeatureKernel::ShapeFeatureKernel(const std::array<unsigned int, 3>& size, const std::array<double, 3>& spacing) :
+  m_Size(size), m_Spacing(spacing), m_FirstIndex({ { 0, 0, 0 } })
+{
+  for (auto& s : m_Size)
+    s = std::max(s, 1u);
+  m_RowsX.resize(std::size_t(m_Size[1]) * m_Size[2]);
+  m_RowsY.resize(std::size_t(m_Size[0]) * m_Size[2]);
+  m_RowsZ.resize(std::size_t(m_Size[0]) * m_Size[1]);
+}
+
+void mitk::ShapeFeatureKernel::AddVoxel(const IndexType& index, bool validIntensity)
+{
+  m_RowsX[index[1] + std::size_t(m_Size[1]) * index[2]].Add(index[0]);
+  m_RowsY[index[0] + std::size_t(m_Size[0]) * index[2]].Add(index[1]);
+  m_RowsZ[index[0] + std::size_t(m_Size[0]) * index[1]].Add(index[2]);
+
+  // Positions relative to the first voxel keep the sums small
+  if (m_Moments.Count == 0)
+    m_FirstIndex = index;
+  const std::array<std::int64_t, 3> position = { { std::int64_t(index[0]) - m_FirstIndex[0], std::int64_t(index[1]) - m_FirstIndex[1], std::int64_t(index[2]) - m_FirstIndex[2] } };
+  m_Moments.Add(position);
+  if (validIntensity)
+    m_CorrectedMoments.Add(position);
+}
+
+std::size_t mitk::ShapeFeatureKernel::GetNumberOfVoxels() const
+{
+  return static_cast<std::size_t>(m_Moments.Count);
+}
+
+std::vector<mitk::ShapeFeatureKernel::IndexType> mitk::ShapeFeatureKernel::GetConvexHullVertices() const
+{
+  // A voxel between two other voxels of a row (along any axis) is not a vertex of the hull
+  std::vector<IndexType> candidates;
+  for (unsigned int z = 0; z < m_Size[2]; ++z)
+  {
+    for (unsigned int y = 0; y < m_Size[1]; ++y)
+    {
+      const auto& row = m_RowsX[y + std::size_t(m_Size[1]) * z];
+      if (row.Minimum < 0)
+        continue;
+      const int numberOfEndpoints = (row.Minimum == row.Maximum) ? 1 : 2;
+      for (int e = 0; e < numberOfEndpoints; ++e)
+      {
+        const int x = (e == 0) ? row.Minimum : row.Maximum;
+        if (m_RowsY[x + std::size_t(m_Size[0]) * z].IsEndpoint(int(y)) && m_RowsZ[x + std::size_t(m_Size[0]) * y].IsEndpoint(int(z)))
+          candidates.push_back({ { x, int(y), int(z) } });
+      }
+    }
+  }
+  return ComputeConvexHull(candidates);
+}
+
+double mitk::ShapeFeatureKernel::GetMaximumPlaneDiameter(unsigned int normalAxis) const
+{
+  // The end points of the rows of a slice contain the vertices of its convex polygon
+  const unsigned int sliceAxis = normalAxis;
+  const unsigned int rowAxis = (normalAxis == 2) ? 1 : 2;
+  const auto& rows = (normalAxis == 0) ? m_RowsY : m_RowsX;
+  const unsigned int rowStride = (normalAxis == 0) ? m_Size[0] : m_Size[1];
+  const double spacingX = (normalAxis == 0) ? m_Spacing[1] : m_Spacing[0];
+  const double spacingY = m_Spacing[rowAxis];
+
+  double diameter = 0;
+  std::vector<Index2DType> points;
+  for (unsigned int slice = 0; slice < m_Size[sliceAxis]; ++slice)
+  {
+    points.clear();
+    for (unsigned int r = 0; r < m_Size[rowAxis]; ++r)
+    {
+      // Rows along x are indexed by (y, z), rows along y by (x, z)
+      const std::size_t rowIndex = (normalAxis == 2) ? r + std::size_t(rowStride) * slice : slice + std::size_t(rowStride) * r;
+      const auto& row = rows[rowIndex];
+      if (row.Minimum < 0)
+        continue;
+      points.push_back({ { row.Minimum, int(r) } });
+      if (row.Maximum != row.Minimum)
+        points.push_back({ { row.Maximum, int(r) } });
+    }
+    if (points.empty())
+      continue;
+    diameter = std::max(diameter, ComputeConvexPolygonDiameter(ComputeConvexHull2D(points), spacingX, spacingY));
+  }
+  return diameter;
+}
+
+std::array<double, 3> mitk::ShapeFeatureKernel::GetPrincipalMoments(bool corrected) const
+{
+  const auto& moments = corrected ? m_CorrectedMoments : m_Moments;
+  std::array<double, 3> eigenvalues = { { 0, 0, 0 } };
+  if (moments.Count < 2)
+    return eigenvalues;
+
+  // Unbiased sample covariance of the positions
+  const double n = static_cast<double>(moments.Count);
+  const std::array<std::array<int, 3>, 3> productIndex = { { { { 0, 1, 2 } }, { { 1, 3, 4 } }, { { 2, 4, 5 } } } };
+  Eigen::Matrix3d covariance;
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      const double centered = double(moments.ProductSum[productIndex[i][j]]) - double(moments.Sum[i]) * double(moments.Sum[j]) / n;
+      covariance(i, j) = centered / (n - 1) * m_Spacing[i] * m_Spacing[j];
+    }
+  }
+
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(covariance, Eigen::EigenvaluesOnly);
+  for (int i = 0; i < 3; ++i)
+    eigenvalues[i] = std::max(0.0, solver.eigenvalues()[i]);
+  return eigenvalues;
+}
+
+std::vector<mitk::ShapeFeatureKernel::IndexType> mitk::ShapeFeatureKernel::ComputeConvexHull(std::vector<IndexType> points)
+{
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  if (points.size() < 3)
+    return points;
+
+  // Initial simplex: the lexicographically smallest point, the point farthest from it, the point farthest from the
+  // line through both and the point farthest from the plane through all three
+  std::array<int, 4> simplex = { { 0, 0, 0, 0 } };
+  double maximum = 0;
+  for (std::size_t i = 1; i < points.size(); ++i)
+  {
+    const double distance = SquaredNorm(Difference(points[i], points[0]));
+    if (distance > maximum)
+    {
+      maximum = distance;
+      simplex[1] = static_cast<int>(i);
+    }
+  }
+  const VectorType direction = Difference(points[simplex[1]], points[0]);
+  maximum = 0;
+  for (std::size_t i = 1; i < points.size(); ++i)
+  {
+    const double distance = SquaredNorm(Cross(direction, Difference(points[i], points[0])));
+    if (distance > maximum)
+    {
+      maximum = distance;
+      simplex[2] = static_cast<int>(i);
+    }
+  }
+  if (maximum == 0)
+  {
+    // All points are on a line, the first point is one of its ends
+    return { points[0], points[simplex[1]] };
+  }
+
+  const VectorType normal = Cross(direction, Difference(points[simplex[2]], points[0]));
+  std::int64_t maximumHeight = 0;
+  for (std::size_t i = 1; i < points.size(); ++i)
+  {
+    const std::int64_t height = std::abs(Dot(normal, points[i]) - Dot(normal, points[0]));
+    if (height > maximumHeight)
+    {
+      maximumHeight = height;
+      simplex[3] = static_cast<int>(i);
+    }
+  }
+  if (maximumHeight == 0)
+  {
+    // All points are on a plane. Dropping the coordinate with the largest normal component maps the plane
+    // one-to-one onto a coordinate plane.
+    int dropped = 0;
+    for (int i = 1; i < 3; ++i)
+    {
+      if (std::abs(normal[i]) > std::abs(normal[dropped]))
+        dropped = i;
+    }
+    const int u = (dropped == 0) ? 1 : 0;
+    const int v = (dropped == 2) ? 1 : 2;
+    std::map<Index2DType, IndexType> projection;
+    std::vector<Index2DType> projectedPoints;
+    for (const auto& point : points)
+    {
+      const Index2DType projected = { { point[u], point[v] } };
+      projection[projected] = point;
+      projectedPoints.push_back(projected);
+    }
+    std::vector<IndexType> vertices;
+    for (const auto& vertex : ComputeConvexHull2D(projectedPoints))
+      vertices.push_back(projection[vertex]);
+    return vertices;
+  }
+
+  ConvexHull3D hull(points);
+  return hull.Compute(simplex);
+}
+
+std::vector<mitk::ShapeFeatureKernel::Index2DType> mitk::ShapeFeatureKernel::ComputeConvexHull2D(std::vector<Index2DType> points)
+{
+  // Monotone chain
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  if (points.size() < 3)
+    return points;
+
+  std::vector<Index2DType> hull(2 * points.size());
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    while (k >= 2 && Cross2D(hull[k - 2], hull[k - 1], points[i]) <= 0)
+      --k;
+    hull[k++] = points[i];
+  }
+  for (std::size_t i = points.size() - 1, lower = k + 1; i > 0; --i)
+  {
+    while (k >= lower && Cross2D(hull[k - 2], hull[k - 1], points[i - 1]) <= 0)
+      --k;
+    hull[k++] = points[i - 1];
+  }
+  hull.resize(k - 1);
+  return hull;
+}
+
+double mitk::ShapeFeatureKernel::ComputeConvexPolygonDiameter(const std::vector<Index2DType>& polygon, double spacingX, double spacingY)
+{
+  auto distance = [&](const Index2DType& a, const Index2DType& b) {
+    const double dx = (a[0] - b[0]) * spacingX;
+    const double dy = (a[1] - b[1]) * spacingY;
+    return std::sqrt(dx * dx + dy * dy);
+  };
+
+  const std::size_t n = polygon.size();
+  if (n < 2)
+    return 0;
+  if (n == 2)
+    return distance(polygon[0], polygon[1]);
+
+  // Rotating calipers: for every edge, advance to the vertex farthest from it. The spacing scales all areas equally,
+  // so the comparisons are done exactly in index space.
+  double diameter = 0;
+  std::size_t j = 1;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const std::size_t next = (i + 1) % n;
+    while (Cross2D(polygon[i], polygon[next], polygon[(j + 1) % n]) > Cross2D(polygon[i], polygon[next], polygon[j]))
+      j = (j + 1) % n;
+    diameter = std::max(diameter, std::max(distance(polygon[i], polygon[j]), distance(polygon[next], polygon[j])));
+  }
+  return diameter;
+}
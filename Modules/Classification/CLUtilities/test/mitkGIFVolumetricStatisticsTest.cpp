@@ -13,15 +13,19 @@ found in the LICENSE file.
 #include <mitkTestingMacros.h>
 #include <mitkTestFixture.h>
 #include "mitkIOUtil.h"
+#include <mitkImageCast.h>
 #include <cmath>
 
 #include <mitkGIFVolumetricStatistics.h>
 
+#include <itkImageRegionConstIteratorWithIndex.h>
+
 class mitkGIFVolumetricStatisticsTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkGIFVolumetricStatisticsTestSuite);
 
   MITK_TEST(ImageDescription_PhantomTest);
+  MITK_TEST(MaximumDiameter_PhantomTest);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -31,6 +35,39 @@ private:
   mitk::Image::Pointer m_IBSI_Phantom_Mask_Small;
   mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
 
+  /** Largest distance between two masked voxels, compared pair by pair like the feature was calculated before
+  * the convex hull was used. If axis is 0, 1 or 2, only voxels in the same y-z, x-z or x-y plane are compared.*/
+  static double CalculateDiameterBruteForce(const mitk::Image* mask, int axis)
+  {
+    typedef itk::Image<int, 3> MaskType;
+    MaskType::Pointer itkMask = MaskType::New();
+    mitk::CastToItkImage(mask, itkMask);
+
+    std::vector<MaskType::IndexType> indices;
+    itk::ImageRegionConstIteratorWithIndex<MaskType> iter(itkMask, itkMask->GetLargestPossibleRegion());
+    for (; !iter.IsAtEnd(); ++iter)
+    {
+      if (iter.Get() != 0)
+        indices.push_back(iter.GetIndex());
+    }
+
+    double diameter = 0;
+    for (const auto& first : indices)
+    {
+      MaskType::PointType firstPoint;
+      itkMask->TransformIndexToPhysicalPoint(first, firstPoint);
+      for (const auto& second : indices)
+      {
+        if (axis >= 0 && first[axis] != second[axis])
+          continue;
+        MaskType::PointType secondPoint;
+        itkMask->TransformIndexToPhysicalPoint(second, secondPoint);
+        diameter = std::max(diameter, firstPoint.EuclideanDistanceTo(secondPoint));
+      }
+    }
+    return diameter;
+  }
+
 public:
 
   void setUp(void) override
@@ -53,7 +90,7 @@ public:
       MITK_INFO << mitk::AbstractGlobalImageFeature::GenerateLegacyFeatureNameWOEncoding(valuePair.first) << " : " << valuePair.second;
       results[mitk::AbstractGlobalImageFeature::GenerateLegacyFeatureNameWOEncoding(valuePair.first)] = valuePair.second;
     }
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("Volume Statistic should calculate 33 features.", std::size_t(38), featureList.size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Volume Statistic should calculate 41 features.", std::size_t(41), featureList.size());
 
     // These values are obtained in cooperation with IBSI
     // Default accuracy is 0.01
@@ -101,6 +138,25 @@ public:
     CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Volumetric Features::Compactness 1 old (mesh based) with Large IBSI Phantom Image", 6.278, results["Volumetric Features::Compactness 1 old (mesh based)"], 0.01);
   }
 
+  void MaximumDiameter_PhantomTest()
+  {
+    mitk::GIFVolumetricStatistics::Pointer featureCalculator = mitk::GIFVolumetricStatistics::New();
+
+    auto featureList = featureCalculator->CalculateFeatures(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+
+    std::map<std::string, double> results;
+    for (const auto &valuePair : featureList)
+    {
+      results[mitk::AbstractGlobalImageFeature::GenerateLegacyFeatureNameWOEncoding(valuePair.first)] = valuePair.second;
+    }
+
+    // The convex hull must not change the results of the exhaustive search
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Volumetric Features::Maximum 3D diameter should match the exhaustive search", CalculateDiameterBruteForce(m_IBSI_Phantom_Mask_Large, -1), results["Volumetric Features::Maximum 3D diameter"], 1e-10);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Volumetric Features::Maximum 2D diameter (axial plane) should match the exhaustive search", CalculateDiameterBruteForce(m_IBSI_Phantom_Mask_Large, 2), results["Volumetric Features::Maximum 2D diameter (axial plane)"], 1e-10);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Volumetric Features::Maximum 2D diameter (coronal plane) should match the exhaustive search", CalculateDiameterBruteForce(m_IBSI_Phantom_Mask_Large, 1), results["Volumetric Features::Maximum 2D diameter (coronal plane)"], 1e-10);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Volumetric Features::Maximum 2D diameter (sagittal plane) should match the exhaustive search", CalculateDiameterBruteForce(m_IBSI_Phantom_Mask_Large, 0), results["Volumetric Features::Maximum 2D diameter (sagittal plane)"], 1e-10);
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkGIFVolumetricStatistics )
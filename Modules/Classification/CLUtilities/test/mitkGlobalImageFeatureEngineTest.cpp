@@ -0,0 +1,174 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include "mitkIOUtil.h"
+#include <cmath>
+
+#include <mitkGlobalImageFeatureEngine.h>
+#include <mitkGIFCooccurenceMatrix2.h>
+#include <mitkGIFFirstOrderStatistics.h>
+#include <mitkGIFGreyLevelRunLength.h>
+#include <mitkGIFGreyLevelSizeZone.h>
+#include <mitkGIFNeighbouringGreyLevelDependenceFeatures.h>
+
+class mitkGlobalImageFeatureEngineTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkGlobalImageFeatureEngineTestSuite);
+
+  MITK_TEST(CalculateFeatures_PhantomTest_3D);
+  MITK_TEST(CalculateFeatures_PhantomTest_2D);
+  MITK_TEST(CalculateFeatures_MultipleCases);
+  MITK_TEST(CalculateFeatures_WithoutCache);
+  MITK_TEST(CalculateFeatures_NoFactory);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Small;
+  mitk::Image::Pointer m_IBSI_Phantom_Image_Large;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Small;
+  mitk::Image::Pointer m_IBSI_Phantom_Mask_Large;
+
+  static mitk::GlobalImageFeatureEngine::FeatureVectorType CreateFeatures()
+  {
+    mitk::GIFCooccurenceMatrix2::Pointer cooc2Calculator = mitk::GIFCooccurenceMatrix2::New();
+    cooc2Calculator->SetRanges({ 1.0, 2.0 });
+    mitk::GIFNeighbouringGreyLevelDependenceFeature::Pointer ngldCalculator = mitk::GIFNeighbouringGreyLevelDependenceFeature::New();
+    ngldCalculator->SetRanges({ 1.0, 2.0 });
+
+    mitk::GlobalImageFeatureEngine::FeatureVectorType features;
+    features.push_back(mitk::GIFFirstOrderStatistics::New().GetPointer());
+    features.push_back(cooc2Calculator.GetPointer());
+    features.push_back(mitk::GIFGreyLevelRunLength::New().GetPointer());
+    features.push_back(mitk::GIFGreyLevelSizeZone::New().GetPointer());
+    features.push_back(ngldCalculator.GetPointer());
+
+    for (auto& feature : features)
+    {
+      feature->SetUseBinsize(true);
+      feature->SetBinsize(1.0);
+      feature->SetUseMinimumIntensity(true);
+      feature->SetUseMaximumIntensity(true);
+      feature->SetMinimumIntensity(0.5);
+      feature->SetMaximumIntensity(6.5);
+    }
+    return features;
+  }
+
+  /** Calculates the features like CLGlobalImageFeatures did before the engine was introduced.*/
+  static mitk::AbstractGlobalImageFeature::FeatureListType CalculateSequentially(const mitk::Image* image, const mitk::Image* mask)
+  {
+    mitk::AbstractGlobalImageFeature::FeatureListType featureList;
+    for (auto& feature : CreateFeatures())
+    {
+      feature->CalculateAndAppendFeatures(image, mask, mask, featureList, false);
+    }
+    return featureList;
+  }
+
+  static mitk::GlobalImageFeatureEngine::CaseType CreateCase(const mitk::Image* image, const mitk::Image* mask)
+  {
+    mitk::GlobalImageFeatureEngine::CaseType inputCase;
+    inputCase.image = image;
+    inputCase.mask = mask;
+    inputCase.maskNoNaN = mask;
+    return inputCase;
+  }
+
+  static void CheckEqual(const mitk::AbstractGlobalImageFeature::FeatureListType& expected, const mitk::AbstractGlobalImageFeature::FeatureListType& result)
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Engine should calculate the same number of features.", expected.size(), result.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      const auto name = mitk::AbstractGlobalImageFeature::GenerateLegacyFeatureNameWOEncoding(expected[i].first);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Features should be in the same order.", name, mitk::AbstractGlobalImageFeature::GenerateLegacyFeatureNameWOEncoding(result[i].first));
+
+      const bool bothNaN = std::isnan(expected[i].second) && std::isnan(result[i].second);
+      CPPUNIT_ASSERT_MESSAGE(name + " should be identical.", bothNaN || expected[i].second == result[i].second);
+    }
+  }
+
+public:
+
+  void setUp(void) override
+  {
+    m_IBSI_Phantom_Image_Small = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Small.nrrd"));
+    m_IBSI_Phantom_Image_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Image_Large.nrrd"));
+    m_IBSI_Phantom_Mask_Small = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Small.nrrd"));
+    m_IBSI_Phantom_Mask_Large = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Radiomics/IBSI_Phantom_Mask_Large.nrrd"));
+  }
+
+  void CalculateFeatures_PhantomTest_3D()
+  {
+    auto expected = CalculateSequentially(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+
+    mitk::GlobalImageFeatureEngine::Pointer engine = mitk::GlobalImageFeatureEngine::New();
+    engine->SetFeatureFactory(&CreateFeatures);
+    engine->SetNumberOfThreads(4);
+    auto result = engine->CalculateFeatures(CreateCase(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large), false);
+
+    CheckEqual(expected, result);
+  }
+
+  void CalculateFeatures_PhantomTest_2D()
+  {
+    auto expected = CalculateSequentially(m_IBSI_Phantom_Image_Small, m_IBSI_Phantom_Mask_Small);
+
+    mitk::GlobalImageFeatureEngine::Pointer engine = mitk::GlobalImageFeatureEngine::New();
+    engine->SetFeatureFactory(&CreateFeatures);
+    engine->SetNumberOfThreads(4);
+    auto result = engine->CalculateFeatures(CreateCase(m_IBSI_Phantom_Image_Small, m_IBSI_Phantom_Mask_Small), false);
+
+    CheckEqual(expected, result);
+  }
+
+  void CalculateFeatures_MultipleCases()
+  {
+    std::vector<mitk::GlobalImageFeatureEngine::CaseType> cases;
+    cases.push_back(CreateCase(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large));
+    cases.push_back(CreateCase(m_IBSI_Phantom_Image_Small, m_IBSI_Phantom_Mask_Small));
+    cases.push_back(CreateCase(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large));
+
+    mitk::GlobalImageFeatureEngine::Pointer engine = mitk::GlobalImageFeatureEngine::New();
+    engine->SetFeatureFactory(&CreateFeatures);
+    auto results = engine->CalculateFeatures(cases, false);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Engine should return one feature list per case.", std::size_t(3), results.size());
+    auto expectedLarge = CalculateSequentially(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+    CheckEqual(expectedLarge, results[0]);
+    CheckEqual(CalculateSequentially(m_IBSI_Phantom_Image_Small, m_IBSI_Phantom_Mask_Small), results[1]);
+    CheckEqual(expectedLarge, results[2]);
+  }
+
+  void CalculateFeatures_WithoutCache()
+  {
+    auto expected = CalculateSequentially(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large);
+
+    mitk::GlobalImageFeatureEngine::Pointer engine = mitk::GlobalImageFeatureEngine::New();
+    engine->SetFeatureFactory(&CreateFeatures);
+    engine->SetNumberOfThreads(1);
+    engine->UseTextureMatrixCacheOff();
+    auto result = engine->CalculateFeatures(CreateCase(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large), false);
+
+    CheckEqual(expected, result);
+  }
+
+  void CalculateFeatures_NoFactory()
+  {
+    mitk::GlobalImageFeatureEngine::Pointer engine = mitk::GlobalImageFeatureEngine::New();
+    CPPUNIT_ASSERT_THROW(engine->CalculateFeatures(CreateCase(m_IBSI_Phantom_Image_Large, m_IBSI_Phantom_Mask_Large)), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkGlobalImageFeatureEngine)
@@ -0,0 +1,233 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <mitkShapeFeatureKernel.h>
+
+class mitkShapeFeatureKernelTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkShapeFeatureKernelTestSuite);
+
+  MITK_TEST(ConvexHull_Cube);
+  MITK_TEST(ConvexHull_Coplanar);
+  MITK_TEST(ConvexHull_Collinear);
+  MITK_TEST(ConvexPolygonDiameter);
+  MITK_TEST(Diameters_RandomMasks);
+  MITK_TEST(PrincipalMoments_RandomMasks);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::ShapeFeatureKernel::IndexType IndexType;
+
+  static double Distance(const IndexType& a, const IndexType& b, const std::array<double, 3>& spacing)
+  {
+    double sum = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      const double d = (a[i] - b[i]) * spacing[i];
+      sum += d * d;
+    }
+    return std::sqrt(sum);
+  }
+
+  /** Returns the voxels of a random mask: an ellipsoid, random noise or a box.*/
+  static std::vector<IndexType> CreateRandomMask(std::mt19937& generator, const std::array<unsigned int, 3>& size, int kind)
+  {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::array<double, 3> centre;
+    std::array<double, 3> radius;
+    for (int i = 0; i < 3; ++i)
+    {
+      centre[i] = uniform(generator) * size[i];
+      radius[i] = 1 + uniform(generator) * size[i] / 2.0;
+    }
+
+    std::vector<IndexType> voxels;
+    for (int z = 0; z < int(size[2]); ++z)
+    {
+      for (int y = 0; y < int(size[1]); ++y)
+      {
+        for (int x = 0; x < int(size[0]); ++x)
+        {
+          bool inside = false;
+          if (kind == 0)
+          {
+            const double dx = (x - centre[0]) / radius[0];
+            const double dy = (y - centre[1]) / radius[1];
+            const double dz = (z - centre[2]) / radius[2];
+            inside = dx * dx + dy * dy + dz * dz <= 1;
+          }
+          else if (kind == 1)
+          {
+            inside = uniform(generator) < 0.2;
+          }
+          else
+          {
+            inside = std::abs(x - centre[0]) <= radius[0] / 2 && std::abs(y - centre[1]) <= radius[1] / 2 && std::abs(z - centre[2]) <= radius[2] / 2;
+          }
+          if (inside)
+            voxels.push_back({ { x, y, z } });
+        }
+      }
+    }
+    return voxels;
+  }
+
+public:
+
+  void ConvexHull_Cube()
+  {
+    std::vector<IndexType> points;
+    for (int z = 0; z < 5; ++z)
+      for (int y = 0; y < 5; ++y)
+        for (int x = 0; x < 5; ++x)
+          points.push_back({ { x, y, z } });
+
+    auto vertices = mitk::ShapeFeatureKernel::ComputeConvexHull(points);
+    std::sort(vertices.begin(), vertices.end());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The hull of a filled cube should consist of its corners.", std::size_t(8), vertices.size());
+    CPPUNIT_ASSERT_MESSAGE("The first corner should be (0, 0, 0).", vertices.front() == IndexType({ { 0, 0, 0 } }));
+    CPPUNIT_ASSERT_MESSAGE("The last corner should be (4, 4, 4).", vertices.back() == IndexType({ { 4, 4, 4 } }));
+  }
+
+  void ConvexHull_Coplanar()
+  {
+    // Points on the tilted plane z = x + 2y, the hull is the parallelogram of the four corners
+    std::vector<IndexType> points;
+    for (int y = 0; y < 4; ++y)
+      for (int x = 0; x < 6; ++x)
+        points.push_back({ { x, y, x + 2 * y } });
+
+    auto vertices = mitk::ShapeFeatureKernel::ComputeConvexHull(points);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The hull of coplanar points should consist of the polygon corners.", std::size_t(4), vertices.size());
+  }
+
+  void ConvexHull_Collinear()
+  {
+    std::vector<IndexType> points = { { { 2, 2, 2 } }, { { 0, 1, 2 } }, { { 4, 3, 2 } }, { { 2, 2, 2 } } };
+    auto vertices = mitk::ShapeFeatureKernel::ComputeConvexHull(points);
+    std::sort(vertices.begin(), vertices.end());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The hull of collinear points should consist of the end points.", std::size_t(2), vertices.size());
+    CPPUNIT_ASSERT_MESSAGE("The hull should start at (0, 1, 2).", vertices.front() == IndexType({ { 0, 1, 2 } }));
+    CPPUNIT_ASSERT_MESSAGE("The hull should end at (4, 3, 2).", vertices.back() == IndexType({ { 4, 3, 2 } }));
+
+    std::vector<IndexType> single = { { { 1, 1, 1 } } };
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The hull of a single point should be the point.", std::size_t(1), mitk::ShapeFeatureKernel::ComputeConvexHull(single).size());
+  }
+
+  void ConvexPolygonDiameter()
+  {
+    std::vector<mitk::ShapeFeatureKernel::Index2DType> points = { { { 0, 0 } }, { { 3, 0 } }, { { 3, 1 } }, { { 1, 1 } }, { { 0, 1 } }, { { 2, 0 } } };
+    auto polygon = mitk::ShapeFeatureKernel::ComputeConvexHull2D(points);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The polygon should not contain collinear vertices.", std::size_t(4), polygon.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("The diameter should be the diagonal of the rectangle.", std::sqrt(9.0 * 4 + 1.0 * 9), mitk::ShapeFeatureKernel::ComputeConvexPolygonDiameter(polygon, 2.0, 3.0), 1e-12);
+  }
+
+  void Diameters_RandomMasks()
+  {
+    std::mt19937 generator(42);
+    for (int run = 0; run < 60; ++run)
+    {
+      std::array<unsigned int, 3> size = { { 1u + unsigned(generator() % 16), 1u + unsigned(generator() % 16), 1u + unsigned(generator() % 16) } };
+      std::array<double, 3> spacing = { { 0.5 + (generator() % 4) * 0.5, 0.7 + (generator() % 3) * 0.3, 1.0 + generator() % 3 } };
+      auto voxels = CreateRandomMask(generator, size, run % 3);
+
+      mitk::ShapeFeatureKernel kernel(size, spacing);
+      for (const auto& voxel : voxels)
+        kernel.AddVoxel(voxel, true);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Kernel should count all voxels.", voxels.size(), kernel.GetNumberOfVoxels());
+
+      double expected = 0;
+      std::array<double, 3> expectedPlanes = { { 0, 0, 0 } };
+      for (const auto& first : voxels)
+      {
+        for (const auto& second : voxels)
+        {
+          const double distance = Distance(first, second, spacing);
+          expected = std::max(expected, distance);
+          for (int axis = 0; axis < 3; ++axis)
+          {
+            if (first[axis] == second[axis])
+              expectedPlanes[axis] = std::max(expectedPlanes[axis], distance);
+          }
+        }
+      }
+
+      double diameter = 0;
+      auto vertices = kernel.GetConvexHullVertices();
+      for (const auto& first : vertices)
+        for (const auto& second : vertices)
+          diameter = std::max(diameter, Distance(first, second, spacing));
+
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Maximum 3D diameter should match the exhaustive search.", expected, diameter);
+      for (unsigned int axis = 0; axis < 3; ++axis)
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Maximum 2D diameter should match the exhaustive search.", expectedPlanes[axis], kernel.GetMaximumPlaneDiameter(axis), 1e-12);
+    }
+  }
+
+  void PrincipalMoments_RandomMasks()
+  {
+    std::mt19937 generator(7);
+    for (int run = 0; run < 20; ++run)
+    {
+      std::array<unsigned int, 3> size = { { 2u + unsigned(generator() % 20), 2u + unsigned(generator() % 20), 2u + unsigned(generator() % 20) } };
+      std::array<double, 3> spacing = { { 0.5, 1.0, 2.5 } };
+      auto voxels = CreateRandomMask(generator, size, run % 3);
+
+      // Only every other voxel has a valid intensity
+      mitk::ShapeFeatureKernel kernel(size, spacing);
+      std::vector<IndexType> validVoxels;
+      for (std::size_t i = 0; i < voxels.size(); ++i)
+      {
+        kernel.AddVoxel(voxels[i], i % 2 == 0);
+        if (i % 2 == 0)
+          validVoxels.push_back(voxels[i]);
+      }
+
+      for (int corrected = 0; corrected < 2; ++corrected)
+      {
+        const auto& points = corrected ? validVoxels : voxels;
+        if (points.size() < 2)
+          continue;
+
+        // Trace and sum of the principal minors of the covariance matrix are invariant to the eigen decomposition
+        std::array<double, 3> mean = { { 0, 0, 0 } };
+        for (const auto& point : points)
+          for (int i = 0; i < 3; ++i)
+            mean[i] += point[i] * spacing[i] / points.size();
+        double covariance[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+        for (const auto& point : points)
+          for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+              covariance[i][j] += (point[i] * spacing[i] - mean[i]) * (point[j] * spacing[j] - mean[j]) / (points.size() - 1);
+        const double trace = covariance[0][0] + covariance[1][1] + covariance[2][2];
+        const double minors = covariance[0][0] * covariance[1][1] - covariance[0][1] * covariance[0][1] +
+          covariance[0][0] * covariance[2][2] - covariance[0][2] * covariance[0][2] +
+          covariance[1][1] * covariance[2][2] - covariance[1][2] * covariance[1][2];
+
+        auto moments = kernel.GetPrincipalMoments(corrected == 1);
+        CPPUNIT_ASSERT_MESSAGE("Principal moments should be sorted ascending.", moments[0] <= moments[1] && moments[1] <= moments[2]);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Sum of the principal moments should be the trace of the covariance.", trace, moments[0] + moments[1] + moments[2], 1e-8 * (1 + trace));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Principal moments should match the principal minors of the covariance.", minors,
+          moments[0] * moments[1] + moments[0] * moments[2] + moments[1] * moments[2], 1e-8 * (1 + minors));
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkShapeFeatureKernel)
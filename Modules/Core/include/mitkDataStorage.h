@@ -21,12 +21,15 @@ found in the LICENSE file.
 #include <MitkCoreExports.h>
 #include <map>
 #include <mutex>
+#include <set>
+#include <shared_mutex>
 
 namespace mitk
 {
   class NodePredicateBase;
   class DataNode;
   class BaseRenderer;
+  class DataStorageView;
 
   //##Documentation
   //## @brief Data management class that handles 'was created by' relations
@@ -38,6 +41,9 @@ namespace mitk
   //## If a new node is added to the DataStorage, AddNodeEvent is emitted.
   //## If a node is removed, RemoveNodeEvent is emitted.
   //##
+  //## The DataStorage incrementally maintains indexes of the names, data types and selected property
+  //## values of its nodes (see GetSubsetByName(), GetSubsetByDataType() and GetSubsetByProperty()) and
+  //## keeps its DataStorageView objects up to date.
   //##
   //## \ingroup DataStorage
   class MITKCORE_EXPORT DataStorage : public itk::Object
@@ -100,6 +106,28 @@ namespace mitk
     //## conditions. A set of all objects can be retrieved with the GetAll() method;
     SetOfObjects::ConstPointer GetSubset(const NodePredicateBase *condition) const;
 
+    //##Documentation
+    //## @brief returns all nodes whose "name" property is a StringProperty with the given value
+    //##
+    //## Equivalent to GetSubset() with a NodePredicateProperty("name", StringProperty::New(name)),
+    //## but answered by an index instead of evaluating all nodes.
+    SetOfObjects::ConstPointer GetSubsetByName(const std::string &name) const;
+
+    //##Documentation
+    //## @brief returns all nodes whose data object is of the given class (see itk::LightObject::GetNameOfClass())
+    //##
+    //## Equivalent to GetSubset() with a NodePredicateDataType(className), but answered by an index.
+    SetOfObjects::ConstPointer GetSubsetByDataType(const std::string &className) const;
+
+    //##Documentation
+    //## @brief returns all nodes that have a property with the given key and value
+    //##
+    //## Equivalent to GetSubset() with a NodePredicateProperty(key, value). If value is nullptr, all nodes that
+    //## have a property with the given key are returned. Properties are looked up like DataNode::GetProperty()
+    //## without a renderer. The first query of a key builds the index of the key, further queries are
+    //## answered by the index.
+    SetOfObjects::ConstPointer GetSubsetByProperty(const std::string &key, const BaseProperty *value = nullptr) const;
+
     //##Documentation
     //## @brief returns a set of source objects for a given node that meet the given condition(s).
     //##
@@ -371,6 +399,8 @@ namespace mitk
     void BlockNodeModifiedEvents(bool block);
 
   protected:
+    friend class DataStorageView;
+
     //##Documentation
     //## @brief  EmitAddNodeEvent emits the AddNodeEvent
     //##
@@ -415,6 +445,17 @@ namespace mitk
     //## to suppress NodeChangedEvent to be emitted.
     bool m_BlockNodeModifiedEvents;
 
+    //##Documentation
+    //## @brief Registers a view that is notified about added, removed and modified nodes.
+    //##
+    //## The property keys of the predicate of the view are indexed, so that modifications of
+    //## these properties are noticed, too.
+    void RegisterView(DataStorageView *view, const std::set<std::string> &propertyKeys);
+
+    //##Documentation
+    //## @brief Unregisters a view that has been registered with RegisterView()
+    void UnregisterView(DataStorageView *view, const std::set<std::string> &propertyKeys);
+
     DataStorage();
     ~DataStorage() override;
 
@@ -425,6 +466,57 @@ namespace mitk
     //##Documentation
     //## @brief Prints the contents of the DataStorage to os. Do not call directly, call ->Print() instead
     void PrintSelf(std::ostream &os, itk::Indent indent) const override;
+
+  private:
+    typedef std::set<const DataNode *> NodeSetType;
+
+    struct IndexedProperty
+    {
+      const BaseProperty *m_Property;
+      std::string m_Value;
+    };
+
+    struct NodeIndexEntry
+    {
+      std::string m_DataType;
+      std::map<std::string, IndexedProperty> m_Properties;
+    };
+
+    struct PropertyObservation
+    {
+      BaseProperty::ConstPointer m_Property;
+      unsigned long m_ObserverTag;
+      std::set<std::pair<const DataNode *, std::string>> m_Owners;
+    };
+
+    void IndexNode(const DataNode *node);
+    void UnindexNode(const DataNode *node);
+    void ReindexNode(const DataNode *node);
+    void IndexProperty(const DataNode *node, NodeIndexEntry &entry, const std::string &key);
+    void UnindexProperty(const DataNode *node, NodeIndexEntry &entry, const std::string &key);
+    void TrackPropertyKey(const std::string &key);
+    void UntrackPropertyKey(const std::string &key);
+
+    //##Documentation
+    //## @brief Updates the index entries of all nodes that own the modified property and notifies the views.
+    void OnPropertyModified(const itk::Object *caller, const itk::EventObject &event);
+
+    //##Documentation
+    //## @brief Calls notify for all registered views. Views that are unregistered meanwhile are skipped.
+    template <typename TFunction>
+    void NotifyViews(TFunction notify);
+
+    SetOfObjects::ConstPointer ToSetOfObjects(const NodeSetType &nodes) const;
+
+    mutable std::shared_mutex m_IndexMutex;
+    std::map<const DataNode *, NodeIndexEntry> m_NodeIndex;
+    std::map<std::string, NodeSetType> m_DataTypeIndex;
+    std::map<std::string, std::map<std::string, NodeSetType>> m_PropertyIndex;
+    std::map<std::string, unsigned int> m_TrackedPropertyKeys;
+    std::map<const BaseProperty *, PropertyObservation> m_ObservedProperties;
+
+    std::recursive_mutex m_ViewsMutex;
+    std::set<DataStorageView *> m_Views;
   };
 
   //##Documentation
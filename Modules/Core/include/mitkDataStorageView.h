@@ -0,0 +1,115 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKDATASTORAGEVIEW_H
+#define MITKDATASTORAGEVIEW_H
+
+#include "mitkDataStorage.h"
+#include "mitkNodePredicateBase.h"
+#include "mitkWeakPointer.h"
+
+#include <set>
+#include <shared_mutex>
+#include <string>
+
+namespace mitk
+{
+  //##Documentation
+  //## @brief Live result of a GetSubset() query
+  //##
+  //## A DataStorageView holds the nodes of a DataStorage that meet a predicate. Instead of evaluating
+  //## the predicate for all nodes on every query, the DataStorage notifies its views about added, removed
+  //## and modified nodes, so that only the affected node has to be re-evaluated. Modifications of the
+  //## properties that are checked by the predicate (see NodePredicateBase::CollectPropertyKeys()) are
+  //## noticed, too, even if the property value is changed directly via its SetValue() method.
+  //##
+  //## Renderer-specific properties and other state the predicate depends on (e.g. the properties or
+  //## the geometry of the data object) are not observed. Call Refresh() if these change. Views with a predicate
+  //## that depends on the relations within the DataStorage (see NodePredicateBase::DependsOnDataStorage())
+  //## are re-evaluated completely on the next query after any change of the DataStorage.
+  //##
+  //## GetNodes() returns an immutable snapshot that may be used concurrently by multiple threads.
+  //## The view emits an itk::ModifiedEvent whenever its nodes (may) have changed.
+  //##
+  //## \code
+  //## auto view = mitk::DataStorageView::New(dataStorage, mitk::NodePredicateDataType::New("Image"));
+  //## auto images = view->GetNodes();
+  //## \endcode
+  //##
+  //## @ingroup DataStorage
+  class MITKCORE_EXPORT DataStorageView : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(DataStorageView, itk::Object);
+    mitkNewMacro2Param(Self, DataStorage *, const NodePredicateBase *);
+
+    //##Documentation
+    //## @brief Returns the nodes that meet the predicate, ordered like the result of DataStorage::GetSubset()
+    DataStorage::SetOfObjects::ConstPointer GetNodes() const;
+
+    //##Documentation
+    //## @brief Checks if the node meets the predicate
+    bool Contains(const DataNode *node) const;
+
+    //##Documentation
+    //## @brief Returns the number of nodes that meet the predicate
+    unsigned int GetSize() const;
+
+    //##Documentation
+    //## @brief Re-evaluates the predicate for all nodes of the DataStorage
+    void Refresh();
+
+    const NodePredicateBase *GetPredicate() const;
+
+  protected:
+    friend class DataStorage;
+
+    //##Documentation
+    //## @brief Constructor. A nullptr predicate is met by all nodes.
+    DataStorageView(DataStorage *dataStorage, const NodePredicateBase *predicate);
+    ~DataStorageView() override;
+
+    void OnNodeAdded(const DataNode *node);
+    void OnNodeRemoved(const DataNode *node);
+    void OnNodeModified(const DataNode *node);
+    void OnPropertyModified(const DataNode *node, const std::string &propertyKey);
+
+  private:
+    typedef std::set<const DataNode *> NodeSetType;
+
+    //##Documentation
+    //## @brief Evaluates the predicate for all nodes of the DataStorage. m_Mutex has to be locked exclusively.
+    void Evaluate() const;
+
+    //##Documentation
+    //## @brief Inserts node into or removes node from m_Nodes. Returns true if the nodes changed.
+    bool Update(const DataNode *node, bool meetsPredicate);
+
+    //##Documentation
+    //## @brief Marks the nodes for re-evaluation. Returns true if they have not been marked already.
+    bool Invalidate();
+
+    bool CheckNode(const DataNode *node) const;
+
+    WeakPointer<DataStorage> m_DataStorage;
+    NodePredicateBase::ConstPointer m_Predicate;
+    std::set<std::string> m_PropertyKeys;
+    bool m_DependsOnDataStorage;
+
+    mutable std::shared_mutex m_Mutex;
+    mutable NodeSetType m_Nodes;
+    mutable bool m_OutOfDate;
+    mutable DataStorage::SetOfObjects::ConstPointer m_Snapshot;
+  };
+} // namespace mitk
+
+#endif // MITKDATASTORAGEVIEW_H
@@ -34,8 +34,14 @@ namespace mitk
    *
    * This filter is completely based on ITK compared to the VTK-based
    * mitk::ExtractSliceFilter. It is more robust, easy to use, and produces
-   * an mitk::Image with valid geometry. Generally it is not as fast as
-   * mitk::ExtractSliceFilter, though.
+   * an mitk::Image with valid geometry.
+   *
+   * The output rows are distributed across the ITK thread pool. Nearest
+   * neighbor and linear interpolation are evaluated by pixel type-specific
+   * loops that step through the input index space incrementally instead of
+   * transforming every output pixel individually. If the output plane is
+   * aligned with the axes of the input image and no interpolation between
+   * voxels is necessary, the slice is copied directly from the input buffer.
    */
   class MITKCORE_EXPORT ExtractSliceFilter2 final : public ImageToImageFilter
   {
@@ -67,9 +73,8 @@ namespace mitk
     ~ExtractSliceFilter2() override;
 
     void AllocateOutputs() override;
-    // void BeforeThreadedGenerateData() override;
-    // void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
-    void GenerateData() override;
+    void BeforeThreadedGenerateData() override;
+    void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
     void VerifyInputInformation() const override;
 
     struct Impl;
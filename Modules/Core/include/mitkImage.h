@@ -229,6 +229,23 @@ namespace mitk
                                   int n = 0,
                                   ImportMemoryManagementType importMemoryManagement = CopyMemory);
 
+    /**
+      * @brief Set the memory @a data of channel @a n, which was provided by @a allocator.
+      *
+      * The image takes over the memory and returns it to @a allocator when it is released. This is how
+      * readers hand over memory-mapped files, for example (see MappedFileImageDataAllocator).
+      */
+    bool SetImportChannel(void *data, int n, ImageDataAllocator *allocator);
+
+    /**
+      * @brief Allocator of the memory of slices, volumes and channels that are allocated by this image.
+      *
+      * If no allocator is set (default), ImageDataAllocator::GetDefaultAllocator() is used. Set the allocator
+      * before the data is accessed for the first time, data that was already allocated is not moved.
+      */
+    itkSetObjectMacro(DataAllocator, ImageDataAllocator);
+    itkGetObjectMacro(DataAllocator, ImageDataAllocator);
+
     /**
       * initialize new (or re-initialize) image information
       * @warning Initialize() by pic assumes a plane, evenly spaced geometry starting at (0,0,0).
@@ -573,6 +590,8 @@ namespace mitk
     size_t *m_OffsetTable;
     ImageDataItemPointer m_CompleteData;
 
+    ImageDataAllocator::Pointer m_DataAllocator;
+
     // Image statistics Holder replaces the former implementation directly inside this class
     friend class ImageStatisticsHolder;
     StatisticsHolderPointer m_ImageStatistics;
@@ -0,0 +1,202 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkImageDataAllocator_h
+#define mitkImageDataAllocator_h
+
+#include "mitkCommon.h"
+#include <MitkCoreExports.h>
+
+#include <itkObject.h>
+
+namespace mitk
+{
+  /**
+   * \brief Provides the memory of ImageDataItems.
+   *
+   * An ImageDataItem that allocates its memory keeps a reference to the allocator and returns the
+   * memory to it on destruction. Images use the default allocator, unless an allocator is set by
+   * Image::SetDataAllocator().
+   *
+   * Allocators must be thread-safe, since images may be allocated by several threads at once.
+   *
+   * \sa HeapImageDataAllocator, AlignedImageDataAllocator, HugePageImageDataAllocator,
+   *     FileBackedImageDataAllocator, MappedFileImageDataAllocator
+   * \ingroup Data
+   */
+  class MITKCORE_EXPORT ImageDataAllocator : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(ImageDataAllocator, itk::Object);
+
+    /**
+     * \brief Allocate a block of numberOfBytes bytes.
+     * \throw itk::MemoryAllocationError if the memory cannot be provided.
+     */
+    virtual void *Allocate(size_t numberOfBytes) = 0;
+
+    /** \brief Release a block returned by Allocate(). numberOfBytes is the size it was allocated with.*/
+    virtual void Deallocate(void *data, size_t numberOfBytes) = 0;
+
+    /** \brief The allocator of images without an allocator of their own (a HeapImageDataAllocator by default).*/
+    static ImageDataAllocator::Pointer GetDefaultAllocator();
+
+    /** \brief Replace the default allocator. nullptr restores the HeapImageDataAllocator.*/
+    static void SetDefaultAllocator(ImageDataAllocator *allocator);
+
+  protected:
+    ImageDataAllocator();
+    ~ImageDataAllocator() override;
+  };
+
+  /**
+   * \brief Allocates memory by new[] and releases it by delete[], like images always did.
+   *
+   * Memory that is imported into an image with Image::ManageMemory is released by delete[], too.
+   */
+  class MITKCORE_EXPORT HeapImageDataAllocator : public ImageDataAllocator
+  {
+  public:
+    mitkClassMacro(HeapImageDataAllocator, ImageDataAllocator);
+    itkFactorylessNewMacro(Self);
+
+    void *Allocate(size_t numberOfBytes) override;
+    void Deallocate(void *data, size_t numberOfBytes) override;
+
+  protected:
+    HeapImageDataAllocator();
+    ~HeapImageDataAllocator() override;
+  };
+
+  /**
+   * \brief Allocates memory aligned to 64 bytes (the width of a cache line and of AVX-512 registers),
+   * so that SIMD kernels can use aligned loads and stores on image buffers.
+   */
+  class MITKCORE_EXPORT AlignedImageDataAllocator : public ImageDataAllocator
+  {
+  public:
+    mitkClassMacro(AlignedImageDataAllocator, ImageDataAllocator);
+    itkFactorylessNewMacro(Self);
+
+    /** \brief Alignment in bytes, a power of two of at least sizeof(void *). Default: 64.*/
+    void SetAlignment(size_t alignment);
+    itkGetConstMacro(Alignment, size_t);
+
+    void *Allocate(size_t numberOfBytes) override;
+    void Deallocate(void *data, size_t numberOfBytes) override;
+
+  protected:
+    AlignedImageDataAllocator();
+    ~AlignedImageDataAllocator() override;
+
+  private:
+    size_t m_Alignment;
+  };
+
+  /**
+   * \brief Allocates memory in blocks of 2 MiB and asks the operating system to back them by transparent
+   * huge pages, which reduces TLB misses when large images are traversed.
+   *
+   * Huge pages are requested by madvise(MADV_HUGEPAGE) on Linux. On other platforms, the memory is mapped
+   * with the default page size.
+   */
+  class MITKCORE_EXPORT HugePageImageDataAllocator : public ImageDataAllocator
+  {
+  public:
+    mitkClassMacro(HugePageImageDataAllocator, ImageDataAllocator);
+    itkFactorylessNewMacro(Self);
+
+    static const size_t HugePageSize = 2 * 1024 * 1024;
+
+    void *Allocate(size_t numberOfBytes) override;
+    void Deallocate(void *data, size_t numberOfBytes) override;
+
+  protected:
+    HugePageImageDataAllocator();
+    ~HugePageImageDataAllocator() override;
+  };
+
+  /**
+   * \brief Allocates memory that is backed by a temporary file instead of the swap space.
+   *
+   * Every allocation maps a new file in Directory (the temporary directory by default), which is deleted
+   * as soon as it is unmapped. The operating system writes modified pages to that file and reclaims them
+   * under memory pressure, thus images larger than the physical memory can be held.
+   */
+  class MITKCORE_EXPORT FileBackedImageDataAllocator : public ImageDataAllocator
+  {
+  public:
+    mitkClassMacro(FileBackedImageDataAllocator, ImageDataAllocator);
+    itkFactorylessNewMacro(Self);
+
+    /** \brief Directory of the backing files. Empty (default) means the temporary directory.*/
+    itkSetStringMacro(Directory);
+    itkGetStringMacro(Directory);
+
+    void *Allocate(size_t numberOfBytes) override;
+    void Deallocate(void *data, size_t numberOfBytes) override;
+
+  protected:
+    FileBackedImageDataAllocator();
+    ~FileBackedImageDataAllocator() override;
+
+  private:
+    std::string m_Directory;
+  };
+
+  /**
+   * \brief Provides the contents of a file as memory by mapping it.
+   *
+   * Allocate(numberOfBytes) maps the numberOfBytes bytes at Offset of FileName copy-on-write. Pages are read
+   * lazily when they are accessed for the first time, and unmodified pages can be reclaimed by the operating
+   * system at any time. Modifications of the memory are private, i.e. they never reach the file.
+   *
+   * The file must not be truncated or modified by other processes while it is mapped. Writers of MITK call
+   * DetachFromFile() before they open a file, so images can be saved to the file they were mapped from.
+   */
+  class MITKCORE_EXPORT MappedFileImageDataAllocator : public ImageDataAllocator
+  {
+  public:
+    mitkClassMacro(MappedFileImageDataAllocator, ImageDataAllocator);
+    itkFactorylessNewMacro(Self);
+
+    itkSetStringMacro(FileName);
+    itkGetStringMacro(FileName);
+
+    /** \brief Position of the first mapped byte in the file. It does not need to be aligned to pages.*/
+    itkSetMacro(Offset, size_t);
+    itkGetConstMacro(Offset, size_t);
+
+    void *Allocate(size_t numberOfBytes) override;
+    void Deallocate(void *data, size_t numberOfBytes) override;
+
+    /**
+     * \brief Copies all memory mapped from the file into anonymous memory at the same addresses.
+     *
+     * Afterwards the file can be overwritten or deleted without affecting the images. This reads all
+     * pages of the file that were not accessed yet. The memory must not be accessed by other threads
+     * during the call.
+     * \throw itk::MemoryAllocationError if the memory cannot be replaced.
+     */
+    static void DetachFromFile(const std::string &fileName);
+
+  protected:
+    MappedFileImageDataAllocator();
+    ~MappedFileImageDataAllocator() override;
+
+  private:
+    std::string m_FileName;
+    size_t m_Offset;
+  };
+}
+
+#endif
@@ -15,6 +15,7 @@ found in the LICENSE file.
 
 #include "mitkCommon.h"
 #include <MitkCoreExports.h>
+#include "mitkImageDataAllocator.h"
 #include "mitkImageDescriptor.h"
 
 class vtkImageData;
@@ -39,6 +40,9 @@ namespace mitk
   //## It should not be used outside of this.
   //##
   //## @param manageMemory Determines if image data is removed while destruction of ImageDataItem or not.
+  //## @param allocator Provides the memory if no data is given and releases it on destruction. If no allocator is
+  //## given, memory is allocated by the default allocator (see ImageDataAllocator), while given data is released
+  //## by delete[].
   //## @ingroup Data
   class MITKCORE_EXPORT ImageDataItem : public itk::LightObject
   {
@@ -73,14 +77,19 @@ namespace mitk
 
     ~ImageDataItem() override;
 
-    ImageDataItem(const mitk::ImageDescriptor::Pointer desc, int timestep, void *data, bool manageMemory);
+    ImageDataItem(const mitk::ImageDescriptor::Pointer desc,
+                  int timestep,
+                  void *data,
+                  bool manageMemory,
+                  ImageDataAllocator *allocator = nullptr);
 
     ImageDataItem(const mitk::PixelType &type,
                   int timestep,
                   unsigned int dimension,
                   unsigned int *dimensions,
                   void *data,
-                  bool manageMemory);
+                  bool manageMemory,
+                  ImageDataAllocator *allocator = nullptr);
 
     ImageDataItem(const ImageDataItem &other);
 
@@ -117,6 +126,8 @@ namespace mitk
 
     // Returns if image data should be deleted on destruction of ImageDataItem.
     bool GetManageMemory() const { return m_ManageMemory; }
+    // Returns the allocator that releases the image data, nullptr if it is released by delete[].
+    const ImageDataAllocator *GetAllocator() const { return m_Allocator; }
     virtual void ConstructVtkImageData(ImageConstPointer) const;
 
     size_t GetSize() const { return m_Size; }
@@ -147,6 +158,9 @@ namespace mitk
 
   private:
     void ComputeItemSize(const unsigned int *dimensions, unsigned int dimension);
+    void AllocateData(ImageDataAllocator *allocator);
+
+    ImageDataAllocator::Pointer m_Allocator;
 
     ImageDataItem::ConstPointer m_Parent;
 
@@ -47,6 +47,19 @@ namespace mitk
     void Write() override;
     ConfidenceLevel GetWriterConfidenceLevel() const override;
 
+    /**
+     * \brief Map uncompressed files into memory instead of reading them (disabled by default).
+     *
+     * If enabled, the pixels of raw encoded NRRD files and of uncompressed single file NIfTI images are not
+     * read, but the file is mapped copy-on-write (see MappedFileImageDataAllocator): loading is nearly
+     * instantaneous and pages are read from disk when they are accessed. Files that need conversion while
+     * reading (foreign byte order, intensity scaling, multi-component pixels) are read as before.
+     *
+     * The files must not be modified while their images exist.
+     */
+    static void SetMemoryMappingEnabled(bool enabled);
+    static bool GetMemoryMappingEnabled();
+
   protected:
     virtual std::vector<std::string> FixUpImageIOExtensions(const std::string &imageIOName);
     virtual void FixUpCustomMimeTypeName(const std::string &imageIOName, CustomMimeType &customMimeType);
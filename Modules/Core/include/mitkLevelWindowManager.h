@@ -16,6 +16,7 @@ found in the LICENSE file.
 // mitk core
 #include "mitkBaseProperty.h"
 #include "mitkDataStorage.h"
+#include "mitkDataStorageView.h"
 #include "mitkLevelWindowProperty.h"
 
 //  c++
@@ -171,6 +172,7 @@ namespace mitk
     ~LevelWindowManager() override;
 
     DataStorage::Pointer m_DataStorage;
+    DataStorageView::Pointer m_RelevantNodes;
     LevelWindowProperty::Pointer m_LevelWindowProperty;
 
     typedef std::pair<unsigned long, DataNode::Pointer> PropDataPair;
@@ -25,6 +25,8 @@ found in the LICENSE file.
 #pragma GCC visibility pop
 
 #include <deque>
+#include <map>
+#include <string>
 
 namespace mitk
 {
@@ -33,6 +35,14 @@ namespace mitk
   //##
   //## Derived from UndoModel AND itk::Object. Invokes ITK-events to signal listening
   //## GUI elements, whether each of the stacks is empty or not (to enable/disable button, ...)
+  //##
+  //## Besides the number of items (see SetUndoLimit()) the memory occupied by the
+  //## history can be limited (see SetUndoMemoryLimit()). If the items of both stacks
+  //## exceed the memory limit, the bulk data of the oldest swappable items (see
+  //## UndoStackItem::IsSwappable()) is written to temporary files and released from
+  //## memory. Swapped items are read back when they are undone or redone. The items
+  //## on top of both stacks are never swapped. The memory limit is disabled by
+  //## default; UndoController::SetUndoMemoryLimit() sets it for all undo models.
   class MITKCORE_EXPORT LimitedLinearUndo : public UndoModel
   {
   public:
@@ -100,6 +110,32 @@ namespace mitk
     //## @param limit the maximum number of items on the stack
     void SetUndoLimit(std::size_t limit) override;
 
+    //##Documentation
+    //## @brief Gets the limit on the memory (in bytes) the undo history
+    //## may occupy before items are swapped to disk.
+    //## The 0 value means that there is no limit.
+    std::size_t GetUndoMemoryLimit() const override;
+
+    //##Documentation
+    //## @brief Sets a limit on the memory (in bytes) the undo history
+    //## may occupy. If the limit is exceeded, the oldest items are
+    //## swapped to temporary files.
+    //## The 0 value means that there is no limit.
+    void SetUndoMemoryLimit(std::size_t limit) override;
+
+    //##Documentation
+    //## @brief Returns the number of bytes the items of the undo and
+    //## redo stack currently occupy in memory.
+    std::size_t GetUndoMemoryUsage() const override;
+
+    //##Documentation
+    //## @brief Returns the number of bytes of swapped items on disk.
+    std::size_t GetSwappedUndoMemory() const;
+
+    //##Documentation
+    //## @brief Returns the number of items that are currently swapped to disk.
+    std::size_t GetNumberOfSwappedItems() const;
+
     //##Documentation
     //## @brief Returns the ObjectEventId of the
     //## top element in the OperationHistory
@@ -128,6 +164,16 @@ namespace mitk
     //## elements in the list and to clear the list
     void ClearList(UndoContainer *list);
 
+    //## @brief Frees the memory of an item that was removed from the stacks
+    //## and removes its swap file, if any
+    void DeleteStackItem(UndoStackItem *item);
+
+    //## @brief Swaps out the oldest items until the memory limit is met
+    void EnforceUndoMemoryLimit();
+
+    //## @brief Reads the data of a swapped item back into memory
+    void SwapInItem(UndoStackItem *item);
+
     UndoContainer m_UndoList;
 
     UndoContainer m_RedoList;
@@ -135,7 +181,18 @@ namespace mitk
   private:
     int FirstObjectEventIdOfCurrentGroup(UndoContainer &stack);
 
+    bool SwapOutItem(UndoStackItem *item);
+
     std::size_t m_UndoLimit;
+    std::size_t m_UndoMemoryLimit;
+
+    struct SwappedItem
+    {
+      std::string FileName;
+      std::size_t Size;
+    };
+
+    std::map<UndoStackItem *, SwappedItem> m_SwappedItems;
 
   };
 
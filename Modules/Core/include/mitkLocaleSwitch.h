@@ -31,6 +31,10 @@ namespace mitk
 
     WARNING: Please be aware that using setlocale and there for is not thread
     safe. So use this class with care (see tast T24295 for more information.
+    Switches to the same locale that are active at the same time (e.g. in jobs
+    running concurrently) share the installed locale: only the first one calls
+    setlocale and the last one restores the previous locale. Switching to
+    different locales concurrently is still not thread safe.
     This switch is especially use full if you have to deal with third party code
     where you have to controll the locale via set locale
     \code
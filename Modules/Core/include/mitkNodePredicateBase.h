@@ -17,6 +17,9 @@ found in the LICENSE file.
 #include <MitkCoreExports.h>
 #include <mitkCommon.h>
 
+#include <set>
+#include <string>
+
 namespace mitk
 {
   class DataNode;
@@ -44,6 +47,19 @@ namespace mitk
     //##Documentation
     //## @brief This method will be used to evaluate the node. Has to be overwritten in subclasses
     virtual bool CheckNode(const mitk::DataNode *node) const = 0;
+
+    //##Documentation
+    //## @brief Adds the keys of all node properties that are evaluated by CheckNode() to keys.
+    //##
+    //## DataStorageView uses these keys to re-evaluate a node if one of these properties is modified.
+    //## The default implementation adds nothing.
+    virtual void CollectPropertyKeys(std::set<std::string> &keys) const;
+
+    //##Documentation
+    //## @brief Returns true if the result of CheckNode() depends on the relations of the node within a DataStorage.
+    //##
+    //## The default implementation returns false.
+    virtual bool DependsOnDataStorage() const;
   };
 
 } // namespace mitk
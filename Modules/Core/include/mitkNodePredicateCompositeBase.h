@@ -48,6 +48,14 @@ namespace mitk
     //## @brief Return all child predicates (immutable).
     virtual ChildPredicates GetPredicates() const;
 
+    //##Documentation
+    //## @brief Collects the property keys of all child predicates.
+    void CollectPropertyKeys(std::set<std::string> &keys) const override;
+
+    //##Documentation
+    //## @brief Returns true if any child predicate depends on the DataStorage.
+    bool DependsOnDataStorage() const override;
+
   protected:
     //##Documentation
     //## @brief list of child predicates
@@ -42,6 +42,10 @@ namespace mitk
     //## @brief Checks, if the node is a source node of m_BaseNode (e.g. if m_BaseNode "was created from" node)
     bool CheckNode(const mitk::DataNode *node) const override;
 
+    //##Documentation
+    //## @brief Returns true, since the result depends on the relations within the DataStorage
+    bool DependsOnDataStorage() const override;
+
   protected:
     //##Documentation
     //## @brief Constructor - This class can either search only for direct source objects or for all source objects
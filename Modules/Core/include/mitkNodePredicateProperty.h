@@ -44,6 +44,10 @@ namespace mitk
     //## @brief Checks, if the nodes contains a property that is equal to m_ValidProperty
     bool CheckNode(const mitk::DataNode *node) const override;
 
+    //##Documentation
+    //## @brief Adds the name of the checked property
+    void CollectPropertyKeys(std::set<std::string> &keys) const override;
+
   protected:
     //##Documentation
     //## @brief Constructor to check for a named property
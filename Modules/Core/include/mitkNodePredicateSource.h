@@ -41,6 +41,10 @@ namespace mitk
     //## @brief Checks, if m_BaseNode is a source node of childNode  (e.g. if childNode "was created from" m_BaseNode)
     bool CheckNode(const mitk::DataNode *childNode) const override;
 
+    //##Documentation
+    //## @brief Returns true, since the result depends on the relations within the DataStorage
+    bool DependsOnDataStorage() const override;
+
   protected:
     //##Documentation
     //## @brief Constructor - This class can either search only for direct source objects or for all source objects
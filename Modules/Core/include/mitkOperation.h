@@ -18,6 +18,8 @@ found in the LICENSE file.
 
 #include <mitkCommon.h>
 
+#include <iosfwd>
+
 namespace mitk
 {
   typedef int OperationType;
@@ -39,6 +41,26 @@ namespace mitk
 
     OperationType GetOperationType();
 
+    //##Documentation
+    //## @brief Returns the number of bytes of memory held by the operation.
+    //## Used by undo models to limit the memory of the undo history.
+    //## The default implementation only accounts for the operation object
+    //## itself. Operations that keep bulk data (e.g. images) should override it.
+    virtual std::size_t GetMemoryFootprint() const;
+
+    //##Documentation
+    //## @brief True if the operation can release its bulk data by SwapOut().
+    virtual bool IsSwappable() const;
+
+    //##Documentation
+    //## @brief Writes the bulk data of the operation to the stream and releases
+    //## it from memory. The operation must not be executed until SwapIn() restored the data.
+    virtual void SwapOut(std::ostream &stream);
+
+    //##Documentation
+    //## @brief Restores the bulk data written by SwapOut().
+    virtual void SwapIn(std::istream &stream);
+
   protected:
     OperationType m_OperationType;
   };
@@ -74,6 +74,23 @@ namespace mitk
     virtual void ReverseOperations();
     virtual void ReverseAndExecute();
 
+    //##Documentation
+    //## @brief Returns the number of bytes of memory held by this item.
+    virtual std::size_t GetMemoryFootprint() const;
+
+    //##Documentation
+    //## @brief True if the item can release memory by SwapOut().
+    virtual bool IsSwappable() const;
+
+    //##Documentation
+    //## @brief Writes the bulk data of the item to the stream and releases it from memory.
+    //## Undo models have to call SwapIn() before the item is executed again.
+    virtual void SwapOut(std::ostream &stream);
+
+    //##Documentation
+    //## @brief Restores the bulk data written by SwapOut().
+    virtual void SwapIn(std::istream &stream);
+
     //##Documentation
     //## @brief Increases the current ObjectEventId
     //## For example if a button click generates operations the ObjectEventId has to be incremented to be able to undo
@@ -166,6 +183,17 @@ namespace mitk
     //##reverses and executes both operations (used, when moved from undo to redo stack)
     void ReverseAndExecute() override;
 
+    //## @brief Returns the memory of this item and of both operations
+    std::size_t GetMemoryFootprint() const override;
+
+    //## @brief True if one of the operations is swappable
+    bool IsSwappable() const override;
+
+    //## @brief Swaps out the swappable operations (operation first, then undo operation)
+    void SwapOut(std::ostream &stream) override;
+
+    void SwapIn(std::istream &stream) override;
+
     //## @brief returns true if the destination still is present
     //## and false if it already has been deleted
     virtual bool IsValid();
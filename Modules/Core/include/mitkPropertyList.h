@@ -230,6 +230,14 @@ namespace mitk
      */
     bool DeleteProperty(const std::string &propertyKey);
 
+    /**
+     * @brief Returns the keys of all properties whose key starts with the passed prefix.
+     *
+     * The map is ordered by key, thus only the range of matching keys is visited and not
+     * all keys of the list (like filtering the result of GetPropertyKeys() would do).
+     */
+    std::vector<std::string> GetPropertyKeysWithPrefix(const std::string &prefix) const;
+
     const PropertyMap *GetMap() const { return &m_Properties; }
     bool IsEmpty() const { return m_Properties.empty(); }
     virtual void Clear();
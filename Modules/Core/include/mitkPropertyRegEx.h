@@ -0,0 +1,82 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkPropertyRegEx_h
+#define mitkPropertyRegEx_h
+
+#include <memory>
+#include <regex>
+#include <string>
+
+#include <MitkCoreExports.h>
+
+namespace mitk
+{
+  /** @brief Compiled regular expression (ECMAScript syntax) for the matching of property names and keys.
+   *
+   * In addition to the compiled std::regex the class deduces the literal prefix of the pattern (e.g. "MITK.Relations."
+   * for "MITK\.Relations\.([a-zA-Z0-9- ]+)\.ruleID"). Every string matched by the pattern must start with (Match) or
+   * contain (Search) this prefix. Match() and Search() check the prefix first, thus most strings never reach the regex
+   * engine. Patterns without any special character are compared directly.
+   *
+   * Compiling a std::regex is expensive. Use Get() to obtain instances from a process wide cache instead of
+   * constructing the expression for every query. Instances are immutable and can be used concurrently.
+   */
+  class MITKCORE_EXPORT PropertyRegEx
+  {
+  public:
+    using ConstPointer = std::shared_ptr<const PropertyRegEx>;
+
+    /** Returns the compiled expression of the passed pattern. The expression is only compiled on the first request
+     * of a pattern. The function is thread safe.
+     * @throw std::regex_error if the pattern is not a valid regular expression (like std::regex).*/
+    static ConstPointer Get(const std::string &pattern);
+
+    /** Removes all expressions from the cache. Instances that are still referenced stay valid.*/
+    static void ClearCache();
+
+    /** @throw std::regex_error if the pattern is not a valid regular expression (like std::regex).*/
+    explicit PropertyRegEx(const std::string &pattern);
+
+    const std::string &GetPattern() const { return m_Pattern; };
+    const std::regex &GetRegEx() const { return m_RegEx; };
+
+    /** Literal prefix every match of the pattern starts with. May be empty (e.g. if the pattern starts with a wild
+     * card or contains alternatives).*/
+    const std::string &GetLiteralPrefix() const { return m_LiteralPrefix; };
+
+    /** Indicates if the pattern contains no special characters and thus only matches its literal prefix.*/
+    bool IsLiteral() const { return m_IsLiteral; };
+
+    /** Equivalent to std::regex_match(str, GetRegEx()).*/
+    bool Match(const std::string &str) const;
+    /** Equivalent to std::regex_match(str, matches, GetRegEx()).*/
+    bool Match(const std::string &str, std::smatch &matches) const;
+    /** Equivalent to std::regex_search(str, matches, GetRegEx()).*/
+    bool Search(const std::string &str, std::smatch &matches) const;
+
+    /** Deduces the literal prefix of a pattern (see GetLiteralPrefix()). The deduction is conservative: if in doubt,
+     * the prefix is shorter than possible.
+     * @param pattern The regular expression.
+     * @param isLiteral Is set to true, if the whole pattern is the prefix.*/
+    static std::string DeduceLiteralPrefix(const std::string &pattern, bool &isLiteral);
+
+  private:
+    std::string m_Pattern;
+    std::regex m_RegEx;
+    std::string m_LiteralPrefix;
+    bool m_IsLiteral;
+    bool m_IsAnchored;
+  };
+}
+
+#endif
@@ -376,6 +376,14 @@ namespace mitk
        Please remove if T24728 is done then could directly use owner->GetPropertyKeys() again.*/
     static std::vector<std::string> GetPropertyKeys(const IPropertyProvider *owner);
 
+    /** Returns only the keys of the owner that start with the passed prefix (same workaround as above).
+       If the owner is (or is backed by) a PropertyList, the ordered property map is used as index,
+       thus the costs depend on the number of relevant keys and not on all keys of the owner.*/
+    static std::vector<std::string> GetPropertyKeys(const IPropertyProvider *owner, const std::string &prefix);
+
+    /** Prefix of all property keys that store relation instance information (RII) ("MITK.Relations.").*/
+    static const std::string &GetRIIPropertyKeyPrefix();
+
     /** Helper method that tries to cast the provider to the Identifiable interface.*/
     const Identifiable* CastProviderAsIdentifiable(const mitk::IPropertyProvider* provider) const;
 
@@ -17,7 +17,7 @@ found in the LICENSE file.
 #include "mitkDataStorage.h"
 #include "mitkMessage.h"
 #include <map>
-#include <mutex>
+#include <shared_mutex>
 
 namespace mitk
 {
@@ -87,9 +87,12 @@ namespace mitk
     //##Documentation
     //## @brief returns a set of all data objects that are stored in the data storage
     //##
+    //## The returned set is shared by all callers until the next node is added or removed.
     SetOfObjects::ConstPointer GetAll() const override;
 
-    mutable std::mutex m_Mutex;
+    //##Documentation
+    //## @brief Queries lock the mutex shared, Add() and Remove() lock it exclusively
+    mutable std::shared_mutex m_Mutex;
 
   protected:
     //##Documentation
@@ -124,6 +127,10 @@ namespace mitk
     //##Documentation
     //## @brief Nodes are stored in reverse relation for easier traversal in the opposite direction of the relation
     AdjacencyList m_DerivedNodes;
+
+    //##Documentation
+    //## @brief Result of GetAll(), reset whenever a node is added or removed
+    mutable SetOfObjects::ConstPointer m_AllNodes;
   };
 } // namespace mitk
 #endif /* MITKSTANDALONEDATASTORAGE_H_HEADER_INCLUDED_ */
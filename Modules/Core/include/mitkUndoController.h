@@ -116,6 +116,18 @@ namespace mitk
     //## especially to retrieve text descriptions of the undo/redo stack
     static UndoModel *GetCurrentUndoModel();
 
+    //##Documentation
+    //## @brief Sets the limit on the memory (in bytes) the undo history of
+    //## every UndoModel may occupy, see UndoModel::SetUndoMemoryLimit().
+    //## The limit is also applied to UndoModels added later.
+    //## The 0 value (default) means that there is no limit. In the workbench
+    //## the limit is set from the general preferences (org.mitk.gui.qt.application).
+    static void SetUndoMemoryLimit(std::size_t limit);
+
+    //##Documentation
+    //## @brief Gets the limit on the memory (in bytes) set by SetUndoMemoryLimit().
+    static std::size_t GetUndoMemoryLimit();
+
   private:
     //##Documentation
     //## current selected UndoModel
@@ -126,6 +138,9 @@ namespace mitk
     //##Documentation
     //## different UndoModels to select and activate
     static UndoModelMap m_UndoModelList;
+    //##Documentation
+    //## memory limit applied to all UndoModels
+    static std::size_t m_UndoMemoryLimit;
   };
 } // namespace mitk
 
@@ -71,6 +71,22 @@ namespace mitk
     //## @param limit the maximum number of items on the stack
     virtual void SetUndoLimit(std::size_t limit) = 0;
 
+    //##Documentation
+    //## @brief Gets the limit on the memory (in bytes) the undo history
+    //## may occupy. The 0 value means that there is no limit.
+    virtual std::size_t GetUndoMemoryLimit() const = 0;
+
+    //##Documentation
+    //## @brief Sets a limit on the memory (in bytes) the undo history
+    //## may occupy. How the limit is enforced depends on the undo model.
+    //## The 0 value means that there is no limit.
+    virtual void SetUndoMemoryLimit(std::size_t limit) = 0;
+
+    //##Documentation
+    //## @brief Returns the number of bytes the items of the undo
+    //## and redo history currently occupy in memory.
+    virtual std::size_t GetUndoMemoryUsage() const = 0;
+
     //##Documentation
     //## @brief returns the ObjectEventId of the
     //## top Element in the OperationHistory of the selected
@@ -16,11 +16,28 @@ found in the LICENSE file.
 #include <mitkImageWriteAccessor.h>
 
 #include <itkBSplineInterpolateImageFunction.h>
-#include <itkLinearInterpolateImageFunction.h>
-#include <itkNearestNeighborInterpolateImageFunction.h>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
+namespace
+{
+  /** \brief Continuous input index of the first output pixel and the
+   * increments of the continuous input index per output pixel along the
+   * x and y axes of the output plane.
+   */
+  struct SliceStepping
+  {
+    double Origin[3];
+    double XStep[3];
+    double YStep[3];
+    double UpperBound[3];
+    long Size[3];
+    bool IsAxisAligned;
+  };
+}
+
 struct mitk::ExtractSliceFilter2::Impl
 {
   Impl();
@@ -29,10 +46,12 @@ struct mitk::ExtractSliceFilter2::Impl
   PlaneGeometry::Pointer OutputGeometry;
   mitk::ExtractSliceFilter2::Interpolator Interpolator;
   itk::Object::Pointer InterpolateImageFunction;
+  SliceStepping Stepping;
 };
 
 mitk::ExtractSliceFilter2::Impl::Impl()
-  : Interpolator(NearestNeighbor)
+  : Interpolator(NearestNeighbor),
+    Stepping()
 {
 }
 
@@ -43,46 +62,45 @@ mitk::ExtractSliceFilter2::Impl::~Impl()
 namespace
 {
   template <class TInputImage>
-  void CreateInterpolateImageFunction(const TInputImage* inputImage, mitk::ExtractSliceFilter2::Interpolator interpolator, itk::Object::Pointer& result)
+  void CreateInterpolateImageFunction(const TInputImage* inputImage, itk::Object::Pointer& result)
   {
-    typename itk::InterpolateImageFunction<TInputImage>::Pointer interpolateImageFunction;
+    auto bSplineInterpolateImageFunction = itk::BSplineInterpolateImageFunction<TInputImage>::New();
+    bSplineInterpolateImageFunction->SetSplineOrder(2);
+    bSplineInterpolateImageFunction->SetInputImage(inputImage);
 
-    switch (interpolator)
-    {
-      case mitk::ExtractSliceFilter2::NearestNeighbor:
-        interpolateImageFunction = itk::NearestNeighborInterpolateImageFunction<TInputImage>::New().GetPointer();
-        break;
+    result = bSplineInterpolateImageFunction.GetPointer();
+  }
 
-      case mitk::ExtractSliceFilter2::Linear:
-        interpolateImageFunction = itk::LinearInterpolateImageFunction<TInputImage>::New().GetPointer();
-        break;
+  bool IsIntegral(double value)
+  {
+    return std::abs(value - std::round(value)) < 1e-6;
+  }
 
-      case mitk::ExtractSliceFilter2::Cubic:
-      {
-        auto bSplineInterpolateImageFunction = itk::BSplineInterpolateImageFunction<TInputImage>::New();
-        bSplineInterpolateImageFunction->SetSplineOrder(2);
-        interpolateImageFunction = bSplineInterpolateImageFunction.GetPointer();
-        break;
-      }
+  /** \brief Check if a step in index space moves by exactly one voxel along
+   * a single axis. On success, the axis and the direction are returned.
+   */
+  bool IsUnitAxisStep(const double* step, int& axis, int& sign)
+  {
+    axis = -1;
 
-      default:
-        mitkThrow() << "Interplator is unknown.";
-    }
+    for (int i = 0; i < 3; ++i)
+    {
+      if (std::abs(step[i]) < 1e-6)
+        continue;
 
-    interpolateImageFunction->SetInputImage(inputImage);
+      if (-1 != axis || std::abs(std::abs(step[i]) - 1.0) >= 1e-6)
+        return false;
 
-    result = interpolateImageFunction.GetPointer();
+      axis = i;
+      sign = step[i] > 0.0 ? 1 : -1;
+    }
+
+    return -1 != axis;
   }
 
   template <typename TPixel, unsigned int VImageDimension>
-  void GenerateData(const itk::Image<TPixel, VImageDimension>* inputImage, mitk::Image* outputImage, const mitk::ExtractSliceFilter2::OutputImageRegionType& outputRegion, itk::Object* interpolateImageFunction)
+  void ComputeSliceStepping(const itk::Image<TPixel, VImageDimension>* inputImage, const mitk::PlaneGeometry* outputGeometry, mitk::ExtractSliceFilter2::Interpolator interpolator, SliceStepping& stepping)
   {
-    typedef itk::Image<TPixel, VImageDimension> TInputImage;
-    typedef itk::InterpolateImageFunction<TInputImage> TInterpolateImageFunction;
-
-    auto outputGeometry = outputImage->GetSlicedGeometry()->GetPlaneGeometry(0);
-    auto interpolator = static_cast<TInterpolateImageFunction*>(interpolateImageFunction);
-
     auto origin = outputGeometry->GetOrigin();
     auto spacing = outputGeometry->GetSpacing();
     auto xDirection = outputGeometry->GetAxisVector(0);
@@ -94,41 +112,280 @@ namespace
     auto spacingAlongXDirection = xDirection * spacing[0];
     auto spacingAlongYDirection = yDirection * spacing[1];
 
-    const std::size_t pixelSize = outputImage->GetPixelType().GetSize();
-    const std::size_t width = outputGeometry->GetExtent(0);
-    const std::size_t xBegin = outputRegion.GetIndex(0);
-    const std::size_t yBegin = outputRegion.GetIndex(1);
-    const std::size_t xEnd = xBegin + outputRegion.GetSize(0);
-    const std::size_t yEnd = yBegin + outputRegion.GetSize(1);
+    const auto& physicalPointToIndex = inputImage->GetPhysicalPointToIndexMatrix();
+    const auto& inputOrigin = inputImage->GetOrigin();
+    const auto& inputSize = inputImage->GetLargestPossibleRegion().GetSize();
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      stepping.Origin[i] = 0.0;
+      stepping.XStep[i] = 0.0;
+      stepping.YStep[i] = 0.0;
+
+      for (unsigned int j = 0; j < 3; ++j)
+      {
+        stepping.Origin[i] += physicalPointToIndex[i][j] * (origin[j] - inputOrigin[j]);
+        stepping.XStep[i] += physicalPointToIndex[i][j] * spacingAlongXDirection[j];
+        stepping.YStep[i] += physicalPointToIndex[i][j] * spacingAlongYDirection[j];
+      }
+
+      stepping.Size[i] = static_cast<long>(inputSize[i]);
+      stepping.UpperBound[i] = static_cast<double>(inputSize[i] - 1);
+    }
+
+    int xAxis, yAxis, xSign, ySign;
+    stepping.IsAxisAligned = IsUnitAxisStep(stepping.XStep, xAxis, xSign) && IsUnitAxisStep(stepping.YStep, yAxis, ySign) && xAxis != yAxis;
+
+    // Linear and cubic interpolation only degenerate to a copy if every output
+    // pixel hits a voxel center. Nearest neighbor interpolation always does.
+    if (stepping.IsAxisAligned && mitk::ExtractSliceFilter2::NearestNeighbor != interpolator)
+      stepping.IsAxisAligned = IsIntegral(stepping.Origin[0]) && IsIntegral(stepping.Origin[1]) && IsIntegral(stepping.Origin[2]);
+  }
+
+  /** \brief Same semantics as itk::ImageRegion::IsInside() for continuous indices. */
+  inline bool IsInside(const double* index, const double* upperBound)
+  {
+    return index[0] >= -0.5 && index[0] <= upperBound[0] &&
+           index[1] >= -0.5 && index[1] <= upperBound[1] &&
+           index[2] >= -0.5 && index[2] <= upperBound[2];
+  }
+
+  inline void ComputeIndex(const double* rowIndex, const double* xStep, long x, double* index)
+  {
+    index[0] = rowIndex[0] + x * xStep[0];
+    index[1] = rowIndex[1] + x * xStep[1];
+    index[2] = rowIndex[2] + x * xStep[2];
+  }
+
+  /** \brief Determine the interval [first, last] of output pixels of a row
+   * that are located within the input image.
+   *
+   * Since the row is a straight line in index space, all of its pixels
+   * inside of the input image form a single interval. The analytical bounds
+   * are widened by a pixel and then narrowed with the exact inside test to
+   * be robust against rounding errors.
+   *
+   * \return False if no pixel of the row is located within the input image.
+   */
+  bool ComputeInsideRange(const double* rowIndex, const double* xStep, const double* upperBound, long xBegin, long xEnd, long& first, long& last)
+  {
+    double lower = static_cast<double>(xBegin);
+    double upper = static_cast<double>(xEnd - 1);
+
+    for (int i = 0; i < 3; ++i)
+    {
+      if (0.0 == xStep[i])
+      {
+        if (rowIndex[i] < -0.5 || rowIndex[i] > upperBound[i])
+          return false;
+
+        continue;
+      }
+
+      double a = (-0.5 - rowIndex[i]) / xStep[i];
+      double b = (upperBound[i] - rowIndex[i]) / xStep[i];
+
+      if (a > b)
+        std::swap(a, b);
+
+      lower = std::max(lower, a);
+      upper = std::min(upper, b);
+    }
+
+    if (lower > upper + 2.0)
+      return false;
+
+    first = std::max(xBegin, static_cast<long>(std::ceil(lower)) - 1);
+    last = std::min(xEnd - 1, static_cast<long>(std::floor(upper)) + 1);
+
+    double index[3];
+
+    for (; first <= last; ++first)
+    {
+      ComputeIndex(rowIndex, xStep, first, index);
+
+      if (IsInside(index, upperBound))
+        break;
+    }
+
+    for (; last >= first; --last)
+    {
+      ComputeIndex(rowIndex, xStep, last, index);
+
+      if (IsInside(index, upperBound))
+        break;
+    }
+
+    return first <= last;
+  }
+
+  template <typename TPixel>
+  void CopyRow(const TPixel* input, const itk::OffsetValueType* offsetTable, const SliceStepping& stepping, const double* rowIndex, TPixel* output, long first, long last)
+  {
+    // Nearest neighbor of the first pixel of the row. All other pixels are
+    // located a fixed number of voxels apart along a single input axis.
+    itk::OffsetValueType offset = 0;
+    itk::OffsetValueType stride = 0;
+
+    for (int i = 0; i < 3; ++i)
+    {
+      double index = rowIndex[i] + first * stepping.XStep[i];
+      offset += static_cast<itk::OffsetValueType>(index + 0.5) * offsetTable[i];
+      stride += static_cast<itk::OffsetValueType>(std::round(stepping.XStep[i])) * offsetTable[i];
+    }
+
+    const TPixel* source = input + offset;
+
+    if (1 == stride)
+    {
+      std::copy(source, source + (last - first + 1), output + first);
+    }
+    else
+    {
+      for (long x = first; x <= last; ++x, source += stride)
+        output[x] = *source;
+    }
+  }
+
+  template <typename TPixel>
+  void NearestNeighborRow(const TPixel* input, const itk::OffsetValueType* offsetTable, const SliceStepping& stepping, const double* rowIndex, TPixel* output, long first, long last)
+  {
+    const double* xStep = stepping.XStep;
+
+    for (long x = first; x <= last; ++x)
+    {
+      // Indices are not smaller than -0.5 inside of the input image so that
+      // truncation is equivalent to rounding half integers up.
+      const auto i = static_cast<itk::OffsetValueType>(rowIndex[0] + x * xStep[0] + 0.5);
+      const auto j = static_cast<itk::OffsetValueType>(rowIndex[1] + x * xStep[1] + 0.5);
+      const auto k = static_cast<itk::OffsetValueType>(rowIndex[2] + x * xStep[2] + 0.5);
+
+      output[x] = input[i + j * offsetTable[1] + k * offsetTable[2]];
+    }
+  }
+
+  template <typename TPixel>
+  void LinearRow(const TPixel* input, const itk::OffsetValueType* offsetTable, const SliceStepping& stepping, const double* rowIndex, TPixel* output, long first, long last)
+  {
+    const double* xStep = stepping.XStep;
+    const long* size = stepping.Size;
+
+    for (long x = first; x <= last; ++x)
+    {
+      double index[3];
+      ComputeIndex(rowIndex, xStep, x, index);
+
+      // Clamping of base indices and neighbors at the image border follows
+      // itk::LinearInterpolateImageFunction.
+      const long i0 = static_cast<long>(index[0]);
+      const long j0 = static_cast<long>(index[1]);
+      const long k0 = static_cast<long>(index[2]);
+
+      const double d0 = std::max(0.0, index[0] - i0);
+      const double d1 = std::max(0.0, index[1] - j0);
+      const double d2 = std::max(0.0, index[2] - k0);
+
+      const itk::OffsetValueType di = i0 + 1 < size[0] ? 1 : 0;
+      const itk::OffsetValueType dj = j0 + 1 < size[1] ? offsetTable[1] : 0;
+      const itk::OffsetValueType dk = k0 + 1 < size[2] ? offsetTable[2] : 0;
+
+      const TPixel* p = input + i0 + j0 * offsetTable[1] + k0 * offsetTable[2];
+
+      const double val000 = p[0];
+      const double val100 = p[di];
+      const double val010 = p[dj];
+      const double val110 = p[di + dj];
+      const double val001 = p[dk];
+      const double val101 = p[di + dk];
+      const double val011 = p[dj + dk];
+      const double val111 = p[di + dj + dk];
+
+      const double val00 = val000 + (val100 - val000) * d0;
+      const double val10 = val010 + (val110 - val010) * d0;
+      const double val01 = val001 + (val101 - val001) * d0;
+      const double val11 = val011 + (val111 - val011) * d0;
+
+      const double val0 = val00 + (val10 - val00) * d1;
+      const double val1 = val01 + (val11 - val01) * d1;
+
+      output[x] = static_cast<TPixel>(val0 + (val1 - val0) * d2);
+    }
+  }
+
+  template <typename TInputImage>
+  void CubicRow(const itk::BSplineInterpolateImageFunction<TInputImage>* interpolator, const SliceStepping& stepping, const double* rowIndex, typename TInputImage::PixelType* output, long first, long last)
+  {
+    itk::ContinuousIndex<mitk::ScalarType, 3> index;
+
+    for (long x = first; x <= last; ++x)
+    {
+      ComputeIndex(rowIndex, stepping.XStep, x, index.GetDataPointer());
+      output[x] = static_cast<typename TInputImage::PixelType>(interpolator->EvaluateAtContinuousIndex(index));
+    }
+  }
+
+  template <typename TPixel, unsigned int VImageDimension>
+  void GenerateData(const itk::Image<TPixel, VImageDimension>* inputImage, mitk::Image* outputImage, const mitk::ExtractSliceFilter2::OutputImageRegionType& outputRegion, mitk::ExtractSliceFilter2::Interpolator interpolator, const SliceStepping& stepping, itk::Object* interpolateImageFunction)
+  {
+    typedef itk::Image<TPixel, VImageDimension> TInputImage;
+    typedef itk::BSplineInterpolateImageFunction<TInputImage> TInterpolateImageFunction;
+
+    const auto* input = inputImage->GetBufferPointer();
+    const auto* offsetTable = inputImage->GetOffsetTable();
+    const auto* bSplineInterpolator = static_cast<TInterpolateImageFunction*>(interpolateImageFunction);
+
+    const long width = static_cast<long>(outputImage->GetDimension(0));
+    const long xBegin = outputRegion.GetIndex(0);
+    const long yBegin = outputRegion.GetIndex(1);
+    const long xEnd = xBegin + static_cast<long>(outputRegion.GetSize(0));
+    const long yEnd = yBegin + static_cast<long>(outputRegion.GetSize(1));
 
     mitk::ImageWriteAccessor writeAccess(outputImage, nullptr, mitk::ImageAccessorBase::IgnoreLock);
-    auto data = static_cast<char*>(writeAccess.GetData());
+    auto data = static_cast<TPixel*>(writeAccess.GetData());
 
     const TPixel backgroundPixel = std::numeric_limits<TPixel>::lowest();
-    TPixel pixel;
 
-    itk::ContinuousIndex<mitk::ScalarType, 3> index;
-    mitk::Point3D yPoint;
-    mitk::Point3D point;
+    double rowIndex[3];
+    long first, last;
 
-    for (std::size_t y = yBegin; y < yEnd; ++y)
+    for (long y = yBegin; y < yEnd; ++y)
     {
-      yPoint = origin + spacingAlongYDirection * y;
+      auto row = data + width * y;
 
-      for (std::size_t x = xBegin; x < xEnd; ++x)
+      for (int i = 0; i < 3; ++i)
+        rowIndex[i] = stepping.Origin[i] + y * stepping.YStep[i];
+
+      if (!ComputeInsideRange(rowIndex, stepping.XStep, stepping.UpperBound, xBegin, xEnd, first, last))
       {
-        point = yPoint + spacingAlongXDirection * x;
+        std::fill(row + xBegin, row + xEnd, backgroundPixel);
+        continue;
+      }
 
-        if (inputImage->TransformPhysicalPointToContinuousIndex(point, index))
-        {
-          pixel = interpolator->EvaluateAtContinuousIndex(index);
-          memcpy(static_cast<void*>(data + pixelSize * (width * y + x)), static_cast<const void*>(&pixel), pixelSize);
-        }
-        else
+      std::fill(row + xBegin, row + first, backgroundPixel);
+
+      if (stepping.IsAxisAligned)
+      {
+        CopyRow(input, offsetTable, stepping, rowIndex, row, first, last);
+      }
+      else
+      {
+        switch (interpolator)
         {
-          memcpy(static_cast<void*>(data + pixelSize * (width * y + x)), static_cast<const void*>(&backgroundPixel), pixelSize);
+          case mitk::ExtractSliceFilter2::NearestNeighbor:
+            NearestNeighborRow(input, offsetTable, stepping, rowIndex, row, first, last);
+            break;
+
+          case mitk::ExtractSliceFilter2::Linear:
+            LinearRow(input, offsetTable, stepping, rowIndex, row, first, last);
+            break;
+
+          case mitk::ExtractSliceFilter2::Cubic:
+            CubicRow<TInputImage>(bSplineInterpolator, stepping, rowIndex, row, first, last);
+            break;
         }
       }
+
+      std::fill(row + last + 1, row + xEnd, backgroundPixel);
     }
   }
 
@@ -194,36 +451,30 @@ void mitk::ExtractSliceFilter2::AllocateOutputs()
   {
     delete[] data;
   }
-}
-
-/*void mitk::ExtractSliceFilter2::BeforeThreadedGenerateData()
-{
-  if (nullptr != m_Impl->InterpolateImageFunction && this->GetInput()->GetMTime() < this->GetMTime())
-    return;
 
-  const auto* inputImage = this->GetInput();
-  AccessFixedDimensionByItk_2(inputImage, CreateInterpolateImageFunction, 3, this->GetInterpolator(), m_Impl->InterpolateImageFunction);
+  // The requested region is split into bands of output rows for the threads.
+  outputImage->SetRequestedRegionToLargestPossibleRegion();
 }
 
-void mitk::ExtractSliceFilter2::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType)
+void mitk::ExtractSliceFilter2::BeforeThreadedGenerateData()
 {
   const auto* inputImage = this->GetInput();
-  AccessFixedDimensionByItk_3(inputImage, ::GenerateData, 3, this->GetOutput(), outputRegionForThread, m_Impl->InterpolateImageFunction);
-}*/
 
-void mitk::ExtractSliceFilter2::GenerateData()
-{
-  if (nullptr != m_Impl->InterpolateImageFunction && this->GetInput()->GetMTime() < this->GetMTime())
-    return;
+  AccessFixedDimensionByItk_n(inputImage, ComputeSliceStepping, 3, (this->GetOutputGeometry(), this->GetInterpolator(), m_Impl->Stepping));
 
-  const auto* inputImage = this->GetInput();
+  if (Cubic != this->GetInterpolator() || m_Impl->Stepping.IsAxisAligned)
+    return;
 
-  AccessFixedDimensionByItk_2(inputImage, CreateInterpolateImageFunction, 3, this->GetInterpolator(), m_Impl->InterpolateImageFunction);
+  if (nullptr != m_Impl->InterpolateImageFunction && inputImage->GetMTime() < this->GetMTime())
+    return;
 
-  this->AllocateOutputs();
-  auto outputRegion = this->GetOutput()->GetLargestPossibleRegion();
+  AccessFixedDimensionByItk_1(inputImage, CreateInterpolateImageFunction, 3, m_Impl->InterpolateImageFunction);
+}
 
-  AccessFixedDimensionByItk_3(inputImage, ::GenerateData, 3, this->GetOutput(), outputRegion, m_Impl->InterpolateImageFunction);
+void mitk::ExtractSliceFilter2::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType)
+{
+  const auto* inputImage = this->GetInput();
+  AccessFixedDimensionByItk_n(inputImage, ::GenerateData, 3, (this->GetOutput(), outputRegionForThread, this->GetInterpolator(), m_Impl->Stepping, m_Impl->InterpolateImageFunction));
 }
 
 void mitk::ExtractSliceFilter2::SetInput(const InputImageType* image)
@@ -11,8 +11,16 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkLimitedLinearUndo.h"
+#include <mitkExceptionMacro.h>
+#include <mitkIOUtil.h>
+#include <mitkLogMacros.h>
 #include <mitkRenderingManager.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
 namespace mitk
 {
   itkEventMacroDefinition(UndoStackEvent, itk::ModifiedEvent);
@@ -25,7 +33,7 @@ namespace mitk
 }
 
 mitk::LimitedLinearUndo::LimitedLinearUndo()
-: m_UndoLimit(0)
+: m_UndoLimit(0), m_UndoMemoryLimit(0)
 {
   // nothing to do
 }
@@ -43,7 +51,103 @@ void mitk::LimitedLinearUndo::ClearList(UndoContainer *list)
   {
     UndoStackItem *item = list->back();
     list->pop_back();
-    delete item;
+    this->DeleteStackItem(item);
+  }
+}
+
+void mitk::LimitedLinearUndo::DeleteStackItem(UndoStackItem *item)
+{
+  auto finding = m_SwappedItems.find(item);
+
+  if (m_SwappedItems.end() != finding)
+  {
+    std::remove(finding->second.FileName.c_str());
+    m_SwappedItems.erase(finding);
+  }
+
+  delete item;
+}
+
+bool mitk::LimitedLinearUndo::SwapOutItem(UndoStackItem *item)
+{
+  // The item releases its data while writing, so write to memory first to be
+  // able to restore the item if the swap file cannot be written.
+  std::stringstream buffer(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+  item->SwapOut(buffer);
+
+  const auto data = buffer.str();
+
+  try
+  {
+    std::ofstream file;
+    const auto fileName = IOUtil::CreateTemporaryFile(file, std::ios_base::binary, "MITK_UndoItem_XXXXXX");
+
+    file.write(data.data(), data.size());
+    file.close();
+
+    if (!file.good())
+    {
+      std::remove(fileName.c_str());
+      mitkThrow() << "Cannot write undo swap file " << fileName;
+    }
+
+    m_SwappedItems[item] = { fileName, data.size() };
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_WARN << "Cannot swap out undo item \"" << item->GetDescription() << "\": " << e.GetDescription();
+    item->SwapIn(buffer);
+    return false;
+  }
+
+  return true;
+}
+
+void mitk::LimitedLinearUndo::SwapInItem(UndoStackItem *item)
+{
+  auto finding = m_SwappedItems.find(item);
+
+  if (m_SwappedItems.end() == finding)
+    return;
+
+  const auto fileName = finding->second.FileName;
+  m_SwappedItems.erase(finding);
+
+  std::ifstream file(fileName, std::ios_base::binary);
+
+  if (!file.is_open())
+    mitkThrow() << "Cannot read undo swap file " << fileName;
+
+  item->SwapIn(file);
+  file.close();
+
+  std::remove(fileName.c_str());
+}
+
+void mitk::LimitedLinearUndo::EnforceUndoMemoryLimit()
+{
+  if (0 == m_UndoMemoryLimit)
+    return;
+
+  auto usage = this->GetUndoMemoryUsage();
+
+  // Swap out the oldest items first: the bottom of the undo stack, then the
+  // redo items that are farthest away from the current state. The top items
+  // of both stacks stay in memory for an immediate undo or redo.
+  for (auto list : { &m_UndoList, &m_RedoList })
+  {
+    for (auto iter = list->begin(); usage > m_UndoMemoryLimit && !list->empty() && iter != list->end() - 1; ++iter)
+    {
+      auto item = *iter;
+
+      if (!item->IsSwappable() || m_SwappedItems.end() != m_SwappedItems.find(item))
+        continue;
+
+      const auto footprint = item->GetMemoryFootprint();
+
+      if (this->SwapOutItem(item))
+        usage -= footprint - std::min(footprint, item->GetMemoryFootprint());
+    }
   }
 }
 
@@ -64,10 +168,12 @@ bool mitk::LimitedLinearUndo::SetOperationEvent(UndoStackItem *stackItem)
   {
     auto item = m_UndoList.front();
     m_UndoList.pop_front();
-    delete item;
+    this->DeleteStackItem(item);
   }
   m_UndoList.push_back(operationEvent);
 
+  this->EnforceUndoMemoryLimit();
+
   InvokeEvent(UndoNotEmptyEvent());
 
   return true;
@@ -106,6 +212,7 @@ bool mitk::LimitedLinearUndo::Undo(int oeid)
   bool rc = true;
   do
   {
+    this->SwapInItem(m_UndoList.back());
     m_UndoList.back()->ReverseAndExecute();
 
     m_RedoList.push_back(m_UndoList.back()); // move to redo stack
@@ -120,6 +227,8 @@ bool mitk::LimitedLinearUndo::Undo(int oeid)
     }
   } while (m_UndoList.back()->GetObjectEventId() >= oeid);
 
+  this->EnforceUndoMemoryLimit();
+
   // Update. Check Rendering Mechanism where to request updates
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
   return rc;
@@ -146,6 +255,7 @@ bool mitk::LimitedLinearUndo::Redo(int oeid)
 
   do
   {
+    this->SwapInItem(m_RedoList.back());
     m_RedoList.back()->ReverseAndExecute();
 
     m_UndoList.push_back(m_RedoList.back());
@@ -159,6 +269,8 @@ bool mitk::LimitedLinearUndo::Redo(int oeid)
     }
   } while (m_RedoList.back()->GetObjectEventId() <= oeid);
 
+  this->EnforceUndoMemoryLimit();
+
   // Update. This should belong into the ExecuteOperation() of OperationActors, but it seems not to be used everywhere
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
   return true;
@@ -193,14 +305,58 @@ void mitk::LimitedLinearUndo::SetUndoLimit(std::size_t undoLimit)
 {
   if (undoLimit != m_UndoLimit)
   {
-    if (m_UndoList.size() > undoLimit)
+    while (0 != undoLimit && m_UndoList.size() > undoLimit)
     {
-      m_UndoList.erase(m_UndoList.begin(), m_UndoList.end() - undoLimit);
+      auto item = m_UndoList.front();
+      m_UndoList.pop_front();
+      this->DeleteStackItem(item);
     }
     m_UndoLimit = undoLimit;
   }
 }
 
+std::size_t mitk::LimitedLinearUndo::GetUndoMemoryLimit() const
+{
+  return m_UndoMemoryLimit;
+}
+
+void mitk::LimitedLinearUndo::SetUndoMemoryLimit(std::size_t limit)
+{
+  if (limit != m_UndoMemoryLimit)
+  {
+    m_UndoMemoryLimit = limit;
+    this->EnforceUndoMemoryLimit();
+  }
+}
+
+std::size_t mitk::LimitedLinearUndo::GetUndoMemoryUsage() const
+{
+  std::size_t usage = 0;
+
+  for (auto list : { &m_UndoList, &m_RedoList })
+  {
+    for (auto item : *list)
+      usage += item->GetMemoryFootprint();
+  }
+
+  return usage;
+}
+
+std::size_t mitk::LimitedLinearUndo::GetSwappedUndoMemory() const
+{
+  std::size_t size = 0;
+
+  for (const auto &swappedItem : m_SwappedItems)
+    size += swappedItem.second.Size;
+
+  return size;
+}
+
+std::size_t mitk::LimitedLinearUndo::GetNumberOfSwappedItems() const
+{
+  return m_SwappedItems.size();
+}
+
 int mitk::LimitedLinearUndo::GetLastObjectEventIdInList()
 {
   return m_UndoList.back()->GetObjectEventId();
@@ -13,6 +13,9 @@ found in the LICENSE file.
 #include "mitkOperationEvent.h"
 #include <itkCommand.h>
 
+#include <istream>
+#include <ostream>
+
 int mitk::UndoStackItem::m_CurrObjectEventId = 0;
 int mitk::UndoStackItem::m_CurrGroupEventId = 0;
 
@@ -72,6 +75,24 @@ void mitk::UndoStackItem::ReverseAndExecute()
   ReverseOperations();
 }
 
+std::size_t mitk::UndoStackItem::GetMemoryFootprint() const
+{
+  return sizeof(UndoStackItem) + m_Description.capacity();
+}
+
+bool mitk::UndoStackItem::IsSwappable() const
+{
+  return false;
+}
+
+void mitk::UndoStackItem::SwapOut(std::ostream &)
+{
+}
+
+void mitk::UndoStackItem::SwapIn(std::istream &)
+{
+}
+
 // ******************** mitk::OperationEvent ********************
 
 mitk::Operation *mitk::OperationEvent::GetOperation()
@@ -109,8 +130,10 @@ mitk::OperationEvent::~OperationEvent()
     }
   }
 
+  if (m_UndoOperation != m_Operation)
+    delete m_UndoOperation;
+
   delete m_Operation;
-  delete m_UndoOperation;
 }
 
 //##Documentation
@@ -144,6 +167,50 @@ void mitk::OperationEvent::OnObjectDeleted()
   m_Invalid = true;
 }
 
+std::size_t mitk::OperationEvent::GetMemoryFootprint() const
+{
+  std::size_t footprint = UndoStackItem::GetMemoryFootprint() + sizeof(OperationEvent) - sizeof(UndoStackItem);
+
+  if (nullptr != m_Operation)
+    footprint += m_Operation->GetMemoryFootprint();
+
+  // Some events use the same operation for do and undo, it must be counted once.
+  if (nullptr != m_UndoOperation && m_UndoOperation != m_Operation)
+    footprint += m_UndoOperation->GetMemoryFootprint();
+
+  return footprint;
+}
+
+bool mitk::OperationEvent::IsSwappable() const
+{
+  return (nullptr != m_Operation && m_Operation->IsSwappable()) ||
+         (nullptr != m_UndoOperation && m_UndoOperation->IsSwappable());
+}
+
+void mitk::OperationEvent::SwapOut(std::ostream &stream)
+{
+  // An operation shared for do and undo must be swapped only once.
+  auto undoOperation = m_UndoOperation != m_Operation ? m_UndoOperation : nullptr;
+
+  for (auto operation : { m_Operation, undoOperation })
+  {
+    if (nullptr != operation && operation->IsSwappable())
+      operation->SwapOut(stream);
+  }
+}
+
+void mitk::OperationEvent::SwapIn(std::istream &stream)
+{
+  // An operation shared for do and undo must be swapped only once.
+  auto undoOperation = m_UndoOperation != m_Operation ? m_UndoOperation : nullptr;
+
+  for (auto operation : { m_Operation, undoOperation })
+  {
+    if (nullptr != operation && operation->IsSwappable())
+      operation->SwapIn(stream);
+  }
+}
+
 bool mitk::OperationEvent::IsValid()
 {
   return !m_Invalid;
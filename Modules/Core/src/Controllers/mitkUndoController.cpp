@@ -20,6 +20,7 @@ found in the LICENSE file.
 mitk::UndoModel::Pointer mitk::UndoController::m_CurUndoModel;
 mitk::UndoController::UndoModelMap mitk::UndoController::m_UndoModelList;
 mitk::UndoController::UndoType mitk::UndoController::m_CurUndoType;
+std::size_t mitk::UndoController::m_UndoMemoryLimit = 0;
 
 // const mitk::UndoController::UndoType mitk::UndoController::DEFAULTUNDOMODEL = LIMITEDLINEARUNDO;
 const mitk::UndoController::UndoType mitk::UndoController::DEFAULTUNDOMODEL = VERBOSE_LIMITEDLINEARUNDO;
@@ -48,6 +49,7 @@ mitk::UndoController::UndoController(UndoType undoType)
         m_CurUndoType = undoType;
         m_UndoModelList.insert(UndoModelMap::value_type(undoType, m_CurUndoModel));
     }
+    m_CurUndoModel->SetUndoMemoryLimit(m_UndoMemoryLimit);
   }
 }
 
@@ -153,6 +155,7 @@ bool mitk::UndoController::AddUndoModel(UndoType undoType)
       // that undoType is not implemented!
       return false;
   }
+  m_CurUndoModel->SetUndoMemoryLimit(m_UndoMemoryLimit);
   return true;
 }
 
@@ -211,3 +214,16 @@ mitk::UndoModel *mitk::UndoController::GetCurrentUndoModel()
 {
   return m_CurUndoModel;
 }
+
+void mitk::UndoController::SetUndoMemoryLimit(std::size_t limit)
+{
+  m_UndoMemoryLimit = limit;
+
+  for (auto &undoModel : m_UndoModelList)
+    undoModel.second->SetUndoMemoryLimit(limit);
+}
+
+std::size_t mitk::UndoController::GetUndoMemoryLimit()
+{
+  return m_UndoMemoryLimit;
+}
@@ -38,10 +38,12 @@ bool mitk::VerboseLimitedLinearUndo::SetOperationEvent(UndoStackItem *undoStackI
   {
     auto item = m_UndoList.front();
     m_UndoList.pop_front();
-    delete item;
+    this->DeleteStackItem(item);
   }
   m_UndoList.push_back(undoStackItem);
 
+  this->EnforceUndoMemoryLimit();
+
   InvokeEvent(UndoNotEmptyEvent());
 
   return true;
@@ -14,6 +14,7 @@ found in the LICENSE file.
 
 #include "itkCommand.h"
 #include "mitkDataNode.h"
+#include "mitkDataStorageView.h"
 #include "mitkGroupTagProperty.h"
 #include "mitkImage.h"
 #include "mitkNodePredicateBase.h"
@@ -21,8 +22,12 @@ found in the LICENSE file.
 #include "mitkProperties.h"
 #include "mitkArbitraryTimeGeometry.h"
 
+#include <vector>
+
 mitk::DataStorage::DataStorage() : itk::Object(), m_BlockNodeModifiedEvents(false)
 {
+  // names are always indexed for GetNamedNode()
+  m_TrackedPropertyKeys["name"] = 1;
 }
 
 mitk::DataStorage::~DataStorage()
@@ -33,6 +38,28 @@ mitk::DataStorage::~DataStorage()
   //  this->RemoveListeners(it->Value());
   // m_NodeModifiedObserverTags.clear();
   // m_NodeDeleteObserverTags.clear();
+
+  for (const auto &observation : m_ObservedProperties)
+  {
+    const_cast<BaseProperty *>(observation.second.m_Property.GetPointer())
+      ->RemoveObserver(observation.second.m_ObserverTag);
+  }
+}
+
+template <typename TFunction>
+void mitk::DataStorage::NotifyViews(TFunction notify)
+{
+  // the mutex is recursive, since views may be created or deleted by observers of a view
+  std::lock_guard<std::recursive_mutex> locked(m_ViewsMutex);
+  if (m_Views.empty())
+    return;
+
+  const std::vector<DataStorageView *> views(m_Views.begin(), m_Views.end());
+  for (auto view : views)
+  {
+    if (m_Views.find(view) != m_Views.end())
+      notify(view);
+  }
 }
 
 void mitk::DataStorage::Add(DataNode *node, DataNode *parent)
@@ -53,19 +80,93 @@ void mitk::DataStorage::Remove(const DataStorage::SetOfObjects *nodes)
 
 mitk::DataStorage::SetOfObjects::ConstPointer mitk::DataStorage::GetSubset(const NodePredicateBase *condition) const
 {
+  // GetAll() already returns a set that is not modified by later changes of the DataStorage
+  if (condition == nullptr)
+    return this->GetAll();
+
   DataStorage::SetOfObjects::ConstPointer result = this->FilterSetOfObjects(this->GetAll(), condition);
   return result;
 }
 
+mitk::DataStorage::SetOfObjects::ConstPointer mitk::DataStorage::GetSubsetByName(const std::string &name) const
+{
+  auto property = StringProperty::New(name);
+  return this->GetSubsetByProperty("name", property);
+}
+
+mitk::DataStorage::SetOfObjects::ConstPointer mitk::DataStorage::GetSubsetByDataType(const std::string &className) const
+{
+  std::shared_lock<std::shared_mutex> locked(m_IndexMutex);
+
+  auto iter = m_DataTypeIndex.find(className);
+  if (iter == m_DataTypeIndex.end())
+    return SetOfObjects::ConstPointer(SetOfObjects::New());
+
+  return this->ToSetOfObjects(iter->second);
+}
+
+mitk::DataStorage::SetOfObjects::ConstPointer mitk::DataStorage::GetSubsetByProperty(const std::string &key,
+                                                                                    const BaseProperty *value) const
+{
+  if (key.empty())
+    throw std::invalid_argument("DataStorage: invalid property key");
+
+  SetOfObjects::ConstPointer candidates;
+  {
+    std::shared_lock<std::shared_mutex> sharedLock(m_IndexMutex);
+    std::unique_lock<std::shared_mutex> uniqueLock;
+
+    if (m_TrackedPropertyKeys.find(key) == m_TrackedPropertyKeys.end())
+    {
+      // build the index of the key on first use
+      sharedLock.unlock();
+      uniqueLock = std::unique_lock<std::shared_mutex>(m_IndexMutex);
+      if (m_TrackedPropertyKeys.find(key) == m_TrackedPropertyKeys.end())
+        const_cast<DataStorage *>(this)->TrackPropertyKey(key);
+    }
+
+    NodeSetType nodes;
+    auto keyIter = m_PropertyIndex.find(key);
+    if (keyIter != m_PropertyIndex.end())
+    {
+      if (value == nullptr)
+      {
+        for (const auto &valueNodes : keyIter->second)
+          nodes.insert(valueNodes.second.begin(), valueNodes.second.end());
+      }
+      else
+      {
+        auto valueIter = keyIter->second.find(value->GetValueAsString());
+        if (valueIter != keyIter->second.end())
+          nodes = valueIter->second;
+      }
+    }
+
+    candidates = this->ToSetOfObjects(nodes);
+  }
+
+  if (value == nullptr)
+    return candidates;
+
+  // equal value strings do not imply equal properties, e.g. for different property types
+  SetOfObjects::Pointer result = SetOfObjects::New();
+  for (auto iter = candidates->Begin(); iter != candidates->End(); ++iter)
+  {
+    const BaseProperty *property = iter->Value()->GetProperty(key.c_str());
+    if (property != nullptr && *property == *value)
+      result->InsertElement(result->Size(), iter->Value());
+  }
+
+  return SetOfObjects::ConstPointer(result);
+}
+
 mitk::DataNode *mitk::DataStorage::GetNamedNode(const char *name) const
 
 {
   if (name == nullptr)
     return nullptr;
 
-  StringProperty::Pointer s(StringProperty::New(name));
-  NodePredicateProperty::Pointer p = NodePredicateProperty::New("name", s);
-  DataStorage::SetOfObjects::ConstPointer rs = this->GetSubset(p);
+  DataStorage::SetOfObjects::ConstPointer rs = this->GetSubsetByName(name);
   if (rs->Size() >= 1)
     return rs->GetElement(0);
   else
@@ -174,12 +275,27 @@ const mitk::DataNode::GroupTagList mitk::DataStorage::GetGroupTags() const
 
 void mitk::DataStorage::EmitAddNodeEvent(const DataNode *node)
 {
+  {
+    std::unique_lock<std::shared_mutex> locked(m_IndexMutex);
+    this->IndexNode(node);
+  }
+
+  // views are up to date when the observers of AddNodeEvent are called
+  this->NotifyViews([node](DataStorageView *view) { view->OnNodeAdded(node); });
+
   AddNodeEvent.Send(node);
 }
 
 void mitk::DataStorage::EmitRemoveNodeEvent(const DataNode *node)
 {
   RemoveNodeEvent.Send(node);
+
+  {
+    std::unique_lock<std::shared_mutex> locked(m_IndexMutex);
+    this->UnindexNode(node);
+  }
+
+  this->NotifyViews([node](DataStorageView *view) { view->OnNodeRemoved(node); });
 }
 
 void mitk::DataStorage::OnNodeInteractorChanged(itk::Object *caller, const itk::EventObject &)
@@ -193,10 +309,22 @@ void mitk::DataStorage::OnNodeInteractorChanged(itk::Object *caller, const itk::
 
 void mitk::DataStorage::OnNodeModifiedOrDeleted(const itk::Object *caller, const itk::EventObject &event)
 {
+  const auto *_Node = dynamic_cast<const DataNode *>(caller);
+
+  // indexes and views are also updated if NodeChangedEvent is blocked
+  if (_Node && dynamic_cast<const itk::ModifiedEvent *>(&event))
+  {
+    {
+      std::unique_lock<std::shared_mutex> locked(m_IndexMutex);
+      this->ReindexNode(_Node);
+    }
+
+    this->NotifyViews([_Node](DataStorageView *view) { view->OnNodeModified(_Node); });
+  }
+
   if (m_BlockNodeModifiedEvents)
     return;
 
-  const auto *_Node = dynamic_cast<const DataNode *>(caller);
   if (_Node)
   {
     const auto *modEvent = dynamic_cast<const itk::ModifiedEvent *>(&event);
@@ -251,6 +379,238 @@ void mitk::DataStorage::RemoveListeners(const DataNode *_Node)
   }
 }
 
+void mitk::DataStorage::RegisterView(DataStorageView *view, const std::set<std::string> &propertyKeys)
+{
+  {
+    std::unique_lock<std::shared_mutex> locked(m_IndexMutex);
+    for (const auto &key : propertyKeys)
+      this->TrackPropertyKey(key);
+  }
+
+  std::lock_guard<std::recursive_mutex> locked(m_ViewsMutex);
+  m_Views.insert(view);
+}
+
+void mitk::DataStorage::UnregisterView(DataStorageView *view, const std::set<std::string> &propertyKeys)
+{
+  {
+    std::lock_guard<std::recursive_mutex> locked(m_ViewsMutex);
+    m_Views.erase(view);
+  }
+
+  std::unique_lock<std::shared_mutex> locked(m_IndexMutex);
+  for (const auto &key : propertyKeys)
+    this->UntrackPropertyKey(key);
+}
+
+void mitk::DataStorage::IndexNode(const DataNode *node)
+{
+  if (node == nullptr || m_NodeIndex.find(node) != m_NodeIndex.end())
+    return;
+
+  auto &entry = m_NodeIndex[node];
+
+  if (node->GetData() != nullptr)
+  {
+    entry.m_DataType = node->GetData()->GetNameOfClass();
+    m_DataTypeIndex[entry.m_DataType].insert(node);
+  }
+
+  for (const auto &key : m_TrackedPropertyKeys)
+    this->IndexProperty(node, entry, key.first);
+}
+
+void mitk::DataStorage::UnindexNode(const DataNode *node)
+{
+  auto iter = m_NodeIndex.find(node);
+  if (iter == m_NodeIndex.end())
+    return;
+
+  auto &entry = iter->second;
+
+  if (!entry.m_DataType.empty())
+  {
+    auto typeIter = m_DataTypeIndex.find(entry.m_DataType);
+    typeIter->second.erase(node);
+    if (typeIter->second.empty())
+      m_DataTypeIndex.erase(typeIter);
+  }
+
+  while (!entry.m_Properties.empty())
+    this->UnindexProperty(node, entry, entry.m_Properties.begin()->first);
+
+  m_NodeIndex.erase(iter);
+}
+
+void mitk::DataStorage::ReindexNode(const DataNode *node)
+{
+  auto iter = m_NodeIndex.find(node);
+  if (iter == m_NodeIndex.end())
+    return;
+
+  auto &entry = iter->second;
+
+  const std::string dataType = node->GetData() != nullptr ? node->GetData()->GetNameOfClass() : "";
+  if (dataType != entry.m_DataType)
+  {
+    if (!entry.m_DataType.empty())
+    {
+      auto typeIter = m_DataTypeIndex.find(entry.m_DataType);
+      typeIter->second.erase(node);
+      if (typeIter->second.empty())
+        m_DataTypeIndex.erase(typeIter);
+    }
+
+    entry.m_DataType = dataType;
+    if (!dataType.empty())
+      m_DataTypeIndex[dataType].insert(node);
+  }
+
+  for (const auto &key : m_TrackedPropertyKeys)
+    this->IndexProperty(node, entry, key.first);
+}
+
+void mitk::DataStorage::IndexProperty(const DataNode *node, NodeIndexEntry &entry, const std::string &key)
+{
+  const BaseProperty *property = node->GetProperty(key.c_str());
+  auto iter = entry.m_Properties.find(key);
+
+  if (iter != entry.m_Properties.end())
+  {
+    if (iter->second.m_Property == property)
+    {
+      // same property object, only its value may have changed
+      auto value = property->GetValueAsString();
+      if (value != iter->second.m_Value)
+      {
+        auto &valueIndex = m_PropertyIndex[key];
+        valueIndex[iter->second.m_Value].erase(node);
+        if (valueIndex[iter->second.m_Value].empty())
+          valueIndex.erase(iter->second.m_Value);
+
+        valueIndex[value].insert(node);
+        iter->second.m_Value = value;
+      }
+      return;
+    }
+
+    this->UnindexProperty(node, entry, key);
+  }
+
+  if (property == nullptr)
+    return;
+
+  IndexedProperty indexedProperty = { property, property->GetValueAsString() };
+  m_PropertyIndex[key][indexedProperty.m_Value].insert(node);
+  entry.m_Properties[key] = indexedProperty;
+
+  auto &observation = m_ObservedProperties[property];
+  if (observation.m_Property.IsNull())
+  {
+    // keeps the property alive until the observer is removed again
+    observation.m_Property = property;
+
+    auto command = itk::MemberCommand<DataStorage>::New();
+    command->SetCallbackFunction(this, &DataStorage::OnPropertyModified);
+    observation.m_ObserverTag = property->AddObserver(itk::ModifiedEvent(), command);
+  }
+  observation.m_Owners.emplace(node, key);
+}
+
+void mitk::DataStorage::UnindexProperty(const DataNode *node, NodeIndexEntry &entry, const std::string &key)
+{
+  auto iter = entry.m_Properties.find(key);
+  if (iter == entry.m_Properties.end())
+    return;
+
+  auto &valueIndex = m_PropertyIndex[key];
+  auto valueIter = valueIndex.find(iter->second.m_Value);
+  if (valueIter != valueIndex.end())
+  {
+    valueIter->second.erase(node);
+    if (valueIter->second.empty())
+      valueIndex.erase(valueIter);
+  }
+
+  auto observationIter = m_ObservedProperties.find(iter->second.m_Property);
+  if (observationIter != m_ObservedProperties.end())
+  {
+    auto &observation = observationIter->second;
+    observation.m_Owners.erase(std::make_pair(node, key));
+
+    if (observation.m_Owners.empty())
+    {
+      const_cast<BaseProperty *>(observation.m_Property.GetPointer())->RemoveObserver(observation.m_ObserverTag);
+      m_ObservedProperties.erase(observationIter);
+    }
+  }
+
+  entry.m_Properties.erase(iter);
+}
+
+void mitk::DataStorage::TrackPropertyKey(const std::string &key)
+{
+  if (++m_TrackedPropertyKeys[key] > 1)
+    return;
+
+  for (auto &entry : m_NodeIndex)
+    this->IndexProperty(entry.first, entry.second, key);
+}
+
+void mitk::DataStorage::UntrackPropertyKey(const std::string &key)
+{
+  auto iter = m_TrackedPropertyKeys.find(key);
+  if (iter == m_TrackedPropertyKeys.end() || --iter->second > 0)
+    return;
+
+  for (auto &entry : m_NodeIndex)
+    this->UnindexProperty(entry.first, entry.second, key);
+
+  m_PropertyIndex.erase(key);
+  m_TrackedPropertyKeys.erase(iter);
+}
+
+void mitk::DataStorage::OnPropertyModified(const itk::Object *caller, const itk::EventObject &)
+{
+  std::vector<std::pair<const DataNode *, std::string>> modified;
+  {
+    std::unique_lock<std::shared_mutex> locked(m_IndexMutex);
+
+    auto iter = m_ObservedProperties.find(dynamic_cast<const BaseProperty *>(caller));
+    if (iter == m_ObservedProperties.end())
+      return;
+
+    // IndexProperty() may modify the owners
+    const auto owners = iter->second.m_Owners;
+    for (const auto &owner : owners)
+    {
+      auto entryIter = m_NodeIndex.find(owner.first);
+      if (entryIter == m_NodeIndex.end())
+        continue;
+
+      this->IndexProperty(owner.first, entryIter->second, owner.second);
+      modified.push_back(owner);
+    }
+  }
+
+  this->NotifyViews([&modified](DataStorageView *view) {
+    for (const auto &owner : modified)
+      view->OnPropertyModified(owner.first, owner.second);
+  });
+}
+
+mitk::DataStorage::SetOfObjects::ConstPointer mitk::DataStorage::ToSetOfObjects(const NodeSetType &nodes) const
+{
+  // indexed nodes are still held by the DataStorage, i.e. they are alive as long as m_IndexMutex is locked
+  SetOfObjects::Pointer result = SetOfObjects::New();
+  result->CastToSTLContainer().reserve(nodes.size());
+
+  for (auto node : nodes)
+    result->InsertElement(result->Size(), const_cast<DataNode *>(node));
+
+  return SetOfObjects::ConstPointer(result);
+}
+
 mitk::TimeGeometry::ConstPointer mitk::DataStorage::ComputeBoundingGeometry3D(const SetOfObjects *input,
                                                                               const char *boolPropertyKey,
                                                                               const BaseRenderer *renderer,
@@ -0,0 +1,218 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkDataStorageView.h"
+
+#include <algorithm>
+#include <mutex>
+
+mitk::DataStorageView::DataStorageView(DataStorage *dataStorage, const NodePredicateBase *predicate)
+  : m_DataStorage(dataStorage),
+    m_Predicate(predicate),
+    m_DependsOnDataStorage(false),
+    m_OutOfDate(true)
+{
+  if (dataStorage == nullptr)
+    throw std::invalid_argument("DataStorageView: invalid DataStorage");
+
+  if (m_Predicate.IsNotNull())
+  {
+    m_Predicate->CollectPropertyKeys(m_PropertyKeys);
+    m_DependsOnDataStorage = m_Predicate->DependsOnDataStorage();
+  }
+
+  m_DataStorage.SetDeleteEventCallback([this]() {
+    std::unique_lock<std::shared_mutex> locked(m_Mutex);
+    m_Nodes.clear();
+    m_OutOfDate = false;
+    m_Snapshot = nullptr;
+  });
+
+  dataStorage->RegisterView(this, m_PropertyKeys);
+}
+
+mitk::DataStorageView::~DataStorageView()
+{
+  auto dataStorage = m_DataStorage.Lock();
+  if (dataStorage.IsNotNull())
+    dataStorage->UnregisterView(this, m_PropertyKeys);
+}
+
+const mitk::NodePredicateBase *mitk::DataStorageView::GetPredicate() const
+{
+  return m_Predicate;
+}
+
+mitk::DataStorage::SetOfObjects::ConstPointer mitk::DataStorageView::GetNodes() const
+{
+  {
+    std::shared_lock<std::shared_mutex> locked(m_Mutex);
+    if (!m_OutOfDate && m_Snapshot.IsNotNull())
+      return m_Snapshot;
+  }
+
+  std::unique_lock<std::shared_mutex> locked(m_Mutex);
+
+  if (m_OutOfDate)
+    this->Evaluate();
+
+  if (m_Snapshot.IsNull())
+  {
+    // nodes of the view are held by the DataStorage, since removed nodes are removed from the view, too
+    DataStorage::SetOfObjects::Pointer snapshot = DataStorage::SetOfObjects::New();
+    snapshot->CastToSTLContainer().reserve(m_Nodes.size());
+
+    for (auto node : m_Nodes)
+      snapshot->InsertElement(snapshot->Size(), const_cast<DataNode *>(node));
+
+    m_Snapshot = snapshot.GetPointer();
+  }
+
+  return m_Snapshot;
+}
+
+bool mitk::DataStorageView::Contains(const DataNode *node) const
+{
+  {
+    std::shared_lock<std::shared_mutex> locked(m_Mutex);
+    if (!m_OutOfDate)
+      return m_Nodes.find(node) != m_Nodes.end();
+  }
+
+  auto nodes = this->GetNodes();
+  return std::find(nodes->begin(), nodes->end(), node) != nodes->end();
+}
+
+unsigned int mitk::DataStorageView::GetSize() const
+{
+  {
+    std::shared_lock<std::shared_mutex> locked(m_Mutex);
+    if (!m_OutOfDate)
+      return static_cast<unsigned int>(m_Nodes.size());
+  }
+
+  return this->GetNodes()->Size();
+}
+
+void mitk::DataStorageView::Refresh()
+{
+  {
+    std::unique_lock<std::shared_mutex> locked(m_Mutex);
+    this->Evaluate();
+  }
+
+  this->Modified();
+}
+
+void mitk::DataStorageView::Evaluate() const
+{
+  m_Nodes.clear();
+  m_Snapshot = nullptr;
+  m_OutOfDate = false;
+
+  auto dataStorage = m_DataStorage.Lock();
+  if (dataStorage.IsNull())
+    return;
+
+  auto nodes = dataStorage->GetSubset(m_Predicate);
+  for (auto iter = nodes->Begin(); iter != nodes->End(); ++iter)
+    m_Nodes.insert(iter->Value().GetPointer());
+}
+
+bool mitk::DataStorageView::CheckNode(const DataNode *node) const
+{
+  return m_Predicate.IsNull() || m_Predicate->CheckNode(node);
+}
+
+bool mitk::DataStorageView::Update(const DataNode *node, bool meetsPredicate)
+{
+  bool changed = false;
+
+  if (meetsPredicate)
+    changed = m_Nodes.insert(node).second;
+  else
+    changed = m_Nodes.erase(node) > 0;
+
+  if (changed)
+    m_Snapshot = nullptr;
+
+  return changed;
+}
+
+bool mitk::DataStorageView::Invalidate()
+{
+  if (m_OutOfDate)
+    return false;
+
+  m_OutOfDate = true;
+  m_Snapshot = nullptr;
+  return true;
+}
+
+void mitk::DataStorageView::OnNodeAdded(const DataNode *node)
+{
+  this->OnNodeModified(node);
+}
+
+void mitk::DataStorageView::OnNodeRemoved(const DataNode *node)
+{
+  bool changed = false;
+  {
+    std::unique_lock<std::shared_mutex> locked(m_Mutex);
+
+    // the node must not stay in the view, even if the view is re-evaluated later on
+    changed = this->Update(node, false);
+
+    if (m_DependsOnDataStorage)
+      changed = this->Invalidate() || changed;
+  }
+
+  if (changed)
+    this->Modified();
+}
+
+void mitk::DataStorageView::OnNodeModified(const DataNode *node)
+{
+  bool changed = false;
+  {
+    std::unique_lock<std::shared_mutex> locked(m_Mutex);
+
+    if (m_OutOfDate)
+      return;
+
+    if (m_DependsOnDataStorage)
+    {
+      changed = this->Invalidate();
+    }
+    else
+    {
+      try
+      {
+        changed = this->Update(node, this->CheckNode(node));
+      }
+      catch (const std::exception &)
+      {
+        // the exception is reported to the caller of the next GetNodes()
+        changed = this->Invalidate();
+      }
+    }
+  }
+
+  if (changed)
+    this->Modified();
+}
+
+void mitk::DataStorageView::OnPropertyModified(const DataNode *node, const std::string &propertyKey)
+{
+  if (m_PropertyKeys.find(propertyKey) != m_PropertyKeys.end())
+    this->OnNodeModified(node);
+}
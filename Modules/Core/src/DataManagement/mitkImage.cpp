@@ -38,6 +38,7 @@ mitk::Image::Image()
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
+    m_DataAllocator(nullptr),
     m_ImageStatistics(nullptr)
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
@@ -53,6 +54,7 @@ mitk::Image::Image(const Image &other)
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
+    m_DataAllocator(other.m_DataAllocator),
     m_ImageStatistics(nullptr)
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
@@ -311,7 +313,7 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetVolumeData_unlocked(
       // ok, let's combine the slices!
       if (vol.GetPointer() == nullptr)
       {
-        vol = new ImageDataItem(chPixelType, t, 3, m_Dimensions, nullptr, true);
+        vol = new ImageDataItem(chPixelType, t, 3, m_Dimensions, nullptr, true, m_DataAllocator);
       }
       vol->SetComplete(true);
       size_t size = m_OffsetTable[2] * (ptypeSize);
@@ -409,7 +411,7 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetChannelData_unlocked(
       ch = m_Channels[n];
       // ok, let's combine the volumes!
       if (ch.GetPointer() == nullptr)
-        ch = new ImageDataItem(this->m_ImageDescriptor, -1, nullptr, true);
+        ch = new ImageDataItem(this->m_ImageDescriptor, -1, nullptr, true, m_DataAllocator);
       ch->SetComplete(true);
       size_t size = m_OffsetTable[m_Dimension - 1] * (ptypeSize);
       unsigned int t;
@@ -709,6 +711,40 @@ bool mitk::Image::SetImportChannel(void *data, int n, ImportMemoryManagementType
   return true;
 }
 
+bool mitk::Image::SetImportChannel(void *data, int n, ImageDataAllocator *allocator)
+{
+  if (IsValidChannel(n) == false || data == nullptr || allocator == nullptr)
+    return false;
+
+  bool channelWasSet = false;
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+
+    channelWasSet = m_Channels[n].IsNotNull() && m_Channels[n]->IsComplete();
+
+    ImageDataItemPointer ch = new ImageDataItem(this->m_ImageDescriptor, -1, data, true, allocator);
+    ch->SetComplete(true);
+
+    // volumes and slices of the channel refer to the memory of the replaced channel
+    for (unsigned int t = 0; t < m_Dimensions[3]; ++t)
+    {
+      m_Volumes[GetVolumeIndex(t, n)] = nullptr;
+      for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+        m_Slices[GetSliceIndex(s, t, n)] = nullptr;
+    }
+    if (n == 0)
+      m_CompleteData = nullptr;
+
+    m_Channels[n] = ch;
+    this->m_ImageDescriptor->GetChannelDescriptor(n).SetData(ch->GetData());
+  }
+
+  if (channelWasSet)
+    Modified();
+
+  return true;
+}
+
 void mitk::Image::Initialize()
 {
   ImageDataItemPointerArray::iterator it, end;
@@ -1146,7 +1182,7 @@ mitk::Image::ImageDataItemPointer mitk::Image::AllocateVolumeData_unlocked(
   // allocate new volume
   if (importMemoryManagement == CopyMemory)
   {
-    vol = new ImageDataItem(chPixelType, t, 3, m_Dimensions, nullptr, true);
+    vol = new ImageDataItem(chPixelType, t, 3, m_Dimensions, nullptr, true, m_DataAllocator);
     if (data != nullptr)
       std::memcpy(vol->GetData(), data, m_OffsetTable[3] * (ptypeSize));
   }
@@ -1174,7 +1210,7 @@ mitk::Image::ImageDataItemPointer mitk::Image::AllocateChannelData_unlocked(
   {
     const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
 
-    ch = new ImageDataItem(this->m_ImageDescriptor, -1, nullptr, true);
+    ch = new ImageDataItem(this->m_ImageDescriptor, -1, nullptr, true, m_DataAllocator);
     if (data != nullptr)
       std::memcpy(ch->GetData(), data, m_OffsetTable[4] * (ptypeSize));
   }
@@ -0,0 +1,489 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkImageDataAllocator.h"
+
+#include "mitkIOUtil.h"
+#include "mitkMemoryUtilities.h"
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#if _MSC_VER
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  std::mutex s_DefaultAllocatorMutex;
+  mitk::ImageDataAllocator::Pointer s_DefaultAllocator;
+
+  void ThrowAllocationError(const std::string &message)
+  {
+    throw itk::MemoryAllocationError(__FILE__, __LINE__, message, ITK_LOCATION);
+  }
+
+  size_t GetPageSize()
+  {
+#if _MSC_VER
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwAllocationGranularity;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+  }
+
+  size_t RoundUp(size_t value, size_t multiple)
+  {
+    return (value + multiple - 1) / multiple * multiple;
+  }
+
+  /** Mapped pages of an allocation of the MappedFileImageDataAllocator.*/
+  struct FileMapping
+  {
+    void *Mapping;
+    size_t Length;
+    std::string FileName;
+    bool IsDetached; // replaced by anonymous memory by DetachFromFile()
+  };
+
+  // Registry of all mappings of all MappedFileImageDataAllocators by the allocated address, so that
+  // writers can find the memory mapped from the file they are going to overwrite
+  std::mutex s_FileMappingsMutex;
+  std::map<void *, FileMapping> s_FileMappings;
+
+  std::string GetRealFileName(const std::string &fileName)
+  {
+    return itksys::SystemTools::GetRealPath(fileName);
+  }
+
+  /** Replace the mapped pages by anonymous memory of the same content at the same address.*/
+  void DetachMapping(FileMapping &fileMapping)
+  {
+#if _MSC_VER
+    void *copy = VirtualAlloc(nullptr, fileMapping.Length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (nullptr == copy)
+      ThrowAllocationError("Failed to allocate memory to detach " + fileMapping.FileName);
+
+    std::memcpy(copy, fileMapping.Mapping, fileMapping.Length);
+
+    // views cannot be replaced atomically, but the address is reserved again right after unmapping
+    UnmapViewOfFile(fileMapping.Mapping);
+    void *data = VirtualAlloc(fileMapping.Mapping, fileMapping.Length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+    if (data != fileMapping.Mapping)
+    {
+      VirtualFree(copy, 0, MEM_RELEASE);
+      ThrowAllocationError("Failed to detach memory from " + fileMapping.FileName);
+    }
+
+    std::memcpy(data, copy, fileMapping.Length);
+    VirtualFree(copy, 0, MEM_RELEASE);
+#else
+    void *copy = mmap(nullptr, fileMapping.Length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == copy)
+      ThrowAllocationError("Failed to allocate memory to detach " + fileMapping.FileName);
+
+    std::memcpy(copy, fileMapping.Mapping, fileMapping.Length);
+
+    // MAP_FIXED atomically replaces the mapped pages of the file
+    void *data = mmap(fileMapping.Mapping,
+                      fileMapping.Length,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+                      -1,
+                      0);
+
+    if (data != fileMapping.Mapping)
+    {
+      munmap(copy, fileMapping.Length);
+      ThrowAllocationError("Failed to detach memory from " + fileMapping.FileName);
+    }
+
+    std::memcpy(data, copy, fileMapping.Length);
+    munmap(copy, fileMapping.Length);
+#endif
+
+    fileMapping.IsDetached = true;
+  }
+}
+
+// ImageDataAllocator
+
+mitk::ImageDataAllocator::ImageDataAllocator()
+{
+}
+
+mitk::ImageDataAllocator::~ImageDataAllocator()
+{
+}
+
+mitk::ImageDataAllocator::Pointer mitk::ImageDataAllocator::GetDefaultAllocator()
+{
+  std::lock_guard<std::mutex> lock(s_DefaultAllocatorMutex);
+
+  if (s_DefaultAllocator.IsNull())
+    s_DefaultAllocator = HeapImageDataAllocator::New().GetPointer();
+
+  return s_DefaultAllocator;
+}
+
+void mitk::ImageDataAllocator::SetDefaultAllocator(ImageDataAllocator *allocator)
+{
+  std::lock_guard<std::mutex> lock(s_DefaultAllocatorMutex);
+  s_DefaultAllocator = allocator;
+}
+
+// HeapImageDataAllocator
+
+mitk::HeapImageDataAllocator::HeapImageDataAllocator()
+{
+}
+
+mitk::HeapImageDataAllocator::~HeapImageDataAllocator()
+{
+}
+
+void *mitk::HeapImageDataAllocator::Allocate(size_t numberOfBytes)
+{
+  return MemoryUtilities::AllocateElements<unsigned char>(numberOfBytes);
+}
+
+void mitk::HeapImageDataAllocator::Deallocate(void *data, size_t)
+{
+  MemoryUtilities::DeleteElements(static_cast<unsigned char *>(data));
+}
+
+// AlignedImageDataAllocator
+
+mitk::AlignedImageDataAllocator::AlignedImageDataAllocator() : m_Alignment(64)
+{
+}
+
+mitk::AlignedImageDataAllocator::~AlignedImageDataAllocator()
+{
+}
+
+void mitk::AlignedImageDataAllocator::SetAlignment(size_t alignment)
+{
+  if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0)
+  {
+    itkExceptionMacro("Alignment must be a power of two of at least " << sizeof(void *) << ", but is " << alignment);
+  }
+
+  if (m_Alignment != alignment)
+  {
+    m_Alignment = alignment;
+    this->Modified();
+  }
+}
+
+void *mitk::AlignedImageDataAllocator::Allocate(size_t numberOfBytes)
+{
+  const size_t size = RoundUp(std::max<size_t>(numberOfBytes, 1), m_Alignment);
+  void *data = nullptr;
+
+#if _MSC_VER
+  data = _aligned_malloc(size, m_Alignment);
+#else
+  if (0 != posix_memalign(&data, m_Alignment, size))
+    data = nullptr;
+#endif
+
+  if (nullptr == data)
+    ThrowAllocationError("Failed to allocate aligned memory.");
+
+  return data;
+}
+
+void mitk::AlignedImageDataAllocator::Deallocate(void *data, size_t)
+{
+#if _MSC_VER
+  _aligned_free(data);
+#else
+  free(data);
+#endif
+}
+
+// HugePageImageDataAllocator
+
+mitk::HugePageImageDataAllocator::HugePageImageDataAllocator()
+{
+}
+
+mitk::HugePageImageDataAllocator::~HugePageImageDataAllocator()
+{
+}
+
+void *mitk::HugePageImageDataAllocator::Allocate(size_t numberOfBytes)
+{
+  const size_t size = RoundUp(std::max<size_t>(numberOfBytes, 1), HugePageSize);
+
+#if _MSC_VER
+  // large pages require the SeLockMemoryPrivilege, which users usually lack
+  void *data = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  if (nullptr == data)
+    ThrowAllocationError("Failed to allocate memory.");
+  return data;
+#else
+  // over-allocate by one huge page to be able to align the block to a huge page boundary
+  void *mapping = mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == mapping)
+    ThrowAllocationError("Failed to map memory.");
+
+  auto *begin = static_cast<char *>(mapping);
+  auto *data = reinterpret_cast<char *>(RoundUp(reinterpret_cast<size_t>(begin), HugePageSize));
+  auto *end = begin + size + HugePageSize;
+
+  if (data > begin)
+    munmap(begin, data - begin);
+  if (end > data + size)
+    munmap(data + size, end - (data + size));
+
+#ifdef MADV_HUGEPAGE
+  madvise(data, size, MADV_HUGEPAGE);
+#endif
+
+  return data;
+#endif
+}
+
+void mitk::HugePageImageDataAllocator::Deallocate(void *data, size_t numberOfBytes)
+{
+#if _MSC_VER
+  VirtualFree(data, 0, MEM_RELEASE);
+#else
+  munmap(data, RoundUp(std::max<size_t>(numberOfBytes, 1), HugePageSize));
+#endif
+}
+
+// FileBackedImageDataAllocator
+
+mitk::FileBackedImageDataAllocator::FileBackedImageDataAllocator()
+{
+}
+
+mitk::FileBackedImageDataAllocator::~FileBackedImageDataAllocator()
+{
+}
+
+void *mitk::FileBackedImageDataAllocator::Allocate(size_t numberOfBytes)
+{
+  const size_t size = std::max<size_t>(numberOfBytes, 1);
+  const std::string directory = m_Directory.empty() ? IOUtil::GetTempPath() : m_Directory;
+
+#if _MSC_VER
+  const std::string filename = IOUtil::CreateTemporaryFile("ImageData_XXXXXX.raw", directory);
+
+  // the file is deleted as soon as the last handle is closed and the view is unmapped
+  HANDLE file = CreateFileA(filename.c_str(),
+                            GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                            nullptr);
+  if (INVALID_HANDLE_VALUE == file)
+    ThrowAllocationError("Failed to open backing file " + filename);
+
+  const auto size64 = static_cast<unsigned long long>(size);
+  HANDLE mapping = CreateFileMappingA(
+    file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFF), nullptr);
+  CloseHandle(file);
+
+  if (nullptr == mapping)
+    ThrowAllocationError("Failed to map backing file " + filename);
+
+  void *data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  CloseHandle(mapping);
+
+  if (nullptr == data)
+    ThrowAllocationError("Failed to map backing file " + filename);
+
+  return data;
+#else
+  std::string filenameTemplate = directory + "/ImageData_XXXXXX";
+  std::vector<char> filename(filenameTemplate.begin(), filenameTemplate.end());
+  filename.push_back('\0');
+
+  const int file = mkstemp(filename.data());
+  if (file < 0)
+    ThrowAllocationError("Failed to create backing file in " + directory);
+
+  // the file is deleted as soon as it is unmapped
+  unlink(filename.data());
+
+  if (0 != ftruncate(file, static_cast<off_t>(size)))
+  {
+    close(file);
+    ThrowAllocationError("Failed to resize backing file in " + directory);
+  }
+
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+  close(file);
+
+  if (MAP_FAILED == data)
+    ThrowAllocationError("Failed to map backing file in " + directory);
+
+  return data;
+#endif
+}
+
+void mitk::FileBackedImageDataAllocator::Deallocate(void *data, size_t numberOfBytes)
+{
+#if _MSC_VER
+  UnmapViewOfFile(data);
+#else
+  munmap(data, std::max<size_t>(numberOfBytes, 1));
+#endif
+}
+
+// MappedFileImageDataAllocator
+
+mitk::MappedFileImageDataAllocator::MappedFileImageDataAllocator() : m_Offset(0)
+{
+}
+
+mitk::MappedFileImageDataAllocator::~MappedFileImageDataAllocator()
+{
+}
+
+void *mitk::MappedFileImageDataAllocator::Allocate(size_t numberOfBytes)
+{
+  if (m_FileName.empty())
+    ThrowAllocationError("No file to map.");
+
+  // mappings have to start at page boundaries
+  const size_t mappingOffset = m_Offset / GetPageSize() * GetPageSize();
+  const size_t mappingLength = m_Offset - mappingOffset + std::max<size_t>(numberOfBytes, 1);
+  void *mapping = nullptr;
+
+#if _MSC_VER
+  HANDLE file = CreateFileA(m_FileName.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_DELETE,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (INVALID_HANDLE_VALUE == file)
+    ThrowAllocationError("Failed to open " + m_FileName);
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) ||
+      static_cast<unsigned long long>(fileSize.QuadPart) < static_cast<unsigned long long>(m_Offset) + numberOfBytes)
+  {
+    CloseHandle(file);
+    ThrowAllocationError(m_FileName + " is too small to be mapped.");
+  }
+
+  HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+
+  if (nullptr == fileMapping)
+    ThrowAllocationError("Failed to map " + m_FileName);
+
+  const auto offset64 = static_cast<unsigned long long>(mappingOffset);
+  mapping = MapViewOfFile(fileMapping,
+                          FILE_MAP_COPY,
+                          static_cast<DWORD>(offset64 >> 32),
+                          static_cast<DWORD>(offset64 & 0xFFFFFFFF),
+                          mappingLength);
+  CloseHandle(fileMapping);
+
+  if (nullptr == mapping)
+    ThrowAllocationError("Failed to map " + m_FileName);
+#else
+  const int file = open(m_FileName.c_str(), O_RDONLY);
+  if (file < 0)
+    ThrowAllocationError("Failed to open " + m_FileName);
+
+  struct stat fileStatus;
+  if (0 != fstat(file, &fileStatus) ||
+      static_cast<unsigned long long>(fileStatus.st_size) < static_cast<unsigned long long>(m_Offset) + numberOfBytes)
+  {
+    close(file);
+    ThrowAllocationError(m_FileName + " is too small to be mapped.");
+  }
+
+  // private, writable mapping: pages are read on first access and copied on first write
+  mapping = mmap(nullptr, mappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, static_cast<off_t>(mappingOffset));
+  close(file);
+
+  if (MAP_FAILED == mapping)
+    ThrowAllocationError("Failed to map " + m_FileName);
+#endif
+
+  void *data = static_cast<char *>(mapping) + (m_Offset - mappingOffset);
+
+  std::lock_guard<std::mutex> lock(s_FileMappingsMutex);
+  s_FileMappings[data] = FileMapping{mapping, mappingLength, GetRealFileName(m_FileName), false};
+
+  return data;
+}
+
+void mitk::MappedFileImageDataAllocator::Deallocate(void *data, size_t)
+{
+  FileMapping fileMapping;
+
+  {
+    std::lock_guard<std::mutex> lock(s_FileMappingsMutex);
+
+    auto iter = s_FileMappings.find(data);
+    if (iter == s_FileMappings.end())
+    {
+      MITK_ERROR << "Ignoring memory that has not been mapped from " << m_FileName;
+      return;
+    }
+
+    fileMapping = iter->second;
+    s_FileMappings.erase(iter);
+  }
+
+#if _MSC_VER
+  if (fileMapping.IsDetached)
+    VirtualFree(fileMapping.Mapping, 0, MEM_RELEASE);
+  else
+    UnmapViewOfFile(fileMapping.Mapping);
+#else
+  munmap(fileMapping.Mapping, fileMapping.Length);
+#endif
+}
+
+void mitk::MappedFileImageDataAllocator::DetachFromFile(const std::string &fileName)
+{
+  std::lock_guard<std::mutex> lock(s_FileMappingsMutex);
+
+  if (s_FileMappings.empty() || !itksys::SystemTools::FileExists(fileName, true))
+    return;
+
+  const std::string realFileName = GetRealFileName(fileName);
+
+  for (auto &entry : s_FileMappings)
+  {
+    if (!entry.second.IsDetached && entry.second.FileName == realFileName)
+      DetachMapping(entry.second);
+  }
+}
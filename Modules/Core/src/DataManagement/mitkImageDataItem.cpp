@@ -11,7 +11,6 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkImageDataItem.h"
-#include "mitkMemoryUtilities.h"
 #include <vtkImageData.h>
 #include <vtkPointData.h>
 
@@ -90,7 +89,12 @@ mitk::ImageDataItem::~ImageDataItem()
   if (m_Parent.IsNull())
   {
     if (m_ManageMemory)
-      delete[] m_Data;
+    {
+      if (m_Allocator.IsNotNull())
+        m_Allocator->Deallocate(m_Data, m_Size);
+      else
+        delete[] m_Data;
+    }
   }
   delete m_PixelType;
 }
@@ -98,7 +102,8 @@ mitk::ImageDataItem::~ImageDataItem()
 mitk::ImageDataItem::ImageDataItem(const mitk::ImageDescriptor::Pointer desc,
                                    int timestep,
                                    void *data,
-                                   bool manageMemory)
+                                   bool manageMemory,
+                                   ImageDataAllocator *allocator)
   : m_Data(static_cast<unsigned char *>(data)),
     m_PixelType(new mitk::PixelType(desc->GetChannelDescriptor(0).GetPixelType())),
     m_ManageMemory(manageMemory),
@@ -108,6 +113,7 @@ mitk::ImageDataItem::ImageDataItem(const mitk::ImageDescriptor::Pointer desc,
     m_Offset(0),
     m_IsComplete(false),
     m_Size(0),
+    m_Allocator(manageMemory ? allocator : nullptr),
     m_Dimension(desc->GetNumberOfDimensions()),
     m_Timestep(timestep)
 {
@@ -122,8 +128,7 @@ mitk::ImageDataItem::ImageDataItem(const mitk::ImageDescriptor::Pointer desc,
 
   if (m_Data == nullptr)
   {
-    m_Data = mitk::MemoryUtilities::AllocateElements<unsigned char>(m_Size);
-    m_ManageMemory = true;
+    this->AllocateData(allocator);
   }
 
   m_ReferenceCount = 0;
@@ -134,7 +139,8 @@ mitk::ImageDataItem::ImageDataItem(const mitk::PixelType &type,
                                    unsigned int dimension,
                                    unsigned int *dimensions,
                                    void *data,
-                                   bool manageMemory)
+                                   bool manageMemory,
+                                   ImageDataAllocator *allocator)
   : m_Data(static_cast<unsigned char *>(data)),
     m_PixelType(new mitk::PixelType(type)),
     m_ManageMemory(manageMemory),
@@ -144,6 +150,7 @@ mitk::ImageDataItem::ImageDataItem(const mitk::PixelType &type,
     m_Offset(0),
     m_IsComplete(false),
     m_Size(0),
+    m_Allocator(manageMemory ? allocator : nullptr),
     m_Parent(nullptr),
     m_Dimension(dimension),
     m_Timestep(timestep)
@@ -157,8 +164,7 @@ mitk::ImageDataItem::ImageDataItem(const mitk::PixelType &type,
 
   if (m_Data == nullptr)
   {
-    m_Data = mitk::MemoryUtilities::AllocateElements<unsigned char>(m_Size);
-    m_ManageMemory = true;
+    this->AllocateData(allocator);
   }
 
   m_ReferenceCount = 0;
@@ -175,6 +181,7 @@ mitk::ImageDataItem::ImageDataItem(const ImageDataItem &other)
     m_Offset(other.m_Offset),
     m_IsComplete(other.m_IsComplete),
     m_Size(other.m_Size),
+    m_Allocator(other.m_Allocator),
     m_Parent(other.m_Parent),
     m_Dimension(other.m_Dimension),
     m_Timestep(other.m_Timestep)
@@ -200,6 +207,13 @@ void mitk::ImageDataItem::ComputeItemSize(const unsigned int *dimensions, unsign
   }
 }
 
+void mitk::ImageDataItem::AllocateData(ImageDataAllocator *allocator)
+{
+  m_Allocator = allocator != nullptr ? allocator : ImageDataAllocator::GetDefaultAllocator().GetPointer();
+  m_Data = static_cast<unsigned char *>(m_Allocator->Allocate(m_Size));
+  m_ManageMemory = true;
+}
+
 void mitk::ImageDataItem::ConstructVtkImageData(ImageConstPointer iP) const
 {
   vtkImageData *inData = vtkImageData::New();
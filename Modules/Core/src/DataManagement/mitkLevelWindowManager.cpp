@@ -69,6 +69,29 @@ void mitk::LevelWindowManager::SetDataStorage(DataStorage *dataStorage)
       MessageDelegate1<LevelWindowManager, const DataNode *>(this, &LevelWindowManager::DataStorageRemovedNode));
   }
 
+  auto notBinary = NodePredicateProperty::New("binary", BoolProperty::New(false));
+  auto hasLevelWindow = NodePredicateProperty::New("levelwindow", nullptr);
+
+  auto isImage = NodePredicateDataType::New("Image");
+  auto isDImage = NodePredicateDataType::New("DiffusionImage");
+  auto isTImage = NodePredicateDataType::New("TensorImage");
+  auto isOdfImage = NodePredicateDataType::New("OdfImage");
+  auto isShImage = NodePredicateDataType::New("ShImage");
+  auto predicateTypes = NodePredicateOr::New();
+  predicateTypes->AddPredicate(isImage);
+  predicateTypes->AddPredicate(isDImage);
+  predicateTypes->AddPredicate(isTImage);
+  predicateTypes->AddPredicate(isOdfImage);
+  predicateTypes->AddPredicate(isShImage);
+
+  NodePredicateAnd::Pointer predicate = NodePredicateAnd::New();
+  predicate->AddPredicate(notBinary);
+  predicate->AddPredicate(hasLevelWindow);
+  predicate->AddPredicate(predicateTypes);
+
+  // the view is kept up to date by the DataStorage, so that the relevant nodes are not searched on every call
+  m_RelevantNodes = DataStorageView::New(dataStorage, predicate);
+
   // register listener for new DataStorage
   m_DataStorage = dataStorage;
   m_DataStorage->AddNodeEvent.AddListener(
@@ -554,34 +577,12 @@ int mitk::LevelWindowManager::GetNumberOfObservers() const
 
 mitk::DataStorage::SetOfObjects::ConstPointer mitk::LevelWindowManager::GetRelevantNodes() const
 {
-  if (m_DataStorage.IsNull())
+  if (m_DataStorage.IsNull() || m_RelevantNodes.IsNull())
   {
     return DataStorage::SetOfObjects::ConstPointer(DataStorage::SetOfObjects::New());
   }
 
-  auto notBinary = NodePredicateProperty::New("binary", BoolProperty::New(false));
-  auto hasLevelWindow = NodePredicateProperty::New("levelwindow", nullptr);
-
-  auto isImage = NodePredicateDataType::New("Image");
-  auto isDImage = NodePredicateDataType::New("DiffusionImage");
-  auto isTImage = NodePredicateDataType::New("TensorImage");
-  auto isOdfImage = NodePredicateDataType::New("OdfImage");
-  auto isShImage = NodePredicateDataType::New("ShImage");
-  auto predicateTypes = NodePredicateOr::New();
-  predicateTypes->AddPredicate(isImage);
-  predicateTypes->AddPredicate(isDImage);
-  predicateTypes->AddPredicate(isTImage);
-  predicateTypes->AddPredicate(isOdfImage);
-  predicateTypes->AddPredicate(isShImage);
-
-  NodePredicateAnd::Pointer predicate = NodePredicateAnd::New();
-  predicate->AddPredicate(notBinary);
-  predicate->AddPredicate(hasLevelWindow);
-  predicate->AddPredicate(predicateTypes);
-
-  DataStorage::SetOfObjects::ConstPointer relevantNodes = m_DataStorage->GetSubset(predicate);
-
-  return relevantNodes;
+  return m_RelevantNodes->GetNodes();
 }
 
 void mitk::LevelWindowManager::UpdateObservers()
@@ -15,3 +15,12 @@ found in the LICENSE file.
 mitk::NodePredicateBase::~NodePredicateBase()
 {
 }
+
+void mitk::NodePredicateBase::CollectPropertyKeys(std::set<std::string> &) const
+{
+}
+
+bool mitk::NodePredicateBase::DependsOnDataStorage() const
+{
+  return false;
+}
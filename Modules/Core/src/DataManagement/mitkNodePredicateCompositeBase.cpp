@@ -12,7 +12,7 @@ found in the LICENSE file.
 
 #include "mitkNodePredicateCompositeBase.h"
 
-// for std::find
+// for std::find, std::any_of
 #include <algorithm>
 
 mitk::NodePredicateCompositeBase::~NodePredicateCompositeBase()
@@ -33,3 +33,16 @@ mitk::NodePredicateCompositeBase::ChildPredicates mitk::NodePredicateCompositeBa
 {
   return m_ChildPredicates;
 }
+
+void mitk::NodePredicateCompositeBase::CollectPropertyKeys(std::set<std::string> &keys) const
+{
+  for (const auto &predicate : m_ChildPredicates)
+    predicate->CollectPropertyKeys(keys);
+}
+
+bool mitk::NodePredicateCompositeBase::DependsOnDataStorage() const
+{
+  return std::any_of(m_ChildPredicates.cbegin(),
+                     m_ChildPredicates.cend(),
+                     [](const NodePredicateBase::ConstPointer &predicate) { return predicate->DependsOnDataStorage(); });
+}
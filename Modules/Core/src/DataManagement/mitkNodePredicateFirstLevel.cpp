@@ -33,3 +33,8 @@ bool mitk::NodePredicateFirstLevel::CheckNode(const mitk::DataNode *node) const
   mitk::DataStorage::SetOfObjects::ConstPointer list = dataStorage->GetSources(node, nullptr, true);
   return (list->Size() == 0);
 }
+
+bool mitk::NodePredicateFirstLevel::DependsOnDataStorage() const
+{
+  return true;
+}
@@ -46,3 +46,8 @@ bool mitk::NodePredicateProperty::CheckNode(const mitk::DataNode *node) const
     return (*p == *m_ValidProperty); // search for name and property
   }
 }
+
+void mitk::NodePredicateProperty::CollectPropertyKeys(std::set<std::string> &keys) const
+{
+  keys.insert(m_ValidPropertyName);
+}
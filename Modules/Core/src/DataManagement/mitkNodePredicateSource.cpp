@@ -33,3 +33,8 @@ bool mitk::NodePredicateSource::CheckNode(const mitk::DataNode *childNode) const
 
   return false;
 }
+
+bool mitk::NodePredicateSource::DependsOnDataStorage() const
+{
+  return true;
+}
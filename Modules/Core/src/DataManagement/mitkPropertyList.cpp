@@ -40,6 +40,20 @@ std::vector<std::string> mitk::PropertyList::GetPropertyKeys(const std::string &
   return propertyKeys;
 };
 
+std::vector<std::string> mitk::PropertyList::GetPropertyKeysWithPrefix(const std::string &prefix) const
+{
+  std::vector<std::string> propertyKeys;
+
+  for (auto iter = m_Properties.lower_bound(prefix);
+       iter != m_Properties.cend() && 0 == iter->first.compare(0, prefix.size(), prefix);
+       ++iter)
+  {
+    propertyKeys.push_back(iter->first);
+  }
+
+  return propertyKeys;
+}
+
 std::vector<std::string> mitk::PropertyList::GetPropertyContextNames() const
 {
   return std::vector<std::string>();
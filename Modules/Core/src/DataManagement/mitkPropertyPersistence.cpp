@@ -11,10 +11,10 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include <algorithm>
-#include <regex>
 #include <utility>
 
 #include <mitkPropertyPersistence.h>
+#include <mitkPropertyRegEx.h>
 
 mitk::PropertyPersistence::PropertyPersistence()
 {
@@ -98,8 +98,7 @@ mitk::PropertyPersistence::InfoResultType mitk::PropertyPersistence::GetInfo(con
     select = [propertyName](const InfoMap::value_type &x) {
       if (x.second.IsNotNull() && x.second->IsRegEx())
       {
-        std::regex ex(x.second->GetName());
-        return std::regex_match(propertyName, ex);
+        return mitk::PropertyRegEx::Get(x.second->GetName())->Match(propertyName);
       }
       return false;
     };
@@ -130,8 +129,7 @@ bool infoPredicateRegEx(
 {
   if (x.second.IsNotNull() && x.second->IsRegEx())
   {
-    std::regex ex(x.second->GetName());
-    return std::regex_match(propertyName, ex) && x.second->GetMimeTypeName() == mime;
+    return x.second->GetMimeTypeName() == mime && mitk::PropertyRegEx::Get(x.second->GetName())->Match(propertyName);
   }
   return false;
 }
@@ -197,8 +195,7 @@ mitk::PropertyPersistence::InfoResultType mitk::PropertyPersistence::GetInfoByKe
       bool valid = pos.second->GetKey() == persistenceKey;
       if (!valid && pos.second->IsRegEx() && allowKeyRegEx)
       {
-        std::regex ex(pos.second->GetKey());
-        valid = std::regex_match(persistenceKey, ex);
+        valid = PropertyRegEx::Get(pos.second->GetKey())->Match(persistenceKey);
       }
 
       if (valid)
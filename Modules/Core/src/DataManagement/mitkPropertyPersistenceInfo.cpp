@@ -15,6 +15,7 @@ found in the LICENSE file.
 
 #include <mitkIOMimeTypes.h>
 #include <mitkPropertyPersistenceInfo.h>
+#include <mitkPropertyRegEx.h>
 #include <mitkStringProperty.h>
 
 namespace mitk
@@ -96,7 +97,7 @@ void mitk::PropertyPersistenceInfo::SetNameAndKey(const std::string &name, const
 
 void mitk::PropertyPersistenceInfo::UseRegEx(const std::string &nameRegEx, const std::string &nameTemplate)
 {
-  std::regex checker(nameRegEx); // no exception => valid we can change the info
+  PropertyRegEx::Get(nameRegEx); // no exception => valid we can change the info
   m_Impl->Name = nameRegEx;
   m_Impl->Key = nameRegEx;
   m_Impl->IsRegEx = true;
@@ -109,8 +110,8 @@ void mitk::PropertyPersistenceInfo::UseRegEx(const std::string &nameRegEx,
                                              const std::string &keyRegEx,
                                              const std::string keyTemplate)
 {
-  std::regex nameChecker(nameRegEx); // no exception => valid we can change the info
-  std::regex keyChecker(keyRegEx);   // no exception => valid we can change the info
+  PropertyRegEx::Get(nameRegEx); // no exception => valid we can change the info
+  PropertyRegEx::Get(keyRegEx);  // no exception => valid we can change the info
   m_Impl->Name = nameRegEx;
   m_Impl->Key = keyRegEx;
   m_Impl->IsRegEx = true;
@@ -172,8 +173,7 @@ std::string GenerateFromTemplate(const std::string &sourceStr,
                                  const std::string &regexStr)
 {
   std::smatch sm;
-  std::regex ex(regexStr);
-  std::regex_match(sourceStr, sm, ex);
+  mitk::PropertyRegEx::Get(regexStr)->Match(sourceStr, sm);
 
   std::string result = templateStr;
 
@@ -184,8 +184,7 @@ std::string GenerateFromTemplate(const std::string &sourceStr,
     {
       std::ostringstream stream;
       stream << "(\\$" << groupID << ")";
-      std::regex rex(stream.str());
-      result = std::regex_replace(result, rex, match.str());
+      result = std::regex_replace(result, mitk::PropertyRegEx::Get(stream.str())->GetRegEx(), match.str());
     }
     ++groupID;
   }
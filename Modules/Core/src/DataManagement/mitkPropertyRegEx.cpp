@@ -0,0 +1,186 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkPropertyRegEx.h"
+
+#include <cctype>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+  /** Patterns are rarely generated dynamically (e.g. with instance IDs). The cache is reset if it exceeds this size
+   to bound the memory in such scenarios.*/
+  const std::size_t MaximumCacheSize = 4096;
+
+  std::mutex &GetCacheMutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  std::unordered_map<std::string, mitk::PropertyRegEx::ConstPointer> &GetCache()
+  {
+    static std::unordered_map<std::string, mitk::PropertyRegEx::ConstPointer> cache;
+    return cache;
+  }
+
+  bool IsSpecialCharacter(char c)
+  {
+    return nullptr != std::strchr("^$.*+?()[]{}|\\", c);
+  }
+
+  bool IsOptionalQuantifier(char c)
+  {
+    return c == '*' || c == '?' || c == '{';
+  }
+}
+
+mitk::PropertyRegEx::ConstPointer mitk::PropertyRegEx::Get(const std::string &pattern)
+{
+  {
+    std::lock_guard<std::mutex> guard(GetCacheMutex());
+    auto finding = GetCache().find(pattern);
+    if (finding != GetCache().end())
+    {
+      return finding->second;
+    }
+  }
+
+  // compile outside of the lock; concurrent requests of a new pattern just compile it twice.
+  auto regEx = std::make_shared<const PropertyRegEx>(pattern);
+
+  std::lock_guard<std::mutex> guard(GetCacheMutex());
+  auto &cache = GetCache();
+  if (cache.size() >= MaximumCacheSize)
+  {
+    cache.clear();
+  }
+  return cache.emplace(pattern, regEx).first->second;
+}
+
+void mitk::PropertyRegEx::ClearCache()
+{
+  std::lock_guard<std::mutex> guard(GetCacheMutex());
+  GetCache().clear();
+}
+
+mitk::PropertyRegEx::PropertyRegEx(const std::string &pattern)
+  : m_Pattern(pattern), m_RegEx(pattern), m_IsLiteral(false), m_IsAnchored(!pattern.empty() && pattern[0] == '^')
+{
+  m_LiteralPrefix = DeduceLiteralPrefix(pattern, m_IsLiteral);
+}
+
+std::string mitk::PropertyRegEx::DeduceLiteralPrefix(const std::string &pattern, bool &isLiteral)
+{
+  isLiteral = false;
+
+  // alternatives have no common prefix (checked conservatively, also '|' in brackets counts)
+  for (std::size_t i = 0; i < pattern.size(); ++i)
+  {
+    if (pattern[i] == '\\')
+    {
+      ++i;
+    }
+    else if (pattern[i] == '|')
+    {
+      return std::string();
+    }
+  }
+
+  std::string prefix;
+  std::size_t pos = (!pattern.empty() && pattern[0] == '^') ? 1 : 0;
+
+  while (pos < pattern.size())
+  {
+    char literal = pattern[pos];
+    std::size_t next = pos + 1;
+
+    if (literal == '\\')
+    {
+      // only escaped punctuation is a literal, other escapes are character classes or assertions (\d, \b, ...)
+      if (next < pattern.size() && std::ispunct(static_cast<unsigned char>(pattern[next])))
+      {
+        literal = pattern[next];
+        ++next;
+      }
+      else
+      {
+        return prefix;
+      }
+    }
+    else if (IsSpecialCharacter(literal))
+    {
+      isLiteral = (literal == '$' && next == pattern.size());
+      return prefix;
+    }
+
+    if (next < pattern.size() && IsOptionalQuantifier(pattern[next]))
+    {
+      // the character may be missing in a match
+      return prefix;
+    }
+
+    prefix.push_back(literal);
+
+    if (next < pattern.size() && pattern[next] == '+')
+    {
+      return prefix;
+    }
+
+    pos = next;
+  }
+
+  isLiteral = true;
+  return prefix;
+}
+
+bool mitk::PropertyRegEx::Match(const std::string &str) const
+{
+  if (0 != str.compare(0, m_LiteralPrefix.size(), m_LiteralPrefix))
+  {
+    return false;
+  }
+
+  if (m_IsLiteral)
+  {
+    return str.size() == m_LiteralPrefix.size();
+  }
+
+  return std::regex_match(str, m_RegEx);
+}
+
+bool mitk::PropertyRegEx::Match(const std::string &str, std::smatch &matches) const
+{
+  if (0 != str.compare(0, m_LiteralPrefix.size(), m_LiteralPrefix) ||
+      (m_IsLiteral && str.size() != m_LiteralPrefix.size()))
+  {
+    matches = std::smatch();
+    return false;
+  }
+
+  return std::regex_match(str, matches, m_RegEx);
+}
+
+bool mitk::PropertyRegEx::Search(const std::string &str, std::smatch &matches) const
+{
+  const bool hasPrefix = m_IsAnchored ? 0 == str.compare(0, m_LiteralPrefix.size(), m_LiteralPrefix)
+                                      : std::string::npos != str.find(m_LiteralPrefix);
+  if (!hasPrefix)
+  {
+    matches = std::smatch();
+    return false;
+  }
+
+  return std::regex_search(str, matches, m_RegEx);
+}
@@ -15,11 +15,11 @@ found in the LICENSE file.
 #include <mitkDataNode.h>
 #include <mitkExceptionMacro.h>
 #include <mitkNodePredicateBase.h>
+#include <mitkPropertyRegEx.h>
 #include <mitkStringProperty.h>
 #include <mitkUIDGenerator.h>
 
 #include <mutex>
-#include <regex>
 #include <algorithm>
 
 bool mitk::PropertyRelationRuleBase::IsAbstract() const
@@ -107,8 +107,50 @@ std::vector<std::string> mitk::PropertyRelationRuleBase::GetPropertyKeys(const m
   }
   return keys;
 }
+
+std::vector<std::string> mitk::PropertyRelationRuleBase::GetPropertyKeys(const mitk::IPropertyProvider *owner, const std::string &prefix)
+{
+  const PropertyList* propertyList = dynamic_cast<const PropertyList*>(owner);
+  PropertyList::Pointer dataPropertyList;
+
+  auto sourceCasted = dynamic_cast<const mitk::DataNode*>(owner);
+  if (sourceCasted) {
+    auto sourceData = sourceCasted->GetData();
+    if (sourceData) {
+      dataPropertyList = sourceData->GetPropertyList();
+    }
+    else {
+      propertyList = sourceCasted->GetPropertyList();
+    }
+  }
+  else if (auto data = dynamic_cast<const mitk::BaseData*>(owner)) {
+    dataPropertyList = data->GetPropertyList();
+  }
+
+  if (dataPropertyList.IsNotNull()) {
+    propertyList = dataPropertyList;
+  }
+
+  if (nullptr != propertyList) {
+    return propertyList->GetPropertyKeysWithPrefix(prefix);
+  }
+
+  std::vector<std::string> keys;
+  for (auto& key : owner->GetPropertyKeys()) {
+    if (0 == key.compare(0, prefix.size(), prefix)) {
+      keys.push_back(std::move(key));
+    }
+  }
+  return keys;
+}
 //end workaround for T24729
 
+const std::string& mitk::PropertyRelationRuleBase::GetRIIPropertyKeyPrefix()
+{
+  static const std::string prefix = PropertyKeyPathToPropertyName(GetRootKeyPath()) + ".";
+  return prefix;
+}
+
 bool mitk::PropertyRelationRuleBase::IsSource(const IPropertyProvider *owner) const
 {
   return !this->GetExistingRelations(owner).empty();
@@ -222,15 +264,15 @@ mitk::PropertyRelationRuleBase::RelationUIDVectorType mitk::PropertyRelationRule
   if (layer != RelationType::Data)
   {
     auto ruleIDRegExStr = this->GetRIIPropertyRegEx("ruleID");
-    auto regEx = std::regex(ruleIDRegExStr);
+    auto regEx = PropertyRegEx::Get(ruleIDRegExStr);
 
     //workaround until T24729 is done. You can use directly source->GetPropertyKeys again, when fixed.
-    const auto keys = GetPropertyKeys(source);
+    const auto keys = GetPropertyKeys(source, GetRIIPropertyKeyPrefix());
     //end workaround for T24729
 
     for (const auto& key : keys)
     {
-      if (std::regex_match(key, regEx))
+      if (regEx->Match(key))
       {
         auto idProp = source->GetConstProperty(key);
         auto ruleID = idProp->GetValueAsString();
@@ -373,16 +415,16 @@ mitk::PropertyRelationRuleBase::InstanceIDType mitk::PropertyRelationRuleBase::G
 
   auto destRegExStr =
     PropertyKeyPathToPropertyRegEx(GetRIIRelationUIDPropertyKeyPath());
-  auto regEx = std::regex(destRegExStr);
+  auto regEx = PropertyRegEx::Get(destRegExStr);
   std::smatch instance_matches;
 
   //workaround until T24729 is done. You can use directly source->GetPropertyKeys again, when fixed.
-  const auto keys = GetPropertyKeys(source);
+  const auto keys = GetPropertyKeys(source, GetRIIPropertyKeyPrefix());
   //end workaround for T24729
 
   for (const auto &key : keys)
   {
-    if (std::regex_search(key, instance_matches, regEx))
+    if (regEx->Search(key, instance_matches))
     {
       auto idProp = source->GetConstProperty(key);
       if (idProp->GetValueAsString() == relationUID)
@@ -419,18 +461,18 @@ mitk::PropertyRelationRuleBase::InstanceIDVectorType mitk::PropertyRelationRuleB
   { // check for relations of type Connected_ID;
 
     auto destRegExStr = this->GetRIIPropertyRegEx("destinationUID");
-    auto regEx = std::regex(destRegExStr);
+    auto regEx = PropertyRegEx::Get(destRegExStr);
     std::smatch instance_matches;
 
     auto destUID = identifiable->GetUID();
 
     //workaround until T24729 is done. You can use directly source->GetPropertyKeys again, when fixed.
-    const auto keys = GetPropertyKeys(source);
+    const auto keys = GetPropertyKeys(source, GetRIIPropertyKeyPrefix());
     //end workaround for T24729
 
     for (const auto &key : keys)
     {
-      if (std::regex_search(key, instance_matches, regEx))
+      if (regEx->Search(key, instance_matches))
       {
         auto idProp = source->GetConstProperty(key);
         if (idProp->GetValueAsString() == destUID)
@@ -588,16 +630,12 @@ void mitk::PropertyRelationRuleBase::Disconnect(IPropertyOwner *source, Relation
     auto instancePrefix = PropertyKeyPathToPropertyName(GetRootKeyPath().AddElement(instanceID));
 
     //workaround until T24729 is done. You can use directly source->GetPropertyKeys again, when fixed.
-    const auto keys = GetPropertyKeys(source);
+    const auto keys = GetPropertyKeys(source, instancePrefix);
     //end workaround for T24729
 
-
     for (const auto &key : keys)
     {
-      if (key.find(instancePrefix) == 0)
-      {
-        source->RemoveProperty(key);
-      }
+      source->RemoveProperty(key);
     }
   }
 }
@@ -627,17 +665,17 @@ mitk::PropertyRelationRuleBase::InstanceIDType mitk::PropertyRelationRuleBase::C
 
   auto destRegExStr =
     PropertyKeyPathToPropertyRegEx(GetRIIRelationUIDPropertyKeyPath());
-  auto regEx = std::regex(destRegExStr);
+  auto regEx = PropertyRegEx::Get(destRegExStr);
   std::smatch instance_matches;
 
   //workaround until T24729 is done. You can use directly source->GetPropertyKeys again, when fixed.
-  const auto keys = GetPropertyKeys(source);
+  const auto keys = GetPropertyKeys(source, GetRIIPropertyKeyPrefix());
   //end workaround for T24729
 
 
   for (const auto &key : keys)
   {
-    if (std::regex_search(key, instance_matches, regEx))
+    if (regEx->Search(key, instance_matches))
     {
       if (instance_matches.size()>1)
       {
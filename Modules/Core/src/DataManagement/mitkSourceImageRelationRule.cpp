@@ -10,7 +10,6 @@ found in the LICENSE file.
 
 ============================================================================*/
 
-#include <regex>
 #include <mutex>
 
 #include "mitkSourceImageRelationRule.h"
@@ -19,6 +18,7 @@ found in the LICENSE file.
 #include "mitkTemporoSpatialStringProperty.h"
 #include "mitkDataNode.h"
 #include "mitkIdentifiable.h"
+#include "mitkPropertyRegEx.h"
 
 std::string mitk::SourceImageRelationRule::GenerateRuleID(const std::string& purpose) const
 {
@@ -102,10 +102,10 @@ mitk::SourceImageRelationRule::GetRelationUIDs_DataLayer(const IPropertyProvider
   auto relevantIndicesAndRuleIDs = GetReferenceSequenceIndices(source, destination, instances_IDLayer);
 
   auto itemRIIRegExStr = this->GetRIIPropertyRegEx("SourceImageSequenceItem");
-  auto regEx = std::regex(itemRIIRegExStr);
+  auto regEx = PropertyRegEx::Get(itemRIIRegExStr);
 
   //workaround until T24729 is done. Please remove if T24728 is done
-  auto keys = PropertyRelationRuleBase::GetPropertyKeys(source);
+  auto keys = PropertyRelationRuleBase::GetPropertyKeys(source, GetRIIPropertyKeyPrefix());
   //end workaround for T24729
 
   for (const auto &indexNRule : relevantIndicesAndRuleIDs)
@@ -113,7 +113,7 @@ mitk::SourceImageRelationRule::GetRelationUIDs_DataLayer(const IPropertyProvider
     bool relationCoveredByRII = false;
     for (const auto& key : keys)
     {
-      if (std::regex_match(key, regEx))
+      if (regEx->Match(key))
       {
         auto sequItemProp = source->GetConstProperty(key);
         if (sequItemProp.IsNotNull() && sequItemProp->GetValueAsString() == std::to_string(indexNRule.first))
@@ -191,16 +191,16 @@ std::vector<std::pair<size_t,std::string> > mitk::SourceImageRelationRule::GetRe
   referencedInstanceUIDs.AddElement("DICOM").AddElement("0008").AddAnySelection("2112").AddElement("0008").AddElement("1155");
 
   auto sourceRegExStr = PropertyKeyPathToPropertyRegEx(referencedInstanceUIDs);
-  auto regEx = std::regex(sourceRegExStr);
+  auto regEx = PropertyRegEx::Get(sourceRegExStr);
 
   std::vector<std::string> keys;
   //workaround until T24729 is done. Please remove if T24728 is done
-  keys = PropertyRelationRuleBase::GetPropertyKeys(source);
+  keys = PropertyRelationRuleBase::GetPropertyKeys(source, regEx->GetLiteralPrefix());
   //end workaround for T24729
 
   for (const auto &key : keys)
   {
-    if (std::regex_match(key, regEx))
+    if (regEx->Match(key))
     {
       auto refUIDProp = source->GetConstProperty(key);
       if (destination==nullptr || *refUIDProp == *destInstanceUIDProp)
@@ -254,16 +254,16 @@ mitk::PropertyKeyPath::ItemSelectionIndex mitk::SourceImageRelationRule::CreateN
   PropertyKeyPath referencedInstanceUIDs;
   referencedInstanceUIDs.AddElement("DICOM").AddElement("0008").AddAnySelection("2112").AddElement("0008").AddElement("1155");
   auto regExStr = PropertyKeyPathToPropertyRegEx(referencedInstanceUIDs);
-  auto regEx = std::regex(regExStr);
+  auto regEx = PropertyRegEx::Get(regExStr);
   std::smatch instance_matches;
 
   //workaround until T24729 is done. You can use directly source->GetPropertyKeys again, when fixed.
-  const auto keys = GetPropertyKeys(source);
+  const auto keys = GetPropertyKeys(source, regEx->GetLiteralPrefix());
   //end workaround for T24729
 
   for (const auto &key : keys)
   {
-    if (std::regex_search(key, instance_matches, regEx))
+    if (regEx->Search(key, instance_matches))
     {
       if (instance_matches.size()>1)
       {
@@ -372,7 +372,7 @@ void mitk::SourceImageRelationRule::Disconnect_datalayer(IPropertyOwner * source
         auto prefix = PropertyKeyPathToPropertyName(refDICOMDataPath);
 
         PropertyKeyPath refRelDataPath = GetRootKeyPath().AddAnyElement().AddElement("SourceImageSequenceItem");;
-        auto riiRegEx = std::regex(PropertyKeyPathToPropertyRegEx(refRelDataPath));
+        auto riiRegEx = PropertyRegEx::Get(PropertyKeyPathToPropertyRegEx(refRelDataPath));
 
         //workaround until T24729 is done. You can use directly source->GetPropertyKeys again, when fixed.
         const auto keys = GetPropertyKeys(source);
@@ -392,7 +392,7 @@ void mitk::SourceImageRelationRule::Disconnect_datalayer(IPropertyOwner * source
             //remove old/outdated data layer information
             source->RemoveProperty(key);
           }
-          if (std::regex_match(key, riiRegEx))
+          if (riiRegEx->Match(key))
           { //it is a relevant RII property, remove it or update it.
             auto imageSequenceItemProp = source->GetConstProperty(key);
             if (imageSequenceItemProp->GetValueAsString() == deletedImageRefSequenceIndexStr)
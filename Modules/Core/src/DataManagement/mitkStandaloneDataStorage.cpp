@@ -38,7 +38,7 @@ bool mitk::StandaloneDataStorage::IsInitialized() const
 void mitk::StandaloneDataStorage::Add(mitk::DataNode *node, const mitk::DataStorage::SetOfObjects *parents)
 {
   {
-    std::lock_guard<std::mutex> locked(m_Mutex);
+    std::unique_lock<std::shared_mutex> locked(m_Mutex);
     if (!IsInitialized())
       throw std::logic_error("DataStorage not initialized");
     /* check if node is in its own list of sources */
@@ -77,6 +77,8 @@ void mitk::StandaloneDataStorage::Add(mitk::DataNode *node, const mitk::DataStor
                           node); // node is derived from parent. Insert it into the parents list of derived objects
     }
 
+    m_AllNodes = nullptr;
+
     // register for ITK changed events
     this->AddListeners(node);
   }
@@ -106,16 +108,17 @@ void mitk::StandaloneDataStorage::Remove(const mitk::DataNode *node)
   /* Notify observers of imminent node removal */
   EmitRemoveNodeEvent(node);
   {
-    std::lock_guard<std::mutex> locked(m_Mutex);
+    std::unique_lock<std::shared_mutex> locked(m_Mutex);
     /* remove node from both relation adjacency lists */
     this->RemoveFromRelation(node, m_SourceNodes);
     this->RemoveFromRelation(node, m_DerivedNodes);
+    m_AllNodes = nullptr;
   }
 }
 
 bool mitk::StandaloneDataStorage::Exists(const mitk::DataNode *node) const
 {
-  std::lock_guard<std::mutex> locked(m_Mutex);
+  std::shared_lock<std::shared_mutex> locked(m_Mutex);
   return (m_SourceNodes.find(node) != m_SourceNodes.end());
 }
 
@@ -143,11 +146,21 @@ void mitk::StandaloneDataStorage::RemoveFromRelation(const mitk::DataNode *node,
 
 mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetAll() const
 {
-  std::lock_guard<std::mutex> locked(m_Mutex);
   if (!IsInitialized())
     throw std::logic_error("DataStorage not initialized");
 
+  {
+    std::shared_lock<std::shared_mutex> locked(m_Mutex);
+    if (m_AllNodes.IsNotNull())
+      return m_AllNodes;
+  }
+
+  std::unique_lock<std::shared_mutex> locked(m_Mutex);
+  if (m_AllNodes.IsNotNull())
+    return m_AllNodes;
+
   mitk::DataStorage::SetOfObjects::Pointer resultset = mitk::DataStorage::SetOfObjects::New();
+  resultset->CastToSTLContainer().reserve(m_SourceNodes.size());
   /* Fill resultset with all objects that are managed by the StandaloneDataStorage object */
   unsigned int index = 0;
   for (auto it = m_SourceNodes.cbegin(); it != m_SourceNodes.cend(); ++it)
@@ -156,7 +169,8 @@ mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetAl
     else
       resultset->InsertElement(index++, const_cast<mitk::DataNode *>(it->first.GetPointer()));
 
-  return SetOfObjects::ConstPointer(resultset);
+  m_AllNodes = resultset.GetPointer();
+  return m_AllNodes;
 }
 
 mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetRelations(
@@ -238,14 +252,14 @@ mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetRe
 mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetSources(
   const mitk::DataNode *node, const NodePredicateBase *condition, bool onlyDirectSources) const
 {
-  std::lock_guard<std::mutex> locked(m_Mutex);
+  std::shared_lock<std::shared_mutex> locked(m_Mutex);
   return this->GetRelations(node, m_SourceNodes, condition, onlyDirectSources);
 }
 
 mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetDerivations(
   const mitk::DataNode *node, const NodePredicateBase *condition, bool onlyDirectDerivations) const
 {
-  std::lock_guard<std::mutex> locked(m_Mutex);
+  std::shared_lock<std::shared_mutex> locked(m_Mutex);
   return this->GetRelations(node, m_DerivedNodes, condition, onlyDirectDerivations);
 }
 
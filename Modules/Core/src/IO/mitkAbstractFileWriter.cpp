@@ -16,6 +16,7 @@ found in the LICENSE file.
 #include <mitkCustomMimeType.h>
 #include <mitkExceptionMacro.h>
 #include <mitkIOUtil.h>
+#include <mitkImageDataAllocator.h>
 #include <mitkUtf8Util.h>
 
 #include <mitkFileReaderWriterBase.h>
@@ -41,6 +42,9 @@ namespace mitk
   AbstractFileWriter::LocalFile::LocalFile(IFileWriter *writer)
     : d(new Impl(writer->GetOutputLocation(), writer->GetOutputStream()))
   {
+    // images may still be mapped from the file that is going to be overwritten
+    if (d->m_Stream == nullptr)
+      MappedFileImageDataAllocator::DetachFromFile(d->m_Location);
   }
 
   AbstractFileWriter::LocalFile::~LocalFile()
@@ -79,6 +83,7 @@ namespace mitk
     }
     else
     {
+      MappedFileImageDataAllocator::DetachFromFile(writer->GetOutputLocation());
       m_Stream = new std::ofstream(writer->GetOutputLocation().c_str(), mode);
       this->init(m_Stream->rdbuf());
     }
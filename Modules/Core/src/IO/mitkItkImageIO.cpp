@@ -18,6 +18,7 @@ found in the LICENSE file.
 #include <mitkIOMimeTypes.h>
 #include <mitkIPropertyPersistence.h>
 #include <mitkImage.h>
+#include <mitkImageDataAllocator.h>
 #include <mitkImageReadAccessor.h>
 #include <mitkLocaleSwitch.h>
 #include <mitkUIDManipulator.h>
@@ -29,6 +30,11 @@ found in the LICENSE file.
 #include <itkMetaDataObject.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 
 namespace mitk
 {
@@ -38,6 +44,158 @@ namespace mitk
   const char *const PROPERTY_KEY_TIMEGEOMETRY_TIMEPOINTS = "org_mitk_timegeometry_timepoints";
   const char* const PROPERTY_KEY_UID = "org_mitk_uid";
 
+  namespace
+  {
+    std::atomic<bool> s_MemoryMappingEnabled(false);
+
+    bool IsLittleEndianHost()
+    {
+      const std::uint16_t one = 1;
+      return 1 == *reinterpret_cast<const unsigned char *>(&one);
+    }
+
+    /** Offset of the pixels of an attached, raw encoded NRRD file in host byte order.*/
+    bool GetRawNrrdDataOffset(const std::string &path, unsigned int componentSize, std::size_t &offset)
+    {
+      std::ifstream file(path, std::ios::binary);
+      std::string line;
+
+      if (!std::getline(file, line) || 0 != line.compare(0, 4, "NRRD"))
+        return false;
+
+      bool raw = false;
+      bool nativeEndian = 1 == componentSize;
+
+      while (std::getline(file, line))
+      {
+        if (!line.empty() && '\r' == line.back())
+          line.pop_back();
+
+        if (line.empty())
+        {
+          const auto position = file.tellg();
+          if (position < 0)
+            return false;
+
+          offset = static_cast<std::size_t>(position);
+          return raw && nativeEndian;
+        }
+
+        if ('#' == line[0])
+          continue;
+
+        const auto separator = line.find(": ");
+        if (std::string::npos == separator || (separator > 0 && ':' == line[separator - 1]))
+          continue; // key/value pairs ("key:=value") do not affect the data
+
+        std::string field = line.substr(0, separator);
+        std::string value = line.substr(separator + 2);
+        std::transform(field.begin(), field.end(), field.begin(), ::tolower);
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        field.erase(std::remove(field.begin(), field.end(), ' '), field.end());
+
+        if ("encoding" == field)
+        {
+          raw = "raw" == value;
+        }
+        else if ("endian" == field)
+        {
+          nativeEndian = nativeEndian || ("little" == value) == IsLittleEndianHost();
+        }
+        else if ("datafile" == field || "lineskip" == field || "byteskip" == field)
+        {
+          if ("datafile" == field || "0" != value)
+            return false;
+        }
+      }
+
+      return false;
+    }
+
+    template <typename T>
+    T ReadHeaderValue(const char *header, std::size_t position)
+    {
+      T value;
+      std::memcpy(&value, header + position, sizeof(T));
+      return value;
+    }
+
+    /** Offset of the pixels of an uncompressed single file NIfTI image in host byte order without scaling.*/
+    bool GetNiftiDataOffset(const std::string &path, std::size_t &offset)
+    {
+      std::ifstream file(path, std::ios::binary);
+      char header[540];
+
+      if (!file.read(header, 348))
+        return false;
+
+      const auto sizeOfHeader = ReadHeaderValue<std::int32_t>(header, 0);
+      double slope = 0.0;
+      double intercept = 0.0;
+
+      if (348 == sizeOfHeader)
+      {
+        if (0 != std::memcmp(header + 344, "n+1", 4))
+          return false;
+
+        const auto voxelOffset = ReadHeaderValue<float>(header, 108);
+        if (voxelOffset < 348.0f)
+          return false;
+
+        offset = static_cast<std::size_t>(voxelOffset);
+        slope = ReadHeaderValue<float>(header, 112);
+        intercept = ReadHeaderValue<float>(header, 116);
+      }
+      else if (540 == sizeOfHeader)
+      {
+        if (!file.read(header + 348, 540 - 348) || 0 != std::memcmp(header + 4, "n+2", 4))
+          return false;
+
+        const auto voxelOffset = ReadHeaderValue<std::int64_t>(header, 168);
+        if (voxelOffset < 540)
+          return false;
+
+        offset = static_cast<std::size_t>(voxelOffset);
+        slope = ReadHeaderValue<double>(header, 176);
+        intercept = ReadHeaderValue<double>(header, 184);
+      }
+      else
+      {
+        return false; // gzip compressed or foreign byte order
+      }
+
+      // ITK rescales the intensities for any other values
+      return 0.0 == slope || (1.0 == slope && 0.0 == intercept);
+    }
+
+    /** Offset of the pixels in the file, if it can be mapped instead of read by imageIO.*/
+    bool GetMappableDataOffset(const itk::ImageIOBase *imageIO, const std::string &path, std::size_t &offset)
+    {
+      if (1 != imageIO->GetNumberOfComponents() || imageIO->GetNumberOfDimensions() > 4)
+        return false;
+
+      const std::string imageIOName = imageIO->GetNameOfClass();
+
+      if ("NrrdImageIO" == imageIOName)
+        return GetRawNrrdDataOffset(path, imageIO->GetComponentSize(), offset);
+
+      if ("NiftiImageIO" == imageIOName)
+        return GetNiftiDataOffset(path, offset);
+
+      return false;
+    }
+  }
+
+  void ItkImageIO::SetMemoryMappingEnabled(bool enabled)
+  {
+    s_MemoryMappingEnabled = enabled;
+  }
+
+  bool ItkImageIO::GetMemoryMappingEnabled()
+  {
+    return s_MemoryMappingEnabled;
+  }
+
   ItkImageIO::ItkImageIO(const ItkImageIO &other)
     : AbstractFileIO(other), m_ImageIO(dynamic_cast<itk::ImageIOBase *>(other.m_ImageIO->Clone().GetPointer()))
   {
@@ -338,11 +496,35 @@ namespace mitk
 
     MITK_INFO << "ioRegion: " << ioRegion << std::endl;
     m_ImageIO->SetIORegion(ioRegion);
-    void *buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
-    m_ImageIO->Read(buffer);
-
     image->Initialize(MakePixelType(m_ImageIO), ndim, dimensions);
-    image->SetImportChannel(buffer, 0, Image::ManageMemory);
+
+    void *buffer = nullptr;
+    std::size_t dataOffset = 0;
+
+    if (GetMemoryMappingEnabled() && GetMappableDataOffset(m_ImageIO, path, dataOffset))
+    {
+      auto allocator = MappedFileImageDataAllocator::New();
+      allocator->SetFileName(path);
+      allocator->SetOffset(dataOffset);
+
+      try
+      {
+        buffer = allocator->Allocate(m_ImageIO->GetImageSizeInBytes());
+        image->SetImportChannel(buffer, 0, allocator);
+      }
+      catch (const itk::ExceptionObject &e)
+      {
+        MITK_WARN << "Could not map " << path << ", reading it instead: " << e.GetDescription();
+        buffer = nullptr;
+      }
+    }
+
+    if (nullptr == buffer)
+    {
+      buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
+      m_ImageIO->Read(buffer);
+      image->SetImportChannel(buffer, 0, Image::ManageMemory);
+    }
 
     const itk::MetaDataDictionary &dictionary = m_ImageIO->GetMetaDataDictionary();
 
@@ -15,8 +15,29 @@ found in the LICENSE file.
 #include "mitkLogMacros.h"
 
 #include <clocale>
+#include <mutex>
 #include <string>
 
+namespace
+{
+  /** setlocale() changes the locale of the whole process. Switches to the same locale that overlap in
+      time (e.g. of jobs running concurrently) are therefore shared: the first one installs the locale,
+      the last one restores the locale that was active before the first one.*/
+  struct SharedLocaleSwitch
+  {
+    std::mutex Mutex;
+    std::string Locale;
+    std::string OldLocale;
+    unsigned int Count = 0;
+  };
+
+  SharedLocaleSwitch &GetSharedLocaleSwitch()
+  {
+    static SharedLocaleSwitch sharedSwitch;
+    return sharedSwitch;
+  }
+}
+
 namespace mitk
 {
   struct LocaleSwitch::Impl
@@ -31,10 +52,24 @@ namespace mitk
 
     /// locale during life-time of object
     const std::string m_NewLocale;
+
+    /// indicates if the switch is shared with other switches to the same locale
+    bool m_IsShared;
   };
 
-  LocaleSwitch::Impl::Impl(const std::string &newLocale) : m_NewLocale(newLocale)
+  LocaleSwitch::Impl::Impl(const std::string &newLocale) : m_NewLocale(newLocale), m_IsShared(false)
   {
+    auto &sharedSwitch = GetSharedLocaleSwitch();
+    std::lock_guard<std::mutex> lock(sharedSwitch.Mutex);
+
+    if (0 != sharedSwitch.Count && sharedSwitch.Locale == m_NewLocale)
+    {
+      // the locale is already installed by an active switch
+      ++sharedSwitch.Count;
+      m_IsShared = true;
+      return;
+    }
+
     // query and keep the current locale
     const char *currentLocale = std::setlocale(LC_ALL, nullptr);
     if (currentLocale != nullptr)
@@ -49,12 +84,32 @@ namespace mitk
       {
         MITK_INFO << "Could not switch to locale " << m_NewLocale;
         m_OldLocale = "";
+        return;
       }
     }
+
+    if (0 == sharedSwitch.Count)
+    {
+      sharedSwitch.Locale = m_NewLocale;
+      sharedSwitch.OldLocale = m_OldLocale;
+      sharedSwitch.Count = 1;
+      m_IsShared = true;
+    }
   }
 
   LocaleSwitch::Impl::~Impl()
   {
+    auto &sharedSwitch = GetSharedLocaleSwitch();
+    std::lock_guard<std::mutex> lock(sharedSwitch.Mutex);
+
+    if (m_IsShared)
+    {
+      if (0 != --sharedSwitch.Count)
+        return;
+
+      m_OldLocale = sharedSwitch.OldLocale;
+    }
+
     if (!m_OldLocale.empty() && m_OldLocale != m_NewLocale && !std::setlocale(LC_ALL, m_OldLocale.c_str()))
     {
       MITK_INFO << "Could not reset original locale " << m_OldLocale;
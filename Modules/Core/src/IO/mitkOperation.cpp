@@ -24,3 +24,21 @@ mitk::OperationType mitk::Operation::GetOperationType()
 {
   return m_OperationType;
 }
+
+std::size_t mitk::Operation::GetMemoryFootprint() const
+{
+  return sizeof(Operation);
+}
+
+bool mitk::Operation::IsSwappable() const
+{
+  return false;
+}
+
+void mitk::Operation::SwapOut(std::ostream &)
+{
+}
+
+void mitk::Operation::SwapIn(std::istream &)
+{
+}
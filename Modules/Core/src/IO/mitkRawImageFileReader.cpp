@@ -13,9 +13,11 @@ found in the LICENSE file.
 #include "mitkRawImageFileReader.h"
 #include "mitkIOConstants.h"
 #include "mitkIOMimeTypes.h"
+#include "mitkImageDataAllocator.h"
 #include "mitkITKImageImport.h"
 #include "mitkImageCast.h"
 
+#include <itkByteSwapper.h>
 #include <itkImage.h>
 #include <itkImageFileReader.h>
 #include <itkRawImageIO.h>
@@ -55,6 +57,8 @@ mitk::RawImageFileReaderService::RawImageFileReaderService()
   defaultOptions[IOConstants::SIZE_Z()] = 0;
   // defaultOptions[IOConstants::SIZE_T()] = 0;
 
+  defaultOptions[IOConstants::MEMORY_MAPPING()] = false;
+
   this->SetDefaultOptions(defaultOptions);
 
   this->RegisterService();
@@ -84,25 +88,28 @@ std::vector<itk::SmartPointer<mitk::BaseData>> mitk::RawImageFileReaderService::
   dimensions[2] = us::any_cast<int>(options.find(IOConstants::SIZE_Z())->second);
   dimensions[3] = 0; // us::any_cast<int>(options.find(IOConstants::SIZE_T())->second);
 
+  const auto mappingOption = options.find(IOConstants::MEMORY_MAPPING());
+  const bool mapFile = mappingOption != options.end() && us::any_cast<bool>(mappingOption->second);
+
   // check file dimensionality and pixel type and perform reading according to it
   if (dimensionality == "2")
   {
     if (pixelType == IOConstants::PIXEL_TYPE_CHAR())
-      result.push_back(TypedRead<signed char, 2>(path, endianity, dimensions));
+      result.push_back(TypedRead<signed char, 2>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_UCHAR())
-      result.push_back(TypedRead<unsigned char, 2>(path, endianity, dimensions));
+      result.push_back(TypedRead<unsigned char, 2>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_SHORT())
-      result.push_back(TypedRead<signed short int, 2>(path, endianity, dimensions));
+      result.push_back(TypedRead<signed short int, 2>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_USHORT())
-      result.push_back(TypedRead<unsigned short int, 2>(path, endianity, dimensions));
+      result.push_back(TypedRead<unsigned short int, 2>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_UINT())
-      result.push_back(TypedRead<unsigned int, 2>(path, endianity, dimensions));
+      result.push_back(TypedRead<unsigned int, 2>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_INT())
-      result.push_back(TypedRead<signed int, 2>(path, endianity, dimensions));
+      result.push_back(TypedRead<signed int, 2>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_FLOAT())
-      result.push_back(TypedRead<float, 2>(path, endianity, dimensions));
+      result.push_back(TypedRead<float, 2>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_DOUBLE())
-      result.push_back(TypedRead<double, 2>(path, endianity, dimensions));
+      result.push_back(TypedRead<double, 2>(path, endianity, dimensions, mapFile));
     else
     {
       MITK_INFO << "Error while reading raw file: Dimensionality or pixel type not supported or not properly set"
@@ -112,21 +119,21 @@ std::vector<itk::SmartPointer<mitk::BaseData>> mitk::RawImageFileReaderService::
   else if (dimensionality == "3")
   {
     if (pixelType == IOConstants::PIXEL_TYPE_CHAR())
-      result.push_back(TypedRead<signed char, 3>(path, endianity, dimensions));
+      result.push_back(TypedRead<signed char, 3>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_UCHAR())
-      result.push_back(TypedRead<unsigned char, 3>(path, endianity, dimensions));
+      result.push_back(TypedRead<unsigned char, 3>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_SHORT())
-      result.push_back(TypedRead<signed short int, 3>(path, endianity, dimensions));
+      result.push_back(TypedRead<signed short int, 3>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_USHORT())
-      result.push_back(TypedRead<unsigned short int, 3>(path, endianity, dimensions));
+      result.push_back(TypedRead<unsigned short int, 3>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_UINT())
-      result.push_back(TypedRead<unsigned int, 3>(path, endianity, dimensions));
+      result.push_back(TypedRead<unsigned int, 3>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_INT())
-      result.push_back(TypedRead<signed int, 3>(path, endianity, dimensions));
+      result.push_back(TypedRead<signed int, 3>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_FLOAT())
-      result.push_back(TypedRead<float, 3>(path, endianity, dimensions));
+      result.push_back(TypedRead<float, 3>(path, endianity, dimensions, mapFile));
     else if (pixelType == IOConstants::PIXEL_TYPE_DOUBLE())
-      result.push_back(TypedRead<double, 3>(path, endianity, dimensions));
+      result.push_back(TypedRead<double, 3>(path, endianity, dimensions, mapFile));
     else
     {
       MITK_INFO << "Error while reading raw file: Dimensionality or pixel type not supported or not properly set"
@@ -144,7 +151,8 @@ std::vector<itk::SmartPointer<mitk::BaseData>> mitk::RawImageFileReaderService::
 template <typename TPixel, unsigned int VImageDimensions>
 mitk::BaseData::Pointer mitk::RawImageFileReaderService::TypedRead(const std::string &path,
                                                                    EndianityType endianity,
-                                                                   int *size)
+                                                                   int *size,
+                                                                   bool mapFile)
 {
   typedef itk::Image<TPixel, VImageDimensions> ImageType;
   typedef itk::ImageFileReader<ImageType> ReaderType;
@@ -176,6 +184,32 @@ mitk::BaseData::Pointer mitk::RawImageFileReaderService::TypedRead(const std::st
   reader->SetImageIO(io);
   reader->SetFileName(path);
 
+  const bool hostByteOrder =
+    1 == sizeof(TPixel) || (endianity == LITTLE) == (itk::ByteSwapper<TPixel>::SystemIsLittleEndian());
+
+  if (mapFile && hostByteOrder)
+  {
+    try
+    {
+      reader->UpdateOutputInformation();
+
+      // like itk::RawImageIO, the header is whatever precedes the pixels at the end of the file
+      io->SetFileName(path);
+      auto allocator = MappedFileImageDataAllocator::New();
+      allocator->SetFileName(path);
+      allocator->SetOffset(io->GetHeaderSize());
+
+      mitk::Image::Pointer image = mitk::Image::New();
+      image->InitializeByItk(reader->GetOutput());
+      image->SetImportChannel(allocator->Allocate(io->GetImageSizeInBytes()), 0, allocator);
+      return image.GetPointer();
+    }
+    catch (const itk::ExceptionObject &err)
+    {
+      MITK_WARN << "Could not map raw image file, reading it instead: " << err.GetDescription();
+    }
+  }
+
   try
   {
     reader->Update();
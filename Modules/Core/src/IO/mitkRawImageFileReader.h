@@ -20,6 +20,9 @@ namespace mitk
   /**
    * The user must set the dimensionality, the dimensions and the pixel type.
    * If they are incorrect, the image will not be opened or the visualization will be incorrect.
+   *
+   * With the option IOConstants::MEMORY_MAPPING(), the file is mapped into memory instead of read,
+   * if it is in host byte order (see MappedFileImageDataAllocator).
    */
   class RawImageFileReaderService : public AbstractFileReader
   {
@@ -41,7 +44,7 @@ namespace mitk
 
   private:
     template <typename TPixel, unsigned int VImageDimensions>
-    mitk::BaseData::Pointer TypedRead(const std::string &path, EndianityType endianity, int *size);
+    mitk::BaseData::Pointer TypedRead(const std::string &path, EndianityType endianity, int *size, bool mapFile);
 
     RawImageFileReaderService *Clone() const override;
   };
@@ -36,6 +36,7 @@ set(MODULE_TESTS
   mitkGeometryDataIOTest.cpp
   mitkGeometryDataToSurfaceFilterTest.cpp
   mitkImageCastTest.cpp
+  mitkImageDataAllocatorTest.cpp
   mitkImageDataItemTest.cpp
   mitkImageGeneratorTest.cpp
   mitkIOUtilTest.cpp
@@ -61,6 +62,7 @@ set(MODULE_TESTS
   mitkPropertyPersistenceInfoTest.cpp
   mitkPropertyRelationRuleBaseTest.cpp
   mitkPropertyRelationsTest.cpp
+  mitkPropertyRegExTest.cpp
   mitkSlicedGeometry3DTest.cpp
   mitkSliceNavigationControllerTest.cpp
   mitkSurfaceTest.cpp
@@ -71,6 +73,7 @@ set(MODULE_TESTS
   mitkUndoControllerTest.cpp
   mitkVtkWidgetRenderingTest.cpp
   mitkVerboseLimitedLinearUndoTest.cpp
+  mitkLimitedLinearUndoTest.cpp
   mitkWeakPointerTest.cpp
   mitkTransferFunctionTest.cpp
   mitkStepperTest.cpp
@@ -80,10 +83,12 @@ set(MODULE_TESTS
   mitkNodePredicateSourceTest.cpp
   mitkNodePredicateDataPropertyTest.cpp
   mitkNodePredicateFunctionTest.cpp
+  mitkDataStorageViewTest.cpp
   mitkVectorTest.cpp
   mitkClippedSurfaceBoundsCalculatorTest.cpp
   mitkExceptionTest.cpp
   mitkExtractSliceFilterTest.cpp
+  mitkExtractSliceFilter2Test.cpp
   mitkLogTest.cpp
   mitkImageDimensionConverterTest.cpp
   mitkLoggingAdapterTest.cpp
@@ -190,6 +195,13 @@ if(NOT WIN32)
  set(MODULE_CUSTOM_TESTS ${MODULE_CUSTOM_TESTS} mitkSurfaceDepthSortingTest.cpp)
 endif()
 
+# Benchmarks are built into the test driver, but not registered with ctest.
+# Run them explicitly, e.g. MitkCoreTestDriver mitkExtractSliceFilter2BenchmarkTest
+set(MODULE_CUSTOM_TESTS ${MODULE_CUSTOM_TESTS}
+    mitkExtractSliceFilter2BenchmarkTest.cpp
+    mitkPropertyRelationRuleBaseBenchmarkTest.cpp
+)
+
 set(RESOURCE_FILES
   Interactions/AddAndRemovePoints.xml
   Interactions/globalConfig.xml
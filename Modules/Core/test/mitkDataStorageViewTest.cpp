@@ -0,0 +1,388 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkBaseDataTestImplementation.h"
+#include "mitkDataStorageView.h"
+#include "mitkNodePredicateAnd.h"
+#include "mitkNodePredicateDataType.h"
+#include "mitkNodePredicateFirstLevel.h"
+#include "mitkNodePredicateNot.h"
+#include "mitkNodePredicateProperty.h"
+#include "mitkPointSet.h"
+#include "mitkProperties.h"
+#include "mitkStandaloneDataStorage.h"
+#include "mitkStringProperty.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class mitkDataStorageViewTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDataStorageViewTestSuite);
+  MITK_TEST(GetSubsetByName_EqualsGetSubset);
+  MITK_TEST(GetSubsetByDataType_EqualsGetSubset);
+  MITK_TEST(GetSubsetByProperty_EqualsGetSubset);
+  MITK_TEST(View_FollowsAddAndRemove);
+  MITK_TEST(View_FollowsPropertyModifications);
+  MITK_TEST(View_FollowsSetData);
+  MITK_TEST(View_DependingOnRelations);
+  MITK_TEST(View_OutlivesDataStorage);
+  MITK_TEST(GetAll_ReturnsSnapshot);
+  MITK_TEST(ConcurrentQueries);
+  MITK_TEST(View_EqualsGetSubsetOnLargeStorage);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  struct AddNodeListener
+  {
+    AddNodeListener(const mitk::DataStorageView *view) : m_View(view), m_ContainedOnAddNodeEvent(false) {}
+
+    void OnNodeAdded(const mitk::DataNode *node) { m_ContainedOnAddNodeEvent = m_View->Contains(node); }
+
+    const mitk::DataStorageView *m_View;
+    bool m_ContainedOnAddNodeEvent;
+  };
+
+  mitk::StandaloneDataStorage::Pointer m_DataStorage;
+
+  static mitk::DataNode::Pointer CreateNode(const std::string &name, mitk::BaseData *data, bool binary)
+  {
+    auto node = mitk::DataNode::New();
+    node->SetName(name);
+    node->SetData(data);
+    node->SetBoolProperty("binary", binary);
+    return node;
+  }
+
+  /** Compares the nodes of both sets including their order.*/
+  static bool AreEqual(const mitk::DataStorage::SetOfObjects *expected, const mitk::DataStorage::SetOfObjects *actual)
+  {
+    if (expected->Size() != actual->Size())
+      return false;
+
+    return std::equal(expected->begin(), expected->end(), actual->begin());
+  }
+
+  void AssertViewIsUpToDate(const mitk::DataStorageView *view)
+  {
+    auto expected = m_DataStorage->GetSubset(view->GetPredicate());
+    CPPUNIT_ASSERT(AreEqual(expected, view->GetNodes()));
+    CPPUNIT_ASSERT_EQUAL(expected->Size(), view->GetSize());
+
+    for (auto iter = expected->Begin(); iter != expected->End(); ++iter)
+      CPPUNIT_ASSERT(view->Contains(iter->Value()));
+  }
+
+public:
+  void setUp() override
+  {
+    m_DataStorage = mitk::StandaloneDataStorage::New();
+
+    for (int i = 0; i < 20; ++i)
+    {
+      mitk::BaseData::Pointer data;
+      if (i % 3 == 0)
+        data = mitk::PointSet::New();
+      else if (i % 3 == 1)
+        data = mitk::BaseDataTestImplementation::New();
+
+      m_DataStorage->Add(CreateNode("node" + std::to_string(i % 7), data, i % 2 == 0));
+    }
+  }
+
+  void tearDown() override { m_DataStorage = nullptr; }
+
+  void GetSubsetByName_EqualsGetSubset()
+  {
+    for (int i = 0; i < 8; ++i)
+    {
+      const std::string name = "node" + std::to_string(i);
+      auto predicate = mitk::NodePredicateProperty::New("name", mitk::StringProperty::New(name));
+
+      auto expected = m_DataStorage->GetSubset(predicate);
+      CPPUNIT_ASSERT(AreEqual(expected, m_DataStorage->GetSubsetByName(name)));
+
+      auto namedNode = m_DataStorage->GetNamedNode(name);
+      CPPUNIT_ASSERT(expected->empty() ? nullptr == namedNode : expected->GetElement(0) == namedNode);
+    }
+
+    // renaming by setting the value of the existing property
+    auto node = m_DataStorage->GetNamedNode("node3");
+    dynamic_cast<mitk::StringProperty *>(node->GetProperty("name"))->SetValue("renamed");
+    CPPUNIT_ASSERT(m_DataStorage->GetNamedNode("renamed") == node);
+    auto node3 = m_DataStorage->GetSubsetByName("node3");
+    CPPUNIT_ASSERT(std::find(node3->begin(), node3->end(), node) == node3->end());
+
+    // renaming by replacing the property
+    node->SetName("renamed again");
+    CPPUNIT_ASSERT(m_DataStorage->GetNamedNode("renamed again") == node);
+    CPPUNIT_ASSERT(m_DataStorage->GetSubsetByName("renamed")->empty());
+
+    m_DataStorage->Remove(node);
+    CPPUNIT_ASSERT(nullptr == m_DataStorage->GetNamedNode("renamed again"));
+  }
+
+  void GetSubsetByDataType_EqualsGetSubset()
+  {
+    for (const std::string type : {"PointSet", "BaseDataTestImplementation", "Image"})
+    {
+      auto predicate = mitk::NodePredicateDataType::New(type.c_str());
+      CPPUNIT_ASSERT(AreEqual(m_DataStorage->GetSubset(predicate), m_DataStorage->GetSubsetByDataType(type)));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(7u, m_DataStorage->GetSubsetByDataType("PointSet")->Size());
+  }
+
+  void GetSubsetByProperty_EqualsGetSubset()
+  {
+    auto binary = mitk::NodePredicateProperty::New("binary", mitk::BoolProperty::New(true));
+    CPPUNIT_ASSERT(AreEqual(m_DataStorage->GetSubset(binary),
+                            m_DataStorage->GetSubsetByProperty("binary", mitk::BoolProperty::New(true))));
+
+    auto hasBinary = mitk::NodePredicateProperty::New("binary");
+    CPPUNIT_ASSERT(AreEqual(m_DataStorage->GetSubset(hasBinary), m_DataStorage->GetSubsetByProperty("binary")));
+
+    // equal value strings of different property types must not match
+    CPPUNIT_ASSERT(m_DataStorage->GetSubsetByProperty("binary", mitk::StringProperty::New("1"))->empty());
+
+    // the index of "binary" is maintained after the first query
+    auto node = m_DataStorage->GetAll()->GetElement(0);
+    bool isBinary = false;
+    node->GetBoolProperty("binary", isBinary);
+    dynamic_cast<mitk::BoolProperty *>(node->GetProperty("binary"))->SetValue(!isBinary);
+    CPPUNIT_ASSERT(AreEqual(m_DataStorage->GetSubset(binary),
+                            m_DataStorage->GetSubsetByProperty("binary", mitk::BoolProperty::New(true))));
+
+    node->SetProperty("binary", mitk::StringProperty::New("no bool"));
+    CPPUNIT_ASSERT(AreEqual(m_DataStorage->GetSubset(binary),
+                            m_DataStorage->GetSubsetByProperty("binary", mitk::BoolProperty::New(true))));
+    CPPUNIT_ASSERT(AreEqual(m_DataStorage->GetSubset(hasBinary), m_DataStorage->GetSubsetByProperty("binary")));
+
+    CPPUNIT_ASSERT_THROW(m_DataStorage->GetSubsetByProperty(""), std::invalid_argument);
+  }
+
+  void View_FollowsAddAndRemove()
+  {
+    auto view = mitk::DataStorageView::New(m_DataStorage, mitk::NodePredicateDataType::New("PointSet"));
+    this->AssertViewIsUpToDate(view);
+
+    auto allNodes = mitk::DataStorageView::New(m_DataStorage, nullptr);
+    this->AssertViewIsUpToDate(allNodes);
+
+    // the view is updated before AddNodeEvent is emitted
+    auto node = CreateNode("added", mitk::PointSet::New(), false);
+    AddNodeListener listener(view);
+    m_DataStorage->AddNodeEvent.AddListener(
+      mitk::MessageDelegate1<AddNodeListener, const mitk::DataNode *>(&listener, &AddNodeListener::OnNodeAdded));
+    m_DataStorage->Add(node);
+    m_DataStorage->AddNodeEvent.RemoveListener(
+      mitk::MessageDelegate1<AddNodeListener, const mitk::DataNode *>(&listener, &AddNodeListener::OnNodeAdded));
+
+    CPPUNIT_ASSERT(listener.m_ContainedOnAddNodeEvent);
+    this->AssertViewIsUpToDate(view);
+    this->AssertViewIsUpToDate(allNodes);
+
+    m_DataStorage->Remove(node);
+    CPPUNIT_ASSERT(!view->Contains(node));
+    this->AssertViewIsUpToDate(view);
+    this->AssertViewIsUpToDate(allNodes);
+
+    m_DataStorage->Remove(m_DataStorage->GetSubsetByDataType("PointSet"));
+    CPPUNIT_ASSERT_EQUAL(0u, view->GetSize());
+    this->AssertViewIsUpToDate(allNodes);
+  }
+
+  void View_FollowsPropertyModifications()
+  {
+    auto predicate = mitk::NodePredicateAnd::New(
+      mitk::NodePredicateProperty::New("binary", mitk::BoolProperty::New(false)),
+      mitk::NodePredicateNot::New(mitk::NodePredicateProperty::New("name", mitk::StringProperty::New("node0"))));
+
+    auto view = mitk::DataStorageView::New(m_DataStorage, predicate);
+    this->AssertViewIsUpToDate(view);
+
+    auto modifiedTime = view->GetMTime();
+    auto node = m_DataStorage->GetSubset(predicate)->GetElement(0);
+
+    // modifying the property directly does not modify the node
+    dynamic_cast<mitk::BoolProperty *>(node->GetProperty("binary"))->SetValue(true);
+    CPPUNIT_ASSERT(!view->Contains(node));
+    CPPUNIT_ASSERT(view->GetMTime() > modifiedTime);
+    this->AssertViewIsUpToDate(view);
+
+    node->SetBoolProperty("binary", false);
+    CPPUNIT_ASSERT(view->Contains(node));
+    this->AssertViewIsUpToDate(view);
+
+    node->SetName("node0");
+    CPPUNIT_ASSERT(!view->Contains(node));
+    this->AssertViewIsUpToDate(view);
+
+    // the property is replaced by a property of another type
+    node->SetName("node1");
+    node->SetProperty("binary", mitk::IntProperty::New(0));
+    CPPUNIT_ASSERT(!view->Contains(node));
+    this->AssertViewIsUpToDate(view);
+
+    // the old property must not be observed anymore
+    node->SetBoolProperty("binary", false);
+    CPPUNIT_ASSERT(view->Contains(node));
+    this->AssertViewIsUpToDate(view);
+
+    // modifications are noticed even if ChangedNodeEvent is blocked
+    m_DataStorage->BlockNodeModifiedEvents(true);
+    node->GetPropertyList()->DeleteProperty("binary");
+    m_DataStorage->BlockNodeModifiedEvents(false);
+    CPPUNIT_ASSERT(!view->Contains(node));
+    this->AssertViewIsUpToDate(view);
+  }
+
+  void View_FollowsSetData()
+  {
+    auto view = mitk::DataStorageView::New(m_DataStorage, mitk::NodePredicateDataType::New("PointSet"));
+
+    auto node = m_DataStorage->GetSubsetByDataType("BaseDataTestImplementation")->GetElement(0);
+    CPPUNIT_ASSERT(!view->Contains(node));
+
+    node->SetData(mitk::PointSet::New());
+    CPPUNIT_ASSERT(view->Contains(node));
+    CPPUNIT_ASSERT(AreEqual(m_DataStorage->GetSubset(mitk::NodePredicateDataType::New("PointSet")),
+                            m_DataStorage->GetSubsetByDataType("PointSet")));
+    this->AssertViewIsUpToDate(view);
+
+    node->SetData(nullptr);
+    CPPUNIT_ASSERT(!view->Contains(node));
+    this->AssertViewIsUpToDate(view);
+  }
+
+  void View_DependingOnRelations()
+  {
+    auto view = mitk::DataStorageView::New(m_DataStorage, mitk::NodePredicateFirstLevel::New(m_DataStorage));
+    CPPUNIT_ASSERT_EQUAL(m_DataStorage->GetAll()->Size(), view->GetSize());
+
+    auto parent = m_DataStorage->GetNamedNode("node1");
+    auto child = CreateNode("child", nullptr, false);
+    m_DataStorage->Add(child, parent);
+
+    CPPUNIT_ASSERT(!view->Contains(child));
+    this->AssertViewIsUpToDate(view);
+
+    m_DataStorage->Remove(parent);
+    this->AssertViewIsUpToDate(view);
+  }
+
+  void View_OutlivesDataStorage()
+  {
+    auto view = mitk::DataStorageView::New(m_DataStorage, mitk::NodePredicateDataType::New("PointSet"));
+    CPPUNIT_ASSERT(view->GetSize() > 0);
+
+    m_DataStorage = nullptr;
+    CPPUNIT_ASSERT_EQUAL(0u, view->GetSize());
+    CPPUNIT_ASSERT(view->GetNodes()->empty());
+
+    CPPUNIT_ASSERT_THROW(mitk::DataStorageView::New(nullptr, nullptr), std::invalid_argument);
+  }
+
+  void GetAll_ReturnsSnapshot()
+  {
+    auto all = m_DataStorage->GetAll();
+    CPPUNIT_ASSERT(all == m_DataStorage->GetAll());
+
+    const auto size = all->Size();
+    m_DataStorage->Add(CreateNode("added", nullptr, false));
+
+    CPPUNIT_ASSERT_EQUAL(size, all->Size());
+    CPPUNIT_ASSERT_EQUAL(size + 1, m_DataStorage->GetAll()->Size());
+
+    // removing all nodes of a GetAll() result must not invalidate it
+    m_DataStorage->Remove(m_DataStorage->GetAll());
+    CPPUNIT_ASSERT(m_DataStorage->GetAll()->empty());
+  }
+
+  void ConcurrentQueries()
+  {
+    auto predicate = mitk::NodePredicateProperty::New("binary", mitk::BoolProperty::New(false));
+    auto view = mitk::DataStorageView::New(m_DataStorage, predicate);
+
+    std::atomic<bool> stop(false);
+    std::atomic<unsigned int> failures(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+      readers.emplace_back([&]() {
+        while (!stop)
+        {
+          // each snapshot has to be consistent in itself
+          auto nodes = view->GetNodes();
+          for (auto iter = nodes->Begin(); iter != nodes->End(); ++iter)
+          {
+            if (iter->Value().IsNull())
+              ++failures;
+          }
+
+          auto temporaryNodes = m_DataStorage->GetSubsetByName("temporary");
+          for (auto iter = temporaryNodes->Begin(); iter != temporaryNodes->End(); ++iter)
+          {
+            if (iter->Value()->GetName() != "temporary")
+              ++failures;
+          }
+        }
+      });
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+      auto node = CreateNode("temporary", nullptr, i % 2 == 0);
+      m_DataStorage->Add(node);
+      node->SetBoolProperty("binary", i % 2 != 0);
+      m_DataStorage->Remove(node);
+    }
+
+    stop = true;
+    for (auto &reader : readers)
+      reader.join();
+
+    CPPUNIT_ASSERT_EQUAL(0u, failures.load());
+    this->AssertViewIsUpToDate(view);
+  }
+
+  void View_EqualsGetSubsetOnLargeStorage()
+  {
+    const int numberOfNodes = 5000;
+
+    auto dataStorage = mitk::StandaloneDataStorage::New();
+    for (int i = 0; i < numberOfNodes; ++i)
+    {
+      mitk::BaseData::Pointer data;
+      if (i % 10 == 0)
+        data = mitk::PointSet::New();
+
+      dataStorage->Add(CreateNode("node" + std::to_string(i), data, i % 2 == 0));
+    }
+
+    auto predicate = mitk::NodePredicateAnd::New(mitk::NodePredicateDataType::New("PointSet"),
+                                                 mitk::NodePredicateProperty::New("binary", mitk::BoolProperty::New(false)));
+
+    auto view = mitk::DataStorageView::New(dataStorage, predicate);
+
+    CPPUNIT_ASSERT(AreEqual(dataStorage->GetSubset(predicate), view->GetNodes()));
+    CPPUNIT_ASSERT(dataStorage->GetNode(mitk::NodePredicateProperty::New("name", mitk::StringProperty::New("node4711"))) ==
+                   dataStorage->GetNamedNode("node4711"));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDataStorageView)
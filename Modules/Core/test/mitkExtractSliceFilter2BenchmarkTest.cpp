@@ -0,0 +1,167 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Benchmark, not part of the ctest set. Run it explicitly:
+//   MitkCoreTestDriver mitkExtractSliceFilter2BenchmarkTest
+
+#include <mitkExtractSliceFilter2.h>
+#include <mitkImageCast.h>
+#include <mitkImageGenerator.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkNearestNeighborInterpolateImageFunction.h>
+
+#include <chrono>
+#include <limits>
+
+class mitkExtractSliceFilter2BenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkExtractSliceFilter2BenchmarkTestSuite);
+  MITK_TEST(Benchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<short, 3> ItkImageType;
+
+  mitk::Image::Pointer m_Image;
+  ItkImageType::Pointer m_ItkImage;
+
+  mitk::PlaneGeometry::Pointer CreatePlane(const mitk::Vector3D& right, const mitk::Vector3D& down, const mitk::Point3D& origin, unsigned int width, unsigned int height)
+  {
+    mitk::Vector3D spacing;
+    spacing.Fill(1.0);
+
+    auto plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(width, height, right, down, &spacing);
+    plane->SetOrigin(origin);
+    plane->SetImageGeometry(true);
+
+    return plane;
+  }
+
+  /** \brief The per-pixel ITK interpolation ExtractSliceFilter2 is compared with
+   * (see mitkExtractSliceFilter2Test).
+   */
+  std::vector<short> ComputeReference(const mitk::PlaneGeometry* plane, mitk::ExtractSliceFilter2::Interpolator interpolator)
+  {
+    typedef itk::InterpolateImageFunction<ItkImageType> InterpolateImageFunctionType;
+    InterpolateImageFunctionType::Pointer interpolateImageFunction;
+
+    if (mitk::ExtractSliceFilter2::NearestNeighbor == interpolator)
+    {
+      interpolateImageFunction = itk::NearestNeighborInterpolateImageFunction<ItkImageType>::New().GetPointer();
+    }
+    else
+    {
+      interpolateImageFunction = itk::LinearInterpolateImageFunction<ItkImageType>::New().GetPointer();
+    }
+
+    interpolateImageFunction->SetInputImage(m_ItkImage);
+
+    auto origin = plane->GetOrigin();
+    auto spacing = plane->GetSpacing();
+    auto xDirection = plane->GetAxisVector(0);
+    auto yDirection = plane->GetAxisVector(1);
+
+    xDirection.Normalize();
+    yDirection.Normalize();
+
+    const auto width = static_cast<unsigned int>(plane->GetExtent(0));
+    const auto height = static_cast<unsigned int>(plane->GetExtent(1));
+
+    std::vector<short> result(width * height);
+    itk::ContinuousIndex<mitk::ScalarType, 3> index;
+
+    for (unsigned int y = 0; y < height; ++y)
+    {
+      for (unsigned int x = 0; x < width; ++x)
+      {
+        mitk::Point3D point = origin + yDirection * (spacing[1] * y) + xDirection * (spacing[0] * x);
+
+        result[width * y + x] = m_ItkImage->TransformPhysicalPointToContinuousIndex(point, index)
+          ? static_cast<short>(interpolateImageFunction->EvaluateAtContinuousIndex(index))
+          : std::numeric_limits<short>::lowest();
+      }
+    }
+
+    return result;
+  }
+
+  mitk::Image::Pointer Extract(const mitk::PlaneGeometry* plane, mitk::ExtractSliceFilter2::Interpolator interpolator)
+  {
+    auto filter = mitk::ExtractSliceFilter2::New();
+    filter->SetInput(m_Image);
+    filter->SetOutputGeometry(plane->Clone());
+    filter->SetInterpolator(interpolator);
+    filter->Update();
+
+    return filter->GetOutput();
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<short>(256, 256, 128, 1, 1.0, 1.0, 1.0, 1000.0, -1000.0);
+    mitk::CastToItkImage(m_Image, m_ItkImage);
+  }
+
+  void tearDown() override
+  {
+    m_ItkImage = nullptr;
+    m_Image = nullptr;
+  }
+
+  void Benchmark()
+  {
+    mitk::Vector3D right; right[0] = 1.0; right[1] = 0.3; right[2] = 0.1;
+    mitk::Vector3D down; down[0] = -0.2; down[1] = 1.0; down[2] = 0.4;
+    mitk::Point3D origin; origin[0] = 0.0; origin[1] = 0.0; origin[2] = 20.0;
+
+    auto obliquePlane = this->CreatePlane(right, down, origin, 256, 256);
+
+    right[1] = 0.0; right[2] = 0.0;
+    down[0] = 0.0; down[2] = 0.0;
+    origin[2] = 64.0;
+
+    auto axialPlane = this->CreatePlane(right, down, origin, 256, 256);
+
+    const int numberOfRepetitions = 10;
+
+    for (auto interpolator : { mitk::ExtractSliceFilter2::NearestNeighbor, mitk::ExtractSliceFilter2::Linear })
+    {
+      for (auto plane : { axialPlane.GetPointer(), obliquePlane.GetPointer() })
+      {
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < numberOfRepetitions; ++i)
+          this->ComputeReference(plane, interpolator);
+
+        auto referenceTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / numberOfRepetitions;
+
+        start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < numberOfRepetitions; ++i)
+          this->Extract(plane, interpolator);
+
+        auto filterTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / numberOfRepetitions;
+
+        MITK_INFO << (plane == axialPlane.GetPointer() ? "Axial" : "Oblique") << " plane, "
+                  << (mitk::ExtractSliceFilter2::NearestNeighbor == interpolator ? "nearest neighbor" : "linear")
+                  << " interpolation: per-pixel ITK interpolator " << referenceTime << " ms, ExtractSliceFilter2 " << filterTime << " ms";
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkExtractSliceFilter2Benchmark)
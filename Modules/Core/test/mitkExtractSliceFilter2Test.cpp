@@ -0,0 +1,231 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkExtractSliceFilter2.h>
+#include <mitkImageCast.h>
+#include <mitkImageGenerator.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkNearestNeighborInterpolateImageFunction.h>
+
+#include <cmath>
+#include <limits>
+
+class mitkExtractSliceFilter2TestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkExtractSliceFilter2TestSuite);
+  MITK_TEST(AxialNearestNeighbor_MatchesReference);
+  MITK_TEST(AxialLinear_MatchesReference);
+  MITK_TEST(SagittalNearestNeighbor_MatchesReference);
+  MITK_TEST(ObliqueNearestNeighbor_MatchesReference);
+  MITK_TEST(ObliqueLinear_MatchesReference);
+  MITK_TEST(ObliqueCubic_MatchesReference);
+  MITK_TEST(PartiallyOutside_MatchesReference);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<short, 3> ItkImageType;
+
+  mitk::Image::Pointer m_Image;
+  ItkImageType::Pointer m_ItkImage;
+
+  mitk::PlaneGeometry::Pointer CreatePlane(const mitk::Vector3D& right, const mitk::Vector3D& down, const mitk::Point3D& origin, unsigned int width, unsigned int height)
+  {
+    mitk::Vector3D spacing;
+    spacing.Fill(1.0);
+
+    auto plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(width, height, right, down, &spacing);
+    plane->SetOrigin(origin);
+    plane->SetImageGeometry(true);
+
+    return plane;
+  }
+
+  mitk::PlaneGeometry::Pointer CreateObliquePlane()
+  {
+    mitk::Vector3D right;
+    right[0] = 1.0; right[1] = 0.4; right[2] = 0.2;
+    mitk::Vector3D down;
+    down[0] = -0.3; down[1] = 1.0; down[2] = 0.5;
+
+    mitk::Point3D origin;
+    origin[0] = 3.3; origin[1] = 2.7; origin[2] = 5.1;
+
+    return this->CreatePlane(right, down, origin, 60, 60);
+  }
+
+  /** \brief Reference implementation: evaluate an ITK interpolator at every
+   * output pixel after transforming its physical position into the input
+   * index space.
+   */
+  std::vector<short> ComputeReference(const mitk::PlaneGeometry* plane, mitk::ExtractSliceFilter2::Interpolator interpolator)
+  {
+    typedef itk::InterpolateImageFunction<ItkImageType> InterpolateImageFunctionType;
+    InterpolateImageFunctionType::Pointer interpolateImageFunction;
+
+    switch (interpolator)
+    {
+      case mitk::ExtractSliceFilter2::NearestNeighbor:
+        interpolateImageFunction = itk::NearestNeighborInterpolateImageFunction<ItkImageType>::New().GetPointer();
+        break;
+
+      case mitk::ExtractSliceFilter2::Linear:
+        interpolateImageFunction = itk::LinearInterpolateImageFunction<ItkImageType>::New().GetPointer();
+        break;
+
+      case mitk::ExtractSliceFilter2::Cubic:
+      {
+        auto bSplineInterpolateImageFunction = itk::BSplineInterpolateImageFunction<ItkImageType>::New();
+        bSplineInterpolateImageFunction->SetSplineOrder(2);
+        interpolateImageFunction = bSplineInterpolateImageFunction.GetPointer();
+        break;
+      }
+    }
+
+    interpolateImageFunction->SetInputImage(m_ItkImage);
+
+    auto origin = plane->GetOrigin();
+    auto spacing = plane->GetSpacing();
+    auto xDirection = plane->GetAxisVector(0);
+    auto yDirection = plane->GetAxisVector(1);
+
+    xDirection.Normalize();
+    yDirection.Normalize();
+
+    const auto width = static_cast<unsigned int>(plane->GetExtent(0));
+    const auto height = static_cast<unsigned int>(plane->GetExtent(1));
+
+    std::vector<short> result(width * height);
+    itk::ContinuousIndex<mitk::ScalarType, 3> index;
+
+    for (unsigned int y = 0; y < height; ++y)
+    {
+      for (unsigned int x = 0; x < width; ++x)
+      {
+        mitk::Point3D point = origin + yDirection * (spacing[1] * y) + xDirection * (spacing[0] * x);
+
+        result[width * y + x] = m_ItkImage->TransformPhysicalPointToContinuousIndex(point, index)
+          ? static_cast<short>(interpolateImageFunction->EvaluateAtContinuousIndex(index))
+          : std::numeric_limits<short>::lowest();
+      }
+    }
+
+    return result;
+  }
+
+  mitk::Image::Pointer Extract(const mitk::PlaneGeometry* plane, mitk::ExtractSliceFilter2::Interpolator interpolator)
+  {
+    auto filter = mitk::ExtractSliceFilter2::New();
+    filter->SetInput(m_Image);
+    filter->SetOutputGeometry(plane->Clone());
+    filter->SetInterpolator(interpolator);
+    filter->Update();
+
+    return filter->GetOutput();
+  }
+
+  void CompareWithReference(const mitk::PlaneGeometry* plane, mitk::ExtractSliceFilter2::Interpolator interpolator, int tolerance)
+  {
+    auto reference = this->ComputeReference(plane, interpolator);
+    auto slice = this->Extract(plane, interpolator);
+
+    mitk::ImageReadAccessor readAccess(slice);
+    auto data = static_cast<const short*>(readAccess.GetData());
+
+    std::size_t numberOfMismatches = 0;
+
+    for (std::size_t i = 0; i < reference.size(); ++i)
+    {
+      if (std::abs(static_cast<int>(reference[i]) - static_cast<int>(data[i])) > tolerance)
+        ++numberOfMismatches;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), numberOfMismatches);
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<short>(64, 48, 32, 1, 1.0, 1.0, 1.0, 1000.0, -1000.0);
+    mitk::CastToItkImage(m_Image, m_ItkImage);
+  }
+
+  void tearDown() override
+  {
+    m_ItkImage = nullptr;
+    m_Image = nullptr;
+  }
+
+  void AxialNearestNeighbor_MatchesReference()
+  {
+    mitk::Vector3D right; right[0] = 1.0; right[1] = 0.0; right[2] = 0.0;
+    mitk::Vector3D down; down[0] = 0.0; down[1] = 1.0; down[2] = 0.0;
+    mitk::Point3D origin; origin[0] = 0.0; origin[1] = 0.0; origin[2] = 12.2;
+
+    this->CompareWithReference(this->CreatePlane(right, down, origin, 64, 48), mitk::ExtractSliceFilter2::NearestNeighbor, 0);
+  }
+
+  void AxialLinear_MatchesReference()
+  {
+    mitk::Vector3D right; right[0] = 1.0; right[1] = 0.0; right[2] = 0.0;
+    mitk::Vector3D down; down[0] = 0.0; down[1] = 1.0; down[2] = 0.0;
+    mitk::Point3D origin; origin[0] = 0.0; origin[1] = 0.0; origin[2] = 7.0;
+
+    this->CompareWithReference(this->CreatePlane(right, down, origin, 64, 48), mitk::ExtractSliceFilter2::Linear, 0);
+  }
+
+  void SagittalNearestNeighbor_MatchesReference()
+  {
+    mitk::Vector3D right; right[0] = 0.0; right[1] = 1.0; right[2] = 0.0;
+    mitk::Vector3D down; down[0] = 0.0; down[1] = 0.0; down[2] = -1.0;
+    mitk::Point3D origin; origin[0] = 20.0; origin[1] = 0.0; origin[2] = 31.0;
+
+    this->CompareWithReference(this->CreatePlane(right, down, origin, 48, 32), mitk::ExtractSliceFilter2::NearestNeighbor, 0);
+  }
+
+  void ObliqueNearestNeighbor_MatchesReference()
+  {
+    this->CompareWithReference(this->CreateObliquePlane(), mitk::ExtractSliceFilter2::NearestNeighbor, 0);
+  }
+
+  void ObliqueLinear_MatchesReference()
+  {
+    // Rounding differences of the index computation may flip the truncation
+    // of interpolated values to the integer pixel type.
+    this->CompareWithReference(this->CreateObliquePlane(), mitk::ExtractSliceFilter2::Linear, 1);
+  }
+
+  void ObliqueCubic_MatchesReference()
+  {
+    this->CompareWithReference(this->CreateObliquePlane(), mitk::ExtractSliceFilter2::Cubic, 1);
+  }
+
+  void PartiallyOutside_MatchesReference()
+  {
+    mitk::Vector3D right; right[0] = 1.0; right[1] = 0.0; right[2] = 0.0;
+    mitk::Vector3D down; down[0] = 0.0; down[1] = 1.0; down[2] = 0.0;
+    mitk::Point3D origin; origin[0] = -10.0; origin[1] = -5.0; origin[2] = 3.0;
+
+    auto plane = this->CreatePlane(right, down, origin, 100, 70);
+
+    this->CompareWithReference(plane, mitk::ExtractSliceFilter2::NearestNeighbor, 0);
+    this->CompareWithReference(plane, mitk::ExtractSliceFilter2::Linear, 0);
+    this->CompareWithReference(this->CreateObliquePlane(), mitk::ExtractSliceFilter2::Linear, 1);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkExtractSliceFilter2)
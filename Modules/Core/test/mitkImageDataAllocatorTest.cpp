@@ -0,0 +1,455 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkIOConstants.h"
+#include "mitkIOUtil.h"
+#include "mitkImage.h"
+#include "mitkImageDataAllocator.h"
+#include "mitkImagePixelReadAccessor.h"
+#include "mitkItkImageIO.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+class mitkImageDataAllocatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageDataAllocatorTestSuite);
+  MITK_TEST(HeapAllocator_ProvidesWritableMemory);
+  MITK_TEST(AlignedAllocator_AlignsMemory);
+  MITK_TEST(AlignedAllocator_RejectsInvalidAlignment);
+  MITK_TEST(HugePageAllocator_AlignsMemory);
+  MITK_TEST(FileBackedAllocator_ProvidesWritableMemory);
+  MITK_TEST(MappedFileAllocator_IsCopyOnWrite);
+  MITK_TEST(MappedFileAllocator_RejectsTooSmallFile);
+  MITK_TEST(Image_UsesDataAllocator);
+  MITK_TEST(Image_CopyUsesDataAllocator);
+  MITK_TEST(LoadNrrd_Mapped_EqualsRead);
+  MITK_TEST(LoadNrrd_ForeignByteOrder_IsRead);
+  MITK_TEST(LoadNifti_Mapped_EqualsRead);
+  MITK_TEST(LoadRaw_Mapped_EqualsRead);
+  MITK_TEST(MappedFileAllocator_DetachFromFile_KeepsMemory);
+  MITK_TEST(SaveNrrd_ToMappedFile_KeepsImage);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::vector<std::string> m_FileNames;
+
+  static bool IsLittleEndianHost()
+  {
+    const std::uint16_t one = 1;
+    return 1 == *reinterpret_cast<const unsigned char *>(&one);
+  }
+
+  static std::vector<short> CreatePixels(unsigned int numberOfPixels)
+  {
+    std::vector<short> pixels(numberOfPixels);
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+      pixels[i] = static_cast<short>(i % 30011 - 15000);
+    return pixels;
+  }
+
+  static void SwapBytes(std::vector<short> &pixels)
+  {
+    for (auto &pixel : pixels)
+    {
+      const auto value = static_cast<std::uint16_t>(pixel);
+      pixel = static_cast<short>(static_cast<std::uint16_t>((value << 8) | (value >> 8)));
+    }
+  }
+
+  std::string CreateTemporaryFileName(const std::string &templateName)
+  {
+    m_FileNames.push_back(mitk::IOUtil::CreateTemporaryFile(templateName));
+    return m_FileNames.back();
+  }
+
+  /** Writes an attached, raw encoded NRRD file of signed shorts.*/
+  std::string WriteNrrd(const unsigned int *size, std::vector<short> pixels, bool littleEndian)
+  {
+    const std::string fileName = this->CreateTemporaryFileName("mapped-XXXXXX.nrrd");
+
+    if (littleEndian != IsLittleEndianHost())
+      SwapBytes(pixels);
+
+    std::ofstream file(fileName, std::ios::binary);
+    file << "NRRD0004\n"
+         << "# Complete NRRD file format specification at:\n"
+         << "# http://teem.sourceforge.net/nrrd/format.html\n"
+         << "type: short\n"
+         << "dimension: 3\n"
+         << "space: left-posterior-superior\n"
+         << "sizes: " << size[0] << " " << size[1] << " " << size[2] << "\n"
+         << "space directions: (0.5,0,0) (0,0.5,0) (0,0,2)\n"
+         << "kinds: domain domain domain\n"
+         << "endian: " << (littleEndian ? "little" : "big") << "\n"
+         << "encoding: raw\n"
+         << "space origin: (1,2,3)\n"
+         << "modality:=test\n"
+         << "\n";
+    file.write(reinterpret_cast<const char *>(pixels.data()), pixels.size() * sizeof(short));
+
+    return fileName;
+  }
+
+  /** Writes an uncompressed single file NIfTI-1 image of signed shorts in host byte order.*/
+  std::string WriteNifti(const unsigned int *size, const std::vector<short> &pixels)
+  {
+    const std::string fileName = this->CreateTemporaryFileName("mapped-XXXXXX.nii");
+
+    char header[352];
+    std::memset(header, 0, sizeof(header));
+
+    auto write = [&header](std::size_t position, auto value) {
+      std::memcpy(header + position, &value, sizeof(value));
+    };
+
+    write(0, std::int32_t(348));
+    write(40, std::int16_t(3));
+    write(42, std::int16_t(size[0]));
+    write(44, std::int16_t(size[1]));
+    write(46, std::int16_t(size[2]));
+    write(48, std::int16_t(1));
+    write(70, std::int16_t(4)); // DT_INT16
+    write(72, std::int16_t(16));
+    write(76, 1.0f);
+    write(80, 0.5f);
+    write(84, 0.5f);
+    write(88, 2.0f);
+    write(108, 352.0f);
+    write(112, 1.0f);
+    write(123, char(10)); // NIFTI_UNITS_MM
+    std::memcpy(header + 344, "n+1", 4);
+
+    std::ofstream file(fileName, std::ios::binary);
+    file.write(header, sizeof(header));
+    file.write(reinterpret_cast<const char *>(pixels.data()), pixels.size() * sizeof(short));
+
+    return fileName;
+  }
+
+  static bool IsMapped(const mitk::Image *image)
+  {
+    auto allocator = image->GetChannelData()->GetAllocator();
+    return nullptr != dynamic_cast<const mitk::MappedFileImageDataAllocator *>(allocator);
+  }
+
+  static void AssertPixelsEqual(const std::vector<short> &expected,
+                                const mitk::Image *image,
+                                const std::string &message)
+  {
+    mitk::ImagePixelReadAccessor<short, 3> accessor(image);
+    const bool equal = 0 == std::memcmp(expected.data(), accessor.GetData(), expected.size() * sizeof(short));
+    CPPUNIT_ASSERT_MESSAGE(message, equal);
+  }
+
+  mitk::Image::Pointer LoadImage(const std::string &fileName, bool map)
+  {
+    mitk::ItkImageIO::SetMemoryMappingEnabled(map);
+    auto image = mitk::IOUtil::Load<mitk::Image>(fileName);
+    mitk::ItkImageIO::SetMemoryMappingEnabled(false);
+    return image;
+  }
+
+  void AssertAllocatorProvidesWritableMemory(mitk::ImageDataAllocator *allocator, std::size_t numberOfBytes)
+  {
+    auto data = static_cast<unsigned char *>(allocator->Allocate(numberOfBytes));
+    CPPUNIT_ASSERT(nullptr != data);
+
+    for (std::size_t i = 0; i < numberOfBytes; ++i)
+      data[i] = static_cast<unsigned char>(i * 7);
+
+    bool equal = true;
+    for (std::size_t i = 0; i < numberOfBytes; ++i)
+      equal = equal && data[i] == static_cast<unsigned char>(i * 7);
+
+    allocator->Deallocate(data, numberOfBytes);
+    CPPUNIT_ASSERT_MESSAGE("Memory keeps written values", equal);
+  }
+
+public:
+  void tearDown() override
+  {
+    mitk::ItkImageIO::SetMemoryMappingEnabled(false);
+
+    for (const auto &fileName : m_FileNames)
+      std::remove(fileName.c_str());
+
+    m_FileNames.clear();
+  }
+
+  void HeapAllocator_ProvidesWritableMemory()
+  {
+    this->AssertAllocatorProvidesWritableMemory(mitk::HeapImageDataAllocator::New(), 100000);
+  }
+
+  void AlignedAllocator_AlignsMemory()
+  {
+    auto allocator = mitk::AlignedImageDataAllocator::New();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(64), allocator->GetAlignment());
+
+    for (std::size_t alignment : {std::size_t(16), std::size_t(64), std::size_t(4096)})
+    {
+      allocator->SetAlignment(alignment);
+
+      std::vector<void *> blocks;
+      for (std::size_t numberOfBytes : {std::size_t(1), std::size_t(1000), std::size_t(123457)})
+      {
+        blocks.push_back(allocator->Allocate(numberOfBytes));
+        const auto address = reinterpret_cast<std::uintptr_t>(blocks.back());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), static_cast<std::size_t>(address % alignment));
+      }
+
+      for (auto block : blocks)
+        allocator->Deallocate(block, 0);
+    }
+
+    this->AssertAllocatorProvidesWritableMemory(allocator, 100000);
+  }
+
+  void AlignedAllocator_RejectsInvalidAlignment()
+  {
+    auto allocator = mitk::AlignedImageDataAllocator::New();
+    CPPUNIT_ASSERT_THROW(allocator->SetAlignment(48), itk::ExceptionObject);
+    CPPUNIT_ASSERT_THROW(allocator->SetAlignment(1), itk::ExceptionObject);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(64), allocator->GetAlignment());
+  }
+
+  void HugePageAllocator_AlignsMemory()
+  {
+    auto allocator = mitk::HugePageImageDataAllocator::New();
+    const std::size_t numberOfBytes = 3 * mitk::HugePageImageDataAllocator::HugePageSize + 17;
+
+    void *data = allocator->Allocate(numberOfBytes);
+#ifndef _MSC_VER
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0),
+                         static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(data) %
+                                                     mitk::HugePageImageDataAllocator::HugePageSize));
+#endif
+    allocator->Deallocate(data, numberOfBytes);
+
+    this->AssertAllocatorProvidesWritableMemory(allocator, numberOfBytes);
+  }
+
+  void FileBackedAllocator_ProvidesWritableMemory()
+  {
+    auto allocator = mitk::FileBackedImageDataAllocator::New();
+    CPPUNIT_ASSERT_EQUAL(std::string(), std::string(allocator->GetDirectory()));
+    this->AssertAllocatorProvidesWritableMemory(allocator, 5 * 1024 * 1024 + 3);
+
+    allocator->SetDirectory(mitk::IOUtil::GetTempPath());
+    this->AssertAllocatorProvidesWritableMemory(allocator, 1000);
+  }
+
+  void MappedFileAllocator_IsCopyOnWrite()
+  {
+    const unsigned int size[] = {20, 30, 40};
+    const auto pixels = CreatePixels(size[0] * size[1] * size[2]);
+    const std::string fileName = this->WriteNrrd(size, pixels, IsLittleEndianHost());
+
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    const std::size_t fileSize = static_cast<std::size_t>(file.tellg());
+    const std::size_t numberOfBytes = pixels.size() * sizeof(short);
+    file.close();
+
+    auto allocator = mitk::MappedFileImageDataAllocator::New();
+    allocator->SetFileName(fileName);
+    allocator->SetOffset(fileSize - numberOfBytes);
+
+    auto data = static_cast<short *>(allocator->Allocate(numberOfBytes));
+    CPPUNIT_ASSERT_MESSAGE("Mapped memory shows the file", 0 == std::memcmp(pixels.data(), data, numberOfBytes));
+
+    std::fill(data, data + pixels.size(), short(0));
+    CPPUNIT_ASSERT_EQUAL(short(0), data[pixels.size() - 1]);
+    allocator->Deallocate(data, numberOfBytes);
+
+    data = static_cast<short *>(allocator->Allocate(numberOfBytes));
+    CPPUNIT_ASSERT_MESSAGE("Modifications do not reach the file", 0 == std::memcmp(pixels.data(), data, numberOfBytes));
+    allocator->Deallocate(data, numberOfBytes);
+  }
+
+  void MappedFileAllocator_RejectsTooSmallFile()
+  {
+    const unsigned int size[] = {10, 10, 10};
+    const std::string fileName = this->WriteNrrd(size, CreatePixels(1000), IsLittleEndianHost());
+
+    auto allocator = mitk::MappedFileImageDataAllocator::New();
+    CPPUNIT_ASSERT_THROW(allocator->Allocate(100), itk::MemoryAllocationError);
+
+    allocator->SetFileName(fileName);
+    allocator->SetOffset(100);
+    CPPUNIT_ASSERT_THROW(allocator->Allocate(1000000), itk::MemoryAllocationError);
+  }
+
+  void Image_UsesDataAllocator()
+  {
+    auto allocator = mitk::AlignedImageDataAllocator::New();
+    allocator->SetAlignment(4096);
+
+    const unsigned int dimensions[] = {33, 17, 5, 3};
+    auto image = mitk::Image::New();
+    image->SetDataAllocator(allocator);
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 4, dimensions);
+
+    CPPUNIT_ASSERT(allocator.GetPointer() == image->GetDataAllocator());
+    CPPUNIT_ASSERT(allocator.GetPointer() == image->GetChannelData()->GetAllocator());
+    const auto address = reinterpret_cast<std::uintptr_t>(image->GetData());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), static_cast<std::size_t>(address % 4096));
+
+    auto image2 = mitk::Image::New();
+    image2->Initialize(mitk::MakeScalarPixelType<float>(), 4, dimensions);
+    auto defaultAllocator = image2->GetChannelData()->GetAllocator();
+    CPPUNIT_ASSERT(nullptr != dynamic_cast<const mitk::HeapImageDataAllocator *>(defaultAllocator));
+  }
+
+  void Image_CopyUsesDataAllocator()
+  {
+    auto allocator = mitk::FileBackedImageDataAllocator::New();
+
+    const unsigned int size[] = {20, 30, 40};
+    const auto pixels = CreatePixels(size[0] * size[1] * size[2]);
+
+    auto image = mitk::Image::New();
+    image->SetDataAllocator(allocator);
+    image->Initialize(mitk::MakeScalarPixelType<short>(), 3, size);
+    image->SetImportVolume(pixels.data(), 0);
+
+    auto clone = image->Clone();
+    CPPUNIT_ASSERT(allocator.GetPointer() == clone->GetDataAllocator());
+    AssertPixelsEqual(pixels, clone, "Clone equals image");
+  }
+
+  void LoadNrrd_Mapped_EqualsRead()
+  {
+    const unsigned int size[] = {31, 23, 17};
+    const auto pixels = CreatePixels(size[0] * size[1] * size[2]);
+    const std::string fileName = this->WriteNrrd(size, pixels, IsLittleEndianHost());
+
+    auto readImage = this->LoadImage(fileName, false);
+    auto mappedImage = this->LoadImage(fileName, true);
+
+    CPPUNIT_ASSERT(!IsMapped(readImage));
+    CPPUNIT_ASSERT(IsMapped(mappedImage));
+    MITK_ASSERT_EQUAL(readImage, mappedImage, "Mapped image equals read image");
+    AssertPixelsEqual(pixels, mappedImage, "Mapped image has the pixels of the file");
+  }
+
+  void LoadNrrd_ForeignByteOrder_IsRead()
+  {
+    const unsigned int size[] = {31, 23, 17};
+    const auto pixels = CreatePixels(size[0] * size[1] * size[2]);
+    const std::string fileName = this->WriteNrrd(size, pixels, !IsLittleEndianHost());
+
+    auto image = this->LoadImage(fileName, true);
+
+    CPPUNIT_ASSERT(!IsMapped(image));
+    AssertPixelsEqual(pixels, image, "Bytes are swapped");
+  }
+
+  void LoadNifti_Mapped_EqualsRead()
+  {
+    const unsigned int size[] = {31, 23, 17};
+    const auto pixels = CreatePixels(size[0] * size[1] * size[2]);
+    const std::string fileName = this->WriteNifti(size, pixels);
+
+    auto readImage = this->LoadImage(fileName, false);
+    auto mappedImage = this->LoadImage(fileName, true);
+
+    CPPUNIT_ASSERT(!IsMapped(readImage));
+    CPPUNIT_ASSERT(IsMapped(mappedImage));
+    MITK_ASSERT_EQUAL(readImage, mappedImage, "Mapped image equals read image");
+    AssertPixelsEqual(pixels, mappedImage, "Mapped image has the pixels of the file");
+  }
+
+  void LoadRaw_Mapped_EqualsRead()
+  {
+    const unsigned int size[] = {31, 23, 17};
+    const auto pixels = CreatePixels(size[0] * size[1] * size[2]);
+    const std::string fileName = this->CreateTemporaryFileName("mapped-XXXXXX.raw");
+
+    {
+      std::ofstream file(fileName, std::ios::binary);
+      file.write("header", 6);
+      file.write(reinterpret_cast<const char *>(pixels.data()), pixels.size() * sizeof(short));
+    }
+
+    mitk::IFileReader::Options options;
+    options[mitk::IOConstants::PIXEL_TYPE()] = mitk::IOConstants::PIXEL_TYPE_SHORT();
+    options[mitk::IOConstants::DIMENSION()] = std::string("3");
+    options[mitk::IOConstants::ENDIANNESS()] =
+      IsLittleEndianHost() ? mitk::IOConstants::ENDIANNESS_LITTLE() : mitk::IOConstants::ENDIANNESS_BIG();
+    options[mitk::IOConstants::SIZE_X()] = static_cast<int>(size[0]);
+    options[mitk::IOConstants::SIZE_Y()] = static_cast<int>(size[1]);
+    options[mitk::IOConstants::SIZE_Z()] = static_cast<int>(size[2]);
+
+    options[mitk::IOConstants::MEMORY_MAPPING()] = false;
+    auto readImage = mitk::IOUtil::Load<mitk::Image>(fileName, options);
+
+    options[mitk::IOConstants::MEMORY_MAPPING()] = true;
+    auto mappedImage = mitk::IOUtil::Load<mitk::Image>(fileName, options);
+
+    CPPUNIT_ASSERT(!IsMapped(readImage));
+    CPPUNIT_ASSERT(IsMapped(mappedImage));
+    MITK_ASSERT_EQUAL(readImage, mappedImage, "Mapped image equals read image");
+    AssertPixelsEqual(pixels, mappedImage, "Mapped image has the pixels of the file");
+  }
+
+  void MappedFileAllocator_DetachFromFile_KeepsMemory()
+  {
+    const unsigned int size[] = {64, 64, 32};
+    const auto pixels = CreatePixels(size[0] * size[1] * size[2]);
+    const std::string fileName = this->WriteNrrd(size, pixels, IsLittleEndianHost());
+    const std::size_t numberOfBytes = pixels.size() * sizeof(short);
+
+    auto allocator = mitk::MappedFileImageDataAllocator::New();
+    allocator->SetFileName(fileName);
+    allocator->SetOffset(0);
+
+    auto data = static_cast<char *>(allocator->Allocate(numberOfBytes));
+    const std::vector<char> expected(data, data + numberOfBytes);
+    data[0] = 42;
+
+    mitk::MappedFileImageDataAllocator::DetachFromFile(fileName);
+
+    {
+      std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+      file.write("overwritten", 11);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(char(42), data[0]);
+    CPPUNIT_ASSERT_MESSAGE("Detached memory keeps the contents of the file",
+                           0 == std::memcmp(expected.data() + 1, data + 1, numberOfBytes - 1));
+
+    allocator->Deallocate(data, numberOfBytes);
+  }
+
+  void SaveNrrd_ToMappedFile_KeepsImage()
+  {
+    const unsigned int size[] = {64, 64, 32};
+    const auto pixels = CreatePixels(size[0] * size[1] * size[2]);
+    const std::string fileName = this->WriteNrrd(size, pixels, IsLittleEndianHost());
+
+    auto mappedImage = this->LoadImage(fileName, true);
+    CPPUNIT_ASSERT(IsMapped(mappedImage));
+
+    mitk::IOUtil::Save(mappedImage, fileName);
+
+    AssertPixelsEqual(pixels, mappedImage, "Image keeps its pixels when its file is overwritten");
+    AssertPixelsEqual(pixels, this->LoadImage(fileName, false), "Saved file has the pixels of the image");
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageDataAllocator)
@@ -0,0 +1,225 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include "mitkInteractionConst.h"
+#include "mitkLimitedLinearUndo.h"
+#include "mitkOperationActor.h"
+#include "mitkOperationEvent.h"
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace
+{
+  /** Operation with a payload of a given size that can be swapped out. */
+  class PayloadOperation : public mitk::Operation
+  {
+  public:
+    PayloadOperation(std::size_t size, char value) : Operation(mitk::OpTEST), m_Payload(size, value) {}
+
+    std::size_t GetMemoryFootprint() const override { return sizeof(PayloadOperation) + m_Payload.capacity(); }
+
+    bool IsSwappable() const override { return true; }
+
+    void SwapOut(std::ostream &stream) override
+    {
+      const auto size = m_Payload.size();
+      stream.write(reinterpret_cast<const char *>(&size), sizeof(size));
+      stream.write(m_Payload.data(), size);
+      std::vector<char>().swap(m_Payload);
+    }
+
+    void SwapIn(std::istream &stream) override
+    {
+      std::size_t size = 0;
+      stream.read(reinterpret_cast<char *>(&size), sizeof(size));
+      m_Payload.resize(size);
+      stream.read(m_Payload.data(), size);
+    }
+
+    const std::vector<char> &GetPayload() const { return m_Payload; }
+
+  private:
+    std::vector<char> m_Payload;
+  };
+
+  /** Records the payloads of the executed operations. */
+  class RecordingActor : public mitk::OperationActor
+  {
+  public:
+    void ExecuteOperation(mitk::Operation *operation) override
+    {
+      auto payloadOperation = dynamic_cast<PayloadOperation *>(operation);
+
+      if (nullptr != payloadOperation)
+        m_ExecutedPayloads.push_back(payloadOperation->GetPayload());
+    }
+
+    std::vector<std::vector<char>> m_ExecutedPayloads;
+  };
+}
+
+class mitkLimitedLinearUndoTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLimitedLinearUndoTestSuite);
+
+  MITK_TEST(GetUndoMemoryUsage_SumsItemFootprints);
+  MITK_TEST(SetUndoMemoryLimit_SwapsOutOldestItems);
+  MITK_TEST(Undo_SwapsInItems);
+  MITK_TEST(Clear_RemovesSwappedItems);
+  MITK_TEST(SetUndoLimit_DropsOldestItems);
+  MITK_TEST(SharedOperation_IsCountedAndSwappedOnce);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static constexpr std::size_t PayloadSize = 1024 * 1024;
+  static constexpr int NumberOfItems = 8;
+
+  mitk::LimitedLinearUndo::Pointer m_Undo;
+  RecordingActor m_Actor;
+
+  void AddItems()
+  {
+    for (int i = 0; i < NumberOfItems; ++i)
+    {
+      auto doOp = new PayloadOperation(PayloadSize, static_cast<char>(i));
+      auto undoOp = new PayloadOperation(PayloadSize, static_cast<char>(-i));
+      m_Undo->SetOperationEvent(new mitk::OperationEvent(&m_Actor, doOp, undoOp, "Test"));
+      mitk::OperationEvent::IncCurrObjectEventId();
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Undo = mitk::LimitedLinearUndo::New();
+    m_Actor.m_ExecutedPayloads.clear();
+  }
+
+  void tearDown() override
+  {
+    m_Undo = nullptr;
+  }
+
+  void GetUndoMemoryUsage_SumsItemFootprints()
+  {
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Undo->GetUndoMemoryUsage());
+
+    this->AddItems();
+
+    CPPUNIT_ASSERT(m_Undo->GetUndoMemoryUsage() >= 2 * NumberOfItems * PayloadSize);
+    CPPUNIT_ASSERT(m_Undo->GetUndoMemoryUsage() < 2 * NumberOfItems * (PayloadSize + 1024));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Undo->GetNumberOfSwappedItems());
+  }
+
+  void SetUndoMemoryLimit_SwapsOutOldestItems()
+  {
+    this->AddItems();
+
+    const std::size_t limit = 5 * PayloadSize;
+    m_Undo->SetUndoMemoryLimit(limit);
+
+    CPPUNIT_ASSERT_EQUAL(limit, m_Undo->GetUndoMemoryLimit());
+    CPPUNIT_ASSERT(m_Undo->GetUndoMemoryUsage() <= limit);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(NumberOfItems - 2), m_Undo->GetNumberOfSwappedItems());
+    CPPUNIT_ASSERT(m_Undo->GetSwappedUndoMemory() >= (NumberOfItems - 2) * 2 * PayloadSize);
+
+    // new items keep the usage within the limit
+    this->AddItems();
+
+    CPPUNIT_ASSERT(m_Undo->GetUndoMemoryUsage() <= limit);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2 * NumberOfItems - 2), m_Undo->GetNumberOfSwappedItems());
+  }
+
+  void Undo_SwapsInItems()
+  {
+    this->AddItems();
+    m_Undo->SetUndoMemoryLimit(3 * PayloadSize);
+
+    for (int i = NumberOfItems - 1; i >= 0; --i)
+    {
+      m_Undo->Undo();
+
+      CPPUNIT_ASSERT(std::vector<char>(PayloadSize, static_cast<char>(-i)) == m_Actor.m_ExecutedPayloads.back());
+      CPPUNIT_ASSERT(m_Undo->GetUndoMemoryUsage() <= 3 * PayloadSize);
+    }
+
+    for (int i = 0; i < NumberOfItems; ++i)
+    {
+      m_Undo->Redo();
+
+      CPPUNIT_ASSERT(std::vector<char>(PayloadSize, static_cast<char>(i)) == m_Actor.m_ExecutedPayloads.back());
+    }
+
+    m_Undo->SetUndoMemoryLimit(0);
+    CPPUNIT_ASSERT(m_Undo->GetNumberOfSwappedItems() > 0);
+  }
+
+  void Clear_RemovesSwappedItems()
+  {
+    this->AddItems();
+    m_Undo->SetUndoMemoryLimit(PayloadSize);
+
+    CPPUNIT_ASSERT(m_Undo->GetNumberOfSwappedItems() > 0);
+
+    m_Undo->Clear();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Undo->GetNumberOfSwappedItems());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Undo->GetSwappedUndoMemory());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Undo->GetUndoMemoryUsage());
+  }
+
+  void SetUndoLimit_DropsOldestItems()
+  {
+    this->AddItems();
+    m_Undo->SetUndoMemoryLimit(PayloadSize);
+    m_Undo->SetUndoLimit(2);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), m_Undo->GetNumberOfSwappedItems());
+
+    m_Undo->Undo();
+    m_Undo->Undo();
+
+    CPPUNIT_ASSERT(std::vector<char>(PayloadSize, static_cast<char>(-(NumberOfItems - 2))) == m_Actor.m_ExecutedPayloads.back());
+    CPPUNIT_ASSERT(!m_Undo->Undo());
+  }
+
+  void SharedOperation_IsCountedAndSwappedOnce()
+  {
+    for (int i = 0; i < NumberOfItems; ++i)
+    {
+      auto operation = new PayloadOperation(PayloadSize, static_cast<char>(i));
+      m_Undo->SetOperationEvent(new mitk::OperationEvent(&m_Actor, operation, operation, "Test"));
+      mitk::OperationEvent::IncCurrObjectEventId();
+    }
+
+    CPPUNIT_ASSERT(m_Undo->GetUndoMemoryUsage() < NumberOfItems * (PayloadSize + 1024));
+
+    m_Undo->SetUndoMemoryLimit(3 * PayloadSize);
+
+    CPPUNIT_ASSERT(m_Undo->GetSwappedUndoMemory() < (NumberOfItems - 1) * (PayloadSize + 1024));
+
+    for (int i = NumberOfItems - 1; i >= 0; --i)
+    {
+      m_Undo->Undo();
+
+      CPPUNIT_ASSERT(std::vector<char>(PayloadSize, static_cast<char>(i)) == m_Actor.m_ExecutedPayloads.back());
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLimitedLinearUndo)
@@ -283,6 +283,34 @@ int mitkPropertyListTest(int /*argc*/, char * /*argv*/ [])
     return EXIT_FAILURE;
   }
 
+  std::cout << "Testing GetPropertyKeysWithPrefix(): ";
+  {
+    mitk::PropertyList::Pointer prefixList = mitk::PropertyList::New();
+    prefixList->SetProperty("MITK.Relations.1.ruleID", boolProp);
+    prefixList->SetProperty("MITK.Relations.2.ruleID", boolProp);
+    prefixList->SetProperty("MITK.RelationsX", boolProp);
+    prefixList->SetProperty("MITK.Other", boolProp);
+    prefixList->SetProperty("name", boolProp);
+
+    auto keys = prefixList->GetPropertyKeysWithPrefix("MITK.Relations.");
+    std::vector<std::string> expectedKeys = {"MITK.Relations.1.ruleID", "MITK.Relations.2.ruleID"};
+    if (keys != expectedKeys || prefixList->GetPropertyKeysWithPrefix("").size() != 5 ||
+        !prefixList->GetPropertyKeysWithPrefix("Z").empty())
+    {
+      std::cout << "[FAILED]" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    prefixList->DeleteProperty("MITK.Relations.1.ruleID");
+    keys = prefixList->GetPropertyKeysWithPrefix("MITK.Relations.");
+    if (keys.size() != 1 || keys.front() != "MITK.Relations.2.ruleID")
+    {
+      std::cout << "[FAILED]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::cout << "[PASSED]" << std::endl;
+
   std::cout << "[TEST DONE]" << std::endl;
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,169 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkPropertyRegEx.h"
+#include "mitkPropertyKeyPath.h"
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+class mitkPropertyRegExTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPropertyRegExTestSuite);
+
+  MITK_TEST(DeduceLiteralPrefix);
+  MITK_TEST(Match_EqualsStdRegEx);
+  MITK_TEST(Search_EqualsStdRegEx);
+  MITK_TEST(Get);
+  MITK_TEST(InvalidPattern);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::vector<std::string> m_Patterns;
+  std::vector<std::string> m_Strings;
+
+  std::string Prefix(const std::string &pattern, bool expectedIsLiteral) const
+  {
+    bool isLiteral = !expectedIsLiteral;
+    auto prefix = mitk::PropertyRegEx::DeduceLiteralPrefix(pattern, isLiteral);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Literal state of pattern: " + pattern, expectedIsLiteral, isLiteral);
+    return prefix;
+  }
+
+public:
+  void setUp() override
+  {
+    mitk::PropertyKeyPath relationUIDPath;
+    relationUIDPath.AddElement("MITK").AddElement("Relations").AddAnyElement().AddElement("relationUID");
+    mitk::PropertyKeyPath dicomPath;
+    dicomPath.AddElement("DICOM").AddElement("0008").AddAnySelection("2112").AddElement("0008").AddElement("1155");
+
+    m_Patterns = { mitk::PropertyKeyPathToPropertyRegEx(relationUIDPath),
+                   mitk::PropertyKeyPathToPropertyRegEx(dicomPath),
+                   "name",
+                   "^name$",
+                   "DICOM.0010.0010",
+                   "DICOM_([0-9a-fA-F]{4})_([0-9a-fA-F]{4})",
+                   "ab*c",
+                   "abc|xyz",
+                   ".*\\.ruleID",
+                   "(\\$1)" };
+
+    m_Strings = { "MITK.Relations.1.relationUID",
+                  "MITK.Relations.12.relationUID",
+                  "MITK.Relations.1.ruleID",
+                  "prefix.MITK.Relations.1.relationUID",
+                  "MITK.Relations.1.relationUID.suffix",
+                  "DICOM.0008.2112.[0].0008.1155",
+                  "DICOM.0008.2112.[12].0008.1150",
+                  "DICOM.0010.0010",
+                  "DICOMX0010.0010",
+                  "DICOM_0010_00ab",
+                  "name",
+                  "names",
+                  "ac",
+                  "abbbc",
+                  "xyz",
+                  "$1",
+                  "" };
+  }
+
+  void tearDown() override {}
+
+  void DeduceLiteralPrefix()
+  {
+    CPPUNIT_ASSERT_EQUAL(std::string("MITK.Relations."), Prefix("MITK\\.Relations\\.([a-zA-Z0-9- ]+)\\.ruleID", false));
+    CPPUNIT_ASSERT_EQUAL(std::string("DICOM.0008.2112.["), Prefix("DICOM\\.0008\\.2112\\.\\[(\\d*)\\]\\.0008", false));
+    CPPUNIT_ASSERT_EQUAL(std::string("name"), Prefix("name", true));
+    CPPUNIT_ASSERT_EQUAL(std::string("name"), Prefix("^name$", true));
+    CPPUNIT_ASSERT_EQUAL(std::string("DICOM"), Prefix("DICOM.0010.0010", false));
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), Prefix("ab*c", false));
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), Prefix("ab?c", false));
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), Prefix("ab{0,2}c", false));
+    CPPUNIT_ASSERT_EQUAL(std::string("ab"), Prefix("ab+c", false));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), Prefix("abc|xyz", false));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), Prefix(".*\\.ruleID", false));
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), Prefix("a\\d", false));
+    CPPUNIT_ASSERT_EQUAL(std::string("a|b"), Prefix("a\\|b", true));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), Prefix("", true));
+  }
+
+  void Match_EqualsStdRegEx()
+  {
+    for (const auto &pattern : m_Patterns)
+    {
+      mitk::PropertyRegEx regEx(pattern);
+      std::regex reference(pattern);
+
+      for (const auto &str : m_Strings)
+      {
+        std::smatch matches;
+        std::smatch referenceMatches;
+        const bool expected = std::regex_match(str, referenceMatches, reference);
+
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Pattern: " + pattern + "; string: " + str, expected, regEx.Match(str));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Pattern: " + pattern + "; string: " + str, expected, regEx.Match(str, matches));
+        CPPUNIT_ASSERT_EQUAL(referenceMatches.size(), matches.size());
+        for (std::size_t i = 0; i < matches.size(); ++i)
+        {
+          CPPUNIT_ASSERT_EQUAL(referenceMatches[i].str(), matches[i].str());
+        }
+      }
+    }
+  }
+
+  void Search_EqualsStdRegEx()
+  {
+    for (const auto &pattern : m_Patterns)
+    {
+      mitk::PropertyRegEx regEx(pattern);
+      std::regex reference(pattern);
+
+      for (const auto &str : m_Strings)
+      {
+        std::smatch matches;
+        std::smatch referenceMatches;
+        const bool expected = std::regex_search(str, referenceMatches, reference);
+
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Pattern: " + pattern + "; string: " + str, expected, regEx.Search(str, matches));
+        CPPUNIT_ASSERT_EQUAL(referenceMatches.size(), matches.size());
+        for (std::size_t i = 0; i < matches.size(); ++i)
+        {
+          CPPUNIT_ASSERT_EQUAL(referenceMatches[i].str(), matches[i].str());
+        }
+      }
+    }
+  }
+
+  void Get()
+  {
+    auto regEx = mitk::PropertyRegEx::Get("MITK\\.Relations\\.([a-zA-Z0-9- ]+)\\.ruleID");
+    CPPUNIT_ASSERT(nullptr != regEx);
+    CPPUNIT_ASSERT_EQUAL(std::string("MITK\\.Relations\\.([a-zA-Z0-9- ]+)\\.ruleID"), regEx->GetPattern());
+    CPPUNIT_ASSERT_MESSAGE("Cached instance is returned.",
+                           regEx == mitk::PropertyRegEx::Get("MITK\\.Relations\\.([a-zA-Z0-9- ]+)\\.ruleID"));
+    CPPUNIT_ASSERT(regEx != mitk::PropertyRegEx::Get("MITK\\.Relations\\.([a-zA-Z0-9- ]+)\\.relationUID"));
+
+    mitk::PropertyRegEx::ClearCache();
+    CPPUNIT_ASSERT_MESSAGE("Instances stay valid after clearing the cache.", regEx->Match("MITK.Relations.1.ruleID"));
+    CPPUNIT_ASSERT(regEx != mitk::PropertyRegEx::Get("MITK\\.Relations\\.([a-zA-Z0-9- ]+)\\.ruleID"));
+  }
+
+  void InvalidPattern()
+  {
+    CPPUNIT_ASSERT_THROW(mitk::PropertyRegEx::Get("MITK.(Relations"), std::regex_error);
+    CPPUNIT_ASSERT_THROW(mitk::PropertyRegEx("[a-"), std::regex_error);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPropertyRegEx)
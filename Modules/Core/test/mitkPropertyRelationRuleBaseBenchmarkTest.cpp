@@ -0,0 +1,115 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Benchmark, not part of the ctest set. Run it explicitly:
+//   MitkCoreTestDriver mitkPropertyRelationRuleBaseBenchmarkTest
+
+#include "mitkGenericIDRelationRule.h"
+
+#include "mitkDataNode.h"
+#include "mitkPointSet.h"
+#include "mitkStringProperty.h"
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <chrono>
+#include <regex>
+
+class mitkPropertyRelationRuleBaseBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPropertyRelationRuleBaseBenchmarkTestSuite);
+  MITK_TEST(ConnectedSourcesDetector_Benchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::GenericIDRelationRule::Pointer rule;
+  mitk::DataNode::Pointer dest_1;
+
+public:
+  void setUp() override
+  {
+    rule = mitk::GenericIDRelationRule::New("Benchmark");
+
+    dest_1 = mitk::DataNode::New();
+    dest_1->SetName("dest_1");
+    dest_1->SetData(mitk::PointSet::New());
+  }
+
+  void tearDown() override
+  {
+    rule = nullptr;
+    dest_1 = nullptr;
+  }
+
+  /** Checks the relations of a large number of nodes with many unrelated properties (e.g. DICOM tags)
+   and reports the time in comparison to a full regex scan of all keys of every node.*/
+  void ConnectedSourcesDetector_Benchmark()
+  {
+    const unsigned int numberOfNodes = 5000;
+    const unsigned int numberOfUnrelatedProperties = 60;
+
+    std::vector<mitk::DataNode::Pointer> nodes;
+    for (unsigned int i = 0; i < numberOfNodes; ++i)
+    {
+      auto node = mitk::DataNode::New();
+      for (unsigned int j = 0; j < numberOfUnrelatedProperties; ++j)
+      {
+        node->SetProperty("DICOM.0010." + std::to_string(1000 + j), mitk::StringProperty::New("value"));
+      }
+      if (0 == i % 10)
+      {
+        rule->Connect(node, dest_1);
+      }
+      nodes.push_back(node);
+    }
+
+    auto detector = rule->GetConnectedSourcesDetector();
+
+    auto start = std::chrono::steady_clock::now();
+    unsigned int sourceCount = 0;
+    for (const auto &node : nodes)
+    {
+      if (detector->CheckNode(node))
+      {
+        ++sourceCount;
+      }
+    }
+    const std::chrono::duration<double, std::milli> detectorTime = std::chrono::steady_clock::now() - start;
+
+    CPPUNIT_ASSERT_EQUAL(numberOfNodes / 10, sourceCount);
+
+    // reference: compile the expression per query and scan all keys of every node (former implementation)
+    start = std::chrono::steady_clock::now();
+    unsigned int referenceCount = 0;
+    for (const auto &node : nodes)
+    {
+      std::regex regEx(mitk::PropertyKeyPathToPropertyRegEx(
+        mitk::PropertyRelationRuleBase::GetRIIRuleIDPropertyKeyPath()));
+      for (const auto &key : node->GetPropertyKeys())
+      {
+        if (std::regex_match(key, regEx) && node->GetConstProperty(key)->GetValueAsString() == rule->GetRuleID())
+        {
+          ++referenceCount;
+        }
+      }
+    }
+    const std::chrono::duration<double, std::milli> referenceTime = std::chrono::steady_clock::now() - start;
+
+    CPPUNIT_ASSERT_EQUAL(sourceCount, referenceCount);
+
+    MITK_INFO << "Connected sources detector on " << numberOfNodes << " nodes: " << detectorTime.count()
+              << " ms (full regex scan of all keys: " << referenceTime.count() << " ms)";
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPropertyRelationRuleBaseBenchmark)
@@ -185,6 +185,7 @@ class mitkPropertyRelationRuleBaseTestSuite : public mitk::TestFixture
   MITK_TEST(Connect_abstract);
   MITK_TEST(Disconnect_abstract);
   MITK_TEST(GetRIIPropertyKeyPath);
+  MITK_TEST(ConnectedSourcesDetector_ManyUnrelatedProperties);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -1140,6 +1141,60 @@ public:
     CPPUNIT_ASSERT(referencePath == path);
   }
 
+  /** Checks the relations of a large number of nodes with many unrelated properties (e.g. DICOM tags)
+   in comparison to a full regex scan of all keys of every node. The timing of both is reported by
+   mitkPropertyRelationRuleBaseBenchmarkTest.*/
+  void ConnectedSourcesDetector_ManyUnrelatedProperties()
+  {
+    const unsigned int numberOfNodes = 1000;
+    const unsigned int numberOfUnrelatedProperties = 60;
+
+    std::vector<mitk::DataNode::Pointer> nodes;
+    for (unsigned int i = 0; i < numberOfNodes; ++i)
+    {
+      auto node = mitk::DataNode::New();
+      for (unsigned int j = 0; j < numberOfUnrelatedProperties; ++j)
+      {
+        node->SetProperty("DICOM.0010." + std::to_string(1000 + j), mitk::StringProperty::New("value"));
+      }
+      if (0 == i % 10)
+      {
+        rule->Connect(node, dest_1);
+      }
+      nodes.push_back(node);
+    }
+
+    auto detector = rule->GetConnectedSourcesDetector();
+
+    unsigned int sourceCount = 0;
+    for (const auto &node : nodes)
+    {
+      if (detector->CheckNode(node))
+      {
+        ++sourceCount;
+      }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(numberOfNodes / 10, sourceCount);
+
+    // reference: compile the expression per query and scan all keys of every node (former implementation)
+    unsigned int referenceCount = 0;
+    for (const auto &node : nodes)
+    {
+      std::regex regEx(mitk::PropertyKeyPathToPropertyRegEx(
+        mitk::PropertyRelationRuleBase::GetRIIRuleIDPropertyKeyPath()));
+      for (const auto &key : node->GetPropertyKeys())
+      {
+        if (std::regex_match(key, regEx) && node->GetConstProperty(key)->GetValueAsString() == rule->GetRuleID())
+        {
+          ++referenceCount;
+        }
+      }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(sourceCount, referenceCount);
+  }
+
 
 };
 
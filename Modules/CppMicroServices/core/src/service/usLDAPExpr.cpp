@@ -282,6 +282,47 @@ bool LDAPExpr::IsSimple(const StringList& keywords, LocalCache& cache,
   return false;
 }
 
+bool LDAPExpr::GetEqualityConstraint(std::string& attrName, StringList& values) const
+{
+  if (!d) return false;
+
+  if (d->m_operator == EQ)
+  {
+    if (d->m_attrValue.find_first_of(LDAPExprConstants::WILDCARD()) != std::string::npos)
+      return false;
+
+    attrName = d->m_attrName;
+    values = StringList(1, d->m_attrValue);
+    return true;
+  }
+  else if (d->m_operator == OR)
+  {
+    StringList mergedValues;
+    for (std::size_t i = 0; i < d->m_args.size(); i++)
+    {
+      std::string argAttrName;
+      StringList argValues;
+      if (!d->m_args[i].GetEqualityConstraint(argAttrName, argValues) ||
+          (i > 0 && argAttrName != attrName))
+        return false;
+
+      attrName = argAttrName;
+      mergedValues.insert(mergedValues.end(), argValues.begin(), argValues.end());
+    }
+    values.swap(mergedValues);
+    return !d->m_args.empty();
+  }
+  else if (d->m_operator == AND)
+  {
+    for (std::size_t i = 0; i < d->m_args.size(); i++)
+    {
+      if (d->m_args[i].GetEqualityConstraint(attrName, values))
+        return true;
+    }
+  }
+  return false;
+}
+
 bool LDAPExpr::IsNull() const
 {
   return !d;
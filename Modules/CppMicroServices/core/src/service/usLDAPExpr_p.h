@@ -110,6 +110,27 @@ public:
     LocalCache& cache,
     bool matchCase) const;
 
+  /**
+   * Checks if every match of this LDAP expression requires a certain attribute
+   * to be equal to one of a set of values. This is the case for
+   * <ul>
+   *  <li><code>(<it>name</it>=<it>value</it>)</code> if <it>value</it> does not
+   *      contain a wildcard character;</li>
+   *  <li><code>(| EXPR+ )</code> if all <code>EXPR</code> constrain the same
+   *      attribute (the values are merged);</li>
+   *  <li><code>(& EXPR+ )</code> if one of the <code>EXPR</code> constrains
+   *      an attribute.</li>
+   * </ul>
+   * Such expressions can be evaluated with the help of an index over the
+   * values of the attribute.
+   *
+   * @param attrName Is set to the name of the constrained attribute.
+   * @param values Is set to the values allowed for the attribute.
+   * @return <code>true</code> if the expression has such a constraint,
+   *         <code>false</code> otherwise.
+   */
+  bool GetEqualityConstraint(std::string& attrName, StringList& values) const;
+
   /**
    * Returns <code>true</code> if this instance is invalid, i.e. it was
    * constructed using LDAPExpr().
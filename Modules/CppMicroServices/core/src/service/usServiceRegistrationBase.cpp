@@ -133,6 +133,11 @@ void ServiceRegistrationBase::SetProperties(const ServiceProperties& props)
       {
         d->module->coreCtx->services.UpdateServiceRegistrationOrder(*this, classes);
       }
+      else
+      {
+        // the property indexes of the service classes are outdated
+        d->module->coreCtx->services.UpdateServiceProperties(classes);
+      }
     }
     else
     {
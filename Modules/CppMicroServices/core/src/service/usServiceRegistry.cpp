@@ -22,6 +22,7 @@
 #include <iterator>
 #include <stdexcept>
 #include <cassert>
+#include <list>
 
 #include "usServiceRegistry_p.h"
 #include "usServiceFactory.h"
@@ -34,6 +35,77 @@
 
 US_BEGIN_NAMESPACE
 
+namespace {
+
+// Filters are mostly built from a small set of templates (e.g. mime type or
+// property names), the cache is reset if it grows beyond this size.
+const std::size_t MaxFilterCacheSize = 1024;
+
+}
+
+ServiceRegistry::ClassServices::ClassServices(const std::vector<ServiceRegistrationBase>& regs)
+  : registrations(regs)
+{
+}
+
+std::shared_ptr<const ServiceRegistry::PropertyIndex>
+ServiceRegistry::ClassServices::GetIndex(const std::string& key) const
+{
+  MutexLock lock(indexMutex);
+
+  std::shared_ptr<const PropertyIndex>& index = indexes[key];
+  if (!index)
+  {
+    std::shared_ptr<PropertyIndex> newIndex = std::make_shared<PropertyIndex>();
+
+    for (std::size_t pos = 0; pos < registrations.size(); ++pos)
+    {
+      const ServiceRegistrationBase& sr = registrations[pos];
+      MutexLock propsLock(sr.d->propsLock);
+
+      // same lookup as LDAPExpr::Evaluate: case sensitive first
+      int propIndex = sr.d->properties.FindCaseSensitive(key);
+      if (propIndex < 0) propIndex = sr.d->properties.Find(key);
+      if (propIndex < 0)
+      {
+        // cannot match an equality constraint on the key
+        continue;
+      }
+
+      const Any& value = sr.d->properties.Value(propIndex);
+      if (value.Type() == typeid(std::string))
+      {
+        newIndex->values[ref_any_cast<std::string>(value)].push_back(pos);
+      }
+      else if (value.Type() == typeid(std::vector<std::string>))
+      {
+        const std::vector<std::string>& list = ref_any_cast<std::vector<std::string> >(value);
+        for (std::vector<std::string>::const_iterator i = list.begin(); i != list.end(); ++i)
+        {
+          std::vector<std::size_t>& positions = newIndex->values[*i];
+          if (positions.empty() || positions.back() != pos) positions.push_back(pos);
+        }
+      }
+      else if (value.Type() == typeid(std::list<std::string>))
+      {
+        const std::list<std::string>& list = ref_any_cast<std::list<std::string> >(value);
+        for (std::list<std::string>::const_iterator i = list.begin(); i != list.end(); ++i)
+        {
+          std::vector<std::size_t>& positions = newIndex->values[*i];
+          if (positions.empty() || positions.back() != pos) positions.push_back(pos);
+        }
+      }
+      else
+      {
+        newIndex->unindexed.push_back(pos);
+      }
+    }
+
+    index = newIndex;
+  }
+  return index;
+}
+
 ServicePropertiesImpl ServiceRegistry::CreateServiceProperties(const ServiceProperties& in,
                                                                const std::vector<std::string>& classes,
                                                                bool isFactory, bool isPrototypeFactory,
@@ -66,7 +138,8 @@ ServicePropertiesImpl ServiceRegistry::CreateServiceProperties(const ServiceProp
 }
 
 ServiceRegistry::ServiceRegistry(CoreModuleContext* coreCtx)
-  : core(coreCtx)
+  : classServices(std::make_shared<MapClassServices>())
+  , core(coreCtx)
 {
 
 }
@@ -80,10 +153,72 @@ void ServiceRegistry::Clear()
 {
   services.clear();
   serviceRegistrations.clear();
-  classServices.clear();
+  std::atomic_store(&classServices, std::shared_ptr<const MapClassServices>(std::make_shared<MapClassServices>()));
+  {
+    MutexLock lock(filterCacheMutex);
+    filterCache.clear();
+  }
   core = nullptr;
 }
 
+std::shared_ptr<const ServiceRegistry::MapClassServices> ServiceRegistry::GetClassServices() const
+{
+  return std::atomic_load(&classServices);
+}
+
+std::shared_ptr<const ServiceRegistry::ClassServices> ServiceRegistry::GetClassServices(const std::string& clazz) const
+{
+  std::shared_ptr<const MapClassServices> map = GetClassServices();
+  MapClassServices::const_iterator i = map->find(clazz);
+  if (i != map->end())
+  {
+    return i->second;
+  }
+  return std::shared_ptr<const ClassServices>();
+}
+
+void ServiceRegistry::PublishClassServices_unlocked(
+    const US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> >& changes)
+{
+  std::shared_ptr<MapClassServices> map = std::make_shared<MapClassServices>(*GetClassServices());
+  for (US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> >::const_iterator i = changes.begin();
+       i != changes.end(); ++i)
+  {
+    if (i->second.empty())
+    {
+      map->erase(i->first);
+    }
+    else
+    {
+      (*map)[i->first] = std::make_shared<const ClassServices>(i->second);
+    }
+  }
+  std::atomic_store(&classServices, std::shared_ptr<const MapClassServices>(map));
+}
+
+LDAPExpr ServiceRegistry::GetFilterExpression(const std::string& filter) const
+{
+  {
+    MutexLock lock(filterCacheMutex);
+    US_UNORDERED_MAP_TYPE<std::string, LDAPExpr>::const_iterator i = filterCache.find(filter);
+    if (i != filterCache.end())
+    {
+      return i->second;
+    }
+  }
+
+  // parse outside of the lock, invalid filters throw and are not cached
+  LDAPExpr ldap(filter);
+
+  MutexLock lock(filterCacheMutex);
+  if (filterCache.size() >= MaxFilterCacheSize)
+  {
+    filterCache.clear();
+  }
+  filterCache.insert(std::make_pair(filter, ldap));
+  return ldap;
+}
+
 ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
                                                      const InterfaceMap& service,
                                                      const ServiceProperties& properties)
@@ -115,14 +250,18 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
     MutexLock lock(mutex);
     services.insert(std::make_pair(res, classes));
     serviceRegistrations.push_back(res);
+
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > changes;
     for (std::vector<std::string>::const_iterator i = classes.begin();
          i != classes.end(); ++i)
     {
-      std::vector<ServiceRegistrationBase>& s = classServices[*i];
+      std::vector<ServiceRegistrationBase>& s = changes[*i];
+      Get_unlocked(*i, s);
       std::vector<ServiceRegistrationBase>::iterator ip =
           std::lower_bound(s.begin(), s.end(), res);
       s.insert(ip, res);
     }
+    PublishClassServices_unlocked(changes);
   }
 
   ServiceReferenceBase r = res.GetReference(std::string());
@@ -138,39 +277,55 @@ void ServiceRegistry::UpdateServiceRegistrationOrder(const ServiceRegistrationBa
                                                      const std::vector<std::string>& classes)
 {
   MutexLock lock(mutex);
+
+  US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > changes;
   for (std::vector<std::string>::const_iterator i = classes.begin();
        i != classes.end(); ++i)
   {
-    std::vector<ServiceRegistrationBase>& s = classServices[*i];
+    std::vector<ServiceRegistrationBase>& s = changes[*i];
+    Get_unlocked(*i, s);
     s.erase(std::remove(s.begin(), s.end(), sr), s.end());
     s.insert(std::lower_bound(s.begin(), s.end(), sr), sr);
   }
+  PublishClassServices_unlocked(changes);
+}
+
+void ServiceRegistry::UpdateServiceProperties(const std::vector<std::string>& classes)
+{
+  MutexLock lock(mutex);
+
+  // republish the unchanged registrations to drop the property indexes
+  US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > changes;
+  for (std::vector<std::string>::const_iterator i = classes.begin();
+       i != classes.end(); ++i)
+  {
+    Get_unlocked(*i, changes[*i]);
+  }
+  PublishClassServices_unlocked(changes);
 }
 
 void ServiceRegistry::Get(const std::string& clazz,
                           std::vector<ServiceRegistrationBase>& serviceRegs) const
 {
-  MutexLock lock(mutex);
   Get_unlocked(clazz, serviceRegs);
 }
 
 void ServiceRegistry::Get_unlocked(const std::string& clazz,
                                    std::vector<ServiceRegistrationBase>& serviceRegs) const
 {
-  MapClassServices::const_iterator i = classServices.find(clazz);
-  if (i != classServices.end())
+  std::shared_ptr<const ClassServices> s = GetClassServices(clazz);
+  if (s)
   {
-    serviceRegs = i->second;
+    serviceRegs = s->registrations;
   }
 }
 
 ServiceReferenceBase ServiceRegistry::Get(ModulePrivate* module, const std::string& clazz) const
 {
-  MutexLock lock(mutex);
   try
   {
     std::vector<ServiceReferenceBase> srs;
-    Get_unlocked(clazz, "", module, srs);
+    Get(clazz, "", module, srs);
     US_DEBUG << "get service ref " << clazz << " for module "
              << module->info.name << " = " << srs.size() << " refs";
 
@@ -188,8 +343,16 @@ ServiceReferenceBase ServiceRegistry::Get(ModulePrivate* module, const std::stri
 void ServiceRegistry::Get(const std::string& clazz, const std::string& filter,
                           ModulePrivate* module, std::vector<ServiceReferenceBase>& res) const
 {
-  MutexLock lock(mutex);
-  Get_unlocked(clazz, filter, module, res);
+  if (clazz.empty())
+  {
+    MutexLock lock(mutex);
+    Get_unlocked(clazz, filter, module, res);
+  }
+  else
+  {
+    // lookups by class only read the published snapshot
+    Get_unlocked(clazz, filter, module, res);
+  }
 }
 
 void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string& filter,
@@ -198,23 +361,25 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   std::vector<ServiceRegistrationBase>::const_iterator s;
   std::vector<ServiceRegistrationBase>::const_iterator send;
   std::vector<ServiceRegistrationBase> v;
+  std::shared_ptr<const ClassServices> classSnapshot;
   LDAPExpr ldap;
   if (clazz.empty())
   {
     if (!filter.empty())
     {
-      ldap = LDAPExpr(filter);
+      ldap = GetFilterExpression(filter);
       LDAPExpr::ObjectClassSet matched;
       if (ldap.GetMatchedObjectClasses(matched))
       {
         v.clear();
+        std::shared_ptr<const MapClassServices> map = GetClassServices();
         for(LDAPExpr::ObjectClassSet::const_iterator className = matched.begin();
             className != matched.end(); ++className)
         {
-          MapClassServices::const_iterator i = classServices.find(*className);
-          if (i != classServices.end())
+          MapClassServices::const_iterator i = map->find(*className);
+          if (i != map->end())
           {
-            std::copy(i->second.begin(), i->second.end(), std::back_inserter(v));
+            std::copy(i->second->registrations.begin(), i->second->registrations.end(), std::back_inserter(v));
           }
         }
         if (!v.empty())
@@ -241,11 +406,11 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
   }
   else
   {
-    MapClassServices::const_iterator it = classServices.find(clazz);
-    if (it != classServices.end())
+    classSnapshot = GetClassServices(clazz);
+    if (classSnapshot)
     {
-      s = it->second.begin();
-      send = it->second.end();
+      s = classSnapshot->registrations.begin();
+      send = classSnapshot->registrations.end();
     }
     else
     {
@@ -253,17 +418,43 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
     }
     if (!filter.empty())
     {
-      ldap = LDAPExpr(filter);
+      ldap = GetFilterExpression(filter);
+
+      // only evaluate the candidates of an equality constraint
+      std::string attrName;
+      LDAPExpr::StringList values;
+      if (ldap.GetEqualityConstraint(attrName, values))
+      {
+        std::shared_ptr<const PropertyIndex> index = classSnapshot->GetIndex(attrName);
+
+        std::vector<std::size_t> candidates(index->unindexed);
+        for (LDAPExpr::StringList::const_iterator value = values.begin(); value != values.end(); ++value)
+        {
+          PropertyIndex::ValueMap::const_iterator i = index->values.find(*value);
+          if (i != index->values.end())
+          {
+            candidates.insert(candidates.end(), i->second.begin(), i->second.end());
+          }
+        }
+
+        // keep the ranking order of the registrations
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        for (std::vector<std::size_t>::const_iterator i = candidates.begin(); i != candidates.end(); ++i)
+        {
+          v.push_back(classSnapshot->registrations[*i]);
+        }
+        s = v.begin();
+        send = v.end();
+      }
     }
   }
 
   for (; s != send; ++s)
   {
-    ServiceReferenceBase sri = s->GetReference(clazz);
-
     if (filter.empty() || ldap.Evaluate(s->d->properties, false))
     {
-      res.push_back(sri);
+      res.push_back(s->GetReference(clazz));
     }
   }
 
@@ -290,19 +481,17 @@ void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& s
   services.erase(sr);
   serviceRegistrations.erase(std::remove(serviceRegistrations.begin(), serviceRegistrations.end(), sr),
                              serviceRegistrations.end());
+
+  // an empty vector removes the class
+  US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > changes;
   for (std::vector<std::string>::const_iterator i = classes.begin();
        i != classes.end(); ++i)
   {
-    std::vector<ServiceRegistrationBase>& s = classServices[*i];
-    if (s.size() > 1)
-    {
-      s.erase(std::remove(s.begin(), s.end(), sr), s.end());
-    }
-    else
-    {
-      classServices.erase(*i);
-    }
+    std::vector<ServiceRegistrationBase>& s = changes[*i];
+    Get_unlocked(*i, s);
+    s.erase(std::remove(s.begin(), s.end(), sr), s.end());
   }
+  PublishClassServices_unlocked(changes);
 }
 
 void ServiceRegistry::GetRegisteredByModule(ModulePrivate* p,
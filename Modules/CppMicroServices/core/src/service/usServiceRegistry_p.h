@@ -27,6 +27,9 @@
 #include "usServiceRegistration.h"
 
 #include "usThreads_p.h"
+#include "usLDAPExpr_p.h"
+
+#include <memory>
 
 US_BEGIN_NAMESPACE
 
@@ -60,8 +63,53 @@ public:
                                                        const std::vector<std::string>& classes = std::vector<std::string>(),
                                                        bool isFactory = false, bool isPrototypeFactory = false, long sid = -1);
 
+  /**
+   * Index of the registrations of a class by the value of one property.
+   * Positions refer to ClassServices::registrations.
+   */
+  struct PropertyIndex
+  {
+    typedef US_UNORDERED_MAP_TYPE<std::string, std::vector<std::size_t> > ValueMap;
+
+    /** Positions of the registrations with a (multi-)string property value.*/
+    ValueMap values;
+
+    /**
+     * Positions of the registrations with a non string property value
+     * (e.g. numbers). They can not be hashed by the filter string and are
+     * always evaluated.
+     */
+    std::vector<std::size_t> unindexed;
+  };
+
+  /**
+   * Immutable snapshot of the services registered under one class name,
+   * ordered with the highest ranked service first. Any change of the
+   * registrations or of their properties publishes a new snapshot, thus
+   * readers can use a snapshot without holding the registry mutex.
+   */
+  class ClassServices
+  {
+  public:
+
+    explicit ClassServices(const std::vector<ServiceRegistrationBase>& regs);
+
+    const std::vector<ServiceRegistrationBase> registrations;
+
+    /**
+     * Returns the index of the registrations by the given property key.
+     * The index is built on the first request of the key.
+     */
+    std::shared_ptr<const PropertyIndex> GetIndex(const std::string& key) const;
+
+  private:
+
+    mutable MutexType indexMutex;
+    mutable US_UNORDERED_MAP_TYPE<std::string, std::shared_ptr<const PropertyIndex> > indexes;
+  };
+
   typedef US_UNORDERED_MAP_TYPE<ServiceRegistrationBase, std::vector<std::string> > MapServiceClasses;
-  typedef US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > MapClassServices;
+  typedef US_UNORDERED_MAP_TYPE<std::string, std::shared_ptr<const ClassServices> > MapClassServices;
 
   /**
    * All registered services in the current framework.
@@ -76,8 +124,11 @@ public:
    * Mapping of classname to registered service.
    * The List of registered services are ordered with the highest
    * ranked service first.
+   *
+   * The map is copied on write (under the mutex) and published
+   * atomically. Use GetClassServices() to read it.
    */
-  MapClassServices classServices;
+  std::shared_ptr<const MapClassServices> classServices;
 
   CoreModuleContext* core;
 
@@ -116,6 +167,14 @@ public:
   void UpdateServiceRegistrationOrder(const ServiceRegistrationBase& sr,
                                       const std::vector<std::string>& classes);
 
+  /**
+   * Service properties changed (without a change of the ranking),
+   * invalidate the property indexes of the service classes.
+   *
+   * @param classes The classes of the service.
+   */
+  void UpdateServiceProperties(const std::vector<std::string>& classes);
+
   /**
    * Get all services implementing a certain class.
    * Only used internally by the framework.
@@ -173,11 +232,39 @@ private:
 
   friend class ServiceHooks;
 
+  /*
+   * The Get_unlocked methods only need the mutex if no class name is given
+   * (then all registrations are searched). Lookups by class name use the
+   * published class snapshots.
+   */
   void Get_unlocked(const std::string& clazz, std::vector<ServiceRegistrationBase>& serviceRegs) const;
 
   void Get_unlocked(const std::string& clazz, const std::string& filter,
                     ModulePrivate* module, std::vector<ServiceReferenceBase>& serviceRefs) const;
 
+  /** Returns the current snapshot of the class to services map.*/
+  std::shared_ptr<const MapClassServices> GetClassServices() const;
+
+  /** Returns the current snapshot of the services of a class (or null).*/
+  std::shared_ptr<const ClassServices> GetClassServices(const std::string& clazz) const;
+
+  /**
+   * Replaces the services of the given classes (empty vectors remove
+   * the class) and publishes the new map. Requires the mutex.
+   */
+  void PublishClassServices_unlocked(const US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> >& changes);
+
+  /**
+   * Returns the parsed LDAP expression of the filter. Parsed filters are
+   * kept in a bounded cache.
+   *
+   * @throws std::invalid_argument If the filter is not valid.
+   */
+  LDAPExpr GetFilterExpression(const std::string& filter) const;
+
+  mutable MutexType filterCacheMutex;
+  mutable US_UNORDERED_MAP_TYPE<std::string, LDAPExpr> filterCache;
+
   // purposely not implemented
   ServiceRegistry(const ServiceRegistry&);
   ServiceRegistry& operator=(const ServiceRegistry&);
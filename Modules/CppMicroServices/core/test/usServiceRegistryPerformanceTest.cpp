@@ -24,6 +24,8 @@
 #include <usGetModuleContext.h>
 #include <usModuleContext.h>
 
+#include <thread>
+
 US_USE_NAMESPACE
 
 #ifdef US_PLATFORM_APPLE
@@ -203,6 +205,7 @@ public:
 
   void TestAddListeners();
   void TestRegisterServices();
+  void TestFilteredLookups();
 
   void TestModifyServices();
   void TestUnregisterServices();
@@ -216,6 +219,7 @@ private:
 
   void AddListeners(int n);
   void RegisterServices(int n);
+  std::size_t LookupServices(int n, int offset) const;
   void ModifyServices();
   void UnregisterServices();
 
@@ -358,6 +362,63 @@ void ServiceRegistryPerformanceTest::RegisterServices(int n)
   }
 }
 
+void ServiceRegistryPerformanceTest::TestFilteredLookups()
+{
+  Log() << "Lookup services by filter, and check that we get exactly one service per lookup\n";
+
+  const int nLookups = 2000;
+  const int nThreads = 4;
+
+  HighPrecisionTimer t;
+  t.Start();
+  std::size_t found = LookupServices(nLookups, 0);
+  long long ms = t.ElapsedMilli();
+  Log() << nLookups << " lookups took " << ms << "ms\n";
+  US_TEST_CONDITION_REQUIRED(found == static_cast<std::size_t>(nLookups),
+                             "# of found services must be same as # of lookups");
+
+  std::vector<std::size_t> threadFound(nThreads, 0);
+  std::vector<std::thread> threads;
+  t.Start();
+  for (int i = 0; i < nThreads; ++i)
+  {
+    threads.push_back(std::thread([this, i, nLookups, &threadFound]() {
+      threadFound[i] = this->LookupServices(nLookups, i);
+    }));
+  }
+  for (std::size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i].join();
+  }
+  ms = t.ElapsedMilli();
+  Log() << nThreads << " threads with " << nLookups << " lookups each took " << ms << "ms\n";
+  for (int i = 0; i < nThreads; ++i)
+  {
+    US_TEST_CONDITION_REQUIRED(threadFound[i] == static_cast<std::size_t>(nLookups),
+                               "# of found services must be same as # of lookups in each thread");
+  }
+
+  std::vector<ServiceReference<IPerfTestService> > refs =
+      mc->GetServiceReferences<IPerfTestService>("(|(service.pid=my.service.1)(service.pid=my.service.2))");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 2, "Disjunction of pids returns both services");
+  refs = mc->GetServiceReferences<IPerfTestService>("(&(service.pid=my.service.1)(perf.service.value=2))");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 1, "Conjunction with non-string property");
+  refs = mc->GetServiceReferences<IPerfTestService>("(&(service.pid=my.service.1)(perf.service.value=3))");
+  US_TEST_CONDITION_REQUIRED(refs.empty(), "Conjunction with non-matching property");
+}
+
+std::size_t ServiceRegistryPerformanceTest::LookupServices(int n, int offset) const
+{
+  std::size_t found = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    std::stringstream ss;
+    ss << "(service.pid=my.service." << (i + offset) % nServices << ")";
+    found += mc->GetServiceReferences<IPerfTestService>(ss.str()).size();
+  }
+  return found;
+}
+
 void ServiceRegistryPerformanceTest::TestModifyServices()
 {
   Log() << "Modify all services, and check that we get #of services ("
@@ -370,6 +431,8 @@ void ServiceRegistryPerformanceTest::TestModifyServices()
   Log() << "modify took " << ms << "ms\n";
   US_TEST_CONDITION_REQUIRED(nServices * listeners.size() == nModified,
                              "# MODIFIED events must be same as # of modified services  * # of listeners");
+  US_TEST_CONDITION_REQUIRED(mc->GetServiceReferences<IPerfTestService>("(service.pid=my.service.1)").empty(),
+                             "Lookups must not find removed properties");
 }
 
 void ServiceRegistryPerformanceTest::ModifyServices()
@@ -420,6 +483,7 @@ int usServiceRegistryPerformanceTest(int /*argc*/, char* /*argv*/[])
   perfTest.InitTestCase();
   perfTest.TestAddListeners();
   perfTest.TestRegisterServices();
+  perfTest.TestFilteredLookups();
   perfTest.TestModifyServices();
   perfTest.TestUnregisterServices();
   perfTest.CleanupTestCase();
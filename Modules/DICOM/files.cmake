@@ -6,6 +6,7 @@ set(CPP_FILES
   mitkDICOMTagScanner.cpp
   mitkDICOMGDCMTagScanner.cpp
   mitkDICOMDCMTKTagScanner.cpp
+  mitkDICOMTagScanIndex.cpp
   mitkDICOMImageBlockDescriptor.cpp
   mitkDICOMITKSeriesGDCMReader.cpp
   mitkDICOMDatasetSorter.cpp
@@ -31,6 +31,13 @@ public:
 
   IFileReader::ConfidenceLevel GetConfidenceLevel() const override;
 
+  /** Sets the file of the persistent DICOMTagScanIndex that all DICOM reader services use
+   * to skip files that did not change since they were scanned the last time. The setting
+   * is shared by all reader services, so that applications can configure it once (e.g. from
+   * their preferences). An empty name (default) disables the index.*/
+  static void SetTagScanIndexFileName(const std::string& fileName);
+  static std::string GetTagScanIndexFileName();
+
 protected:
   BaseDICOMReaderService(const std::string& description);
   BaseDICOMReaderService(const mitk::CustomMimeType& customType, const std::string& description);
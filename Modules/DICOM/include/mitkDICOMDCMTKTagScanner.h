@@ -18,6 +18,7 @@ found in the LICENSE file.
 #include "mitkDICOMTagScanner.h"
 #include "mitkDICOMEnums.h"
 #include "mitkDICOMGenericTagCache.h"
+#include "mitkDICOMTagScanIndex.h"
 
 namespace mitk
 {
@@ -27,6 +28,13 @@ namespace mitk
     \brief Encapsulates the tag scanning process for a set of DICOM files.
 
     For the scanning process it uses DCMTK functionality.
+
+    Scanning can be sped up in three ways:
+    - SetStopBeforePixelData() stops parsing each file in front of the pixel data
+      element (7FE0,0010), so only the header of a file is read.
+    - SetNumberOfThreads() distributes the files over the ITK thread pool.
+    - SetScanIndex() takes the tag values of files that did not change since
+      they were scanned the last time from a persistent DICOMTagScanIndex.
   */
   class MITKDICOM_EXPORT DICOMDCMTKTagScanner : public DICOMTagScanner
   {
@@ -78,6 +86,34 @@ namespace mitk
       */
       DICOMTagCache::Pointer GetScanCache() const override;
 
+      /**
+        \brief Stop parsing each file in front of the pixel data element (7FE0,0010).
+        Tags located behind the pixel data are not found in this mode. Default: false.
+      */
+      itkSetMacro(StopBeforePixelData, bool);
+      itkGetConstMacro(StopBeforePixelData, bool);
+      itkBooleanMacro(StopBeforePixelData);
+
+      /**
+        \brief Number of threads used for scanning.
+        1 scans all files in the calling thread, 0 uses the default of the ITK
+        multi-threader. Default: 1.
+      */
+      itkSetMacro(NumberOfThreads, unsigned int);
+      itkGetConstMacro(NumberOfThreads, unsigned int);
+
+      /**
+        \brief Index that is consulted before a file is parsed and that is updated with newly scanned files.
+        Default: nullptr (no index).
+      */
+      void SetScanIndex(DICOMTagScanIndex* index);
+      DICOMTagScanIndex* GetScanIndex() const;
+
+      /**
+        \brief Number of files of the last scan whose tag values were taken from the scan index.
+      */
+      itkGetConstMacro(NumberOfFilesTakenFromIndex, std::size_t);
+
     protected:
 
       DICOMDCMTKTagScanner();
@@ -87,6 +123,11 @@ namespace mitk
       StringList m_InputFilenames;
       DICOMGenericTagCache::Pointer m_Cache;
 
+      bool m_StopBeforePixelData;
+      unsigned int m_NumberOfThreads;
+      DICOMTagScanIndex::Pointer m_ScanIndex;
+      std::size_t m_NumberOfFilesTakenFromIndex;
+
     private:
       DICOMDCMTKTagScanner(const DICOMDCMTKTagScanner&);
   };
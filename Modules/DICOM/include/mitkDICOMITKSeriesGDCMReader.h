@@ -20,6 +20,7 @@ found in the LICENSE file.
 #include "mitkDICOMGDCMImageFrameInfo.h"
 #include "mitkEquiDistantBlocksSorter.h"
 #include "mitkNormalDirectionConsistencySorter.h"
+#include "mitkITKDICOMSeriesReaderHelper.h"
 #include "MitkDICOMExports.h"
 
 
@@ -259,6 +260,40 @@ class MITKDICOM_EXPORT DICOMITKSeriesGDCMReader : public DICOMFileReader
       return m_SimpleVolumeReading;
     };
 
+    /**
+      \brief Persistent tag scan index used by AnalyzeInputFiles().
+      If a file name is set, tags are scanned with DICOMDCMTKTagScanner on multiple
+      threads, parsing only the file headers. Files that did not change since the
+      last scan (same path, modification time and size) are taken from the index
+      file, which is updated after every scan. An empty name (default) disables the index.
+    */
+    void SetTagScanIndexFileName(const std::string& fileName)
+    {
+      if (m_TagScanIndexFileName != fileName)
+      {
+        m_TagScanIndexFileName = fileName;
+        this->Modified();
+      }
+    };
+
+    const std::string& GetTagScanIndexFileName() const
+    {
+      return m_TagScanIndexFileName;
+    };
+
+    /**
+      \brief Throughput counters of all images loaded by this reader so far.
+    */
+    const ITKDICOMSeriesReaderHelper::LoadStatistics& GetLoadStatistics() const
+    {
+      return m_LoadStatistics;
+    };
+
+    void ResetLoadStatistics()
+    {
+      m_LoadStatistics = ITKDICOMSeriesReaderHelper::LoadStatistics();
+    };
+
     double GetToleratedOriginError() const;
     bool IsToleratedOriginOffsetAbsolute() const;
 
@@ -370,6 +405,9 @@ class MITKDICOM_EXPORT DICOMITKSeriesGDCMReader : public DICOMFileReader
 
     DICOMTagCache::Pointer m_TagCache;
     bool m_ExternalCache;
+    std::string m_TagScanIndexFileName;
+
+    mutable ITKDICOMSeriesReaderHelper::LoadStatistics m_LoadStatistics;
 };
 
 }
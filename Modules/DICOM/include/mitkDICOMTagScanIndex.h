@@ -0,0 +1,133 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkDICOMTagScanIndex_h
+#define mitkDICOMTagScanIndex_h
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+
+#include <itkObjectFactory.h>
+#include <mitkCommon.h>
+
+#include "mitkDICOMTagPath.h"
+
+#include "MitkDICOMExports.h"
+
+namespace mitk
+{
+
+  /**
+    \ingroup DICOMModule
+    \brief Persistent index of tag scan results.
+
+    The index stores the tag values found in each scanned file together with
+    the modification time and size of the file. DICOMDCMTKTagScanner takes the
+    values of a file from the index instead of parsing the file again, as long
+    as path, modification time and size did not change.
+
+    The entries are only valid for the set of tag paths they were scanned for.
+    SetScannedTagPaths() therefore discards all entries if the requested tag
+    paths differ from the indexed ones.
+
+    Entries of files that were modified or deleted are removed when they are
+    looked up. The number of entries is bounded by SetMaximumNumberOfEntries();
+    if it is exceeded, the least recently used entries are evicted, so that an
+    index shared by many imports does not grow without limit.
+
+    Lookup() and Insert() may be called concurrently from multiple threads.
+  */
+  class MITKDICOM_EXPORT DICOMTagScanIndex : public itk::Object
+  {
+    public:
+
+      mitkClassMacroItkParent(DICOMTagScanIndex, itk::Object);
+      itkFactorylessNewMacro(DICOMTagScanIndex);
+
+      typedef std::vector<std::pair<DICOMTagPath, std::string>> TagValueList;
+
+      /**
+        \brief Replace the content of the index by the content of an index file.
+        \return False if the file does not exist or is not a valid index file.
+        The index is empty in this case.
+      */
+      bool Load(const std::string& indexFilename);
+
+      /**
+        \brief Write the index to a file.
+        \exception mitk::Exception if the file cannot be written.
+      */
+      void Save(const std::string& indexFilename) const;
+
+      /**
+        \brief Define the tag paths of subsequent scans.
+        Existing entries are discarded if they were scanned for a different
+        set of tag paths, even for a superset of the passed tag paths.
+      */
+      void SetScannedTagPaths(const std::set<DICOMTagPath>& tagPaths);
+
+      /**
+        \brief Retrieve the indexed tag values of a file.
+        \return False if the file is not indexed or if it was modified since
+        it was indexed. The entry of a modified or deleted file is removed.
+      */
+      bool Lookup(const std::string& filename, TagValueList& values);
+
+      /**
+        \brief Add or replace the entry of a file.
+        The current modification time and size of the file are stored with the values.
+      */
+      void Insert(const std::string& filename, const TagValueList& values);
+
+      std::size_t GetNumberOfEntries() const;
+
+      /**
+        \brief Upper bound of the number of entries (default: 100000, 0 means unbounded).
+        Exceeding entries are evicted in least recently used order.
+      */
+      void SetMaximumNumberOfEntries(std::size_t maximumNumberOfEntries);
+      std::size_t GetMaximumNumberOfEntries() const;
+
+      void Clear();
+
+    protected:
+
+      DICOMTagScanIndex();
+      ~DICOMTagScanIndex() override;
+
+      struct Entry
+      {
+        long int ModifiedTime;
+        unsigned long FileSize;
+        std::uint64_t LastUsed;
+        TagValueList Values;
+      };
+
+      typedef std::map<std::string, Entry> EntryMapType;
+
+      /** Evicts least recently used entries if the maximum number of entries is exceeded. Expects m_Mutex to be locked. */
+      void EvictEntries();
+
+      EntryMapType m_Entries;
+      std::set<std::string> m_ScannedTagPaths;
+      std::uint64_t m_UseCounter;
+      std::size_t m_MaximumNumberOfEntries;
+      mutable std::mutex m_Mutex;
+
+    private:
+      DICOMTagScanIndex(const DICOMTagScanIndex&);
+  };
+}
+
+#endif
@@ -25,10 +25,49 @@ class OFDateTime;
 namespace mitk
 {
 
+/**
+  \brief Loads DICOM series into mitk::Image.
+
+  The frames of a series are decoded concurrently on the ITK thread pool,
+  each frame straight into its final position in the buffer of the result image.
+  The geometry of the result is determined by itk::ImageSeriesReader, so it
+  is identical to reading the series with ITK. Each frame is decoded with its
+  own rescale slope and intercept.
+*/
 class ITKDICOMSeriesReaderHelper
 {
   public:
 
+    /** \brief Throughput counters of the loads performed by a helper instance. */
+    struct LoadStatistics
+    {
+      std::size_t NumberOfFrames = 0;
+      std::size_t NumberOfBytes = 0;
+      /** Seconds spent in decoding the frames. */
+      double DecodingTime = 0.0;
+      /** Seconds spent in loading, including geometry determination and tilt correction. */
+      double TotalTime = 0.0;
+
+      double GetFramesPerSecond() const
+      {
+        return TotalTime > 0.0 ? NumberOfFrames / TotalTime : 0.0;
+      }
+
+      double GetMegabytesPerSecond() const
+      {
+        return TotalTime > 0.0 ? NumberOfBytes / (TotalTime * 1024.0 * 1024.0) : 0.0;
+      }
+
+      LoadStatistics& operator+=(const LoadStatistics& other)
+      {
+        NumberOfFrames += other.NumberOfFrames;
+        NumberOfBytes += other.NumberOfBytes;
+        DecodingTime += other.DecodingTime;
+        TotalTime += other.TotalTime;
+        return *this;
+      }
+    };
+
     static const DICOMTag AcquisitionDateTag;
     static const DICOMTag AcquisitionTimeTag;
     static const DICOMTag TriggerTimeTag;
@@ -41,8 +80,16 @@ class ITKDICOMSeriesReaderHelper
 
     static bool CanHandleFile(const std::string& filename);
 
+    /** \brief Accumulated counters of all Load() and Load3DnT() calls of this instance. */
+    const LoadStatistics& GetLoadStatistics() const
+    {
+      return m_LoadStatistics;
+    }
+
   private:
 
+    LoadStatistics m_LoadStatistics;
+
     typedef std::vector<TimeBounds> TimeBoundsList;
     typedef itk::FixedArray<OFDateTime,2>  DateTimeBounds;
 
@@ -79,6 +126,20 @@ class ITKDICOMSeriesReaderHelper
     */
     static TimeGeometry::Pointer GenerateTimeGeometry(const BaseGeometry* templateGeometry, const TimeBoundsList& boundsList);
 
+    /** Determines size and geometry of the volume read from filenames exactly like
+     itk::ImageSeriesReader does, but without reading any pixel data.
+     The returned image has no buffer allocated. */
+    template <typename ImageType>
+    typename ImageType::Pointer
+    ReadVolumeInformation( const StringContainer& filenames, itk::GDCMImageIO::Pointer& io );
+
+    /** Decodes the i-th file into buffer + i * pixelsPerFile, using the ITK thread pool.
+     Files whose pixel type differs from PixelType (e.g. due to different rescale parameters)
+     are converted like itk::ImageSeriesReader does. */
+    template <typename PixelType>
+    void
+    DecodeFrames( const StringContainer& filenames, PixelType* buffer, std::size_t pixelsPerFile );
+
     template <typename ImageType>
     typename ImageType::Pointer
     FixUpTiltedGeometry( ImageType* input, const GantryTiltInformation& tiltInfo );
@@ -12,7 +12,10 @@ found in the LICENSE file.
 
 #include "mitkITKDICOMSeriesReaderHelper.h"
 
+#include <mitkImageWriteAccessor.h>
+
 #include <itkImageSeriesReader.h>
+#include <itkMultiThreaderBase.h>
 #include <itkResampleImageFilter.h>
 //#include <itkAffineTransform.h>
 //#include <itkLinearInterpolateImageFunction.h>
@@ -20,19 +23,15 @@ found in the LICENSE file.
 
 #include "dcmtk/ofstd/ofdatime.h"
 
-template <typename PixelType>
-mitk::Image::Pointer
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+template <typename ImageType>
+typename ImageType::Pointer
 mitk::ITKDICOMSeriesReaderHelper
-::LoadDICOMByITK(
-    const StringContainer& filenames,
-    bool correctTilt,
-    const GantryTiltInformation& tiltInfo,
-    itk::GDCMImageIO::Pointer& io)
+::ReadVolumeInformation( const StringContainer& filenames, itk::GDCMImageIO::Pointer& io )
 {
-  /******** Normal Case, 3D (also for GDCM < 2 usable) ***************/
-  mitk::Image::Pointer image = mitk::Image::New();
-
-  typedef itk::Image<PixelType, 3> ImageType;
   typedef itk::ImageSeriesReader<ImageType> ReaderType;
 
   io = itk::GDCMImageIO::New();
@@ -46,17 +45,126 @@ mitk::ITKDICOMSeriesReaderHelper
                              // see NormalDirectionConsistencySorter.
 
   reader->SetFileNames(filenames);
-  reader->Update();
-  typename ImageType::Pointer readVolume = reader->GetOutput();
+  reader->UpdateOutputInformation();
+
+  typename ImageType::Pointer volume = ImageType::New();
+  volume->CopyInformation(reader->GetOutput());
+  volume->SetRegions(reader->GetOutput()->GetLargestPossibleRegion());
+
+  return volume;
+}
+
+template <typename PixelType>
+void
+mitk::ITKDICOMSeriesReaderHelper
+::DecodeFrames( const StringContainer& filenames, PixelType* buffer, std::size_t pixelsPerFile )
+{
+  typedef itk::Image<PixelType, 3> FileImageType;
+  typedef typename itk::PixelTraits<PixelType>::ValueType ComponentType;
+
+  const auto startTime = std::chrono::steady_clock::now();
+
+  const auto expectedComponentType = itk::ImageIOBase::MapPixelType<ComponentType>::CType;
+  const unsigned int expectedNumberOfComponents = itk::PixelTraits<PixelType>::Dimension;
+  const std::size_t expectedSizeInBytes = pixelsPerFile * sizeof(PixelType);
+
+  std::vector<std::exception_ptr> errors(filenames.size());
+
+  itk::MultiThreaderBase::New()->ParallelizeArray(0, filenames.size(), [&](itk::SizeValueType i)
+  {
+    try
+    {
+      PixelType* destination = buffer + i * pixelsPerFile;
+
+      itk::GDCMImageIO::Pointer io = itk::GDCMImageIO::New();
+      io->SetFileName(filenames[i]);
+      io->ReadImageInformation();
+
+      if (io->GetComponentType() == expectedComponentType
+          && io->GetNumberOfComponents() == expectedNumberOfComponents
+          && static_cast<std::size_t>(io->GetImageSizeInBytes()) == expectedSizeInBytes)
+      {
+        // usual case: the (rescaled) pixel type of the file equals the pixel type of the volume
+        io->Read(destination);
+      }
+      else
+      {
+        // rescale parameters of this file lead to another pixel type, let ITK convert it
+        typename itk::ImageFileReader<FileImageType>::Pointer reader = itk::ImageFileReader<FileImageType>::New();
+        reader->SetImageIO(io);
+        reader->SetFileName(filenames[i]);
+        reader->Update();
+
+        if (reader->GetOutput()->GetBufferedRegion().GetNumberOfPixels() != pixelsPerFile)
+        {
+          mitkThrow() << "Size of file " << filenames[i] << " does not match the size of the first file of the series.";
+        }
+
+        std::copy_n(reader->GetOutput()->GetBufferPointer(), pixelsPerFile, destination);
+      }
+    }
+    catch (...)
+    {
+      errors[i] = std::current_exception();
+    }
+  }, nullptr);
+
+  for (const auto& error : errors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
+  m_LoadStatistics.NumberOfFrames += filenames.size();
+  m_LoadStatistics.NumberOfBytes += filenames.size() * expectedSizeInBytes;
+  m_LoadStatistics.DecodingTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+template <typename PixelType>
+mitk::Image::Pointer
+mitk::ITKDICOMSeriesReaderHelper
+::LoadDICOMByITK(
+    const StringContainer& filenames,
+    bool correctTilt,
+    const GantryTiltInformation& tiltInfo,
+    itk::GDCMImageIO::Pointer& io)
+{
+  /******** Normal Case, 3D (also for GDCM < 2 usable) ***************/
+  const auto startTime = std::chrono::steady_clock::now();
+
+  mitk::Image::Pointer image = mitk::Image::New();
+
+  typedef itk::Image<PixelType, 3> ImageType;
+
+  typename ImageType::Pointer readVolume = ReadVolumeInformation<ImageType>(filenames, io);
+
+  const std::size_t numberOfPixels = readVolume->GetLargestPossibleRegion().GetNumberOfPixels();
+  if (numberOfPixels % filenames.size() != 0)
+  {
+    mitkThrow() << "Error while loading DICOM series. Volume size " << numberOfPixels << " is no multiple of the number of files " << filenames.size();
+  }
+  const std::size_t pixelsPerFile = numberOfPixels / filenames.size();
 
   // if we detected that the images are from a tilted gantry acquisition, we need to push some pixels into the right position
   if (correctTilt)
   {
-    readVolume = FixUpTiltedGeometry( reader->GetOutput(), tiltInfo );
+    readVolume->Allocate();
+    DecodeFrames<PixelType>(filenames, readVolume->GetBufferPointer(), pixelsPerFile);
+
+    readVolume = FixUpTiltedGeometry( readVolume.GetPointer(), tiltInfo );
+
+    image->InitializeByItk(readVolume.GetPointer());
+    image->SetImportVolume(readVolume->GetBufferPointer());
   }
+  else
+  {
+    image->InitializeByItk(readVolume.GetPointer());
 
-  image->InitializeByItk(readVolume.GetPointer());
-  image->SetImportVolume(readVolume->GetBufferPointer());
+    mitk::ImageWriteAccessor accessor(image);
+    DecodeFrames<PixelType>(filenames, static_cast<PixelType*>(accessor.GetData()), pixelsPerFile);
+  }
 
 #ifdef MBILOG_ENABLE_DEBUG
 
@@ -69,6 +177,8 @@ mitk::ITKDICOMSeriesReaderHelper
                                     << image->GetGeometry()->GetSpacing()[2] << "]";
 #endif //MBILOG_ENABLE_DEBUG
 
+  m_LoadStatistics.TotalTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
   return image;
 }
 
@@ -89,6 +199,8 @@ mitk::ITKDICOMSeriesReaderHelper
     const GantryTiltInformation& tiltInfo,
     itk::GDCMImageIO::Pointer& io)
 {
+  const auto startTime = std::chrono::steady_clock::now();
+
   unsigned int numberOfTimeSteps = filenamesForTimeSteps.size();
 
   MITK_DEBUG << "Start extracting time bounds of time steps";
@@ -101,59 +213,69 @@ mitk::ITKDICOMSeriesReaderHelper
   mitk::Image::Pointer image = mitk::Image::New();
 
   typedef itk::Image<PixelType, 4> ImageType;
-  typedef itk::ImageSeriesReader<ImageType> ReaderType;
-
-  io = itk::GDCMImageIO::New();
-  typename ReaderType::Pointer reader = ReaderType::New();
-
-  reader->SetImageIO(io);
-  reader->ReverseOrderOff(); // at this point we require an order of input images so that
-                             // the direction between the origin of the first and the last slice
-                             // is the same direction as the image normals! Otherwise we might
-                             // see images upside down. Unclear whether this is a bug in MITK,
-                             // see NormalDirectionConsistencySorter.
-
-
-  unsigned int currentTimeStep = 0;
 
 #ifdef MBILOG_ENABLE_DEBUG
-  MITK_DEBUG << "Start loading timestep " << currentTimeStep;
-  MITK_DEBUG_OUTPUT_FILELIST( filenamesForTimeSteps.front() )
+  unsigned int currentTimeStep = 0;
+  for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
+  {
+    MITK_DEBUG << "Loading timestep " << currentTimeStep++;
+    MITK_DEBUG_OUTPUT_FILELIST( filenamesOfTimeStep )
+  }
 #endif // MBILOG_ENABLE_DEBUG
 
-  reader->SetFileNames(filenamesForTimeSteps.front());
-  reader->Update();
-  typename ImageType::Pointer readVolume = reader->GetOutput();
+  // all time steps share the geometry of the first one
+  const StringContainer& filenamesOfFirstTimeStep = filenamesForTimeSteps.front();
+  typename ImageType::Pointer readVolume = ReadVolumeInformation<ImageType>(filenamesOfFirstTimeStep, io);
 
-  // if we detected that the images are from a tilted gantry acquisition, we need to push some pixels into the right position
-  if (correctTilt)
+  const std::size_t pixelsPerTimeStep = readVolume->GetLargestPossibleRegion().GetNumberOfPixels();
+  if (pixelsPerTimeStep % filenamesOfFirstTimeStep.size() != 0)
   {
-    readVolume = FixUpTiltedGeometry( reader->GetOutput(), tiltInfo );
+    mitkThrow() << "Error while loading 3D+t. Volume size " << pixelsPerTimeStep << " is no multiple of the number of files " << filenamesOfFirstTimeStep.size();
   }
+  const std::size_t pixelsPerFile = pixelsPerTimeStep / filenamesOfFirstTimeStep.size();
 
-  image->InitializeByItk(readVolume.GetPointer(), 1, numberOfTimeSteps);
-  image->SetImportVolume(readVolume->GetBufferPointer(), currentTimeStep++); // timestep 0
+  for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
+  {
+    if (filenamesOfTimeStep.size() != filenamesOfFirstTimeStep.size())
+    {
+      mitkThrow() << "Error while loading 3D+t. Inconsistent number of files per time step: " << filenamesOfTimeStep.size() << " instead of " << filenamesOfFirstTimeStep.size();
+    }
+  }
 
-  // for other time-steps
-  for (auto timestepsIter = ++(filenamesForTimeSteps.cbegin()); // start with SECOND entry
-      timestepsIter != filenamesForTimeSteps.cend();
-      ++currentTimeStep, ++timestepsIter)
+  if (correctTilt)
   {
-#ifdef MBILOG_ENABLE_DEBUG
-    MITK_DEBUG << "Start loading timestep " << currentTimeStep;
-    MITK_DEBUG_OUTPUT_FILELIST( *timestepsIter )
-#endif // MBILOG_ENABLE_DEBUG
+    // tilt correction resamples each time step on its own
+    readVolume->Allocate();
+    const typename ImageType::Pointer decodedVolume = readVolume;
+
+    unsigned int currentTimeStep = 0;
+    for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
+    {
+      DecodeFrames<PixelType>(filenamesOfTimeStep, decodedVolume->GetBufferPointer(), pixelsPerFile);
+      readVolume = FixUpTiltedGeometry( decodedVolume.GetPointer(), tiltInfo );
 
-    reader->SetFileNames( *timestepsIter );
-    reader->Update();
-    readVolume = reader->GetOutput();
+      if (0 == currentTimeStep)
+      {
+        image->InitializeByItk(readVolume.GetPointer(), 1, numberOfTimeSteps);
+      }
 
-    if (correctTilt)
+      image->SetImportVolume(readVolume->GetBufferPointer(), currentTimeStep++);
+    }
+  }
+  else
+  {
+    // the volumes of all time steps are contiguous in the image buffer, so all frames are decoded in one go
+    image->InitializeByItk(readVolume.GetPointer(), 1, numberOfTimeSteps);
+
+    StringContainer allFilenames;
+    allFilenames.reserve(filenamesOfFirstTimeStep.size() * numberOfTimeSteps);
+    for (const auto& filenamesOfTimeStep : filenamesForTimeSteps)
     {
-      readVolume = FixUpTiltedGeometry( reader->GetOutput(), tiltInfo );
+      allFilenames.insert(allFilenames.end(), filenamesOfTimeStep.cbegin(), filenamesOfTimeStep.cend());
     }
 
-    image->SetImportVolume(readVolume->GetBufferPointer(), currentTimeStep);
+    mitk::ImageWriteAccessor accessor(image);
+    DecodeFrames<PixelType>(allFilenames, static_cast<PixelType*>(accessor.GetData()), pixelsPerFile);
   }
 
 #ifdef MBILOG_ENABLE_DEBUG
@@ -169,6 +291,9 @@ mitk::ITKDICOMSeriesReaderHelper
   //construct timegeometry
   TimeGeometry::Pointer timeGeometry = GenerateTimeGeometry(image->GetGeometry(),timeBoundsList);
   image->SetTimeGeometry(timeGeometry);
+
+  m_LoadStatistics.TotalTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
   return image;
 }
 
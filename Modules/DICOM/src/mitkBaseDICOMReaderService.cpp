@@ -21,6 +21,7 @@ found in the LICENSE file.
 #include <mitkDICOMProperty.h>
 #include "legacy/mitkDicomSeriesReader.h"
 #include <mitkDICOMDCMTKTagScanner.h>
+#include <mitkDICOMTagScanIndex.h>
 #include <mitkLocaleSwitch.h>
 #include "mitkIPropertyProvider.h"
 #include "mitkPropertyNameHelper.h"
@@ -28,11 +29,18 @@ found in the LICENSE file.
 #include "mitkDICOMIOMetaInformationPropertyConstants.h"
 
 #include <iostream>
+#include <mutex>
 
 
 #include <itksys/SystemTools.hxx>
 #include <itksys/Directory.hxx>
 
+namespace
+{
+  std::mutex TagScanIndexMutex;
+  std::string TagScanIndexFileName;
+}
+
 namespace mitk
 {
 
@@ -56,6 +64,18 @@ bool BaseDICOMReaderService::GetOnlyRegardOwnSeries() const
   return m_OnlyRegardOwnSeries;
 }
 
+void BaseDICOMReaderService::SetTagScanIndexFileName(const std::string& fileName)
+{
+  std::lock_guard<std::mutex> lock(TagScanIndexMutex);
+  TagScanIndexFileName = fileName;
+}
+
+std::string BaseDICOMReaderService::GetTagScanIndexFileName()
+{
+  std::lock_guard<std::mutex> lock(TagScanIndexMutex);
+  return TagScanIndexFileName;
+}
+
 
 std::vector<itk::SmartPointer<BaseData> > BaseDICOMReaderService::DoRead()
 {
@@ -142,8 +162,34 @@ std::vector<itk::SmartPointer<BaseData> > BaseDICOMReaderService::DoRead()
           mitk::DICOMDCMTKTagScanner::Pointer scanner = mitk::DICOMDCMTKTagScanner::New();
           scanner->AddTagPaths(reader->GetTagsOfInterest());
           scanner->SetInputFiles(relevantFiles);
+
+          const std::string tagScanIndexFileName = GetTagScanIndexFileName();
+          mitk::DICOMTagScanIndex::Pointer scanIndex;
+
+          if (!tagScanIndexFileName.empty())
+          {
+            scanIndex = mitk::DICOMTagScanIndex::New();
+            scanIndex->Load(tagScanIndexFileName);
+            scanner->SetScanIndex(scanIndex);
+          }
+
           scanner->Scan();
 
+          if (scanIndex.IsNotNull())
+          {
+            MITK_DEBUG << scanner->GetNumberOfFilesTakenFromIndex() << " of " << relevantFiles.size()
+                       << " files taken from tag scan index " << tagScanIndexFileName;
+
+            try
+            {
+              scanIndex->Save(tagScanIndexFileName);
+            }
+            catch (const mitk::Exception& e)
+            {
+              MITK_WARN << "Could not update tag scan index: " << e.GetDescription();
+            }
+          }
+
           reader->SetTagCache(scanner->GetScanCache());
           reader->AnalyzeInputFiles();
           reader->LoadImages();
@@ -13,10 +13,18 @@ found in the LICENSE file.
 #include "mitkDICOMDCMTKTagScanner.h"
 #include "mitkDICOMGenericImageFrameInfo.h"
 
+#include <dcmtk/dcmdata/dcdeftag.h>
 #include <dcmtk/dcmdata/dcfilefo.h>
 #include <dcmtk/dcmdata/dcpath.h>
 
+#include <itkMultiThreaderBase.h>
+
+#include <exception>
+
 mitk::DICOMDCMTKTagScanner::DICOMDCMTKTagScanner()
+  : m_StopBeforePixelData(false),
+    m_NumberOfThreads(1),
+    m_NumberOfFilesTakenFromIndex(0)
 {
 }
 
@@ -55,6 +63,20 @@ void mitk::DICOMDCMTKTagScanner::SetInputFiles( const StringList& filenames )
   m_InputFilenames = filenames;
 }
 
+void mitk::DICOMDCMTKTagScanner::SetScanIndex(DICOMTagScanIndex* index)
+{
+  if (m_ScanIndex != index)
+  {
+    m_ScanIndex = index;
+    this->Modified();
+  }
+}
+
+mitk::DICOMTagScanIndex* mitk::DICOMDCMTKTagScanner::GetScanIndex() const
+{
+  return m_ScanIndex;
+}
+
 mitk::DICOMTagPath DcmPathToTagPath(DcmPath * dcmpath)
 {
   mitk::DICOMTagPath result;
@@ -98,63 +120,151 @@ mitk::DICOMTagPath DcmPathToTagPath(DcmPath * dcmpath)
   return result;
 }
 
+namespace
+{
+  /** Parses a single file and collects the values of all scanned tag paths. */
+  bool ScanFile(const std::string& fileName, const std::set<mitk::DICOMTagPath>& scannedTags, bool stopBeforePixelData,
+    DcmPathProcessor& processor, mitk::DICOMTagScanIndex::TagValueList& values)
+  {
+    DcmFileFormat dfile;
+    OFCondition cond = stopBeforePixelData
+      ? dfile.loadFileUntilTag(fileName.c_str(), EXS_Unknown, EGL_noChange, DCM_MaxReadLength, ERM_autoDetect, DCM_PixelData)
+      : dfile.loadFile(fileName.c_str());
+
+    if (cond.bad())
+      return false;
+
+    for (const auto& path : scannedTags)
+    {
+      std::string tagPath = mitk::DICOMTagPathToDCMTKSearchPath(path);
+      cond = processor.findOrCreatePath(dfile.getDataset(), tagPath.c_str());
+      if (cond.good())
+      {
+        OFList< DcmPath * > findings;
+        processor.getResults(findings);
+        for (const auto& finding : findings)
+        {
+          auto element = dynamic_cast<DcmElement*>(finding->back()->m_obj);
+          if (!element)
+          {
+            auto item = dynamic_cast<DcmItem*>(finding->back()->m_obj);
+            if (item)
+            {
+              element = item->getElement(finding->back()->m_itemNo);
+            }
+          }
+
+          if (element)
+          {
+            OFString value;
+            cond = element->getOFStringArray(value);
+            if (cond.good())
+            {
+              values.emplace_back(DcmPathToTagPath(finding), std::string(value.c_str()));
+            }
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+}
+
 void mitk::DICOMDCMTKTagScanner::Scan()
 {
   this->PushLocale();
 
   try
   {
-    DcmPathProcessor processor;
-    processor.setItemWildcardSupport(true);
+    const auto numberOfFiles = this->m_InputFilenames.size();
 
-    DICOMGenericTagCache::Pointer newCache = DICOMGenericTagCache::New();
+    std::vector<DICOMTagScanIndex::TagValueList> values(numberOfFiles);
+    std::vector<char> scanned(numberOfFiles, 0);
+    std::vector<char> takenFromIndex(numberOfFiles, 0);
+    std::vector<std::exception_ptr> errors(numberOfFiles);
+
+    if (m_ScanIndex.IsNotNull())
+      m_ScanIndex->SetScannedTagPaths(m_ScannedTags);
 
-    for (const auto& fileName : this->m_InputFilenames)
+    auto scanFile = [&](std::size_t i, DcmPathProcessor& processor)
     {
-      DcmFileFormat dfile;
-      OFCondition cond = dfile.loadFile(fileName.c_str());
-      if (cond.bad())
+      const auto& fileName = this->m_InputFilenames[i];
+
+      try
       {
-        MITK_ERROR << "Error when scanning for tags. Cannot open given file. File: " << fileName;
+        if (m_ScanIndex.IsNotNull() && m_ScanIndex->Lookup(fileName, values[i]))
+        {
+          scanned[i] = 1;
+          takenFromIndex[i] = 1;
+        }
+        else if (ScanFile(fileName, this->m_ScannedTags, m_StopBeforePixelData, processor, values[i]))
+        {
+          scanned[i] = 1;
+
+          if (m_ScanIndex.IsNotNull())
+            m_ScanIndex->Insert(fileName, values[i]);
+        }
       }
-      else
+      catch (...)
       {
-        DICOMGenericImageFrameInfo::Pointer info = DICOMGenericImageFrameInfo::New(fileName);
+        errors[i] = std::current_exception();
+      }
+    };
 
-        for (const auto& path : this->m_ScannedTags)
-        {
-          std::string tagPath = DICOMTagPathToDCMTKSearchPath(path);
-          cond = processor.findOrCreatePath(dfile.getDataset(), tagPath.c_str());
-          if (cond.good())
-          {
-            OFList< DcmPath * > findings;
-            processor.getResults(findings);
-            for (const auto& finding : findings)
-            {
-              auto element = dynamic_cast<DcmElement*>(finding->back()->m_obj);
-              if (!element)
-              {
-                auto item = dynamic_cast<DcmItem*>(finding->back()->m_obj);
-                if (item)
-                {
-                  element = item->getElement(finding->back()->m_itemNo);
-                }
-              }
-
-              if (element)
-              {
-                OFString value;
-                cond = element->getOFStringArray(value);
-                if (cond.good())
-                {
-                  info->SetTagValue(DcmPathToTagPath(finding), std::string(value.c_str()));
-                }
-              }
-            }
-          }
-        }
-        newCache->AddFrameInfo(info);
+    if (1 == m_NumberOfThreads || numberOfFiles < 2)
+    {
+      DcmPathProcessor processor;
+      processor.setItemWildcardSupport(true);
+
+      for (std::size_t i = 0; i < numberOfFiles; ++i)
+        scanFile(i, processor);
+    }
+    else
+    {
+      auto multiThreader = itk::MultiThreaderBase::New();
+
+      if (0 != m_NumberOfThreads)
+      {
+        multiThreader->SetMaximumNumberOfThreads(m_NumberOfThreads);
+        multiThreader->SetNumberOfWorkUnits(m_NumberOfThreads);
+      }
+
+      multiThreader->ParallelizeArray(0, numberOfFiles, [&scanFile](itk::SizeValueType i)
+      {
+        // DcmPathProcessor keeps the results of the last search and must not be shared between threads.
+        DcmPathProcessor processor;
+        processor.setItemWildcardSupport(true);
+        scanFile(i, processor);
+      }, nullptr);
+    }
+
+    // Assemble the cache in input order, independent of the order in which the files were scanned.
+    DICOMGenericTagCache::Pointer newCache = DICOMGenericTagCache::New();
+    m_NumberOfFilesTakenFromIndex = 0;
+
+    for (std::size_t i = 0; i < numberOfFiles; ++i)
+    {
+      if (errors[i])
+        std::rethrow_exception(errors[i]);
+
+      const auto& fileName = this->m_InputFilenames[i];
+
+      if (!scanned[i])
+      {
+        MITK_ERROR << "Error when scanning for tags. Cannot open given file. File: " << fileName;
+        continue;
       }
+
+      DICOMGenericImageFrameInfo::Pointer info = DICOMGenericImageFrameInfo::New(fileName);
+
+      for (const auto& [path, value] : values[i])
+        info->SetTagValue(path, value);
+
+      newCache->AddFrameInfo(info);
+
+      if (takenFromIndex[i])
+        ++m_NumberOfFilesTakenFromIndex;
     }
 
     m_Cache = newCache;
@@ -20,6 +20,7 @@ found in the LICENSE file.
 #include "mitkGantryTiltInformation.h"
 #include "mitkDICOMTagBasedSorter.h"
 #include "mitkDICOMGDCMTagScanner.h"
+#include "mitkDICOMDCMTKTagScanner.h"
 
 std::mutex mitk::DICOMITKSeriesGDCMReader::s_LocaleMutex;
 
@@ -47,6 +48,7 @@ mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( const DICOMITKSeriesGD
 , m_DecimalPlacesForOrientation( other.m_DecimalPlacesForOrientation )
 , m_TagCache( other.m_TagCache )
 , m_ExternalCache(other.m_ExternalCache)
+, m_TagScanIndexFileName(other.m_TagScanIndexFileName)
 {
 }
 
@@ -69,6 +71,7 @@ mitk::DICOMITKSeriesGDCMReader& mitk::DICOMITKSeriesGDCMReader::
     this->m_ReplacedCinLocales               = other.m_ReplacedCinLocales;
     this->m_DecimalPlacesForOrientation      = other.m_DecimalPlacesForOrientation;
     this->m_TagCache                         = other.m_TagCache;
+    this->m_TagScanIndexFileName             = other.m_TagScanIndexFileName;
   }
   return *this;
 }
@@ -233,16 +236,50 @@ void mitk::DICOMITKSeriesGDCMReader::AnalyzeInputFiles()
   if ( m_TagCache.IsNull() || ( m_TagCache->GetMTime()<this->GetMTime() && !m_ExternalCache ))
   {
     timeStart( "Tag scanning" );
-    DICOMGDCMTagScanner::Pointer filescanner = DICOMGDCMTagScanner::New();
+    if ( !m_TagScanIndexFileName.empty() )
+    {
+      DICOMTagScanIndex::Pointer scanIndex = DICOMTagScanIndex::New();
+      scanIndex->Load( m_TagScanIndexFileName );
+
+      DICOMDCMTKTagScanner::Pointer filescanner = DICOMDCMTKTagScanner::New();
+
+      filescanner->SetInputFiles( inputFilenames );
+      filescanner->AddTagPaths( this->GetTagsOfInterest() );
+      filescanner->StopBeforePixelDataOn();
+      filescanner->SetNumberOfThreads( 0 );
+      filescanner->SetScanIndex( scanIndex );
+
+      PushLocale();
+      filescanner->Scan();
+      PopLocale();
+
+      MITK_DEBUG << filescanner->GetNumberOfFilesTakenFromIndex() << " of " << inputFilenames.size()
+                 << " files taken from tag scan index " << m_TagScanIndexFileName;
+
+      try
+      {
+        scanIndex->Save( m_TagScanIndexFileName );
+      }
+      catch ( const mitk::Exception& e )
+      {
+        MITK_WARN << "Could not update tag scan index: " << e.GetDescription();
+      }
+
+      m_TagCache = filescanner->GetScanCache(); // keep alive and make accessible to sub-classes
+    }
+    else
+    {
+      DICOMGDCMTagScanner::Pointer filescanner = DICOMGDCMTagScanner::New();
 
-    filescanner->SetInputFiles( inputFilenames );
-    filescanner->AddTagPaths( this->GetTagsOfInterest() );
+      filescanner->SetInputFiles( inputFilenames );
+      filescanner->AddTagPaths( this->GetTagsOfInterest() );
 
-    PushLocale();
-    filescanner->Scan();
-    PopLocale();
+      PushLocale();
+      filescanner->Scan();
+      PopLocale();
 
-    m_TagCache = filescanner->GetScanCache(); // keep alive and make accessible to sub-classes
+      m_TagCache = filescanner->GetScanCache(); // keep alive and make accessible to sub-classes
+    }
 
     timeStop("Tag scanning");
   }
@@ -452,6 +489,11 @@ bool mitk::DICOMITKSeriesGDCMReader::LoadMitkImageForImageBlockDescriptor(
   {
     mitk::Image::Pointer mitkImage = helper.Load( filenames, m_FixTiltByShearing && hasTilt, tiltInfo );
     block.SetMitkImage( mitkImage );
+
+    const ITKDICOMSeriesReaderHelper::LoadStatistics& statistics = helper.GetLoadStatistics();
+    MITK_DEBUG << "Loaded " << statistics.NumberOfFrames << " frames in " << statistics.TotalTime << " s ("
+               << statistics.GetFramesPerSecond() << " frames/s, " << statistics.GetMegabytesPerSecond() << " MB/s)";
+    m_LoadStatistics += statistics;
   }
   catch ( const std::exception& e )
   {
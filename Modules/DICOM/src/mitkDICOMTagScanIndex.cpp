@@ -0,0 +1,389 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkDICOMTagScanIndex.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkLogMacros.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+  const std::string IndexFileSignature = "MITK DICOM tag scan index 2";
+
+  /** Escapes line breaks, tabs and backslashes so that every string occupies a single line field. */
+  std::string Escape(const std::string& str)
+  {
+    std::string result;
+    result.reserve(str.size());
+
+    for (const auto c : str)
+    {
+      switch (c)
+      {
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default: result += c;
+      }
+    }
+
+    return result;
+  }
+
+  std::string Unescape(const std::string& str)
+  {
+    std::string result;
+    result.reserve(str.size());
+
+    for (std::string::size_type i = 0; i < str.size(); ++i)
+    {
+      if ('\\' == str[i] && i + 1 < str.size())
+      {
+        switch (str[++i])
+        {
+          case 'n': result += '\n'; break;
+          case 'r': result += '\r'; break;
+          case 't': result += '\t'; break;
+          default: result += str[i];
+        }
+      }
+      else
+      {
+        result += str[i];
+      }
+    }
+
+    return result;
+  }
+
+  /** Lossless string representation of a tag path: "type,group,element,selection" per node, separated by slashes. */
+  std::string EncodeTagPath(const mitk::DICOMTagPath& path)
+  {
+    std::ostringstream stream;
+    bool first = true;
+
+    for (const auto& node : path.GetNodes())
+    {
+      if (!first)
+        stream << '/';
+
+      first = false;
+
+      stream << static_cast<int>(node.type) << ',' << node.tag.GetGroup() << ',' << node.tag.GetElement() << ',' << node.selection;
+    }
+
+    return stream.str();
+  }
+
+  mitk::DICOMTagPath DecodeTagPath(const std::string& str)
+  {
+    mitk::DICOMTagPath path;
+    std::istringstream stream(str);
+    std::string nodeStr;
+
+    while (std::getline(stream, nodeStr, '/'))
+    {
+      std::istringstream nodeStream(nodeStr);
+      int type = 0;
+      unsigned int group = 0;
+      unsigned int element = 0;
+      mitk::DICOMTagPath::ItemSelectionIndex selection = 0;
+      char separator;
+
+      if (!(nodeStream >> type >> separator >> group >> separator >> element >> separator >> selection))
+        mitkThrow() << "Invalid tag path in DICOM tag scan index: " << str;
+
+      path.AddNode(mitk::DICOMTagPath::NodeInfo(mitk::DICOMTag(group, element), static_cast<mitk::DICOMTagPath::NodeInfo::NodeType>(type), selection));
+    }
+
+    return path;
+  }
+
+  bool GetFileStatistics(const std::string& filename, long int& modifiedTime, unsigned long& fileSize)
+  {
+    if (!itksys::SystemTools::FileExists(filename, true))
+      return false;
+
+    modifiedTime = itksys::SystemTools::ModifiedTime(filename);
+    fileSize = itksys::SystemTools::FileLength(filename);
+
+    return true;
+  }
+}
+
+mitk::DICOMTagScanIndex::DICOMTagScanIndex()
+  : m_UseCounter(0),
+    m_MaximumNumberOfEntries(100000)
+{
+}
+
+mitk::DICOMTagScanIndex::~DICOMTagScanIndex()
+{
+}
+
+bool mitk::DICOMTagScanIndex::Load(const std::string& indexFilename)
+{
+  this->Clear();
+
+  std::ifstream file(indexFilename, std::ios::binary);
+
+  if (!file.is_open())
+    return false;
+
+  EntryMapType entries;
+  std::set<std::string> scannedTagPaths;
+  std::uint64_t useCounter = 0;
+
+  try
+  {
+    std::string line;
+
+    if (!std::getline(file, line) || IndexFileSignature != line)
+      mitkThrow() << "Missing file signature.";
+
+    std::string keyword;
+    std::size_t count = 0;
+
+    if (!(file >> keyword >> count) || "tags" != keyword)
+      mitkThrow() << "Missing tag section.";
+
+    std::getline(file, line);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      if (!std::getline(file, line))
+        mitkThrow() << "Unexpected end of tag section.";
+
+      scannedTagPaths.insert(line);
+    }
+
+    if (!(file >> keyword >> count) || "files" != keyword)
+      mitkThrow() << "Missing file section.";
+
+    std::getline(file, line);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      std::string filename;
+
+      if (!std::getline(file, filename))
+        mitkThrow() << "Unexpected end of file section.";
+
+      Entry entry;
+      std::size_t numberOfValues = 0;
+
+      if (!(file >> entry.ModifiedTime >> entry.FileSize >> entry.LastUsed >> numberOfValues))
+        mitkThrow() << "Invalid file entry.";
+
+      useCounter = std::max(useCounter, entry.LastUsed);
+
+      std::getline(file, line);
+
+      for (std::size_t j = 0; j < numberOfValues; ++j)
+      {
+        if (!std::getline(file, line))
+          mitkThrow() << "Unexpected end of file entry.";
+
+        const auto separator = line.find('\t');
+
+        if (std::string::npos == separator)
+          mitkThrow() << "Invalid tag value.";
+
+        entry.Values.emplace_back(DecodeTagPath(line.substr(0, separator)), Unescape(line.substr(separator + 1)));
+      }
+
+      entries[Unescape(filename)] = entry;
+    }
+  }
+  catch (const mitk::Exception& e)
+  {
+    MITK_WARN << "Ignoring invalid DICOM tag scan index " << indexFilename << ": " << e.GetDescription();
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.swap(entries);
+  m_ScannedTagPaths.swap(scannedTagPaths);
+  m_UseCounter = useCounter;
+  this->EvictEntries();
+
+  return true;
+}
+
+void mitk::DICOMTagScanIndex::Save(const std::string& indexFilename) const
+{
+  // Write to a temporary file first so that an interrupted save never leaves a truncated index behind.
+  const std::string temporaryFilename = indexFilename + ".tmp";
+
+  {
+    std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+      mitkThrow() << "Cannot open DICOM tag scan index for writing: " << temporaryFilename;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    file << IndexFileSignature << '\n';
+    file << "tags " << m_ScannedTagPaths.size() << '\n';
+
+    for (const auto& tagPath : m_ScannedTagPaths)
+      file << tagPath << '\n';
+
+    file << "files " << m_Entries.size() << '\n';
+
+    for (const auto& [filename, entry] : m_Entries)
+    {
+      file << Escape(filename) << '\n';
+      file << entry.ModifiedTime << ' ' << entry.FileSize << ' ' << entry.LastUsed << ' ' << entry.Values.size() << '\n';
+
+      for (const auto& [path, value] : entry.Values)
+        file << EncodeTagPath(path) << '\t' << Escape(value) << '\n';
+    }
+
+    if (!file.good())
+      mitkThrow() << "Error while writing DICOM tag scan index: " << temporaryFilename;
+  }
+
+  if (!itksys::SystemTools::RenameFile(temporaryFilename, indexFilename))
+    mitkThrow() << "Cannot replace DICOM tag scan index: " << indexFilename;
+}
+
+void mitk::DICOMTagScanIndex::SetScannedTagPaths(const std::set<DICOMTagPath>& tagPaths)
+{
+  std::set<std::string> encodedTagPaths;
+
+  for (const auto& tagPath : tagPaths)
+    encodedTagPaths.insert(EncodeTagPath(tagPath));
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  // Entries of a superset cannot be kept for a subset either: entries inserted
+  // for the subset would lack values if the superset is requested again.
+  if (m_ScannedTagPaths != encodedTagPaths)
+  {
+    m_Entries.clear();
+    m_ScannedTagPaths.swap(encodedTagPaths);
+    this->Modified();
+  }
+}
+
+bool mitk::DICOMTagScanIndex::Lookup(const std::string& filename, TagValueList& values)
+{
+  long int modifiedTime = 0;
+  unsigned long fileSize = 0;
+
+  const bool fileExists = GetFileStatistics(filename, modifiedTime, fileSize);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  auto finding = m_Entries.find(filename);
+
+  if (m_Entries.end() == finding)
+    return false;
+
+  if (!fileExists || finding->second.ModifiedTime != modifiedTime || finding->second.FileSize != fileSize)
+  {
+    m_Entries.erase(finding);
+    return false;
+  }
+
+  finding->second.LastUsed = ++m_UseCounter;
+  values = finding->second.Values;
+  return true;
+}
+
+void mitk::DICOMTagScanIndex::Insert(const std::string& filename, const TagValueList& values)
+{
+  Entry entry;
+
+  if (!GetFileStatistics(filename, entry.ModifiedTime, entry.FileSize))
+    return;
+
+  entry.Values = values;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  entry.LastUsed = ++m_UseCounter;
+  m_Entries[filename] = std::move(entry);
+  this->EvictEntries();
+}
+
+std::size_t mitk::DICOMTagScanIndex::GetNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+void mitk::DICOMTagScanIndex::SetMaximumNumberOfEntries(std::size_t maximumNumberOfEntries)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (m_MaximumNumberOfEntries != maximumNumberOfEntries)
+  {
+    m_MaximumNumberOfEntries = maximumNumberOfEntries;
+    this->EvictEntries();
+    this->Modified();
+  }
+}
+
+std::size_t mitk::DICOMTagScanIndex::GetMaximumNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumNumberOfEntries;
+}
+
+void mitk::DICOMTagScanIndex::EvictEntries()
+{
+  if (0 == m_MaximumNumberOfEntries || m_Entries.size() <= m_MaximumNumberOfEntries)
+    return;
+
+  // Evict down to 90 % of the maximum, so that a scan adding many files does
+  // not search for the least recently used entries on every insertion.
+  const std::size_t numberOfRemainingEntries = m_MaximumNumberOfEntries - m_MaximumNumberOfEntries / 10;
+  const std::size_t numberOfEvictedEntries = m_Entries.size() - numberOfRemainingEntries;
+
+  std::vector<std::uint64_t> lastUsed;
+  lastUsed.reserve(m_Entries.size());
+
+  for (const auto& entry : m_Entries)
+    lastUsed.push_back(entry.second.LastUsed);
+
+  std::nth_element(lastUsed.begin(), lastUsed.begin() + numberOfEvictedEntries, lastUsed.end());
+  const auto threshold = lastUsed[numberOfEvictedEntries];
+
+  for (auto iter = m_Entries.begin(); iter != m_Entries.end();)
+  {
+    if (iter->second.LastUsed < threshold)
+    {
+      iter = m_Entries.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+}
+
+void mitk::DICOMTagScanIndex::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_ScannedTagPaths.clear();
+  m_UseCounter = 0;
+}
@@ -258,6 +258,11 @@ mitk::ThreeDnTDICOMSeriesReader
 
   block.SetMitkImage( mitkImage );
 
+  const ITKDICOMSeriesReaderHelper::LoadStatistics& statistics = helper.GetLoadStatistics();
+  MITK_DEBUG << "Loaded " << statistics.NumberOfFrames << " frames in " << statistics.TotalTime << " s ("
+             << statistics.GetFramesPerSecond() << " frames/s, " << statistics.GetMegabytesPerSecond() << " MB/s)";
+  m_LoadStatistics += statistics;
+
   PopLocale();
 
   return true;
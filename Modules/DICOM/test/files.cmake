@@ -1,6 +1,8 @@
 set(MODULE_TESTS
   mitkDICOMReaderConfiguratorTest.cpp
   mitkDICOMDCMTKTagScannerTest.cpp
+  mitkDICOMTagScanIndexTest.cpp
+  mitkITKDICOMSeriesReaderHelperTest.cpp
   mitkDICOMSimpleVolumeImportTest.cpp
   mitkDICOMTagPathTest.cpp
   mitkDICOMPropertyTest.cpp
@@ -11,6 +13,12 @@ set(MODULE_CUSTOM_TESTS
   mitkDICOMITKSeriesGDCMReaderBasicsTest.cpp
 )
 
+# Benchmarks are built into the test driver, but not registered with ctest.
+# Run them explicitly, e.g. MitkDICOMTestDriver mitkDICOMTagScanIndexBenchmarkTest
+set(MODULE_CUSTOM_TESTS ${MODULE_CUSTOM_TESTS}
+  mitkDICOMTagScanIndexBenchmarkTest.cpp
+)
+
 set(CPP_FILES
   mitkDICOMNullFileReader.cpp
   mitkDICOMFilenameSorter.cpp
@@ -0,0 +1,167 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Benchmark, not part of the ctest set. Run it explicitly:
+//   MitkDICOMTestDriver mitkDICOMTagScanIndexBenchmarkTest
+
+#include "mitkDICOMDCMTKTagScanner.h"
+#include "mitkDICOMTagScanIndex.h"
+
+#include "mitkIOUtil.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <dcmtk/dcmdata/dcdeftag.h>
+#include <dcmtk/dcmdata/dcfilefo.h>
+#include <dcmtk/dcmdata/dcuid.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <chrono>
+
+class mitkDICOMTagScanIndexBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMTagScanIndexBenchmarkTestSuite);
+  MITK_TEST(Benchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  std::string m_Directory;
+  mitk::StringList m_Files;
+  mitk::DICOMTagPathList m_TagPaths;
+
+  /** Writes a synthetic CT slice like mitkDICOMTagScanIndexTest does. */
+  void WriteSlice(const std::string& fileName, unsigned int series, unsigned int slice, unsigned int size)
+  {
+    const std::string uidRoot = "1.2.826.0.1.3680043.2.1125.7.";
+
+    DcmFileFormat fileFormat;
+    DcmDataset* dataset = fileFormat.getDataset();
+
+    dataset->putAndInsertString(DCM_SOPClassUID, UID_CTImageStorage);
+    dataset->putAndInsertString(DCM_SOPInstanceUID, (uidRoot + "3." + std::to_string(series) + "." + std::to_string(slice)).c_str());
+    dataset->putAndInsertString(DCM_StudyInstanceUID, (uidRoot + "1").c_str());
+    dataset->putAndInsertString(DCM_SeriesInstanceUID, (uidRoot + "2." + std::to_string(series)).c_str());
+    dataset->putAndInsertString(DCM_FrameOfReferenceUID, (uidRoot + "4").c_str());
+    dataset->putAndInsertString(DCM_Modality, "CT");
+    dataset->putAndInsertString(DCM_PatientName, "Synthetic^Patient");
+    dataset->putAndInsertString(DCM_InstanceNumber, std::to_string(slice + 1).c_str());
+    dataset->putAndInsertString(DCM_ImagePositionPatient, ("0\\0\\" + std::to_string(slice * 2.5)).c_str());
+    dataset->putAndInsertString(DCM_ImageOrientationPatient, "1\\0\\0\\0\\1\\0");
+    dataset->putAndInsertString(DCM_PixelSpacing, "0.5\\0.5");
+    dataset->putAndInsertString(DCM_SliceThickness, "2.5");
+    dataset->putAndInsertUint16(DCM_SamplesPerPixel, 1);
+    dataset->putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+    dataset->putAndInsertUint16(DCM_Rows, size);
+    dataset->putAndInsertUint16(DCM_Columns, size);
+    dataset->putAndInsertUint16(DCM_BitsAllocated, 16);
+    dataset->putAndInsertUint16(DCM_BitsStored, 16);
+    dataset->putAndInsertUint16(DCM_HighBit, 15);
+    dataset->putAndInsertUint16(DCM_PixelRepresentation, 0);
+
+    std::vector<Uint16> pixels(size * size);
+    for (std::size_t i = 0; i < pixels.size(); ++i)
+      pixels[i] = static_cast<Uint16>((i + slice * 7) % 4096);
+
+    dataset->putAndInsertUint16Array(DCM_PixelData, pixels.data(), static_cast<unsigned long>(pixels.size()));
+
+    CPPUNIT_ASSERT_MESSAGE("Writing synthetic DICOM file " + fileName, fileFormat.saveFile(fileName.c_str(), EXS_LittleEndianExplicit).good());
+  }
+
+  mitk::DICOMDCMTKTagScanner::Pointer CreateScanner(bool stopBeforePixelData, unsigned int numberOfThreads, mitk::DICOMTagScanIndex* index = nullptr)
+  {
+    auto scanner = mitk::DICOMDCMTKTagScanner::New();
+    scanner->SetInputFiles(m_Files);
+    scanner->AddTagPaths(m_TagPaths);
+    scanner->SetStopBeforePixelData(stopBeforePixelData);
+    scanner->SetNumberOfThreads(numberOfThreads);
+    scanner->SetScanIndex(index);
+    return scanner;
+  }
+
+  static double Milliseconds(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Directory = mitk::IOUtil::CreateTemporaryDirectory("mitkDICOMTagScanIndexBenchmarkTest_XXXXXX");
+
+    m_TagPaths.clear();
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0010, 0x0010)); // patient name
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0020, 0x000e)); // series instance uid
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0020, 0x0032)); // image position patient
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0020, 0x0037)); // image orientation patient
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0028, 0x0030)); // pixel spacing
+
+    m_Files.clear();
+
+    for (unsigned int series = 0; series < 4; ++series)
+    {
+      const std::string seriesDirectory = m_Directory + "/series" + std::to_string(series);
+      itksys::SystemTools::MakeDirectory(seriesDirectory);
+
+      for (unsigned int slice = 0; slice < 60; ++slice)
+      {
+        const std::string fileName = seriesDirectory + "/slice" + std::to_string(slice) + ".dcm";
+        this->WriteSlice(fileName, series, slice, 256);
+        m_Files.push_back(fileName);
+      }
+    }
+  }
+
+  void tearDown() override
+  {
+    itksys::SystemTools::RemoveADirectory(m_Directory);
+  }
+
+  void Benchmark()
+  {
+    auto start = std::chrono::steady_clock::now();
+    this->CreateScanner(false, 1)->Scan();
+    const auto fullSerialTime = Milliseconds(start);
+
+    start = std::chrono::steady_clock::now();
+    this->CreateScanner(true, 1)->Scan();
+    const auto headerSerialTime = Milliseconds(start);
+
+    // Cold: the index is empty and filled by the scan, then written to disk.
+    const std::string indexFileName = m_Directory + "/benchmark.index";
+    auto index = mitk::DICOMTagScanIndex::New();
+
+    start = std::chrono::steady_clock::now();
+    this->CreateScanner(true, 0, index)->Scan();
+    index->Save(indexFileName);
+    const auto coldTime = Milliseconds(start);
+
+    // Warm: the index is read from disk and serves all files.
+    auto loadedIndex = mitk::DICOMTagScanIndex::New();
+
+    start = std::chrono::steady_clock::now();
+    CPPUNIT_ASSERT(loadedIndex->Load(indexFileName));
+    auto indexedScanner = this->CreateScanner(true, 0, loadedIndex);
+    indexedScanner->Scan();
+    const auto warmTime = Milliseconds(start);
+
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), indexedScanner->GetNumberOfFilesTakenFromIndex());
+
+    MITK_INFO << "Tag scanning of " << m_Files.size() << " files: full parse " << fullSerialTime << " ms, header only "
+              << headerSerialTime << " ms, cold index (header only on thread pool, saving the index) " << coldTime
+              << " ms, warm index (loading the index) " << warmTime << " ms";
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMTagScanIndexBenchmark)
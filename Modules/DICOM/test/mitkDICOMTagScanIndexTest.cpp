@@ -0,0 +1,376 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkDICOMDCMTKTagScanner.h"
+#include "mitkDICOMITKSeriesGDCMReader.h"
+#include "mitkDICOMTagScanIndex.h"
+
+#include "mitkIOUtil.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <dcmtk/dcmdata/dcdeftag.h>
+#include <dcmtk/dcmdata/dcfilefo.h>
+#include <dcmtk/dcmdata/dcuid.h>
+
+#include <itksys/SystemTools.hxx>
+
+class mitkDICOMTagScanIndexTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMTagScanIndexTestSuite);
+
+  MITK_TEST(HeaderOnlyParallelScan_EqualsFullScan);
+  MITK_TEST(ScanIndex_SkipsUnchangedFiles);
+  MITK_TEST(ScanIndex_SaveAndLoad);
+  MITK_TEST(ScanIndex_DiscardedForOtherTags);
+  MITK_TEST(ScanIndex_SubsetScanDoesNotShortenEntries);
+  MITK_TEST(Reader_WithScanIndex_EqualsReaderWithout);
+  MITK_TEST(ScanIndex_RemovesDeletedFiles);
+  MITK_TEST(ScanIndex_EvictsLeastRecentlyUsedEntries);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  std::string m_Directory;
+  mitk::StringList m_Files;
+  mitk::DICOMTagPathList m_TagPaths;
+
+  /** Writes a synthetic CT slice. The pixel data dominates the file size, like in real data. */
+  void WriteSlice(const std::string& fileName, unsigned int series, unsigned int slice, unsigned int size, const std::string& patientName)
+  {
+    const std::string uidRoot = "1.2.826.0.1.3680043.2.1125.7.";
+
+    DcmFileFormat fileFormat;
+    DcmDataset* dataset = fileFormat.getDataset();
+
+    dataset->putAndInsertString(DCM_SOPClassUID, UID_CTImageStorage);
+    dataset->putAndInsertString(DCM_SOPInstanceUID, (uidRoot + "3." + std::to_string(series) + "." + std::to_string(slice)).c_str());
+    dataset->putAndInsertString(DCM_StudyInstanceUID, (uidRoot + "1").c_str());
+    dataset->putAndInsertString(DCM_SeriesInstanceUID, (uidRoot + "2." + std::to_string(series)).c_str());
+    dataset->putAndInsertString(DCM_FrameOfReferenceUID, (uidRoot + "4").c_str());
+    dataset->putAndInsertString(DCM_Modality, "CT");
+    dataset->putAndInsertString(DCM_PatientName, patientName.c_str());
+    dataset->putAndInsertString(DCM_InstanceNumber, std::to_string(slice + 1).c_str());
+    dataset->putAndInsertString(DCM_ImagePositionPatient, ("0\\0\\" + std::to_string(slice * 2.5)).c_str());
+    dataset->putAndInsertString(DCM_ImageOrientationPatient, "1\\0\\0\\0\\1\\0");
+    dataset->putAndInsertString(DCM_PixelSpacing, "0.5\\0.5");
+    dataset->putAndInsertString(DCM_SliceThickness, "2.5");
+    dataset->putAndInsertUint16(DCM_SamplesPerPixel, 1);
+    dataset->putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+    dataset->putAndInsertUint16(DCM_Rows, size);
+    dataset->putAndInsertUint16(DCM_Columns, size);
+    dataset->putAndInsertUint16(DCM_BitsAllocated, 16);
+    dataset->putAndInsertUint16(DCM_BitsStored, 16);
+    dataset->putAndInsertUint16(DCM_HighBit, 15);
+    dataset->putAndInsertUint16(DCM_PixelRepresentation, 0);
+
+    std::vector<Uint16> pixels(size * size);
+    for (std::size_t i = 0; i < pixels.size(); ++i)
+      pixels[i] = static_cast<Uint16>((i + slice * 7) % 4096);
+
+    dataset->putAndInsertUint16Array(DCM_PixelData, pixels.data(), static_cast<unsigned long>(pixels.size()));
+
+    CPPUNIT_ASSERT_MESSAGE("Writing synthetic DICOM file " + fileName, fileFormat.saveFile(fileName.c_str(), EXS_LittleEndianExplicit).good());
+  }
+
+  void GenerateTree(unsigned int numberOfSeries, unsigned int numberOfSlices, unsigned int size)
+  {
+    m_Files.clear();
+
+    for (unsigned int series = 0; series < numberOfSeries; ++series)
+    {
+      const std::string seriesDirectory = m_Directory + "/series" + std::to_string(series);
+      itksys::SystemTools::MakeDirectory(seriesDirectory);
+
+      for (unsigned int slice = 0; slice < numberOfSlices; ++slice)
+      {
+        const std::string fileName = seriesDirectory + "/slice" + std::to_string(slice) + ".dcm";
+        this->WriteSlice(fileName, series, slice, size, "Synthetic^Patient");
+        m_Files.push_back(fileName);
+      }
+    }
+  }
+
+  mitk::DICOMDCMTKTagScanner::Pointer CreateScanner(bool stopBeforePixelData, unsigned int numberOfThreads, mitk::DICOMTagScanIndex* index = nullptr)
+  {
+    auto scanner = mitk::DICOMDCMTKTagScanner::New();
+    scanner->SetInputFiles(m_Files);
+    scanner->AddTagPaths(m_TagPaths);
+    scanner->SetStopBeforePixelData(stopBeforePixelData);
+    scanner->SetNumberOfThreads(numberOfThreads);
+    scanner->SetScanIndex(index);
+    return scanner;
+  }
+
+  void AssertEqualScanResults(const mitk::DICOMDatasetAccessingImageFrameList& expected, const mitk::DICOMDatasetAccessingImageFrameList& actual)
+  {
+    CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(expected[i]->GetFilenameIfAvailable(), actual[i]->GetFilenameIfAvailable());
+
+      for (const auto& path : m_TagPaths)
+      {
+        auto expectedFindings = expected[i]->GetTagValueAsString(path);
+        auto actualFindings = actual[i]->GetTagValueAsString(path);
+
+        CPPUNIT_ASSERT_EQUAL(expectedFindings.size(), actualFindings.size());
+
+        auto actualIter = actualFindings.cbegin();
+        for (const auto& expectedFinding : expectedFindings)
+        {
+          CPPUNIT_ASSERT(expectedFinding.isValid == actualIter->isValid);
+          CPPUNIT_ASSERT(expectedFinding.path == actualIter->path);
+          CPPUNIT_ASSERT_EQUAL(expectedFinding.value, actualIter->value);
+          ++actualIter;
+        }
+      }
+    }
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Directory = mitk::IOUtil::CreateTemporaryDirectory("mitkDICOMTagScanIndexTest_XXXXXX");
+
+    m_TagPaths.clear();
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0010, 0x0010)); // patient name
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0020, 0x000e)); // series instance uid
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0020, 0x0032)); // image position patient
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0020, 0x0037)); // image orientation patient
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0028, 0x0030)); // pixel spacing
+
+    this->GenerateTree(2, 8, 64);
+  }
+
+  void tearDown() override
+  {
+    itksys::SystemTools::RemoveADirectory(m_Directory);
+  }
+
+  void HeaderOnlyParallelScan_EqualsFullScan()
+  {
+    auto fullScanner = this->CreateScanner(false, 1);
+    fullScanner->Scan();
+
+    auto headerScanner = this->CreateScanner(true, 0);
+    headerScanner->Scan();
+
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), fullScanner->GetFrameInfoList().size());
+    this->AssertEqualScanResults(fullScanner->GetFrameInfoList(), headerScanner->GetFrameInfoList());
+  }
+
+  void ScanIndex_SkipsUnchangedFiles()
+  {
+    auto index = mitk::DICOMTagScanIndex::New();
+
+    auto scanner = this->CreateScanner(true, 0, index);
+    scanner->Scan();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), scanner->GetNumberOfFilesTakenFromIndex());
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), index->GetNumberOfEntries());
+
+    auto reference = scanner->GetFrameInfoList();
+
+    auto secondScanner = this->CreateScanner(true, 0, index);
+    secondScanner->Scan();
+
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), secondScanner->GetNumberOfFilesTakenFromIndex());
+    this->AssertEqualScanResults(reference, secondScanner->GetFrameInfoList());
+
+    // A longer patient name changes the file size, which is detected independent of the time stamp resolution.
+    this->WriteSlice(m_Files[3], 0, 3, 64, "Modified^Synthetic^Patient");
+
+    auto thirdScanner = this->CreateScanner(true, 0, index);
+    thirdScanner->Scan();
+
+    CPPUNIT_ASSERT_EQUAL(m_Files.size() - 1, thirdScanner->GetNumberOfFilesTakenFromIndex());
+
+    auto findings = thirdScanner->GetFrameInfoList()[3]->GetTagValueAsString(mitk::DICOMTagPath(0x0010, 0x0010));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), findings.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Modified^Synthetic^Patient"), findings.front().value);
+  }
+
+  void ScanIndex_SaveAndLoad()
+  {
+    const std::string indexFileName = m_Directory + "/tagscan.index";
+
+    auto index = mitk::DICOMTagScanIndex::New();
+    auto scanner = this->CreateScanner(true, 0, index);
+    scanner->Scan();
+    index->Save(indexFileName);
+
+    auto loadedIndex = mitk::DICOMTagScanIndex::New();
+    CPPUNIT_ASSERT(loadedIndex->Load(indexFileName));
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), loadedIndex->GetNumberOfEntries());
+
+    auto secondScanner = this->CreateScanner(false, 1, loadedIndex);
+    secondScanner->Scan();
+
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), secondScanner->GetNumberOfFilesTakenFromIndex());
+    this->AssertEqualScanResults(scanner->GetFrameInfoList(), secondScanner->GetFrameInfoList());
+
+    CPPUNIT_ASSERT(!loadedIndex->Load(m_Files.front()));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), loadedIndex->GetNumberOfEntries());
+  }
+
+  void ScanIndex_DiscardedForOtherTags()
+  {
+    auto index = mitk::DICOMTagScanIndex::New();
+    auto scanner = this->CreateScanner(true, 0, index);
+    scanner->Scan();
+
+    m_TagPaths.push_back(mitk::DICOMTagPath(0x0008, 0x0060)); // modality
+
+    auto secondScanner = this->CreateScanner(true, 0, index);
+    secondScanner->Scan();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), secondScanner->GetNumberOfFilesTakenFromIndex());
+
+    auto findings = secondScanner->GetFrameInfoList().front()->GetTagValueAsString(mitk::DICOMTagPath(0x0008, 0x0060));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), findings.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("CT"), findings.front().value);
+
+    // Entries of a superset are discarded for a subset, too.
+    m_TagPaths.pop_back();
+
+    auto thirdScanner = this->CreateScanner(true, 0, index);
+    thirdScanner->Scan();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), thirdScanner->GetNumberOfFilesTakenFromIndex());
+  }
+
+  void ScanIndex_SubsetScanDoesNotShortenEntries()
+  {
+    const mitk::DICOMTagPath modalityPath(0x0008, 0x0060);
+    m_TagPaths.push_back(modalityPath);
+
+    auto index = mitk::DICOMTagScanIndex::New();
+    this->CreateScanner(true, 0, index)->Scan();
+
+    // Scan new files for a subset of the tags.
+    const auto oldFiles = m_Files;
+    const std::string seriesDirectory = m_Directory + "/series2";
+    itksys::SystemTools::MakeDirectory(seriesDirectory);
+
+    m_Files.clear();
+
+    for (unsigned int slice = 0; slice < 4; ++slice)
+    {
+      const std::string fileName = seriesDirectory + "/slice" + std::to_string(slice) + ".dcm";
+      this->WriteSlice(fileName, 2, slice, 64, "Synthetic^Patient");
+      m_Files.push_back(fileName);
+    }
+
+    const auto newFiles = m_Files;
+
+    m_TagPaths.pop_back();
+    this->CreateScanner(true, 0, index)->Scan();
+
+    // All files must have values for the full set of tags again.
+    m_TagPaths.push_back(modalityPath);
+    m_Files = oldFiles;
+    m_Files.insert(m_Files.end(), newFiles.begin(), newFiles.end());
+
+    auto scanner = this->CreateScanner(true, 0, index);
+    scanner->Scan();
+
+    auto reference = this->CreateScanner(true, 0);
+    reference->Scan();
+
+    this->AssertEqualScanResults(reference->GetFrameInfoList(), scanner->GetFrameInfoList());
+
+    for (const auto& frameInfo : scanner->GetFrameInfoList())
+    {
+      auto findings = frameInfo->GetTagValueAsString(modalityPath);
+      CPPUNIT_ASSERT_EQUAL(std::size_t(1), findings.size());
+      CPPUNIT_ASSERT_EQUAL(std::string("CT"), findings.front().value);
+    }
+  }
+
+  void Reader_WithScanIndex_EqualsReaderWithout()
+  {
+    auto reader = mitk::DICOMITKSeriesGDCMReader::New();
+    reader->SetInputFiles(m_Files);
+    reader->AnalyzeInputFiles();
+
+    const std::string indexFileName = m_Directory + "/reader.index";
+
+    for (int run = 0; run < 2; ++run)
+    {
+      auto indexedReader = mitk::DICOMITKSeriesGDCMReader::New();
+      indexedReader->SetTagScanIndexFileName(indexFileName);
+      indexedReader->SetInputFiles(m_Files);
+      indexedReader->AnalyzeInputFiles();
+
+      CPPUNIT_ASSERT(itksys::SystemTools::FileExists(indexFileName, true));
+      CPPUNIT_ASSERT_EQUAL(reader->GetNumberOfOutputs(), indexedReader->GetNumberOfOutputs());
+
+      for (unsigned int i = 0; i < reader->GetNumberOfOutputs(); ++i)
+        CPPUNIT_ASSERT(reader->GetOutput(i).GetImageFrameList().size() == indexedReader->GetOutput(i).GetImageFrameList().size());
+    }
+  }
+
+  void ScanIndex_RemovesDeletedFiles()
+  {
+    auto index = mitk::DICOMTagScanIndex::New();
+    auto scanner = this->CreateScanner(true, 0, index);
+    scanner->Scan();
+
+    CPPUNIT_ASSERT_EQUAL(m_Files.size(), index->GetNumberOfEntries());
+
+    mitk::DICOMTagScanIndex::TagValueList values;
+    CPPUNIT_ASSERT(index->Lookup(m_Files.front(), values));
+
+    itksys::SystemTools::RemoveFile(m_Files.front());
+
+    CPPUNIT_ASSERT(!index->Lookup(m_Files.front(), values));
+    CPPUNIT_ASSERT_EQUAL(m_Files.size() - 1, index->GetNumberOfEntries());
+  }
+
+  void ScanIndex_EvictsLeastRecentlyUsedEntries()
+  {
+    auto index = mitk::DICOMTagScanIndex::New();
+    auto scanner = this->CreateScanner(true, 0, index);
+    scanner->Scan();
+
+    mitk::DICOMTagScanIndex::TagValueList values;
+    CPPUNIT_ASSERT(index->Lookup(m_Files.front(), values));
+
+    // The first file was used last, the index is bounded to 10 entries and
+    // evicts down to 9 entries once the bound is exceeded.
+    index->SetMaximumNumberOfEntries(10);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(9), index->GetNumberOfEntries());
+    CPPUNIT_ASSERT(index->Lookup(m_Files.front(), values));
+
+    for (const auto& file : m_Files)
+      index->Insert(file, values);
+
+    CPPUNIT_ASSERT(index->GetNumberOfEntries() <= 10);
+    CPPUNIT_ASSERT(index->Lookup(m_Files.back(), values));
+
+    const std::string indexFileName = m_Directory + "/bounded.index";
+    index->Save(indexFileName);
+
+    auto loadedIndex = mitk::DICOMTagScanIndex::New();
+    loadedIndex->SetMaximumNumberOfEntries(5);
+    CPPUNIT_ASSERT(loadedIndex->Load(indexFileName));
+    CPPUNIT_ASSERT(loadedIndex->GetNumberOfEntries() <= 5);
+    CPPUNIT_ASSERT(loadedIndex->Lookup(m_Files.back(), values));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMTagScanIndex)
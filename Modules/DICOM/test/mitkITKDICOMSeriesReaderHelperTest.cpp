@@ -0,0 +1,214 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkDICOMITKSeriesGDCMReader.h"
+#include "mitkThreeDnTDICOMSeriesReader.h"
+
+#include "mitkIOUtil.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <dcmtk/dcmdata/dcdeftag.h>
+#include <dcmtk/dcmdata/dcfilefo.h>
+#include <dcmtk/dcmdata/dcuid.h>
+
+#include <itkGDCMImageIO.h>
+#include <itkImageSeriesReader.h>
+#include <itksys/SystemTools.hxx>
+
+class mitkITKDICOMSeriesReaderHelperTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkITKDICOMSeriesReaderHelperTestSuite);
+
+  MITK_TEST(Load3D_EqualsImageSeriesReader);
+  MITK_TEST(Load3DnT_EqualsImageSeriesReader);
+  MITK_TEST(LoadStatistics_CountFrames);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  typedef itk::Image<short, 3> ItkImageType;
+
+  static constexpr unsigned int Size = 32;
+  static constexpr unsigned int NumberOfSlices = 12;
+  static constexpr unsigned int NumberOfTimeSteps = 3;
+
+  std::string m_Directory;
+
+  /** Writes a CT slice whose rescale intercept differs from slice to slice. */
+  std::string WriteSlice(unsigned int timeStep, unsigned int slice)
+  {
+    const std::string uidRoot = "1.2.826.0.1.3680043.2.1125.8.";
+    const std::string fileName = m_Directory + "/t" + std::to_string(timeStep) + "_s" + std::to_string(slice) + ".dcm";
+
+    DcmFileFormat fileFormat;
+    DcmDataset* dataset = fileFormat.getDataset();
+
+    dataset->putAndInsertString(DCM_SOPClassUID, UID_CTImageStorage);
+    dataset->putAndInsertString(DCM_SOPInstanceUID, (uidRoot + "3." + std::to_string(timeStep) + "." + std::to_string(slice)).c_str());
+    dataset->putAndInsertString(DCM_StudyInstanceUID, (uidRoot + "1").c_str());
+    dataset->putAndInsertString(DCM_SeriesInstanceUID, (uidRoot + "2").c_str());
+    dataset->putAndInsertString(DCM_FrameOfReferenceUID, (uidRoot + "4").c_str());
+    dataset->putAndInsertString(DCM_Modality, "CT");
+    dataset->putAndInsertString(DCM_PatientName, "Synthetic^Patient");
+    dataset->putAndInsertString(DCM_AcquisitionDate, "20200101");
+    dataset->putAndInsertString(DCM_AcquisitionTime, ("1200" + std::to_string(10 + timeStep * 10)).c_str());
+    dataset->putAndInsertString(DCM_InstanceNumber, std::to_string(timeStep * NumberOfSlices + slice + 1).c_str());
+    dataset->putAndInsertString(DCM_ImagePositionPatient, ("-8\\-8\\" + std::to_string(slice * 2)).c_str());
+    dataset->putAndInsertString(DCM_ImageOrientationPatient, "1\\0\\0\\0\\1\\0");
+    dataset->putAndInsertString(DCM_PixelSpacing, "0.5\\0.5");
+    dataset->putAndInsertString(DCM_SliceThickness, "2");
+    dataset->putAndInsertString(DCM_RescaleSlope, "1");
+    dataset->putAndInsertString(DCM_RescaleIntercept, std::to_string(-1000 - static_cast<int>(slice)).c_str());
+    dataset->putAndInsertUint16(DCM_SamplesPerPixel, 1);
+    dataset->putAndInsertString(DCM_PhotometricInterpretation, "MONOCHROME2");
+    dataset->putAndInsertUint16(DCM_Rows, Size);
+    dataset->putAndInsertUint16(DCM_Columns, Size);
+    dataset->putAndInsertUint16(DCM_BitsAllocated, 16);
+    dataset->putAndInsertUint16(DCM_BitsStored, 12);
+    dataset->putAndInsertUint16(DCM_HighBit, 11);
+    dataset->putAndInsertUint16(DCM_PixelRepresentation, 0);
+
+    std::vector<Uint16> pixels(Size * Size);
+    for (std::size_t i = 0; i < pixels.size(); ++i)
+      pixels[i] = static_cast<Uint16>((i * 3 + slice * 11 + timeStep * 101) % 4096);
+
+    dataset->putAndInsertUint16Array(DCM_PixelData, pixels.data(), static_cast<unsigned long>(pixels.size()));
+
+    CPPUNIT_ASSERT_MESSAGE("Writing synthetic DICOM file " + fileName, fileFormat.saveFile(fileName.c_str(), EXS_LittleEndianExplicit).good());
+
+    return fileName;
+  }
+
+  mitk::StringList WriteTimeStep(unsigned int timeStep)
+  {
+    mitk::StringList files;
+
+    for (unsigned int slice = 0; slice < NumberOfSlices; ++slice)
+      files.push_back(this->WriteSlice(timeStep, slice));
+
+    return files;
+  }
+
+  ItkImageType::Pointer ReadWithImageSeriesReader(const mitk::StringList& files)
+  {
+    auto reader = itk::ImageSeriesReader<ItkImageType>::New();
+    reader->SetImageIO(itk::GDCMImageIO::New());
+    reader->SetFileNames(files);
+    reader->Update();
+
+    return reader->GetOutput();
+  }
+
+  void AssertEqualVolume(const ItkImageType* expected, const mitk::Image* image, unsigned int timeStep)
+  {
+    const auto geometry = image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep);
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(expected->GetLargestPossibleRegion().GetSize()[i]), image->GetDimension(i));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->GetSpacing()[i], geometry->GetSpacing()[i], mitk::eps);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->GetOrigin()[i], geometry->GetOrigin()[i], mitk::eps);
+    }
+
+    mitk::ImageReadAccessor accessor(image, image->GetVolumeData(timeStep));
+    const auto data = static_cast<const short*>(accessor.GetData());
+    const auto numberOfPixels = expected->GetLargestPossibleRegion().GetNumberOfPixels();
+
+    CPPUNIT_ASSERT(std::equal(data, data + numberOfPixels, expected->GetBufferPointer()));
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Directory = mitk::IOUtil::CreateTemporaryDirectory("mitkITKDICOMSeriesReaderHelperTest_XXXXXX");
+  }
+
+  void tearDown() override
+  {
+    itksys::SystemTools::RemoveADirectory(m_Directory);
+  }
+
+  void Load3D_EqualsImageSeriesReader()
+  {
+    const auto files = this->WriteTimeStep(0);
+
+    auto reader = mitk::DICOMITKSeriesGDCMReader::New();
+    reader->SetInputFiles(files);
+    reader->AnalyzeInputFiles();
+    reader->LoadImages();
+
+    CPPUNIT_ASSERT_EQUAL(1u, reader->GetNumberOfOutputs());
+
+    const auto image = reader->GetOutput(0).GetMitkImage();
+    CPPUNIT_ASSERT(image.IsNotNull());
+
+    // per-file rescale intercepts must be applied
+    auto expected = this->ReadWithImageSeriesReader(files);
+    CPPUNIT_ASSERT_EQUAL(short(-1000), expected->GetPixel({ { 0, 0, 0 } }));
+    CPPUNIT_ASSERT_EQUAL(short(11 - 1001), expected->GetPixel({ { 0, 0, 1 } }));
+
+    this->AssertEqualVolume(expected, image, 0);
+  }
+
+  void Load3DnT_EqualsImageSeriesReader()
+  {
+    std::vector<mitk::StringList> filesOfTimeSteps;
+    mitk::StringList allFiles;
+
+    for (unsigned int timeStep = 0; timeStep < NumberOfTimeSteps; ++timeStep)
+    {
+      filesOfTimeSteps.push_back(this->WriteTimeStep(timeStep));
+      allFiles.insert(allFiles.end(), filesOfTimeSteps.back().begin(), filesOfTimeSteps.back().end());
+    }
+
+    auto reader = mitk::ThreeDnTDICOMSeriesReader::New();
+    reader->SetInputFiles(allFiles);
+    reader->AnalyzeInputFiles();
+    reader->LoadImages();
+
+    CPPUNIT_ASSERT_EQUAL(1u, reader->GetNumberOfOutputs());
+
+    const auto image = reader->GetOutput(0).GetMitkImage();
+    CPPUNIT_ASSERT(image.IsNotNull());
+    CPPUNIT_ASSERT_EQUAL(NumberOfTimeSteps, image->GetTimeSteps());
+
+    for (unsigned int timeStep = 0; timeStep < NumberOfTimeSteps; ++timeStep)
+      this->AssertEqualVolume(this->ReadWithImageSeriesReader(filesOfTimeSteps[timeStep]), image, timeStep);
+  }
+
+  void LoadStatistics_CountFrames()
+  {
+    const auto files = this->WriteTimeStep(0);
+
+    auto reader = mitk::DICOMITKSeriesGDCMReader::New();
+    reader->SetInputFiles(files);
+    reader->AnalyzeInputFiles();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), reader->GetLoadStatistics().NumberOfFrames);
+
+    reader->LoadImages();
+
+    const auto& statistics = reader->GetLoadStatistics();
+    CPPUNIT_ASSERT_EQUAL(files.size(), statistics.NumberOfFrames);
+    CPPUNIT_ASSERT_EQUAL(files.size() * Size * Size * sizeof(short), statistics.NumberOfBytes);
+    CPPUNIT_ASSERT(statistics.TotalTime >= statistics.DecodingTime);
+
+    reader->ResetLoadStatistics();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), reader->GetLoadStatistics().NumberOfFrames);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkITKDICOMSeriesReaderHelper)
@@ -81,6 +81,14 @@ namespace mitk
     Image::Pointer GetDiffImage();
 
     bool IsImageStillValid() { return m_ImageStillValid; }
+
+    /** Memory of the operation including the compressed difference image. */
+    std::size_t GetMemoryFootprint() const override;
+
+    /** The compressed difference image can be swapped out by undo models. */
+    bool IsSwappable() const override;
+    void SwapOut(std::ostream &stream) override;
+    void SwapIn(std::istream &stream) override;
   };
 
 } // namespace mitk
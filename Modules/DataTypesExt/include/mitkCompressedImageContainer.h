@@ -16,25 +16,77 @@ found in the LICENSE file.
 #include <MitkDataTypesExtExports.h>
 #include <mitkImage.h>
 #include <array>
+#include <iosfwd>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace mitk
 {
+  /** \brief Holds an LZ4 compressed copy of an image.
+   *
+   * Slices are compressed and decompressed independently on all available cores.
+   * Optionally, each slice is encoded as difference to the previous slice of the
+   * same time step before compression (see Codec), which greatly improves the
+   * compression ratio of label images and of smooth intensity images.
+   */
   class MITKDATATYPESEXT_EXPORT CompressedImageContainer
   {
   public:
+    enum class Codec
+    {
+      /** Compress the raw bytes of each slice. */
+      LZ4,
+      /** Compress the bytewise XOR of each slice with the previous slice. */
+      XorDeltaLZ4,
+      /** Compress a run-length encoding of the zero runs of the XOR delta.
+       *  Best suited for label images where consecutive slices hardly differ. */
+      RunLengthDeltaLZ4
+    };
+
     CompressedImageContainer();
     ~CompressedImageContainer();
 
     CompressedImageContainer(const CompressedImageContainer&) = delete;
     CompressedImageContainer& operator=(const CompressedImageContainer&) = delete;
 
+    /** \brief Set the codec used by subsequent calls of CompressImage(). Default is Codec::LZ4. */
+    void SetCodec(Codec codec);
+    Codec GetCodec() const;
+
     void CompressImage(const Image* image);
     Image::Pointer DecompressImage() const;
 
+    /** \brief Number of bytes of the compressed image data. */
+    std::size_t GetCompressedSize() const;
+
+    /** \brief Number of bytes of the pixel data of the compressed image. */
+    std::size_t GetUncompressedSize() const;
+
+    /** \brief Number of bytes held in memory, including the compressed image data. */
+    std::size_t GetMemoryFootprint() const;
+
+    /** \brief Writes the compressed image data to the stream and releases it from memory.
+     *
+     * Pixel type and geometry stay in memory. DecompressImage() must not be called
+     * until the data is restored by SwapIn().
+     */
+    void SwapOut(std::ostream& stream);
+
+    /** \brief Restores the compressed image data written by SwapOut().
+     *  \exception mitk::Exception if the stream does not contain valid data.
+     */
+    void SwapIn(std::istream& stream);
+
   private:
-    using CompressedSliceData = std::pair<int, char*>;
+    struct CompressedSliceData
+    {
+      /** LZ4 compressed data. */
+      std::vector<char> Data;
+      /** Number of bytes before LZ4 compression (differs from the slice size for Codec::RunLengthDeltaLZ4). */
+      int EncodedSize = 0;
+    };
+
     using CompressedTimeStepData = std::vector<CompressedSliceData>;
     using CompressedImageData = std::vector<CompressedTimeStepData>;
 
@@ -42,6 +94,8 @@ namespace mitk
 
     CompressedImageData m_CompressedImageData;
 
+    Codec m_Codec;
+    Codec m_CompressedImageCodec;
     std::unique_ptr<PixelType> m_PixelType;
     TimeGeometry::Pointer m_TimeGeometry;
     std::array<unsigned int, 2> m_SliceDimensions;
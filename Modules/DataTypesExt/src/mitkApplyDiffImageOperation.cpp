@@ -62,3 +62,23 @@ mitk::Image::Pointer mitk::ApplyDiffImageOperation::GetDiffImage()
   // uncompress image to create a valid mitk::Image
   return m_CompressedImageContainer.DecompressImage();
 }
+
+std::size_t mitk::ApplyDiffImageOperation::GetMemoryFootprint() const
+{
+  return sizeof(ApplyDiffImageOperation) - sizeof(CompressedImageContainer) + m_CompressedImageContainer.GetMemoryFootprint();
+}
+
+bool mitk::ApplyDiffImageOperation::IsSwappable() const
+{
+  return true;
+}
+
+void mitk::ApplyDiffImageOperation::SwapOut(std::ostream &stream)
+{
+  m_CompressedImageContainer.SwapOut(stream);
+}
+
+void mitk::ApplyDiffImageOperation::SwapIn(std::istream &stream)
+{
+  m_CompressedImageContainer.SwapIn(stream);
+}
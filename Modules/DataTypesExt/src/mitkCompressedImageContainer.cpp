@@ -12,15 +12,149 @@ found in the LICENSE file.
 
 #include <mitkCompressedImageContainer.h>
 
+#include <mitkExceptionMacro.h>
 #include <mitkImageReadAccessor.h>
 #include <mitkImageWriteAccessor.h>
 
+#include <itkMultiThreaderBase.h>
+
 #include <lz4.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace
+{
+  /** Number of bytes per work item when reverting the XOR delta of all slices of a time step. */
+  constexpr std::size_t DeltaChunkSize = 64 * 1024;
+
+  /** Minimum number of zero bytes that terminate a literal run of the run-length encoding. */
+  constexpr std::size_t MinimumZeroRun = 3;
+
+  void WriteSize(std::ostream& stream, std::uint64_t size)
+  {
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  }
+
+  std::uint64_t ReadSize(std::istream& stream)
+  {
+    std::uint64_t size = 0;
+
+    if (!stream.read(reinterpret_cast<char*>(&size), sizeof(size)))
+      mitkThrow() << "Unexpected end of swapped compressed image data.";
+
+    return size;
+  }
+
+  void XorBytes(const char* a, const char* b, char* result, std::size_t numBytes)
+  {
+    for (std::size_t i = 0; i < numBytes; ++i)
+      result[i] = a[i] ^ b[i];
+  }
+
+  void WriteVarInt(std::vector<char>& buffer, std::size_t value)
+  {
+    while (value >= 0x80)
+    {
+      buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+
+    buffer.push_back(static_cast<char>(value));
+  }
+
+  bool ReadVarInt(const char*& pos, const char* end, std::size_t& value)
+  {
+    value = 0;
+
+    for (unsigned int shift = 0; pos < end && shift < 64; shift += 7)
+    {
+      const auto byte = static_cast<unsigned char>(*pos++);
+      value |= static_cast<std::size_t>(byte & 0x7F) << shift;
+
+      if (0 == (byte & 0x80))
+        return true;
+    }
+
+    return false;
+  }
+
+  /** Encodes the data as sequence of (number of zero bytes, number of literal bytes, literal bytes). */
+  void EncodeRunLength(const char* data, std::size_t numBytes, std::vector<char>& encoded)
+  {
+    encoded.clear();
+    std::size_t pos = 0;
+
+    while (pos < numBytes)
+    {
+      const auto zeroRunBegin = pos;
+
+      while (pos < numBytes && 0 == data[pos])
+        ++pos;
+
+      const auto literalBegin = pos;
+
+      // Short zero runs are cheaper to keep in the literal run.
+      while (pos < numBytes)
+      {
+        if (0 != data[pos])
+        {
+          ++pos;
+          continue;
+        }
+
+        auto zeroRunEnd = pos;
+
+        while (zeroRunEnd < numBytes && 0 == data[zeroRunEnd] && zeroRunEnd - pos < MinimumZeroRun)
+          ++zeroRunEnd;
+
+        if (zeroRunEnd - pos >= MinimumZeroRun || zeroRunEnd == numBytes)
+          break;
+
+        pos = zeroRunEnd;
+      }
+
+      WriteVarInt(encoded, literalBegin - zeroRunBegin);
+      WriteVarInt(encoded, pos - literalBegin);
+      encoded.insert(encoded.end(), data + literalBegin, data + pos);
+    }
+  }
+
+  bool DecodeRunLength(const char* encoded, std::size_t encodedSize, char* data, std::size_t numBytes)
+  {
+    const auto end = encoded + encodedSize;
+    std::size_t pos = 0;
+
+    while (encoded < end)
+    {
+      std::size_t zeroRun = 0;
+      std::size_t literalRun = 0;
+
+      if (!ReadVarInt(encoded, end, zeroRun) || !ReadVarInt(encoded, end, literalRun))
+        return false;
+
+      if (zeroRun > numBytes - pos || literalRun > numBytes - pos - zeroRun || literalRun > static_cast<std::size_t>(end - encoded))
+        return false;
+
+      std::fill_n(data + pos, zeroRun, 0);
+      pos += zeroRun;
+
+      std::copy_n(encoded, literalRun, data + pos);
+      encoded += literalRun;
+      pos += literalRun;
+    }
+
+    return pos == numBytes;
+  }
+}
 
 mitk::CompressedImageContainer::CompressedImageContainer()
-  : m_Dimension(0)
+  : m_Codec(Codec::LZ4),
+    m_CompressedImageCodec(Codec::LZ4),
+    m_Dimension(0)
 {
 }
 
@@ -29,16 +163,21 @@ mitk::CompressedImageContainer::~CompressedImageContainer()
   this->ClearCompressedImageData();
 }
 
-void mitk::CompressedImageContainer::ClearCompressedImageData()
+void mitk::CompressedImageContainer::SetCodec(Codec codec)
 {
-  for (const auto& image : m_CompressedImageData)
-  {
-    for (auto slice : image)
-      delete[] slice.second;
-  }
+  m_Codec = codec;
+}
+
+mitk::CompressedImageContainer::Codec mitk::CompressedImageContainer::GetCodec() const
+{
+  return m_Codec;
+}
 
+void mitk::CompressedImageContainer::ClearCompressedImageData()
+{
   m_CompressedImageData.clear();
 
+  m_CompressedImageCodec = Codec::LZ4;
   m_PixelType = nullptr;
   m_TimeGeometry = nullptr;
   m_SliceDimensions[0] = 0;
@@ -53,6 +192,7 @@ void mitk::CompressedImageContainer::CompressImage(const Image* image)
   if (nullptr == image)
     return;
 
+  m_CompressedImageCodec = m_Codec;
   m_PixelType = std::make_unique<PixelType>(image->GetPixelType());
   m_TimeGeometry = image->GetTimeGeometry()->Clone();
   m_SliceDimensions[0] = image->GetDimension(0);
@@ -63,38 +203,64 @@ void mitk::CompressedImageContainer::CompressImage(const Image* image)
   const auto numSlices = image->GetDimension(2);
   const auto numSliceBytes = image->GetPixelType().GetSize() * image->GetDimension(0) * image->GetDimension(1);
 
-  m_CompressedImageData.reserve(numTimeSteps);
+  std::vector<std::unique_ptr<ImageReadAccessor>> accessors;
+  m_CompressedImageData.resize(numTimeSteps);
 
   for (std::remove_const_t<decltype(numTimeSteps)> t = 0; t < numTimeSteps; ++t)
   {
-    CompressedTimeStepData slices;
-    slices.reserve(numSlices);
+    accessors.push_back(std::make_unique<ImageReadAccessor>(image, image->GetVolumeData(t)));
+    m_CompressedImageData[t].resize(numSlices);
+  }
 
-    ImageReadAccessor accessor(image, image->GetVolumeData(t));
+  const auto codec = m_CompressedImageCodec;
+  std::atomic<bool> failed(false);
 
-    for (std::remove_const_t<decltype(numSlices)> s = 0; s < numSlices; ++s)
+  auto compressSlice = [&](itk::SizeValueType i)
+  {
+    const auto t = i / numSlices;
+    const auto s = i % numSlices;
+
+    const auto* src = reinterpret_cast<const char*>(accessors[t]->GetData()) + numSliceBytes * s;
+    const char* input = src;
+    std::size_t inputSize = numSliceBytes;
+
+    std::vector<char> delta;
+    std::vector<char> encoded;
+
+    if (Codec::LZ4 != codec && 0 != s)
     {
-      const auto* src = reinterpret_cast<const char*>(accessor.GetData()) + numSliceBytes * s;
-      char* dest = new char[numSliceBytes];
-      const auto destSize = LZ4_compress_default(src, dest, static_cast<int>(numSliceBytes), static_cast<int>(numSliceBytes));
+      delta.resize(numSliceBytes);
+      XorBytes(src, src - numSliceBytes, delta.data(), numSliceBytes);
+      input = delta.data();
+    }
 
-      if (0 == destSize)
-      {
-        MITK_ERROR << "LZ4 compression failed!";
-        delete[] dest;
-        slices.emplace_back(0, nullptr);
-      }
-      else
-      {
-        char* shrinkedDest = new char[destSize];
-        std::copy(dest, dest + destSize, shrinkedDest);
-        delete[] dest;
-        slices.emplace_back(destSize, shrinkedDest);
-      }
+    if (Codec::RunLengthDeltaLZ4 == codec)
+    {
+      EncodeRunLength(input, numSliceBytes, encoded);
+      input = encoded.data();
+      inputSize = encoded.size();
     }
 
-    m_CompressedImageData.push_back(slices);
-  }
+    auto& slice = m_CompressedImageData[t][s];
+    slice.EncodedSize = static_cast<int>(inputSize);
+    slice.Data.resize(LZ4_compressBound(slice.EncodedSize));
+
+    const auto destSize = LZ4_compress_default(input, slice.Data.data(), slice.EncodedSize, static_cast<int>(slice.Data.size()));
+
+    if (0 == destSize && 0 != inputSize)
+      failed = true;
+
+    slice.Data.resize(destSize);
+    slice.Data.shrink_to_fit();
+  };
+
+  const itk::SizeValueType numSlicesTotal = numTimeSteps * numSlices;
+
+  if (0 != numSlicesTotal)
+    itk::MultiThreaderBase::New()->ParallelizeArray(0, numSlicesTotal, compressSlice, nullptr);
+
+  if (failed)
+    MITK_ERROR << "LZ4 compression failed!";
 }
 
 mitk::Image::Pointer mitk::CompressedImageContainer::DecompressImage() const
@@ -115,22 +281,146 @@ mitk::Image::Pointer mitk::CompressedImageContainer::DecompressImage() const
   auto image = Image::New();
   image->Initialize(*m_PixelType, m_Dimension, dimensions.data());
 
+  std::vector<std::unique_ptr<ImageWriteAccessor>> accessors;
+
   for (std::remove_const_t<decltype(numTimeSteps)> t = 0; t < numTimeSteps; ++t)
+    accessors.push_back(std::make_unique<ImageWriteAccessor>(image, image->GetVolumeData(static_cast<int>(t))));
+
+  const auto codec = m_CompressedImageCodec;
+  std::atomic<bool> failed(false);
+
+  auto decompressSlice = [&](itk::SizeValueType i)
   {
-    ImageWriteAccessor accessor(image, image->GetVolumeData(static_cast<int>(t)));
+    const auto t = i / numSlices;
+    const auto s = i % numSlices;
+
+    auto* dest = reinterpret_cast<char*>(accessors[t]->GetData()) + numSliceBytes * s;
+    const auto& slice = m_CompressedImageData[t][s];
 
-    for (std::remove_const_t<decltype(numSlices)> s = 0; s < numSlices; ++s)
+    if (Codec::RunLengthDeltaLZ4 == codec)
     {
-      auto* dest = reinterpret_cast<char*>(accessor.GetData()) + numSliceBytes * s;
-      const auto& slice = m_CompressedImageData[t][s];
-      const auto destSize = LZ4_decompress_safe(slice.second, dest, slice.first, static_cast<int>(numSliceBytes));
+      std::vector<char> encoded(slice.EncodedSize);
 
-      if (0 > destSize)
-        MITK_ERROR << "LZ4 decompression failed!";
+      if (slice.EncodedSize != LZ4_decompress_safe(slice.Data.data(), encoded.data(), static_cast<int>(slice.Data.size()), slice.EncodedSize) ||
+          !DecodeRunLength(encoded.data(), encoded.size(), dest, numSliceBytes))
+      {
+        failed = true;
+      }
     }
+    else if (0 > LZ4_decompress_safe(slice.Data.data(), dest, static_cast<int>(slice.Data.size()), static_cast<int>(numSliceBytes)))
+    {
+      failed = true;
+    }
+  };
+
+  const itk::SizeValueType numSlicesTotal = numTimeSteps * numSlices;
+
+  if (0 != numSlicesTotal)
+    itk::MultiThreaderBase::New()->ParallelizeArray(0, numSlicesTotal, decompressSlice, nullptr);
+
+  if (Codec::LZ4 != codec && 1 < numSlices && 0 != numSliceBytes)
+  {
+    // Revert the delta encoding. Slices depend on their predecessor, so each work
+    // item processes a range of bytes through all slices of a time step.
+    const itk::SizeValueType numChunks = (numSliceBytes + DeltaChunkSize - 1) / DeltaChunkSize;
+
+    itk::MultiThreaderBase::New()->ParallelizeArray(0, numTimeSteps * numChunks, [&](itk::SizeValueType i)
+    {
+      auto* data = reinterpret_cast<char*>(accessors[i / numChunks]->GetData());
+      const auto begin = (i % numChunks) * DeltaChunkSize;
+      const auto numBytes = std::min<std::size_t>(DeltaChunkSize, numSliceBytes - begin);
+
+      for (unsigned int s = 1; s < numSlices; ++s)
+      {
+        auto* slice = data + numSliceBytes * s + begin;
+        XorBytes(slice, slice - numSliceBytes, slice, numBytes);
+      }
+    }, nullptr);
   }
 
+  if (failed)
+    MITK_ERROR << "LZ4 decompression failed!";
+
+  accessors.clear();
+
   image->SetTimeGeometry(m_TimeGeometry->Clone());
 
   return image;
 }
+
+std::size_t mitk::CompressedImageContainer::GetCompressedSize() const
+{
+  std::size_t size = 0;
+
+  for (const auto& timeStep : m_CompressedImageData)
+  {
+    for (const auto& slice : timeStep)
+      size += slice.Data.size();
+  }
+
+  return size;
+}
+
+std::size_t mitk::CompressedImageContainer::GetUncompressedSize() const
+{
+  if (m_CompressedImageData.empty())
+    return 0;
+
+  return m_PixelType->GetSize() * m_SliceDimensions[0] * m_SliceDimensions[1] * m_CompressedImageData[0].size() * m_CompressedImageData.size();
+}
+
+std::size_t mitk::CompressedImageContainer::GetMemoryFootprint() const
+{
+  std::size_t footprint = sizeof(CompressedImageContainer) + m_CompressedImageData.capacity() * sizeof(CompressedTimeStepData);
+
+  for (const auto& timeStep : m_CompressedImageData)
+  {
+    footprint += timeStep.capacity() * sizeof(CompressedSliceData);
+
+    for (const auto& slice : timeStep)
+      footprint += slice.Data.capacity();
+  }
+
+  return footprint;
+}
+
+void mitk::CompressedImageContainer::SwapOut(std::ostream& stream)
+{
+  WriteSize(stream, m_CompressedImageData.size());
+
+  for (const auto& timeStep : m_CompressedImageData)
+  {
+    WriteSize(stream, timeStep.size());
+
+    for (const auto& slice : timeStep)
+    {
+      WriteSize(stream, slice.EncodedSize);
+      WriteSize(stream, slice.Data.size());
+      stream.write(slice.Data.data(), slice.Data.size());
+    }
+  }
+
+  // Keep codec, pixel type, geometry and dimensions for SwapIn()
+  CompressedImageData().swap(m_CompressedImageData);
+}
+
+void mitk::CompressedImageContainer::SwapIn(std::istream& stream)
+{
+  CompressedImageData data(ReadSize(stream));
+
+  for (auto& timeStep : data)
+  {
+    timeStep.resize(ReadSize(stream));
+
+    for (auto& slice : timeStep)
+    {
+      slice.EncodedSize = static_cast<int>(ReadSize(stream));
+      slice.Data.resize(ReadSize(stream));
+
+      if (!stream.read(slice.Data.data(), slice.Data.size()))
+        mitkThrow() << "Unexpected end of swapped compressed image data.";
+    }
+  }
+
+  m_CompressedImageData.swap(data);
+}
@@ -2,6 +2,13 @@ set(MODULE_TESTS
   mitkColorSequenceRainbowTest.cpp
   mitkMultiStepperTest.cpp
   mitkUnstructuredGridTest.cpp
+  mitkCompressedImageContainerCodecTest.cpp
+)
+
+# Benchmarks are built into the test driver, but not registered with ctest.
+# Run them explicitly, e.g. MitkDataTypesExtTestDriver mitkCompressedImageContainerCodecBenchmarkTest
+set(MODULE_CUSTOM_TESTS
+  mitkCompressedImageContainerCodecBenchmarkTest.cpp
 )
 
 set(MODULE_IMAGE_TESTS
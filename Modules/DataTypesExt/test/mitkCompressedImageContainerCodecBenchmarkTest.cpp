@@ -0,0 +1,121 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Benchmark, not part of the ctest set. Run it explicitly:
+//   MitkDataTypesExtTestDriver mitkCompressedImageContainerCodecBenchmarkTest
+
+#include "mitkCompressedImageContainer.h"
+
+#include "mitkImageWriteAccessor.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+
+class mitkCompressedImageContainerCodecBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkCompressedImageContainerCodecBenchmarkTestSuite);
+  MITK_TEST(Benchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  using Codec = mitk::CompressedImageContainer::Codec;
+
+  static constexpr unsigned int Size = 256;
+  static constexpr unsigned int NumberOfSlices = 96;
+
+  template <typename TPixel, typename TFunction>
+  static mitk::Image::Pointer CreateImage(unsigned int numberOfTimeSteps, TFunction function)
+  {
+    std::array<unsigned int, 4> dimensions = { { Size, Size, NumberOfSlices, numberOfTimeSteps } };
+
+    auto image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<TPixel>(), 1 < numberOfTimeSteps ? 4 : 3, dimensions.data());
+
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      mitk::ImageWriteAccessor accessor(image, image->GetVolumeData(t));
+      auto data = static_cast<TPixel*>(accessor.GetData());
+
+      for (unsigned int z = 0; z < NumberOfSlices; ++z)
+        for (unsigned int y = 0; y < Size; ++y)
+          for (unsigned int x = 0; x < Size; ++x)
+            *data++ = function(x, y, z, t);
+    }
+
+    return image;
+  }
+
+  /** Nested spheres as they occur in multi-label segmentations (see mitkCompressedImageContainerCodecTest). */
+  static unsigned short Label(unsigned int x, unsigned int y, unsigned int z, unsigned int t)
+  {
+    const double dx = x - 128.0 - t;
+    const double dy = y - 120.0;
+    const double dz = (z - 48.0) * 2.0;
+    const double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    return distance < 30 ? 3 : distance < 60 ? 2 : distance < 90 ? 1 : 0;
+  }
+
+  /** Body ellipse with soft tissue, a bone and deterministic noise (see mitkCompressedImageContainerCodecTest). */
+  static short CT(unsigned int x, unsigned int y, unsigned int z, unsigned int)
+  {
+    const double dx = (x - 128.0) / 110.0;
+    const double dy = (y - 128.0) / 80.0;
+
+    if (dx * dx + dy * dy > 1.0)
+      return -1000;
+
+    const auto noise = static_cast<short>(((x * 7919u) ^ (y * 104729u) ^ (z * 1299709u)) % 21) - 10;
+    const double bx = x - 128.0 - z * 0.2;
+    const double by = y - 160.0;
+
+    return static_cast<short>((bx * bx + by * by < 150.0 ? 700 : 40 + y / 8) + noise);
+  }
+
+  /** Reports ratio and throughput of all codecs. */
+  static void BenchmarkAllCodecs(const mitk::Image* image, const std::string& name)
+  {
+    for (const auto codec : { Codec::LZ4, Codec::XorDeltaLZ4, Codec::RunLengthDeltaLZ4 })
+    {
+      mitk::CompressedImageContainer container;
+      container.SetCodec(codec);
+
+      const auto start = std::chrono::steady_clock::now();
+      container.CompressImage(image);
+      const auto compressed = std::chrono::steady_clock::now();
+      auto decompressedImage = container.DecompressImage();
+      const auto decompressed = std::chrono::steady_clock::now();
+
+      CPPUNIT_ASSERT(decompressedImage.IsNotNull());
+
+      const double megabytes = container.GetUncompressedSize() / (1024.0 * 1024.0);
+
+      MITK_INFO << name << ", codec " << static_cast<int>(codec) << ": ratio "
+                << static_cast<double>(container.GetUncompressedSize()) / container.GetCompressedSize() << ", compression "
+                << megabytes / std::chrono::duration<double>(compressed - start).count() << " MB/s, decompression "
+                << megabytes / std::chrono::duration<double>(decompressed - compressed).count() << " MB/s";
+    }
+  }
+
+public:
+  void Benchmark()
+  {
+    BenchmarkAllCodecs(CreateImage<unsigned short>(1, Label), "Label image");
+    BenchmarkAllCodecs(CreateImage<short>(1, CT), "CT image");
+    BenchmarkAllCodecs(CreateImage<unsigned short>(3, Label), "3D+t label image");
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkCompressedImageContainerCodecBenchmark)
@@ -0,0 +1,194 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkCompressedImageContainer.h"
+
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+class mitkCompressedImageContainerCodecTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkCompressedImageContainerCodecTestSuite);
+
+  MITK_TEST(AllCodecs_LabelImage_RoundTrip);
+  MITK_TEST(AllCodecs_CTImage_RoundTrip);
+  MITK_TEST(AllCodecs_TimeSteps_RoundTrip);
+  MITK_TEST(DeltaCodecs_LabelImage_CompressBetter);
+  MITK_TEST(SwapOut_SwapIn_RoundTrip);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  using Codec = mitk::CompressedImageContainer::Codec;
+
+  static constexpr unsigned int Size = 256;
+  static constexpr unsigned int NumberOfSlices = 96;
+
+  mitk::Image::Pointer m_LabelImage;
+  mitk::Image::Pointer m_CTImage;
+
+  template <typename TPixel, typename TFunction>
+  static mitk::Image::Pointer CreateImage(unsigned int numberOfTimeSteps, TFunction function)
+  {
+    std::array<unsigned int, 4> dimensions = { { Size, Size, NumberOfSlices, numberOfTimeSteps } };
+
+    auto image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<TPixel>(), 1 < numberOfTimeSteps ? 4 : 3, dimensions.data());
+
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      mitk::ImageWriteAccessor accessor(image, image->GetVolumeData(t));
+      auto data = static_cast<TPixel*>(accessor.GetData());
+
+      for (unsigned int z = 0; z < NumberOfSlices; ++z)
+        for (unsigned int y = 0; y < Size; ++y)
+          for (unsigned int x = 0; x < Size; ++x)
+            *data++ = function(x, y, z, t);
+    }
+
+    return image;
+  }
+
+  /** Nested spheres as they occur in multi-label segmentations. */
+  static unsigned short Label(unsigned int x, unsigned int y, unsigned int z, unsigned int t)
+  {
+    const double dx = x - 128.0 - t;
+    const double dy = y - 120.0;
+    const double dz = (z - 48.0) * 2.0;
+    const double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    return distance < 30 ? 3 : distance < 60 ? 2 : distance < 90 ? 1 : 0;
+  }
+
+  /** Body ellipse with soft tissue, a bone and deterministic noise. */
+  static short CT(unsigned int x, unsigned int y, unsigned int z, unsigned int)
+  {
+    const double dx = (x - 128.0) / 110.0;
+    const double dy = (y - 128.0) / 80.0;
+
+    if (dx * dx + dy * dy > 1.0)
+      return -1000;
+
+    const auto noise = static_cast<short>(((x * 7919u) ^ (y * 104729u) ^ (z * 1299709u)) % 21) - 10;
+    const double bx = x - 128.0 - z * 0.2;
+    const double by = y - 160.0;
+
+    return static_cast<short>((bx * bx + by * by < 150.0 ? 700 : 40 + y / 8) + noise);
+  }
+
+  static bool Equal(const mitk::Image* image, const mitk::Image* other)
+  {
+    if (image->GetDimension() != other->GetDimension() || image->GetPixelType() != other->GetPixelType())
+      return false;
+
+    for (unsigned int t = 0; t < image->GetTimeSteps(); ++t)
+    {
+      mitk::ImageReadAccessor accessor(image, image->GetVolumeData(t));
+      mitk::ImageReadAccessor otherAccessor(other, other->GetVolumeData(t));
+      const auto numBytes = image->GetPixelType().GetSize() * Size * Size * NumberOfSlices;
+
+      if (0 != std::memcmp(accessor.GetData(), otherAccessor.GetData(), numBytes))
+        return false;
+    }
+
+    return true;
+  }
+
+  /** Round trip with all codecs. */
+  static void TestAllCodecs(const mitk::Image* image, const std::string& name)
+  {
+    for (const auto codec : { Codec::LZ4, Codec::XorDeltaLZ4, Codec::RunLengthDeltaLZ4 })
+    {
+      mitk::CompressedImageContainer container;
+      container.SetCodec(codec);
+      container.CompressImage(image);
+      auto decompressedImage = container.DecompressImage();
+
+      CPPUNIT_ASSERT_MESSAGE(name + ": round trip with codec " + std::to_string(static_cast<int>(codec)),
+                             Equal(image, decompressedImage));
+    }
+  }
+
+  static std::size_t CompressedSize(const mitk::Image* image, Codec codec)
+  {
+    mitk::CompressedImageContainer container;
+    container.SetCodec(codec);
+    container.CompressImage(image);
+
+    return container.GetCompressedSize();
+  }
+
+public:
+  void setUp() override
+  {
+    m_LabelImage = CreateImage<unsigned short>(1, Label);
+    m_CTImage = CreateImage<short>(1, CT);
+  }
+
+  void tearDown() override
+  {
+    m_LabelImage = nullptr;
+    m_CTImage = nullptr;
+  }
+
+  void AllCodecs_LabelImage_RoundTrip()
+  {
+    TestAllCodecs(m_LabelImage, "Label image");
+  }
+
+  void AllCodecs_CTImage_RoundTrip()
+  {
+    TestAllCodecs(m_CTImage, "CT image");
+  }
+
+  void AllCodecs_TimeSteps_RoundTrip()
+  {
+    TestAllCodecs(CreateImage<unsigned short>(3, Label), "3D+t label image");
+  }
+
+  void DeltaCodecs_LabelImage_CompressBetter()
+  {
+    const auto lz4Size = CompressedSize(m_LabelImage, Codec::LZ4);
+
+    CPPUNIT_ASSERT(CompressedSize(m_LabelImage, Codec::XorDeltaLZ4) < lz4Size);
+    CPPUNIT_ASSERT(CompressedSize(m_LabelImage, Codec::RunLengthDeltaLZ4) < lz4Size);
+  }
+
+  void SwapOut_SwapIn_RoundTrip()
+  {
+    mitk::CompressedImageContainer container;
+    container.SetCodec(Codec::RunLengthDeltaLZ4);
+    container.CompressImage(m_CTImage);
+
+    const auto footprint = container.GetMemoryFootprint();
+    const auto compressedSize = container.GetCompressedSize();
+    std::stringstream stream;
+    container.SwapOut(stream);
+
+    CPPUNIT_ASSERT(container.GetMemoryFootprint() < footprint);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), container.GetCompressedSize());
+
+    container.SwapIn(stream);
+
+    CPPUNIT_ASSERT_EQUAL(compressedSize, container.GetCompressedSize());
+    CPPUNIT_ASSERT(Equal(m_CTImage, container.DecompressImage()));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkCompressedImageContainerCodec)
@@ -145,10 +145,15 @@ int mitkCompressedImageContainerTest(int argc, char *argv[])
 
   std::cout << "  (II) Could load image." << std::endl;
 
+  for (const auto codec : { mitk::CompressedImageContainer::Codec::LZ4,
+                            mitk::CompressedImageContainer::Codec::XorDeltaLZ4,
+                            mitk::CompressedImageContainer::Codec::RunLengthDeltaLZ4 })
   {
     mitk::CompressedImageContainer container;
+    container.SetCodec(codec);
 
     // some real work
+    std::cout << "Testing codec " << static_cast<int>(codec) << std::endl;
     mitkCompressedImageContainerTestClass::Test(&container, image, numberFailed);
 
     std::cout << "Testing destruction" << std::endl;
@@ -7,4 +7,5 @@ set(H_FILES
   itkShortestPathNode.h
   itkShortestPathImageFilter.h
   itkShortestPathCostFunctionLiveWire.h
+  itkLiveWireShortestPathEngine.h
 )
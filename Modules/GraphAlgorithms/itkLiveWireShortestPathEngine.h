@@ -0,0 +1,151 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef __itkLiveWireShortestPathEngine_h
+#define __itkLiveWireShortestPathEngine_h
+
+#include "itkShortestPathCostFunctionLiveWire.h"
+#include "itkShortestPathNode.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace itk
+{
+  /** \brief One-to-all shortest path search for interactive LiveWire segmentation.
+
+  Contrary to ShortestPathImageFilter, which searches a new path for every pair of start and end point,
+  this engine keeps the search tree of a fixed anchor point. The costs of ShortestPathCostFunctionLiveWire
+  are computed once per slice into a flat buffer. Afterwards, a Dijkstra search expands from the anchor
+  only as far as needed to reach the requested target and continues where it stopped for the next target.
+  Paths to targets that have already been reached are obtained by backtracking the predecessors, thus
+  moving the mouse around the anchor does not trigger new searches.
+
+  The search uses a radix queue, i.e. a monotone priority queue that exploits that the extracted distances
+  never decrease. Distances are non-negative doubles, whose bit patterns are ordered like the values.
+
+  The costs are recomputed as soon as the cost function (e.g. its image or its dynamic cost map) is modified.
+  Repulsive points of the cost function are considered during the search; after changing them,
+  ResetSearch() has to be called.
+
+  Only 2D images are supported, like by ShortestPathCostFunctionLiveWire.
+  */
+  template <class TInputImageType>
+  class ITK_EXPORT LiveWireShortestPathEngine : public Object
+  {
+  public:
+    /** Standard class typedefs. */
+    typedef LiveWireShortestPathEngine Self;
+    typedef Object Superclass;
+    typedef SmartPointer<Self> Pointer;
+    typedef SmartPointer<const Self> ConstPointer;
+
+    /** Method for creation through the object factory. */
+    itkFactorylessNewMacro(Self);
+
+    /** Run-time type information (and related methods). */
+    itkTypeMacro(LiveWireShortestPathEngine, Object);
+
+    typedef TInputImageType ImageType;
+    typedef typename ImageType::IndexType IndexType;
+    typedef typename ImageType::RegionType RegionType;
+    typedef ShortestPathCostFunctionLiveWire<ImageType> CostFunctionType;
+    typedef std::vector<IndexType> PathType;
+
+    static_assert(ImageType::ImageDimension == 2, "LiveWireShortestPathEngine only supports 2D images.");
+
+    /** \brief Set the cost function. Its image defines the search domain.*/
+    itkSetObjectMacro(CostFunction, CostFunctionType);
+    itkGetModifiableObjectMacro(CostFunction, CostFunctionType);
+
+    /** \brief Use the 8-neighborhood (default) instead of the 4-neighborhood.*/
+    itkSetMacro(FullNeighbors, bool);
+    itkGetConstMacro(FullNeighbors, bool);
+    itkBooleanMacro(FullNeighbors);
+
+    /** \brief Set the anchor of the search. Changing it discards the search tree.*/
+    void SetAnchorIndex(const IndexType &index);
+    itkGetConstReferenceMacro(AnchorIndex, IndexType);
+
+    /** \brief Discard the search tree, e.g. because repulsive points of the cost function changed.*/
+    void ResetSearch();
+
+    /** \brief Compute the shortest path from the anchor to target (both included).
+    The search is only expanded if target has not been reached yet.
+    \return False if the anchor or target is outside the image.*/
+    bool GetPath(const IndexType &target, PathType &path);
+
+    /** \brief Number of pixels whose shortest path from the anchor is known.*/
+    itkGetConstMacro(NumberOfSettledNodes, SizeValueType);
+
+  protected:
+    LiveWireShortestPathEngine();
+    ~LiveWireShortestPathEngine() override{};
+
+  private:
+    LiveWireShortestPathEngine(const Self &); // purposely not implemented
+    void operator=(const Self &);             // purposely not implemented
+
+    /** \brief Monotone priority queue for non-negative keys.
+    An entry is stored in the bucket of the highest bit in which its key differs from the last extracted key.
+    Extracting from an empty bucket 0 redistributes the lowest non-empty bucket.*/
+    class RadixQueue
+    {
+    public:
+      void Clear();
+      bool IsEmpty() const { return m_Size == 0; }
+      void Push(double key, NodeNumType node);
+      NodeNumType Pop(double &key);
+
+    private:
+      typedef std::pair<std::uint64_t, NodeNumType> EntryType;
+
+      static std::uint64_t ToKey(double key);
+      static double FromKey(std::uint64_t key);
+      unsigned int GetBucket(std::uint64_t key) const;
+
+      std::array<std::vector<EntryType>, 65> m_Buckets;
+      std::uint64_t m_Last = 0;
+      std::size_t m_Size = 0;
+    };
+
+    void UpdateCosts();
+    void InitializeSearch();
+    void ExpandUntilSettled(NodeNumType target);
+
+    NodeNumType IndexToNode(const IndexType &index) const;
+    IndexType NodeToIndex(NodeNumType node) const;
+
+    typename CostFunctionType::Pointer m_CostFunction;
+    bool m_FullNeighbors;
+    IndexType m_AnchorIndex;
+
+    RegionType m_Region;
+    std::vector<float> m_Costs;
+    TimeStamp m_CostsTime;
+
+    bool m_SearchInitialized;
+    std::vector<double> m_Distances;
+    std::vector<NodeNumType> m_Predecessors;
+    std::vector<unsigned char> m_Settled;
+    RadixQueue m_Queue;
+    SizeValueType m_NumberOfSettledNodes;
+  };
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLiveWireShortestPathEngine.txx"
+#endif
+
+#endif /* __itkLiveWireShortestPathEngine_h */
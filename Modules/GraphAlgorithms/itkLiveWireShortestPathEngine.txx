@@ -0,0 +1,313 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef __itkLiveWireShortestPathEngine_txx
+#define __itkLiveWireShortestPathEngine_txx
+
+#include "itkLiveWireShortestPathEngine.h"
+
+#include <itkMultiThreaderBase.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace itk
+{
+  template <class TInputImageType>
+  void LiveWireShortestPathEngine<TInputImageType>::RadixQueue::Clear()
+  {
+    for (auto &bucket : m_Buckets)
+      bucket.clear();
+
+    m_Last = 0;
+    m_Size = 0;
+  }
+
+  template <class TInputImageType>
+  std::uint64_t LiveWireShortestPathEngine<TInputImageType>::RadixQueue::ToKey(double key)
+  {
+    // the bit patterns of non-negative doubles are ordered like their values
+    std::uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+  }
+
+  template <class TInputImageType>
+  double LiveWireShortestPathEngine<TInputImageType>::RadixQueue::FromKey(std::uint64_t key)
+  {
+    double value;
+    std::memcpy(&value, &key, sizeof(value));
+    return value;
+  }
+
+  template <class TInputImageType>
+  unsigned int LiveWireShortestPathEngine<TInputImageType>::RadixQueue::GetBucket(std::uint64_t key) const
+  {
+    // number of significant bits of key ^ m_Last, i.e. 0 if key equals the last extracted key
+    std::uint64_t difference = key ^ m_Last;
+    unsigned int bucket = 0;
+
+    for (unsigned int shift = 32; shift > 0; shift /= 2)
+    {
+      if ((difference >> shift) != 0)
+      {
+        difference >>= shift;
+        bucket += shift;
+      }
+    }
+
+    return bucket + static_cast<unsigned int>(difference);
+  }
+
+  template <class TInputImageType>
+  void LiveWireShortestPathEngine<TInputImageType>::RadixQueue::Push(double key, NodeNumType node)
+  {
+    const auto bits = ToKey(key);
+    m_Buckets[this->GetBucket(bits)].emplace_back(bits, node);
+    ++m_Size;
+  }
+
+  template <class TInputImageType>
+  NodeNumType LiveWireShortestPathEngine<TInputImageType>::RadixQueue::Pop(double &key)
+  {
+    if (m_Buckets[0].empty())
+    {
+      unsigned int i = 1;
+      while (m_Buckets[i].empty())
+        ++i;
+
+      auto &bucket = m_Buckets[i];
+      m_Last = std::min_element(bucket.begin(), bucket.end())->first;
+
+      // all entries of bucket i move to lower buckets
+      for (const auto &entry : bucket)
+        m_Buckets[this->GetBucket(entry.first)].push_back(entry);
+
+      bucket.clear();
+    }
+
+    const auto entry = m_Buckets[0].back();
+    m_Buckets[0].pop_back();
+    --m_Size;
+
+    key = FromKey(entry.first);
+    return entry.second;
+  }
+
+  template <class TInputImageType>
+  LiveWireShortestPathEngine<TInputImageType>::LiveWireShortestPathEngine()
+    : m_FullNeighbors(true), m_SearchInitialized(false), m_NumberOfSettledNodes(0)
+  {
+    m_AnchorIndex.Fill(0);
+  }
+
+  template <class TInputImageType>
+  void LiveWireShortestPathEngine<TInputImageType>::SetAnchorIndex(const IndexType &index)
+  {
+    if (m_AnchorIndex != index)
+    {
+      m_AnchorIndex = index;
+      this->ResetSearch();
+    }
+  }
+
+  template <class TInputImageType>
+  void LiveWireShortestPathEngine<TInputImageType>::ResetSearch()
+  {
+    m_SearchInitialized = false;
+  }
+
+  template <class TInputImageType>
+  inline NodeNumType LiveWireShortestPathEngine<TInputImageType>::IndexToNode(const IndexType &index) const
+  {
+    return static_cast<NodeNumType>((index[1] - m_Region.GetIndex(1)) * m_Region.GetSize(0) +
+                                    (index[0] - m_Region.GetIndex(0)));
+  }
+
+  template <class TInputImageType>
+  inline typename LiveWireShortestPathEngine<TInputImageType>::IndexType
+    LiveWireShortestPathEngine<TInputImageType>::NodeToIndex(NodeNumType node) const
+  {
+    IndexType index;
+    index[0] = m_Region.GetIndex(0) + static_cast<IndexValueType>(node % m_Region.GetSize(0));
+    index[1] = m_Region.GetIndex(1) + static_cast<IndexValueType>(node / m_Region.GetSize(0));
+    return index;
+  }
+
+  template <class TInputImageType>
+  void LiveWireShortestPathEngine<TInputImageType>::UpdateCosts()
+  {
+    const ImageType *image = m_CostFunction->GetImage();
+
+    if (!m_Costs.empty() && m_CostsTime.GetMTime() > m_CostFunction->GetMTime() &&
+        m_CostsTime.GetMTime() > image->GetMTime())
+    {
+      return;
+    }
+
+    m_Region = image->GetLargestPossibleRegion();
+
+    // computes the feature images on first use
+    m_CostFunction->SetStartIndex(m_AnchorIndex);
+    m_CostFunction->SetEndIndex(m_AnchorIndex);
+    m_CostFunction->Initialize();
+
+    const auto width = m_Region.GetSize(0);
+    const auto height = m_Region.GetSize(1);
+    m_Costs.resize(width * height);
+
+    const CostFunctionType *costFunction = m_CostFunction;
+
+    MultiThreaderBase::New()->ParallelizeArray(
+      0,
+      height,
+      [this, costFunction, width](SizeValueType y) {
+        IndexType index;
+        index[1] = m_Region.GetIndex(1) + static_cast<IndexValueType>(y);
+        float *costs = m_Costs.data() + y * width;
+
+        for (SizeValueType x = 0; x < width; ++x)
+        {
+          index[0] = m_Region.GetIndex(0) + static_cast<IndexValueType>(x);
+          const double cost = costFunction->GetPixelCost(index);
+
+          // Dijkstra requires non-negative costs; an undefined cost (e.g. on a constant image) is free
+          costs[x] = cost > 0.0 ? static_cast<float>(cost) : 0.0f;
+        }
+      },
+      nullptr);
+
+    m_CostsTime.Modified();
+    m_SearchInitialized = false;
+  }
+
+  template <class TInputImageType>
+  void LiveWireShortestPathEngine<TInputImageType>::InitializeSearch()
+  {
+    const auto numberOfNodes = m_Costs.size();
+
+    m_Distances.assign(numberOfNodes, std::numeric_limits<double>::infinity());
+    m_Predecessors.resize(numberOfNodes);
+    m_Settled.assign(numberOfNodes, 0);
+    m_NumberOfSettledNodes = 0;
+
+    const auto anchor = this->IndexToNode(m_AnchorIndex);
+    m_Distances[anchor] = 0.0;
+    m_Predecessors[anchor] = anchor;
+
+    m_Queue.Clear();
+    m_Queue.Push(0.0, anchor);
+
+    m_SearchInitialized = true;
+  }
+
+  template <class TInputImageType>
+  void LiveWireShortestPathEngine<TInputImageType>::ExpandUntilSettled(NodeNumType target)
+  {
+    const auto width = static_cast<long long>(m_Region.GetSize(0));
+    const auto height = static_cast<long long>(m_Region.GetSize(1));
+    const unsigned char *mask = m_CostFunction->GetMaskImage()->GetBufferPointer();
+
+    const int numberOfNeighbors = m_FullNeighbors ? 8 : 4;
+    static const int offsetX[8] = { 0, 1, 0, -1, -1, 1, -1, 1 };
+    static const int offsetY[8] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+    static const double diagonal = std::sqrt(2.0);
+    static const double distanceScale[8] = { 1.0, 1.0, 1.0, 1.0, diagonal, diagonal, diagonal, diagonal };
+
+    while (!m_Settled[target] && !m_Queue.IsEmpty())
+    {
+      double distance;
+      const auto node = m_Queue.Pop(distance);
+
+      // the queue may hold outdated entries of nodes whose distance was lowered later on
+      if (m_Settled[node] || distance > m_Distances[node])
+        continue;
+
+      m_Settled[node] = 1;
+      ++m_NumberOfSettledNodes;
+
+      const long long x = node % width;
+      const long long y = node / width;
+
+      for (int i = 0; i < numberOfNeighbors; ++i)
+      {
+        const long long neighborX = x + offsetX[i];
+        const long long neighborY = y + offsetY[i];
+
+        if (neighborX < 0 || neighborX >= width || neighborY < 0 || neighborY >= height)
+          continue;
+
+        const auto neighbor = static_cast<NodeNumType>(neighborY * width + neighborX);
+
+        if (m_Settled[neighbor])
+          continue;
+
+        const double cost = (mask[node] != 0 || mask[neighbor] != 0)
+                              ? static_cast<double>(CostFunctionType::REPULSIVEPOINTCOSTS)
+                              : m_Costs[neighbor] * distanceScale[i];
+
+        const double newDistance = distance + cost;
+
+        if (newDistance < m_Distances[neighbor])
+        {
+          m_Distances[neighbor] = newDistance;
+          m_Predecessors[neighbor] = node;
+          m_Queue.Push(newDistance, neighbor);
+        }
+      }
+    }
+  }
+
+  template <class TInputImageType>
+  bool LiveWireShortestPathEngine<TInputImageType>::GetPath(const IndexType &target, PathType &path)
+  {
+    path.clear();
+
+    if (m_CostFunction.IsNull() || nullptr == m_CostFunction->GetImage())
+    {
+      itkExceptionMacro("No cost function or no image set.");
+    }
+
+    const RegionType region = m_CostFunction->GetImage()->GetLargestPossibleRegion();
+
+    if (!region.IsInside(m_AnchorIndex) || !region.IsInside(target))
+      return false;
+
+    this->UpdateCosts();
+
+    if (!m_SearchInitialized)
+      this->InitializeSearch();
+
+    const auto targetNode = this->IndexToNode(target);
+    this->ExpandUntilSettled(targetNode);
+
+    if (!m_Settled[targetNode])
+      return false;
+
+    const auto anchorNode = this->IndexToNode(m_AnchorIndex);
+
+    for (auto node = targetNode; node != anchorNode; node = m_Predecessors[node])
+    {
+      path.push_back(this->NodeToIndex(node));
+    }
+
+    path.push_back(m_AnchorIndex);
+    std::reverse(path.begin(), path.end());
+
+    return true;
+  }
+
+} // end namespace itk
+
+#endif // __itkLiveWireShortestPathEngine_txx
@@ -44,6 +44,7 @@ namespace itk
 
     // \brief Set the input image.
     itkSetConstObjectMacro(Image, TInputImageType);
+    itkGetConstObjectMacro(Image, TInputImageType);
 
     // \brief Calculate the cost for going from pixel p1 to pixel p2
     virtual double GetCost(IndexType p1, IndexType p2) = 0;
@@ -68,6 +68,11 @@ namespace itk
     /** \brief calculates the costs for going from p1 to p2*/
     double GetCost(IndexType p1, IndexType p2) override;
 
+    /** \brief calculates the costs for entering pixel p from a horizontal or vertical neighbor.
+    Repulsive points are not considered. GetCost() scales this value by the euclidian distance of p1 and p2,
+    thus the costs of all links of an initialized metric can be precomputed per pixel.*/
+    double GetPixelCost(const IndexType &p) const;
+
     /** \brief returns the minimal costs possible (needed for A*)*/
     double GetMinCost() override;
 
@@ -96,14 +101,22 @@ namespace itk
       this->Modified();
     }
 
-    void SetUseCostMap(bool useCostMap) { this->m_UseCostMap = useCostMap; }
+    void SetUseCostMap(bool useCostMap)
+    {
+      if (this->m_UseCostMap != useCostMap)
+      {
+        this->m_UseCostMap = useCostMap;
+        this->Modified();
+      }
+    }
     /**
      \brief Set the maximum of the dynamic cost map to save computation time.
     */
     void SetCostMapMaximum(double max) { this->m_MaxMapCosts = max; }
     enum Constants
     {
-      MAPSCALEFACTOR = 10
+      MAPSCALEFACTOR = 10,
+      REPULSIVEPOINTCOSTS = 1000
     };
 
     /** \brief Returns the y value of gaussian with given offset and amplitude
@@ -76,6 +76,36 @@ namespace itk
 
   template <class TInputImageType>
   double ShortestPathCostFunctionLiveWire<TInputImageType>::GetCost(IndexType p1, IndexType p2)
+  {
+    // if we are on the mask, return asap
+    if (m_UseRepulsivePoints)
+    {
+      if ((this->m_MaskImage->GetPixel(p1) != 0) || (this->m_MaskImage->GetPixel(p2) != 0))
+        return REPULSIVEPOINTCOSTS;
+    }
+
+    double costs = this->GetPixelCost(p2);
+
+    // scale by euclidian distance
+    double costScale;
+    if (p1[0] == p2[0] || p1[1] == p2[1])
+    {
+      // horizontal or vertical neighbor
+      costScale = 1.0;
+    }
+    else
+    {
+      // diagonal neighbor
+      costScale = sqrt(2.0);
+    }
+
+    costs *= costScale;
+
+    return costs;
+  }
+
+  template <class TInputImageType>
+  double ShortestPathCostFunctionLiveWire<TInputImageType>::GetPixelCost(const IndexType &p2) const
   {
     // local component costs
     // weights
@@ -84,13 +114,6 @@ namespace itk
     double w3;
     double costs = 0.0;
 
-    // if we are on the mask, return asap
-    if (m_UseRepulsivePoints)
-    {
-      if ((this->m_MaskImage->GetPixel(p1) != 0) || (this->m_MaskImage->GetPixel(p2) != 0))
-        return 1000;
-    }
-
     double gradientX, gradientY;
     gradientX = gradientY = 0.0;
 
@@ -105,19 +128,19 @@ namespace itk
 
     if (m_UseCostMap && !m_CostMap.empty())
     {
-      std::map<int, int>::iterator end = m_CostMap.end();
-      std::map<int, int>::iterator last = --(m_CostMap.end());
+      std::map<int, int>::const_iterator end = m_CostMap.end();
+      std::map<int, int>::const_iterator last = --(m_CostMap.end());
 
       // current position
-      std::map<int, int>::iterator x;
+      std::map<int, int>::const_iterator x;
       // std::map< int, int >::key_type keyOfX = static_cast<std::map< int, int >::key_type>(gradientMagnitude * 1000);
       int keyOfX = static_cast<int>(gradientMagnitude /* ShortestPathCostFunctionLiveWire::MAPSCALEFACTOR*/);
       x = m_CostMap.find(keyOfX);
 
-      std::map<int, int>::iterator left2;
-      std::map<int, int>::iterator left1;
-      std::map<int, int>::iterator right1;
-      std::map<int, int>::iterator right2;
+      std::map<int, int>::const_iterator left2;
+      std::map<int, int>::const_iterator left1;
+      std::map<int, int>::const_iterator right1;
+      std::map<int, int>::const_iterator right2;
 
       if (x == end)
       { // x can also be == end if the key is not in the map but between two other keys
@@ -245,9 +268,10 @@ namespace itk
     nGradientAtP2[1] /= m_GradientMagnitudeImage->GetPixel(p2);
 
     double scalarProduct = (nGradientAtP1[0] * nGradientAtP2[0]) + (nGradientAtP1[1] * nGradientAtP2[1]);
-    if (std::abs(scalarProduct) >= 1.0)
+    if (!(std::abs(scalarProduct) < 1.0))
     {
       // this should probably not happen; make sure the input for acos is valid
+      // (also covers a vanishing gradient, whose direction is undefined)
       scalarProduct = 0.999999999;
     }
 
@@ -267,21 +291,6 @@ namespace itk
     }
     costs = w1 * laplacianCost + w2 * gradientCost + w3 * gradientDirectionCost;
 
-    // scale by euclidian distance
-    double costScale;
-    if (p1[0] == p2[0] || p1[1] == p2[1])
-    {
-      // horizontal or vertical neighbor
-      costScale = 1.0;
-    }
-    else
-    {
-      // diagonal neighbor
-      costScale = sqrt(2.0);
-    }
-
-    costs *= costScale;
-
     return costs;
   }
 
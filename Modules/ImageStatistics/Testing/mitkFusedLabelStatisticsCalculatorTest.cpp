@@ -0,0 +1,306 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkFusedLabelStatisticsCalculator.h>
+#include <mitkImageStatisticsCalculator.h>
+#include <mitkImageMaskGenerator.h>
+#include <mitkImageStatisticsConstants.h>
+#include <mitkLabelStatisticsImageFilter.h>
+#include <mitkMinMaxImageFilterWithIndex.h>
+#include <mitkMinMaxLabelmageFilterWithIndex.h>
+#include <mitkStatisticsImageFilter.h>
+
+#include <mitkImageCast.h>
+#include <mitkProportionalTimeGeometry.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <cmath>
+
+class mitkFusedLabelStatisticsCalculatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkFusedLabelStatisticsCalculatorTestSuite);
+
+  MITK_TEST(ShortImage_EqualsLabelStatisticsFilter);
+  MITK_TEST(ShortImageManyLabels_EqualsLabelStatisticsFilter);
+  MITK_TEST(FloatImage_EqualsLabelStatisticsFilter);
+  MITK_TEST(UnsignedCharImageWithoutMask_EqualsStatisticsFilter);
+  MITK_TEST(ImageStatisticsCalculator_AllTimeStepsAndCacheReuse);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static constexpr unsigned int Size = 64;
+  static constexpr double Tolerance = 1e-9;
+
+  using MaskType = itk::Image<unsigned short, 3>;
+
+  template <typename TPixel, typename TFunction>
+  static typename itk::Image<TPixel, 3>::Pointer CreateImage(TFunction function)
+  {
+    using ImageType = itk::Image<TPixel, 3>;
+
+    typename ImageType::RegionType region;
+    region.SetSize({ { Size, Size, Size / 2 } });
+
+    typename ImageType::SpacingType spacing;
+    spacing.Fill(0.5);
+
+    auto image = ImageType::New();
+    image->SetRegions(region);
+    image->SetSpacing(spacing);
+    image->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const auto& index = it.GetIndex();
+      it.Set(function(index[0], index[1], index[2]));
+    }
+
+    return image;
+  }
+
+  /** Concentric shells around a center that is not aligned to the chunks.*/
+  static MaskType::Pointer CreateMask(unsigned int numberOfLabels)
+  {
+    return CreateImage<unsigned short>([numberOfLabels](long x, long y, long z)
+    {
+      const double distance = std::sqrt((x - 30.5) * (x - 30.5) + (y - 27.0) * (y - 27.0) + (z - 13.0) * (z - 13.0) * 4);
+      return static_cast<unsigned short>(std::min<double>(distance / 40.0 * numberOfLabels, numberOfLabels));
+    });
+  }
+
+  static short ShortValue(long x, long y, long z)
+  {
+    return static_cast<short>(((x * 7919 + y * 104729 + z * 1299709) % 2000) - 1000);
+  }
+
+  static void AssertEqual(double expected, double actual, const std::string& name)
+  {
+    const auto tolerance = Tolerance * std::max(1.0, std::abs(expected));
+
+    if (std::isnan(expected))
+      CPPUNIT_ASSERT_MESSAGE(name, std::isnan(actual));
+    else
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(name, expected, actual, tolerance);
+  }
+
+  template <typename THistogram, typename TOtherHistogram>
+  static void AssertEqualHistograms(const THistogram* expected, const TOtherHistogram* actual)
+  {
+    CPPUNIT_ASSERT_EQUAL(expected->GetSize(0), actual->GetSize(0));
+    CPPUNIT_ASSERT_EQUAL(expected->GetBinMin(0, 0), actual->GetBinMin(0, 0));
+    CPPUNIT_ASSERT_EQUAL(expected->GetBinMax(0, expected->GetSize(0) - 1), actual->GetBinMax(0, actual->GetSize(0) - 1));
+
+    for (unsigned int bin = 0; bin < expected->GetSize(0); ++bin)
+      CPPUNIT_ASSERT_EQUAL(expected->GetFrequency(bin), actual->GetFrequency(bin));
+  }
+
+  /** Compares the calculator with the filters ImageStatisticsCalculator used so far.*/
+  template <typename TImage>
+  static void TestAgainstLabelStatisticsFilter(const TImage* image, const MaskType* mask, unsigned int numberOfBins)
+  {
+    using MinMaxFilterType = itk::MinMaxLabelImageFilterWithIndex<TImage, MaskType>;
+    using StatisticsFilterType = mitk::LabelStatisticsImageFilter<TImage>;
+
+    auto minMaxFilter = MinMaxFilterType::New();
+    minMaxFilter->SetInput(image);
+    minMaxFilter->SetLabelInput(mask);
+    minMaxFilter->UpdateLargestPossibleRegion();
+
+    std::unordered_map<unsigned short, unsigned int> sizes;
+    std::unordered_map<unsigned short, double> lowerBounds;
+    std::unordered_map<unsigned short, double> upperBounds;
+
+    for (auto label : minMaxFilter->GetRelevantLabels())
+    {
+      sizes[label] = numberOfBins;
+      lowerBounds[label] = minMaxFilter->GetMin(label);
+      upperBounds[label] = minMaxFilter->GetMax(label);
+    }
+
+    auto statisticsFilter = StatisticsFilterType::New();
+    statisticsFilter->SetInput(image);
+    statisticsFilter->SetLabelInput(mask);
+    statisticsFilter->SetHistogramParameters(sizes, lowerBounds, upperBounds);
+    statisticsFilter->Update();
+
+    mitk::FusedLabelStatisticsCalculator<TImage> calculator;
+    calculator.SetInput(image);
+    calculator.SetLabelInput(mask);
+    calculator.SetNumberOfBins(numberOfBins);
+    calculator.Compute();
+
+    const auto& labelStatistics = calculator.GetLabelStatistics();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(statisticsFilter->GetNumberOfLabels()), labelStatistics.size());
+
+    for (const auto& labelAndStatistics : labelStatistics)
+    {
+      const auto label = labelAndStatistics.first;
+      const auto& statistics = labelAndStatistics.second;
+      const auto name = "Label " + std::to_string(label);
+
+      CPPUNIT_ASSERT_MESSAGE(name, statisticsFilter->HasLabel(label));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(name, statisticsFilter->GetCount(label), statistics.m_Count);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(name, statisticsFilter->GetMinimum(label), statistics.m_Min);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(name, statisticsFilter->GetMaximum(label), statistics.m_Max);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(name, minMaxFilter->GetMinIndex(label), statistics.m_MinIndex);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(name, minMaxFilter->GetMaxIndex(label), statistics.m_MaxIndex);
+
+      AssertEqual(statisticsFilter->GetMean(label), statistics.m_Mean, name + " mean");
+      AssertEqual(statisticsFilter->GetVariance(label), statistics.m_Variance, name + " variance");
+      AssertEqual(statisticsFilter->GetSkewness(label), statistics.m_Skewness, name + " skewness");
+      AssertEqual(statisticsFilter->GetKurtosis(label), statistics.m_Kurtosis, name + " kurtosis");
+      AssertEqual(statisticsFilter->GetMPP(label), statistics.m_MPP, name + " MPP");
+      AssertEqual(statisticsFilter->GetMedian(label), statistics.m_Median, name + " median");
+      AssertEqual(statisticsFilter->GetEntropy(label), statistics.m_Entropy, name + " entropy");
+      AssertEqual(statisticsFilter->GetUniformity(label), statistics.m_Uniformity, name + " uniformity");
+      AssertEqual(statisticsFilter->GetUPP(label), statistics.m_UPP, name + " UPP");
+
+      AssertEqualHistograms(statisticsFilter->GetHistogram(label).GetPointer(), statistics.m_Histogram.GetPointer());
+    }
+  }
+
+public:
+  void ShortImage_EqualsLabelStatisticsFilter()
+  {
+    auto image = CreateImage<short>(ShortValue);
+    TestAgainstLabelStatisticsFilter(image.GetPointer(), CreateMask(3).GetPointer(), 100);
+  }
+
+  void ShortImageManyLabels_EqualsLabelStatisticsFilter()
+  {
+    // more labels than pixel values can be counted for, so some labels need the histogram pass
+    auto image = CreateImage<short>(ShortValue);
+    TestAgainstLabelStatisticsFilter(image.GetPointer(), CreateMask(12).GetPointer(), 25);
+  }
+
+  void FloatImage_EqualsLabelStatisticsFilter()
+  {
+    auto image = CreateImage<float>([](long x, long y, long z)
+    {
+      return static_cast<float>(200.0 + std::sin(x * 0.3) * 100.0 + std::cos(y * 0.2) * 50.0 - z * 0.75);
+    });
+
+    TestAgainstLabelStatisticsFilter(image.GetPointer(), CreateMask(4).GetPointer(), 100);
+  }
+
+  void UnsignedCharImageWithoutMask_EqualsStatisticsFilter()
+  {
+    using ImageType = itk::Image<unsigned char, 3>;
+    auto image = CreateImage<unsigned char>([](long x, long y, long z)
+    {
+      return static_cast<unsigned char>((x * 3 + y * 5 + z * 7) % 200 + 20);
+    });
+
+    auto minMaxFilter = itk::MinMaxImageFilterWithIndex<ImageType>::New();
+    minMaxFilter->SetInput(image);
+    minMaxFilter->UpdateLargestPossibleRegion();
+
+    auto statisticsFilter = mitk::StatisticsImageFilter<ImageType>::New();
+    statisticsFilter->SetInput(image);
+    statisticsFilter->SetHistogramParameters(50, minMaxFilter->GetMin(), minMaxFilter->GetMax());
+    statisticsFilter->Update();
+
+    mitk::FusedLabelStatisticsCalculator<ImageType> calculator;
+    calculator.SetInput(image);
+    calculator.SetNumberOfBins(50);
+    calculator.Compute();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), calculator.GetLabelStatistics().size());
+
+    const auto& statistics = calculator.GetLabelStatistics().at(1);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<itk::SizeValueType>(image->GetLargestPossibleRegion().GetNumberOfPixels()), statistics.m_Count);
+    CPPUNIT_ASSERT_EQUAL(statisticsFilter->GetMinimum(), statistics.m_Min);
+    CPPUNIT_ASSERT_EQUAL(statisticsFilter->GetMaximum(), statistics.m_Max);
+    CPPUNIT_ASSERT_EQUAL(minMaxFilter->GetMinIndex(), statistics.m_MinIndex);
+    CPPUNIT_ASSERT_EQUAL(minMaxFilter->GetMaxIndex(), statistics.m_MaxIndex);
+
+    AssertEqual(statisticsFilter->GetMean(), statistics.m_Mean, "mean");
+    AssertEqual(statisticsFilter->GetVariance(), statistics.m_Variance, "variance");
+    AssertEqual(statisticsFilter->GetSkewness(), statistics.m_Skewness, "skewness");
+    AssertEqual(statisticsFilter->GetKurtosis(), statistics.m_Kurtosis, "kurtosis");
+    AssertEqual(statisticsFilter->GetMPP(), statistics.m_MPP, "MPP");
+    AssertEqual(statisticsFilter->GetMedian(), statistics.m_Median, "median");
+    AssertEqual(statisticsFilter->GetEntropy(), statistics.m_Entropy, "entropy");
+
+    AssertEqualHistograms(statisticsFilter->GetHistogram().GetPointer(), statistics.m_Histogram.GetPointer());
+  }
+
+  void ImageStatisticsCalculator_AllTimeStepsAndCacheReuse()
+  {
+    constexpr unsigned int numberOfTimeSteps = 8;
+
+    auto image = mitk::Image::New();
+    auto mask = mitk::Image::New();
+    auto timeStepImage = CreateImage<short>(ShortValue);
+    auto maskImage = CreateMask(3);
+
+    mitk::CastToMitkImage(maskImage, mask);
+
+    auto timeGeometry = mitk::ProportionalTimeGeometry::New();
+    timeGeometry->Initialize(mask->GetGeometry()->Clone(), numberOfTimeSteps);
+
+    image->Initialize(mitk::MakeScalarPixelType<short>(), *timeGeometry);
+
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      // timesteps differ in an offset
+      itk::ImageRegionIterator<itk::Image<short, 3>> it(timeStepImage, timeStepImage->GetLargestPossibleRegion());
+      for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+        it.Set(it.Get() + 1);
+
+      image->SetVolume(timeStepImage->GetBufferPointer(), t);
+    }
+
+    auto maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetInputImage(image);
+    maskGenerator->SetImageMask(mask);
+
+    auto calculator = mitk::ImageStatisticsCalculator::New();
+    calculator->SetInputImage(image);
+    calculator->SetMask(maskGenerator);
+
+    auto statistics = calculator->GetStatistics(2);
+
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      CPPUNIT_ASSERT(statistics->TimeStepExists(t));
+    }
+
+    const auto meanOfTimeStep0 = statistics->GetStatisticsForTimeStep(0).GetValueConverted<double>(mitk::ImageStatisticsConstants::MEAN());
+    const auto meanOfLastTimeStep = statistics->GetStatisticsForTimeStep(numberOfTimeSteps - 1).GetValueConverted<double>(mitk::ImageStatisticsConstants::MEAN());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(meanOfTimeStep0 + numberOfTimeSteps - 1, meanOfLastTimeStep, 1e-6);
+
+    // a new histogram parameter reuses the generated masks and time slices
+    calculator->SetNBinsForHistogramStatistics(20);
+    statistics = calculator->GetStatistics(2);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(20), static_cast<std::size_t>(statistics->GetStatisticsForTimeStep(0).m_Histogram->GetSize(0)));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(meanOfTimeStep0,
+      statistics->GetStatisticsForTimeStep(0).GetValueConverted<double>(mitk::ImageStatisticsConstants::MEAN()), 1e-6);
+
+    // modified masks are regenerated
+    mask->Modified();
+    maskGenerator->Modified();
+    statistics = calculator->GetStatistics(2);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(meanOfTimeStep0,
+      statistics->GetStatisticsForTimeStep(0).GetValueConverted<double>(mitk::ImageStatisticsConstants::MEAN()), 1e-6);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkFusedLabelStatisticsCalculator)
@@ -26,6 +26,7 @@ set(H_FILES
   mitkPointSetStatisticsCalculator.h
   mitkStatisticsImageFilter.h
   mitkLabelStatisticsImageFilter.h
+  mitkFusedLabelStatisticsCalculator.h
   mitkHotspotMaskGenerator.h
   mitkMaskGenerator.h
   mitkPlanarFigureMaskGenerator.h
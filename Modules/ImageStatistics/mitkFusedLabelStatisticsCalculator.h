@@ -0,0 +1,200 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkFusedLabelStatisticsCalculator_h
+#define mitkFusedLabelStatisticsCalculator_h
+
+#include <itkCompensatedSummation.h>
+#include <itkHistogram.h>
+#include <itkImage.h>
+
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief Computes moments, extrema with their indices and histograms of all labels of a label image at once.
+   *
+   * The results equal the ones of MinMaxLabelImageFilterWithIndex combined with LabelStatisticsImageFilter
+   * (or, without a label image, MinMaxImageFilterWithIndex combined with StatisticsImageFilter), but the image is
+   * only read once: moments and extrema of all labels are accumulated in a single fused pass. For integer pixel
+   * types of up to 16 bit, this pass additionally counts the occurrences of every pixel value, from which the
+   * histograms are binned without touching the image again. Only labels whose values could not be counted (other
+   * pixel types or too many labels per chunk) need a second histogram pass, because the histogram bounds depend
+   * on the extrema of the label.
+   *
+   * The image is split into chunks (slabs along the outermost dimension) that are processed independently of
+   * each other. This allows callers to schedule the chunks of several calculators (e.g. of all time steps of an
+   * image) in one parallel section:
+   *
+   * \code
+   * auto numberOfChunks = calculator.SplitIntoChunks(n);
+   * // for all chunks (in parallel):
+   * calculator.ProcessChunk(chunk);
+   * if (calculator.InitializeHistograms())
+   *   // for all chunks (in parallel):
+   *   calculator.ProcessHistogramChunk(chunk);
+   * calculator.Finalize();
+   * \endcode
+   *
+   * Compute() runs these steps for a single calculator. Without a label image, all pixels are accounted to label 1.
+   */
+  template <typename TInputImage>
+  class FusedLabelStatisticsCalculator
+  {
+  public:
+    using ImageType = TInputImage;
+    using PixelType = typename ImageType::PixelType;
+    using IndexType = typename ImageType::IndexType;
+    using RegionType = typename ImageType::RegionType;
+    using RealType = typename itk::NumericTraits<PixelType>::RealType;
+    using LabelPixelType = unsigned short;
+    using LabelImageType = itk::Image<LabelPixelType, ImageType::ImageDimension>;
+    using HistogramType = itk::Statistics::Histogram<RealType>;
+
+    static constexpr unsigned int ImageDimension = ImageType::ImageDimension;
+
+    class LabelStatistics
+    {
+    public:
+      LabelStatistics();
+
+      itk::SizeValueType m_Count;
+      itk::SizeValueType m_CountOfPositivePixels;
+      PixelType m_Min;
+      PixelType m_Max;
+      IndexType m_MinIndex;
+      IndexType m_MaxIndex;
+      itk::CompensatedSummation<RealType> m_Sum;
+      itk::CompensatedSummation<RealType> m_SumOfPositivePixels;
+      itk::CompensatedSummation<RealType> m_SumOfSquares;
+      itk::CompensatedSummation<RealType> m_SumOfCubes;
+      itk::CompensatedSummation<RealType> m_SumOfQuadruples;
+      RealType m_Mean;
+      RealType m_Sigma;
+      RealType m_Variance;
+      RealType m_Skewness;
+      RealType m_Kurtosis;
+      RealType m_MPP;
+      RealType m_Median;
+      RealType m_Uniformity;
+      RealType m_UPP;
+      RealType m_Entropy;
+      typename HistogramType::Pointer m_Histogram;
+    };
+
+    using LabelStatisticsMapType = std::map<LabelPixelType, LabelStatistics>;
+
+    FusedLabelStatisticsCalculator();
+
+    void SetInput(const ImageType* image);
+
+    /** The label image has to cover the same region as the input image. If no label image is set, all pixels are
+     * accounted to label 1.*/
+    void SetLabelInput(const LabelImageType* labelImage);
+
+    /** Sets a fixed number of histogram bins for all labels.*/
+    void SetNumberOfBins(unsigned int numberOfBins);
+
+    /** Sets the histogram bin size. The number of bins of each label is derived from its value range like
+     * ImageStatisticsCalculator does it, but at least 10 bins are used.*/
+    void SetBinSize(double binSize);
+
+    /** Resets the results and splits the input region into at most numberOfChunks chunks.
+     * \return The actual number of chunks.*/
+    unsigned int SplitIntoChunks(unsigned int numberOfChunks);
+
+    /** Fused pass over one chunk. Different chunks may be processed concurrently.*/
+    void ProcessChunk(unsigned int chunk);
+
+    /** Merges the results of all chunks and bins the counted pixel values into the label histograms.
+     * \return True if ProcessHistogramChunk() has to be called for all chunks before Finalize().*/
+    bool InitializeHistograms();
+
+    /** Histogram pass over one chunk for all labels whose pixel values have not been counted.
+     * Different chunks may be processed concurrently.*/
+    void ProcessHistogramChunk(unsigned int chunk);
+
+    /** Merges the histograms of all chunks and derives the remaining statistics.*/
+    void Finalize();
+
+    /** Runs all passes with the default number of ITK work units.*/
+    void Compute();
+
+    const LabelStatisticsMapType& GetLabelStatistics() const;
+
+  private:
+    using ValueCountsType = std::vector<itk::SizeValueType>;
+    using FrequenciesType = std::vector<itk::SizeValueType>;
+
+    struct Accumulator
+    {
+      LabelStatistics m_Statistics;
+
+      /** If true, the occurrences of every pixel value are counted in m_ValueCounts. Otherwise, the moments are
+       * accumulated in m_Statistics and the histogram needs a second pass.*/
+      bool m_CountValues = false;
+      ValueCountsType m_ValueCounts;
+
+      /** Histogram frequencies of the second pass.*/
+      FrequenciesType m_Frequencies;
+    };
+
+    using AccumulatorMapType = std::unordered_map<LabelPixelType, Accumulator>;
+
+    struct Chunk
+    {
+      RegionType m_Region;
+      AccumulatorMapType m_Accumulators;
+      unsigned int m_NumberOfCountedLabels = 0;
+    };
+
+    static constexpr bool CanCountValues = std::is_integral<PixelType>::value && sizeof(PixelType) <= 2;
+
+    /** Upper bound for the memory of the value counts of a single chunk.*/
+    static constexpr std::size_t MaximumValueCountsMemoryPerChunk = 2 * 1024 * 1024;
+
+    /** Calls function(label, pixels, index, begin, end) for all runs of equally labeled pixels within the lines
+     * of region. pixels and index refer to the start of the line.*/
+    template <typename TFunction>
+    void ForEachRun(const RegionType& region, TFunction function) const;
+
+    Accumulator& GetAccumulator(Chunk& chunk, LabelPixelType label) const;
+
+    void ProcessRun(Accumulator& accumulator, const PixelType* pixels, IndexType index,
+                    itk::IndexValueType begin, itk::IndexValueType end) const;
+
+    void AddValueCounts(LabelStatistics& statistics, const ValueCountsType& valueCounts) const;
+
+    void AddHistogramFrequencies(LabelStatistics& statistics, const ValueCountsType& valueCounts) const;
+
+    unsigned int GetNumberOfBins(const LabelStatistics& statistics) const;
+
+    const ImageType* m_Image;
+    const LabelImageType* m_LabelImage;
+
+    unsigned int m_NumberOfBins;
+    double m_BinSize;
+    bool m_UseBinSize;
+
+    std::vector<Chunk> m_Chunks;
+    bool m_HistogramPassRequired;
+    LabelStatisticsMapType m_LabelStatistics;
+  };
+}
+
+#include "mitkFusedLabelStatisticsCalculator.hxx"
+
+#endif
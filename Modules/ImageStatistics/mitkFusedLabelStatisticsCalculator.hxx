@@ -0,0 +1,567 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkFusedLabelStatisticsCalculator_hxx
+#define mitkFusedLabelStatisticsCalculator_hxx
+
+#include "mitkFusedLabelStatisticsCalculator.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkHistogramStatisticsCalculator.h>
+
+#include <itkImageScanlineConstIterator.h>
+#include <itkMultiThreaderBase.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+template <typename TInputImage>
+mitk::FusedLabelStatisticsCalculator<TInputImage>::LabelStatistics::LabelStatistics()
+  : m_Count(0),
+    m_CountOfPositivePixels(0),
+    m_Min(itk::NumericTraits<PixelType>::max()),
+    m_Max(itk::NumericTraits<PixelType>::NonpositiveMin()),
+    m_Sum(0),
+    m_SumOfPositivePixels(0),
+    m_SumOfSquares(0),
+    m_SumOfCubes(0),
+    m_SumOfQuadruples(0),
+    m_Mean(0),
+    m_Sigma(0),
+    m_Variance(0),
+    m_Skewness(0),
+    m_Kurtosis(0),
+    m_MPP(0),
+    m_Median(0),
+    m_Uniformity(0),
+    m_UPP(0),
+    m_Entropy(0)
+{
+  m_MinIndex.Fill(0);
+  m_MaxIndex.Fill(0);
+}
+
+template <typename TInputImage>
+mitk::FusedLabelStatisticsCalculator<TInputImage>::FusedLabelStatisticsCalculator()
+  : m_Image(nullptr),
+    m_LabelImage(nullptr),
+    m_NumberOfBins(100),
+    m_BinSize(10),
+    m_UseBinSize(false),
+    m_HistogramPassRequired(false)
+{
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::SetInput(const ImageType* image)
+{
+  m_Image = image;
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::SetLabelInput(const LabelImageType* labelImage)
+{
+  m_LabelImage = labelImage;
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::SetNumberOfBins(unsigned int numberOfBins)
+{
+  m_NumberOfBins = numberOfBins;
+  m_UseBinSize = false;
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::SetBinSize(double binSize)
+{
+  m_BinSize = binSize;
+  m_UseBinSize = true;
+}
+
+template <typename TInputImage>
+unsigned int mitk::FusedLabelStatisticsCalculator<TInputImage>::SplitIntoChunks(unsigned int numberOfChunks)
+{
+  if (nullptr == m_Image)
+    mitkThrow() << "Cannot compute statistics. Input image is not set.";
+
+  const auto region = m_Image->GetLargestPossibleRegion();
+
+  if (nullptr != m_LabelImage && m_LabelImage->GetLargestPossibleRegion().GetSize() != region.GetSize())
+    mitkThrow() << "Cannot compute statistics. Label image does not cover the region of the input image.";
+
+  m_Chunks.clear();
+  m_LabelStatistics.clear();
+  m_HistogramPassRequired = false;
+
+  if (0 == region.GetNumberOfPixels())
+    return 0;
+
+  // split along the outermost dimension that is not flat, so that the chunks keep the scan order
+  unsigned int splitDimension = ImageDimension - 1;
+  while (0 < splitDimension && 1 == region.GetSize(splitDimension))
+    --splitDimension;
+
+  const auto size = region.GetSize(splitDimension);
+  numberOfChunks = static_cast<unsigned int>(std::max<itk::SizeValueType>(1, std::min<itk::SizeValueType>(numberOfChunks, size)));
+
+  m_Chunks.resize(numberOfChunks);
+
+  for (unsigned int i = 0; i < numberOfChunks; ++i)
+  {
+    const auto begin = size * i / numberOfChunks;
+    const auto end = size * (i + 1) / numberOfChunks;
+
+    auto& chunkRegion = m_Chunks[i].m_Region;
+    chunkRegion = region;
+    chunkRegion.SetIndex(splitDimension, region.GetIndex(splitDimension) + static_cast<itk::IndexValueType>(begin));
+    chunkRegion.SetSize(splitDimension, end - begin);
+  }
+
+  return numberOfChunks;
+}
+
+template <typename TInputImage>
+template <typename TFunction>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::ForEachRun(const RegionType& region, TFunction function) const
+{
+  const auto lineLength = static_cast<itk::IndexValueType>(region.GetSize(0));
+  const auto imageBuffer = m_Image->GetBufferPointer();
+  const auto labelBuffer = nullptr != m_LabelImage ? m_LabelImage->GetBufferPointer() : nullptr;
+
+  itk::ImageScanlineConstIterator<ImageType> it(m_Image, region);
+
+  while (!it.IsAtEnd())
+  {
+    const auto index = it.GetIndex();
+    const auto pixels = imageBuffer + m_Image->ComputeOffset(index);
+
+    if (nullptr == labelBuffer)
+    {
+      function(LabelPixelType(1), pixels, index, 0, lineLength);
+    }
+    else
+    {
+      const auto labels = labelBuffer + m_LabelImage->ComputeOffset(index);
+      itk::IndexValueType begin = 0;
+
+      while (begin < lineLength)
+      {
+        const auto label = labels[begin];
+        auto end = begin + 1;
+
+        while (end < lineLength && labels[end] == label)
+          ++end;
+
+        function(label, pixels, index, begin, end);
+        begin = end;
+      }
+    }
+
+    it.NextLine();
+  }
+}
+
+template <typename TInputImage>
+auto mitk::FusedLabelStatisticsCalculator<TInputImage>::GetAccumulator(Chunk& chunk, LabelPixelType label) const -> Accumulator&
+{
+  auto it = chunk.m_Accumulators.find(label);
+
+  if (chunk.m_Accumulators.end() == it)
+  {
+    it = chunk.m_Accumulators.emplace(label, Accumulator()).first;
+
+    if constexpr (CanCountValues)
+    {
+      constexpr std::size_t numberOfValues = std::size_t(1) << (8 * sizeof(PixelType));
+      constexpr unsigned int maximumNumberOfCountedLabels =
+        std::max<std::size_t>(1, MaximumValueCountsMemoryPerChunk / (numberOfValues * sizeof(itk::SizeValueType)));
+
+      if (chunk.m_NumberOfCountedLabels < maximumNumberOfCountedLabels)
+      {
+        it->second.m_CountValues = true;
+        it->second.m_ValueCounts.assign(numberOfValues, 0);
+        ++chunk.m_NumberOfCountedLabels;
+      }
+    }
+  }
+
+  return it->second;
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::ProcessRun(Accumulator& accumulator, const PixelType* pixels,
+  IndexType index, itk::IndexValueType begin, itk::IndexValueType end) const
+{
+  auto& statistics = accumulator.m_Statistics;
+  const auto lineStart = index[0];
+
+  if (accumulator.m_CountValues)
+  {
+    const auto valueCounts = accumulator.m_ValueCounts.data();
+
+    for (auto x = begin; x < end; ++x)
+    {
+      const auto value = pixels[x];
+
+      if (value < statistics.m_Min)
+      {
+        statistics.m_Min = value;
+        statistics.m_MinIndex = index;
+        statistics.m_MinIndex[0] = lineStart + x;
+      }
+
+      if (value > statistics.m_Max)
+      {
+        statistics.m_Max = value;
+        statistics.m_MaxIndex = index;
+        statistics.m_MaxIndex[0] = lineStart + x;
+      }
+
+      ++valueCounts[static_cast<std::size_t>(value - itk::NumericTraits<PixelType>::NonpositiveMin())];
+    }
+  }
+  else
+  {
+    for (auto x = begin; x < end; ++x)
+    {
+      const auto value = pixels[x];
+
+      if (value < statistics.m_Min)
+      {
+        statistics.m_Min = value;
+        statistics.m_MinIndex = index;
+        statistics.m_MinIndex[0] = lineStart + x;
+      }
+
+      if (value > statistics.m_Max)
+      {
+        statistics.m_Max = value;
+        statistics.m_MaxIndex = index;
+        statistics.m_MaxIndex[0] = lineStart + x;
+      }
+
+      const auto realValue = static_cast<RealType>(value);
+      const auto squareValue = realValue * realValue;
+
+      statistics.m_Sum += realValue;
+      statistics.m_SumOfSquares += squareValue;
+      statistics.m_SumOfCubes += squareValue * realValue;
+      statistics.m_SumOfQuadruples += squareValue * squareValue;
+
+      if (0 < realValue)
+      {
+        statistics.m_SumOfPositivePixels += realValue;
+        ++statistics.m_CountOfPositivePixels;
+      }
+    }
+  }
+
+  statistics.m_Count += static_cast<itk::SizeValueType>(end - begin);
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::ProcessChunk(unsigned int chunkIndex)
+{
+  auto& chunk = m_Chunks[chunkIndex];
+
+  this->ForEachRun(chunk.m_Region, [this, &chunk](LabelPixelType label, const PixelType* pixels, const IndexType& index,
+    itk::IndexValueType begin, itk::IndexValueType end)
+  {
+    this->ProcessRun(this->GetAccumulator(chunk, label), pixels, index, begin, end);
+  });
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::AddValueCounts(LabelStatistics& statistics,
+  const ValueCountsType& valueCounts) const
+{
+  const auto lowest = itk::NumericTraits<PixelType>::NonpositiveMin();
+  const auto last = static_cast<std::size_t>(statistics.m_Max - lowest);
+
+  for (auto i = static_cast<std::size_t>(statistics.m_Min - lowest); i <= last; ++i)
+  {
+    if (0 == valueCounts[i])
+      continue;
+
+    const auto count = static_cast<RealType>(valueCounts[i]);
+    const auto realValue = static_cast<RealType>(lowest) + static_cast<RealType>(i);
+    const auto squareValue = realValue * realValue;
+
+    statistics.m_Sum += realValue * count;
+    statistics.m_SumOfSquares += squareValue * count;
+    statistics.m_SumOfCubes += squareValue * realValue * count;
+    statistics.m_SumOfQuadruples += squareValue * squareValue * count;
+
+    if (0 < realValue)
+    {
+      statistics.m_SumOfPositivePixels += realValue * count;
+      statistics.m_CountOfPositivePixels += valueCounts[i];
+    }
+  }
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::AddHistogramFrequencies(LabelStatistics& statistics,
+  const ValueCountsType& valueCounts) const
+{
+  typename HistogramType::MeasurementVectorType measurement(1);
+  typename HistogramType::IndexType histogramIndex(1);
+
+  const auto lowest = itk::NumericTraits<PixelType>::NonpositiveMin();
+  const auto last = static_cast<std::size_t>(statistics.m_Max - lowest);
+
+  for (auto i = static_cast<std::size_t>(statistics.m_Min - lowest); i <= last; ++i)
+  {
+    if (0 == valueCounts[i])
+      continue;
+
+    measurement[0] = static_cast<RealType>(lowest) + static_cast<RealType>(i);
+    statistics.m_Histogram->GetIndex(measurement, histogramIndex);
+    statistics.m_Histogram->IncreaseFrequencyOfIndex(histogramIndex, valueCounts[i]);
+  }
+}
+
+template <typename TInputImage>
+unsigned int mitk::FusedLabelStatisticsCalculator<TInputImage>::GetNumberOfBins(const LabelStatistics& statistics) const
+{
+  if (m_UseBinSize)
+  {
+    // do not allow less than 10 bins
+    return static_cast<unsigned int>(
+      std::max(static_cast<double>(std::ceil(statistics.m_Max - statistics.m_Min)) / m_BinSize, 10.));
+  }
+
+  return m_NumberOfBins;
+}
+
+template <typename TInputImage>
+bool mitk::FusedLabelStatisticsCalculator<TInputImage>::InitializeHistograms()
+{
+  m_LabelStatistics.clear();
+  m_HistogramPassRequired = false;
+
+  std::map<LabelPixelType, ValueCountsType> valueCountsOfLabels;
+
+  // chunks are merged in scan order, so extrema keep the index of their first occurrence
+  for (auto& chunk : m_Chunks)
+  {
+    for (auto& labelAccumulator : chunk.m_Accumulators)
+    {
+      auto& statistics = m_LabelStatistics[labelAccumulator.first];
+      auto& accumulator = labelAccumulator.second;
+      const auto& chunkStatistics = accumulator.m_Statistics;
+
+      if (chunkStatistics.m_Min < statistics.m_Min)
+      {
+        statistics.m_Min = chunkStatistics.m_Min;
+        statistics.m_MinIndex = chunkStatistics.m_MinIndex;
+      }
+
+      if (chunkStatistics.m_Max > statistics.m_Max)
+      {
+        statistics.m_Max = chunkStatistics.m_Max;
+        statistics.m_MaxIndex = chunkStatistics.m_MaxIndex;
+      }
+
+      statistics.m_Count += chunkStatistics.m_Count;
+
+      if (!accumulator.m_CountValues)
+      {
+        statistics.m_Sum += chunkStatistics.m_Sum;
+        statistics.m_SumOfSquares += chunkStatistics.m_SumOfSquares;
+        statistics.m_SumOfCubes += chunkStatistics.m_SumOfCubes;
+        statistics.m_SumOfQuadruples += chunkStatistics.m_SumOfQuadruples;
+        statistics.m_SumOfPositivePixels += chunkStatistics.m_SumOfPositivePixels;
+        statistics.m_CountOfPositivePixels += chunkStatistics.m_CountOfPositivePixels;
+        m_HistogramPassRequired = true;
+      }
+      else
+      {
+        auto& valueCounts = valueCountsOfLabels[labelAccumulator.first];
+
+        if (valueCounts.empty())
+        {
+          valueCounts.swap(accumulator.m_ValueCounts);
+        }
+        else
+        {
+          std::transform(valueCounts.begin(), valueCounts.end(), accumulator.m_ValueCounts.begin(), valueCounts.begin(),
+            std::plus<itk::SizeValueType>());
+        }
+
+        ValueCountsType().swap(accumulator.m_ValueCounts);
+      }
+    }
+  }
+
+  typename HistogramType::SizeType histogramSize(1);
+  typename HistogramType::MeasurementVectorType lowerBound(1);
+  typename HistogramType::MeasurementVectorType upperBound(1);
+
+  for (auto& labelStatistics : m_LabelStatistics)
+  {
+    auto& statistics = labelStatistics.second;
+
+    histogramSize[0] = this->GetNumberOfBins(statistics);
+    lowerBound[0] = static_cast<RealType>(statistics.m_Min);
+    upperBound[0] = static_cast<RealType>(statistics.m_Max);
+
+    statistics.m_Histogram = HistogramType::New();
+    statistics.m_Histogram->SetMeasurementVectorSize(1);
+    statistics.m_Histogram->Initialize(histogramSize, lowerBound, upperBound);
+
+    auto valueCountsIt = valueCountsOfLabels.find(labelStatistics.first);
+
+    if (valueCountsOfLabels.end() != valueCountsIt)
+    {
+      this->AddValueCounts(statistics, valueCountsIt->second);
+      this->AddHistogramFrequencies(statistics, valueCountsIt->second);
+    }
+  }
+
+  return m_HistogramPassRequired;
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::ProcessHistogramChunk(unsigned int chunkIndex)
+{
+  auto& chunk = m_Chunks[chunkIndex];
+
+  typename HistogramType::MeasurementVectorType measurement(1);
+  typename HistogramType::IndexType histogramIndex(1);
+
+  this->ForEachRun(chunk.m_Region, [&](LabelPixelType label, const PixelType* pixels, const IndexType&,
+    itk::IndexValueType begin, itk::IndexValueType end)
+  {
+    auto& accumulator = chunk.m_Accumulators.at(label);
+
+    // values of this label have already been counted in the fused pass
+    if (accumulator.m_CountValues)
+      return;
+
+    const auto histogram = m_LabelStatistics.at(label).m_Histogram.GetPointer();
+    const auto histogramSize = static_cast<itk::IndexValueType>(histogram->GetSize(0));
+
+    if (accumulator.m_Frequencies.empty())
+      accumulator.m_Frequencies.assign(histogramSize, 0);
+
+    for (auto x = begin; x < end; ++x)
+    {
+      measurement[0] = static_cast<RealType>(pixels[x]);
+      histogram->GetIndex(measurement, histogramIndex);
+
+      if (0 <= histogramIndex[0] && histogramIndex[0] < histogramSize)
+        ++accumulator.m_Frequencies[histogramIndex[0]];
+    }
+  });
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::Finalize()
+{
+  if (m_HistogramPassRequired)
+  {
+    for (const auto& chunk : m_Chunks)
+    {
+      for (const auto& labelAccumulator : chunk.m_Accumulators)
+      {
+        const auto& frequencies = labelAccumulator.second.m_Frequencies;
+        auto histogram = m_LabelStatistics.at(labelAccumulator.first).m_Histogram;
+
+        for (std::size_t bin = 0; bin < frequencies.size(); ++bin)
+        {
+          if (0 != frequencies[bin])
+            histogram->IncreaseFrequency(bin, frequencies[bin]);
+        }
+      }
+    }
+  }
+
+  m_Chunks.clear();
+
+  for (auto& labelStatistics : m_LabelStatistics)
+  {
+    auto& stats = labelStatistics.second;
+
+    const auto& sum = stats.m_Sum.GetSum();
+    const auto& sumOfSquares = stats.m_SumOfSquares.GetSum();
+    const auto& sumOfCubes = stats.m_SumOfCubes.GetSum();
+    const auto& sumOfQuadruples = stats.m_SumOfQuadruples.GetSum();
+    const auto& sumOfPositivePixels = stats.m_SumOfPositivePixels.GetSum();
+
+    const RealType count = stats.m_Count;
+    const RealType countOfPositivePixels = stats.m_CountOfPositivePixels;
+
+    stats.m_Mean = sum / count;
+    const auto& mean = stats.m_Mean;
+
+    if (count > 1)
+    {
+      auto sumSquared = sum * sum;
+      stats.m_Variance = (sumOfSquares - sumSquared / count) / (count - 1.0);
+    }
+    else
+    {
+      stats.m_Variance = 0.0;
+    }
+
+    stats.m_Sigma = std::sqrt(stats.m_Variance);
+
+    const auto secondMoment = sumOfSquares / count;
+    const auto thirdMoment = sumOfCubes / count;
+    const auto fourthMoment = sumOfQuadruples / count;
+
+    stats.m_Skewness = (thirdMoment - 3 * secondMoment * mean + 2 * std::pow(mean, 3)) / std::pow(secondMoment - std::pow(mean, 2), 1.5);
+    stats.m_Kurtosis = (fourthMoment - 4 * thirdMoment * mean + 6 * secondMoment * std::pow(mean, 2) - 3 * std::pow(mean, 4)) / std::pow(secondMoment - std::pow(mean, 2), 2);
+    stats.m_MPP = sumOfPositivePixels / countOfPositivePixels;
+
+    mitk::HistogramStatisticsCalculator histogramStatisticsCalculator;
+    histogramStatisticsCalculator.SetHistogram(stats.m_Histogram);
+    histogramStatisticsCalculator.CalculateStatistics();
+
+    stats.m_Entropy = histogramStatisticsCalculator.GetEntropy();
+    stats.m_Uniformity = histogramStatisticsCalculator.GetUniformity();
+    stats.m_UPP = histogramStatisticsCalculator.GetUPP();
+    stats.m_Median = histogramStatisticsCalculator.GetMedian();
+  }
+}
+
+template <typename TInputImage>
+void mitk::FusedLabelStatisticsCalculator<TInputImage>::Compute()
+{
+  auto multiThreader = itk::MultiThreaderBase::New();
+  const auto numberOfChunks = this->SplitIntoChunks(multiThreader->GetNumberOfWorkUnits());
+
+  multiThreader->ParallelizeArray(0, numberOfChunks, [this](itk::SizeValueType chunk)
+  {
+    this->ProcessChunk(static_cast<unsigned int>(chunk));
+  }, nullptr);
+
+  if (this->InitializeHistograms())
+  {
+    multiThreader->ParallelizeArray(0, numberOfChunks, [this](itk::SizeValueType chunk)
+    {
+      this->ProcessHistogramChunk(static_cast<unsigned int>(chunk));
+    }, nullptr);
+  }
+
+  this->Finalize();
+}
+
+template <typename TInputImage>
+auto mitk::FusedLabelStatisticsCalculator<TInputImage>::GetLabelStatistics() const -> const LabelStatisticsMapType&
+{
+  return m_LabelStatistics;
+}
+
+#endif
@@ -11,8 +11,7 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkImageStatisticsCalculator.h"
-#include <mitkLabelStatisticsImageFilter.h>
-#include <mitkStatisticsImageFilter.h>
+#include <mitkFusedLabelStatisticsCalculator.h>
 #include <mitkImage.h>
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
@@ -20,10 +19,13 @@ found in the LICENSE file.
 #include <mitkImageTimeSelector.h>
 #include <mitkImageToItk.h>
 #include <mitkMaskUtilities.h>
-#include <mitkMinMaxImageFilterWithIndex.h>
-#include <mitkMinMaxLabelmageFilterWithIndex.h>
 #include <mitkitkMaskImageFilter.h>
 
+#include <itkMultiThreaderBase.h>
+
+#include <algorithm>
+#include <iterator>
+
 namespace mitk
 {
   void ImageStatisticsCalculator::SetInputImage(const mitk::Image *image)
@@ -31,6 +33,7 @@ namespace mitk
     if (image != m_Image)
     {
       m_Image = image;
+      m_TimeStepInputs.clear();
       this->Modified();
     }
   }
@@ -40,6 +43,7 @@ namespace mitk
     if (mask != m_MaskGenerator)
     {
       m_MaskGenerator = mask;
+      m_TimeStepInputs.clear();
       this->Modified();
     }
   }
@@ -49,6 +53,7 @@ namespace mitk
     if (mask != m_SecondaryMaskGenerator)
     {
       m_SecondaryMaskGenerator = mask;
+      m_TimeStepInputs.clear();
       this->Modified();
     }
   }
@@ -104,55 +109,14 @@ namespace mitk
 
     if (IsUpdateRequired(label))
     {
-      auto timeGeometry = m_Image->GetTimeGeometry();
-      // always compute statistics on all timesteps
-      for (unsigned int timeStep = 0; timeStep < m_Image->GetTimeSteps(); timeStep++)
+      if (this->IsTimeStepInputUpdateRequired())
       {
-        if (m_MaskGenerator.IsNotNull())
-        {
-          m_MaskGenerator->SetTimeStep(timeStep);
-          //See T25625: otherwise, the mask is not computed again after setting a different time step
-          m_MaskGenerator->Modified();
-          m_InternalMask = m_MaskGenerator->GetMask();
-          if (m_MaskGenerator->GetReferenceImage().IsNotNull())
-          {
-            m_InternalImageForStatistics = m_MaskGenerator->GetReferenceImage();
-          }
-          else
-          {
-            m_InternalImageForStatistics = m_Image;
-          }
-        }
-        else
-        {
-          m_InternalImageForStatistics = m_Image;
-        }
-
-        if (m_SecondaryMaskGenerator.IsNotNull())
-        {
-          m_SecondaryMaskGenerator->SetTimeStep(timeStep);
-          m_SecondaryMask = m_SecondaryMaskGenerator->GetMask();
-        }
-
-        ImageTimeSelector::Pointer imgTimeSel = ImageTimeSelector::New();
-        imgTimeSel->SetInput(m_InternalImageForStatistics);
-        imgTimeSel->SetTimeNr(timeStep);
-        imgTimeSel->UpdateLargestPossibleRegion();
-        imgTimeSel->Update();
-        m_ImageTimeSlice = imgTimeSel->GetOutput();
-
-        // Calculate statistics with/without mask
-        if (m_MaskGenerator.IsNull() && m_SecondaryMaskGenerator.IsNull())
-        {
-          // 1) calculate statistics unmasked:
-          AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsUnmasked, timeGeometry, timeStep)
-        }
-        else
-        {
-          // 2) calculate statistics masked
-          AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsMasked, timeGeometry, timeStep)
-        }
+        this->UpdateTimeStepInputs();
       }
+
+      // always compute statistics on all timesteps
+      const mitk::Image* firstImageTimeSlice = m_TimeStepInputs.front().m_ImageTimeSlice;
+      AccessByItk(firstImageTimeSlice, InternalCalculateStatistics)
     }
 
     auto it = m_StatisticContainers.find(label);
@@ -167,341 +131,396 @@ namespace mitk
     }
   }
 
-  template <typename TPixel, unsigned int VImageDimension>
-  void ImageStatisticsCalculator::InternalCalculateStatisticsUnmasked(
-    typename itk::Image<TPixel, VImageDimension> *image, const TimeGeometry *timeGeometry, TimeStepType timeStep)
+  void ImageStatisticsCalculator::UpdateTimeStepInputs()
   {
-    typedef typename itk::Image<TPixel, VImageDimension> ImageType;
-    typedef typename mitk::StatisticsImageFilter<ImageType> ImageStatisticsFilterType;
-    typedef typename itk::MinMaxImageFilterWithIndex<ImageType> MinMaxFilterType;
-
-    // reset statistics container if exists
-    ImageStatisticsContainer::Pointer statisticContainerForImage;
-    LabelIndex labelNoMask = 1;
-    auto it = m_StatisticContainers.find(labelNoMask);
-    if (it != m_StatisticContainers.end())
-    {
-      statisticContainerForImage = it->second;
-    }
-    else
-    {
-      statisticContainerForImage = ImageStatisticsContainer::New();
-      statisticContainerForImage->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
-      m_StatisticContainers.emplace(labelNoMask, statisticContainerForImage);
-    }
-
-    auto statObj = ImageStatisticsContainer::ImageStatisticsObject();
+    const auto numberOfTimeSteps = m_Image->GetTimeSteps();
+    m_TimeStepInputs.clear();
+    m_TimeStepInputs.resize(numberOfTimeSteps);
 
-    typename ImageStatisticsFilterType::Pointer statisticsFilter = ImageStatisticsFilterType::New();
-    statisticsFilter->SetInput(image);
-    statisticsFilter->SetCoordinateTolerance(0.001);
-    statisticsFilter->SetDirectionTolerance(0.001);
+    // mask generators are not thread-safe, so all masks are generated upfront
+    for (unsigned int timeStep = 0; timeStep < numberOfTimeSteps; timeStep++)
+    {
+      auto& input = m_TimeStepInputs[timeStep];
 
-    // TODO: this is single threaded. Implement our own image filter that does this multi threaded
-    //        typename itk::MinimumMaximumImageCalculator<ImageType>::Pointer imgMinMaxFilter =
-    //        itk::MinimumMaximumImageCalculator<ImageType>::New(); imgMinMaxFilter->SetImage(image);
-    //        imgMinMaxFilter->Compute();
-    vnl_vector<int> minIndex, maxIndex;
+      if (m_MaskGenerator.IsNotNull())
+      {
+        m_MaskGenerator->SetTimeStep(timeStep);
+        //See T25625: otherwise, the mask is not computed again after setting a different time step
+        m_MaskGenerator->Modified();
+        input.m_Mask = m_MaskGenerator->GetMask();
+        if (m_MaskGenerator->GetReferenceImage().IsNotNull())
+        {
+          input.m_ImageForStatistics = m_MaskGenerator->GetReferenceImage();
+        }
+        else
+        {
+          input.m_ImageForStatistics = m_Image;
+        }
+      }
+      else
+      {
+        input.m_ImageForStatistics = m_Image;
+      }
 
-    typename MinMaxFilterType::Pointer minMaxFilter = MinMaxFilterType::New();
-    minMaxFilter->SetInput(image);
-    minMaxFilter->UpdateLargestPossibleRegion();
-    typename ImageType::PixelType minval = minMaxFilter->GetMin();
-    typename ImageType::PixelType maxval = minMaxFilter->GetMax();
+      if (m_SecondaryMaskGenerator.IsNotNull())
+      {
+        m_SecondaryMaskGenerator->SetTimeStep(timeStep);
+        input.m_SecondaryMask = m_SecondaryMaskGenerator->GetMask();
 
-    typename ImageType::IndexType tmpMinIndex = minMaxFilter->GetMinIndex();
-    typename ImageType::IndexType tmpMaxIndex = minMaxFilter->GetMaxIndex();
+        if (input.m_Mask.IsNull())
+        {
+          // workaround: if m_SecondaryMaskGenerator ist not null but m_MaskGenerator is! (this is the case if we request a
+          // 'ignore zuero valued pixels' mask in the gui but do not define a primary mask)
+          input.m_Mask = input.m_SecondaryMask;
+          input.m_SecondaryMask = nullptr;
+        }
+        else if (input.m_Mask->GetDimension() == 2 &&
+                 (input.m_SecondaryMask->GetDimension() == 3 || input.m_SecondaryMask->GetDimension() == 4))
+        {
+          // dirty workaround for a bug when pf mask + any other mask is used in conjunction. We need a proper fix for this
+          // (Fabian Isensee is responsible and probably working on it!)
+          mitk::Image::ConstPointer old_img = m_SecondaryMaskGenerator->GetReferenceImage();
+          m_SecondaryMaskGenerator->SetInputImage(m_MaskGenerator->GetReferenceImage());
+          input.m_SecondaryMask = m_SecondaryMaskGenerator->GetMask();
+          m_SecondaryMaskGenerator->SetInputImage(old_img);
+        }
+      }
 
-    //        typename ImageType::IndexType tmpMinIndex = imgMinMaxFilter->GetIndexOfMinimum();
-    //        typename ImageType::IndexType tmpMaxIndex = imgMinMaxFilter->GetIndexOfMaximum();
+      ImageTimeSelector::Pointer imgTimeSel = ImageTimeSelector::New();
+      imgTimeSel->SetInput(input.m_ImageForStatistics);
+      imgTimeSel->SetTimeNr(timeStep);
+      imgTimeSel->UpdateLargestPossibleRegion();
+      imgTimeSel->Update();
+      input.m_ImageTimeSlice = imgTimeSel->GetOutput();
+    }
 
-    minIndex.set_size(tmpMaxIndex.GetIndexDimension());
-    maxIndex.set_size(tmpMaxIndex.GetIndexDimension());
+    m_TimeStepInputsUpdateTime.Modified();
+  }
 
-    for (unsigned int i = 0; i < tmpMaxIndex.GetIndexDimension(); i++)
+  bool ImageStatisticsCalculator::IsTimeStepInputUpdateRequired() const
+  {
+    if (m_TimeStepInputs.size() != m_Image->GetTimeSteps())
     {
-      minIndex[i] = tmpMinIndex[i];
-      maxIndex[i] = tmpMaxIndex[i];
+      return true;
     }
 
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUMPOSITION(), minIndex);
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUMPOSITION(), maxIndex);
+    const auto updateTime = m_TimeStepInputsUpdateTime.GetMTime();
 
-    // convert m_binSize in m_nBins if necessary
-    unsigned int nBinsForHistogram;
-    if (m_UseBinSizeOverNBins)
+    if (m_Image->GetMTime() > updateTime)
     {
-      nBinsForHistogram = std::max(static_cast<double>(std::ceil(maxval - minval)) / m_binSizeForHistogramStatistics,
-                                   10.); // do not allow less than 10 bins
-    }
-    else
-    {
-      nBinsForHistogram = m_nBinsForHistogramStatistics;
+      return true;
     }
 
-    statisticsFilter->SetHistogramParameters(nBinsForHistogram, minval, maxval);
-
-    try
+    if (m_MaskGenerator.IsNotNull() && m_MaskGenerator->GetMTime() > updateTime)
     {
-      statisticsFilter->Update();
+      return true;
     }
-    catch (const itk::ExceptionObject &e)
+
+    if (m_SecondaryMaskGenerator.IsNotNull() && m_SecondaryMaskGenerator->GetMTime() > updateTime)
     {
-      mitkThrow() << "Image statistics calculation failed due to following ITK Exception: \n " << e.what();
+      return true;
     }
 
-    auto voxelVolume = GetVoxelVolume<TPixel, VImageDimension>(image);
-
-    auto numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
-    auto volume = static_cast<double>(numberOfPixels) * voxelVolume;
-    auto variance = statisticsFilter->GetSigma() * statisticsFilter->GetSigma();
-    auto rms =
-      std::sqrt(std::pow(statisticsFilter->GetMean(), 2.) + statisticsFilter->GetVariance()); // variance = sigma^2
-
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::NUMBEROFVOXELS(),
-                         static_cast<ImageStatisticsContainer::VoxelCountType>(numberOfPixels));
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::VOLUME(), volume);
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), statisticsFilter->GetMean());
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(),
-                         static_cast<ImageStatisticsContainer::RealType>(statisticsFilter->GetMinimum()));
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(),
-                         static_cast<ImageStatisticsContainer::RealType>(statisticsFilter->GetMaximum()));
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), statisticsFilter->GetSigma());
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), variance);
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), statisticsFilter->GetSkewness());
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), statisticsFilter->GetKurtosis());
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::RMS(), rms);
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(), statisticsFilter->GetMPP());
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), statisticsFilter->GetEntropy());
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), statisticsFilter->GetMedian());
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), statisticsFilter->GetUniformity());
-    statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), statisticsFilter->GetUPP());
-    statObj.m_Histogram = statisticsFilter->GetHistogram();
-    statisticContainerForImage->SetStatisticsForTimeStep(timeStep, statObj);
-  }
-
-  template <typename TPixel, unsigned int VImageDimension>
-  double ImageStatisticsCalculator::GetVoxelVolume(typename itk::Image<TPixel, VImageDimension> *image) const
-  {
-    auto spacing = image->GetSpacing();
-    double voxelVolume = 1.;
-    for (unsigned int i = 0; i < image->GetImageDimension(); i++)
+    // masks may be images of the data storage that are modified without their generator noticing it
+    for (const auto& input : m_TimeStepInputs)
     {
-      voxelVolume *= spacing[i];
+      for (const mitk::Image* image : { input.m_ImageForStatistics.GetPointer(), input.m_Mask.GetPointer(), input.m_SecondaryMask.GetPointer() })
+      {
+        if (nullptr != image && image->GetMTime() > updateTime)
+        {
+          return true;
+        }
+      }
     }
-    return voxelVolume;
+
+    return false;
   }
 
   template <typename TPixel, unsigned int VImageDimension>
-  void ImageStatisticsCalculator::InternalCalculateStatisticsMasked(typename itk::Image<TPixel, VImageDimension> *image,
-                                                                    const TimeGeometry *timeGeometry,
-                                                                    unsigned int timeStep)
+  void ImageStatisticsCalculator::PrepareMaskedTimeStep(TimeStepInput& input,
+                                                        typename itk::Image<TPixel, VImageDimension>::ConstPointer& image,
+                                                        typename itk::Image<MaskPixelType, VImageDimension>::ConstPointer& mask)
   {
     typedef itk::Image<TPixel, VImageDimension> ImageType;
     typedef itk::Image<MaskPixelType, VImageDimension> MaskType;
-    typedef typename MaskType::PixelType LabelPixelType;
-    typedef LabelStatisticsImageFilter<ImageType> ImageStatisticsFilterType;
     typedef MaskUtilities<TPixel, VImageDimension> MaskUtilType;
-    typedef typename itk::MinMaxLabelImageFilterWithIndex<ImageType, MaskType> MinMaxLabelFilterType;
-
-    // workaround: if m_SecondaryMaskGenerator ist not null but m_MaskGenerator is! (this is the case if we request a
-    // 'ignore zuero valued pixels' mask in the gui but do not define a primary mask)
-    bool swapMasks = false;
-    if (m_SecondaryMask.IsNotNull() && m_InternalMask.IsNull())
-    {
-      m_InternalMask = m_SecondaryMask;
-      m_SecondaryMask = nullptr;
-      swapMasks = true;
-    }
 
-    // maskImage has to have the same dimension as image
-    typename MaskType::ConstPointer maskImage = MaskType::New();
-    try
+    if (input.m_PreparedMask.IsNotNull())
     {
-      // try to access the pixel values directly (no copying or casting). Only works if mask pixels are of pixelType
-      // unsigned short
-      maskImage = ImageToItkImage<MaskPixelType, VImageDimension>(m_InternalMask);
+      mask = static_cast<const MaskType*>(input.m_PreparedMask.GetPointer());
     }
-    catch (const itk::ExceptionObject &)
-
+    else
     {
-      typename MaskType::Pointer noneConstMaskImage; //needed to work arround the fact that CastToItkImage currently does not support const itk images.
-      // if the pixel type of the mask is not short, then we have to make a copy of m_InternalMask (and cast the values)
-      CastToItkImage(m_InternalMask, noneConstMaskImage);
-      maskImage = noneConstMaskImage;
-    }
+      bool isMaskView = true;
 
-    // if we have a secondary mask (say a ignoreZeroPixelMask) we need to combine the masks (corresponds to AND)
-    if (m_SecondaryMask.IsNotNull())
-    {
-      // dirty workaround for a bug when pf mask + any other mask is used in conjunction. We need a proper fix for this
-      // (Fabian Isensee is responsible and probably working on it!)
-      if (m_InternalMask->GetDimension() == 2 &&
-          (m_SecondaryMask->GetDimension() == 3 || m_SecondaryMask->GetDimension() == 4))
+      // maskImage has to have the same dimension as image
+      try
       {
-        mitk::Image::ConstPointer old_img = m_SecondaryMaskGenerator->GetReferenceImage();
-        m_SecondaryMaskGenerator->SetInputImage(m_MaskGenerator->GetReferenceImage());
-        m_SecondaryMask = m_SecondaryMaskGenerator->GetMask();
-        m_SecondaryMaskGenerator->SetInputImage(old_img);
+        // try to access the pixel values directly (no copying or casting). Only works if mask pixels are of pixelType
+        // unsigned short
+        mask = ImageToItkImage<MaskPixelType, VImageDimension>(input.m_Mask);
+      }
+      catch (const itk::ExceptionObject &)
+      {
+        typename MaskType::Pointer noneConstMaskImage; //needed to work arround the fact that CastToItkImage currently does not support const itk images.
+        // if the pixel type of the mask is not short, then we have to make a copy of the mask (and cast the values)
+        CastToItkImage(input.m_Mask, noneConstMaskImage);
+        mask = noneConstMaskImage;
+        isMaskView = false;
       }
-      typename MaskType::ConstPointer secondaryMaskImage = MaskType::New();
-      secondaryMaskImage = ImageToItkImage<MaskPixelType, VImageDimension>(m_SecondaryMask);
 
-      // secondary mask should be a ignore zero value pixel mask derived from image. it has to be cropped to the mask
-      // region (which may be planar or simply smaller)
-      typename MaskUtilities<MaskPixelType, VImageDimension>::Pointer secondaryMaskMaskUtil =
-        MaskUtilities<MaskPixelType, VImageDimension>::New();
-      secondaryMaskMaskUtil->SetImage(secondaryMaskImage.GetPointer());
-      secondaryMaskMaskUtil->SetMask(maskImage.GetPointer());
-      typename MaskType::ConstPointer adaptedSecondaryMaskImage = secondaryMaskMaskUtil->ExtractMaskImageRegion();
+      // if we have a secondary mask (say a ignoreZeroPixelMask) we need to combine the masks (corresponds to AND)
+      if (input.m_SecondaryMask.IsNotNull())
+      {
+        typename MaskType::ConstPointer secondaryMaskImage = ImageToItkImage<MaskPixelType, VImageDimension>(input.m_SecondaryMask);
+
+        // secondary mask should be a ignore zero value pixel mask derived from image. it has to be cropped to the mask
+        // region (which may be planar or simply smaller)
+        typename MaskUtilities<MaskPixelType, VImageDimension>::Pointer secondaryMaskMaskUtil =
+          MaskUtilities<MaskPixelType, VImageDimension>::New();
+        secondaryMaskMaskUtil->SetImage(secondaryMaskImage.GetPointer());
+        secondaryMaskMaskUtil->SetMask(mask.GetPointer());
+        typename MaskType::ConstPointer adaptedSecondaryMaskImage = secondaryMaskMaskUtil->ExtractMaskImageRegion();
+
+        typename itk::MaskImageFilter2<MaskType, MaskType, MaskType>::Pointer maskFilter =
+          itk::MaskImageFilter2<MaskType, MaskType, MaskType>::New();
+        maskFilter->SetInput1(mask);
+        maskFilter->SetInput2(adaptedSecondaryMaskImage);
+        maskFilter->SetMaskingValue(
+          1); // all pixels of maskImage where secondaryMaskImage==1 will be kept, all the others are set to 0
+        maskFilter->UpdateLargestPossibleRegion();
+        mask = maskFilter->GetOutput();
+        isMaskView = false;
+      }
 
-      typename itk::MaskImageFilter2<MaskType, MaskType, MaskType>::Pointer maskFilter =
-        itk::MaskImageFilter2<MaskType, MaskType, MaskType>::New();
-      maskFilter->SetInput1(maskImage);
-      maskFilter->SetInput2(adaptedSecondaryMaskImage);
-      maskFilter->SetMaskingValue(
-        1); // all pixels of maskImage where secondaryMaskImage==1 will be kept, all the others are set to 0
-      maskFilter->UpdateLargestPossibleRegion();
-      maskImage = maskFilter->GetOutput();
+      if (!isMaskView)
+      {
+        input.m_PreparedMask = mask.GetPointer();
+      }
     }
 
-    typename MaskUtilType::Pointer maskUtil = MaskUtilType::New();
-    maskUtil->SetImage(image);
-    maskUtil->SetMask(maskImage.GetPointer());
+    if (input.m_PreparedImage.IsNotNull())
+    {
+      image = static_cast<const ImageType*>(input.m_PreparedImage.GetPointer());
+    }
+    else
+    {
+      typename ImageType::ConstPointer timeSliceImage = ImageToItkImage<TPixel, VImageDimension>(input.m_ImageTimeSlice);
 
-    // if mask is smaller than image, extract the image region where the mask is
-    typename ImageType::ConstPointer adaptedImage = ImageType::New();
+      typename MaskUtilType::Pointer maskUtil = MaskUtilType::New();
+      maskUtil->SetImage(timeSliceImage);
+      maskUtil->SetMask(mask.GetPointer());
 
-    adaptedImage = maskUtil->ExtractMaskImageRegion(); // this also checks mask sanity
+      // if mask is smaller than image, extract the image region where the mask is
+      image = maskUtil->ExtractMaskImageRegion(); // this also checks mask sanity
+      input.m_PreparedImage = image.GetPointer();
+    }
+  }
 
-    // find min, max, minindex and maxindex
-    typename MinMaxLabelFilterType::Pointer minMaxFilter = MinMaxLabelFilterType::New();
-    minMaxFilter->SetInput(adaptedImage);
-    minMaxFilter->SetLabelInput(maskImage);
-    minMaxFilter->UpdateLargestPossibleRegion();
+  template <typename TPixel, unsigned int VImageDimension>
+  void ImageStatisticsCalculator::InternalCalculateStatistics(const itk::Image<TPixel, VImageDimension>*)
+  {
+    typedef itk::Image<TPixel, VImageDimension> ImageType;
+    typedef itk::Image<MaskPixelType, VImageDimension> MaskType;
+    typedef FusedLabelStatisticsCalculator<ImageType> StatisticsCalculatorType;
+    typedef std::pair<std::size_t, unsigned int> WorkItemType; // timestep, chunk
 
-    // set histogram parameters for each label individually (min/max may be different for each label)
-    typedef typename std::unordered_map<LabelPixelType, ScalarType> MapType;
+    const auto timeGeometry = m_Image->GetTimeGeometry();
+    const auto numberOfTimeSteps = m_TimeStepInputs.size();
+    const bool masked = m_MaskGenerator.IsNotNull() || m_SecondaryMaskGenerator.IsNotNull();
 
-    std::vector<LabelPixelType> relevantLabels = minMaxFilter->GetRelevantLabels();
-    MapType minVals;
-    MapType maxVals;
-    std::unordered_map<LabelPixelType, unsigned int> nBins;
+    // preparation runs ITK filters itself, so it is done before the parallel section
+    std::vector<typename ImageType::ConstPointer> images(numberOfTimeSteps);
+    std::vector<typename MaskType::ConstPointer> masks(numberOfTimeSteps);
 
-    for (LabelPixelType label : relevantLabels)
+    for (std::size_t timeStep = 0; timeStep < numberOfTimeSteps; ++timeStep)
     {
-      minVals[label] = static_cast<ScalarType>(minMaxFilter->GetMin(label));
-      maxVals[label] = static_cast<ScalarType>(minMaxFilter->GetMax(label));
+      auto& input = m_TimeStepInputs[timeStep];
 
-      unsigned int nBinsForHistogram;
-      if (m_UseBinSizeOverNBins)
+      if (masked)
       {
-        nBinsForHistogram =
-          std::max(static_cast<double>(std::ceil(minMaxFilter->GetMax(label) - minMaxFilter->GetMin(label))) /
-                     m_binSizeForHistogramStatistics,
-                   10.); // do not allow less than 10 bins
+        this->PrepareMaskedTimeStep<TPixel, VImageDimension>(input, images[timeStep], masks[timeStep]);
       }
       else
       {
-        nBinsForHistogram = m_nBinsForHistogramStatistics;
-      }
+        if (input.m_PreparedImage.IsNull())
+        {
+          input.m_PreparedImage = ImageToItkImage<TPixel, VImageDimension>(input.m_ImageTimeSlice).GetPointer();
+        }
 
-      nBins[label] = nBinsForHistogram;
+        images[timeStep] = static_cast<const ImageType*>(input.m_PreparedImage.GetPointer());
+      }
     }
 
-    typename ImageStatisticsFilterType::Pointer imageStatisticsFilter = ImageStatisticsFilterType::New();
-    imageStatisticsFilter->SetDirectionTolerance(0.001);
-    imageStatisticsFilter->SetCoordinateTolerance(0.001);
-    imageStatisticsFilter->SetInput(adaptedImage);
-    imageStatisticsFilter->SetLabelInput(maskImage);
-    imageStatisticsFilter->SetHistogramParameters(nBins, minVals, maxVals);
-    imageStatisticsFilter->Update();
+    // the chunks of all timesteps are processed in one parallel section, so that a single timestep
+    // as well as many small timesteps keep all work units busy
+    auto multiThreader = itk::MultiThreaderBase::New();
+    const auto numberOfWorkUnits = multiThreader->GetNumberOfWorkUnits();
+    const auto numberOfChunksPerTimeStep = std::max<unsigned int>(
+      1, static_cast<unsigned int>((numberOfWorkUnits + numberOfTimeSteps - 1) / numberOfTimeSteps));
 
-    auto labels = imageStatisticsFilter->GetValidLabelValues();
-    auto it = labels.begin();
+    std::vector<StatisticsCalculatorType> calculators(numberOfTimeSteps);
+    std::vector<WorkItemType> workItems;
 
-    while (it != labels.end())
+    for (std::size_t timeStep = 0; timeStep < numberOfTimeSteps; ++timeStep)
     {
-      ImageStatisticsContainer::Pointer statisticContainerForLabelImage;
-      auto labelIt = m_StatisticContainers.find(*it);
-      // reset if statisticContainer already exist
-      if (labelIt != m_StatisticContainers.end())
+      auto& calculator = calculators[timeStep];
+      calculator.SetInput(images[timeStep]);
+      calculator.SetLabelInput(masks[timeStep]);
+
+      if (m_UseBinSizeOverNBins)
       {
-        statisticContainerForLabelImage = labelIt->second;
+        calculator.SetBinSize(m_binSizeForHistogramStatistics);
       }
-      // create new statisticContainer
       else
       {
-        statisticContainerForLabelImage = ImageStatisticsContainer::New();
-        statisticContainerForLabelImage->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
-        // link label (*it) to statisticContainer
-        m_StatisticContainers.emplace(*it, statisticContainerForLabelImage);
+        calculator.SetNumberOfBins(m_nBinsForHistogramStatistics);
       }
 
-      ImageStatisticsContainer::ImageStatisticsObject statObj;
+      const auto numberOfChunks = calculator.SplitIntoChunks(numberOfChunksPerTimeStep);
+
+      for (unsigned int chunk = 0; chunk < numberOfChunks; ++chunk)
+      {
+        workItems.emplace_back(timeStep, chunk);
+      }
+    }
+
+    multiThreader->ParallelizeArray(0, workItems.size(), [&calculators, &workItems](itk::SizeValueType i)
+    {
+      calculators[workItems[i].first].ProcessChunk(workItems[i].second);
+    }, nullptr);
+
+    std::vector<char> histogramPassRequired(numberOfTimeSteps);
+
+    multiThreader->ParallelizeArray(0, numberOfTimeSteps, [&calculators, &histogramPassRequired](itk::SizeValueType timeStep)
+    {
+      histogramPassRequired[timeStep] = calculators[timeStep].InitializeHistograms();
+    }, nullptr);
 
-      // find min, max, minindex and maxindex
-      // make sure to only look in the masked region, use a masker for this
+    std::vector<WorkItemType> histogramWorkItems;
+    std::copy_if(workItems.begin(), workItems.end(), std::back_inserter(histogramWorkItems),
+      [&histogramPassRequired](const WorkItemType& item) { return histogramPassRequired[item.first]; });
+
+    if (!histogramWorkItems.empty())
+    {
+      multiThreader->ParallelizeArray(0, histogramWorkItems.size(), [&calculators, &histogramWorkItems](itk::SizeValueType i)
+      {
+        calculators[histogramWorkItems[i].first].ProcessHistogramChunk(histogramWorkItems[i].second);
+      }, nullptr);
+    }
 
-      vnl_vector<int> minIndex, maxIndex;
-      mitk::Point3D worldCoordinateMin;
-      mitk::Point3D worldCoordinateMax;
-      mitk::Point3D indexCoordinateMin;
-      mitk::Point3D indexCoordinateMax;
-      m_InternalImageForStatistics->GetGeometry()->IndexToWorld(minMaxFilter->GetMinIndex(*it), worldCoordinateMin);
-      m_InternalImageForStatistics->GetGeometry()->IndexToWorld(minMaxFilter->GetMaxIndex(*it), worldCoordinateMax);
-      m_Image->GetGeometry()->WorldToIndex(worldCoordinateMin, indexCoordinateMin);
-      m_Image->GetGeometry()->WorldToIndex(worldCoordinateMax, indexCoordinateMax);
+    multiThreader->ParallelizeArray(0, numberOfTimeSteps, [&calculators](itk::SizeValueType timeStep)
+    {
+      calculators[timeStep].Finalize();
+    }, nullptr);
 
-      minIndex.set_size(3);
-      maxIndex.set_size(3);
+    // containers are not thread-safe, so they are filled sequentially
+    for (std::size_t timeStep = 0; timeStep < numberOfTimeSteps; ++timeStep)
+    {
+      const auto& calculator = calculators[timeStep];
+      const auto& input = m_TimeStepInputs[timeStep];
+      const auto voxelVolume = GetVoxelVolume<TPixel, VImageDimension>(images[timeStep]);
 
-      // for (unsigned int i=0; i < tmpMaxIndex.GetIndexDimension(); i++)
-      for (unsigned int i = 0; i < 3; i++)
+      for (const auto& labelStatistics : calculator.GetLabelStatistics())
       {
-        minIndex[i] = indexCoordinateMin[i];
-        maxIndex[i] = indexCoordinateMax[i];
+        // without mask, all pixels are accounted to label 1
+        const LabelIndex label = labelStatistics.first;
+        const auto& statistics = labelStatistics.second;
+
+        ImageStatisticsContainer::Pointer statisticContainerForLabelImage;
+        auto labelIt = m_StatisticContainers.find(label);
+        // reset if statisticContainer already exist
+        if (labelIt != m_StatisticContainers.end())
+        {
+          statisticContainerForLabelImage = labelIt->second;
+        }
+        // create new statisticContainer
+        else
+        {
+          statisticContainerForLabelImage = ImageStatisticsContainer::New();
+          statisticContainerForLabelImage->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
+          // link label to statisticContainer
+          m_StatisticContainers.emplace(label, statisticContainerForLabelImage);
+        }
+
+        ImageStatisticsContainer::ImageStatisticsObject statObj;
+
+        vnl_vector<int> minIndex, maxIndex;
+
+        if (masked)
+        {
+          // min/max indices refer to the reference image of the mask generator and are converted to indices of the input image
+          mitk::Point3D worldCoordinateMin;
+          mitk::Point3D worldCoordinateMax;
+          mitk::Point3D indexCoordinateMin;
+          mitk::Point3D indexCoordinateMax;
+          input.m_ImageForStatistics->GetGeometry()->IndexToWorld(statistics.m_MinIndex, worldCoordinateMin);
+          input.m_ImageForStatistics->GetGeometry()->IndexToWorld(statistics.m_MaxIndex, worldCoordinateMax);
+          m_Image->GetGeometry()->WorldToIndex(worldCoordinateMin, indexCoordinateMin);
+          m_Image->GetGeometry()->WorldToIndex(worldCoordinateMax, indexCoordinateMax);
+
+          minIndex.set_size(3);
+          maxIndex.set_size(3);
+
+          for (unsigned int i = 0; i < 3; i++)
+          {
+            minIndex[i] = indexCoordinateMin[i];
+            maxIndex[i] = indexCoordinateMax[i];
+          }
+        }
+        else
+        {
+          minIndex.set_size(VImageDimension);
+          maxIndex.set_size(VImageDimension);
+
+          for (unsigned int i = 0; i < VImageDimension; i++)
+          {
+            minIndex[i] = statistics.m_MinIndex[i];
+            maxIndex[i] = statistics.m_MaxIndex[i];
+          }
+        }
+
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUMPOSITION(), minIndex);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUMPOSITION(), maxIndex);
+
+        auto numberOfVoxels = static_cast<ImageStatisticsContainer::VoxelCountType>(statistics.m_Count);
+        auto volume = static_cast<double>(numberOfVoxels) * voxelVolume;
+        auto variance = statistics.m_Sigma * statistics.m_Sigma;
+        auto rms = std::sqrt(std::pow(statistics.m_Mean, 2.) + statistics.m_Variance); // variance = sigma^2
+
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::NUMBEROFVOXELS(), numberOfVoxels);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::VOLUME(), volume);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), statistics.m_Mean);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(),
+                             static_cast<ImageStatisticsContainer::RealType>(statistics.m_Min));
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(),
+                             static_cast<ImageStatisticsContainer::RealType>(statistics.m_Max));
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), statistics.m_Sigma);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), variance);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), statistics.m_Skewness);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), statistics.m_Kurtosis);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::RMS(), rms);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(), statistics.m_MPP);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), statistics.m_Entropy);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), statistics.m_Median);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), statistics.m_Uniformity);
+        statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), statistics.m_UPP);
+        statObj.m_Histogram = statistics.m_Histogram;
+        statisticContainerForLabelImage->SetStatisticsForTimeStep(timeStep, statObj);
       }
+    }
+  }
 
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUMPOSITION(), minIndex);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUMPOSITION(), maxIndex);
-
-      auto voxelVolume = GetVoxelVolume<TPixel, VImageDimension>(image);
-      auto numberOfVoxels =
-        static_cast<unsigned long>(imageStatisticsFilter->GetCount(*it));
-      auto volume = static_cast<double>(numberOfVoxels) * voxelVolume;
-      auto rms = std::sqrt(std::pow(imageStatisticsFilter->GetMean(*it), 2.) +
-                           imageStatisticsFilter->GetVariance(*it)); // variance = sigma^2
-      auto variance = imageStatisticsFilter->GetSigma(*it) * imageStatisticsFilter->GetSigma(*it);
-
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::NUMBEROFVOXELS(), numberOfVoxels);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::VOLUME(), volume);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), imageStatisticsFilter->GetMean(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(),
-        static_cast<ImageStatisticsContainer::RealType>(imageStatisticsFilter->GetMinimum(*it)));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(),
-        static_cast<ImageStatisticsContainer::RealType>(imageStatisticsFilter->GetMaximum(*it)));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), imageStatisticsFilter->GetSigma(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), variance);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), imageStatisticsFilter->GetSkewness(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), imageStatisticsFilter->GetKurtosis(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::RMS(), rms);
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(), imageStatisticsFilter->GetMPP(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), imageStatisticsFilter->GetEntropy(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), imageStatisticsFilter->GetMedian(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), imageStatisticsFilter->GetUniformity(*it));
-      statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), imageStatisticsFilter->GetUPP(*it));
-      statObj.m_Histogram = imageStatisticsFilter->GetHistogram(*it);
-      statisticContainerForLabelImage->SetStatisticsForTimeStep(timeStep, statObj);
-      ++it;
-    }
-
-    // swap maskGenerators back
-    if (swapMasks)
-    {
-      m_SecondaryMask = m_InternalMask;
-      m_InternalMask = nullptr;
+  template <typename TPixel, unsigned int VImageDimension>
+  double ImageStatisticsCalculator::GetVoxelVolume(const itk::Image<TPixel, VImageDimension> *image) const
+  {
+    auto spacing = image->GetSpacing();
+    double voxelVolume = 1.;
+    for (unsigned int i = 0; i < image->GetImageDimension(); i++)
+    {
+      voxelVolume *= spacing[i];
     }
+    return voxelVolume;
   }
 
   bool ImageStatisticsCalculator::IsUpdateRequired(LabelIndex label) const
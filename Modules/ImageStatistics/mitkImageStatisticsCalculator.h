@@ -18,6 +18,8 @@ found in the LICENSE file.
 #include <mitkMaskGenerator.h>
 #include <mitkImageStatisticsContainer.h>
 
+#include <itkTimeStamp.h>
+
 namespace mitk
 {
     class MITKIMAGESTATISTICS_EXPORT ImageStatisticsCalculator: public itk::Object
@@ -72,7 +74,9 @@ namespace mitk
 
         /**Documentation
         @brief Returns the statistics for label @a label. If these requested statistics are not computed yet the computation is done as well.
-        For performance reasons, statistics for all labels in the image are computed at once.
+        For performance reasons, statistics for all labels and all timesteps in the image are computed at once, in a single pass per timestep
+        and with all timesteps in parallel. The time-sliced images and masks are kept and reused as long as the image, the mask generators
+        and the generated masks are unchanged, e.g. if only the histogram parameters are changed.
          */
         ImageStatisticsContainer* GetStatistics(LabelIndex label=1);
 
@@ -85,28 +89,48 @@ namespace mitk
 
 
     private:
-        //Calculates statistics for each timestep for image
-        template < typename TPixel, unsigned int VImageDimension > void InternalCalculateStatisticsUnmasked(
-                typename itk::Image< TPixel, VImageDimension >* image, const TimeGeometry* timeGeometry, TimeStepType timeStep);
+        /** Inputs of the statistics computation for a single timestep.*/
+        struct TimeStepInput
+        {
+          /** Reference image of the mask generator or the input image. Used for the conversion of min/max indices.*/
+          mitk::Image::ConstPointer m_ImageForStatistics;
+          mitk::Image::ConstPointer m_ImageTimeSlice;
+          mitk::Image::ConstPointer m_Mask;
+          mitk::Image::ConstPointer m_SecondaryMask;
+
+          /** ITK image restricted to the mask region. Created on first use.*/
+          itk::DataObject::ConstPointer m_PreparedImage;
+
+          /** ITK mask combined with the secondary mask and/or cast to MaskPixelType. Only kept if it is not a view
+          of m_Mask, because a view locks the mask for write access.*/
+          itk::DataObject::ConstPointer m_PreparedMask;
+        };
+
+        /** Generates the masks and time slices of all timesteps.*/
+        void UpdateTimeStepInputs();
+
+        bool IsTimeStepInputUpdateRequired() const;
 
-        template < typename TPixel, unsigned int VImageDimension > void InternalCalculateStatisticsMasked(
-                typename itk::Image< TPixel, VImageDimension >* image, const TimeGeometry* timeGeometry,
-                unsigned int timeStep);
+        //Calculates statistics for all timesteps of the image. image is only used to determine the pixel type.
+        template < typename TPixel, unsigned int VImageDimension > void InternalCalculateStatistics(
+                const itk::Image< TPixel, VImageDimension >* image);
+
+        template < typename TPixel, unsigned int VImageDimension > void PrepareMaskedTimeStep(TimeStepInput& input,
+                typename itk::Image< TPixel, VImageDimension >::ConstPointer& image,
+                typename itk::Image< MaskPixelType, VImageDimension >::ConstPointer& mask);
 
         template < typename TPixel, unsigned int VImageDimension >
-        double GetVoxelVolume(typename itk::Image<TPixel, VImageDimension>* image) const;
+        double GetVoxelVolume(const itk::Image<TPixel, VImageDimension>* image) const;
 
         bool IsUpdateRequired(LabelIndex label) const;
 
         mitk::Image::ConstPointer m_Image;
-        mitk::Image::Pointer m_ImageTimeSlice;
-        mitk::Image::ConstPointer m_InternalImageForStatistics;
 
         mitk::MaskGenerator::Pointer m_MaskGenerator;
-        mitk::Image::ConstPointer m_InternalMask;
-
         mitk::MaskGenerator::Pointer m_SecondaryMaskGenerator;
-        mitk::Image::ConstPointer m_SecondaryMask;
+
+        std::vector<TimeStepInput> m_TimeStepInputs;
+        itk::TimeStamp m_TimeStepInputsUpdateTime;
 
         unsigned int m_nBinsForHistogramStatistics;
         double m_binSizeForHistogramStatistics;
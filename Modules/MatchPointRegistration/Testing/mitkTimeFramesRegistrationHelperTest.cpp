@@ -14,6 +14,11 @@ found in the LICENSE file.
 #include "mitkTestFixture.h"
 
 #include "mitkTimeFramesRegistrationHelper.h"
+#include "mitkMultiModalTransDefaultRegistrationAlgorithm.h"
+#include <mitkImageReadAccessor.h>
+
+#include <cmath>
+#include <vector>
 
 class mitkTimeFramesRegistrationHelperTestSuite : public mitk::TestFixture
 {
@@ -25,11 +30,92 @@ class mitkTimeFramesRegistrationHelperTestSuite : public mitk::TestFixture
   MITK_TEST(SetAllowUnregPixels_GetAllowUnregPixels);
   MITK_TEST(SetInterpolatorType_GetInterpolatorType);
   MITK_TEST(Set_Get_Clear_IgnoreList);
+  MITK_TEST(SetNumberOfThreads_GetNumberOfThreads);
+  MITK_TEST(SetWarmStart_GetWarmStart);
+  MITK_TEST(Generate_MultiThreaded_EqualsSequential);
+  MITK_TEST(Generate_WarmStart_AlignsFrames);
   CPPUNIT_TEST_SUITE_END();
 private:
+  typedef itk::Image<float, 3> FrameImageType;
+
   mitk::TimeFramesRegistrationHelper::Pointer frameRegHelper;
   mitk::TimeFramesRegistrationHelper::IgnoreListType ignoreList;
 
+  /** 4D image of a smooth blob that is shifted by (1.5, 1, -0.5) voxels per frame.*/
+  static mitk::Image::Pointer GenerateMovingBlob()
+  {
+    const unsigned int dimensions[] = { 32, 32, 32, 5 };
+    auto image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 4, dimensions);
+
+    std::vector<float> frame(dimensions[0] * dimensions[1] * dimensions[2]);
+
+    for (unsigned int t = 0; t < dimensions[3]; ++t)
+    {
+      const double center[] = { 12 + 1.5 * t, 14 + 1.0 * t, 17 - 0.5 * t };
+      auto pixel = frame.begin();
+
+      for (unsigned int z = 0; z < dimensions[2]; ++z)
+        for (unsigned int y = 0; y < dimensions[1]; ++y)
+          for (unsigned int x = 0; x < dimensions[0]; ++x, ++pixel)
+          {
+            const double squaredDistance = (x - center[0]) * (x - center[0]) + (y - center[1]) * (y - center[1]) +
+              (z - center[2]) * (z - center[2]);
+            *pixel = static_cast<float>(100.0 * std::exp(-squaredDistance / 50.0));
+          }
+
+      image->SetVolume(frame.data(), t);
+    }
+
+    return image;
+  }
+
+  static mitk::Image::Pointer RegisterFrames(const mitk::Image* image, unsigned int numberOfThreads, bool warmStart)
+  {
+    auto helper = mitk::TimeFramesRegistrationHelper::New();
+    helper->Set4DImage(image);
+    helper->SetAlgorithm(mitk::MultiModalTranslationDefaultRegistrationAlgorithm<FrameImageType>::New());
+    helper->SetNumberOfThreads(numberOfThreads);
+    helper->SetWarmStart(warmStart);
+
+    return helper->GetRegisteredImage();
+  }
+
+  /** Intensity weighted center of the frame in index coordinates.*/
+  static mitk::Vector3D GetCenterOfMass(mitk::Image* image, unsigned int t)
+  {
+    mitk::ImageReadAccessor accessor(image, image->GetVolumeData(t));
+    auto pixel = static_cast<const float*>(accessor.GetData());
+
+    mitk::Vector3D center;
+    center.Fill(0.0);
+    double sum = 0.0;
+
+    for (unsigned int z = 0; z < image->GetDimension(2); ++z)
+      for (unsigned int y = 0; y < image->GetDimension(1); ++y)
+        for (unsigned int x = 0; x < image->GetDimension(0); ++x, ++pixel)
+        {
+          center[0] += x * *pixel;
+          center[1] += y * *pixel;
+          center[2] += z * *pixel;
+          sum += *pixel;
+        }
+
+    return center / sum;
+  }
+
+  static void AssertFramesAligned(mitk::Image* image)
+  {
+    const auto target = GetCenterOfMass(image, 0);
+
+    for (unsigned int t = 1; t < image->GetTimeSteps(); ++t)
+    {
+      const auto difference = GetCenterOfMass(image, t) - target;
+      CPPUNIT_ASSERT_MESSAGE("Registered frame #" + std::to_string(t) + " is aligned with the first frame",
+                             difference.GetNorm() < 1.0);
+    }
+  }
+
 public:
   void setUp() override
   {
@@ -102,6 +188,47 @@ public:
     CPPUNIT_ASSERT(frameRegHelper->GetIgnoreList().empty());
   }
 
+  void SetNumberOfThreads_GetNumberOfThreads()
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on default value", 1u, frameRegHelper->GetNumberOfThreads());
+
+    itk::ModifiedTimeType mtime = frameRegHelper->GetMTime();
+    frameRegHelper->SetNumberOfThreads(0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on changed value", 0u, frameRegHelper->GetNumberOfThreads());
+    CPPUNIT_ASSERT(mtime < frameRegHelper->GetMTime());
+  }
+
+  void SetWarmStart_GetWarmStart()
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on default value", false, frameRegHelper->GetWarmStart());
+    frameRegHelper->WarmStartOn();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on changed value", true, frameRegHelper->GetWarmStart());
+    frameRegHelper->SetWarmStart(false);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on changed value", false, frameRegHelper->GetWarmStart());
+  }
+
+  void Generate_MultiThreaded_EqualsSequential()
+  {
+    auto image = GenerateMovingBlob();
+
+    auto sequentialResult = RegisterFrames(image, 1, false);
+    auto concurrentResult = RegisterFrames(image, 3, false);
+
+    AssertFramesAligned(sequentialResult);
+
+    // every frame is registered from scratch by an algorithm with identical settings
+    MITK_ASSERT_EQUAL(sequentialResult, concurrentResult, "Frames registered on several threads equal sequential result");
+  }
+
+  void Generate_WarmStart_AlignsFrames()
+  {
+    auto image = GenerateMovingBlob();
+
+    // the chunks of warm started frames depend on the number of threads, thus the results are only comparable by
+    // the alignment of the frames
+    AssertFramesAligned(RegisterFrames(image, 1, true));
+    AssertFramesAligned(RegisterFrames(image, 2, true));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkTimeFramesRegistrationHelper)
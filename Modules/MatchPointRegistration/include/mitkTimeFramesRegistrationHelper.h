@@ -39,6 +39,13 @@ namespace mitk
    * - mitk::FrameRegistrationEvent: when ever a frame was registered.
    * - mitk::FrameMappingEvent: when ever a frame was mapped registered.
    * - itk::ProgressEvent: when ever a new frame was added to the result image.
+   *
+   * Frames can be registered concurrently (see SetNumberOfThreads). Each worker thread then uses its own instance of
+   * the algorithm, created via CreateAnother() and configured with the readable and writable meta properties of the set
+   * algorithm. Mapped frames are written by the workers directly into the result image; a frame is only locked while it
+   * is copied. All events are still invoked by the thread that called Generate(), thus observers need not be thread
+   * safe. If warm start is activated, the registration of a frame is initialized with the registration of the
+   * preceding frame processed by the same worker (see SetWarmStart).
    */
   class MITKMATCHPOINTREGISTRATION_EXPORT TimeFramesRegistrationHelper : public itk::Object
   {
@@ -78,6 +85,24 @@ namespace mitk
     itkSetMacro(InterpolatorType, mitk::ImageMappingInterpolator::Type);
     itkGetConstMacro(InterpolatorType, mitk::ImageMappingInterpolator::Type);
 
+    /** Number of frames that are registered concurrently. 1 (default) processes all frames one after another on the
+     * calling thread with the set algorithm instance. 0 uses one thread per hardware thread. If the algorithm cannot be
+     * duplicated (no meta property interface), the frames are processed sequentially.
+     * The duplicates only get the settings of the algorithm that are readable and writable meta properties (see
+     * CloneAlgorithm). Use more than one thread only if the algorithm is completely configured by its meta properties.*/
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /** Indicates if the registration of a frame should start from the registration of its temporal neighbor.
+     * The moving frame is premapped with the neighbor registration, registered to the target frame and the resulting
+     * registration is combined with the neighbor registration. Thus the algorithm only has to find the (small) motion
+     * between the neighboring frames. The frames are processed in contiguous chunks (one per thread), the first frame
+     * of each chunk is registered without warm start. Warm start is only supported for 3D registrations; other
+     * registrations are always computed from scratch. Default is false.*/
+    itkSetMacro(WarmStart, bool);
+    itkGetConstMacro(WarmStart, bool);
+    itkBooleanMacro(WarmStart);
+
     /** cleares the ignore list. Therefore all frames will be processed.*/
     void ClearIgnoreList();
     void SetIgnoreList(const IgnoreListType& il);
@@ -110,6 +135,8 @@ namespace mitk
       m_AllowUnregPixels(true),
       m_ErrorValue(0),
       m_InterpolatorType(mitk::ImageMappingInterpolator::Linear),
+      m_NumberOfThreads(1),
+      m_WarmStart(false),
       m_Progress(0)
     {
       m_4DImage = nullptr;
@@ -122,6 +149,13 @@ namespace mitk
     RegistrationPointer DoFrameRegistration(const mitk::Image* movingFrame,
                                             const mitk::Image* targetFrame, const mitk::Image* targetMask) const;
 
+    /** Registers the frame with the passed algorithm instance. If neighborReg is set and warm start is possible,
+     * the moving frame is premapped with neighborReg and the returned registration is the combination of neighborReg
+     * and the registration of the premapped frame.*/
+    RegistrationPointer DoFrameRegistration(RegistrationAlgorithmBaseType* algorithm, const mitk::Image* movingFrame,
+                                            const mitk::Image* targetFrame, const mitk::Image* targetMask,
+                                            const RegistrationType* neighborReg) const;
+
     mitk::Image::Pointer DoFrameMapping(const mitk::Image* movingFrame, const RegistrationType* reg,
                                         const mitk::Image* targetFrame) const;
 
@@ -132,6 +166,12 @@ namespace mitk
 
     mitk::Image::Pointer GetFrameImage(const mitk::Image* image, mitk::TimePointType timePoint) const;
 
+    /** Creates a new instance of the algorithm and copies all readable and writable meta properties of m_Algorithm.
+     * Settings that are not exposed as writable meta properties (e.g. configured directly on the ITK components of
+     * the algorithm) keep the defaults of the new instance. Register such algorithms with one thread.
+     * Returns nullptr if the algorithm does not support the meta property interface.*/
+    RegistrationAlgorithmPointer CloneAlgorithm() const;
+
     RegistrationAlgorithmPointer m_Algorithm;
 
   private:
@@ -152,6 +192,9 @@ namespace mitk
     /** Type of interpolator. Only relevant for images and if m_doGeometryRefinement is false. */
     mitk::ImageMappingInterpolator::Type m_InterpolatorType;
 
+    unsigned int m_NumberOfThreads;
+    bool m_WarmStart;
+
     double m_Progress;
   };
 
@@ -15,10 +15,24 @@ found in the LICENSE file.
 #include "mitkTimeFramesRegistrationHelper.h"
 #include <mitkImageTimeSelector.h>
 #include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
 
 #include <mitkMaskedAlgorithmHelper.h>
 #include <mitkMAPAlgorithmHelper.h>
 
+#include <mapMetaPropertyAlgorithmInterface.h>
+#include <mapRegistration.h>
+#include <mapRegistrationCombinator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 mitk::Image::Pointer
 mitk::TimeFramesRegistrationHelper::GetFrameImage(const mitk::Image* image,
     mitk::TimePointType timePoint) const
@@ -32,75 +46,312 @@ mitk::TimeFramesRegistrationHelper::GetFrameImage(const mitk::Image* image,
   return frameImage;
 };
 
+namespace
+{
+  /** Processing step of a frame that a worker reports to the thread that called Generate().*/
+  struct FrameNotification
+  {
+    enum StepType
+    {
+      Registered,
+      Mapped,
+      Stored
+    };
+
+    mitk::TimeStepType frame;
+    StepType step;
+    mitk::BaseGeometry::Pointer geometry;
+  };
+
+  /** Input images used by one worker. Every worker has its own instances, because the conversion into ITK images
+   * is not thread safe for shared inputs.*/
+  struct WorkerInputs
+  {
+    ::map::algorithm::RegistrationAlgorithmBase::Pointer algorithm;
+    mitk::Image::Pointer targetFrame;
+    mitk::Image::ConstPointer mask;
+  };
+}
+
 void
 mitk::TimeFramesRegistrationHelper::Generate()
 {
   CheckValidInputs();
 
   //prepare processing
-  mitk::Image::Pointer targetFrame = GetFrameImage(this->m_4DImage, 0);
-
   this->m_Registered4DImage = this->m_4DImage->Clone();
 
-  Image::ConstPointer mask;
+  const unsigned int timeSteps = this->m_4DImage->GetTimeSteps();
+  double progressDelta = 1.0 / ((timeSteps - 1) * 3.0);
+  m_Progress = 0.0;
 
-  if (m_TargetMask.IsNotNull())
+  std::vector<mitk::TimeStepType> frames;
+  for (unsigned int i = 1; i < timeSteps; ++i)
   {
-    if (m_TargetMask->GetTimeSteps() > 1)
+    IgnoreListType::iterator finding = std::find(m_IgnoreList.begin(), m_IgnoreList.end(), i);
+
+    if (finding == m_IgnoreList.end())
     {
-      mask = GetFrameImage(m_TargetMask, 0);
+      frames.push_back(i);
     }
     else
     {
-      mask = m_TargetMask;
+      //frame is already copied by the clone
+      m_Progress += 3 * progressDelta;
+      this->InvokeEvent(::itk::ProgressEvent());
     }
   }
 
-  double progressDelta = 1.0 / ((this->m_4DImage->GetTimeSteps() - 1) * 3.0);
-  m_Progress = 0.0;
-
-  //process the frames
-  for (unsigned int i = 1; i < this->m_4DImage->GetTimeSteps(); ++i)
+  if (frames.empty())
   {
-    Image::Pointer movingFrame = GetFrameImage(this->m_4DImage, i);
-    Image::Pointer mappedFrame;
+    return;
+  }
 
-    IgnoreListType::iterator finding = std::find(m_IgnoreList.begin(), m_IgnoreList.end(), i);
+  unsigned int numberOfThreads = m_NumberOfThreads > 0 ? m_NumberOfThreads : std::thread::hardware_concurrency();
+  numberOfThreads = std::max(1u, std::min<unsigned int>(numberOfThreads, frames.size()));
 
+  std::vector<WorkerInputs> workerInputs(numberOfThreads);
 
-    if (finding == m_IgnoreList.end())
+  for (auto& inputs : workerInputs)
+  {
+    if (numberOfThreads == 1)
     {
-      //frame should be processed
-      RegistrationPointer reg = DoFrameRegistration(movingFrame, targetFrame, mask);
+      inputs.algorithm = m_Algorithm;
+    }
+    else
+    {
+      inputs.algorithm = this->CloneAlgorithm();
+
+      if (inputs.algorithm.IsNull())
+      {
+        MITK_WARN << "Cannot register frames concurrently. Algorithm cannot be duplicated, because it does not support "
+                     "the meta property interface. Frames will be registered sequentially.";
+        numberOfThreads = 1;
+        workerInputs.resize(1);
+        workerInputs.front().algorithm = m_Algorithm;
+        break;
+      }
+    }
+  }
 
-      m_Progress += progressDelta;
-      this->InvokeEvent(::mitk::FrameRegistrationEvent(nullptr,
-                        "Registred frame #" +::map::core::convert::toStr(i)));
+  for (auto& inputs : workerInputs)
+  {
+    inputs.targetFrame = GetFrameImage(this->m_4DImage, 0);
 
-      mappedFrame = DoFrameMapping(movingFrame, reg, targetFrame);
+    if (m_TargetMask.IsNotNull())
+    {
+      if (m_TargetMask->GetTimeSteps() > 1)
+      {
+        inputs.mask = GetFrameImage(m_TargetMask, 0);
+      }
+      else if (numberOfThreads > 1)
+      {
+        inputs.mask = m_TargetMask->Clone();
+      }
+      else
+      {
+        inputs.mask = m_TargetMask;
+      }
+    }
+  }
 
-      m_Progress += progressDelta;
-      this->InvokeEvent(::mitk::FrameMappingEvent(nullptr,
-                        "Mapped frame #" + ::map::core::convert::toStr(i)));
+  //The time selector references the memory of the input, thus extracting all frames upfront is cheap
+  //and keeps the pipeline of the input image out of the worker threads.
+  std::vector<Image::Pointer> movingFrames;
+  movingFrames.reserve(frames.size());
+  for (auto i : frames)
+  {
+    movingFrames.push_back(GetFrameImage(this->m_4DImage, i));
+  }
 
-      mitk::ImageReadAccessor accessor(mappedFrame, mappedFrame->GetVolumeData(0, 0, nullptr,
-                                       mitk::Image::ReferenceMemory));
+  //the mapped frames are written directly into the result. Each frame is only locked while it is copied, so that
+  //observers of the events may access the result image.
+  const std::size_t frameSize = static_cast<std::size_t>(this->m_Registered4DImage->GetPixelType().GetSize()) *
+    this->m_Registered4DImage->GetDimension(0) * this->m_Registered4DImage->GetDimension(1) *
+    this->m_Registered4DImage->GetDimension(2);
 
+  auto handleNotification = [this, progressDelta](const FrameNotification& notification)
+  {
+    m_Progress += progressDelta;
+
+    switch (notification.step)
+    {
+      case FrameNotification::Registered:
+        this->InvokeEvent(::mitk::FrameRegistrationEvent(nullptr,
+                          "Registred frame #" + ::map::core::convert::toStr(notification.frame)));
+        break;
+      case FrameNotification::Mapped:
+        this->InvokeEvent(::mitk::FrameMappingEvent(nullptr,
+                          "Mapped frame #" + ::map::core::convert::toStr(notification.frame)));
+        break;
+      case FrameNotification::Stored:
+        this->m_Registered4DImage->GetTimeGeometry()->SetTimeStepGeometry(notification.geometry, notification.frame);
+        this->InvokeEvent(::itk::ProgressEvent());
+        break;
+    }
+  };
 
-      this->m_Registered4DImage->SetVolume(accessor.GetData(), i);
-      this->m_Registered4DImage->GetTimeGeometry()->SetTimeStepGeometry(mappedFrame->GetGeometry(), i);
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<FrameNotification> notifications;
+  std::atomic<std::size_t> nextPosition(0);
+  std::atomic<bool> cancelled(false);
+  std::exception_ptr exception;
+  unsigned int finishedWorkers = 0;
 
-      m_Progress += progressDelta;
+  auto notify = [&](const FrameNotification& notification)
+  {
+    if (numberOfThreads == 1)
+    {
+      handleNotification(notification);
     }
     else
     {
-      m_Progress += 3 * progressDelta;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        notifications.push_back(notification);
+      }
+      condition.notify_one();
+    }
+  };
+
+  auto processFrames = [&](unsigned int workerID)
+  {
+    const WorkerInputs& inputs = workerInputs[workerID];
+
+    //with warm start each worker processes a contiguous chunk of frames, otherwise the frames are fetched dynamically
+    std::size_t position = m_WarmStart ? (frames.size() * workerID) / numberOfThreads : 0;
+    const std::size_t end = m_WarmStart ? (frames.size() * (workerID + 1)) / numberOfThreads : frames.size();
+
+    RegistrationPointer neighborReg;
+
+    while (!cancelled)
+    {
+      if (!m_WarmStart)
+      {
+        position = nextPosition++;
+      }
+
+      if (position >= end)
+      {
+        break;
+      }
+
+      const mitk::TimeStepType i = frames[position];
+      const Image* movingFrame = movingFrames[position];
+
+      RegistrationPointer reg = DoFrameRegistration(inputs.algorithm, movingFrame, inputs.targetFrame, inputs.mask,
+                                                    neighborReg);
+      notify({ i, FrameNotification::Registered, nullptr });
+
+      Image::Pointer mappedFrame = DoFrameMapping(movingFrame, reg, inputs.targetFrame);
+      notify({ i, FrameNotification::Mapped, nullptr });
+
+      {
+        mitk::ImageReadAccessor accessor(mappedFrame, mappedFrame->GetVolumeData(0, 0, nullptr,
+                                         mitk::Image::ReferenceMemory));
+
+        const std::size_t mappedSize = static_cast<std::size_t>(mappedFrame->GetPixelType().GetSize()) *
+          mappedFrame->GetDimension(0) * mappedFrame->GetDimension(1) * mappedFrame->GetDimension(2);
+
+        if (mappedSize != frameSize)
+        {
+          mitkThrow() << "Cannot store mapped frame #" << i << ". Size of the mapped frame (" << mappedSize
+                      << " bytes) differs from the frame size of the 4D image (" << frameSize << " bytes).";
+        }
+
+        mitk::ImageWriteAccessor resultAccessor(this->m_Registered4DImage,
+                                                this->m_Registered4DImage->GetVolumeData(i));
+        std::memcpy(resultAccessor.GetData(), accessor.GetData(), frameSize);
+      }
+
+      notify({ i, FrameNotification::Stored, mappedFrame->GetGeometry() });
+
+      if (m_WarmStart)
+      {
+        neighborReg = reg;
+        ++position;
+      }
+    }
+  };
+
+  if (numberOfThreads == 1)
+  {
+    processFrames(0);
+    return;
+  }
+
+  auto worker = [&](unsigned int workerID)
+  {
+    try
+    {
+      processFrames(workerID);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!exception)
+      {
+        exception = std::current_exception();
+      }
+      cancelled = true;
     }
 
-    this->InvokeEvent(::itk::ProgressEvent());
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++finishedWorkers;
+    }
+    condition.notify_one();
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numberOfThreads);
+  for (unsigned int t = 0; t < numberOfThreads; ++t)
+  {
+    threads.emplace_back(worker, t);
+  }
+
+  //all events are invoked by the calling thread
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    condition.wait(lock, [&]() { return !notifications.empty() || finishedWorkers == numberOfThreads; });
+
+    if (notifications.empty())
+    {
+      break;
+    }
+
+    const FrameNotification notification = notifications.front();
+    notifications.pop_front();
+
+    lock.unlock();
+    try
+    {
+      handleNotification(notification);
+    }
+    catch (...)
+    {
+      cancelled = true;
+      for (auto& thread : threads)
+      {
+        thread.join();
+      }
+      throw;
+    }
+    lock.lock();
+  }
+  lock.unlock();
 
+  for (auto& thread : threads)
+  {
+    thread.join();
   }
 
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
 };
 
 mitk::Image::Pointer
@@ -134,17 +385,91 @@ mitk::TimeFramesRegistrationHelper::RegistrationPointer
 mitk::TimeFramesRegistrationHelper::DoFrameRegistration(const mitk::Image* movingFrame,
     const mitk::Image* targetFrame, const mitk::Image* targetMask) const
 {
-  mitk::MAPAlgorithmHelper algHelper(m_Algorithm);
+  return DoFrameRegistration(m_Algorithm, movingFrame, targetFrame, targetMask, nullptr);
+};
+
+mitk::TimeFramesRegistrationHelper::RegistrationPointer
+mitk::TimeFramesRegistrationHelper::DoFrameRegistration(RegistrationAlgorithmBaseType* algorithm,
+    const mitk::Image* movingFrame, const mitk::Image* targetFrame, const mitk::Image* targetMask,
+    const RegistrationType* neighborReg) const
+{
+  typedef ::map::core::Registration<3, 3> Registration3DType;
+
+  auto neighborReg3D = dynamic_cast<const Registration3DType*>(neighborReg);
+
+  Image::Pointer premappedFrame;
+  if (neighborReg3D)
+  {
+    //warm start: the algorithm only has to register the motion relative to the neighbor
+    premappedFrame = DoFrameMapping(movingFrame, neighborReg, targetFrame);
+    movingFrame = premappedFrame;
+  }
+
+  mitk::MAPAlgorithmHelper algHelper(algorithm);
   algHelper.SetAllowImageCasting(true);
   algHelper.SetData(movingFrame, targetFrame);
 
   if (targetMask)
   {
-    mitk::MaskedAlgorithmHelper maskHelper(m_Algorithm);
+    mitk::MaskedAlgorithmHelper maskHelper(algorithm);
     maskHelper.SetMasks(nullptr, targetMask);
   }
 
-  return algHelper.GetRegistration();
+  RegistrationPointer reg = algHelper.GetRegistration();
+
+  if (neighborReg3D)
+  {
+    auto reg3D = dynamic_cast<const Registration3DType*>(reg.GetPointer());
+
+    if (!reg3D)
+    {
+      mitkThrow() << "Cannot combine warm started frame registration with the registration of the neighbor frame. "
+                     "Algorithm does not generate a 3D registration.";
+    }
+
+    typedef ::map::core::RegistrationCombinator<Registration3DType, Registration3DType> CombinatorType;
+    CombinatorType::Pointer combinator = CombinatorType::New();
+    reg = combinator->process(*neighborReg3D, *reg3D).GetPointer();
+  }
+
+  return reg;
+};
+
+mitk::TimeFramesRegistrationHelper::RegistrationAlgorithmPointer
+mitk::TimeFramesRegistrationHelper::CloneAlgorithm() const
+{
+  typedef ::map::algorithm::facet::MetaPropertyAlgorithmInterface MetaInterfaceType;
+
+  auto sourceMetaInterface = dynamic_cast<MetaInterfaceType*>(m_Algorithm.GetPointer());
+
+  if (!sourceMetaInterface)
+  {
+    return nullptr;
+  }
+
+  RegistrationAlgorithmPointer clone =
+    dynamic_cast<RegistrationAlgorithmBaseType*>(m_Algorithm->CreateAnother().GetPointer());
+  auto cloneMetaInterface = dynamic_cast<MetaInterfaceType*>(clone.GetPointer());
+
+  if (!cloneMetaInterface)
+  {
+    return nullptr;
+  }
+
+  for (const auto& pInfo : sourceMetaInterface->getPropertyInfos())
+  {
+    if (pInfo->isReadable() && pInfo->isWritable())
+    {
+      MetaInterfaceType::MetaPropertyPointer prop = sourceMetaInterface->getProperty(pInfo);
+
+      if (prop.IsNotNull() && !cloneMetaInterface->setProperty(pInfo, prop))
+      {
+        MITK_WARN << "Cannot copy algorithm property \"" << pInfo->getName() << "\" to the duplicated algorithm.";
+      }
+    }
+  }
+
+  return clone;
 };
 
 mitk::Image::Pointer mitk::TimeFramesRegistrationHelper::DoFrameMapping(
@@ -32,7 +32,16 @@ namespace itk
  * operation to be applied.  A Functor style is used to represent the
  * function.\n
  *
- * All the input images must be of the same type.
+ * All the input images must be of the same type.\n
+ * The filter does not split the output into fixed regions per thread. It rather
+ * collects the indices of all voxels that have to be processed (all voxels inside
+ * the mask, or all voxels if no mask is set) into a compact list and lets the
+ * workers fetch small chunks of this list (see SetChunkSize()) until it is exhausted.
+ * Thus workers stay busy even if the mask is sparse or the evaluation costs vary
+ * strongly between voxels (e.g. iterative fits that converge at different speeds).
+ * Every worker uses its own copy of the functor, so functors may keep per worker
+ * state between voxels (e.g. mitk::ModelFitFunctorPolicy reuses its model instance).
+ * Voxels outside the mask are set to zero in all outputs.
  *
  * \ingroup IntensityImageFilters MultiThreaded
  * \ingroup ITKImageIntensity
@@ -96,6 +105,20 @@ public:
   itkSetObjectMacro(Mask, MaskImageType);
   itkGetConstObjectMacro(Mask, MaskImageType);
 
+  /** Number of voxels a worker fetches from the voxel list at once. Default is 16.*/
+  itkSetClampMacro(ChunkSize, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(ChunkSize, SizeValueType);
+
+  /** Number of voxels the functor was evaluated for during the last update.*/
+  itkGetConstMacro(NumberOfProcessedVoxels, SizeValueType);
+  /** Wall clock time (in s) needed to evaluate the functor for all voxels during the last update.*/
+  itkGetConstMacro(ProcessingTime, double);
+  /** Throughput (processed voxels per second) of the last update.*/
+  double GetVoxelsPerSecond() const
+  {
+    return m_ProcessingTime > 0. ? static_cast<double>(m_NumberOfProcessedVoxels) / m_ProcessingTime : 0.;
+  }
+
   /** ImageDimension constants */
   itkStaticConstMacro(
     InputImageDimension, unsigned int, TInputImage::ImageDimension);
@@ -114,18 +137,10 @@ protected:
   MultiOutputNaryFunctorImageFilter();
   ~MultiOutputNaryFunctorImageFilter() override {}
 
-  /** MultiOutputNaryFunctorImageFilter can be implemented as a multi threaded filter.
-   * Therefore, this implementation provides a ThreadedGenerateData() routine
-   * which is called for each processing thread. The output image data is
-   * allocated automatically by the superclass prior to calling
-   * ThreadedGenerateData().  ThreadedGenerateData can only write to the
-   * portion of the output image specified by the parameter
-   * "outputRegionForThread"
-   *
-   * \sa ImageToImageFilter::ThreadedGenerateData(),
-   *     ImageToImageFilter::GenerateData()  */
-  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
-                            ThreadIdType threadId) override;
+  /** Allocates the outputs, builds the list of voxels to process and distributes
+   * it dynamically in chunks over the work units of the multi threader.
+   * \sa ImageSource::GenerateData()  */
+  void GenerateData() override;
 
   /** Methods actualize the output settings of the filter according to the current functor*/
   void ActualizeOutputs();
@@ -136,6 +151,10 @@ private:
 
   FunctorType m_Functor;
   MaskImagePointer m_Mask;
+
+  SizeValueType m_ChunkSize;
+  SizeValueType m_NumberOfProcessedVoxels;
+  double m_ProcessingTime;
 };
 } // end namespace itk
 
@@ -14,8 +14,14 @@ found in the LICENSE file.
 #define __itkMultiOutputNaryFunctorImageFilter_hxx
 
 #include "itkMultiOutputNaryFunctorImageFilter.h"
-#include "itkImageRegionIterator.h"
-#include "itkProgressReporter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <numeric>
 
 namespace itk
 {
@@ -26,7 +32,9 @@ namespace itk
   MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
     ::MultiOutputNaryFunctorImageFilter()
   {
-    this->DynamicMultiThreadingOff();
+    m_ChunkSize = 16;
+    m_NumberOfProcessedVoxels = 0;
+    m_ProcessingTime = 0.;
 
     // This number will be incremented each time an image
     // is added over the two minimum required
@@ -54,16 +62,17 @@ namespace itk
   };
 
   /**
-  * ThreadedGenerateData Performs the pixel-wise addition
+  * GenerateData evaluates the functor for all (masked) voxels
   */
   template< class TInputImage, class TOutputImage, class TFunction, class TMaskImage >
   void
     MultiOutputNaryFunctorImageFilter< TInputImage, TOutputImage, TFunction, TMaskImage >
-    ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
-    ThreadIdType threadId)
+    ::GenerateData()
   {
-    ProgressReporter progress( this, threadId,
-      outputRegionForThread.GetNumberOfPixels() );
+    m_NumberOfProcessedVoxels = 0;
+    m_ProcessingTime = 0.;
+
+    this->AllocateOutputs();
 
     const unsigned int numberOfInputImages =
       static_cast< unsigned int >( this->GetNumberOfIndexedInputs() );
@@ -71,162 +80,151 @@ namespace itk
     const unsigned int numberOfOutputImages =
       static_cast< unsigned int >( this->GetNumberOfIndexedOutputs() );
 
-    typedef ImageRegionConstIterator< TInputImage > ImageRegionConstIteratorType;
-    std::vector< ImageRegionConstIteratorType * > inputItrVector;
-    inputItrVector.reserve(numberOfInputImages);
-
-    typedef ImageRegionIterator< TOutputImage > OutputImageRegionIteratorType;
-    std::vector< OutputImageRegionIteratorType * > outputItrVector;
-    outputItrVector.reserve(numberOfOutputImages);
-
-    //check if mask image is set and generate iterator if mask is valid
-    typedef ImageRegionConstIterator< TMaskImage > MaskImageRegionIteratorType;
-    MaskImageRegionIteratorType* pMaskIterator = nullptr;
+    // go through the inputs and outputs and collect the non-null ones
+    std::vector< const TInputImage * > inputs;
+    inputs.reserve(numberOfInputImages);
 
-    if (m_Mask.IsNotNull())
-    {
-      if (!m_Mask->GetLargestPossibleRegion().IsInside(outputRegionForThread))
-      {
-        itkExceptionMacro("Mask of filter is set but does not cover region of thread. Mask region: "<< m_Mask->GetLargestPossibleRegion() <<"Thread region: "<<outputRegionForThread)
-      }
-      pMaskIterator = new MaskImageRegionIteratorType(m_Mask,outputRegionForThread);
-    }
-
-    // go through the inputs and add iterators for non-null inputs
     for ( unsigned int i = 0; i < numberOfInputImages; ++i )
     {
-      InputImagePointer inputPtr =
-        dynamic_cast< TInputImage * >( ProcessObject::GetInput(i) );
+      const auto inputPtr = dynamic_cast< const TInputImage * >( ProcessObject::GetInput(i) );
 
       if ( inputPtr )
       {
-        inputItrVector.push_back( new ImageRegionConstIteratorType(inputPtr, outputRegionForThread) );
+        inputs.push_back(inputPtr);
       }
-
     }
 
-    // go through the outputs and add iterators for non-null outputs
+    std::vector< TOutputImage * > outputs;
+    outputs.reserve(numberOfOutputImages);
+
     for ( unsigned int i = 0; i < numberOfOutputImages; ++i )
     {
-      OutputImagePointer outputPtr =
-        dynamic_cast< TOutputImage * >( ProcessObject::GetOutput(i) );
+      const auto outputPtr = dynamic_cast< TOutputImage * >( ProcessObject::GetOutput(i) );
 
       if ( outputPtr )
       {
-        outputItrVector.push_back( new OutputImageRegionIteratorType(outputPtr, outputRegionForThread) );
+        outputs.push_back(outputPtr);
       }
     }
 
-    typename std::vector< ImageRegionConstIteratorType * >::iterator regionInputIterators;
-    const typename std::vector< ImageRegionConstIteratorType * >::const_iterator regionInputItEnd =
-      inputItrVector.end();
+    if ( inputs.empty() || outputs.empty() )
+    {
+      return;
+    }
 
-    typename std::vector< OutputImageRegionIteratorType * >::iterator regionOutputIterators;
-    const typename std::vector< OutputImageRegionIteratorType * >::const_iterator regionOutputItEnd =
-      outputItrVector.end();
+    const OutputImageRegionType outputRegion = outputs.front()->GetRequestedRegion();
 
-    const unsigned int numberOfValidInputImages = inputItrVector.size();
-    const unsigned int numberOfValidOutputImages = outputItrVector.size();
+    // Build the compact list of the voxels that have to be evaluated. The list stores
+    // offsets into the output buffers, which all cover exactly the requested region.
+    std::vector< OffsetValueType > voxelOffsets;
 
-    if ( (numberOfValidInputImages != 0) && ( numberOfValidOutputImages != 0))
+    if (m_Mask.IsNotNull())
     {
-      try
+      if (!m_Mask->GetLargestPossibleRegion().IsInside(outputRegion))
+      {
+        itkExceptionMacro("Mask of filter is set but does not cover the output region. Mask region: "<< m_Mask->GetLargestPossibleRegion() <<"Output region: "<<outputRegion)
+      }
+
+      for (auto outputPtr : outputs)
       {
+        outputPtr->FillBuffer(NumericTraits< OutputImagePixelType >::ZeroValue());
+      }
 
-        while ( !(outputItrVector.front()->IsAtEnd()) )
+      ImageRegionConstIterator< TMaskImage > maskIterator(m_Mask, outputRegion);
+      for (OffsetValueType offset = 0; !maskIterator.IsAtEnd(); ++maskIterator, ++offset)
+      {
+        if (maskIterator.Get() > 0)
         {
-          typename NaryInputArrayType::iterator arrayInIt;
-          typename NaryOutputArrayType::iterator arrayOutIt;
-          NaryInputArrayType naryInputArray(numberOfValidInputImages);
-          NaryOutputArrayType naryOutputArray(numberOfValidOutputImages);
+          voxelOffsets.push_back(offset);
+        }
+      }
+    }
+    else
+    {
+      voxelOffsets.resize(outputRegion.GetNumberOfPixels());
+      std::iota(voxelOffsets.begin(), voxelOffsets.end(), OffsetValueType(0));
+    }
 
-          bool isValid = true;
+    const SizeValueType numberOfVoxels = voxelOffsets.size();
 
-          if (pMaskIterator)
-          {
-            isValid = pMaskIterator->Get() > 0;
-            ++(*pMaskIterator);
-          }
+    if (0 == numberOfVoxels)
+    {
+      return;
+    }
 
-          arrayInIt = naryInputArray.begin();
-          regionInputIterators = inputItrVector.begin();
+    const SizeValueType numberOfChunks = (numberOfVoxels + m_ChunkSize - 1) / m_ChunkSize;
+    const SizeValueType numberOfWorkers = std::max< SizeValueType >(1,
+      std::min< SizeValueType >(this->GetNumberOfWorkUnits(), numberOfChunks));
 
-          typename ImageRegionConstIteratorType::IndexType currentIndex;
-          if(regionInputIterators != regionInputItEnd)
-          {
-            currentIndex = ( *regionInputIterators )->GetIndex();
-          }
+    std::atomic< SizeValueType > nextChunk(0);
+    std::atomic< bool > failed(false);
+    std::vector< std::exception_ptr > workerExceptions(numberOfWorkers);
 
-          while ( regionInputIterators != regionInputItEnd )
-          {
-            *arrayInIt++ = ( *regionInputIterators )->Get();
-            ++( *( *regionInputIterators ) );
-            ++regionInputIterators;
-          }
+    const float progressPerVoxel = 1.f / static_cast< float >(numberOfVoxels);
+
+    auto worker = [&](SizeValueType workerId)
+    {
+      try
+      {
+        // per worker functor copy and input array, reused for all voxels of the worker
+        FunctorType functor(m_Functor);
+        NaryInputArrayType naryInputArray(inputs.size());
+        const TOutputImage* referenceOutput = outputs.front();
 
-          if (isValid)
+        for (SizeValueType chunk = nextChunk++; chunk < numberOfChunks && !failed; chunk = nextChunk++)
+        {
+          const SizeValueType chunkBegin = chunk * m_ChunkSize;
+          const SizeValueType chunkEnd = std::min(numberOfVoxels, chunkBegin + m_ChunkSize);
+
+          for (SizeValueType pos = chunkBegin; pos < chunkEnd; ++pos)
           {
-            naryOutputArray = m_Functor(naryInputArray, currentIndex);
+            const OffsetValueType offset = voxelOffsets[pos];
+            const auto currentIndex = referenceOutput->ComputeIndex(offset);
 
-            if (numberOfValidOutputImages != naryOutputArray.size())
+            for (typename std::vector< const TInputImage * >::size_type i = 0; i < inputs.size(); ++i)
             {
-              itkExceptionMacro("Error. Number of valid output images do not equal number of outputs required by functor. Number of valid outputs: "<< numberOfValidOutputImages << "; needed output number:" << this->m_Functor.GetNumberOfOutputs());
+              naryInputArray[i] = inputs[i]->GetPixel(currentIndex);
             }
-          }
-          else
-          {
-            for (typename NaryOutputArrayType::iterator pos = naryOutputArray.begin(); pos!= naryOutputArray.end(); ++pos)
+
+            const NaryOutputArrayType naryOutputArray = functor(naryInputArray, currentIndex);
+
+            if (outputs.size() != naryOutputArray.size())
             {
-                *pos = 0.0;
+              itkExceptionMacro("Error. Number of valid output images do not equal number of outputs required by functor. Number of valid outputs: "<< outputs.size() << "; needed output number:" << functor.GetNumberOfOutputs());
             }
-          }
 
-          arrayOutIt = naryOutputArray.begin();
-          regionOutputIterators = outputItrVector.begin();
-          while ( regionOutputIterators != regionOutputItEnd )
-          {
-            ( *regionOutputIterators )->Set(*arrayOutIt++);
-            ++( *( *regionOutputIterators ) );
-            ++regionOutputIterators;
+            for (typename std::vector< TOutputImage * >::size_type i = 0; i < outputs.size(); ++i)
+            {
+              outputs[i]->GetBufferPointer()[offset] = naryOutputArray[i];
+            }
           }
 
-          progress.CompletedPixel();
+          this->IncrementProgress(progressPerVoxel * (chunkEnd - chunkBegin));
         }
       }
-      catch(...)
+      catch (...)
       {
-        // Free memory in case of exceptions
-        regionInputIterators = inputItrVector.begin();
-        while ( regionInputIterators != regionInputItEnd )
-        {
-          delete ( *regionInputIterators++ );
-        }
-
-        regionOutputIterators = outputItrVector.begin();
-        while ( regionOutputIterators != regionOutputItEnd )
-        {
-          delete ( *regionOutputIterators++ );
-        }
-
-        delete pMaskIterator;
-        throw;
+        failed = true;
+        workerExceptions[workerId] = std::current_exception();
       }
-    }
+    };
 
-    // Free memory regulary
-    regionInputIterators = inputItrVector.begin();
-    while ( regionInputIterators != regionInputItEnd )
-    {
-      delete ( *regionInputIterators++ );
-    }
+    const auto startTime = std::chrono::steady_clock::now();
 
-    regionOutputIterators = outputItrVector.begin();
-    while ( regionOutputIterators != regionOutputItEnd )
+    // numberOfWorkers never exceeds the number of work units of the filter, so every work unit runs at
+    // most one worker. The number of work units is left untouched, it is a setting of the filter.
+    this->GetMultiThreader()->ParallelizeArray(0, numberOfWorkers, worker, nullptr);
+
+    for (const auto& workerException : workerExceptions)
     {
-      delete ( *regionOutputIterators++ );
+      if (workerException)
+      {
+        std::rethrow_exception(workerException);
+      }
     }
 
-    delete pMaskIterator;
+    m_ProcessingTime = std::chrono::duration< double >(std::chrono::steady_clock::now() - startTime).count();
+    m_NumberOfProcessedVoxels = numberOfVoxels;
   }
 } // end namespace itk
 
@@ -58,6 +58,13 @@ namespace mitk
     itkSetMacro(ActivateFailureThreshold, bool);
     itkGetConstMacro(ActivateFailureThreshold, bool);
 
+    /** If true (default) and the model offers an analytic Jacobian, the optimizer uses the analytic derivatives of
+     * the cost function instead of numerical differentiation. Numerical differentiation needs an additional model
+     * evaluation per parameter and iteration.*/
+    itkSetMacro(UseAnalyticDerivatives, bool);
+    itkGetConstMacro(UseAnalyticDerivatives, bool);
+    itkBooleanMacro(UseAnalyticDerivatives);
+
     ParameterNamesType GetCriterionNames() const override;
 
   protected:
@@ -96,6 +103,8 @@ namespace mitk
     /**If set to true and an constraint checker is set. The cost function will allways fail if the penalty of the
      checker reaches the threshold. In this case no function evaluation will be done-*/
     bool m_ActivateFailureThreshold;
+
+    bool m_UseAnalyticDerivatives;
   };
 
 }
@@ -74,6 +74,12 @@ public:
 
     /**Returns the index of the first (in terms of index position) failed parameter in the last failed evaluation.*/
     ParametersType::size_type GetFailedParameter() const;
+
+    /**Derivatives are analytic if the wrapped cost function offers analytic derivatives. The derivatives of the
+     penalty are always computed numerically, which needs no model evaluation.*/
+    bool HasAnalyticDerivative() const override;
+
+    void GetDerivative(const ParametersType &parameters, DerivativeType &derivative) const override;
 protected:
 
     MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const override;
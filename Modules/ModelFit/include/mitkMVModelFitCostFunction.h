@@ -26,6 +26,8 @@ namespace mitk
 /** Base class for all model fit cost function that return a multiple cost value
  * It offers also a default implementation for the numerical computation of the
  * derivatives. Normaly you just have to (re)implement CalcMeasure().
+ * If the model offers an analytic Jacobian (see ModelBase::HasAnalyticJacobian()) and
+ * the cost function reimplements CalcMeasureDerivative(), the derivatives are computed analytically.
 */
 class MITKMODELFIT_EXPORT MVModelFitCostFunction : public itk::MultipleValuedCostFunction, public ModelFitCostFunctionInterface
 {
@@ -45,6 +47,11 @@ public:
     MeasureType GetValue(const ParametersType& parameter) const override;
     void GetDerivative (const ParametersType &parameters, DerivativeType &derivative) const override;
 
+    /** Indicates if GetDerivative() computes the derivatives analytically instead of numerically.
+     * Default implementation returns true if the model has an analytic Jacobian and
+     * ImplementsMeasureDerivative() returns true.*/
+    virtual bool HasAnalyticDerivative() const;
+
     unsigned int GetNumberOfValues (void) const override;
     unsigned int GetNumberOfParameters (void) const override;
 
@@ -58,6 +65,16 @@ protected:
 
     virtual MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const = 0;
 
+    /** Indicates if the cost function reimplements CalcMeasureDerivative(). Default implementation returns false.*/
+    virtual bool ImplementsMeasureDerivative() const;
+
+    /** Computes the derivatives of the measure, given the model signal and its Jacobian.
+     * Only called by GetDerivative() if HasAnalyticDerivative() returns true.
+     * @param [out] derivative Is already sized to number of parameters x number of values.
+     * @remark Default implementation throws an exception.*/
+    virtual void CalcMeasureDerivative(const ParametersType &parameters, const SignalType& signal,
+                                       const ModelBase::JacobianType& signalJacobian, DerivativeType& derivative) const;
+
     MVModelFitCostFunction() : m_DerivativeStepLength(1e-5)
     {
     }
@@ -74,6 +74,12 @@ namespace mitk
     typedef double DerivedParameterValueType;
     typedef std::map<ParameterNameType, DerivedParameterValueType> DerivedParameterMapType;
 
+    /** Type of the partial derivatives of the signal. Element (i, t) is the derivative of the signal at time point t
+     * with respect to the i-th parameter (same layout as itk::MultipleValuedCostFunction::DerivativeType).*/
+    typedef itk::Array2D<double> JacobianType;
+
+    typedef ModelResultType::ValueType SignalValueType;
+
     /**Default implementation returns a scale of 1.0 for every defined parameter.*/
     ParamterScaleMapType GetParameterScales() const override;
 
@@ -168,10 +174,44 @@ namespace mitk
 
     ModelResultType GetSignal(const ParametersType& parameters) const;
 
+    /** Indicates if the model computes the partial derivatives of its signal analytically (see GetSignalAndJacobian()).
+     * Fit cost functions use the analytic Jacobian instead of numerical differentiation if it is available.
+     * @remark Default implementation returns false.*/
+    virtual bool HasAnalyticJacobian() const;
+
+    /** Returns the signal of the model and its partial derivatives with respect to the parameters.
+     * @pre HasAnalyticJacobian() must return true.
+     * @param parameters The parameters of the model.
+     * @param [out] jacobian Resized to GetNumberOfParameters() x GetTimeGrid().GetSize() and set to the derivatives.*/
+    ModelResultType GetSignalAndJacobian(const ParametersType& parameters, JacobianType& jacobian) const;
+
+    /** Computes the signals for numberOfParameterSets parameter sets (e.g. of many voxels) at once.
+     * The values are passed in structure of arrays layout:
+     * - parameters[i * numberOfParameterSets + s] is the i-th parameter of set s.
+     * - signals[t * numberOfParameterSets + s] is set to the signal of set s at time point t.
+     * .
+     * Thus the values of one parameter or time point are contiguous and models can evaluate all sets in loops that
+     * the compiler can vectorize.
+     * @pre signals must point to GetTimeGrid().GetSize() * numberOfParameterSets values.*/
+    void GetSignalBatch(const ParameterValueType* parameters, std::size_t numberOfParameterSets,
+                        SignalValueType* signals) const;
+
   protected:
 
     virtual ModelResultType ComputeModelfunction(const ParametersType& parameters) const = 0;
 
+    /** Called by GetSignalAndJacobian() after the model was validated. Reimplement together with
+     * HasAnalyticJacobian() to offer analytic derivatives.
+     * @remark Default implementation throws an exception.*/
+    virtual ModelResultType ComputeModelfunctionAndJacobian(const ParametersType& parameters,
+                                                            JacobianType& jacobian) const;
+
+    /** Called by GetSignalBatch() after the model was validated. See GetSignalBatch() for the memory layout.
+     * @remark Default implementation calls ComputeModelfunction() for every parameter set. Reimplement it to
+     * evaluate all sets in one pass.*/
+    virtual void ComputeModelfunctionBatch(const ParameterValueType* parameters, std::size_t numberOfParameterSets,
+                                           SignalValueType* signals) const;
+
     /** Member is called by GetSignal() before ComputeModelfunction(). It indicates if model is in a valid state and
      * ready to compute the signal. The default implementation checks nothing and always returns true.
      * Reimplement to realize special behavior for derived classes.
@@ -20,6 +20,11 @@ found in the LICENSE file.
 namespace mitk
 {
 
+  /** Functor policy that fits the model of the parameterizer voxel by voxel with the model fit functor.
+   * Every copy of the policy keeps its own model instance. As long as the parameterizer defines no local
+   * static parameters, the model is generated once and reused for all voxels the copy is called for.
+   * Thus filters that use one copy per thread (e.g. itk::MultiOutputNaryFunctorImageFilter) do not generate
+   * a new model per voxel.*/
   class MITKMODELFIT_EXPORT ModelFitFunctorPolicy
   {
   public:
@@ -37,6 +42,22 @@ namespace mitk
     ModelFitFunctorPolicy()
     {};
 
+    /** Copies functor and parameterizer, but not the model instance of other.*/
+    ModelFitFunctorPolicy(const ModelFitFunctorPolicy& other) : m_Functor(other.m_Functor), m_ModelParameterizer(other.m_ModelParameterizer)
+    {};
+
+    ModelFitFunctorPolicy& operator=(const ModelFitFunctorPolicy& other)
+    {
+      if (this != &other)
+      {
+        m_Functor = other.m_Functor;
+        m_ModelParameterizer = other.m_ModelParameterizer;
+        m_Model = nullptr;
+      }
+
+      return *this;
+    }
+
     ~ModelFitFunctorPolicy() {};
 
     unsigned int GetNumberOfOutputs() const
@@ -70,6 +91,7 @@ namespace mitk
       }
 
       m_ModelParameterizer = parameterizer;
+      m_Model = nullptr;
     }
 
     bool operator!=(const ModelFitFunctorPolicy& other) const
@@ -96,11 +118,15 @@ namespace mitk
         itkGenericExceptionMacro( << "Error. Cannot process operator(). Parameterizer is Null.");
       }
 
-      ParameterizerType::ModelBasePointer parameterizedModel =
-        m_ModelParameterizer->GenerateParameterizedModel(currentIndex);
+      // Local static parameters may differ per voxel, so the model has to be parameterized for every voxel.
+      if (m_Model.IsNull() || !m_ModelParameterizer->GetLocalStaticParameters(currentIndex).empty())
+      {
+        m_Model = m_ModelParameterizer->GenerateParameterizedModel(currentIndex);
+      }
+
       ParameterizerType::ParametersType initialParams = m_ModelParameterizer->GetInitialParameterization(
             currentIndex);
-      OutputPixelArrayType result = m_Functor->Compute(value, parameterizedModel, initialParams);
+      OutputPixelArrayType result = m_Functor->Compute(value, m_Model, initialParams);
 
       return result;
     }
@@ -109,6 +135,7 @@ namespace mitk
 
     FunctorConstPointer m_Functor;
     ParameterizerConstPointer m_ModelParameterizer;
+    mutable ParameterizerType::ModelBasePointer m_Model;
   };
 
 }
@@ -73,6 +73,13 @@ public:
 
     double GetProgress() const override;
 
+    /** Number of voxels that were fitted by the last generation (only voxels inside the mask are fitted).*/
+    itkGetConstMacro(NumberOfFittedVoxels, itk::SizeValueType);
+    /** Wall clock time (in s) the fits of the last generation took.*/
+    itkGetConstMacro(FitDuration, double);
+    /** Throughput of the last generation in fitted voxels per second.*/
+    double GetFittedVoxelsPerSecond() const;
+
     ParameterNamesType GetParameterNames() const override;
 
     ParameterNamesType GetDerivedParameterNames() const override;
@@ -82,7 +89,7 @@ public:
     ParameterNamesType GetEvaluationParameterNames() const override;
 
 protected:
-  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false)
+  PixelBasedParameterFitImageGenerator() : m_Progress(0), m_TimeGridByParameterizer(false), m_NumberOfFittedVoxels(0), m_FitDuration(0)
   {
     m_InternalMask = nullptr;
     m_Mask = nullptr;
@@ -123,6 +130,9 @@ private:
     /**Indicates if the time grid defined in the parameterizer should be used (True)
     or if the filter should extract the time grid from the input image (False).*/
     bool m_TimeGridByParameterizer;
+
+    itk::SizeValueType m_NumberOfFittedVoxels;
+    double m_FitDuration;
 };
 
 }
@@ -40,6 +40,11 @@ protected:
 
     MeasureType CalcMeasure(const ParametersType &parameters, const SignalType& signal) const override;
 
+    bool ImplementsMeasureDerivative() const override;
+
+    void CalcMeasureDerivative(const ParametersType &parameters, const SignalType& signal,
+                               const ModelBase::JacobianType& signalJacobian, DerivativeType& derivative) const override;
+
     SquaredDifferencesFitCostFunction()
     {
     }
@@ -135,6 +135,11 @@ void
   //generate the fits
   fitFilter->Update();
 
+  this->m_NumberOfFittedVoxels = fitFilter->GetNumberOfProcessedVoxels();
+  this->m_FitDuration = fitFilter->GetProcessingTime();
+  MITK_DEBUG << "Parameter Fit Generator. Fitted " << this->m_NumberOfFittedVoxels << " voxels in " << this->m_FitDuration
+             << " s (" << this->GetFittedVoxelsPerSecond() << " voxels/s, " << fitFilter->GetNumberOfWorkUnits() << " work units).";
+
   //convert the outputs into mitk images and fill the parameter image map
   ModelBaseType::Pointer refModel = this->m_ModelParameterizer->GenerateParameterizedModel();
   ModelFitFunctorBase::ParameterNamesType paramNames = refModel->GetParameterNames();
@@ -214,6 +219,8 @@ void
 void mitk::PixelBasedParameterFitImageGenerator::DoFitAndGetResults(ParameterImageMapType& parameterImages, ParameterImageMapType& derivedParameterImages, ParameterImageMapType& criterionImages, ParameterImageMapType& evaluationParameterImages)
 {
   this->m_Progress = 0;
+  this->m_NumberOfFittedVoxels = 0;
+  this->m_FitDuration = 0;
 
   if(this->m_Mask.IsNotNull())
   {
@@ -239,6 +246,12 @@ double
   return m_Progress;
 };
 
+double
+  mitk::PixelBasedParameterFitImageGenerator::GetFittedVoxelsPerSecond() const
+{
+  return m_FitDuration > 0 ? static_cast<double>(m_NumberOfFittedVoxels) / m_FitDuration : 0.;
+};
+
 mitk::PixelBasedParameterFitImageGenerator::ParameterNamesType
 mitk::PixelBasedParameterFitImageGenerator::GetParameterNames() const
 {
@@ -20,7 +20,7 @@ found in the LICENSE file.
 mitk::LevenbergMarquardtModelFitFunctor::
 LevenbergMarquardtModelFitFunctor(): m_Epsilon(1e-5), m_GradientTolerance(1e-3),
   m_ValueTolerance(1e-5), m_Iterations(1000), m_DerivativeStepLength(1e-5),
-  m_ActivateFailureThreshold(true)
+  m_ActivateFailureThreshold(true), m_UseAnalyticDerivatives(true)
 {};
 
 mitk::LevenbergMarquardtModelFitFunctor::
@@ -128,6 +128,11 @@ DoModelFit(const SignalType& value, const ModelBase* model,
   ::itk::LevenbergMarquardtOptimizer::Pointer optimizer = ::itk::LevenbergMarquardtOptimizer::New();
 
   optimizer->SetCostFunction(metric);
+
+  if (m_UseAnalyticDerivatives && metric->HasAnalyticDerivative())
+  {
+    optimizer->UseCostFunctionGradientOn();
+  }
   optimizer->SetEpsilonFunction(m_Epsilon);
   optimizer->SetGradientTolerance(m_GradientTolerance);
   optimizer->SetNumberOfIterations(m_Iterations);
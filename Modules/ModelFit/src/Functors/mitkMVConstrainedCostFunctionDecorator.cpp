@@ -61,6 +61,61 @@ mitk::MVConstrainedCostFunctionDecorator::MeasureType
   return measure;
 }
 
+bool
+mitk::MVConstrainedCostFunctionDecorator::
+HasAnalyticDerivative() const
+{
+  return m_WrappedCostFunction.IsNotNull() && m_WrappedCostFunction->HasAnalyticDerivative();
+};
+
+void
+mitk::MVConstrainedCostFunctionDecorator::
+GetDerivative(const ParametersType &parameters, DerivativeType &derivative) const
+{
+  if (!this->HasAnalyticDerivative())
+  {
+    Superclass::GetDerivative(parameters, derivative);
+    return;
+  }
+
+  if (m_ConstraintChecker.IsNull()) mitkThrow()<<"Error. Cannot calc derivative. Constraint checker is not set";
+
+  PenaltyValueType penalty = m_ConstraintChecker->GetPenaltySum(parameters);
+
+  if (penalty<m_FailureThreshold || !m_ActivateFailureThreshold)
+  {
+    m_WrappedCostFunction->GetDerivative(parameters, derivative);
+  }
+  else
+  {
+    //the measure is the penalty only
+    derivative.SetSize(parameters.Size(), m_WrappedCostFunction->GetNumberOfValues());
+    derivative.Fill(0.0);
+  }
+
+  //the penalty is added to every measure value
+  const double stepLength = this->GetDerivativeStepLength();
+  for (ParametersType::SizeValueType i = 0; i < parameters.Size(); ++i)
+  {
+    ParametersType newParameters = parameters;
+    newParameters[i] -= stepLength;
+    const PenaltyValueType p0 = m_ConstraintChecker->GetPenaltySum(newParameters);
+
+    newParameters[i] = parameters[i] + stepLength;
+    const PenaltyValueType p1 = m_ConstraintChecker->GetPenaltySum(newParameters);
+
+    const double penaltyDerivative = (p1 - p0) / (2 * stepLength);
+
+    if (penaltyDerivative != 0.0)
+    {
+      for (unsigned int j = 0; j < derivative.cols(); ++j)
+      {
+        derivative[i][j] += penaltyDerivative;
+      }
+    }
+  }
+};
+
 double
 mitk::MVConstrainedCostFunctionDecorator::
 GetPenaltyRatio() const
@@ -36,6 +36,18 @@ void mitk::MVModelFitCostFunction::GetDerivative (const ParametersType &paramete
 
   derivative.SetSize(paramCount,m_Sample.Size());
 
+  if (this->HasAnalyticDerivative())
+  {
+    ModelBase::JacobianType signalJacobian;
+    SignalType signal = m_Model->GetSignalAndJacobian(parameters, signalJacobian);
+
+    if(signal.GetSize() != m_Sample.GetSize()) itkExceptionMacro("Signal size does not matche sample size!");
+    if(signal.GetSize() == 0)  itkExceptionMacro("Signal is empty!");
+
+    CalcMeasureDerivative(parameters, signal, signalJacobian, derivative);
+    return;
+  }
+
   for ( ParametersType::SizeValueType i = 0; i < paramCount; i++ )
   {
     ParametersType newParameters = parameters;
@@ -57,6 +69,22 @@ void mitk::MVModelFitCostFunction::GetDerivative (const ParametersType &paramete
 
 };
 
+bool mitk::MVModelFitCostFunction::HasAnalyticDerivative() const
+{
+  return m_Model.IsNotNull() && m_Model->HasAnalyticJacobian() && this->ImplementsMeasureDerivative();
+}
+
+bool mitk::MVModelFitCostFunction::ImplementsMeasureDerivative() const
+{
+  return false;
+}
+
+void mitk::MVModelFitCostFunction::CalcMeasureDerivative(const ParametersType &/*parameters*/,
+  const SignalType &/*signal*/, const ModelBase::JacobianType &/*signalJacobian*/, DerivativeType &/*derivative*/) const
+{
+  itkExceptionMacro("Cost function does not implement analytic derivatives of the measure.");
+}
+
 unsigned int mitk::MVModelFitCostFunction::GetNumberOfParameters() const
 {
   return m_Model->GetNumberOfParameters();
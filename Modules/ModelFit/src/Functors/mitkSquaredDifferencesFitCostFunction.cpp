@@ -24,3 +24,20 @@ mitk::SquaredDifferencesFitCostFunction::MeasureType mitk::SquaredDifferencesFit
 
   return measure;
 }
+
+bool mitk::SquaredDifferencesFitCostFunction::ImplementsMeasureDerivative() const
+{
+  return true;
+}
+
+void mitk::SquaredDifferencesFitCostFunction::CalcMeasureDerivative(const ParametersType &/*parameters*/,
+  const SignalType &signal, const ModelBase::JacobianType &signalJacobian, DerivativeType &derivative) const
+{
+  for (unsigned int p = 0; p < derivative.rows(); ++p)
+  {
+    for (SignalType::size_type i = 0; i < signal.GetSize(); ++i)
+    {
+      derivative[p][i] = -2.0 * (m_Sample[i] - signal[i]) * signalJacobian[p][i];
+    }
+  }
+}
@@ -146,6 +146,83 @@ mitk::ModelBase::ModelResultType mitk::ModelBase::GetSignal(const ParametersType
   return signal;
 }
 
+bool mitk::ModelBase::HasAnalyticJacobian() const
+{
+  return false;
+};
+
+mitk::ModelBase::ModelResultType mitk::ModelBase::GetSignalAndJacobian(const ParametersType& parameters,
+  JacobianType& jacobian) const
+{
+  if (!this->HasAnalyticJacobian())
+  {
+    itkExceptionMacro("Cannot compute Jacobian. Model does not offer analytic derivatives.");
+  }
+
+  if (parameters.size() != this->GetNumberOfParameters())
+  {
+    itkExceptionMacro("Passed parameter set has wrong size for model. Cannot evaluate model. Required size: "
+                      << this->GetNumberOfParameters() << "; passed parameters: " << parameters);
+  }
+
+  std::string error;
+
+  if (!ValidateModel(error))
+  {
+    itkExceptionMacro("Cannot evaluate model and return signal. Model is in an invalid state. Validation error: "
+                      << error);
+  }
+
+  jacobian.SetSize(this->GetNumberOfParameters(), this->m_TimeGrid.GetSize());
+
+  return ComputeModelfunctionAndJacobian(parameters, jacobian);
+}
+
+void mitk::ModelBase::GetSignalBatch(const ParameterValueType* parameters, std::size_t numberOfParameterSets,
+  SignalValueType* signals) const
+{
+  std::string error;
+
+  if (!ValidateModel(error))
+  {
+    itkExceptionMacro("Cannot evaluate model and return signal. Model is in an invalid state. Validation error: "
+                      << error);
+  }
+
+  if (numberOfParameterSets > 0)
+  {
+    ComputeModelfunctionBatch(parameters, numberOfParameterSets, signals);
+  }
+}
+
+mitk::ModelBase::ModelResultType mitk::ModelBase::ComputeModelfunctionAndJacobian(
+  const ParametersType& /*parameters*/, JacobianType& /*jacobian*/) const
+{
+  itkExceptionMacro("Model does not implement analytic derivatives.");
+}
+
+void mitk::ModelBase::ComputeModelfunctionBatch(const ParameterValueType* parameters,
+  std::size_t numberOfParameterSets, SignalValueType* signals) const
+{
+  const ParametersSizeType numberOfParameters = this->GetNumberOfParameters();
+  ParametersType setParameters(numberOfParameters);
+
+  for (std::size_t set = 0; set < numberOfParameterSets; ++set)
+  {
+    for (ParametersSizeType i = 0; i < numberOfParameters; ++i)
+    {
+      setParameters[i] = parameters[i * numberOfParameterSets + set];
+    }
+
+    const ModelResultType signal = ComputeModelfunction(setParameters);
+
+    for (ModelResultType::SizeValueType t = 0; t < signal.GetSize(); ++t)
+    {
+      signals[t * numberOfParameterSets + set] = signal[t];
+    }
+  }
+}
+
 bool mitk::ModelBase::ValidateModel(std::string& /*error*/) const
 {
   return true;
@@ -113,6 +113,8 @@ int itkMultiOutputNaryFunctorImageFilterTest(int  /*argc*/, char*[] /*argv[]*/)
 
   testFilter->Update();
 
+  CPPUNIT_ASSERT_MESSAGE("Check number of processed voxels (functor #1)", 9 == testFilter->GetNumberOfProcessedVoxels());
+
   mitk::TestImageType::Pointer out1 = testFilter->GetOutput(0);
   mitk::TestImageType::Pointer out2 = testFilter->GetOutput(1);
   mitk::TestImageType::Pointer out3 = testFilter->GetOutput(2);
@@ -185,6 +187,8 @@ int itkMultiOutputNaryFunctorImageFilterTest(int  /*argc*/, char*[] /*argv[]*/)
 
   testFilter->Update();
 
+  CPPUNIT_ASSERT_MESSAGE("Check number of processed voxels (masked, functor #2)", 3 == testFilter->GetNumberOfProcessedVoxels());
+
   out1 = testFilter->GetOutput(0);
   out2 = testFilter->GetOutput(1);
   out3 = testFilter->GetOutput(2);
@@ -214,5 +218,23 @@ int itkMultiOutputNaryFunctorImageFilterTest(int  /*argc*/, char*[] /*argv[]*/)
   CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #4 index #4 (functor #2)",0 == out4->GetPixel(testIndex4));
   CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #4 index #5 (functor #2)",0 == out4->GetPixel(testIndex5));
 
+  //Test that the chunk size and the number of work units do not change the result
+  testFilter->SetChunkSize(1);
+  testFilter->SetNumberOfWorkUnits(8);
+  testFilter->Modified();
+
+  testFilter->Update();
+
+  out1 = testFilter->GetOutput(0);
+  out2 = testFilter->GetOutput(1);
+
+  CPPUNIT_ASSERT_MESSAGE("Check number of processed voxels (masked, chunk size 1)", 3 == testFilter->GetNumberOfProcessedVoxels());
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #1 (chunk size 1)",0 == out1->GetPixel(testIndex1));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #2 (chunk size 1)",333 == out1->GetPixel(testIndex2));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #3 (chunk size 1)",444 == out1->GetPixel(testIndex3));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #1 index #5 (chunk size 1)",0 == out1->GetPixel(testIndex5));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #2 index #2 (chunk size 1)",30 == out2->GetPixel(testIndex2));
+  CPPUNIT_ASSERT_MESSAGE("Check pixel of masked output #2 index #3 (chunk size 1)",40 == out2->GetPixel(testIndex3));
+
   MITK_TEST_END()
 }
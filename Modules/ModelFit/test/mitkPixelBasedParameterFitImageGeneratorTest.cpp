@@ -77,6 +77,9 @@ int mitkPixelBasedParameterFitImageGeneratorTest(int  /*argc*/, char*[] /*argv[]
 
     generator->Generate();
 
+    CPPUNIT_ASSERT_MESSAGE("Check number of fitted voxels", 27 == generator->GetNumberOfFittedVoxels());
+    MITK_TEST_CONDITION(generator->GetFitDuration() >= 0, "Check fit duration.");
+
     mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType resultImages = generator->GetParameterImages();
     mitk::PixelBasedParameterFitImageGenerator::ParameterImageMapType derivedResultImages = generator->GetDerivedParameterImages();
 
@@ -113,6 +116,8 @@ int mitkPixelBasedParameterFitImageGeneratorTest(int  /*argc*/, char*[] /*argv[]
 
     generator->Generate();
 
+    CPPUNIT_ASSERT_MESSAGE("Check number of fitted voxels (masked)", 14 == generator->GetNumberOfFittedVoxels());
+
     resultImages = generator->GetParameterImages();
     derivedResultImages = generator->GetDerivedParameterImages();
 
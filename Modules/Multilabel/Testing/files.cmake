@@ -4,6 +4,7 @@ set(MODULE_TESTS
     mitkLabelSetImageTest.cpp
     mitkLabelSetImageIOTest.cpp
     mitkLabelSetImageSurfaceStampFilterTest.cpp
+    mitkSparseLabelVolumeTest.cpp
     mitkTransferLabelTest.cpp
 )
 
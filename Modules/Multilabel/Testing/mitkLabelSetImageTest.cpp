@@ -11,6 +11,8 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include <mitkIOUtil.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
 #include <mitkImageStatisticsHolder.h>
 #include <mitkLabelSetImage.h>
 #include <mitkTestFixture.h>
@@ -34,6 +36,7 @@ class mitkLabelSetImageTestSuite : public mitk::TestFixture
   MITK_TEST(TestExistsLabelSet);
   MITK_TEST(TestSetActiveLayer);
   MITK_TEST(TestRemoveLayer);
+  MITK_TEST(TestLayerStorage);
   MITK_TEST(TestRemoveLabels);
   MITK_TEST(TestEraseLabels);
   MITK_TEST(TestMergeLabels);
@@ -383,6 +386,83 @@ public:
                            m_LabelSetImage->GetActiveLabelSet() == nullptr);
   }
 
+  void TestLayerStorage()
+  {
+    typedef itk::Index<3> IndexType;
+
+    // Layer 0 contains a small label in one corner
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      for (unsigned int z = 0; z < 4; ++z)
+        for (unsigned int y = 0; y < 4; ++y)
+          for (unsigned int x = 0; x < 4; ++x)
+            accessor.SetPixelByIndex({ { x, y, z } }, 1);
+    }
+
+    auto layerID = m_LabelSetImage->AddLayer();
+    CPPUNIT_ASSERT_MESSAGE("Active layer should not have a layer storage", nullptr == m_LabelSetImage->GetLayerStorage(layerID));
+    CPPUNIT_ASSERT_MESSAGE("New layer should be empty",
+                           0 == mitk::ImagePixelReadAccessor<mitk::Label::PixelType, 3>(m_LabelSetImage).GetPixelByIndex(IndexType({ { 1, 1, 1 } })));
+
+    // Only the brick of the label is allocated for the inactive layer
+    const auto *layerStorage = m_LabelSetImage->GetLayerStorage(0);
+    CPPUNIT_ASSERT_MESSAGE("Inactive layer should have a layer storage", nullptr != layerStorage);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Only one brick of the inactive layer should be allocated", std::size_t(1), layerStorage->GetNumberOfAllocatedBricks());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Layer storage has wrong value", mitk::Label::PixelType(1), layerStorage->GetPixel(3, 3, 3));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Layer storage has wrong value", mitk::Label::PixelType(0), layerStorage->GetPixel(4, 3, 3));
+
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      accessor.SetPixelByIndex({ { 50, 60, 20 } }, 2);
+    }
+
+    // The dense layer image of an inactive layer contains its label values, changes are kept on activation
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage->GetLayerImage(0));
+      CPPUNIT_ASSERT_MESSAGE("Layer image has wrong value", 1 == accessor.GetPixelByIndex(IndexType({ { 2, 2, 2 } })));
+      CPPUNIT_ASSERT_MESSAGE("Layer image has wrong value", 0 == accessor.GetPixelByIndex(IndexType({ { 50, 60, 20 } })));
+      accessor.SetPixelByIndex({ { 90, 120, 50 } }, 3);
+    }
+    CPPUNIT_ASSERT_MESSAGE("Layer image of the active layer should be the image",
+                           m_LabelSetImage->GetLayerImage(layerID) == m_LabelSetImage.GetPointer());
+
+    m_LabelSetImage->SetActiveLayer(0);
+    {
+      mitk::ImagePixelReadAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage);
+      CPPUNIT_ASSERT_MESSAGE("Activated layer has wrong value", 1 == accessor.GetPixelByIndex(IndexType({ { 3, 0, 1 } })));
+      CPPUNIT_ASSERT_MESSAGE("Activated layer has wrong value", 0 == accessor.GetPixelByIndex(IndexType({ { 50, 60, 20 } })));
+      CPPUNIT_ASSERT_MESSAGE("Change of the layer image was lost", 3 == accessor.GetPixelByIndex(IndexType({ { 90, 120, 50 } })));
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Layer storage has wrong value", mitk::Label::PixelType(2), m_LabelSetImage->GetLayerStorage(layerID)->GetPixel(50, 60, 20));
+    CPPUNIT_ASSERT_MESSAGE("Activated layer should not have a layer image", !m_LabelSetImage->HasLayerImage(0));
+
+    // Releasing an unmodified dense layer image keeps the layer storage
+    const auto *unchangedLayerStorage = m_LabelSetImage->GetLayerStorage(layerID);
+    m_LabelSetImage->GetLayerImage(layerID);
+    m_LabelSetImage->ReleaseLayerImage(layerID);
+    CPPUNIT_ASSERT_MESSAGE("Unmodified layer image should not rebuild the layer storage",
+                           unchangedLayerStorage == m_LabelSetImage->GetLayerStorage(layerID));
+
+    // Releasing the modified dense layer image moves its changes into the layer storage
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Label::PixelType, 3> accessor(m_LabelSetImage->GetLayerImage(layerID));
+      accessor.SetPixelByIndex({ { 10, 10, 10 } }, 4);
+    }
+    m_LabelSetImage->GetLayerImage(layerID)->Modified();
+    CPPUNIT_ASSERT_MESSAGE("Inactive layer should have a layer image", m_LabelSetImage->HasLayerImage(layerID));
+    m_LabelSetImage->ReleaseLayerImage(layerID);
+    CPPUNIT_ASSERT_MESSAGE("Layer image should be released", !m_LabelSetImage->HasLayerImage(layerID));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Change of the released layer image was lost", mitk::Label::PixelType(4), m_LabelSetImage->GetLayerStorage(layerID)->GetPixel(10, 10, 10));
+
+    // Clones keep all layers
+    auto clone = m_LabelSetImage->Clone();
+    clone->SetActiveLayer(layerID);
+    CPPUNIT_ASSERT_MESSAGE("Cloned layer has wrong value",
+                           2 == mitk::ImagePixelReadAccessor<mitk::Label::PixelType, 3>(clone).GetPixelByIndex(IndexType({ { 50, 60, 20 } })));
+    CPPUNIT_ASSERT_MESSAGE("Cloned layer image has wrong value",
+                           3 == mitk::ImagePixelReadAccessor<mitk::Label::PixelType, 3>(clone->GetLayerImage(0)).GetPixelByIndex(IndexType({ { 90, 120, 50 } })));
+  }
+
   void TestRemoveLabels()
   {
     mitk::Image::Pointer image =
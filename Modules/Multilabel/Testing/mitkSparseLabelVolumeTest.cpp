@@ -0,0 +1,142 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkSparseLabelVolume.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <algorithm>
+#include <random>
+
+class mitkSparseLabelVolumeTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSparseLabelVolumeTestSuite);
+  MITK_TEST(TestEmptyVolume);
+  MITK_TEST(TestBufferRoundTrip);
+  MITK_TEST(TestSetPixel);
+  MITK_TEST(TestCopy);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::SparseLabelVolume::PixelType PixelType;
+
+  /** Dense volume (x, y, z, t) with two labelled boxes, so most bricks are uniform.*/
+  static std::vector<PixelType> CreateBuffer(const mitk::SparseLabelVolume::SizeType &size)
+  {
+    std::vector<PixelType> buffer(std::size_t(size[0]) * size[1] * size[2] * size[3], 0);
+    std::size_t i = 0;
+
+    for (unsigned int t = 0; t < size[3]; ++t)
+      for (unsigned int z = 0; z < size[2]; ++z)
+        for (unsigned int y = 0; y < size[1]; ++y)
+          for (unsigned int x = 0; x < size[0]; ++x, ++i)
+          {
+            if (x >= 10 && x < 20 && y >= 5 && y < 40 && z < 3)
+              buffer[i] = static_cast<PixelType>(1 + t);
+            else if (x >= 70 && y >= 64 && z >= 32)
+              buffer[i] = 7;
+          }
+
+    return buffer;
+  }
+
+public:
+  void TestEmptyVolume()
+  {
+    mitk::SparseLabelVolume volume({ { 100, 70, 40, 2 } }, 5);
+
+    // 4 x 3 x 2 bricks per time step
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of bricks", std::size_t(48), volume.GetNumberOfBricks());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Uniform volume should not allocate bricks", std::size_t(0), volume.GetNumberOfAllocatedBricks());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Uniform volume should not allocate memory", std::size_t(0), volume.GetAllocatedMemorySize());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong value", PixelType(5), volume.GetPixel(99, 69, 39, 1));
+
+    std::vector<PixelType> buffer(volume.GetNumberOfPixels(), 0);
+    volume.GetBuffer(buffer.data());
+    CPPUNIT_ASSERT_MESSAGE("Dense buffer should contain the value",
+                           std::all_of(buffer.begin(), buffer.end(), [](PixelType value) { return 5 == value; }));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE("Index outside of the volume should throw", volume.GetPixel(100, 0, 0, 0), mitk::Exception);
+  }
+
+  void TestBufferRoundTrip()
+  {
+    const mitk::SparseLabelVolume::SizeType size = { { 100, 70, 40, 2 } };
+    const auto buffer = CreateBuffer(size);
+
+    mitk::SparseLabelVolume volume(size);
+    volume.SetBuffer(buffer.data());
+
+    // Per time step, the first box is split over two bricks and the second box covers one brick partially
+    // and one completely (which stays uniform)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Only bricks with label borders should be allocated", std::size_t(2 * (2 + 1)), volume.GetNumberOfAllocatedBricks());
+    CPPUNIT_ASSERT_MESSAGE("Sparse volume should need less memory than the dense buffer",
+                           volume.GetAllocatedMemorySize() < buffer.size() * sizeof(PixelType) / 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong value", PixelType(2), volume.GetPixel(15, 39, 2, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong value", PixelType(7), volume.GetPixel(99, 69, 39, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong value", PixelType(7), volume.GetPixel(70, 64, 32, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong value", PixelType(0), volume.GetPixel(69, 64, 32, 1));
+
+    std::vector<PixelType> result(buffer.size(), 42);
+    volume.GetBuffer(result.data());
+    CPPUNIT_ASSERT_MESSAGE("Dense buffer should be restored", buffer == result);
+
+    volume.Fill(0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Filled volume should not allocate bricks", std::size_t(0), volume.GetNumberOfAllocatedBricks());
+  }
+
+  void TestSetPixel()
+  {
+    const mitk::SparseLabelVolume::SizeType size = { { 45, 33, 35, 1 } };
+    std::vector<PixelType> buffer(std::size_t(size[0]) * size[1] * size[2], 0);
+    mitk::SparseLabelVolume volume(size);
+
+    std::mt19937 generator(42);
+    for (int i = 0; i < 500; ++i)
+    {
+      const unsigned int x = generator() % size[0];
+      const unsigned int y = generator() % size[1];
+      const unsigned int z = generator() % size[2];
+      const auto value = static_cast<PixelType>(generator() % 4);
+
+      volume.SetPixel(x, y, z, 0, value);
+      buffer[x + size[0] * (y + std::size_t(size[1]) * z)] = value;
+    }
+
+    std::vector<PixelType> result(buffer.size());
+    volume.GetBuffer(result.data());
+    CPPUNIT_ASSERT_MESSAGE("Dense buffer should contain all set pixels", buffer == result);
+
+    volume.SetBuffer(buffer.data());
+    volume.GetBuffer(result.data());
+    CPPUNIT_ASSERT_MESSAGE("Dense buffer should be restored", buffer == result);
+  }
+
+  void TestCopy()
+  {
+    const mitk::SparseLabelVolume::SizeType size = { { 100, 70, 40, 1 } };
+    const auto buffer = CreateBuffer(size);
+
+    mitk::SparseLabelVolume volume(size);
+    volume.SetBuffer(buffer.data());
+
+    mitk::SparseLabelVolume copy(volume);
+    volume.SetPixel(15, 10, 1, 0, 9);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Copy should not share bricks", PixelType(1), copy.GetPixel(15, 10, 1, 0));
+
+    std::vector<PixelType> result(buffer.size());
+    copy.GetBuffer(result.data());
+    CPPUNIT_ASSERT_MESSAGE("Copy should contain the original values", buffer == result);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSparseLabelVolume)
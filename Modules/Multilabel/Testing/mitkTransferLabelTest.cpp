@@ -24,6 +24,7 @@ class mitkTransferLabelTestSuite : public mitk::TestFixture
   MITK_TEST(TestTransfer_Replace_RegardLocks);
   MITK_TEST(TestTransfer_Replace_IgnoreLocks);
   MITK_TEST(TestTransfer_multipleLabels);
+  MITK_TEST(TestTransfer_multipleLabels_equalsSequentialTransfers);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -137,6 +138,27 @@ public:
       mitk::Equal(*(destinationLockedExteriorImage.GetPointer()), *(refLockedExteriorImage.GetPointer()), mitk::eps, false));
   }
 
+  void TestTransfer_multipleLabels_equalsSequentialTransfers()
+  {
+    const std::vector<std::pair<mitk::Label::PixelType, mitk::Label::PixelType>> labelMapping = { {1,1}, {3,1}, {2,4}, {4,2} };
+
+    for (auto mergeStyle : { mitk::MultiLabelSegmentation::MergeStyle::Replace, mitk::MultiLabelSegmentation::MergeStyle::Merge })
+    {
+      for (auto overwriteStyle : { mitk::MultiLabelSegmentation::OverwriteStyle::RegardLocks, mitk::MultiLabelSegmentation::OverwriteStyle::IgnoreLocks })
+      {
+        auto batchedImage = mitk::IOUtil::Load<mitk::LabelSetImage>(GetTestDataFilePath("Multilabel/LabelTransferTest_destination.nrrd"));
+        auto sequentialImage = mitk::IOUtil::Load<mitk::LabelSetImage>(GetTestDataFilePath("Multilabel/LabelTransferTest_destination.nrrd"));
+
+        mitk::TransferLabelContent(m_SourceImage, batchedImage, labelMapping, mergeStyle, overwriteStyle);
+
+        for (const auto& mappingElement : labelMapping)
+          mitk::TransferLabelContent(m_SourceImage, sequentialImage, { mappingElement }, mergeStyle, overwriteStyle);
+
+        CPPUNIT_ASSERT_MESSAGE("Transfer of multiple labels in a single pass differs from transferring them one after another",
+          mitk::Equal(*(batchedImage.GetPointer()), *(sequentialImage.GetPointer()), mitk::eps, false));
+      }
+    }
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkTransferLabel)
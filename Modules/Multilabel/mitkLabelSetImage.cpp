@@ -16,6 +16,8 @@ found in the LICENSE file.
 #include "mitkImageCast.h"
 #include "mitkImagePixelReadAccessor.h"
 #include "mitkImagePixelWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
 #include "mitkInteractionConst.h"
 #include "mitkLookupTableProperty.h"
 #include "mitkPadImageFilter.h"
@@ -33,9 +35,54 @@ found in the LICENSE file.
 //#include <itkRelabelComponentImageFilter.h>
 
 #include <itkCommand.h>
+#include <itkMultiThreaderBase.h>
 
-#include <itkBinaryFunctorImageFilter.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
+namespace
+{
+  constexpr std::size_t NumberOfLabelValues = static_cast<std::size_t>(std::numeric_limits<mitk::Label::PixelType>::max()) + 1;
+
+  /** Number of pixels processed by a single work unit of the label kernels. */
+  constexpr itk::SizeValueType LabelKernelChunkSize = 1 << 16;
+
+  /** Calls function(begin, end) for consecutive chunks of [0, numberOfPixels) on the ITK thread pool. */
+  template <typename TFunction>
+  void ParallelizeOverPixels(itk::SizeValueType numberOfPixels, const TFunction &function)
+  {
+    const itk::SizeValueType numberOfChunks = (numberOfPixels + LabelKernelChunkSize - 1) / LabelKernelChunkSize;
+
+    itk::MultiThreaderBase::New()->ParallelizeArray(0, numberOfChunks, [&](itk::SizeValueType chunk)
+    {
+      const auto begin = chunk * LabelKernelChunkSize;
+      function(begin, std::min(begin + LabelKernelChunkSize, numberOfPixels));
+    }, nullptr);
+  }
+
+  std::vector<mitk::Label::PixelType> CreateIdentityLookupTable()
+  {
+    std::vector<mitk::Label::PixelType> lookupTable(NumberOfLabelValues);
+
+    for (std::size_t i = 0; i < NumberOfLabelValues; ++i)
+      lookupTable[i] = static_cast<mitk::Label::PixelType>(i);
+
+    return lookupTable;
+  }
+
+  /** Changes all entries of the lookup table that currently result in oldValue to newValue.
+   * Consecutive calls therefore compose like consecutive passes over the image. */
+  void RemapLookupTable(std::vector<mitk::Label::PixelType> &lookupTable, mitk::Label::PixelType oldValue, mitk::Label::PixelType newValue)
+  {
+    for (auto &value : lookupTable)
+    {
+      if (oldValue == value)
+        value = newValue;
+    }
+  }
+}
 
 template <typename TPixel, unsigned int VDimensions>
 void SetToZero(itk::Image<TPixel, VDimensions> *source)
@@ -96,9 +143,27 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
     lsClone->AddObserver(itk::ModifiedEvent(), command);
     m_LabelSetContainer.push_back(lsClone);
 
-    // clone layer Image data
-    mitk::Image::Pointer liClone = other.GetLayerImage(i)->Clone();
-    m_LayerContainer.push_back(liClone);
+    // clone layer data, the active layer is part of the cloned image buffer
+    if (i == other.GetActiveLayer())
+    {
+      m_LayerContainer.push_back(nullptr);
+    }
+    else
+    {
+      // a modified dense layer image (see GetLayerImage()) takes precedence over the layer storage
+      std::lock_guard<std::mutex> guard(other.m_LayerImageMutex);
+      const auto &otherLayerImage = other.m_LayerImageContainer[i];
+      if (otherLayerImage.IsNotNull() && otherLayerImage->GetMTime() != other.m_LayerImageMTimes[i])
+      {
+        m_LayerContainer.push_back(this->CreateLayerStorage(otherLayerImage));
+      }
+      else
+      {
+        m_LayerContainer.push_back(std::make_unique<SparseLabelVolume>(*other.m_LayerContainer[i]));
+      }
+    }
+    m_LayerImageContainer.push_back(nullptr);
+    m_LayerImageMTimes.push_back(0);
   }
 
   // Add some DICOM Tags as properties to segmentation image
@@ -168,12 +233,108 @@ mitk::LabelSetImage::~LabelSetImage()
 
 mitk::Image *mitk::LabelSetImage::GetLayerImage(unsigned int layer)
 {
-  return m_LayerContainer[layer];
+  if (layer == this->GetActiveLayer())
+    return this;
+
+  return const_cast<mitk::Image *>(static_cast<const LabelSetImage *>(this)->GetLayerImage(layer));
 }
 
 const mitk::Image *mitk::LabelSetImage::GetLayerImage(unsigned int layer) const
 {
-  return m_LayerContainer[layer];
+  if (layer == this->GetActiveLayer())
+    return this;
+
+  std::lock_guard<std::mutex> guard(m_LayerImageMutex);
+  auto &layerImage = m_LayerImageContainer[layer];
+
+  if (layerImage.IsNull())
+  {
+    layerImage = this->CreateLayerImage();
+
+    if (4 == layerImage->GetDimension())
+    {
+      AccessFixedDimensionByItk_n(layerImage, LayerContainerToImageProcessing, 4, (m_LayerContainer[layer].get()));
+    }
+    else
+    {
+      AccessByItk_1(layerImage, LayerContainerToImageProcessing, m_LayerContainer[layer].get());
+    }
+
+    m_LayerImageMTimes[layer] = layerImage->GetMTime();
+  }
+
+  return layerImage;
+}
+
+const mitk::SparseLabelVolume *mitk::LabelSetImage::GetLayerStorage(unsigned int layer) const
+{
+  return m_LayerContainer[layer].get();
+}
+
+bool mitk::LabelSetImage::HasLayerImage(unsigned int layer) const
+{
+  std::lock_guard<std::mutex> guard(m_LayerImageMutex);
+  return layer < m_LayerImageContainer.size() && m_LayerImageContainer[layer].IsNotNull();
+}
+
+void mitk::LabelSetImage::ReleaseLayerImage(unsigned int layer)
+{
+  std::lock_guard<std::mutex> guard(m_LayerImageMutex);
+  if (layer >= m_LayerImageContainer.size() || m_LayerImageContainer[layer].IsNull())
+    return;
+
+  // an unmodified image still equals the layer storage and is just dropped
+  if (m_LayerImageContainer[layer]->GetMTime() != m_LayerImageMTimes[layer])
+  {
+    m_LayerContainer[layer] = this->CreateLayerStorage(m_LayerImageContainer[layer]);
+  }
+  m_LayerImageContainer[layer] = nullptr;
+}
+
+void mitk::LabelSetImage::ReleaseLayerImages()
+{
+  for (unsigned int layer = 0; layer < m_LayerImageContainer.size(); ++layer)
+  {
+    this->ReleaseLayerImage(layer);
+  }
+}
+
+mitk::SparseLabelVolume::SizeType mitk::LabelSetImage::GetLayerStorageSize() const
+{
+  SparseLabelVolume::SizeType size = { { 1, 1, 1, 1 } };
+
+  for (unsigned int dim = 0; dim < std::min(this->GetDimension(), 4u); ++dim)
+    size[dim] = this->GetDimension(dim);
+
+  return size;
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::CreateLayerImage() const
+{
+  mitk::Image::Pointer layerImage = mitk::Image::New();
+  layerImage->Initialize(this->GetPixelType(),
+                         this->GetDimension(),
+                         this->GetDimensions(),
+                         this->GetImageDescriptor()->GetNumberOfChannels());
+  layerImage->SetTimeGeometry(this->GetTimeGeometry()->Clone());
+
+  return layerImage;
+}
+
+std::unique_ptr<mitk::SparseLabelVolume> mitk::LabelSetImage::CreateLayerStorage(const mitk::Image *image) const
+{
+  auto layerStorage = std::make_unique<SparseLabelVolume>(this->GetLayerStorageSize());
+
+  if (4 == image->GetDimension())
+  {
+    AccessFixedDimensionByItk_n(image, ImageToLayerContainerProcessing, 4, (layerStorage.get()));
+  }
+  else
+  {
+    AccessByItk_1(image, ImageToLayerContainerProcessing, layerStorage.get());
+  }
+
+  return layerStorage;
 }
 
 unsigned int mitk::LabelSetImage::GetActiveLayer() const
@@ -192,20 +353,23 @@ void mitk::LabelSetImage::RemoveLayer()
   // remove all observers from active label set
   GetLabelSet(layerToDelete)->RemoveAllObservers();
 
+  // we are deleting the active layer, it should not be copied back into the vector
+  m_activeLayerInvalid = true;
+
   // set the active layer to one below, if exists.
   if (layerToDelete != 0)
   {
     SetActiveLayer(layerToDelete - 1);
   }
-  else
-  {
-    // we are deleting layer zero, it should not be copied back into the vector
-    m_activeLayerInvalid = true;
-  }
 
   // remove labelset and image data
   m_LabelSetContainer.erase(m_LabelSetContainer.begin() + layerToDelete);
   m_LayerContainer.erase(m_LayerContainer.begin() + layerToDelete);
+  {
+    std::lock_guard<std::mutex> guard(m_LayerImageMutex);
+    m_LayerImageContainer.erase(m_LayerImageContainer.begin() + layerToDelete);
+    m_LayerImageMTimes.erase(m_LayerImageMTimes.begin() + layerToDelete);
+  }
 
   if (layerToDelete == 0)
   {
@@ -217,28 +381,16 @@ void mitk::LabelSetImage::RemoveLayer()
 
 unsigned int mitk::LabelSetImage::AddLayer(mitk::LabelSet::Pointer labelSet)
 {
-  mitk::Image::Pointer newImage = mitk::Image::New();
-  newImage->Initialize(this->GetPixelType(),
-                       this->GetDimension(),
-                       this->GetDimensions(),
-                       this->GetImageDescriptor()->GetNumberOfChannels());
-  newImage->SetTimeGeometry(this->GetTimeGeometry()->Clone());
-
-  if (newImage->GetDimension() < 4)
-  {
-    AccessByItk(newImage, SetToZero);
-  }
-  else
-  {
-    AccessFixedDimensionByItk(newImage, SetToZero, 4);
-  }
-
-  unsigned int newLabelSetId = this->AddLayer(newImage, labelSet);
-
-  return newLabelSetId;
+  // an empty layer does not allocate any bricks
+  return this->AddLayerStorage(std::make_unique<SparseLabelVolume>(this->GetLayerStorageSize()), labelSet);
 }
 
 unsigned int mitk::LabelSetImage::AddLayer(mitk::Image::Pointer layerImage, mitk::LabelSet::Pointer labelSet)
+{
+  return this->AddLayerStorage(this->CreateLayerStorage(layerImage), labelSet);
+}
+
+unsigned int mitk::LabelSetImage::AddLayerStorage(std::unique_ptr<SparseLabelVolume> layerStorage, mitk::LabelSet::Pointer labelSet)
 {
   unsigned int newLabelSetId = m_LayerContainer.size();
 
@@ -259,8 +411,13 @@ unsigned int mitk::LabelSetImage::AddLayer(mitk::Image::Pointer layerImage, mitk
   // Add exterior Label to label set
   // mitk::Label::Pointer exteriorLabel = CreateExteriorLabel();
 
-  // push a new working image for the new layer
-  m_LayerContainer.push_back(layerImage);
+  // push the label values of the new layer
+  m_LayerContainer.push_back(std::move(layerStorage));
+  {
+    std::lock_guard<std::mutex> guard(m_LayerImageMutex);
+    m_LayerImageContainer.push_back(nullptr);
+    m_LayerImageMTimes.push_back(0);
+  }
 
   // push a new labelset for the new layer
   m_LabelSetContainer.push_back(ls);
@@ -270,7 +427,16 @@ unsigned int mitk::LabelSetImage::AddLayer(mitk::Image::Pointer layerImage, mitk
   command->SetCallbackFunction(this, &mitk::LabelSetImage::OnLabelSetModified);
   ls->AddObserver(itk::ModifiedEvent(), command);
 
-  SetActiveLayer(newLabelSetId);
+  if (newLabelSetId == this->GetActiveLayer() && !m_activeLayerInvalid)
+  {
+    // the first layer is already active, its label values are moved into the image buffer
+    this->WriteLayerStorageToImage(m_LayerContainer[newLabelSetId].get());
+    m_LayerContainer[newLabelSetId].reset();
+  }
+  else
+  {
+    SetActiveLayer(newLabelSetId);
+  }
   // MITK_INFO << GetActiveLayer();
   this->Modified();
   return newLabelSetId;
@@ -305,47 +471,48 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
 {
   try
   {
-    if (4 == this->GetDimension())
+    if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
     {
-      if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
+      BeforeChangeLayerEvent.Send();
+
+      if (m_activeLayerInvalid)
+      {
+        // We should not write the invalid layer back to the vector
+        m_activeLayerInvalid = false;
+      }
+      else
       {
-        BeforeChangeLayerEvent.Send();
+        m_LayerContainer[GetActiveLayer()] = this->CreateLayerStorage(this);
+      }
 
-        if (m_activeLayerInvalid)
-        {
-          // We should not write the invalid layer back to the vector
-          m_activeLayerInvalid = false;
-        }
-        else
-        {
-          AccessFixedDimensionByItk_n(this, ImageToLayerContainerProcessing, 4, (GetActiveLayer()));
-        }
-        m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
-        AccessFixedDimensionByItk_n(this, LayerContainerToImageProcessing, 4, (GetActiveLayer()));
+      // The label values of the new active layer are only kept in the image buffer. The sparse storage is moved
+      // out of the container (no copy), a dense layer image (see GetLayerImage()) takes precedence.
+      std::unique_ptr<SparseLabelVolume> layerStorage;
+      layerStorage.swap(m_LayerContainer[layer]);
+      mitk::Image::Pointer layerImage;
+      {
+        std::lock_guard<std::mutex> guard(m_LayerImageMutex);
+        layerImage.Swap(m_LayerImageContainer[layer]);
+      }
+
+      m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
 
-        AfterChangeLayerEvent.Send();
+      if (layerImage.IsNotNull())
+      {
+        mitk::ImageReadAccessor source(layerImage);
+        mitk::ImageWriteAccessor target(this);
+        const auto size = this->GetLayerStorageSize();
+        std::memcpy(target.GetData(), source.GetData(), std::size_t(size[0]) * size[1] * size[2] * size[3] * this->GetPixelType().GetSize());
       }
-    }
-    else
-    {
-      if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
+      else
       {
-        BeforeChangeLayerEvent.Send();
+        this->WriteLayerStorageToImage(layerStorage.get());
+      }
 
-        if (m_activeLayerInvalid)
-        {
-          // We should not write the invalid layer back to the vector
-          m_activeLayerInvalid = false;
-        }
-        else
-        {
-          AccessByItk_1(this, ImageToLayerContainerProcessing, GetActiveLayer());
-        }
-        m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
-        AccessByItk_1(this, LayerContainerToImageProcessing, GetActiveLayer());
+      // dense images of the other inactive layers are not kept across layer switches
+      this->ReleaseLayerImages();
 
-        AfterChangeLayerEvent.Send();
-      }
+      AfterChangeLayerEvent.Send();
     }
   }
   catch (itk::ExceptionObject &e)
@@ -355,6 +522,18 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
   this->Modified();
 }
 
+void mitk::LabelSetImage::WriteLayerStorageToImage(const SparseLabelVolume *layerStorage)
+{
+  if (4 == this->GetDimension())
+  {
+    AccessFixedDimensionByItk_n(this, LayerContainerToImageProcessing, 4, (layerStorage));
+  }
+  else
+  {
+    AccessByItk_1(this, LayerContainerToImageProcessing, layerStorage);
+  }
+}
+
 void mitk::LabelSetImage::ClearBuffer()
 {
   try
@@ -399,75 +578,74 @@ bool mitk::LabelSetImage::ExistLabelSet(unsigned int layer) const
 
 void mitk::LabelSetImage::MergeLabel(PixelType pixelValue, PixelType sourcePixelValue, unsigned int layer)
 {
-  try
-  {
-    AccessByItk_2(this, MergeLabelProcessing, pixelValue, sourcePixelValue);
-  }
-  catch (itk::ExceptionObject &e)
-  {
-    mitkThrow() << e.GetDescription();
-  }
-  GetLabelSet(layer)->SetActiveLabel(pixelValue);
-  Modified();
+  std::vector<PixelType> vectorOfSourcePixelValues = { sourcePixelValue };
+  this->MergeLabels(pixelValue, vectorOfSourcePixelValues, layer);
 }
 
 void mitk::LabelSetImage::MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer)
 {
-  try
-  {
-    for (unsigned int idx = 0; idx < vectorOfSourcePixelValues.size(); idx++)
-    {
-      AccessByItk_2(this, MergeLabelProcessing, pixelValue, vectorOfSourcePixelValues[idx]);
-    }
-  }
-  catch (itk::ExceptionObject &e)
-  {
-    mitkThrow() << e.GetDescription();
-  }
+  auto lookupTable = CreateIdentityLookupTable();
+
+  for (const auto sourcePixelValue : vectorOfSourcePixelValues)
+    RemapLookupTable(lookupTable, sourcePixelValue, pixelValue);
+
+  this->RemapLabels(lookupTable);
+
   GetLabelSet(layer)->SetActiveLabel(pixelValue);
   Modified();
 }
 
 void mitk::LabelSetImage::RemoveLabel(PixelType pixelValue, unsigned int layer)
 {
-  this->GetLabelSet(layer)->RemoveLabel(pixelValue);
-  this->EraseLabel(pixelValue);
+  std::vector<PixelType> vectorOfLabelPixelValues = { pixelValue };
+  this->RemoveLabels(vectorOfLabelPixelValues, layer);
 }
 
 void mitk::LabelSetImage::RemoveLabels(std::vector<PixelType>& VectorOfLabelPixelValues, unsigned int layer)
 {
-  for (unsigned int idx = 0; idx < VectorOfLabelPixelValues.size(); idx++)
-  {
-    this->RemoveLabel(VectorOfLabelPixelValues[idx], layer);
-  }
+  for (const auto pixelValue : VectorOfLabelPixelValues)
+    this->GetLabelSet(layer)->RemoveLabel(pixelValue);
+
+  this->EraseLabels(VectorOfLabelPixelValues);
 }
 
 void mitk::LabelSetImage::EraseLabel(PixelType pixelValue)
 {
+  std::vector<PixelType> vectorOfLabelPixelValues = { pixelValue };
+  this->EraseLabels(vectorOfLabelPixelValues);
+}
+
+void mitk::LabelSetImage::EraseLabels(std::vector<PixelType>& VectorOfLabelPixelValues)
+{
+  auto lookupTable = CreateIdentityLookupTable();
+
+  for (const auto pixelValue : VectorOfLabelPixelValues)
+    RemapLookupTable(lookupTable, pixelValue, 0);
+
+  this->RemapLabels(lookupTable);
+  Modified();
+}
+
+void mitk::LabelSetImage::RemapLabels(const std::vector<PixelType>& lookupTable)
+{
+  if (NumberOfLabelValues != lookupTable.size())
+    mitkThrow() << "Invalid lookup table size " << lookupTable.size() << ". Expected " << NumberOfLabelValues << " entries.";
+
   try
   {
     if (4 == this->GetDimension())
     {
-      AccessFixedDimensionByItk_1(this, EraseLabelProcessing, 4, pixelValue);
+      AccessFixedDimensionByItk_1(this, RemapLabelsProcessing, 4, lookupTable);
     }
     else
     {
-      AccessByItk_1(this, EraseLabelProcessing, pixelValue);
+      AccessByItk_1(this, RemapLabelsProcessing, lookupTable);
     }
   }
   catch (const itk::ExceptionObject& e)
   {
     mitkThrow() << e.GetDescription();
   }
-  Modified();
-}
-
-void mitk::LabelSetImage::EraseLabels(std::vector<PixelType>& VectorOfLabelPixelValues)
-{
-  for (unsigned int idx = 0; idx < VectorOfLabelPixelValues.size(); idx++)
-  {
-    this->EraseLabel(VectorOfLabelPixelValues[idx]);
-  }
 }
 
 mitk::Label *mitk::LabelSetImage::GetActiveLabel(unsigned int layer)
@@ -805,91 +983,76 @@ void mitk::LabelSetImage::ClearBufferProcessing(ImageType *itkImage)
 
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::LabelSetImage::LayerContainerToImageProcessing(itk::Image<TPixel, VImageDimension> *target,
-                                                          unsigned int layer)
+                                                          const SparseLabelVolume *layerStorage) const
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typename ImageType::Pointer itkSource;
-  // mitk::CastToItkImage(m_LayerContainer[layer], itkSource);
-  itkSource = ImageToItkImage<TPixel, VImageDimension>(m_LayerContainer[layer]);
-  typedef itk::ImageRegionConstIterator<ImageType> SourceIteratorType;
-  typedef itk::ImageRegionIterator<ImageType> TargetIteratorType;
-
-  SourceIteratorType sourceIter(itkSource, itkSource->GetLargestPossibleRegion());
-  sourceIter.GoToBegin();
+  const auto numberOfPixels = layerStorage->GetNumberOfPixels();
+  if (target->GetBufferedRegion().GetNumberOfPixels() != numberOfPixels)
+    mitkThrow() << "Layer storage does not match the size of the image.";
 
-  TargetIteratorType targetIter(target, target->GetLargestPossibleRegion());
-  targetIter.GoToBegin();
+  auto buffer = target->GetBufferPointer();
 
-  while (!sourceIter.IsAtEnd())
+  if constexpr (std::is_same<TPixel, PixelType>::value)
   {
-    targetIter.Set(sourceIter.Get());
-    ++sourceIter;
-    ++targetIter;
+    layerStorage->GetBuffer(buffer);
+  }
+  else
+  {
+    std::vector<PixelType> values(numberOfPixels);
+    layerStorage->GetBuffer(values.data());
+    std::transform(values.begin(), values.end(), buffer, [](PixelType value) { return static_cast<TPixel>(value); });
   }
 }
 
 template <typename TPixel, unsigned int VImageDimension>
-void mitk::LabelSetImage::ImageToLayerContainerProcessing(itk::Image<TPixel, VImageDimension> *source,
-                                                          unsigned int layer) const
+void mitk::LabelSetImage::ImageToLayerContainerProcessing(const itk::Image<TPixel, VImageDimension> *source,
+                                                          SparseLabelVolume *layerStorage) const
 {
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typename ImageType::Pointer itkTarget;
-  // mitk::CastToItkImage(m_LayerContainer[layer], itkTarget);
-  itkTarget = ImageToItkImage<TPixel, VImageDimension>(m_LayerContainer[layer]);
-
-  typedef itk::ImageRegionConstIterator<ImageType> SourceIteratorType;
-  typedef itk::ImageRegionIterator<ImageType> TargetIteratorType;
+  const auto numberOfPixels = layerStorage->GetNumberOfPixels();
+  if (source->GetBufferedRegion().GetNumberOfPixels() != numberOfPixels)
+    mitkThrow() << "Layer image does not match the size of the segmentation.";
 
-  SourceIteratorType sourceIter(source, source->GetLargestPossibleRegion());
-  sourceIter.GoToBegin();
+  auto buffer = source->GetBufferPointer();
 
-  TargetIteratorType targetIter(itkTarget, itkTarget->GetLargestPossibleRegion());
-  targetIter.GoToBegin();
-
-  while (!sourceIter.IsAtEnd())
+  if constexpr (std::is_same<TPixel, PixelType>::value)
   {
-    targetIter.Set(sourceIter.Get());
-    ++sourceIter;
-    ++targetIter;
+    layerStorage->SetBuffer(buffer);
   }
-}
-
-template <typename ImageType>
-void mitk::LabelSetImage::EraseLabelProcessing(ImageType *itkImage, PixelType pixelValue)
-{
-  typedef itk::ImageRegionIterator<ImageType> IteratorType;
-
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
-
-  while (!iter.IsAtEnd())
+  else
   {
-    PixelType value = iter.Get();
-
-    if (value == pixelValue)
-    {
-      iter.Set(0);
-    }
-    ++iter;
+    std::vector<PixelType> values(numberOfPixels);
+    std::transform(buffer, buffer + numberOfPixels, values.begin(), [](TPixel value) { return static_cast<PixelType>(value); });
+    layerStorage->SetBuffer(values.data());
   }
 }
 
 template <typename ImageType>
-void mitk::LabelSetImage::MergeLabelProcessing(ImageType *itkImage, PixelType pixelValue, PixelType index)
+void mitk::LabelSetImage::RemapLabelsProcessing(ImageType *itkImage, const std::vector<PixelType> &lookupTable)
 {
-  typedef itk::ImageRegionIterator<ImageType> IteratorType;
+  typedef typename ImageType::PixelType ImagePixelType;
 
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
+  auto buffer = itkImage->GetBufferPointer();
+  const auto numberOfPixels = itkImage->GetBufferedRegion().GetNumberOfPixels();
+  const auto lut = lookupTable.data();
 
-  while (!iter.IsAtEnd())
+  ParallelizeOverPixels(numberOfPixels, [buffer, lut](itk::SizeValueType begin, itk::SizeValueType end)
   {
-    if (iter.Get() == index)
+    if constexpr (std::is_same<ImagePixelType, PixelType>::value)
     {
-      iter.Set(pixelValue);
+      for (auto i = begin; i < end; ++i)
+        buffer[i] = lut[buffer[i]];
     }
-    ++iter;
-  }
+    else
+    {
+      // Pixel values are compared as label values, just like in the former per-label passes.
+      for (auto i = begin; i < end; ++i)
+      {
+        const auto value = static_cast<PixelType>(buffer[i]);
+
+        if (lut[value] != value)
+          buffer[i] = static_cast<ImagePixelType>(lut[value]);
+      }
+    }
+  });
 }
 
 bool mitk::Equal(const mitk::LabelSetImage &leftHandSide,
@@ -973,122 +1136,115 @@ bool mitk::Equal(const mitk::LabelSetImage &leftHandSide,
   return returnValue;
 }
 
-/** Functor class that implements the label transfer and is used in conjunction with the itk::BinaryFunctorImageFilter.
-* For details regarding the usage of the filter and the functor patterns, please see info of itk::BinaryFunctorImageFilter.
-*/
-template <class TDestinationPixel, class TSourcePixel, class TOutputpixel>
-class LabelTransferFunctor
+namespace
 {
+  /** Lookup tables that perform the label transfer of all mapping elements at once.
+   * For every source pixel value that is affected by the mapping, SourceToTable points to a table
+   * that maps the existing destination pixel value to the transferred one. SourceToTable is null for
+   * all other source pixel values, which leave the destination untouched.
+   */
+  struct LabelTransferLookupTables
+  {
+    std::vector<mitk::Label::PixelType> Tables;
+    std::vector<const mitk::Label::PixelType*> SourceToTable;
+  };
 
-public:
-  LabelTransferFunctor() {};
-
-  LabelTransferFunctor(const mitk::LabelSet* destinationLabelSet, mitk::Label::PixelType sourceBackground,
-    mitk::Label::PixelType destinationBackground, bool destinationBackgroundLocked,
-    mitk::Label::PixelType sourceLabel, mitk::Label::PixelType newDestinationLabel, mitk::MultiLabelSegmentation::MergeStyle mergeStyle,
-    mitk::MultiLabelSegmentation::OverwriteStyle overwriteStyle) :
-    m_DestinationLabelSet(destinationLabelSet), m_SourceBackground(sourceBackground),
-    m_DestinationBackground(destinationBackground), m_DestinationBackgroundLocked(destinationBackgroundLocked),
-    m_SourceLabel(sourceLabel), m_NewDestinationLabel(newDestinationLabel), m_MergeStyle(mergeStyle), m_OverwriteStyle(overwriteStyle)
+  /** Computes the lookup tables such that applying them yields the same result as transferring
+   * the mapping elements one after another in the order of labelMapping. */
+  LabelTransferLookupTables ComputeLabelTransferLookupTables(const mitk::LabelSet* destinationLabelSet, mitk::Label::PixelType sourceBackground,
+    mitk::Label::PixelType destinationBackground, bool destinationBackgroundLocked, const std::vector<std::pair<mitk::Label::PixelType, mitk::Label::PixelType> >& labelMapping,
+    mitk::MultiLabelSegmentation::MergeStyle mergeStyle, mitk::MultiLabelSegmentation::OverwriteStyle overwriteStyle)
   {
-  };
+    const bool ignoreLocks = mitk::MultiLabelSegmentation::OverwriteStyle::IgnoreLocks == overwriteStyle;
+    const bool replace = mitk::MultiLabelSegmentation::MergeStyle::Replace == mergeStyle;
 
-  ~LabelTransferFunctor() {};
+    // Unknown destination pixel values are assumed to be unlocked.
+    std::vector<bool> locked(NumberOfLabelValues, false);
 
-  bool operator!=(const LabelTransferFunctor& other)const
-  {
-    return !(*this == other);
-  }
-  bool operator==(const LabelTransferFunctor& other) const
-  {
-    return this->m_SourceBackground == other.m_SourceBackground &&
-      this->m_DestinationBackground == other.m_DestinationBackground &&
-      this->m_DestinationBackgroundLocked == other.m_DestinationBackgroundLocked &&
-      this->m_SourceLabel == other.m_SourceLabel &&
-      this->m_NewDestinationLabel == other.m_NewDestinationLabel &&
-      this->m_MergeStyle == other.m_MergeStyle &&
-      this->m_OverwriteStyle == other.m_OverwriteStyle &&
-      this->m_DestinationLabelSet == other.m_DestinationLabelSet;
-  }
+    for (auto iter = destinationLabelSet->IteratorConstBegin(); iter != destinationLabelSet->IteratorConstEnd(); ++iter)
+      locked[iter->first] = iter->second->GetLocked();
 
-  LabelTransferFunctor& operator=(const LabelTransferFunctor& other)
-  {
-    this->m_DestinationLabelSet = other.m_DestinationLabelSet;
-    this->m_SourceBackground = other.m_SourceBackground;
-    this->m_DestinationBackground = other.m_DestinationBackground;
-    this->m_DestinationBackgroundLocked = other.m_DestinationBackgroundLocked;
-    this->m_SourceLabel = other.m_SourceLabel;
-    this->m_NewDestinationLabel = other.m_NewDestinationLabel;
-    this->m_MergeStyle = other.m_MergeStyle;
-    this->m_OverwriteStyle = other.m_OverwriteStyle;
+    // In replace mode, source background pixels clear transferred destination labels.
+    std::vector<mitk::Label::PixelType> affectedSourceValues;
 
-    return *this;
-  }
+    for (const auto& mappingElement : labelMapping)
+      affectedSourceValues.push_back(mappingElement.first);
 
-  inline TOutputpixel operator()(const TDestinationPixel& existingDestinationValue, const TSourcePixel& existingSourceValue)
-  {
-    if (existingSourceValue == this->m_SourceLabel)
+    if (replace)
+      affectedSourceValues.push_back(sourceBackground);
+
+    std::sort(affectedSourceValues.begin(), affectedSourceValues.end());
+    affectedSourceValues.erase(std::unique(affectedSourceValues.begin(), affectedSourceValues.end()), affectedSourceValues.end());
+
+    LabelTransferLookupTables result;
+    result.Tables.resize(affectedSourceValues.size() * NumberOfLabelValues);
+    result.SourceToTable.assign(NumberOfLabelValues, nullptr);
+
+    auto table = result.Tables.data();
+
+    for (const auto sourceValue : affectedSourceValues)
     {
-      if (mitk::MultiLabelSegmentation::OverwriteStyle::IgnoreLocks == this->m_OverwriteStyle)
-      {
-        return this->m_NewDestinationLabel;
-      }
-      else
+      for (std::size_t i = 0; i < NumberOfLabelValues; ++i)
+        table[i] = static_cast<mitk::Label::PixelType>(i);
+
+      for (const auto& [sourceLabel, newDestinationLabel] : labelMapping)
       {
-        auto label = this->m_DestinationLabelSet->GetLabel(existingDestinationValue);
-        if (nullptr == label || !label->GetLocked())
+        if (sourceLabel == sourceValue)
         {
-          return this->m_NewDestinationLabel;
+          for (std::size_t i = 0; i < NumberOfLabelValues; ++i)
+          {
+            if (ignoreLocks || !locked[table[i]])
+              table[i] = newDestinationLabel;
+          }
+        }
+        else if (replace && sourceValue == sourceBackground && (ignoreLocks || !destinationBackgroundLocked))
+        {
+          for (std::size_t i = 0; i < NumberOfLabelValues; ++i)
+          {
+            if (newDestinationLabel == table[i])
+              table[i] = destinationBackground;
+          }
         }
       }
-    }
-    else if (mitk::MultiLabelSegmentation::MergeStyle::Replace == this->m_MergeStyle
-      && existingSourceValue == this->m_SourceBackground
-      && existingDestinationValue == this->m_NewDestinationLabel
-      && (mitk::MultiLabelSegmentation::OverwriteStyle::IgnoreLocks == this->m_OverwriteStyle
-          || !this->m_DestinationBackgroundLocked))
-    {
-      return this->m_DestinationBackground;
+
+      result.SourceToTable[sourceValue] = table;
+      table += NumberOfLabelValues;
     }
 
-    return existingDestinationValue;
+    return result;
   }
-
-private:
-  const mitk::LabelSet* m_DestinationLabelSet = nullptr;
-  mitk::Label::PixelType m_SourceBackground = 0;
-  mitk::Label::PixelType m_DestinationBackground = 0;
-  bool m_DestinationBackgroundLocked = false;
-  mitk::Label::PixelType m_SourceLabel = 1;
-  mitk::Label::PixelType m_NewDestinationLabel = 1;
-  mitk::MultiLabelSegmentation::MergeStyle m_MergeStyle = mitk::MultiLabelSegmentation::MergeStyle::Replace;
-  mitk::MultiLabelSegmentation::OverwriteStyle m_OverwriteStyle = mitk::MultiLabelSegmentation::OverwriteStyle::RegardLocks;
-};
+}
 
 /**Helper function used by TransferLabelContent to allow the templating over different image dimensions in conjunction of AccessFixedPixelTypeByItk_n.*/
 template<unsigned int VImageDimension>
 void TransferLabelContentHelper(const itk::Image<mitk::Label::PixelType, VImageDimension>* itkSourceImage, mitk::Image* destinationImage,
-  const mitk::LabelSet* destinationLabelSet, mitk::Label::PixelType sourceBackground, mitk::Label::PixelType destinationBackground,
-  bool destinationBackgroundLocked, mitk::Label::PixelType sourceLabel, mitk::Label::PixelType newDestinationLabel, mitk::MultiLabelSegmentation::MergeStyle mergeStyle, mitk::MultiLabelSegmentation::OverwriteStyle overwriteStyle)
+  const LabelTransferLookupTables& lookupTables)
 {
   typedef itk::Image<mitk::Label::PixelType, VImageDimension> ContentImageType;
   typename ContentImageType::Pointer itkDestinationImage;
   mitk::CastToItkImage(destinationImage, itkDestinationImage);
 
-  typedef LabelTransferFunctor <mitk::Label::PixelType, mitk::Label::PixelType, mitk::Label::PixelType> LabelTransferFunctorType;
-  typedef itk::BinaryFunctorImageFilter<ContentImageType, ContentImageType, ContentImageType, LabelTransferFunctorType> FilterType;
+  const auto numberOfPixels = itkSourceImage->GetBufferedRegion().GetNumberOfPixels();
 
-  LabelTransferFunctorType transferFunctor(destinationLabelSet, sourceBackground, destinationBackground,
-    destinationBackgroundLocked, sourceLabel, newDestinationLabel, mergeStyle, overwriteStyle);
+  if (numberOfPixels != itkDestinationImage->GetBufferedRegion().GetNumberOfPixels())
+  {
+    mitkThrow() << "Invalid call of TransferLabelContent; sourceImage and destinationImage differ in size.";
+  }
 
-  auto transferFilter = FilterType::New();
+  const auto source = itkSourceImage->GetBufferPointer();
+  auto destination = itkDestinationImage->GetBufferPointer();
+  const auto sourceToTable = lookupTables.SourceToTable.data();
 
-  transferFilter->SetFunctor(transferFunctor);
-  transferFilter->InPlaceOn();
-  transferFilter->SetInput1(itkDestinationImage);
-  transferFilter->SetInput2(itkSourceImage);
+  ParallelizeOverPixels(numberOfPixels, [source, destination, sourceToTable](itk::SizeValueType begin, itk::SizeValueType end)
+  {
+    for (auto i = begin; i < end; ++i)
+    {
+      const auto table = sourceToTable[source[i]];
 
-  transferFilter->Update();
+      if (nullptr != table)
+        destination[i] = table[destination[i]];
+    }
+  });
 }
 
 void mitk::TransferLabelContent(
@@ -1121,15 +1277,18 @@ void mitk::TransferLabelContent(
     mitkThrow() << "Invalid call of TransferLabelContent; destinationImage does not have the requested time step: " << timeStep;
   }
 
-  for (const auto& [sourceLabel, newDestinationLabel] : labelMapping)
+  for (const auto& mappingElement : labelMapping)
   {
-    if (nullptr == destinationLabelSet->GetLabel(newDestinationLabel))
+    if (nullptr == destinationLabelSet->GetLabel(mappingElement.second))
     {
-      mitkThrow() << "Invalid call of TransferLabelContent. Defined destination label does not exist in destinationImage. newDestinationLabel: " << newDestinationLabel;
+      mitkThrow() << "Invalid call of TransferLabelContent. Defined destination label does not exist in destinationImage. newDestinationLabel: " << mappingElement.second;
     }
-
-    AccessFixedPixelTypeByItk_n(sourceImageAtTimeStep, TransferLabelContentHelper, (Label::PixelType), (destinationImageAtTimeStep, destinationLabelSet, sourceBackground, destinationBackground, destinationBackgroundLocked, sourceLabel, newDestinationLabel, mergeStyle, overwriteStlye));
   }
+
+  const auto lookupTables = ComputeLabelTransferLookupTables(destinationLabelSet, sourceBackground, destinationBackground,
+    destinationBackgroundLocked, labelMapping, mergeStyle, overwriteStlye);
+
+  AccessFixedPixelTypeByItk_n(sourceImageAtTimeStep, TransferLabelContentHelper, (Label::PixelType), (destinationImageAtTimeStep, lookupTables));
   destinationImage->Modified();
 }
 
@@ -15,15 +15,21 @@ found in the LICENSE file.
 
 #include <mitkImage.h>
 #include <mitkLabelSet.h>
+#include <mitkSparseLabelVolume.h>
 
 #include <MitkMultilabelExports.h>
 
+#include <memory>
+#include <mutex>
+
 namespace mitk
 {
   //##Documentation
   //## @brief LabelSetImage class for handling labels and layers in a segmentation session.
   //##
   //## Handles operations for adding, removing, erasing and editing labels and layers.
+  //## The image buffer holds the active layer, all other layers are kept as mitk::SparseLabelVolume,
+  //## in which uniform bricks (e.g. background) need no memory.
   //## @ingroup Data
 
   class MITKMULTILABEL_EXPORT LabelSetImage : public Image
@@ -75,6 +81,8 @@ namespace mitk
      * @param pixelValue                  the value of the label that should be the new merged label
      * @param vectorOfSourcePixelValues   the list of label values that should be merge into the specified one
      * @param layer                       the layer in which the merge should be performed
+     *
+     * All labels are merged in a single pass over the image (see RemapLabels()).
      */
     void MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer = 0);
 
@@ -113,9 +121,19 @@ namespace mitk
      * @brief Erases a list of labels with the given values from the labelset image.
      * @param VectorOfLabelPixelValues the list of pixel values of the labels
      *                                 that will be erased from the labelset image
+     *
+     * All labels are erased in a single pass over the image (see RemapLabels()).
      */
     void EraseLabels(std::vector<PixelType> &VectorOfLabelPixelValues);
 
+    /**
+     * @brief Replaces the pixel values of all time steps of the labelset image by a lookup table.
+     *        The label sets are not changed.
+     * @param lookupTable the new pixel value for every possible label pixel value, i.e.
+     *                    std::numeric_limits<PixelType>::max() + 1 entries
+     */
+    void RemapLabels(const std::vector<PixelType> &lookupTable);
+
     /**
       * \brief  Returns true if the value exists in one of the labelsets*/
     bool ExistLabel(PixelType pixelValue) const;
@@ -250,11 +268,50 @@ namespace mitk
     void RemoveLayer();
 
     /**
-      * \brief  */
+     * @brief Returns a dense image of a layer.
+     *
+     * For the active layer this is the LabelSetImage itself. For other layers a dense copy of the sparse layer
+     * storage is created on the first request and kept until it is released (see ReleaseLayerImage()), the
+     * active layer changes or the layer is removed. Changes made to this image are preserved, they are moved
+     * into the layer when the image is released or replace the layer when it is activated. Like for every
+     * image, changes must be signaled by Modified(): an unmodified image is released without rebuilding the
+     * layer storage. Do not modify the image after it has been released.
+     *
+     * GetLayerImage(), HasLayerImage() and ReleaseLayerImage() may be called concurrently (e.g. by the mappers of
+     * several render windows), they are serialized internally. Layer changes (SetActiveLayer(), AddLayer(),
+     * RemoveLayer()) must not run concurrently with the use of a returned image.
+     */
     mitk::Image *GetLayerImage(unsigned int layer);
 
     const mitk::Image *GetLayerImage(unsigned int layer) const;
 
+    /**
+     * @brief Returns the sparse storage of an inactive layer or nullptr for the active layer, whose label
+     *        values are the image buffer.
+     */
+    const SparseLabelVolume *GetLayerStorage(unsigned int layer) const;
+
+    /**
+     * @brief Indicates if a dense image of the inactive layer has been created by GetLayerImage() and not
+     *        released yet.
+     */
+    bool HasLayerImage(unsigned int layer) const;
+
+    /**
+     * @brief Releases the dense image created by GetLayerImage() for an inactive layer.
+     *
+     * Changes made to the image (i.e. if it was modified since its creation) are moved into the sparse layer
+     * storage before.
+     */
+    void ReleaseLayerImage(unsigned int layer);
+
+    /**
+     * @brief Releases the dense images created by GetLayerImage() for all inactive layers (see ReleaseLayerImage()).
+     *
+     * Called by SetActiveLayer(), so that dense images of inactive layers never outlive a layer switch.
+     */
+    void ReleaseLayerImages();
+
     void OnLabelSetModified();
 
     /**
@@ -278,11 +335,26 @@ namespace mitk
     LabelSetImage(const LabelSetImage &other);
     ~LabelSetImage() override;
 
+    /** Returns the size (x, y, z, t) of the layer storage.*/
+    SparseLabelVolume::SizeType GetLayerStorageSize() const;
+
+    /** Creates an empty image with the pixel type and geometry of the LabelSetImage.*/
+    mitk::Image::Pointer CreateLayerImage() const;
+
+    /** Writes the label values of an image into a new sparse layer storage.*/
+    std::unique_ptr<SparseLabelVolume> CreateLayerStorage(const mitk::Image *image) const;
+
+    /** Writes the label values of a layer storage into the image buffer.*/
+    void WriteLayerStorageToImage(const SparseLabelVolume *layerStorage);
+
+    /** Appends a layer with the given label values and activates it.*/
+    unsigned int AddLayerStorage(std::unique_ptr<SparseLabelVolume> layerStorage, mitk::LabelSet::Pointer labelSet);
+
     template <typename TPixel, unsigned int VImageDimension>
-    void LayerContainerToImageProcessing(itk::Image<TPixel, VImageDimension> *source, unsigned int layer);
+    void LayerContainerToImageProcessing(itk::Image<TPixel, VImageDimension> *target, const SparseLabelVolume *layerStorage) const;
 
     template <typename TPixel, unsigned int VImageDimension>
-    void ImageToLayerContainerProcessing(itk::Image<TPixel, VImageDimension> *source, unsigned int layer) const;
+    void ImageToLayerContainerProcessing(const itk::Image<TPixel, VImageDimension> *source, SparseLabelVolume *layerStorage) const;
 
     template <typename ImageType>
     void CalculateCenterOfMassProcessing(ImageType *input, PixelType index, unsigned int layer);
@@ -290,11 +362,14 @@ namespace mitk
     template <typename ImageType>
     void ClearBufferProcessing(ImageType *input);
 
+    /**
+     * @brief Replaces every pixel value of the image by its entry in the passed lookup table.
+     *
+     * The lookup table has an entry for every possible mitk::Label::PixelType value. The image
+     * buffer is processed in a single multi-threaded pass, regardless of how many labels are changed.
+     */
     template <typename ImageType>
-    void EraseLabelProcessing(ImageType *input, PixelType index);
-
-    template <typename ImageType>
-    void MergeLabelProcessing(ImageType *input, PixelType pixelValue, PixelType index);
+    void RemapLabelsProcessing(ImageType *input, const std::vector<PixelType> &lookupTable);
 
     template <typename ImageType>
     void MaskStampProcessing(ImageType *input, mitk::Image *mask, bool forceOverwrite);
@@ -303,7 +378,14 @@ namespace mitk
     void InitializeByLabeledImageProcessing(LabelSetImageType *input, ImageType *other);
 
     std::vector<LabelSet::Pointer> m_LabelSetContainer;
-    std::vector<Image::Pointer> m_LayerContainer;
+    /** Sparse label values of all layers, nullptr for the active layer (its values are the image buffer).*/
+    std::vector<std::unique_ptr<SparseLabelVolume>> m_LayerContainer;
+    /** Dense images of inactive layers created by GetLayerImage(), nullptr if not requested.*/
+    mutable std::vector<Image::Pointer> m_LayerImageContainer;
+    /** MTime of the dense layer images at their creation, an image with this MTime equals its layer storage.*/
+    mutable std::vector<itk::ModifiedTimeType> m_LayerImageMTimes;
+    /** Guards m_LayerImageContainer and m_LayerImageMTimes.*/
+    mutable std::mutex m_LayerImageMutex;
 
     int m_ActiveLayer;
 
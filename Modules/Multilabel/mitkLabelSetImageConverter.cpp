@@ -15,9 +15,9 @@ found in the LICENSE file.
 #include <mitkImageCast.h>
 #include <mitkLabelSetImageConverter.h>
 
-#include <itkComposeImageFilter.h>
 #include <itkExtractImageFilter.h>
 #include <itkImageDuplicator.h>
+#include <itkVectorImage.h>
 #include <itkVectorIndexSelectionCastImageFilter.h>
 
 template <typename TPixel, unsigned int VDimension>
@@ -26,28 +26,56 @@ static void ConvertLabelSetImageToImage(const itk::Image<TPixel, VDimension> *,
                                         mitk::Image::Pointer &image)
 {
   typedef itk::Image<TPixel, VDimension> ImageType;
-  typedef itk::ComposeImageFilter<ImageType> ComposeFilterType;
+  typedef itk::VectorImage<TPixel, VDimension> VectorImageType;
   typedef itk::ImageDuplicator<ImageType> DuplicatorType;
 
   auto numberOfLayers = labelSetImage->GetNumberOfLayers();
 
   if (numberOfLayers > 1)
   {
-    auto vectorImageComposer = ComposeFilterType::New();
     auto activeLayer = labelSetImage->GetActiveLayer();
+    auto activeLayerImage = mitk::ImageToItkImage<TPixel, VDimension>(labelSetImage);
+
+    auto vectorImage = VectorImageType::New();
+    vectorImage->CopyInformation(activeLayerImage);
+    vectorImage->SetRegions(activeLayerImage->GetLargestPossibleRegion());
+    vectorImage->SetNumberOfComponentsPerPixel(numberOfLayers);
+    vectorImage->Allocate();
+
+    const std::size_t numberOfPixels = activeLayerImage->GetLargestPossibleRegion().GetNumberOfPixels();
+    TPixel *target = vectorImage->GetBufferPointer();
+
+    auto copyLayer = [&](auto values, unsigned int layer) {
+      for (std::size_t i = 0; i < numberOfPixels; ++i)
+        target[i * numberOfLayers + layer] = static_cast<TPixel>(values[i]);
+    };
+
+    // Inactive layers are read from their sparse storage into one reused buffer instead of creating a dense
+    // layer image per layer. Only existing dense layer images (which may contain changes) are used directly.
+    std::vector<mitk::Label::PixelType> layerValues;
 
     for (decltype(numberOfLayers) layer = 0; layer < numberOfLayers; ++layer)
     {
-      auto layerImage = mitk::ImageToItkImage<TPixel, VDimension>(
-        layer != activeLayer ? labelSetImage->GetLayerImage(layer) : labelSetImage);
-
-      vectorImageComposer->SetInput(layer, layerImage);
+      if (layer == activeLayer)
+      {
+        copyLayer(activeLayerImage->GetBufferPointer(), layer);
+      }
+      else if (labelSetImage->HasLayerImage(layer))
+      {
+        auto layerImage = mitk::ImageToItkImage<TPixel, VDimension>(labelSetImage->GetLayerImage(layer));
+        copyLayer(layerImage->GetBufferPointer(), layer);
+      }
+      else
+      {
+        layerValues.resize(numberOfPixels);
+        labelSetImage->GetLayerStorage(layer)->GetBuffer(layerValues.data());
+        copyLayer(layerValues.data(), layer);
+      }
     }
 
-    vectorImageComposer->Update();
     // mitk::GrabItkImageMemory does not support 4D, this will handle 4D correctly
     // and create a memory managed copy
-    image = mitk::ImportItkImage(vectorImageComposer->GetOutput())->Clone();
+    image = mitk::ImportItkImage(vectorImage.GetPointer())->Clone();
   }
   else
   {
@@ -75,7 +103,7 @@ mitk::Image::Pointer mitk::ConvertLabelSetImageToImage(LabelSetImage::ConstPoint
     }
     else
     {
-      AccessByItk_2(labelSetImage->GetLayerImage(0), ::ConvertLabelSetImageToImage, labelSetImage, image);
+      AccessByItk_2(labelSetImage, ::ConvertLabelSetImageToImage, labelSetImage, image);
     }
 
     image->SetTimeGeometry(labelSetImage->GetTimeGeometry()->Clone());
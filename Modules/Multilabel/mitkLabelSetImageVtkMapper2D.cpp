@@ -146,7 +146,8 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
   {
     mitk::Image *layerImage = nullptr;
 
-    // set main input for ExtractSliceFilter
+    // set main input for ExtractSliceFilter. The dense images of inactive layers are kept by the LabelSetImage
+    // until the active layer changes, so they are created once and not for every resliced slice.
     if (lidx == activeLayer)
       layerImage = image;
     else
@@ -0,0 +1,254 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkSparseLabelVolume.h"
+
+#include <mitkExceptionMacro.h>
+
+#include <itkMultiThreaderBase.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+  /** Calls function(brickIndex) for all bricks on the ITK thread pool. */
+  template <typename TFunction>
+  void ParallelizeOverBricks(std::size_t numberOfBricks, const TFunction &function)
+  {
+    if (0 == numberOfBricks)
+      return;
+
+    itk::MultiThreaderBase::New()->ParallelizeArray(0, numberOfBricks, [&](itk::SizeValueType brickIndex)
+    {
+      function(static_cast<std::size_t>(brickIndex));
+    }, nullptr);
+  }
+}
+
+mitk::SparseLabelVolume::SparseLabelVolume() : SparseLabelVolume(SizeType({ { 0, 0, 0, 0 } }))
+{
+}
+
+mitk::SparseLabelVolume::SparseLabelVolume(const SizeType &size, PixelType value) : m_Size(size)
+{
+  std::size_t numberOfBricks = size[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    m_NumberOfBricks[i] = (size[i] + BrickSize - 1) / BrickSize;
+    numberOfBricks *= m_NumberOfBricks[i];
+  }
+
+  m_Bricks.resize(numberOfBricks);
+  this->Fill(value);
+}
+
+mitk::SparseLabelVolume::SparseLabelVolume(const SparseLabelVolume &other)
+  : m_Size(other.m_Size), m_NumberOfBricks(other.m_NumberOfBricks), m_Bricks(other.m_Bricks.size())
+{
+  for (std::size_t i = 0; i < m_Bricks.size(); ++i)
+  {
+    m_Bricks[i].Value = other.m_Bricks[i].Value;
+
+    if (nullptr != other.m_Bricks[i].Data)
+    {
+      const auto numberOfPixels = this->GetBrickRegion(i).GetNumberOfPixels();
+      m_Bricks[i].Data.reset(new PixelType[numberOfPixels]);
+      std::copy(other.m_Bricks[i].Data.get(), other.m_Bricks[i].Data.get() + numberOfPixels, m_Bricks[i].Data.get());
+    }
+  }
+}
+
+mitk::SparseLabelVolume::~SparseLabelVolume()
+{
+}
+
+mitk::SparseLabelVolume &mitk::SparseLabelVolume::operator=(const SparseLabelVolume &other)
+{
+  if (this != &other)
+    *this = SparseLabelVolume(other);
+
+  return *this;
+}
+
+std::size_t mitk::SparseLabelVolume::GetNumberOfPixels() const
+{
+  return std::size_t(m_Size[0]) * m_Size[1] * m_Size[2] * m_Size[3];
+}
+
+mitk::SparseLabelVolume::BrickRegion mitk::SparseLabelVolume::GetBrickRegion(std::size_t brickIndex) const
+{
+  BrickRegion region;
+
+  const std::size_t bricksPerTimeStep = std::size_t(m_NumberOfBricks[0]) * m_NumberOfBricks[1] * m_NumberOfBricks[2];
+  region.TimeStep = static_cast<unsigned int>(brickIndex / bricksPerTimeStep);
+  brickIndex %= bricksPerTimeStep;
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    region.Origin[i] = static_cast<unsigned int>(brickIndex % m_NumberOfBricks[i]) * BrickSize;
+    region.Size[i] = std::min(BrickSize, m_Size[i] - region.Origin[i]);
+    brickIndex /= m_NumberOfBricks[i];
+  }
+
+  return region;
+}
+
+std::size_t mitk::SparseLabelVolume::GetBrickIndex(unsigned int x, unsigned int y, unsigned int z, unsigned int t) const
+{
+  if (x >= m_Size[0] || y >= m_Size[1] || z >= m_Size[2] || t >= m_Size[3])
+    mitkThrow() << "Index (" << x << ", " << y << ", " << z << ", " << t << ") is outside of the volume.";
+
+  return x / BrickSize +
+         m_NumberOfBricks[0] * (y / BrickSize + std::size_t(m_NumberOfBricks[1]) * (z / BrickSize + std::size_t(m_NumberOfBricks[2]) * t));
+}
+
+void mitk::SparseLabelVolume::SetBuffer(const PixelType *buffer)
+{
+  const std::size_t rowStride = m_Size[0];
+  const std::size_t sliceStride = rowStride * m_Size[1];
+  const std::size_t volumeStride = sliceStride * m_Size[2];
+
+  ParallelizeOverBricks(m_Bricks.size(), [&](std::size_t brickIndex)
+  {
+    const auto region = this->GetBrickRegion(brickIndex);
+    const PixelType *origin = buffer + region.TimeStep * volumeStride + region.Origin[2] * sliceStride +
+                              region.Origin[1] * rowStride + region.Origin[0];
+    auto &brick = m_Bricks[brickIndex];
+
+    // Uniform bricks only keep their value
+    const PixelType value = *origin;
+    bool isUniform = true;
+    for (unsigned int z = 0; z < region.Size[2] && isUniform; ++z)
+    {
+      for (unsigned int y = 0; y < region.Size[1] && isUniform; ++y)
+      {
+        const PixelType *row = origin + z * sliceStride + y * rowStride;
+        isUniform = std::all_of(row, row + region.Size[0], [value](PixelType pixel) { return pixel == value; });
+      }
+    }
+
+    brick.Value = value;
+
+    if (isUniform)
+    {
+      brick.Data.reset();
+      return;
+    }
+
+    if (nullptr == brick.Data)
+      brick.Data.reset(new PixelType[region.GetNumberOfPixels()]);
+
+    PixelType *target = brick.Data.get();
+    for (unsigned int z = 0; z < region.Size[2]; ++z)
+    {
+      for (unsigned int y = 0; y < region.Size[1]; ++y)
+      {
+        std::memcpy(target, origin + z * sliceStride + y * rowStride, region.Size[0] * sizeof(PixelType));
+        target += region.Size[0];
+      }
+    }
+  });
+}
+
+void mitk::SparseLabelVolume::GetBuffer(PixelType *buffer) const
+{
+  const std::size_t rowStride = m_Size[0];
+  const std::size_t sliceStride = rowStride * m_Size[1];
+  const std::size_t volumeStride = sliceStride * m_Size[2];
+
+  ParallelizeOverBricks(m_Bricks.size(), [&](std::size_t brickIndex)
+  {
+    const auto region = this->GetBrickRegion(brickIndex);
+    PixelType *origin = buffer + region.TimeStep * volumeStride + region.Origin[2] * sliceStride +
+                        region.Origin[1] * rowStride + region.Origin[0];
+    const auto &brick = m_Bricks[brickIndex];
+    const PixelType *source = brick.Data.get();
+
+    for (unsigned int z = 0; z < region.Size[2]; ++z)
+    {
+      for (unsigned int y = 0; y < region.Size[1]; ++y)
+      {
+        PixelType *row = origin + z * sliceStride + y * rowStride;
+
+        if (nullptr == source)
+        {
+          std::fill(row, row + region.Size[0], brick.Value);
+        }
+        else
+        {
+          std::memcpy(row, source, region.Size[0] * sizeof(PixelType));
+          source += region.Size[0];
+        }
+      }
+    }
+  });
+}
+
+void mitk::SparseLabelVolume::Fill(PixelType value)
+{
+  for (auto &brick : m_Bricks)
+  {
+    brick.Value = value;
+    brick.Data.reset();
+  }
+}
+
+mitk::SparseLabelVolume::PixelType mitk::SparseLabelVolume::GetPixel(unsigned int x, unsigned int y, unsigned int z, unsigned int t) const
+{
+  const auto &brick = m_Bricks[this->GetBrickIndex(x, y, z, t)];
+
+  if (nullptr == brick.Data)
+    return brick.Value;
+
+  const unsigned int sizeX = std::min(BrickSize, m_Size[0] - x / BrickSize * BrickSize);
+  const unsigned int sizeY = std::min(BrickSize, m_Size[1] - y / BrickSize * BrickSize);
+  return brick.Data[x % BrickSize + sizeX * (y % BrickSize + std::size_t(sizeY) * (z % BrickSize))];
+}
+
+void mitk::SparseLabelVolume::SetPixel(unsigned int x, unsigned int y, unsigned int z, unsigned int t, PixelType value)
+{
+  const auto brickIndex = this->GetBrickIndex(x, y, z, t);
+  auto &brick = m_Bricks[brickIndex];
+
+  if (nullptr == brick.Data)
+  {
+    if (value == brick.Value)
+      return;
+
+    const auto numberOfPixels = this->GetBrickRegion(brickIndex).GetNumberOfPixels();
+    brick.Data.reset(new PixelType[numberOfPixels]);
+    std::fill(brick.Data.get(), brick.Data.get() + numberOfPixels, brick.Value);
+  }
+
+  const unsigned int sizeX = std::min(BrickSize, m_Size[0] - x / BrickSize * BrickSize);
+  const unsigned int sizeY = std::min(BrickSize, m_Size[1] - y / BrickSize * BrickSize);
+  brick.Data[x % BrickSize + sizeX * (y % BrickSize + std::size_t(sizeY) * (z % BrickSize))] = value;
+}
+
+std::size_t mitk::SparseLabelVolume::GetNumberOfAllocatedBricks() const
+{
+  return std::count_if(m_Bricks.begin(), m_Bricks.end(), [](const Brick &brick) { return nullptr != brick.Data; });
+}
+
+std::size_t mitk::SparseLabelVolume::GetAllocatedMemorySize() const
+{
+  std::size_t size = 0;
+
+  for (std::size_t i = 0; i < m_Bricks.size(); ++i)
+  {
+    if (nullptr != m_Bricks[i].Data)
+      size += this->GetBrickRegion(i).GetNumberOfPixels() * sizeof(PixelType);
+  }
+
+  return size;
+}
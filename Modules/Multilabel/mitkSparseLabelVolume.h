@@ -0,0 +1,105 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkSparseLabelVolume_h
+#define mitkSparseLabelVolume_h
+
+#include <mitkLabel.h>
+
+#include <MitkMultilabelExports.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Stores the label values of a 3D or 3D+t volume in fixed-size bricks.
+   *
+   * The volume is divided into cubic bricks of BrickSize voxels per edge (per time step). A brick in which all
+   * voxels have the same value only stores this value, only the other bricks allocate a voxel buffer. Label
+   * layers usually cover a small part of the image, so most bricks are uniform (e.g. background) and the
+   * volume needs a fraction of the memory of a dense image.
+   *
+   * The dense layout used by SetBuffer() and GetBuffer() is the layout of an mitk::Image (x fastest, then y,
+   * z and t). Both are processed brick-parallel.
+   */
+  class MITKMULTILABEL_EXPORT SparseLabelVolume
+  {
+  public:
+    using PixelType = Label::PixelType;
+    /** Size in x, y, z and t.*/
+    using SizeType = std::array<unsigned int, 4>;
+
+    /** Edge length of the bricks in voxels.*/
+    static constexpr unsigned int BrickSize = 32;
+
+    SparseLabelVolume();
+    /** Creates a volume in which all voxels have the given value (without allocating any brick).*/
+    explicit SparseLabelVolume(const SizeType &size, PixelType value = 0);
+    SparseLabelVolume(const SparseLabelVolume &other);
+    SparseLabelVolume(SparseLabelVolume &&other) = default;
+    ~SparseLabelVolume();
+
+    SparseLabelVolume &operator=(const SparseLabelVolume &other);
+    SparseLabelVolume &operator=(SparseLabelVolume &&other) = default;
+
+    const SizeType &GetSize() const { return m_Size; }
+    std::size_t GetNumberOfPixels() const;
+
+    /** Replaces all voxels by the values of the dense buffer, which contains GetNumberOfPixels() values.*/
+    void SetBuffer(const PixelType *buffer);
+
+    /** Writes all voxels to the dense buffer, which must be able to hold GetNumberOfPixels() values.*/
+    void GetBuffer(PixelType *buffer) const;
+
+    /** Sets all voxels to the value and releases all brick buffers.*/
+    void Fill(PixelType value);
+
+    PixelType GetPixel(unsigned int x, unsigned int y, unsigned int z, unsigned int t = 0) const;
+    void SetPixel(unsigned int x, unsigned int y, unsigned int z, unsigned int t, PixelType value);
+
+    std::size_t GetNumberOfBricks() const { return m_Bricks.size(); }
+    /** Number of bricks that store a voxel buffer, i.e. that are not uniform.*/
+    std::size_t GetNumberOfAllocatedBricks() const;
+    /** Bytes used by the voxel buffers of all bricks.*/
+    std::size_t GetAllocatedMemorySize() const;
+
+  private:
+    struct Brick
+    {
+      /** Value of all voxels if Data is nullptr.*/
+      PixelType Value = 0;
+      std::unique_ptr<PixelType[]> Data;
+    };
+
+    /** Position (in voxels) and size of a brick, which is smaller than BrickSize at the upper borders.*/
+    struct BrickRegion
+    {
+      std::array<unsigned int, 3> Origin;
+      std::array<unsigned int, 3> Size;
+      unsigned int TimeStep;
+
+      std::size_t GetNumberOfPixels() const { return std::size_t(Size[0]) * Size[1] * Size[2]; }
+    };
+
+    BrickRegion GetBrickRegion(std::size_t brickIndex) const;
+    std::size_t GetBrickIndex(unsigned int x, unsigned int y, unsigned int z, unsigned int t) const;
+
+    SizeType m_Size;
+    std::array<unsigned int, 3> m_NumberOfBricks;
+    std::vector<Brick> m_Bricks;
+  };
+}
+
+#endif
@@ -54,8 +54,11 @@ namespace mitk
     itkGetConstReferenceMacro(AterialInputFunctionValues, AterialInputFunctionType);
     itkGetConstReferenceMacro(AterialInputFunctionTimeGrid, TimeGridType);
 
-    itkSetMacro(AterialInputFunctionValues, AterialInputFunctionType);
-    itkSetMacro(AterialInputFunctionTimeGrid, TimeGridType);
+    virtual void SetAterialInputFunctionValues(const AterialInputFunctionType& values);
+    virtual void SetAterialInputFunctionTimeGrid(const TimeGridType& grid);
+
+    /** Reimplementation that also updates the AIF interpolated to the model time grid.*/
+    void SetTimeGrid(const TimeGridType& grid) override;
 
     std::string GetXAxisName() const override;
 
@@ -74,6 +77,12 @@ namespace mitk
      * if currentTimeGrid.Size() = 0 , the Original AIF will be returned*/
     const AterialInputFunctionType GetAterialInputFunction(TimeGridType currentTimeGrid) const;
 
+    /** Returns the Aterial Input function interpolated to the model time grid.
+     * The interpolation is cached and only recomputed if the AIF, the AIF time grid or the model time grid are set.
+     * Thus models should use this method instead of GetAterialInputFunction(m_TimeGrid) in ComputeModelfunction().
+     * The returned function is empty if the model is not valid (see ValidateModel()).*/
+    const AterialInputFunctionType& GetAterialInputFunctionOnModelTimeGrid() const;
+
     ParameterNamesType GetStaticParameterNames() const override;
     ParametersSizeType GetNumberOfStaticParameters() const override;
     ParamterUnitMapType GetStaticParameterUnits() const override;
@@ -100,6 +109,12 @@ namespace mitk
     TimeGridType m_AterialInputFunctionTimeGrid;
     AterialInputFunctionType m_AterialInputFunctionValues;
 
+    /** Interpolates the AIF onto the model time grid and stores it in m_AterialInputFunctionOnModelTimeGrid.*/
+    void UpdateAterialInputFunctionOnModelTimeGrid();
+
+    /** Cache of the AIF interpolated to m_TimeGrid. Only set in the non const setters, thus concurrent
+     * evaluations of the model do not write it.*/
+    AterialInputFunctionType m_AterialInputFunctionOnModelTimeGrid;
 
   private:
 
@@ -14,6 +14,7 @@ found in the LICENSE file.
 
 #include "itkArray.h"
 #include "mitkAIFBasedModelBase.h"
+#include <cstddef>
 #include <iostream>
 #include "MitkPharmacokineticsExports.h"
 
@@ -105,7 +106,7 @@ inline    itk::Array<double> wrap1d(itk::Array<double> kernel)
 
     }
 
-  inline itk::Array<double> convoluteAIFWithExponential(mitk::ModelBase::TimeGridType timeGrid, mitk::AIFBasedModelBase::AterialInputFunctionType aif, double lambda)
+  inline itk::Array<double> convoluteAIFWithExponential(const mitk::ModelBase::TimeGridType& timeGrid, const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, double lambda)
   {
       /** @brief Iterative Formula to Convolve aif(t) with an exponential Residuefunction R(t) = exp(lambda*t)
        **/
@@ -128,8 +129,74 @@ inline    itk::Array<double> wrap1d(itk::Array<double> kernel)
       return convolution;
   }
 
+  /** @brief Computes the same convolution as convoluteAIFWithExponential and its derivative with respect to lambda.
+   * The derivative is the exact derivative of the recurrence, thus it is consistent with the convolution values.
+   * @param [out] convolution Resized to the size of the time grid.
+   * @param [out] derivative Resized to the size of the time grid.*/
+  inline void convoluteAIFWithExponentialAndDerivative(const mitk::ModelBase::TimeGridType& timeGrid, const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, double lambda, itk::Array<double>& convolution, itk::Array<double>& derivative)
+  {
+      convolution.SetSize(timeGrid.GetSize());
+      derivative.SetSize(timeGrid.GetSize());
+      convolution.fill(0.0);
+      derivative.fill(0.0);
+
+      const double lambda2 = lambda * lambda;
+
+      for(unsigned int i = 0; i< (timeGrid.GetSize()-1); ++i)
+      {
+          double dt = timeGrid(i+1) - timeGrid(i);
+          double m = (aif(i+1) - aif(i))/dt;
+          double edt = exp(-lambda *dt);
+          double offset = aif(i) - m*timeGrid(i);
+          double g = (lambda * timeGrid(i+1) - 1) - edt*(lambda*timeGrid(i) -1);
+          double dg = timeGrid(i+1) + dt * edt * (lambda*timeGrid(i) - 1) - edt * timeGrid(i);
+
+          convolution(i+1) = edt * convolution(i)
+                           + offset/lambda * (1 - edt )
+                           + m/lambda2 * g;
+
+          derivative(i+1) = edt * derivative(i) - dt * edt * convolution(i)
+                          + offset * (dt * edt / lambda - (1 - edt) / lambda2)
+                          + m * (dg / lambda2 - 2 * g / (lambda2 * lambda));
+      }
+  }
+
+  /** @brief Batch version of convoluteAIFWithExponential that convolves the AIF with numberOfSets exponentials at once.
+   * The results are stored in structure of arrays layout: convolution[i * numberOfSets + s] is the value of the
+   * exponential with lambdas[s] at time point i. The inner loops run over contiguous memory and can be vectorized.
+   * @pre convolution must point to timeGrid.GetSize() * numberOfSets values.*/
+  inline void convoluteAIFWithExponentials(const mitk::ModelBase::TimeGridType& timeGrid, const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, const double* lambdas, std::size_t numberOfSets, double* convolution)
+  {
+      for (std::size_t s = 0; s < numberOfSets; ++s)
+      {
+          convolution[s] = 0.0;
+      }
+
+      for(unsigned int i = 0; i< (timeGrid.GetSize()-1); ++i)
+      {
+          const double t0 = timeGrid(i);
+          const double t1 = timeGrid(i+1);
+          const double dt = t1 - t0;
+          const double m = (aif(i+1) - aif(i))/dt;
+          const double offset = aif(i) - m*t0;
+
+          const double* previous = convolution + i * numberOfSets;
+          double* current = convolution + (i + 1) * numberOfSets;
+
+          for (std::size_t s = 0; s < numberOfSets; ++s)
+          {
+              const double lambda = lambdas[s];
+              const double edt = exp(-lambda * dt);
+
+              current[s] = edt * previous[s]
+                         + offset/lambda * (1 - edt)
+                         + m/(lambda * lambda) * ((lambda * t1 - 1) - edt*(lambda * t0 - 1));
+          }
+      }
+  }
+
 
-  inline itk::Array<double> convoluteAIFWithConstant(mitk::ModelBase::TimeGridType timeGrid, mitk::AIFBasedModelBase::AterialInputFunctionType aif, double constant)
+  inline itk::Array<double> convoluteAIFWithConstant(const mitk::ModelBase::TimeGridType& timeGrid, const mitk::AIFBasedModelBase::AterialInputFunctionType& aif, double constant)
   {
       /** @brief Iterative Formula to Convolve aif(t) with a constant value by linear interpolation of the Aif between sampling points
        **/
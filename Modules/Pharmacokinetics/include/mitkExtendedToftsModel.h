@@ -66,6 +66,9 @@ namespace mitk
 
     ParamterUnitMapType GetParameterUnits() const override;
 
+    /** The model computes its derivatives analytically, see ComputeModelfunctionAndJacobian().*/
+    bool HasAnalyticJacobian() const override;
+
     ParameterNamesType GetDerivedParameterNames() const override;
 
     ParametersSizeType  GetNumberOfDerivedParameters() const override;
@@ -84,6 +87,12 @@ namespace mitk
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    ModelResultType ComputeModelfunctionAndJacobian(const ParametersType& parameters,
+        JacobianType& jacobian) const override;
+
+    void ComputeModelfunctionBatch(const ParameterValueType* parameters, std::size_t numberOfParameterSets,
+        SignalValueType* signals) const override;
+
     DerivedParameterMapType ComputeDerivedParameters(const mitk::ModelBase::ParametersType&
         parameters) const override;
 
@@ -82,6 +82,9 @@ namespace mitk
 
     ParamterUnitMapType GetParameterUnits() const override;
 
+    /** The model computes its derivatives analytically, see ComputeModelfunctionAndJacobian().*/
+    bool HasAnalyticJacobian() const override;
+
 
   protected:
     TwoCompartmentExchangeModel();
@@ -95,6 +98,12 @@ namespace mitk
 
     ModelResultType ComputeModelfunction(const ParametersType& parameters) const override;
 
+    ModelResultType ComputeModelfunctionAndJacobian(const ParametersType& parameters,
+        JacobianType& jacobian) const override;
+
+    void ComputeModelfunctionBatch(const ParameterValueType* parameters, std::size_t numberOfParameterSets,
+        SignalValueType* signals) const override;
+
     void PrintSelf(std::ostream& os, ::itk::Indent indent) const override;
 
   private:
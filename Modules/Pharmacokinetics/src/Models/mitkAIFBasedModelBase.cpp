@@ -74,6 +74,10 @@ mitk::AIFBasedModelBase::GetAterialInputFunction(TimeGridType CurrentTimeGrid) c
   {
     return this->m_AterialInputFunctionValues;
   }
+  else if (!m_AterialInputFunctionOnModelTimeGrid.empty() && CurrentTimeGrid == m_TimeGrid)
+  {
+    return m_AterialInputFunctionOnModelTimeGrid;
+  }
   else
   {
     return mitk::InterpolateSignalToNewTimeGrid(m_AterialInputFunctionValues,
@@ -81,6 +85,59 @@ mitk::AIFBasedModelBase::GetAterialInputFunction(TimeGridType CurrentTimeGrid) c
   }
 }
 
+const mitk::AIFBasedModelBase::AterialInputFunctionType&
+mitk::AIFBasedModelBase::GetAterialInputFunctionOnModelTimeGrid() const
+{
+  return m_AterialInputFunctionOnModelTimeGrid;
+}
+
+void mitk::AIFBasedModelBase::SetAterialInputFunctionValues(const AterialInputFunctionType& values)
+{
+  itkDebugMacro("setting AterialInputFunctionValues to " << values);
+
+  if (this->m_AterialInputFunctionValues != values)
+  {
+    this->m_AterialInputFunctionValues = values;
+    this->UpdateAterialInputFunctionOnModelTimeGrid();
+    this->Modified();
+  }
+}
+
+void mitk::AIFBasedModelBase::SetAterialInputFunctionTimeGrid(const TimeGridType& grid)
+{
+  itkDebugMacro("setting AterialInputFunctionTimeGrid to " << grid);
+
+  if (this->m_AterialInputFunctionTimeGrid != grid)
+  {
+    this->m_AterialInputFunctionTimeGrid = grid;
+    this->UpdateAterialInputFunctionOnModelTimeGrid();
+    this->Modified();
+  }
+}
+
+void mitk::AIFBasedModelBase::SetTimeGrid(const TimeGridType& grid)
+{
+  Superclass::SetTimeGrid(grid);
+  this->UpdateAterialInputFunctionOnModelTimeGrid();
+}
+
+void mitk::AIFBasedModelBase::UpdateAterialInputFunctionOnModelTimeGrid()
+{
+  const TimeGridType& aifTimeGrid = this->GetCurrentAterialInputFunctionTimeGrid();
+
+  if (m_TimeGrid.empty() || m_AterialInputFunctionValues.empty() ||
+      aifTimeGrid.GetSize() != m_AterialInputFunctionValues.GetSize())
+  {
+    //invalid state, see ValidateModel()
+    m_AterialInputFunctionOnModelTimeGrid.SetSize(0);
+  }
+  else
+  {
+    m_AterialInputFunctionOnModelTimeGrid =
+      mitk::InterpolateSignalToNewTimeGrid(m_AterialInputFunctionValues, aifTimeGrid, m_TimeGrid);
+  }
+}
+
 mitk::AIFBasedModelBase::ParameterNamesType mitk::AIFBasedModelBase::GetStaticParameterNames() const
 {
   ParameterNamesType result;
@@ -14,6 +14,7 @@ found in the LICENSE file.
 #include "mitkConvolutionHelper.h"
 #include <vnl/algo/vnl_fft_1d.h>
 #include <fstream>
+#include <vector>
 
 const std::string mitk::ExtendedToftsModel::MODEL_DISPLAY_NAME = "Extended Tofts Model";
 
@@ -113,8 +114,7 @@ mitk::ExtendedToftsModel::ModelResultType mitk::ExtendedToftsModel::ComputeModel
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+  const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
 
 
 
@@ -144,7 +144,7 @@ mitk::ExtendedToftsModel::ModelResultType mitk::ExtendedToftsModel::ComputeModel
   mitk::ModelBase::ModelResultType::const_iterator res = convolution.begin();
 
 
-  for (AterialInputFunctionType::iterator Cp = aterialInputFunction.begin();
+  for (AterialInputFunctionType::const_iterator Cp = aterialInputFunction.begin();
        Cp != aterialInputFunction.end(); ++res, ++signalPos, ++Cp)
   {
     *signalPos = (*Cp) * vp + ktrans * (*res);
@@ -155,6 +155,98 @@ mitk::ExtendedToftsModel::ModelResultType mitk::ExtendedToftsModel::ComputeModel
 }
 
 
+bool mitk::ExtendedToftsModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
+mitk::ExtendedToftsModel::ModelResultType mitk::ExtendedToftsModel::ComputeModelfunctionAndJacobian(
+  const ParametersType& parameters, JacobianType& jacobian) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
+
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //Model Parameters
+  double ktrans = parameters[POSITION_PARAMETER_Ktrans] / 6000.0;
+  double     ve = parameters[POSITION_PARAMETER_ve];
+  double     vp = parameters[POSITION_PARAMETER_vp];
+
+  if (ve == 0.0)
+  {
+    itkExceptionMacro("ve is 0! Cannot calculate signal");
+  }
+
+  double lambda = ktrans / ve;
+
+  mitk::ModelBase::ModelResultType convolution;
+  mitk::ModelBase::ModelResultType convolutionDerivative;
+  mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, lambda, convolution,
+      convolutionDerivative);
+
+  mitk::ModelBase::ModelResultType signal(timeSteps);
+
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    signal[i] = aterialInputFunction[i] * vp + ktrans * convolution[i];
+
+    //signal = vp * Cp + ktrans * conv(lambda) with lambda = ktrans/ve
+    jacobian[POSITION_PARAMETER_Ktrans][i] = (convolution[i] + lambda * convolutionDerivative[i]) / 6000.0;
+    jacobian[POSITION_PARAMETER_ve][i] = -ktrans * lambda / ve * convolutionDerivative[i];
+    jacobian[POSITION_PARAMETER_vp][i] = aterialInputFunction[i];
+  }
+
+  return signal;
+}
+
+void mitk::ExtendedToftsModel::ComputeModelfunctionBatch(const ParameterValueType* parameters,
+    std::size_t numberOfParameterSets, SignalValueType* signals) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
+
+  const ParameterValueType* ktransValues = parameters + POSITION_PARAMETER_Ktrans * numberOfParameterSets;
+  const ParameterValueType* veValues = parameters + POSITION_PARAMETER_ve * numberOfParameterSets;
+  const ParameterValueType* vpValues = parameters + POSITION_PARAMETER_vp * numberOfParameterSets;
+
+  std::vector<double> ktrans(numberOfParameterSets);
+  std::vector<double> lambdas(numberOfParameterSets);
+
+  for (std::size_t s = 0; s < numberOfParameterSets; ++s)
+  {
+    if (veValues[s] == 0.0)
+    {
+      itkExceptionMacro("ve is 0! Cannot calculate signal");
+    }
+
+    ktrans[s] = ktransValues[s] / 6000.0;
+    lambdas[s] = ktrans[s] / veValues[s];
+  }
+
+  mitk::convoluteAIFWithExponentials(this->m_TimeGrid, aterialInputFunction, lambdas.data(), numberOfParameterSets,
+      signals);
+
+  for (unsigned int i = 0; i < this->m_TimeGrid.GetSize(); ++i)
+  {
+    SignalValueType* signalsAtTimePoint = signals + i * numberOfParameterSets;
+    const double Cp = aterialInputFunction[i];
+
+    for (std::size_t s = 0; s < numberOfParameterSets; ++s)
+    {
+      signalsAtTimePoint[s] = Cp * vpValues[s] + ktrans[s] * signalsAtTimePoint[s];
+    }
+  }
+}
+
 mitk::ModelBase::DerivedParameterMapType mitk::ExtendedToftsModel::ComputeDerivedParameters(
   const mitk::ModelBase::ParametersType& parameters) const
 {
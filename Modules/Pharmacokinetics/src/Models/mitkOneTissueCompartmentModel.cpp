@@ -14,6 +14,7 @@ found in the LICENSE file.
 #include "mitkConvolutionHelper.h"
 #include <vnl/algo/vnl_fft_1d.h>
 #include <fstream>
+#include <vector>
 
 const std::string mitk::OneTissueCompartmentModel::MODEL_DISPLAY_NAME = "One Tissue Compartment Model";
 
@@ -84,8 +85,7 @@ mitk::OneTissueCompartmentModel::ModelResultType mitk::OneTissueCompartmentModel
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+  const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
 
 
 
@@ -120,6 +120,79 @@ mitk::OneTissueCompartmentModel::ModelResultType mitk::OneTissueCompartmentModel
 
 
 
+bool mitk::OneTissueCompartmentModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
+mitk::OneTissueCompartmentModel::ModelResultType mitk::OneTissueCompartmentModel::ComputeModelfunctionAndJacobian(
+  const ParametersType& parameters, JacobianType& jacobian) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
+
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //Model Parameters
+  double     K1 = (double) parameters[POSITION_PARAMETER_k1] / 60.0;
+  double     k2 = (double) parameters[POSITION_PARAMETER_k2] / 60.0;
+
+  mitk::ModelBase::ModelResultType convolution;
+  mitk::ModelBase::ModelResultType convolutionDerivative;
+  mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, k2, convolution,
+      convolutionDerivative);
+
+  mitk::ModelBase::ModelResultType signal(timeSteps);
+
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    signal[i] = K1 * convolution[i];
+
+    jacobian[POSITION_PARAMETER_k1][i] = convolution[i] / 60.0;
+    jacobian[POSITION_PARAMETER_k2][i] = K1 * convolutionDerivative[i] / 60.0;
+  }
+
+  return signal;
+}
+
+void mitk::OneTissueCompartmentModel::ComputeModelfunctionBatch(const ParameterValueType* parameters,
+    std::size_t numberOfParameterSets, SignalValueType* signals) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const ParameterValueType* K1Values = parameters + POSITION_PARAMETER_k1 * numberOfParameterSets;
+  const ParameterValueType* k2Values = parameters + POSITION_PARAMETER_k2 * numberOfParameterSets;
+
+  std::vector<double> K1(numberOfParameterSets);
+  std::vector<double> k2(numberOfParameterSets);
+
+  for (std::size_t s = 0; s < numberOfParameterSets; ++s)
+  {
+    K1[s] = K1Values[s] / 60.0;
+    k2[s] = k2Values[s] / 60.0;
+  }
+
+  mitk::convoluteAIFWithExponentials(this->m_TimeGrid, this->GetAterialInputFunctionOnModelTimeGrid(), k2.data(),
+      numberOfParameterSets, signals);
+
+  for (unsigned int i = 0; i < this->m_TimeGrid.GetSize(); ++i)
+  {
+    SignalValueType* signalsAtTimePoint = signals + i * numberOfParameterSets;
+
+    for (std::size_t s = 0; s < numberOfParameterSets; ++s)
+    {
+      signalsAtTimePoint[s] *= K1[s];
+    }
+  }
+}
+
 itk::LightObject::Pointer mitk::OneTissueCompartmentModel::InternalClone() const
 {
   OneTissueCompartmentModel::Pointer newClone = OneTissueCompartmentModel::New();
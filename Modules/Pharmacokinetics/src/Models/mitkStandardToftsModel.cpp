@@ -14,6 +14,7 @@ found in the LICENSE file.
 #include "mitkConvolutionHelper.h"
 #include <vnl/algo/vnl_fft_1d.h>
 #include <fstream>
+#include <vector>
 
 const std::string mitk::StandardToftsModel::MODEL_DISPLAY_NAME = "Standard Tofts Model";
 
@@ -105,8 +106,7 @@ mitk::StandardToftsModel::ModelResultType mitk::StandardToftsModel::ComputeModel
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+  const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
 
 
 
@@ -130,7 +130,7 @@ mitk::StandardToftsModel::ModelResultType mitk::StandardToftsModel::ComputeModel
   mitk::ModelBase::ModelResultType::const_iterator res = convolution.begin();
 
 
-  for (AterialInputFunctionType::iterator Cp = aterialInputFunction.begin();
+  for (AterialInputFunctionType::const_iterator Cp = aterialInputFunction.begin();
        Cp != aterialInputFunction.end(); ++res, ++signalPos, ++Cp)
   {
     *signalPos = ktrans * (*res);
@@ -141,6 +141,82 @@ mitk::StandardToftsModel::ModelResultType mitk::StandardToftsModel::ComputeModel
 }
 
 
+bool mitk::StandardToftsModel::HasAnalyticJacobian() const
+{
+  return true;
+};
+
+mitk::StandardToftsModel::ModelResultType mitk::StandardToftsModel::ComputeModelfunctionAndJacobian(
+  const ParametersType& parameters, JacobianType& jacobian) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
+
+  unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+  //Model Parameters
+  double ktrans = parameters[POSITION_PARAMETER_Ktrans] / 6000.0;
+  double     ve = parameters[POSITION_PARAMETER_ve];
+
+  double lambda = ktrans / ve;
+
+  mitk::ModelBase::ModelResultType convolution;
+  mitk::ModelBase::ModelResultType convolutionDerivative;
+  mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, lambda, convolution,
+      convolutionDerivative);
+
+  mitk::ModelBase::ModelResultType signal(timeSteps);
+
+  for (unsigned int i = 0; i < timeSteps; ++i)
+  {
+    signal[i] = ktrans * convolution[i];
+
+    //signal = ktrans * conv(lambda) with lambda = ktrans/ve
+    jacobian[POSITION_PARAMETER_Ktrans][i] = (convolution[i] + lambda * convolutionDerivative[i]) / 6000.0;
+    jacobian[POSITION_PARAMETER_ve][i] = -ktrans * lambda / ve * convolutionDerivative[i];
+  }
+
+  return signal;
+}
+
+void mitk::StandardToftsModel::ComputeModelfunctionBatch(const ParameterValueType* parameters,
+    std::size_t numberOfParameterSets, SignalValueType* signals) const
+{
+  if (this->m_TimeGrid.GetSize() == 0)
+  {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+  }
+
+  const ParameterValueType* ktransValues = parameters + POSITION_PARAMETER_Ktrans * numberOfParameterSets;
+  const ParameterValueType* veValues = parameters + POSITION_PARAMETER_ve * numberOfParameterSets;
+
+  std::vector<double> ktrans(numberOfParameterSets);
+  std::vector<double> lambdas(numberOfParameterSets);
+
+  for (std::size_t s = 0; s < numberOfParameterSets; ++s)
+  {
+    ktrans[s] = ktransValues[s] / 6000.0;
+    lambdas[s] = ktrans[s] / veValues[s];
+  }
+
+  mitk::convoluteAIFWithExponentials(this->m_TimeGrid, this->GetAterialInputFunctionOnModelTimeGrid(), lambdas.data(),
+      numberOfParameterSets, signals);
+
+  for (unsigned int i = 0; i < this->m_TimeGrid.GetSize(); ++i)
+  {
+    SignalValueType* signalsAtTimePoint = signals + i * numberOfParameterSets;
+
+    for (std::size_t s = 0; s < numberOfParameterSets; ++s)
+    {
+      signalsAtTimePoint[s] *= ktrans[s];
+    }
+  }
+}
+
 mitk::ModelBase::DerivedParameterMapType mitk::StandardToftsModel::ComputeDerivedParameters(
   const mitk::ModelBase::ParametersType& parameters) const
 {
@@ -13,6 +13,7 @@ found in the LICENSE file.
 #include "mitkTwoCompartmentExchangeModel.h"
 #include "mitkConvolutionHelper.h"
 #include <fstream>
+#include <vector>
 
 const std::string mitk::TwoCompartmentExchangeModel::MODEL_DISPLAY_NAME =
  "Two Compartment Exchange Model";
@@ -103,8 +104,7 @@ mitk::TwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& pa
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
     }
 
-    AterialInputFunctionType aterialInputFunction;
-    aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+    const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
 
     unsigned int timeSteps = this->m_TimeGrid.GetSize();
     mitk::ModelBase::ModelResultType signal(timeSteps);
@@ -161,6 +161,179 @@ mitk::TwoCompartmentExchangeModel::ComputeModelfunction(const ParametersType& pa
 }
 
 
+bool mitk::TwoCompartmentExchangeModel::HasAnalyticJacobian() const
+{
+  return true;
+}
+
+mitk::TwoCompartmentExchangeModel::ModelResultType
+mitk::TwoCompartmentExchangeModel::ComputeModelfunctionAndJacobian(const ParametersType& parameters,
+    JacobianType& jacobian) const
+{
+    typedef mitk::ModelBase::ModelResultType ConvolutionResultType;
+
+    if (this->m_TimeGrid.GetSize() == 0)
+    {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+    }
+
+    const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
+
+    unsigned int timeSteps = this->m_TimeGrid.GetSize();
+    mitk::ModelBase::ModelResultType signal(timeSteps);
+
+    //Model Parameters
+    double F = parameters[POSITION_PARAMETER_F] / 6000.0;
+    double PS  = parameters[POSITION_PARAMETER_PS] / 6000.0;
+    double ve = parameters[POSITION_PARAMETER_ve];
+    double vp = parameters[POSITION_PARAMETER_vp];
+
+    const unsigned int positions[4] = { POSITION_PARAMETER_F, POSITION_PARAMETER_PS, POSITION_PARAMETER_ve,
+                                        POSITION_PARAMETER_vp };
+    //F and PS are passed in ml/min/100ml
+    const double scales[4] = { 1 / 6000.0, 1 / 6000.0, 1.0, 1.0 };
+
+    if(PS != 0)
+    {
+        //Kp/m = 0.5 * (a +/- sqrt(a^2 - 4b)), with a = 1/Tp + 1/Te and b = 1/(Te*Tb) (see ComputeModelfunction)
+        double a = (PS + F) / vp + PS / ve;
+        double b = (PS / ve) * (F / vp);
+        double D = sqrt(a * a - 4 * b);
+
+        double Kp = 0.5 * (a + D);
+        double Km = 0.5 * (a - D);
+        double h = F / vp;
+        double E = (Kp - h) / D;
+
+        ConvolutionResultType expp, exppDerivative;
+        ConvolutionResultType expm, expmDerivative;
+        mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, Kp, expp, exppDerivative);
+        mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, Km, expm, expmDerivative);
+
+        for (unsigned int i = 0; i < timeSteps; ++i)
+        {
+            signal[i] = F * (expp[i] + E * (expm[i] - expp[i]));
+        }
+
+        //derivatives of a, b and h with respect to F, PS, ve and vp
+        const double da[4] = { 1 / vp, 1 / vp + 1 / ve, -PS / (ve * ve), -(PS + F) / (vp * vp) };
+        const double db[4] = { PS / (ve * vp), F / (ve * vp), -b / ve, -b / vp };
+        const double dh[4] = { 1 / vp, 0.0, 0.0, -F / (vp * vp) };
+
+        for (unsigned int p = 0; p < 4; ++p)
+        {
+            double dD = (a * da[p] - 2 * db[p]) / D;
+            double dKp = 0.5 * (da[p] + dD);
+            double dKm = 0.5 * (da[p] - dD);
+            double dE = ((dKp - dh[p]) * D - (Kp - h) * dD) / (D * D);
+
+            for (unsigned int i = 0; i < timeSteps; ++i)
+            {
+                double derivative = F * (dE * (expm[i] - expp[i]) + (1 - E) * exppDerivative[i] * dKp
+                                         + E * expmDerivative[i] * dKm);
+                if (p == 0)
+                {
+                    derivative += (1 - E) * expp[i] + E * expm[i];
+                }
+
+                jacobian[positions[p]][i] = scales[p] * derivative;
+            }
+        }
+    }
+    else
+    {
+        double Kp = F/vp;
+        ConvolutionResultType exp, expDerivative;
+        mitk::convoluteAIFWithExponentialAndDerivative(this->m_TimeGrid, aterialInputFunction, Kp, exp, expDerivative);
+
+        //The derivative with respect to PS is the one sided limit for PS -> 0. In this limit
+        //Km -> 0, thus the convolution with exp(-Km*t) becomes the integral of the (piecewise linear) AIF.
+        double aifIntegral = 0.0;
+
+        for (unsigned int i = 0; i < timeSteps; ++i)
+        {
+            if (i > 0)
+            {
+                aifIntegral += 0.5 * (aterialInputFunction[i - 1] + aterialInputFunction[i]) *
+                               (this->m_TimeGrid[i] - this->m_TimeGrid[i - 1]);
+            }
+
+            signal[i] = F * exp[i];
+
+            jacobian[POSITION_PARAMETER_F][i] = scales[0] * (exp[i] + F / vp * expDerivative[i]);
+            jacobian[POSITION_PARAMETER_PS][i] = scales[1] * (aifIntegral - exp[i] + F / vp * expDerivative[i]);
+            jacobian[POSITION_PARAMETER_ve][i] = 0.0;
+            jacobian[POSITION_PARAMETER_vp][i] = -F * F / (vp * vp) * expDerivative[i];
+        }
+    }
+
+    return signal;
+}
+
+void mitk::TwoCompartmentExchangeModel::ComputeModelfunctionBatch(const ParameterValueType* parameters,
+    std::size_t numberOfParameterSets, SignalValueType* signals) const
+{
+    if (this->m_TimeGrid.GetSize() == 0)
+    {
+    itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
+    }
+
+    const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
+    const unsigned int timeSteps = this->m_TimeGrid.GetSize();
+
+    const ParameterValueType* FValues = parameters + POSITION_PARAMETER_F * numberOfParameterSets;
+    const ParameterValueType* PSValues = parameters + POSITION_PARAMETER_PS * numberOfParameterSets;
+    const ParameterValueType* veValues = parameters + POSITION_PARAMETER_ve * numberOfParameterSets;
+    const ParameterValueType* vpValues = parameters + POSITION_PARAMETER_vp * numberOfParameterSets;
+
+    std::vector<double> F(numberOfParameterSets);
+    std::vector<double> E(numberOfParameterSets);
+    std::vector<double> Kp(numberOfParameterSets);
+    std::vector<double> Km(numberOfParameterSets);
+
+    for (std::size_t s = 0; s < numberOfParameterSets; ++s)
+    {
+        F[s] = FValues[s] / 6000.0;
+        double PS = PSValues[s] / 6000.0;
+        double ve = veValues[s];
+        double vp = vpValues[s];
+
+        if (PS != 0)
+        {
+            double Tp = vp/(PS + F[s]);
+            double Te = ve/PS;
+            double Tb = vp/F[s];
+
+            Kp[s] = 0.5 *( 1/Tp + 1/Te + sqrt(( 1/Tp + 1/Te )*( 1/Tp + 1/Te ) - 4 * 1/Te*1/Tb) );
+            Km[s] = 0.5 *( 1/Tp + 1/Te - sqrt(( 1/Tp + 1/Te )*( 1/Tp + 1/Te ) - 4 * 1/Te*1/Tb) );
+            E[s] = ( Kp[s] - 1/Tb )/( Kp[s] - Km[s] );
+        }
+        else
+        {
+            //single exponential; Km is irrelevant because E is 0
+            Kp[s] = F[s]/vp;
+            Km[s] = Kp[s];
+            E[s] = 0.0;
+        }
+    }
+
+    std::vector<double> expm(timeSteps * numberOfParameterSets);
+    mitk::convoluteAIFWithExponentials(this->m_TimeGrid, aterialInputFunction, Kp.data(), numberOfParameterSets, signals);
+    mitk::convoluteAIFWithExponentials(this->m_TimeGrid, aterialInputFunction, Km.data(), numberOfParameterSets,
+        expm.data());
+
+    for (unsigned int i = 0; i < timeSteps; ++i)
+    {
+        SignalValueType* signalsAtTimePoint = signals + i * numberOfParameterSets;
+        const double* expmAtTimePoint = expm.data() + i * numberOfParameterSets;
+
+        for (std::size_t s = 0; s < numberOfParameterSets; ++s)
+        {
+            signalsAtTimePoint[s] = F[s] * (signalsAtTimePoint[s] + E[s] * (expmAtTimePoint[s] - signalsAtTimePoint[s]));
+        }
+    }
+}
+
 itk::LightObject::Pointer mitk::TwoCompartmentExchangeModel::InternalClone() const
 {
   TwoCompartmentExchangeModel::Pointer newClone = TwoCompartmentExchangeModel::New();
@@ -103,8 +103,7 @@ mitk::TwoTissueCompartmentModel::ComputeModelfunction(const ParametersType& para
     itkExceptionMacro("No Time Grid Set! Cannot Calculate Signal");
   }
 
-  AterialInputFunctionType aterialInputFunction;
-  aterialInputFunction = GetAterialInputFunction(this->m_TimeGrid);
+  const AterialInputFunctionType& aterialInputFunction = this->GetAterialInputFunctionOnModelTimeGrid();
 
 
   unsigned int timeSteps = this->m_TimeGrid.GetSize();
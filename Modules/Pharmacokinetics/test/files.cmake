@@ -4,4 +4,11 @@ SET(MODULE_TESTS
   #ConvertToConcentrationTest.cpp
   mitkTwoCompartmentExchangeModelTest.cpp
   mitkExtendedToftsModelTest.cpp
+  mitkAIFBasedModelJacobianTest.cpp
+)
+
+# Benchmarks are built into the test driver, but not registered with ctest.
+# Run them explicitly, e.g. MitkPharmacokineticsTestDriver mitkAIFBasedModelJacobianBenchmarkTest
+SET(MODULE_CUSTOM_TESTS
+  mitkAIFBasedModelJacobianBenchmarkTest.cpp
 )
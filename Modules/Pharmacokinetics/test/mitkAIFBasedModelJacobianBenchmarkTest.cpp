@@ -0,0 +1,130 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Benchmark, not part of the ctest set. Run it explicitly:
+//   MitkPharmacokineticsTestDriver mitkAIFBasedModelJacobianBenchmarkTest
+
+// Testing
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+//MITK includes
+#include "mitkStandardToftsModel.h"
+#include "mitkLevenbergMarquardtModelFitFunctor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/** Fits the standard Tofts model to a noise free synthetic DCE phantom with numerical and analytic derivatives
+ * and reports the batch evaluation time, the fitted voxels per second and the mean relative Ktrans error.*/
+class mitkAIFBasedModelJacobianBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkAIFBasedModelJacobianBenchmarkTestSuite);
+  MITK_TEST(FitBenchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::ModelBase::TimeGridType m_Grid;
+  mitk::AIFBasedModelBase::AterialInputFunctionType m_AIF;
+
+  static mitk::ModelBase::ParametersType MakeParameters(std::initializer_list<double> values)
+  {
+    mitk::ModelBase::ParametersType parameters(values.size());
+    std::copy(values.begin(), values.end(), parameters.begin());
+    return parameters;
+  }
+
+public:
+  void setUp() override
+  {
+    // 60 frames, 5 s between frames
+    m_Grid.SetSize(60);
+    m_AIF.SetSize(60);
+
+    // AIF from Weinmann, H. J., Laniado, M., and W.Mutzel (1984), bolus arrival after 30 s
+    for (unsigned int i = 0; i < 60; ++i)
+    {
+      m_Grid[i] = 5.0 * i;
+      const double t = m_Grid[i] - 30.0;
+      m_AIF[i] = t < 0 ? 0.0 : 3.99 * exp(-0.144 * t) + 4.78 * exp(-0.0111 * t);
+    }
+  }
+
+  void tearDown() override {}
+
+  void FitBenchmark()
+  {
+    const unsigned int numberOfVoxels = 500;
+
+    auto model = mitk::StandardToftsModel::New();
+    model->SetTimeGrid(m_Grid);
+    model->SetAterialInputFunctionValues(m_AIF);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> ktransDistribution(5.0, 60.0);
+    std::uniform_real_distribution<double> veDistribution(0.1, 0.6);
+
+    std::vector<double> phantomParameters(2 * numberOfVoxels);
+    for (unsigned int v = 0; v < numberOfVoxels; ++v)
+    {
+      phantomParameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans * numberOfVoxels + v] =
+        ktransDistribution(generator);
+      phantomParameters[mitk::StandardToftsModel::POSITION_PARAMETER_ve * numberOfVoxels + v] =
+        veDistribution(generator);
+    }
+
+    std::vector<double> phantom(m_Grid.GetSize() * numberOfVoxels);
+    auto start = std::chrono::steady_clock::now();
+    model->GetSignalBatch(phantomParameters.data(), numberOfVoxels, phantom.data());
+    auto batchTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    MITK_INFO << "Batch evaluation of " << numberOfVoxels << " voxels: " << batchTime << " s";
+
+    const auto initialParameters = MakeParameters({ 20.0, 0.3 });
+
+    double fitTimes[2] = { 0.0, 0.0 };
+    double meanErrors[2] = { 0.0, 0.0 };
+
+    for (unsigned int mode = 0; mode < 2; ++mode)
+    {
+      auto functor = mitk::LevenbergMarquardtModelFitFunctor::New();
+      functor->SetUseAnalyticDerivatives(mode == 1);
+
+      start = std::chrono::steady_clock::now();
+      for (unsigned int v = 0; v < numberOfVoxels; ++v)
+      {
+        mitk::ModelFitFunctorBase::InputPixelArrayType sample(m_Grid.GetSize());
+        for (unsigned int i = 0; i < m_Grid.GetSize(); ++i)
+        {
+          sample[i] = phantom[i * numberOfVoxels + v];
+        }
+
+        const auto result = functor->Compute(sample, model, initialParameters);
+        const double expectedKtrans =
+          phantomParameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans * numberOfVoxels + v];
+        meanErrors[mode] +=
+          std::abs(result[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans] - expectedKtrans) / expectedKtrans;
+      }
+      fitTimes[mode] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      meanErrors[mode] /= numberOfVoxels;
+    }
+
+    MITK_INFO << "Tofts fit, numeric derivatives: " << numberOfVoxels / fitTimes[0]
+              << " voxels/s; mean relative Ktrans error: " << meanErrors[0];
+    MITK_INFO << "Tofts fit, analytic derivatives: " << numberOfVoxels / fitTimes[1]
+              << " voxels/s; mean relative Ktrans error: " << meanErrors[1];
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkAIFBasedModelJacobianBenchmark)
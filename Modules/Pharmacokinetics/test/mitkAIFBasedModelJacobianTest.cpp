@@ -0,0 +1,309 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+//MITK includes
+#include "mitkStandardToftsModel.h"
+#include "mitkExtendedToftsModel.h"
+#include "mitkTwoCompartmentExchangeModel.h"
+#include "mitkOneTissueCompartmentModel.h"
+#include "mitkLevenbergMarquardtModelFitFunctor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/** Checks the analytic Jacobians and the batch evaluation of the AIF based models against the numerical
+ * derivatives and the single evaluation. The fitting benchmark on a synthetic DCE phantom
+ * is mitkAIFBasedModelJacobianBenchmarkTest.*/
+class mitkAIFBasedModelJacobianTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkAIFBasedModelJacobianTestSuite);
+  MITK_TEST(StandardToftsJacobianTest);
+  MITK_TEST(ExtendedToftsJacobianTest);
+  MITK_TEST(TwoCompartmentExchangeJacobianTest);
+  MITK_TEST(TwoCompartmentExchangeWithoutExchangeJacobianTest);
+  MITK_TEST(OneTissueCompartmentJacobianTest);
+  MITK_TEST(BatchEvaluationTest);
+  MITK_TEST(AterialInputFunctionCacheTest);
+  MITK_TEST(AnalyticDerivativesFitTest);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::ModelBase::TimeGridType m_Grid;
+  mitk::AIFBasedModelBase::AterialInputFunctionType m_AIF;
+
+  template <typename TModel>
+  typename TModel::Pointer CreateModel() const
+  {
+    typename TModel::Pointer model = TModel::New();
+    model->SetTimeGrid(m_Grid);
+    model->SetAterialInputFunctionValues(m_AIF);
+    return model;
+  }
+
+  /** Compares the analytic Jacobian with central differences of GetSignal().*/
+  void CheckJacobian(const mitk::ModelBase* model, const mitk::ModelBase::ParametersType& parameters) const
+  {
+    CPPUNIT_ASSERT(model->HasAnalyticJacobian());
+
+    mitk::ModelBase::JacobianType jacobian;
+    mitk::ModelBase::ModelResultType signal = model->GetSignalAndJacobian(parameters, jacobian);
+    mitk::ModelBase::ModelResultType referenceSignal = model->GetSignal(parameters);
+
+    CPPUNIT_ASSERT_EQUAL(referenceSignal.GetSize(), signal.GetSize());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(parameters.GetSize()), jacobian.rows());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(signal.GetSize()), jacobian.cols());
+
+    for (unsigned int i = 0; i < signal.GetSize(); ++i)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(referenceSignal[i], signal[i], 1e-12);
+    }
+
+    for (unsigned int p = 0; p < parameters.GetSize(); ++p)
+    {
+      const double step = 1e-6 * std::max(1.0, std::abs(parameters[p]));
+
+      mitk::ModelBase::ParametersType lower = parameters;
+      mitk::ModelBase::ParametersType upper = parameters;
+      lower[p] -= step;
+      upper[p] += step;
+
+      mitk::ModelBase::ModelResultType lowerSignal = model->GetSignal(lower);
+      mitk::ModelBase::ModelResultType upperSignal = model->GetSignal(upper);
+
+      double maximum = 0.0;
+      for (unsigned int i = 0; i < signal.GetSize(); ++i)
+      {
+        maximum = std::max(maximum, std::abs(jacobian[p][i]));
+      }
+
+      for (unsigned int i = 0; i < signal.GetSize(); ++i)
+      {
+        const double numeric = (upperSignal[i] - lowerSignal[i]) / (2 * step);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Analytic derivative of parameter " + std::to_string(p) +
+                                             " at time point " + std::to_string(i) + " matches numeric one.",
+                                             numeric, jacobian[p][i], 1e-5 * maximum + 1e-10);
+      }
+    }
+  }
+
+  /** Compares GetSignalBatch() with GetSignal() for the passed parameter sets.*/
+  void CheckBatch(const mitk::ModelBase* model, const std::vector<mitk::ModelBase::ParametersType>& parameterSets) const
+  {
+    const std::size_t numberOfSets = parameterSets.size();
+    const unsigned int numberOfParameters = model->GetNumberOfParameters();
+
+    std::vector<double> parameters(numberOfParameters * numberOfSets);
+    for (std::size_t s = 0; s < numberOfSets; ++s)
+    {
+      for (unsigned int p = 0; p < numberOfParameters; ++p)
+      {
+        parameters[p * numberOfSets + s] = parameterSets[s][p];
+      }
+    }
+
+    std::vector<double> signals(m_Grid.GetSize() * numberOfSets);
+    model->GetSignalBatch(parameters.data(), numberOfSets, signals.data());
+
+    for (std::size_t s = 0; s < numberOfSets; ++s)
+    {
+      mitk::ModelBase::ModelResultType signal = model->GetSignal(parameterSets[s]);
+      for (unsigned int i = 0; i < signal.GetSize(); ++i)
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(signal[i], signals[i * numberOfSets + s], 1e-12 + 1e-10 * std::abs(signal[i]));
+      }
+    }
+  }
+
+  static mitk::ModelBase::ParametersType MakeParameters(std::initializer_list<double> values)
+  {
+    mitk::ModelBase::ParametersType parameters(values.size());
+    std::copy(values.begin(), values.end(), parameters.begin());
+    return parameters;
+  }
+
+public:
+  void setUp() override
+  {
+    // 60 frames, 5 s between frames
+    m_Grid.SetSize(60);
+    m_AIF.SetSize(60);
+
+    // AIF from Weinmann, H. J., Laniado, M., and W.Mutzel (1984), bolus arrival after 30 s
+    for (unsigned int i = 0; i < 60; ++i)
+    {
+      m_Grid[i] = 5.0 * i;
+      const double t = m_Grid[i] - 30.0;
+      m_AIF[i] = t < 0 ? 0.0 : 3.99 * exp(-0.144 * t) + 4.78 * exp(-0.0111 * t);
+    }
+  }
+
+  void tearDown() override {}
+
+  void StandardToftsJacobianTest()
+  {
+    auto model = CreateModel<mitk::StandardToftsModel>();
+    CheckJacobian(model, MakeParameters({ 35.0, 0.5 }));
+    CheckJacobian(model, MakeParameters({ 5.0, 0.1 }));
+  }
+
+  void ExtendedToftsJacobianTest()
+  {
+    auto model = CreateModel<mitk::ExtendedToftsModel>();
+    CheckJacobian(model, MakeParameters({ 35.0, 0.5, 0.05 }));
+    CheckJacobian(model, MakeParameters({ 12.0, 0.2, 0.1 }));
+  }
+
+  void TwoCompartmentExchangeJacobianTest()
+  {
+    auto model = CreateModel<mitk::TwoCompartmentExchangeModel>();
+    CheckJacobian(model, MakeParameters({ 60.0, 20.0, 0.3, 0.05 }));
+    CheckJacobian(model, MakeParameters({ 120.0, 5.0, 0.1, 0.1 }));
+  }
+
+  void TwoCompartmentExchangeWithoutExchangeJacobianTest()
+  {
+    auto model = CreateModel<mitk::TwoCompartmentExchangeModel>();
+    const auto parameters = MakeParameters({ 60.0, 0.0, 0.3, 0.05 });
+
+    mitk::ModelBase::JacobianType jacobian;
+    mitk::ModelBase::ModelResultType signal = model->GetSignalAndJacobian(parameters, jacobian);
+
+    // PS is at the boundary of the model (PS = 0 switches to the one compartment solution), thus its derivative
+    // is compared to the (analytic) derivative for a small PS.
+    mitk::ModelBase::JacobianType smallPSJacobian;
+    model->GetSignalAndJacobian(MakeParameters({ 60.0, 0.01, 0.3, 0.05 }), smallPSJacobian);
+
+    for (unsigned int i = 0; i < signal.GetSize(); ++i)
+    {
+      const double expected = smallPSJacobian[mitk::TwoCompartmentExchangeModel::POSITION_PARAMETER_PS][i];
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, jacobian[mitk::TwoCompartmentExchangeModel::POSITION_PARAMETER_PS][i],
+                                   1e-3 * std::abs(expected) + 1e-8);
+      CPPUNIT_ASSERT_EQUAL(0.0, jacobian[mitk::TwoCompartmentExchangeModel::POSITION_PARAMETER_ve][i]);
+    }
+  }
+
+  void OneTissueCompartmentJacobianTest()
+  {
+    auto model = CreateModel<mitk::OneTissueCompartmentModel>();
+    CheckJacobian(model, MakeParameters({ 0.5, 0.2 }));
+    CheckJacobian(model, MakeParameters({ 2.0, 1.5 }));
+  }
+
+  void BatchEvaluationTest()
+  {
+    CheckBatch(CreateModel<mitk::StandardToftsModel>(),
+               { MakeParameters({ 35.0, 0.5 }), MakeParameters({ 5.0, 0.1 }), MakeParameters({ 80.0, 0.9 }) });
+    CheckBatch(CreateModel<mitk::ExtendedToftsModel>(),
+               { MakeParameters({ 35.0, 0.5, 0.05 }), MakeParameters({ 12.0, 0.2, 0.1 }) });
+    CheckBatch(CreateModel<mitk::TwoCompartmentExchangeModel>(),
+               { MakeParameters({ 60.0, 20.0, 0.3, 0.05 }), MakeParameters({ 60.0, 0.0, 0.3, 0.05 }) });
+    CheckBatch(CreateModel<mitk::OneTissueCompartmentModel>(),
+               { MakeParameters({ 0.5, 0.2 }), MakeParameters({ 2.0, 1.5 }) });
+  }
+
+  void AterialInputFunctionCacheTest()
+  {
+    auto model = CreateModel<mitk::StandardToftsModel>();
+    const auto parameters = MakeParameters({ 35.0, 0.5 });
+
+    CPPUNIT_ASSERT(m_AIF == model->GetAterialInputFunctionOnModelTimeGrid());
+    mitk::ModelBase::ModelResultType signal = model->GetSignal(parameters);
+
+    // changing the AIF must update the cached interpolation
+    mitk::AIFBasedModelBase::AterialInputFunctionType doubledAIF = m_AIF;
+    for (auto& value : doubledAIF)
+    {
+      value *= 2.0;
+    }
+    model->SetAterialInputFunctionValues(doubledAIF);
+    mitk::ModelBase::ModelResultType doubledSignal = model->GetSignal(parameters);
+
+    for (unsigned int i = 0; i < signal.GetSize(); ++i)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0 * signal[i], doubledSignal[i], 1e-12);
+    }
+
+    // changing the model time grid must update the cached interpolation
+    mitk::ModelBase::TimeGridType aifGrid = m_Grid;
+    model->SetAterialInputFunctionTimeGrid(aifGrid);
+    mitk::ModelBase::TimeGridType shiftedGrid = m_Grid;
+    for (unsigned int i = 0; i < shiftedGrid.GetSize() - 1; ++i)
+    {
+      shiftedGrid[i] += 2.5;
+    }
+    model->SetTimeGrid(shiftedGrid);
+
+    CPPUNIT_ASSERT(model->GetAterialInputFunction(shiftedGrid) == model->GetAterialInputFunctionOnModelTimeGrid());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5 * (doubledAIF[10] + doubledAIF[11]),
+                                 model->GetAterialInputFunctionOnModelTimeGrid()[10], 1e-12);
+
+    // invalid configuration: no cache, validation fails
+    model->SetAterialInputFunctionValues(mitk::AIFBasedModelBase::AterialInputFunctionType(3));
+    CPPUNIT_ASSERT(model->GetAterialInputFunctionOnModelTimeGrid().empty());
+    CPPUNIT_ASSERT_THROW(model->GetSignal(parameters), itk::ExceptionObject);
+  }
+
+  /** Fits the standard Tofts model with analytic derivatives to a noise free synthetic DCE phantom.*/
+  void AnalyticDerivativesFitTest()
+  {
+    const unsigned int numberOfVoxels = 500;
+
+    auto model = CreateModel<mitk::StandardToftsModel>();
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> ktransDistribution(5.0, 60.0);
+    std::uniform_real_distribution<double> veDistribution(0.1, 0.6);
+
+    std::vector<double> phantomParameters(2 * numberOfVoxels);
+    for (unsigned int v = 0; v < numberOfVoxels; ++v)
+    {
+      phantomParameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans * numberOfVoxels + v] =
+        ktransDistribution(generator);
+      phantomParameters[mitk::StandardToftsModel::POSITION_PARAMETER_ve * numberOfVoxels + v] =
+        veDistribution(generator);
+    }
+
+    std::vector<double> phantom(m_Grid.GetSize() * numberOfVoxels);
+    model->GetSignalBatch(phantomParameters.data(), numberOfVoxels, phantom.data());
+
+    const auto initialParameters = MakeParameters({ 20.0, 0.3 });
+
+    auto functor = mitk::LevenbergMarquardtModelFitFunctor::New();
+    functor->SetUseAnalyticDerivatives(true);
+
+    double meanError = 0.0;
+    for (unsigned int v = 0; v < numberOfVoxels; ++v)
+    {
+      mitk::ModelFitFunctorBase::InputPixelArrayType sample(m_Grid.GetSize());
+      for (unsigned int i = 0; i < m_Grid.GetSize(); ++i)
+      {
+        sample[i] = phantom[i * numberOfVoxels + v];
+      }
+
+      const auto result = functor->Compute(sample, model, initialParameters);
+      const double expectedKtrans =
+        phantomParameters[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans * numberOfVoxels + v];
+      meanError += std::abs(result[mitk::StandardToftsModel::POSITION_PARAMETER_Ktrans] - expectedKtrans) / expectedKtrans;
+    }
+    meanError /= numberOfVoxels;
+
+    CPPUNIT_ASSERT_MESSAGE("Fit with analytic derivatives recovers the phantom.", meanError < 0.05);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkAIFBasedModelJacobian)
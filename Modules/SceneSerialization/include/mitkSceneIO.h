@@ -29,6 +29,7 @@ namespace tinyxml2
 namespace mitk
 {
   class BaseData;
+  class BaseDataSerializer;
   class PropertyList;
 
   class MITKSCENESERIALIZATION_EXPORT SceneIO : public itk::Object
@@ -115,14 +116,39 @@ namespace mitk
      */
     const PropertyList *GetFailedProperties();
 
+    /**
+     * \brief Number of threads used to (de)serialize the BaseData of nodes and to unpack scene files.
+     *
+     * BaseData objects are serialized and read concurrently, while the scene file is written and the
+     * DataStorage is populated on the calling thread, in node order. 0 (default) uses one thread per
+     * hardware thread, 1 processes all nodes on the calling thread.
+     */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
   protected:
     SceneIO();
     ~SceneIO() override;
 
     std::string CreateEmptyTempDirectory();
 
-    tinyxml2::XMLElement *SaveBaseData(tinyxml2::XMLDocument &doc, BaseData *data, const std::string &filenamehint, bool &error);
-    tinyxml2::XMLElement *SavePropertyList(tinyxml2::XMLDocument &doc, PropertyList *propertyList, const std::string &filenamehint);
+    /**
+     * \brief Find a serializer for data, which writes into workingDirectory.
+     * \return nullptr if there is no serializer for the type of data.
+     */
+    itk::SmartPointer<BaseDataSerializer> CreateBaseDataSerializer(BaseData *data,
+                                                                   const std::string &filenamehint,
+                                                                   const std::string &workingDirectory);
+    tinyxml2::XMLElement *SavePropertyList(tinyxml2::XMLDocument &doc,
+                                           PropertyList *propertyList,
+                                           const std::string &filenamehint,
+                                           const std::string &workingDirectory);
+
+    /**
+     * \brief Unpack all entries of the scene file concurrently into m_WorkingDirectory.
+     * \return False if the entries of the scene file could not be listed.
+     */
+    bool DecompressEntries(const std::string &filename);
 
     void OnUnzipError(const void *pSender, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string> &info);
     void OnUnzipOk(const void *pSender, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path> &info);
@@ -132,6 +158,7 @@ namespace mitk
 
     std::string m_WorkingDirectory;
     unsigned int m_UnzipErrors;
+    unsigned int m_NumberOfThreads;
   };
 }
 
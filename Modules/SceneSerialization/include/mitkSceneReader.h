@@ -31,5 +31,12 @@ namespace mitk
     itkCloneMacro(Self);
 
     virtual bool LoadScene(tinyxml2::XMLDocument &document, const std::string &workingDirectory, DataStorage *storage);
+
+    /** \brief Number of threads used to read the BaseData of nodes (0: one per hardware thread).*/
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+  protected:
+    unsigned int m_NumberOfThreads = 0;
   };
 }
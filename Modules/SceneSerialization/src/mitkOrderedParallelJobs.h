@@ -0,0 +1,154 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkOrderedParallelJobs_h
+#define mitkOrderedParallelJobs_h
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief Runs numberOfJobs jobs on worker threads and finishes them on the calling thread in ascending order.
+   *
+   * job(i) is called on one of numberOfThreads worker threads (0 means one per hardware thread), finished(i)
+   * is called on the calling thread as soon as jobs 0 to i are done. Thus, everything that must not be done
+   * concurrently (writing an archive, adding nodes to a DataStorage, the ProgressBar) goes into finished.
+   *
+   * Workers do not start jobs more than two jobs per thread ahead of the last finished one, which limits the
+   * number of intermediate results held at any time.
+   *
+   * An exception thrown by job(i) is rethrown on the calling thread instead of calling finished(i). Pending
+   * jobs are not started after an exception and all workers are joined before it is propagated.
+   */
+  inline void RunOrderedParallelJobs(std::size_t numberOfJobs,
+                                     unsigned int numberOfThreads,
+                                     const std::function<void(std::size_t)> &job,
+                                     const std::function<void(std::size_t)> &finished)
+  {
+    if (0 == numberOfThreads)
+      numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    numberOfThreads = static_cast<unsigned int>(std::min<std::size_t>(numberOfThreads, numberOfJobs));
+
+    if (numberOfThreads <= 1)
+    {
+      for (std::size_t i = 0; i < numberOfJobs; ++i)
+      {
+        job(i);
+        finished(i);
+      }
+      return;
+    }
+
+    const std::size_t maximumLookAhead = 2 * numberOfThreads;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t nextJob = 0;
+    std::size_t numberOfFinishedJobs = 0;
+    bool cancelled = false;
+    std::vector<char> done(numberOfJobs, 0);
+    std::vector<std::exception_ptr> exceptions(numberOfJobs);
+
+    auto worker = [&]() {
+      for (;;)
+      {
+        std::size_t i = 0;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          condition.wait(lock, [&]() {
+            return cancelled || nextJob >= numberOfJobs || nextJob < numberOfFinishedJobs + maximumLookAhead;
+          });
+
+          if (cancelled || nextJob >= numberOfJobs)
+            return;
+
+          i = nextJob++;
+        }
+
+        try
+        {
+          job(i);
+        }
+        catch (...)
+        {
+          exceptions[i] = std::current_exception();
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          done[i] = 1;
+        }
+        condition.notify_all();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads);
+
+    auto joinAll = [&](bool cancel) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = cancelled || cancel;
+      }
+      condition.notify_all();
+
+      for (auto &thread : threads)
+      {
+        if (thread.joinable())
+          thread.join();
+      }
+    };
+
+    try
+    {
+      for (unsigned int t = 0; t < numberOfThreads; ++t)
+        threads.emplace_back(worker);
+
+      for (std::size_t i = 0; i < numberOfJobs; ++i)
+      {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          condition.wait(lock, [&]() { return 0 != done[i]; });
+        }
+
+        if (exceptions[i])
+          std::rethrow_exception(exceptions[i]);
+
+        finished(i);
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          ++numberOfFinishedJobs;
+        }
+        condition.notify_all();
+      }
+    }
+    catch (...)
+    {
+      joinAll(true);
+      throw;
+    }
+
+    joinAll(false);
+  }
+}
+
+#endif
@@ -11,12 +11,17 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include <Poco/Delegate.h>
+#include <Poco/Exception.h>
 #include <Poco/Path.h>
+#include <Poco/StreamCopier.h>
 #include <Poco/TemporaryFile.h>
 #include <Poco/Zip/Compress.h>
 #include <Poco/Zip/Decompress.h>
+#include <Poco/Zip/ZipArchive.h>
+#include <Poco/Zip/ZipStream.h>
 
 #include "mitkBaseDataSerializer.h"
+#include "mitkOrderedParallelJobs.h"
 #include "mitkPropertyListSerializer.h"
 #include "mitkSceneIO.h"
 #include "mitkSceneReader.h"
@@ -30,15 +35,55 @@ found in the LICENSE file.
 
 #include <itkObjectFactoryBase.h>
 
+#include <atomic>
 #include <fstream>
 #include <mitkIOUtil.h>
+#include <set>
 #include <sstream>
 
 #include "itksys/SystemTools.hxx"
 
 #include <tinyxml2.h>
 
-mitk::SceneIO::SceneIO() : m_WorkingDirectory(""), m_UnzipErrors(0)
+namespace
+{
+  // payloads that are compressed by their writers are stored as they are, compressing them again costs
+  // time without making the scene file any smaller
+  std::set<std::string> GetExtensionsOfCompressedPayloads()
+  {
+    return {"nrrd", "vtp", "gz", "png", "jpg", "jpeg", "zip", "mitk"};
+  }
+
+  // rejects absolute entry names and entries that point outside of the working directory
+  bool IsValidEntryName(const std::string &name)
+  {
+    const Poco::Path path(name, Poco::Path::PATH_UNIX);
+
+    if (path.isAbsolute() || path.getFileName() == "..")
+      return false;
+
+    for (int i = 0; i < path.depth(); ++i)
+    {
+      if (path[i] == "..")
+        return false;
+    }
+
+    return true;
+  }
+
+  // everything a single node is serialized into
+  struct NodeSerialization
+  {
+    mitk::DataNode *Node = nullptr;
+    std::string FilenameHint;
+    std::string Directory;
+    mitk::BaseDataSerializer::Pointer Serializer;
+    std::string DataFilename;
+    bool DataError = true;
+  };
+}
+
+mitk::SceneIO::SceneIO() : m_WorkingDirectory(""), m_UnzipErrors(0), m_NumberOfThreads(0)
 {
 }
 
@@ -119,16 +164,23 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadScene(const std::string &filename,
 
   // unzip all filenames contents to temp dir
   m_UnzipErrors = 0;
-  Poco::Zip::Decompress unzipper(file, Poco::Path(m_WorkingDirectory));
-  unzipper.EError += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
-    this, &SceneIO::OnUnzipError);
-  unzipper.EOk += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
-    this, &SceneIO::OnUnzipOk);
-  unzipper.decompressAllFiles();
-  unzipper.EError -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
-    this, &SceneIO::OnUnzipError);
-  unzipper.EOk -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
-    this, &SceneIO::OnUnzipOk);
+  if (!this->DecompressEntries(filename))
+  {
+    // fall back to unpacking the entries one after another
+    file.clear();
+    file.seekg(0);
+
+    Poco::Zip::Decompress unzipper(file, Poco::Path(m_WorkingDirectory));
+    unzipper.EError += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
+      this, &SceneIO::OnUnzipError);
+    unzipper.EOk += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
+      this, &SceneIO::OnUnzipOk);
+    unzipper.decompressAllFiles();
+    unzipper.EError -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
+      this, &SceneIO::OnUnzipError);
+    unzipper.EOk -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
+      this, &SceneIO::OnUnzipOk);
+  }
 
   if (m_UnzipErrors)
   {
@@ -205,6 +257,7 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadSceneUnzipped(const std::string &i
   }
 
   SceneReader::Pointer reader = SceneReader::New();
+  reader->SetNumberOfThreads(m_NumberOfThreads);
   if (!reader->LoadScene(document, workingDir, storage))
   {
     MITK_ERROR << "There were errors while loading scene file " << indexfilename << ". Your data may be corrupted";
@@ -253,231 +306,291 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
     version->SetAttribute("FileVersion", 1);
     document.InsertEndChild(version);
 
-    // DataStorage::SetOfObjects::ConstPointer sceneNodes = storage->GetSubset( predicate );
-
-    if (sceneNodes.IsNull())
+    if (sceneNodes->size() == 0)
     {
       MITK_WARN << "Saving empty scene to " << filename;
     }
-    else
+
+    MITK_INFO << "Storing scene with " << sceneNodes->size() << " objects to " << filename;
+
+    m_WorkingDirectory = CreateEmptyTempDirectory();
+    if (m_WorkingDirectory.empty())
+    {
+      MITK_ERROR << "Could not create temporary directory. Cannot create scene files.";
+      return false;
+    }
+
+    std::string defaultLocale_WorkingDirectory = Poco::Path::transcode(m_WorkingDirectory);
+
+    ProgressBar::GetInstance()->AddStepsToDo(sceneNodes->size());
+
+    // find out about dependencies
+    typedef std::map<DataNode *, std::string> UIDMapType;
+    typedef std::map<DataNode *, std::list<std::string>> SourcesMapType;
+
+    UIDMapType nodeUIDs;       // for dependencies: ID of each node
+    SourcesMapType sourceUIDs; // for dependencies: IDs of a node's parent nodes
+
+    UIDGenerator nodeUIDGen("OBJECT_");
+
+    for (auto iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
     {
-      if (sceneNodes->size() == 0)
+      DataNode *node = iter->GetPointer();
+      if (!node)
+        continue; // unlikely event that we get a nullptr pointer as an object for saving. just ignore
+
+      // generate UIDs for all source objects
+      DataStorage::SetOfObjects::ConstPointer sourceObjects = storage->GetSources(node);
+      for (auto sourceIter = sourceObjects->begin();
+           sourceIter != sourceObjects->end();
+           ++sourceIter)
       {
-        MITK_WARN << "Saving empty scene to " << filename;
-      }
+        if (std::find(sceneNodes->begin(), sceneNodes->end(), *sourceIter) == sceneNodes->end())
+          continue; // source is not saved, so don't generate a UID for this source
 
-      MITK_INFO << "Storing scene with " << sceneNodes->size() << " objects to " << filename;
+        // create a uid for the parent object
+        if (nodeUIDs[*sourceIter].empty())
+        {
+          nodeUIDs[*sourceIter] = nodeUIDGen.GetUID();
+        }
+
+        // store this dependency for writing
+        sourceUIDs[node].push_back(nodeUIDs[*sourceIter]);
+      }
 
-      m_WorkingDirectory = CreateEmptyTempDirectory();
-      if (m_WorkingDirectory.empty())
+      if (nodeUIDs[node].empty())
       {
-        MITK_ERROR << "Could not create temporary directory. Cannot create scene files.";
-        return false;
+        nodeUIDs[node] = nodeUIDGen.GetUID();
       }
+    }
 
-      ProgressBar::GetInstance()->AddStepsToDo(sceneNodes->size());
+    // Every node is serialized into a directory of its own. The BaseData of the nodes is serialized concurrently,
+    // while the serializers are created and everything else is done on this thread. Finished nodes are moved into
+    // the scene file right away, in node order.
+    std::vector<NodeSerialization> nodeSerializations;
+    nodeSerializations.reserve(sceneNodes->size());
 
-      // find out about dependencies
-      typedef std::map<DataNode *, std::string> UIDMapType;
-      typedef std::map<DataNode *, std::list<std::string>> SourcesMapType;
+    for (auto iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
+    {
+      DataNode *node = iter->GetPointer();
 
-      UIDMapType nodeUIDs;       // for dependencies: ID of each node
-      SourcesMapType sourceUIDs; // for dependencies: IDs of a node's parent nodes
+      if (!node)
+      {
+        MITK_WARN << "Ignoring nullptr node during scene serialization.";
+        ProgressBar::GetInstance()->Progress();
+        continue;
+      }
 
-      UIDGenerator nodeUIDGen("OBJECT_");
+      NodeSerialization nodeSerialization;
+      nodeSerialization.Node = node;
+      nodeSerialization.FilenameHint = itksys::SystemTools::MakeCindentifier(
+        node->GetName().c_str()); // escape filename <-- only allow [A-Za-z0-9_], replace everything else with _
 
-      for (auto iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
+      std::ostringstream directory;
+      directory << m_WorkingDirectory << Poco::Path::separator() << "node" << nodeSerializations.size();
+      nodeSerialization.Directory = directory.str();
+
+      if (BaseData *data = node->GetData())
       {
-        DataNode *node = iter->GetPointer();
-        if (!node)
-          continue; // unlikely event that we get a nullptr pointer as an object for saving. just ignore
-
-        // generate UIDs for all source objects
-        DataStorage::SetOfObjects::ConstPointer sourceObjects = storage->GetSources(node);
-        for (auto sourceIter = sourceObjects->begin();
-             sourceIter != sourceObjects->end();
-             ++sourceIter)
-        {
-          if (std::find(sceneNodes->begin(), sceneNodes->end(), *sourceIter) == sceneNodes->end())
-            continue; // source is not saved, so don't generate a UID for this source
+        nodeSerialization.Serializer = this->CreateBaseDataSerializer(
+          data, nodeSerialization.FilenameHint, Poco::Path::transcode(nodeSerialization.Directory));
+      }
+
+      nodeSerializations.push_back(nodeSerialization);
+    }
+
+    Poco::File deleteFile(filename.c_str());
+    if (deleteFile.exists())
+    {
+      deleteFile.remove();
+    }
+
+    // create zip at filename
+    std::ofstream file(filename.c_str(), std::ios::binary | std::ios::out);
+    if (!file.good())
+    {
+      MITK_ERROR << "Could not open a zip file for writing: '" << filename << "'";
+      Poco::File(m_WorkingDirectory).remove(true);
+      return false;
+    }
+
+    Poco::Zip::Compress zipper(file, true);
+    zipper.setStoreExtensions(GetExtensionsOfCompressedPayloads());
 
-          // create a uid for the parent object
-          if (nodeUIDs[*sourceIter].empty())
+    RunOrderedParallelJobs(
+      nodeSerializations.size(),
+      m_NumberOfThreads,
+      [&nodeSerializations](std::size_t i) {
+        auto &nodeSerialization = nodeSerializations[i];
+        Poco::File(nodeSerialization.Directory).createDirectories();
+
+        if (nodeSerialization.Serializer.IsNotNull())
+        {
+          try
           {
-            nodeUIDs[*sourceIter] = nodeUIDGen.GetUID();
+            nodeSerialization.DataFilename = nodeSerialization.Serializer->Serialize();
+            nodeSerialization.DataError = false;
+          }
+          catch (std::exception &e)
+          {
+            MITK_ERROR << "Serializer " << nodeSerialization.Serializer->GetNameOfClass() << " failed: " << e.what();
           }
-
-          // store this dependency for writing
-          sourceUIDs[node].push_back(nodeUIDs[*sourceIter]);
         }
-
-        if (nodeUIDs[node].empty())
+      },
+      [&](std::size_t i) {
+        auto &nodeSerialization = nodeSerializations[i];
+        DataNode *node = nodeSerialization.Node;
+        const std::string &filenameHint = nodeSerialization.FilenameHint;
+        const std::string defaultLocale_Directory = Poco::Path::transcode(nodeSerialization.Directory);
+
+        auto *nodeElement = document.NewElement("node");
+
+        // store dependencies
+        auto searchUIDIter = nodeUIDs.find(node);
+        if (searchUIDIter != nodeUIDs.end())
         {
-          nodeUIDs[node] = nodeUIDGen.GetUID();
+          // store this node's ID
+          nodeElement->SetAttribute("UID", searchUIDIter->second.c_str());
         }
-      }
-
-      // write out objects, dependencies and properties
-      for (auto iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
-      {
-        DataNode *node = iter->GetPointer();
 
-        if (node)
+        auto searchSourcesIter = sourceUIDs.find(node);
+        if (searchSourcesIter != sourceUIDs.end())
         {
-          auto *nodeElement = document.NewElement("node");
-          std::string filenameHint(node->GetName());
-          filenameHint = itksys::SystemTools::MakeCindentifier(
-            filenameHint.c_str()); // escape filename <-- only allow [A-Za-z0-9_], replace everything else with _
-
-          // store dependencies
-          auto searchUIDIter = nodeUIDs.find(node);
-          if (searchUIDIter != nodeUIDs.end())
+          // store all source IDs
+          for (auto sourceUIDIter = searchSourcesIter->second.begin();
+               sourceUIDIter != searchSourcesIter->second.end();
+               ++sourceUIDIter)
           {
-            // store this node's ID
-            nodeElement->SetAttribute("UID", searchUIDIter->second.c_str());
+            auto *uidElement = document.NewElement("source");
+            uidElement->SetAttribute("UID", sourceUIDIter->c_str());
+            nodeElement->InsertEndChild(uidElement);
           }
+        }
 
-          auto searchSourcesIter = sourceUIDs.find(node);
-          if (searchSourcesIter != sourceUIDs.end())
+        // store basedata
+        if (BaseData *data = node->GetData())
+        {
+          auto *dataElement = document.NewElement("data");
+          dataElement->SetAttribute("type", data->GetNameOfClass());
+          if (!nodeSerialization.DataError)
           {
-            // store all source IDs
-            for (auto sourceUIDIter = searchSourcesIter->second.begin();
-                 sourceUIDIter != searchSourcesIter->second.end();
-                 ++sourceUIDIter)
-            {
-              auto *uidElement = document.NewElement("source");
-              uidElement->SetAttribute("UID", sourceUIDIter->c_str());
-              nodeElement->InsertEndChild(uidElement);
-            }
+            dataElement->SetAttribute("file", nodeSerialization.DataFilename.c_str()); // a reference to a file
           }
+          dataElement->SetAttribute("UID", data->GetUID().c_str());
 
-          // store basedata
-          if (BaseData *data = node->GetData())
+          if (nodeSerialization.DataError)
           {
-            // std::string filenameHint( node->GetName() );
-            bool error(false);
-            auto *dataElement = SaveBaseData(document, data, filenameHint, error); // returns a reference to a file
-            if (error)
-            {
-              m_FailedNodes->push_back(node);
-            }
-
-            // store basedata properties
-            PropertyList *propertyList = data->GetPropertyList();
-            if (propertyList && !propertyList->IsEmpty())
-            {
-              auto *baseDataPropertiesElement =
-                SavePropertyList(document, propertyList, filenameHint + "-data"); // returns a reference to a file
-              dataElement->InsertEndChild(baseDataPropertiesElement);
-            }
-
-            nodeElement->InsertEndChild(dataElement);
+            m_FailedNodes->push_back(node);
           }
 
-          // store all renderwindow specific propertylists
-          mitk::DataNode::PropertyListKeyNames propertyListKeys = node->GetPropertyListNames();
-          for (const auto &renderWindowName : propertyListKeys)
+          // store basedata properties
+          PropertyList *propertyList = data->GetPropertyList();
+          if (propertyList && !propertyList->IsEmpty())
           {
-            PropertyList *propertyList = node->GetPropertyList(renderWindowName);
-            if (propertyList && !propertyList->IsEmpty())
-            {
-              auto *renderWindowPropertiesElement =
-                SavePropertyList(document, propertyList, filenameHint + "-" + renderWindowName); // returns a reference to a file
-              renderWindowPropertiesElement->SetAttribute("renderwindow", renderWindowName.c_str());
-              nodeElement->InsertEndChild(renderWindowPropertiesElement);
-            }
+            auto *baseDataPropertiesElement = SavePropertyList(
+              document, propertyList, filenameHint + "-data", defaultLocale_Directory); // returns a reference to a file
+            dataElement->InsertEndChild(baseDataPropertiesElement);
           }
 
-          // don't forget the renderwindow independent list
-          PropertyList *propertyList = node->GetPropertyList();
+          nodeElement->InsertEndChild(dataElement);
+        }
+
+        // store all renderwindow specific propertylists
+        mitk::DataNode::PropertyListKeyNames propertyListKeys = node->GetPropertyListNames();
+        for (const auto &renderWindowName : propertyListKeys)
+        {
+          PropertyList *propertyList = node->GetPropertyList(renderWindowName);
           if (propertyList && !propertyList->IsEmpty())
           {
-            auto *propertiesElement =
-              SavePropertyList(document, propertyList, filenameHint + "-node"); // returns a reference to a file
-            nodeElement->InsertEndChild(propertiesElement);
+            auto *renderWindowPropertiesElement = SavePropertyList(
+              document, propertyList, filenameHint + "-" + renderWindowName, defaultLocale_Directory); // returns a reference to a file
+            renderWindowPropertiesElement->SetAttribute("renderwindow", renderWindowName.c_str());
+            nodeElement->InsertEndChild(renderWindowPropertiesElement);
           }
-          document.InsertEndChild(nodeElement);
         }
-        else
+
+        // don't forget the renderwindow independent list
+        PropertyList *propertyList = node->GetPropertyList();
+        if (propertyList && !propertyList->IsEmpty())
         {
-          MITK_WARN << "Ignoring nullptr node during scene serialization.";
+          auto *propertiesElement =
+            SavePropertyList(document, propertyList, filenameHint + "-node", defaultLocale_Directory); // returns a reference to a file
+          nodeElement->InsertEndChild(propertiesElement);
         }
+        document.InsertEndChild(nodeElement);
 
-        ProgressBar::GetInstance()->Progress();
-      } // end for all nodes
-    }   // end if sceneNodes
+        // file names are unique across all nodes, thus the files of all nodes share the root of the scene file
+        zipper.addRecursive(Poco::Path(nodeSerialization.Directory));
+        Poco::File(nodeSerialization.Directory).remove(true);
 
-    std::string defaultLocale_WorkingDirectory = Poco::Path::transcode( m_WorkingDirectory );
+        ProgressBar::GetInstance()->Progress();
+      });
 
     auto xmlFilename = defaultLocale_WorkingDirectory + Poco::Path::separator() + "index.xml";
     if (tinyxml2::XML_SUCCESS != document.SaveFile(xmlFilename.c_str()))
     {
       MITK_ERROR << "Could not write scene to " << defaultLocale_WorkingDirectory << Poco::Path::separator() << "index.xml"
                  << "\nTinyXML reports '" << document.ErrorStr() << "'";
+      zipper.close();
+      file.close();
+      Poco::File(filename).remove();
+      Poco::File(m_WorkingDirectory).remove(true);
       return false;
     }
-    else
+
+    try
     {
-      try
-      {
-        Poco::File deleteFile(filename.c_str());
-        if (deleteFile.exists())
-        {
-          deleteFile.remove();
-        }
+      zipper.addFile(Poco::Path(m_WorkingDirectory).append("index.xml"), Poco::Path("index.xml"));
+      zipper.close();
+    }
+    catch (std::exception &e)
+    {
+      MITK_ERROR << "Could not create ZIP file from " << m_WorkingDirectory << "\nReason: " << e.what();
+      return false;
+    }
 
-        // create zip at filename
-        std::ofstream file(filename.c_str(), std::ios::binary | std::ios::out);
-        if (!file.good())
-        {
-          MITK_ERROR << "Could not open a zip file for writing: '" << filename << "'";
-          return false;
-        }
-        else
-        {
-          Poco::Zip::Compress zipper(file, true);
-          Poco::Path tmpdir(m_WorkingDirectory);
-          zipper.addRecursive(tmpdir);
-          zipper.close();
-        }
-        try
-        {
-          Poco::File deleteDir(m_WorkingDirectory);
-          deleteDir.remove(true); // recursive
-        }
-        catch (...)
-        {
-          MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
-          return false; // ok?
-        }
-      }
-      catch (std::exception &e)
-      {
-        MITK_ERROR << "Could not create ZIP file from " << m_WorkingDirectory << "\nReason: " << e.what();
-        return false;
-      }
-      return true;
+    try
+    {
+      Poco::File deleteDir(m_WorkingDirectory);
+      deleteDir.remove(true); // recursive
     }
+    catch (...)
+    {
+      MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
+      return false; // ok?
+    }
+
+    return true;
   }
   catch (std::exception &e)
   {
     MITK_ERROR << "Caught exception during saving temporary files to disk. Error description: '" << e.what() << "'";
+
+    try
+    {
+      if (!m_WorkingDirectory.empty() && Poco::File(m_WorkingDirectory).exists())
+        Poco::File(m_WorkingDirectory).remove(true);
+    }
+    catch (...)
+    {
+      MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
+    }
+
     return false;
   }
 }
 
-tinyxml2::XMLElement *mitk::SceneIO::SaveBaseData(tinyxml2::XMLDocument &doc, BaseData *data, const std::string &filenamehint, bool &error)
+mitk::BaseDataSerializer::Pointer mitk::SceneIO::CreateBaseDataSerializer(BaseData *data,
+                                                                          const std::string &filenamehint,
+                                                                          const std::string &workingDirectory)
 {
   assert(data);
-  error = true;
 
   // find correct serializer
   // the serializer must
   //  - create a file containing all information to recreate the BaseData object --> needs to know where to put this
   //  file (and a filename?)
   //  - TODO what to do about writers that creates one file per timestep?
-  auto *element = doc.NewElement("data");
-  element->SetAttribute("type", data->GetNameOfClass());
 
   // construct name of serializer class
   std::string serializername(data->GetNameOfClass());
@@ -498,27 +611,18 @@ tinyxml2::XMLElement *mitk::SceneIO::SaveBaseData(tinyxml2::XMLDocument &doc, Ba
     {
       serializer->SetData(data);
       serializer->SetFilenameHint(filenamehint);
-      std::string defaultLocale_WorkingDirectory = Poco::Path::transcode( m_WorkingDirectory );
-      serializer->SetWorkingDirectory(defaultLocale_WorkingDirectory);
-      try
-      {
-        std::string writtenfilename = serializer->Serialize();
-        element->SetAttribute("file", writtenfilename.c_str());
-        error = false;
-      }
-      catch (std::exception &e)
-      {
-        MITK_ERROR << "Serializer " << serializer->GetNameOfClass() << " failed: " << e.what();
-      }
-      break;
+      serializer->SetWorkingDirectory(workingDirectory);
+      return serializer;
     }
   }
-  element->SetAttribute("UID", data->GetUID().c_str());
 
-  return element;
+  return nullptr;
 }
 
-tinyxml2::XMLElement *mitk::SceneIO::SavePropertyList(tinyxml2::XMLDocument &doc, PropertyList *propertyList, const std::string &filenamehint)
+tinyxml2::XMLElement *mitk::SceneIO::SavePropertyList(tinyxml2::XMLDocument &doc,
+                                                      PropertyList *propertyList,
+                                                      const std::string &filenamehint,
+                                                      const std::string &workingDirectory)
 {
   assert(propertyList);
 
@@ -530,8 +634,7 @@ tinyxml2::XMLElement *mitk::SceneIO::SavePropertyList(tinyxml2::XMLDocument &doc
 
   serializer->SetPropertyList(propertyList);
   serializer->SetFilenameHint(filenamehint);
-  std::string defaultLocale_WorkingDirectory = Poco::Path::transcode( m_WorkingDirectory );
-  serializer->SetWorkingDirectory(defaultLocale_WorkingDirectory);
+  serializer->SetWorkingDirectory(workingDirectory);
   try
   {
     std::string writtenfilename = serializer->Serialize();
@@ -551,6 +654,78 @@ tinyxml2::XMLElement *mitk::SceneIO::SavePropertyList(tinyxml2::XMLDocument &doc
   return element;
 }
 
+bool mitk::SceneIO::DecompressEntries(const std::string &filename)
+{
+  std::vector<Poco::Zip::ZipLocalFileHeader> headers;
+
+  try
+  {
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    Poco::Zip::ZipArchive archive(file);
+
+    for (auto iter = archive.headerBegin(); iter != archive.headerEnd(); ++iter)
+      headers.push_back(iter->second);
+  }
+  catch (const Poco::Exception &e)
+  {
+    MITK_WARN << "Could not list the entries of '" << filename << "': " << e.displayText();
+    return false;
+  }
+
+  Poco::Path workingDirectory(m_WorkingDirectory);
+  workingDirectory.makeDirectory();
+
+  std::atomic<unsigned int> unzipErrors(0);
+
+  // every entry is read through a stream of its own, thus entries are decompressed independently of each other
+  RunOrderedParallelJobs(
+    headers.size(),
+    m_NumberOfThreads,
+    [&](std::size_t i) {
+      const auto &header = headers[i];
+
+      try
+      {
+        if (!IsValidEntryName(header.getFileName()))
+          throw Poco::Exception("Illegal entry name", header.getFileName());
+
+        Poco::Path target(workingDirectory);
+        target.append(Poco::Path(header.getFileName(), Poco::Path::PATH_UNIX));
+
+        if (header.isDirectory())
+        {
+          Poco::File(target).createDirectories();
+          return;
+        }
+
+        Poco::File(target.parent()).createDirectories();
+
+        std::ifstream file(filename.c_str(), std::ios::binary);
+        Poco::Zip::ZipInputStream entry(file, header, true);
+
+        std::ofstream out(target.toString().c_str(), std::ios::binary | std::ios::out);
+        Poco::StreamCopier::copyStream(entry, out);
+
+        if (!entry.eof() || !out.good())
+          throw Poco::Exception("Could not write", target.toString());
+      }
+      catch (const Poco::Exception &e)
+      {
+        ++unzipErrors;
+        MITK_ERROR << "Error while unzipping: " << e.displayText();
+      }
+      catch (const std::exception &e)
+      {
+        ++unzipErrors;
+        MITK_ERROR << "Error while unzipping " << header.getFileName() << ": " << e.what();
+      }
+    },
+    [](std::size_t) {});
+
+  m_UnzipErrors += unzipErrors;
+  return true;
+}
+
 const mitk::SceneIO::FailedBaseDataListType *mitk::SceneIO::GetFailedNodes()
 {
   return m_FailedNodes.GetPointer();
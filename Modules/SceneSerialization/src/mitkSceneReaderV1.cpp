@@ -14,6 +14,7 @@ found in the LICENSE file.
 #include "Poco/Path.h"
 #include "mitkBaseRenderer.h"
 #include "mitkIOUtil.h"
+#include "mitkOrderedParallelJobs.h"
 #include "mitkProgressBar.h"
 #include "mitkPropertyListDeserializer.h"
 #include "mitkSerializerMacros.h"
@@ -99,21 +100,40 @@ bool mitk::SceneReaderV1::LoadScene(tinyxml2::XMLDocument &document, const std::
   // create a node for the tag "data" and test if node was created
   typedef std::vector<mitk::DataNode::Pointer> DataNodeVector;
   DataNodeVector DataNodes;
-  unsigned int listSize = 0;
+  std::vector<const tinyxml2::XMLElement *> dataElements;
   for (auto *element = document.FirstChildElement("node"); element != nullptr;
        element = element->NextSiblingElement("node"))
   {
-    ++listSize;
+    dataElements.push_back(element->FirstChildElement("data"));
   }
 
+  const auto listSize = static_cast<unsigned int>(dataElements.size());
   ProgressBar::GetInstance()->AddStepsToDo(listSize * 2);
 
-  for (auto *element = document.FirstChildElement("node"); element != nullptr;
-       element = element->NextSiblingElement("node"))
-  {
-    DataNodes.push_back(LoadBaseDataFromDataTag(element->FirstChildElement("data"), workingDirectory, error));
-    ProgressBar::GetInstance()->Progress();
-  }
+  // the BaseData objects are read concurrently, the nodes are created in document order on this thread
+  std::vector<BaseData::Pointer> baseData(listSize);
+  std::vector<char> loadErrors(listSize, 0);
+  DataNodes.reserve(listSize);
+
+  RunOrderedParallelJobs(
+    listSize,
+    m_NumberOfThreads,
+    [&](std::size_t i) {
+      bool loadError(false);
+      baseData[i] = LoadBaseData(dataElements[i], workingDirectory, loadError);
+      loadErrors[i] = loadError;
+    },
+    [&](std::size_t i) {
+      mitk::DataNode::Pointer node = DataNode::New();
+      if (baseData[i].IsNotNull())
+      {
+        node->SetData(baseData[i]);
+      }
+
+      error = error || loadErrors[i];
+      DataNodes.push_back(node);
+      ProgressBar::GetInstance()->Progress();
+    });
 
   // iterate all nodes
   // first level nodes should be <node> elements
@@ -271,11 +291,11 @@ bool mitk::SceneReaderV1::LoadScene(tinyxml2::XMLDocument &document, const std::
   return !error;
 }
 
-mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(const tinyxml2::XMLElement *dataElement,
-                                                                     const std::string &workingDirectory,
-                                                                     bool &error)
+mitk::BaseData::Pointer mitk::SceneReaderV1::LoadBaseData(const tinyxml2::XMLElement *dataElement,
+                                                          const std::string &workingDirectory,
+                                                          bool &error) const
 {
-  DataNode::Pointer node;
+  BaseData::Pointer data;
 
   if (dataElement)
   {
@@ -289,8 +309,7 @@ mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(const tinyx
         {
           MITK_WARN << "Discarding multiple base data results from " << filename << " except the first one.";
         }
-        node = DataNode::New();
-        node->SetData(baseData.front());
+        data = baseData.front();
       }
       catch (std::exception &e)
       {
@@ -298,7 +317,7 @@ mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(const tinyx
         error = true;
       }
 
-      if (node.IsNull())
+      if (data.IsNull())
       {
         MITK_ERROR << "Error during attempt to read '" << filename << "'. Factory returned nullptr object.";
         error = true;
@@ -306,20 +325,14 @@ mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(const tinyx
     }
 
     const char* dataUID = dataElement->Attribute("UID");
-    if (!error && dataUID != nullptr)
+    if (!error && data.IsNotNull() && dataUID != nullptr)
     {
-      UIDManipulator manip(node->GetData());
+      UIDManipulator manip(data);
       manip.SetUID(dataUID);
     }
   }
 
-  // in case there was no <data> element we create a new empty node (for appending a propertylist later)
-  if (node.IsNull())
-  {
-    node = DataNode::New();
-  }
-
-  return node;
+  return data;
 }
 
 void mitk::SceneReaderV1::ClearNodePropertyListWithExceptions(DataNode &node, PropertyList &propertyList)
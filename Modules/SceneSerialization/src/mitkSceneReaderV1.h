@@ -32,11 +32,14 @@ namespace mitk
 
   protected:
     /**
-      \brief tries to create one DataNode from a given XML \<node\> element
+      \brief tries to read the BaseData referenced by a given XML \<data\> element
+
+      Does not modify the reader, thus it is called for several elements concurrently.
+      \return nullptr if there is no \<data\> element or the BaseData could not be read.
     */
-    DataNode::Pointer LoadBaseDataFromDataTag(const tinyxml2::XMLElement *dataElement,
-                                              const std::string &workingDirectory,
-                                              bool &error);
+    BaseData::Pointer LoadBaseData(const tinyxml2::XMLElement *dataElement,
+                                   const std::string &workingDirectory,
+                                   bool &error) const;
 
     /**
       \brief reads all the properties from the XML document and recreates them in node
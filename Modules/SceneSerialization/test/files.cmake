@@ -7,6 +7,12 @@ set(MODULE_CUSTOM_TESTS
   mitkSceneIOCompatibilityTest.cpp
 )
 
+# Benchmarks are built into the test driver, but not registered with ctest.
+# Run them explicitly, e.g. MitkSceneSerializationTestDriver mitkSceneIOBenchmarkTest
+set(MODULE_CUSTOM_TESTS ${MODULE_CUSTOM_TESTS}
+  mitkSceneIOBenchmarkTest.cpp
+)
+
 set(MODULE_CPP_FILES
   mitkSceneIOTestScenarioProvider.cpp
   mitkDataStorageCompare.cpp
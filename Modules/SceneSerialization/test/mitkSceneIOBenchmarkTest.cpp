@@ -0,0 +1,134 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Benchmark, not part of the ctest set. Run it explicitly:
+//   MitkSceneSerializationTestDriver mitkSceneIOBenchmarkTest
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include "mitkIOUtil.h"
+#include "mitkImageGenerator.h"
+#include "mitkPointSet.h"
+#include "mitkSceneIO.h"
+#include "mitkStandaloneDataStorage.h"
+#include "mitkSurface.h"
+
+#include <Poco/File.h>
+
+#include <vtkSphereSource.h>
+
+#include <chrono>
+
+class mitkSceneIOBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSceneIOBenchmarkTestSuite);
+  MITK_TEST(MixedScene);
+  CPPUNIT_TEST_SUITE_END();
+
+  /** The scene of images, surfaces and point sets of mitkSceneIOTest2, every third node is a child of the previous image.*/
+  static mitk::DataStorage::Pointer CreateMixedScene(unsigned int numberOfNodes, unsigned int imageSize)
+  {
+    mitk::DataStorage::Pointer storage = mitk::StandaloneDataStorage::New().GetPointer();
+    mitk::DataNode::Pointer lastImageNode;
+
+    for (unsigned int i = 0; i < numberOfNodes; ++i)
+    {
+      mitk::DataNode::Pointer node = mitk::DataNode::New();
+      node->SetName("Node-" + std::to_string(i));
+
+      switch (i % 3)
+      {
+        case 0:
+          node->SetData(mitk::ImageGenerator::GenerateGradientImage<float>(imageSize, imageSize, imageSize));
+          break;
+        case 1:
+        {
+          auto sphere = vtkSmartPointer<vtkSphereSource>::New();
+          sphere->SetThetaResolution(64 + i);
+          sphere->SetPhiResolution(64);
+          sphere->SetRadius(1.0 + i);
+          sphere->Update();
+
+          mitk::Surface::Pointer surface = mitk::Surface::New();
+          surface->SetVtkPolyData(sphere->GetOutput());
+          node->SetData(surface);
+          break;
+        }
+        default:
+        {
+          mitk::PointSet::Pointer pointSet = mitk::PointSet::New();
+          for (unsigned int p = 0; p < 100; ++p)
+          {
+            mitk::PointSet::PointType point;
+            mitk::FillVector3D(point, p, i, p * 0.5);
+            pointSet->SetPoint(p, point);
+          }
+          node->SetData(pointSet);
+          break;
+        }
+      }
+
+      node->SetIntProperty("layer", static_cast<int>(i));
+
+      if (i % 3 == 2 && lastImageNode.IsNotNull())
+      {
+        storage->Add(node, lastImageNode);
+      }
+      else
+      {
+        storage->Add(node);
+      }
+
+      if (i % 3 == 0)
+        lastImageNode = node;
+    }
+
+    return storage;
+  }
+
+public:
+  void MixedScene()
+  {
+    std::string tempDir = mitk::IOUtil::CreateTemporaryDirectory("SceneIOBenchmark_XXXXXX");
+    mitk::DataStorage::Pointer originalStorage = CreateMixedScene(60, 64);
+
+    for (unsigned int numberOfThreads : {1u, 0u})
+    {
+      std::string archiveFilename = mitk::IOUtil::CreateTemporaryFile("scene_XXXXXX.mitk", tempDir);
+
+      mitk::SceneIO::Pointer writer = mitk::SceneIO::New();
+      writer->SetNumberOfThreads(numberOfThreads);
+
+      auto start = std::chrono::steady_clock::now();
+      CPPUNIT_ASSERT(writer->SaveScene(originalStorage->GetAll(), originalStorage, archiveFilename));
+      const double saveDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      mitk::SceneIO::Pointer reader = mitk::SceneIO::New();
+      reader->SetNumberOfThreads(numberOfThreads);
+
+      mitk::DataStorage::Pointer restoredStorage;
+      start = std::chrono::steady_clock::now();
+      CPPUNIT_ASSERT_NO_THROW(restoredStorage = reader->LoadScene(archiveFilename));
+      const double loadDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      CPPUNIT_ASSERT_EQUAL(originalStorage->GetAll()->Size(), restoredStorage->GetAll()->Size());
+
+      MITK_INFO << "Mixed scene of " << originalStorage->GetAll()->Size() << " nodes using "
+                << (numberOfThreads == 0 ? std::string("all") : std::to_string(numberOfThreads))
+                << " thread(s): save " << saveDuration << " s, load " << loadDuration << " s, scene file "
+                << Poco::File(archiveFilename).getSize() / 1024 << " KiB";
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSceneIOBenchmark)
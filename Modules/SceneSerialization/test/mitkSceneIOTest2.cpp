@@ -16,8 +16,19 @@ found in the LICENSE file.
 
 #include "mitkDataStorageCompare.h"
 #include "mitkIOUtil.h"
+#include "mitkImageGenerator.h"
+#include "mitkPointSet.h"
 #include "mitkSceneIO.h"
 #include "mitkSceneIOTestScenarioProvider.h"
+#include "mitkStandaloneDataStorage.h"
+#include "mitkSurface.h"
+
+#include <Poco/Path.h>
+#include <Poco/Zip/ZipArchive.h>
+
+#include <vtkSphereSource.h>
+
+#include <fstream>
 
 /**
   \brief Test cases for SceneIO.
@@ -78,10 +89,82 @@ class mitkSceneIOTest2Suite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkSceneIOTest2Suite);
   MITK_TEST(Test_SceneIOInterfaces);
   MITK_TEST(Test_ReconstructionOfScenes);
+  MITK_TEST(Test_ParallelSceneIOOfMixedScene);
+  MITK_TEST(Test_StoredEntriesOfScene);
   CPPUNIT_TEST_SUITE_END();
 
   mitk::SceneIOTestScenarioProvider m_TestCaseProvider;
 
+  /** A scene of images, surfaces and point sets, where every third node is a child of the previous image.*/
+  static mitk::DataStorage::Pointer CreateMixedScene(unsigned int numberOfNodes, unsigned int imageSize)
+  {
+    mitk::DataStorage::Pointer storage = mitk::StandaloneDataStorage::New().GetPointer();
+    mitk::DataNode::Pointer lastImageNode;
+
+    for (unsigned int i = 0; i < numberOfNodes; ++i)
+    {
+      mitk::DataNode::Pointer node = mitk::DataNode::New();
+      node->SetName("Node-" + std::to_string(i));
+
+      switch (i % 3)
+      {
+        case 0:
+          node->SetData(mitk::ImageGenerator::GenerateGradientImage<float>(imageSize, imageSize, imageSize));
+          break;
+        case 1:
+        {
+          auto sphere = vtkSmartPointer<vtkSphereSource>::New();
+          sphere->SetThetaResolution(64 + i);
+          sphere->SetPhiResolution(64);
+          sphere->SetRadius(1.0 + i);
+          sphere->Update();
+
+          mitk::Surface::Pointer surface = mitk::Surface::New();
+          surface->SetVtkPolyData(sphere->GetOutput());
+          node->SetData(surface);
+          break;
+        }
+        default:
+        {
+          mitk::PointSet::Pointer pointSet = mitk::PointSet::New();
+          for (unsigned int p = 0; p < 100; ++p)
+          {
+            mitk::PointSet::PointType point;
+            mitk::FillVector3D(point, p, i, p * 0.5);
+            pointSet->SetPoint(p, point);
+          }
+          node->SetData(pointSet);
+          break;
+        }
+      }
+
+      node->SetIntProperty("layer", static_cast<int>(i));
+
+      if (i % 3 == 2 && lastImageNode.IsNotNull())
+      {
+        storage->Add(node, lastImageNode);
+      }
+      else
+      {
+        storage->Add(node);
+      }
+
+      if (i % 3 == 0)
+        lastImageNode = node;
+    }
+
+    return storage;
+  }
+
+  static bool CompareScenes(mitk::DataStorage *original, mitk::DataStorage *restored)
+  {
+    return mitk::DataStorageCompare(original,
+                                    restored,
+                                    mitk::DataStorageCompare::CMP_Hierarchy | mitk::DataStorageCompare::CMP_Data |
+                                      mitk::DataStorageCompare::CMP_Properties)
+      .CompareVerbose();
+  }
+
 public:
   void Test_SceneIOInterfaces() { CPPUNIT_ASSERT_MESSAGE("Not urgent", true); }
   void Test_ReconstructionOfScenes()
@@ -125,6 +208,77 @@ public:
     }
   }
 
+  void Test_ParallelSceneIOOfMixedScene()
+  {
+    std::string tempDir = mitk::IOUtil::CreateTemporaryDirectory("SceneIOTest_XXXXXX");
+    mitk::DataStorage::Pointer originalStorage = CreateMixedScene(60, 64);
+
+    // the sequential results are the reference for the parallel ones
+    for (unsigned int numberOfThreads : {1u, 0u})
+    {
+      std::string archiveFilename = mitk::IOUtil::CreateTemporaryFile("scene_XXXXXX.mitk", tempDir);
+
+      mitk::SceneIO::Pointer writer = mitk::SceneIO::New();
+      writer->SetNumberOfThreads(numberOfThreads);
+
+      CPPUNIT_ASSERT(writer->SaveScene(originalStorage->GetAll(), originalStorage, archiveFilename));
+      CPPUNIT_ASSERT_EQUAL(0u, writer->GetFailedNodes()->Size());
+
+      mitk::SceneIO::Pointer reader = mitk::SceneIO::New();
+      reader->SetNumberOfThreads(numberOfThreads);
+
+      mitk::DataStorage::Pointer restoredStorage;
+      CPPUNIT_ASSERT_NO_THROW(restoredStorage = reader->LoadScene(archiveFilename));
+
+      CPPUNIT_ASSERT_EQUAL(originalStorage->GetAll()->Size(), restoredStorage->GetAll()->Size());
+      CPPUNIT_ASSERT(CompareScenes(originalStorage, restoredStorage));
+    }
+  }
+
+  void Test_StoredEntriesOfScene()
+  {
+    std::string tempDir = mitk::IOUtil::CreateTemporaryDirectory("SceneIOTest_XXXXXX");
+    std::string archiveFilename = mitk::IOUtil::CreateTemporaryFile("scene_XXXXXX.mitk", tempDir);
+
+    mitk::DataStorage::Pointer originalStorage = CreateMixedScene(6, 16);
+    mitk::SceneIO::Pointer writer = mitk::SceneIO::New();
+    CPPUNIT_ASSERT(writer->SaveScene(originalStorage->GetAll(), originalStorage, archiveFilename));
+
+    std::ifstream file(archiveFilename.c_str(), std::ios::binary);
+    Poco::Zip::ZipArchive archive(file);
+
+    bool hasIndex = false;
+    unsigned int numberOfImages = 0;
+
+    for (auto iter = archive.headerBegin(); iter != archive.headerEnd(); ++iter)
+    {
+      const auto &name = iter->first;
+      const auto extension = Poco::Path(name).getExtension();
+
+      // all entries are in the root of the scene file
+      CPPUNIT_ASSERT_EQUAL(std::string::npos, name.find('/'));
+
+      if (name == "index.xml")
+        hasIndex = true;
+
+      if (extension == "nrrd")
+        ++numberOfImages;
+
+      // payloads compressed by their writers are not compressed again
+      if (extension == "nrrd" || extension == "vtp")
+      {
+        CPPUNIT_ASSERT(Poco::Zip::ZipCommon::CM_STORE == iter->second.getCompressionMethod());
+      }
+      else if (extension == "xml")
+      {
+        CPPUNIT_ASSERT(Poco::Zip::ZipCommon::CM_DEFLATE == iter->second.getCompressionMethod());
+      }
+    }
+
+    CPPUNIT_ASSERT(hasIndex);
+    CPPUNIT_ASSERT_EQUAL(2u, numberOfImages);
+  }
+
 }; // class
 
 int mitkSceneIOTest2(int /*argc*/, char * /*argv*/ [])
@@ -14,6 +14,8 @@ found in the LICENSE file.
 #include "mitkBasePropertySerializer.h"
 #include "mitkStandardFileLocations.h"
 #include <itksys/SystemTools.hxx>
+
+#include <atomic>
 #include <tinyxml2.h>
 
 mitk::PropertyListSerializer::PropertyListSerializer() : m_FilenameHint("unnamed"), m_WorkingDirectory("")
@@ -35,7 +37,8 @@ std::string mitk::PropertyListSerializer::Serialize()
   }
 
   // tmpname
-  static unsigned long count = 1;
+  // serializers of different nodes may run concurrently
+  static std::atomic<unsigned long> count(1);
   unsigned long n = count++;
   std::ostringstream name;
   for (int i = 0; i < 6; ++i)
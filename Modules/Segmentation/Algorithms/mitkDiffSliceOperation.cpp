@@ -84,6 +84,26 @@ mitk::Image::Pointer mitk::DiffSliceOperation::GetSlice()
   return m_CompressedImageContainer.DecompressImage();
 }
 
+std::size_t mitk::DiffSliceOperation::GetMemoryFootprint() const
+{
+  return sizeof(DiffSliceOperation) - sizeof(CompressedImageContainer) + m_CompressedImageContainer.GetMemoryFootprint();
+}
+
+bool mitk::DiffSliceOperation::IsSwappable() const
+{
+  return true;
+}
+
+void mitk::DiffSliceOperation::SwapOut(std::ostream &stream)
+{
+  m_CompressedImageContainer.SwapOut(stream);
+}
+
+void mitk::DiffSliceOperation::SwapIn(std::istream &stream)
+{
+  m_CompressedImageContainer.SwapIn(stream);
+}
+
 bool mitk::DiffSliceOperation::IsValid()
 {
   return m_ImageIsValid && m_WorldGeometry.IsNotNull(); // TODO improve
@@ -73,6 +73,15 @@ namespace mitk
     const SlicedGeometry3D *GetSliceGeometry() const { return this->m_SliceGeometry; }
     /** \brief Get the axis where the slice has to be applied in the volume.*/
     const BaseGeometry *GetWorldGeometry() const { return this->m_WorldGeometry; }
+
+    /** \brief Memory of the operation including the compressed slice.*/
+    std::size_t GetMemoryFootprint() const override;
+
+    /** \brief The compressed slice can be swapped out by undo models.*/
+    bool IsSwappable() const override;
+    void SwapOut(std::ostream &stream) override;
+    void SwapIn(std::istream &stream) override;
+
   protected:
     ~DiffSliceOperation() override;
 
@@ -25,9 +25,11 @@ mitk::ImageLiveWireContourModelFilter::ImageLiveWireContourModelFilter()
   this->SetNumberOfIndexedOutputs(1);
   this->SetNthOutput(0, output.GetPointer());
   m_CostFunction = CostFunctionType::New();
-  m_ShortestPathFilter = ShortestPathImageFilterType::New();
-  m_ShortestPathFilter->SetCostFunction(m_CostFunction);
+  m_ShortestPathEngine = ShortestPathEngineType::New();
+  m_ShortestPathEngine->SetCostFunction(m_CostFunction);
+  m_ShortestPathEngine->FullNeighborsOn();
   m_UseDynamicCostMap = false;
+  m_UseCostFunction = true;
   m_TimeStep = 0;
 }
 
@@ -125,17 +127,18 @@ void mitk::ImageLiveWireContourModelFilter::ItkPreProcessImage(const itk::Image<
   castFilter->Update();
   m_InternalImage = castFilter->GetOutput();
   m_CostFunction->SetImage(m_InternalImage);
-  m_ShortestPathFilter->SetInput(m_InternalImage);
 }
 
 void mitk::ImageLiveWireContourModelFilter::ClearRepulsivePoints()
 {
   m_CostFunction->ClearRepulsivePoints();
+  m_ShortestPathEngine->ResetSearch();
 }
 
 void mitk::ImageLiveWireContourModelFilter::AddRepulsivePoint(const itk::Index<2> &idx)
 {
   m_CostFunction->AddRepulsivePoint(idx);
+  m_ShortestPathEngine->ResetSearch();
 }
 
 void mitk::ImageLiveWireContourModelFilter::DumpMaskImage()
@@ -149,6 +152,7 @@ void mitk::ImageLiveWireContourModelFilter::DumpMaskImage()
 void mitk::ImageLiveWireContourModelFilter::RemoveRepulsivePoint(const itk::Index<2> &idx)
 {
   m_CostFunction->RemoveRepulsivePoint(idx);
+  m_ShortestPathEngine->ResetSearch();
 }
 
 void mitk::ImageLiveWireContourModelFilter::SetRepulsivePoints(const ShortestPathType &points)
@@ -160,11 +164,12 @@ void mitk::ImageLiveWireContourModelFilter::SetRepulsivePoints(const ShortestPat
   {
     m_CostFunction->AddRepulsivePoint((*iter));
   }
+
+  m_ShortestPathEngine->ResetSearch();
 }
 
 void mitk::ImageLiveWireContourModelFilter::UpdateLiveWire()
 {
-  // compute the requested region for itk filters
   InternalImageType::IndexType startPoint, endPoint;
 
   startPoint[0] = m_StartPointInIndex[0];
@@ -173,43 +178,22 @@ void mitk::ImageLiveWireContourModelFilter::UpdateLiveWire()
   endPoint[0] = m_EndPointInIndex[0];
   endPoint[1] = m_EndPointInIndex[1];
 
-  // minimum value in each direction for startRegion
-  InternalImageType::IndexType startRegion;
-  startRegion[0] = startPoint[0] < endPoint[0] ? startPoint[0] : endPoint[0];
-  startRegion[1] = startPoint[1] < endPoint[1] ? startPoint[1] : endPoint[1];
-
-  // maximum value in each direction for size
-  InternalImageType::SizeType size;
-  size[0] = std::abs(startPoint[0] - endPoint[0]) + 1;
-  size[1] = std::abs(startPoint[1] - endPoint[1]) + 1;
-
-  CostFunctionType::RegionType region;
-  region.SetSize(size);
-  region.SetIndex(startRegion);
-
-  // inputImage->SetRequestedRegion(region);
-
-  // extracts features from image and calculates costs
-  // m_CostFunction->SetImage(m_InternalImage);
-  m_CostFunction->SetStartIndex(startPoint);
-  m_CostFunction->SetEndIndex(endPoint);
-  m_CostFunction->SetRequestedRegion(region);
-  m_CostFunction->SetUseCostMap(m_UseDynamicCostMap);
-
-  // calculate shortest path between start and end point
-  m_ShortestPathFilter->SetFullNeighborsMode(true);
-  // m_ShortestPathFilter->SetInput( m_CostFunction->SetImage(m_InternalImage) );
-  m_ShortestPathFilter->SetMakeOutputImage(false);
+  ShortestPathType shortestPath;
 
-  // m_ShortestPathFilter->SetCalcAllDistances(true);
-  m_ShortestPathFilter->SetStartIndex(startPoint);
-  m_ShortestPathFilter->SetEndIndex(endPoint);
-
-  m_ShortestPathFilter->Update();
+  if (m_UseCostFunction)
+  {
+    // the costs only change (and are recomputed) if the dynamic cost map is toggled
+    m_CostFunction->SetUseCostMap(m_UseDynamicCostMap);
 
-  // construct contour from path image
-  // get the shortest path as vector
-  ShortestPathType shortestPath = m_ShortestPathFilter->GetVectorPath();
+    // the search tree of the start point is reused as long as the start point and the costs do not change
+    m_ShortestPathEngine->SetAnchorIndex(startPoint);
+    m_ShortestPathEngine->GetPath(endPoint, shortestPath);
+  }
+  else
+  {
+    shortestPath.push_back(startPoint);
+    shortestPath.push_back(endPoint);
+  }
 
   // fill the output contour with control points from the path
   OutputType::Pointer output = dynamic_cast<OutputType *>(this->MakeOutput(0).GetPointer());
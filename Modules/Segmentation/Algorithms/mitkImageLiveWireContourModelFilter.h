@@ -22,8 +22,8 @@ found in the LICENSE file.
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
 
+#include <itkLiveWireShortestPathEngine.h>
 #include <itkShortestPathCostFunctionLiveWire.h>
-#include <itkShortestPathImageFilter.h>
 
 namespace mitk
 {
@@ -35,6 +35,10 @@ namespace mitk
    value.
    \sa ShortestPathCostFunctionLiveWire
 
+   The costs of a slice are computed once and the search tree of the start point is kept between updates, thus
+   moving the end point only expands the search where necessary.
+   \sa itk::LiveWireShortestPathEngine
+
    The filter is able to create dynamic cost tranfer map and thus use on the fly training.
    \note On the fly training will only be used for next update.
    The computation uses the last calculated segment to map cost according to features in the area of the segment.
@@ -57,8 +61,8 @@ namespace mitk
     typedef mitk::Image InputType;
 
     typedef itk::Image<float, 2> InternalImageType;
-    typedef itk::ShortestPathImageFilter<InternalImageType, InternalImageType> ShortestPathImageFilterType;
     typedef itk::ShortestPathCostFunctionLiveWire<InternalImageType> CostFunctionType;
+    typedef itk::LiveWireShortestPathEngine<InternalImageType> ShortestPathEngineType;
     typedef std::vector<itk::Index<2>> ShortestPathType;
 
     /** \brief start point in world coordinates*/
@@ -108,7 +112,7 @@ namespace mitk
     /** \brief Create dynamic cost tranfer map - on the fly training*/
     bool CreateDynamicCostMap(mitk::ContourModel *path = nullptr);
 
-    void SetUseCostFunction(bool doUseCostFunction) { m_ShortestPathFilter->SetUseCostFunction(doUseCostFunction); };
+    void SetUseCostFunction(bool doUseCostFunction) { m_UseCostFunction = doUseCostFunction; };
 
   protected:
     ImageLiveWireContourModelFilter();
@@ -136,12 +140,15 @@ namespace mitk
     /** \brief The cost function to compute costs between two pixels*/
     CostFunctionType::Pointer m_CostFunction;
 
-    /** \brief Shortest path filter according to cost function m_CostFunction*/
-    ShortestPathImageFilterType::Pointer m_ShortestPathFilter;
+    /** \brief Incremental shortest path search according to cost function m_CostFunction*/
+    ShortestPathEngineType::Pointer m_ShortestPathEngine;
 
     /** \brief Flag to use a dynmic cost map or not*/
     bool m_UseDynamicCostMap;
 
+    /** \brief Flag to use the cost function or to connect start and end point directly*/
+    bool m_UseCostFunction;
+
     unsigned int m_TimeStep;
 
     template <typename TPixel, unsigned int VImageDimension>
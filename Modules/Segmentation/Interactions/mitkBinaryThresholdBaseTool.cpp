@@ -25,6 +25,8 @@ mitk::BinaryThresholdBaseTool::BinaryThresholdBaseTool()
     m_LowerThreshold(1),
     m_UpperThreshold(1)
 {
+  // thresholding is voxel local, so the visible slices can be previewed before the volume
+  this->ProgressivePreviewOn();
 }
 
 mitk::BinaryThresholdBaseTool::~BinaryThresholdBaseTool()
@@ -93,18 +95,40 @@ void mitk::BinaryThresholdBaseTool::InitiateToolByInput()
   }
 }
 
-void mitk::BinaryThresholdBaseTool::DoUpdatePreview(const Image* inputAtTimeStep, const Image* /*oldSegAtTimeStep*/, LabelSetImage* previewImage, TimeStepType timeStep)
+std::shared_ptr<const mitk::SegWithPreviewTool::PreviewParameters> mitk::BinaryThresholdBaseTool::CapturePreviewParameters() const
 {
+  auto parameters = std::make_shared<ThresholdPreviewParameters>();
+  parameters->ActiveLabel = this->GetUserDefinedActiveLabel();
+  parameters->LowerThreshold = m_LowerThreshold;
+  parameters->UpperThreshold = m_UpperThreshold;
+  return parameters;
+}
+
+void mitk::BinaryThresholdBaseTool::DoUpdatePreview(const Image* inputAtTimeStep, const Image* oldSegAtTimeStep, LabelSetImage* previewImage, TimeStepType timeStep)
+{
+  this->DoUpdatePreviewWithParameters(inputAtTimeStep, oldSegAtTimeStep, previewImage, timeStep, *this->CapturePreviewParameters());
+}
+
+void mitk::BinaryThresholdBaseTool::DoUpdatePreviewWithParameters(const Image* inputAtTimeStep, const Image* /*oldSegAtTimeStep*/, LabelSetImage* previewImage, TimeStepType timeStep, const PreviewParameters& parameters)
+{
+  const auto thresholdParameters = dynamic_cast<const ThresholdPreviewParameters*>(&parameters);
+
+  if (nullptr == thresholdParameters)
+  {
+    mitkThrow() << "Invalid preview parameters. Threshold tools require ThresholdPreviewParameters.";
+  }
+
   if (nullptr != inputAtTimeStep && nullptr != previewImage)
   {
-    AccessByItk_n(inputAtTimeStep, ITKThresholding, (previewImage, timeStep));
+    AccessByItk_n(inputAtTimeStep, ITKThresholding, (previewImage, timeStep, *thresholdParameters));
   }
 }
 
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::BinaryThresholdBaseTool::ITKThresholding(const itk::Image<TPixel, VImageDimension>* inputImage,
                                                     Image* segmentation,
-                                                    unsigned int timeStep)
+                                                    unsigned int timeStep,
+                                                    const ThresholdPreviewParameters& parameters) const
 {
   typedef itk::Image<TPixel, VImageDimension> ImageType;
   typedef itk::Image<Tool::DefaultSegmentationDataType, VImageDimension> SegmentationType;
@@ -112,10 +136,11 @@ void mitk::BinaryThresholdBaseTool::ITKThresholding(const itk::Image<TPixel, VIm
 
   typename ThresholdFilterType::Pointer filter = ThresholdFilterType::New();
   filter->SetInput(inputImage);
-  filter->SetLowerThreshold(m_LowerThreshold);
-  filter->SetUpperThreshold(m_UpperThreshold);
-  filter->SetInsideValue(this->GetUserDefinedActiveLabel());
+  filter->SetLowerThreshold(parameters.LowerThreshold);
+  filter->SetUpperThreshold(parameters.UpperThreshold);
+  filter->SetInsideValue(parameters.ActiveLabel);
   filter->SetOutsideValue(0);
+  this->ObservePreviewCancellation(filter);
   filter->Update();
 
   segmentation->SetVolume((void *)(filter->GetOutput()->GetPixelContainer()->GetBufferPointer()), timeStep);
@@ -53,12 +53,21 @@ namespace mitk
     itkGetMacro(SensibleMinimumThreshold, ScalarType);
     itkGetMacro(SensibleMaximumThreshold, ScalarType);
 
+    /** Thresholds of a preview update, see SegWithPreviewTool::CapturePreviewParameters().*/
+    struct ThresholdPreviewParameters : public PreviewParameters
+    {
+      ScalarType LowerThreshold = 1;
+      ScalarType UpperThreshold = 1;
+    };
+
     void InitiateToolByInput() override;
+    std::shared_ptr<const PreviewParameters> CapturePreviewParameters() const override;
     void DoUpdatePreview(const Image* inputAtTimeStep, const Image* oldSegAtTimeStep, LabelSetImage* previewImage, TimeStepType timeStep) override;
+    void DoUpdatePreviewWithParameters(const Image* inputAtTimeStep, const Image* oldSegAtTimeStep, LabelSetImage* previewImage, TimeStepType timeStep, const PreviewParameters& parameters) override;
 
     template <typename TPixel, unsigned int VImageDimension>
     void ITKThresholding(const itk::Image<TPixel, VImageDimension>* inputImage,
-      Image* segmentation, unsigned int timeStep);
+      Image* segmentation, unsigned int timeStep, const ThresholdPreviewParameters& parameters) const;
 
   private:
     ScalarType m_SensibleMinimumThreshold;
@@ -63,7 +63,11 @@ void mitk::OtsuTool3D::DoUpdatePreview(const Image* inputAtTimeStep, const Image
   otsuFilter->SetValleyEmphasis(m_UseValley);
   otsuFilter->SetNumberOfBins(m_NumberOfBins);
   otsuFilter->SetInput(inputAtTimeStep);
-  otsuFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
+  if (!this->IsPreviewUpdateInBackground())
+  { // the progress bar must only be updated from the UI thread
+    otsuFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
+  }
+  this->ObservePreviewCancellation(otsuFilter);
 
   try
   {
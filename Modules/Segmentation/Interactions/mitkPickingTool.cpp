@@ -270,7 +270,7 @@ void mitk::PickingTool::DoUpdatePreview(const Image* /*inputAtTimeStep*/, const
     }
     if (emptyTimeStep)
     {
-      this->ResetPreviewContentAtTimeStep(timeStep);
+      ResetImageContentAtTimeStep(previewImage, timeStep);
     }
   }
 }
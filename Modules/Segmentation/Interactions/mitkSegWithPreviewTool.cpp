@@ -17,6 +17,7 @@ found in the LICENSE file.
 #include "mitkColorProperty.h"
 #include "mitkProperties.h"
 
+#include "mitkBaseRenderer.h"
 #include "mitkDataStorage.h"
 #include "mitkRenderingManager.h"
 
@@ -28,6 +29,148 @@ found in the LICENSE file.
 #include "mitkNodePredicateGeometry.h"
 #include "mitkSegTool2D.h"
 
+#include <itkCommand.h>
+#include <itkProcessObject.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+  /** Cancellation token of the background preview update that is computed by the current thread (if any).*/
+  thread_local const mitk::SegWithPreviewTool::CancellationToken* CurrentCancellationToken = nullptr;
+
+  /** Aborts the observed filter on the next progress event once the token is cancelled.*/
+  class PreviewCancellationCommand : public itk::Command
+  {
+  public:
+    mitkClassMacroItkParent(PreviewCancellationCommand, itk::Command);
+    itkFactorylessNewMacro(Self);
+
+    void SetToken(const mitk::SegWithPreviewTool::CancellationToken* token) { m_Token = token; }
+
+    void Execute(itk::Object* caller, const itk::EventObject& event) override
+    {
+      auto filter = dynamic_cast<itk::ProcessObject*>(caller);
+
+      if (nullptr != filter && nullptr != m_Token && m_Token->IsCancelled() && itk::ProgressEvent().CheckEvent(&event))
+        filter->AbortGenerateDataOn();
+    }
+
+    void Execute(const itk::Object*, const itk::EventObject&) override
+    {
+    }
+
+  private:
+    const mitk::SegWithPreviewTool::CancellationToken* m_Token = nullptr;
+  };
+}
+
+/** Snapshot of everything the worker needs to compute a requested preview, taken on the requesting thread.*/
+struct mitk::SegWithPreviewTool::BackgroundPreviewJob
+{
+  /** Copies of the input and the working image for a time step of the preview.*/
+  struct TimeStepImages
+  {
+    TimeStepType TimeStep = 0;
+    Image::ConstPointer Input;
+    Image::ConstPointer Working;
+  };
+
+  unsigned long Generation = 0;
+  std::shared_ptr<CancellationToken> Token;
+  std::shared_ptr<const PreviewParameters> Parameters;
+  LabelSet::ConstPointer Labels;
+  /** Time steps of the preview to compute; the current time step comes first.*/
+  std::vector<TimeStepImages> TimeSteps;
+  TimePointType TimePoint = 0.;
+  /** Planes that should be delivered before the volume (only used by progressive previews).*/
+  std::vector<PlaneGeometry::ConstPointer> FocusPlanes;
+};
+
+struct mitk::SegWithPreviewTool::BackgroundPreviewWorker
+{
+  struct Result
+  {
+    unsigned long Generation = 0;
+    TimeStepType TimeStep = 0;
+    TimePointType TimePoint = 0.;
+    /** If set, Image is a slice that has to be written into the preview at this plane,
+     otherwise it is the complete volume of the time step.*/
+    PlaneGeometry::ConstPointer Plane;
+    LabelSetImage::Pointer Image;
+    std::string ErrorMessage;
+    bool IsFinal = false;
+  };
+
+  std::thread Thread;
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::unique_ptr<BackgroundPreviewJob> PendingJob;
+  std::shared_ptr<CancellationToken> RunningToken;
+  bool IsRunning = false;
+  bool Stop = false;
+  std::vector<Result> Results;
+  /** Generation of the latest request. Results of other generations are stale.*/
+  unsigned long Generation = 0;
+
+  /** Copy of a time step of an image the worker reads.*/
+  struct ImageCopy
+  {
+    Image::ConstPointer Source;
+    TimeStepType TimeStep = 0;
+    itk::ModifiedTimeType SourceMTime = 0;
+    Image::ConstPointer Copy;
+  };
+
+  /** Image copies of the latest request. They are reused by the next request as long as the source image
+   is not modified. Only accessed by the requesting thread.*/
+  std::vector<ImageCopy> ImageCopies;
+
+  /** Returns a copy of the time step of the image and adds it to usedCopies.*/
+  Image::ConstPointer CopyImage(const Image* image, TimeStepType timeStep, std::vector<ImageCopy>& usedCopies) const
+  {
+    if (nullptr == image)
+      return nullptr;
+
+    auto isCopyOfImage = [image, timeStep](const ImageCopy& copy)
+    {
+      return copy.Source.GetPointer() == image && copy.TimeStep == timeStep && copy.SourceMTime == image->GetMTime();
+    };
+
+    auto finding = std::find_if(usedCopies.begin(), usedCopies.end(), isCopyOfImage);
+
+    if (usedCopies.end() != finding)
+      return finding->Copy;
+
+    auto reusableCopy = std::find_if(ImageCopies.begin(), ImageCopies.end(), isCopyOfImage);
+
+    if (ImageCopies.end() != reusableCopy)
+    {
+      usedCopies.push_back(*reusableCopy);
+    }
+    else
+    {
+      ImageCopy copy;
+      copy.Source = image;
+      copy.TimeStep = timeStep;
+      copy.SourceMTime = image->GetMTime();
+      copy.Copy = GetImageByTimeStep(image, timeStep)->Clone().GetPointer();
+      usedCopies.push_back(copy);
+    }
+
+    return usedCopies.back().Copy;
+  }
+
+  void Post(Result result)
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    Results.push_back(std::move(result));
+  }
+};
+
 mitk::SegWithPreviewTool::SegWithPreviewTool(bool lazyDynamicPreviews): Tool("dummy"), m_LazyDynamicPreviews(lazyDynamicPreviews)
 {
   m_ProgressCommand = ToolCommand::New();
@@ -40,6 +183,21 @@ mitk::SegWithPreviewTool::SegWithPreviewTool(bool lazyDynamicPreviews, const cha
 
 mitk::SegWithPreviewTool::~SegWithPreviewTool()
 {
+  this->StopBackgroundPreviewWorker();
+}
+
+void mitk::SegWithPreviewTool::SetBackgroundPreviewUpdate(bool backgroundUpdate)
+{
+  if (m_BackgroundPreviewUpdate == backgroundUpdate)
+    return;
+
+  if (!backgroundUpdate)
+  {
+    this->CancelBackgroundPreviewUpdate(true);
+  }
+
+  m_BackgroundPreviewUpdate = backgroundUpdate;
+  this->Modified();
 }
 
 void mitk::SegWithPreviewTool::SetMergeStyle(MultiLabelSegmentation::MergeStyle mergeStyle)
@@ -123,6 +281,9 @@ void mitk::SegWithPreviewTool::Activated()
 
 void mitk::SegWithPreviewTool::Deactivated()
 {
+  // The worker calls virtual members of derived classes, thus it has to be gone before the tool is destroyed.
+  this->StopBackgroundPreviewWorker();
+
   this->GetToolManager()->RoiDataChanged -=
     MessageDelegate<SegWithPreviewTool>(this, &SegWithPreviewTool::OnRoiDataChanged);
 
@@ -157,10 +318,16 @@ void mitk::SegWithPreviewTool::Deactivated()
 void mitk::SegWithPreviewTool::ConfirmSegmentation()
 {
   bool labelChanged = this->EnsureUpToDateUserDefinedActiveLabel();
-  if ((m_LazyDynamicPreviews && m_CreateAllTimeSteps) || labelChanged)
+
+  // The confirmed preview has to be complete, so an unfinished background update is replaced
+  // by a synchronous one.
+  const bool backgroundUpdateIncomplete = this->IsBackgroundPreviewUpdatePending();
+  this->CancelBackgroundPreviewUpdate(true);
+
+  if ((m_LazyDynamicPreviews && m_CreateAllTimeSteps) || labelChanged || backgroundUpdateIncomplete)
   { // The tool should create all time steps but is currently in lazy mode,
     // thus ensure that a preview for all time steps is available.
-    this->UpdatePreview(true);
+    this->UpdatePreviewSynchronously(true);
   }
 
   CreateResultSegmentationFromPreview();
@@ -232,10 +399,15 @@ void ClearBufferProcessing(ImageType* itkImage)
 
 void mitk::SegWithPreviewTool::ResetPreviewContentAtTimeStep(unsigned int timeStep)
 {
-  auto previewImage = GetImageByTimeStep(this->GetPreviewSegmentation(), timeStep);
-  if (nullptr != previewImage)
+  ResetImageContentAtTimeStep(this->GetPreviewSegmentation(), timeStep);
+}
+
+void mitk::SegWithPreviewTool::ResetImageContentAtTimeStep(Image* image, TimeStepType timeStep)
+{
+  auto imageAtTimeStep = GetImageByTimeStep(image, timeStep);
+  if (nullptr != imageAtTimeStep)
   {
-    AccessByItk(previewImage, ClearBufferProcessing);
+    AccessByItk(imageAtTimeStep, ClearBufferProcessing);
   }
 }
 
@@ -258,6 +430,9 @@ void mitk::SegWithPreviewTool::ResetPreviewNode()
     mitkThrow() << "Used tool is implemented incorrectly. ResetPreviewNode is called while preview update is ongoing. Check implementation!";
   }
 
+  // results of pending background updates refer to the old preview
+  this->CancelBackgroundPreviewUpdate();
+
   itk::RGBPixel<float> previewColor;
   previewColor[0] = 0.0f;
   previewColor[1] = 1.0f;
@@ -518,6 +693,18 @@ bool mitk::SegWithPreviewTool::EnsureUpToDateUserDefinedActiveLabel()
 }
 
 void mitk::SegWithPreviewTool::UpdatePreview(bool ignoreLazyPreviewSetting)
+{
+  if (m_BackgroundPreviewUpdate && nullptr == this->GetWorkingPlaneGeometry())
+  {
+    this->RequestBackgroundPreviewUpdate(ignoreLazyPreviewSetting);
+  }
+  else
+  {
+    this->UpdatePreviewSynchronously(ignoreLazyPreviewSetting);
+  }
+}
+
+void mitk::SegWithPreviewTool::UpdatePreviewSynchronously(bool ignoreLazyPreviewSetting)
 {
   const auto inputImage = this->GetSegmentationInput();
   auto previewImage = this->GetPreviewSegmentation();
@@ -525,6 +712,7 @@ void mitk::SegWithPreviewTool::UpdatePreview(bool ignoreLazyPreviewSetting)
 
   const auto workingImage = dynamic_cast<const Image*>(this->GetToolManager()->GetWorkingData(0)->GetData());
   this->EnsureUpToDateUserDefinedActiveLabel();
+  const auto parameters = this->CapturePreviewParameters();
 
   this->CurrentlyBusy.Send(true);
   m_IsUpdating = true;
@@ -560,7 +748,7 @@ void mitk::SegWithPreviewTool::UpdatePreview(bool ignoreLazyPreviewSetting)
             currentSegImage = this->GetImageByTimePoint(workingImage, previewTimePoint);
           }
 
-          this->DoUpdatePreview(feedBackImage, currentSegImage, previewImage, timeStep);
+          this->DoUpdatePreviewWithParameters(feedBackImage, currentSegImage, previewImage, timeStep, *parameters);
         }
       }
       else
@@ -581,7 +769,7 @@ void mitk::SegWithPreviewTool::UpdatePreview(bool ignoreLazyPreviewSetting)
 
         auto timeStep = previewImage->GetTimeGeometry()->TimePointToTimeStep(timePoint);
 
-        this->DoUpdatePreview(feedBackImage, currentSegImage, previewImage, timeStep);
+        this->DoUpdatePreviewWithParameters(feedBackImage, currentSegImage, previewImage, timeStep, *parameters);
       }
       RenderingManager::GetInstance()->RequestUpdateAll();
     }
@@ -615,6 +803,365 @@ bool mitk::SegWithPreviewTool::IsUpdating() const
   return m_IsUpdating;
 }
 
+bool mitk::SegWithPreviewTool::IsBackgroundPreviewUpdatePending() const
+{
+  return m_BackgroundPreviewPending;
+}
+
+void mitk::SegWithPreviewTool::RequestBackgroundPreviewUpdate(bool ignoreLazyPreviewSetting)
+{
+  const auto inputImage = this->GetSegmentationInput();
+  auto previewImage = this->GetPreviewSegmentation();
+
+  if (nullptr == inputImage || nullptr == previewImage)
+    return;
+
+  this->EnsureUpToDateUserDefinedActiveLabel();
+
+  if (m_BackgroundPreviewPending)
+  { // the superseded request will never be finished
+    this->UpdateCleanUp();
+  }
+
+  this->UpdatePrepare();
+
+  if (nullptr == m_BackgroundWorker)
+  {
+    m_BackgroundWorker = std::make_unique<BackgroundPreviewWorker>();
+  }
+
+  auto job = std::make_unique<BackgroundPreviewJob>();
+  job->Token = std::make_shared<CancellationToken>();
+  job->Parameters = this->CapturePreviewParameters();
+  job->Labels = previewImage->GetActiveLabelSet()->Clone();
+  job->TimePoint = RenderingManager::GetInstance()->GetTimeNavigationController()->GetSelectedTimePoint();
+
+  const auto currentTimeStep = previewImage->GetTimeGeometry()->TimePointToTimeStep(job->TimePoint);
+  std::vector<TimeStepType> timeSteps = { currentTimeStep };
+
+  if (previewImage->GetTimeSteps() > 1 && (ignoreLazyPreviewSetting || !m_LazyDynamicPreviews))
+  {
+    for (TimeStepType timeStep = 0; timeStep < previewImage->GetTimeSteps(); ++timeStep)
+    {
+      if (timeStep != currentTimeStep)
+        timeSteps.push_back(timeStep);
+    }
+  }
+
+  // The worker only gets copies, as the images of the nodes may be changed on this thread meanwhile.
+  const auto workingImage = dynamic_cast<const Image*>(this->GetToolManager()->GetWorkingData(0)->GetData());
+  std::vector<BackgroundPreviewWorker::ImageCopy> imageCopies;
+
+  for (const auto timeStep : timeSteps)
+  {
+    const auto previewTimePoint = previewImage->GetTimeGeometry()->TimeStepToTimePoint(timeStep);
+
+    BackgroundPreviewJob::TimeStepImages images;
+    images.TimeStep = timeStep;
+    images.Input = m_BackgroundWorker->CopyImage(inputImage, inputImage->GetTimeGeometry()->TimePointToTimeStep(previewTimePoint), imageCopies);
+
+    if (nullptr != workingImage)
+      images.Working = m_BackgroundWorker->CopyImage(workingImage, workingImage->GetTimeGeometry()->TimePointToTimeStep(previewTimePoint), imageCopies);
+
+    job->TimeSteps.push_back(images);
+  }
+
+  m_BackgroundWorker->ImageCopies.swap(imageCopies);
+
+  if (m_ProgressivePreview)
+  {
+    for (const auto& renderWindow : RenderingManager::GetInstance()->GetAllRegisteredRenderWindows())
+    {
+      const auto renderer = BaseRenderer::GetInstance(renderWindow);
+
+      if (nullptr != renderer && BaseRenderer::Standard2D == renderer->GetMapperID() && nullptr != renderer->GetCurrentWorldPlaneGeometry())
+        job->FocusPlanes.push_back(renderer->GetCurrentWorldPlaneGeometry()->Clone().GetPointer());
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_BackgroundWorker->Mutex);
+
+    job->Generation = ++m_BackgroundWorker->Generation;
+    m_BackgroundWorker->PendingJob = std::move(job);
+
+    if (nullptr != m_BackgroundWorker->RunningToken)
+      m_BackgroundWorker->RunningToken->Cancel();
+  }
+
+  if (!m_BackgroundWorker->Thread.joinable())
+  {
+    m_BackgroundWorker->Stop = false;
+    m_BackgroundWorker->Thread = std::thread(&SegWithPreviewTool::ExecuteBackgroundPreviewJobs, this);
+  }
+
+  m_BackgroundWorker->Condition.notify_all();
+  m_BackgroundPreviewPending = true;
+}
+
+void mitk::SegWithPreviewTool::CancelBackgroundPreviewUpdate(bool waitForWorker)
+{
+  if (nullptr == m_BackgroundWorker)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_BackgroundWorker->Mutex);
+
+    ++m_BackgroundWorker->Generation;
+    m_BackgroundWorker->PendingJob.reset();
+    m_BackgroundWorker->Results.clear();
+
+    if (nullptr != m_BackgroundWorker->RunningToken)
+      m_BackgroundWorker->RunningToken->Cancel();
+
+    if (waitForWorker)
+      m_BackgroundWorker->Condition.wait(lock, [this]() { return !m_BackgroundWorker->IsRunning; });
+  }
+
+  if (m_BackgroundPreviewPending)
+  {
+    m_BackgroundPreviewPending = false;
+    this->UpdateCleanUp();
+  }
+}
+
+void mitk::SegWithPreviewTool::StopBackgroundPreviewWorker()
+{
+  if (nullptr == m_BackgroundWorker)
+    return;
+
+  this->CancelBackgroundPreviewUpdate();
+
+  {
+    std::lock_guard<std::mutex> lock(m_BackgroundWorker->Mutex);
+    m_BackgroundWorker->Stop = true;
+  }
+
+  m_BackgroundWorker->Condition.notify_all();
+
+  if (m_BackgroundWorker->Thread.joinable())
+    m_BackgroundWorker->Thread.join();
+
+  m_BackgroundWorker.reset();
+}
+
+void mitk::SegWithPreviewTool::ExecuteBackgroundPreviewJobs()
+{
+  auto& worker = *m_BackgroundWorker;
+  std::unique_lock<std::mutex> lock(worker.Mutex);
+
+  while (true)
+  {
+    worker.Condition.wait(lock, [&worker]() { return worker.Stop || nullptr != worker.PendingJob; });
+
+    if (worker.Stop)
+      break;
+
+    // only the latest request is computed, older ones were overwritten in PendingJob
+    auto job = std::move(worker.PendingJob);
+    worker.RunningToken = job->Token;
+    worker.IsRunning = true;
+    lock.unlock();
+
+    this->ExecuteBackgroundPreviewJob(*job);
+
+    lock.lock();
+    worker.RunningToken = nullptr;
+    worker.IsRunning = false;
+    worker.Condition.notify_all();
+  }
+}
+
+void mitk::SegWithPreviewTool::ExecuteBackgroundPreviewJob(const BackgroundPreviewJob& job)
+{
+  auto& worker = *m_BackgroundWorker;
+
+  // The worker only writes into images it created itself; they get the labels of the preview, so that
+  // DoUpdatePreview implementations find the same label information as in synchronous updates.
+  auto createResultImage = [&job](const Image* inputImage)
+  {
+    auto result = LabelSetImage::New();
+    result->Initialize(inputImage);
+    result->AddLabelSetToLayer(0, job.Labels->Clone());
+    return result;
+  };
+
+  auto post = [this, &worker, &job](BackgroundPreviewWorker::Result result)
+  {
+    if (job.Token->IsCancelled())
+      return false;
+
+    result.Generation = job.Generation;
+    result.TimePoint = job.TimePoint;
+    worker.Post(std::move(result));
+    this->BackgroundPreviewResultsAvailable.Send();
+    return true;
+  };
+
+  CurrentCancellationToken = job.Token.get();
+
+  try
+  {
+    for (std::size_t i = 0; i < job.TimeSteps.size(); ++i)
+    {
+      const auto timeStep = job.TimeSteps[i].TimeStep;
+      const Image* feedBackImage = job.TimeSteps[i].Input;
+      const Image* currentSegImage = job.TimeSteps[i].Working;
+
+      if (0 == i)
+      { // progressive delivery: the visible slices of the current time step first
+        for (const auto& plane : job.FocusPlanes)
+        {
+          int affectedDimension = 0;
+          int affectedSlice = 0;
+
+          if (job.Token->IsCancelled())
+            break;
+
+          if (!SegTool2D::DetermineAffectedImageSlice(feedBackImage, plane, affectedDimension, affectedSlice))
+            continue;
+
+          Image::ConstPointer feedBackSlice = SegTool2D::GetAffectedImageSliceAs2DImage(plane, feedBackImage, 0);
+          Image::ConstPointer currentSegSlice = SegTool2D::GetAffectedImageSliceAs2DImage(plane, currentSegImage, 0);
+
+          if (feedBackSlice.IsNull() || currentSegSlice.IsNull())
+            continue;
+
+          BackgroundPreviewWorker::Result result;
+          result.TimeStep = timeStep;
+          result.Plane = plane;
+          result.Image = createResultImage(feedBackSlice);
+
+          this->DoUpdatePreviewWithParameters(feedBackSlice, currentSegSlice, result.Image, 0, *job.Parameters);
+          post(std::move(result));
+        }
+      }
+
+      if (job.Token->IsCancelled())
+        break;
+
+      BackgroundPreviewWorker::Result result;
+      result.TimeStep = timeStep;
+      result.Image = createResultImage(feedBackImage);
+      result.IsFinal = job.TimeSteps.size() == i + 1;
+
+      this->DoUpdatePreviewWithParameters(feedBackImage, currentSegImage, result.Image, 0, *job.Parameters);
+
+      if (!post(std::move(result)))
+        break;
+    }
+  }
+  catch (const itk::ExceptionObject& e)
+  {
+    BackgroundPreviewWorker::Result result;
+    result.ErrorMessage = e.GetDescription();
+    result.IsFinal = true;
+    post(std::move(result));
+  }
+  catch (const std::exception& e)
+  {
+    BackgroundPreviewWorker::Result result;
+    result.ErrorMessage = e.what();
+    result.IsFinal = true;
+    post(std::move(result));
+  }
+
+  CurrentCancellationToken = nullptr;
+}
+
+void mitk::SegWithPreviewTool::ProcessBackgroundPreviewResults()
+{
+  if (nullptr == m_BackgroundWorker)
+    return;
+
+  std::vector<BackgroundPreviewWorker::Result> results;
+  unsigned long generation = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(m_BackgroundWorker->Mutex);
+    results.swap(m_BackgroundWorker->Results);
+    generation = m_BackgroundWorker->Generation;
+  }
+
+  auto previewImage = this->GetPreviewSegmentation();
+  bool previewChanged = false;
+
+  for (const auto& result : results)
+  {
+    if (result.Generation != generation || !m_BackgroundPreviewPending)
+      continue;
+
+    if (!result.ErrorMessage.empty())
+    {
+      MITK_ERROR << "Exception caught: " << result.ErrorMessage;
+      ErrorMessage.Send(result.ErrorMessage);
+    }
+    else if (nullptr != previewImage)
+    {
+      if (result.Plane.IsNotNull())
+      {
+        auto labelMapping = GetIdentityLabelMapping(result.Image);
+        TransferLabelInformation(labelMapping, result.Image, previewImage);
+        SegTool2D::WriteSliceToVolume(previewImage, result.Plane, result.Image, result.TimeStep, false);
+      }
+      else
+      {
+        TransferLabelSetImageContent(result.Image, previewImage, result.TimeStep);
+      }
+      previewChanged = true;
+    }
+
+    if (result.IsFinal)
+    {
+      m_LastTimePointOfUpdate = result.TimePoint;
+      m_BackgroundPreviewPending = false;
+      this->UpdateCleanUp();
+    }
+  }
+
+  if (previewChanged)
+  {
+    RenderingManager::GetInstance()->RequestUpdateAll();
+  }
+}
+
+bool mitk::SegWithPreviewTool::IsPreviewUpdateInBackground() const
+{
+  return nullptr != CurrentCancellationToken;
+}
+
+bool mitk::SegWithPreviewTool::IsPreviewUpdateCancelled() const
+{
+  return nullptr != CurrentCancellationToken && CurrentCancellationToken->IsCancelled();
+}
+
+void mitk::SegWithPreviewTool::ObservePreviewCancellation(itk::ProcessObject* filter) const
+{
+  if (nullptr == filter || nullptr == CurrentCancellationToken)
+    return;
+
+  auto command = PreviewCancellationCommand::New();
+  command->SetToken(CurrentCancellationToken);
+  filter->AddObserver(itk::ProgressEvent(), command);
+}
+
+std::shared_ptr<const mitk::SegWithPreviewTool::PreviewParameters> mitk::SegWithPreviewTool::CapturePreviewParameters() const
+{
+  auto parameters = std::make_shared<PreviewParameters>();
+  parameters->ActiveLabel = this->GetUserDefinedActiveLabel();
+  return parameters;
+}
+
+void mitk::SegWithPreviewTool::DoUpdatePreviewWithParameters(const Image* inputAtTimeStep, const Image* oldSegAtTimeStep, LabelSetImage* previewImage, TimeStepType timeStep, const PreviewParameters& /*parameters*/)
+{
+  if (this->IsPreviewUpdateInBackground())
+  {
+    mitkThrow() << "Tool " << this->GetName() << " does not support background preview updates. It has to implement DoUpdatePreviewWithParameters().";
+  }
+
+  this->DoUpdatePreview(inputAtTimeStep, oldSegAtTimeStep, previewImage, timeStep);
+}
+
 void mitk::SegWithPreviewTool::UpdatePrepare()
 {
   // default implementation does nothing
@@ -716,16 +1263,22 @@ mitk::DataNode* mitk::SegWithPreviewTool::GetTargetSegmentationNode() const
   return this->GetToolManager()->GetWorkingData(0);
 }
 
-void mitk::SegWithPreviewTool::TransferLabelSetImageContent(const LabelSetImage* source, LabelSetImage* target, TimeStepType timeStep)
+mitk::SegWithPreviewTool::LabelMappingType mitk::SegWithPreviewTool::GetIdentityLabelMapping(const LabelSetImage* image)
 {
-  mitk::ImageReadAccessor newMitkImgAcc(source);
-
   LabelMappingType labelMapping;
-  const auto labelSet = source->GetActiveLabelSet();
+  const auto labelSet = image->GetActiveLabelSet();
   for (auto labelIter = labelSet->IteratorConstBegin(); labelIter != labelSet->IteratorConstEnd(); ++labelIter)
   {
     labelMapping.push_back({ labelIter->second->GetValue(),labelIter->second->GetValue() });
   }
+  return labelMapping;
+}
+
+void mitk::SegWithPreviewTool::TransferLabelSetImageContent(const LabelSetImage* source, LabelSetImage* target, TimeStepType timeStep)
+{
+  mitk::ImageReadAccessor newMitkImgAcc(source);
+
+  auto labelMapping = GetIdentityLabelMapping(source);
   TransferLabelInformation(labelMapping, source, target);
 
   target->SetVolume(newMitkImgAcc.GetData(), timeStep);
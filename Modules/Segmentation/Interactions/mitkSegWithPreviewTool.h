@@ -19,6 +19,14 @@ found in the LICENSE file.
 #include "mitkToolCommand.h"
 #include <MitkSegmentationExports.h>
 
+#include <atomic>
+#include <memory>
+
+namespace itk
+{
+  class ProcessObject;
+}
+
 namespace mitk
 {
   /**
@@ -31,6 +39,18 @@ namespace mitk
   This class also takes care to properly transfer a confirmed preview into the segementation
   result.
 
+  If BackgroundPreviewUpdate is activated, UpdatePreview() does not block the calling thread.
+  The request is handed to a worker thread that always works on the latest request (stale
+  requests are superseded and the running computation is cancelled). Results are delivered
+  progressively: If ProgressivePreview is set, the slices currently shown in the 2D render windows
+  are computed first, followed by the volume of the current time step and the remaining time steps.
+  The worker signals new results with BackgroundPreviewResultsAvailable; they are transferred into
+  the preview by ProcessBackgroundPreviewResults(), which must be called on the UI thread.
+  The worker never reads members of the tool or the images of the data nodes: a request captures
+  the parameters of the tool (see CapturePreviewParameters()) and copies of the relevant time steps of
+  the input and the working image. Background updates therefore require a tool that implements
+  DoUpdatePreviewWithParameters().
+
   \ingroup ToolManagerEtAl
   \sa mitk::Tool
   \sa QmitkInteractiveSegmentation
@@ -62,6 +82,22 @@ namespace mitk
     itkGetMacro(ResetsToEmptyPreview, bool);
     itkBooleanMacro(ResetsToEmptyPreview);
 
+    /** Controls if UpdatePreview() computes the preview on a worker thread (true) or on the
+     calling thread (false). Only activate it if somebody calls ProcessBackgroundPreviewResults()
+     on the UI thread whenever BackgroundPreviewResultsAvailable is sent and if the tool implements
+     DoUpdatePreviewWithParameters().
+     Previews restricted to a working plane are always computed on the calling thread.*/
+    void SetBackgroundPreviewUpdate(bool backgroundUpdate);
+    itkGetMacro(BackgroundPreviewUpdate, bool);
+    itkBooleanMacro(BackgroundPreviewUpdate);
+
+    /** Controls if background previews first deliver the slices shown in the 2D render windows.
+     Only sensible for tools whose result for a voxel does not depend on voxels outside of the
+     slice (e.g. thresholding).*/
+    itkSetMacro(ProgressivePreview, bool);
+    itkGetMacro(ProgressivePreview, bool);
+    itkBooleanMacro(ProgressivePreview);
+
     /*itk macro was not used on purpose, to aviod the change of mtime.*/
     void SetMergeStyle(MultiLabelSegmentation::MergeStyle mergeStyle);
     itkGetMacro(MergeStyle, MultiLabelSegmentation::MergeStyle);
@@ -94,12 +130,52 @@ namespace mitk
      * will regard the setting specified by the constructor.
      * To define the update generation for time steps implement DoUpdatePreview.
      * To alter what should be done directly before or after the update of the preview,
-     * reimplement UpdatePrepare() or UpdateCleanUp().*/
+     * reimplement UpdatePrepare() or UpdateCleanUp().
+     * If BackgroundPreviewUpdate is active, the call only schedules the update and returns immediately.*/
     void UpdatePreview(bool ignoreLazyPreviewSetting = false);
 
     /** Indicate if currently UpdatePreview is triggered (true) or not (false).*/
     bool IsUpdating() const;
 
+    /** Indicates if a background preview update was requested whose final result was not
+     delivered by ProcessBackgroundPreviewResults() yet.*/
+    bool IsBackgroundPreviewUpdatePending() const;
+
+    /** Cancels the running background preview update and discards all pending requests and results.
+     * @param waitForWorker If true, the call blocks until the worker has left the cancelled computation.*/
+    void CancelBackgroundPreviewUpdate(bool waitForWorker = false);
+
+    /** Transfers the results of the background preview update into the preview segmentation.
+     Results of superseded requests are discarded. Must be called on the UI thread.*/
+    void ProcessBackgroundPreviewResults();
+
+    /** Sent by the worker thread whenever new background preview results are available.
+     Observers are called on the worker thread and should only schedule a call of
+     ProcessBackgroundPreviewResults() on the UI thread.*/
+    Message<> BackgroundPreviewResultsAvailable;
+
+    /** Parameters of the tool a preview update depends on. They are captured by CapturePreviewParameters()
+     when the update is requested, so that background updates do not read members of the tool that might be
+     changed meanwhile. Tools with further parameters derive from it.*/
+    struct PreviewParameters
+    {
+      virtual ~PreviewParameters() = default;
+
+      /** Label value that should be used for the preview (see GetUserDefinedActiveLabel()).*/
+      Label::PixelType ActiveLabel = 1;
+    };
+
+    /** Cancellation state of a background preview update.*/
+    class CancellationToken
+    {
+    public:
+      void Cancel() { m_Cancelled = true; }
+      bool IsCancelled() const { return m_Cancelled; }
+
+    private:
+      std::atomic<bool> m_Cancelled = { false };
+    };
+
     /**
    * @brief Gets the name of the currently selected segmentation node
    * @return the name of the segmentation node or an empty string if
@@ -179,6 +255,31 @@ namespace mitk
      */
     virtual void DoUpdatePreview(const Image* inputAtTimeStep, const Image* oldSegAtTimeStep, LabelSetImage* previewImage, TimeStepType timeStep) = 0;
 
+    /** Returns a copy of the parameters the preview update depends on. It is called on the thread that
+     requests the update. Reimplement it together with DoUpdatePreviewWithParameters() if the tool has
+     further parameters. The default implementation captures the user defined active label.*/
+    virtual std::shared_ptr<const PreviewParameters> CapturePreviewParameters() const;
+
+    /** Variant of DoUpdatePreview() that gets the parameters captured by CapturePreviewParameters().
+     It is called for all preview updates. Background updates call it on the worker thread, therefore
+     implementations must only use the passed images and parameters and must not access members of the tool.
+     The default implementation calls DoUpdatePreview() and throws for background updates.*/
+    virtual void DoUpdatePreviewWithParameters(const Image* inputAtTimeStep, const Image* oldSegAtTimeStep, LabelSetImage* previewImage, TimeStepType timeStep, const PreviewParameters& parameters);
+
+    /** Indicates if DoUpdatePreview is currently called by the background worker.
+     In this case implementations must only write into the passed preview image and must not
+     report progress to the (UI) progress bar.*/
+    bool IsPreviewUpdateInBackground() const;
+
+    /** Indicates if the background preview update that is currently computed in DoUpdatePreview was
+     superseded or cancelled. Implementations may poll it and return early; the results of a cancelled
+     update are discarded. Always returns false for synchronous updates.*/
+    bool IsPreviewUpdateCancelled() const;
+
+    /** Helper that aborts the passed filter (by AbortGenerateData on progress events) as soon as
+     the background preview update that is currently computed is cancelled.*/
+    void ObservePreviewCancellation(itk::ProcessObject* filter) const;
+
     /** Returns the input that should be used for any segmentation/preview or tool update.
      * It is either the data of ReferenceDataNode itself or a part of it defined by a ROI mask
      * provided by the tool manager. Derived classes should regard this as the relevant
@@ -204,6 +305,11 @@ namespace mitk
     time step does not exist, nothing happens.*/
     void ResetPreviewContentAtTimeStep(unsigned int timeStep);
 
+    /** Resets the image content of the specified timeStep of the passed image. Use it in DoUpdatePreview
+    instead of ResetPreviewContentAtTimeStep, as the passed preview image is not the preview of the
+    tool in case of background updates.*/
+    static void ResetImageContentAtTimeStep(Image* image, TimeStepType timeStep);
+
     TimePointType GetLastTimePointOfUpdate() const;
 
     itkGetConstMacro(UserDefinedActiveLabel, Label::PixelType);
@@ -212,6 +318,17 @@ namespace mitk
     itkGetConstObjectMacro(WorkingPlaneGeometry, PlaneGeometry);
 
   private:
+    struct BackgroundPreviewJob;
+    struct BackgroundPreviewWorker;
+
+    void UpdatePreviewSynchronously(bool ignoreLazyPreviewSetting);
+    void RequestBackgroundPreviewUpdate(bool ignoreLazyPreviewSetting);
+    void StopBackgroundPreviewWorker();
+    void ExecuteBackgroundPreviewJobs();
+    void ExecuteBackgroundPreviewJob(const BackgroundPreviewJob& job);
+
+    static LabelMappingType GetIdentityLabelMapping(const LabelSetImage* image);
+
     void TransferImageAtTimeStep(const Image* sourceImage, Image* destinationImage, const TimeStepType timeStep);
 
     void CreateResultSegmentationFromPreview();
@@ -262,6 +379,12 @@ namespace mitk
 
     bool m_IsUpdating = false;
 
+    bool m_BackgroundPreviewUpdate = false;
+    bool m_ProgressivePreview = false;
+    /** Indicates (on the UI thread) if a background update was requested and is not finished yet.*/
+    bool m_BackgroundPreviewPending = false;
+    std::unique_ptr<BackgroundPreviewWorker> m_BackgroundWorker;
+
     Label::PixelType m_UserDefinedActiveLabel = 1;
 
     /** This variable indicates if for the tool a working plane geometry is defined.
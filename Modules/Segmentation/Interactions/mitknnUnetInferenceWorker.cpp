@@ -0,0 +1,541 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitknnUnetInferenceWorker.h"
+
+#include "mitknnUnetTool.h"
+#include <mitkExceptionMacro.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+  using SocketType = SOCKET;
+  const SocketType InvalidSocket = INVALID_SOCKET;
+
+  void CloseSocket(SocketType socket) { closesocket(socket); }
+
+  void InitializeSockets()
+  {
+    static std::once_flag flag;
+    std::call_once(flag, []() {
+      WSADATA data;
+      if (0 != WSAStartup(MAKEWORD(2, 2), &data))
+        mitkThrow() << "Cannot initialize Windows sockets.";
+    });
+  }
+#else
+  using SocketType = int;
+  const SocketType InvalidSocket = -1;
+
+  void CloseSocket(SocketType socket) { close(socket); }
+
+  void InitializeSockets() {}
+#endif
+
+  const unsigned int ProtocolVersion = 1;
+
+  /** Chunk size of socket IO; keeps single system calls reasonable for large volumes.*/
+  const std::size_t MaximumChunkSize = 1 << 24;
+
+  /** Waits until the socket is readable. Returns false on timeout.*/
+  bool WaitForData(SocketType socket, double seconds)
+  {
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(socket, &readSet);
+    timeval timeout;
+    timeout.tv_sec = static_cast<long>(seconds);
+    timeout.tv_usec = static_cast<long>((seconds - timeout.tv_sec) * 1e6);
+    return select(static_cast<int>(socket + 1), &readSet, nullptr, nullptr, &timeout) > 0;
+  }
+
+  void SendAll(SocketType socket, const char *data, std::size_t size)
+  {
+    while (size > 0)
+    {
+      const auto chunk = static_cast<int>(std::min(size, MaximumChunkSize));
+#if defined(_WIN32) || defined(__APPLE__)
+      const auto sent = send(socket, data, chunk, 0);
+#else
+      const auto sent = send(socket, data, chunk, MSG_NOSIGNAL);
+#endif
+      if (sent <= 0)
+        mitkThrow() << "Connection to nnUNet worker lost while sending.";
+      data += sent;
+      size -= static_cast<std::size_t>(sent);
+    }
+  }
+
+  /** Receives size bytes. Throws if no data arrives for timeout seconds (a timeout <= 0 waits forever).*/
+  void ReceiveAll(SocketType socket, char *data, std::size_t size, double timeout)
+  {
+    while (size > 0)
+    {
+      if (timeout > 0 && !WaitForData(socket, timeout))
+        mitkThrow() << "nnUNet worker did not respond within " << timeout << " s.";
+
+      const auto chunk = static_cast<int>(std::min(size, MaximumChunkSize));
+      const auto received = recv(socket, data, chunk, 0);
+      if (received <= 0)
+        mitkThrow() << "Connection to nnUNet worker lost while receiving.";
+      data += received;
+      size -= static_cast<std::size_t>(received);
+    }
+  }
+
+  struct Buffer
+  {
+    const char *data;
+    std::size_t size;
+  };
+
+  void SendWorkerMessage(SocketType socket, nlohmann::json header, const std::vector<Buffer> &buffers = {})
+  {
+    auto &bufferSizes = header["buffers"] = nlohmann::json::array();
+    for (const auto &buffer : buffers)
+      bufferSizes.push_back(buffer.size);
+
+    const std::string headerText = header.dump();
+    char length[8];
+    for (int i = 0; i < 8; ++i)
+      length[i] = static_cast<char>((static_cast<std::uint64_t>(headerText.size()) >> (8 * i)) & 0xFF);
+
+    SendAll(socket, length, sizeof(length));
+    SendAll(socket, headerText.data(), headerText.size());
+    for (const auto &buffer : buffers)
+      SendAll(socket, buffer.data, buffer.size);
+  }
+
+  /** Receives a message; the payload buffers are stored consecutively in payload. Messages announcing more than
+   * maximumPayloadSize bytes are rejected before anything is allocated.*/
+  nlohmann::json ReceiveWorkerMessage(SocketType socket,
+                                      std::vector<char> &payload,
+                                      std::size_t maximumPayloadSize,
+                                      double timeout)
+  {
+    unsigned char length[8];
+    ReceiveAll(socket, reinterpret_cast<char *>(length), sizeof(length), timeout);
+    std::uint64_t headerSize = 0;
+    for (int i = 0; i < 8; ++i)
+      headerSize |= static_cast<std::uint64_t>(length[i]) << (8 * i);
+
+    if (headerSize > MaximumChunkSize)
+      mitkThrow() << "Invalid message header received from nnUNet worker.";
+
+    std::string headerText(static_cast<std::size_t>(headerSize), '\0');
+    ReceiveAll(socket, &headerText[0], headerText.size(), timeout);
+
+    nlohmann::json header;
+    std::size_t payloadSize = 0;
+    try
+    {
+      header = nlohmann::json::parse(headerText);
+      for (const auto &size : header.value("buffers", nlohmann::json::array()))
+      {
+        const auto bufferSize = size.get<std::uint64_t>();
+        if (bufferSize > maximumPayloadSize - payloadSize)
+          mitkThrow() << "nnUNet worker announced more than the expected " << maximumPayloadSize << " bytes.";
+        payloadSize += static_cast<std::size_t>(bufferSize);
+      }
+    }
+    catch (const nlohmann::json::exception &e)
+    {
+      mitkThrow() << "Invalid message header received from nnUNet worker: " << e.what();
+    }
+
+    try
+    {
+      payload.resize(payloadSize);
+    }
+    catch (const std::bad_alloc &)
+    {
+      mitkThrow() << "Cannot allocate " << payloadSize << " bytes for the message of the nnUNet worker.";
+    }
+
+    if (payloadSize > 0)
+      ReceiveAll(socket, payload.data(), payloadSize, timeout);
+
+    return header;
+  }
+
+  std::string GenerateToken()
+  {
+    std::random_device device;
+    std::ostringstream token;
+    for (int i = 0; i < 4; ++i)
+      token << std::hex << device();
+    return token.str();
+  }
+
+  /** Returns the numpy dtype name of the pixel type.*/
+  std::string GetDType(const mitk::PixelType &pixelType)
+  {
+    if (pixelType.GetNumberOfComponents() != 1)
+      mitkThrow() << "nnUNet worker only supports scalar images.";
+
+    const auto bits = std::to_string(pixelType.GetBpe());
+    switch (pixelType.GetComponentType())
+    {
+      case itk::IOComponentEnum::FLOAT:
+      case itk::IOComponentEnum::DOUBLE:
+        return "float" + bits;
+      case itk::IOComponentEnum::UCHAR:
+      case itk::IOComponentEnum::USHORT:
+      case itk::IOComponentEnum::UINT:
+      case itk::IOComponentEnum::ULONG:
+      case itk::IOComponentEnum::ULONGLONG:
+        return "uint" + bits;
+      case itk::IOComponentEnum::CHAR:
+      case itk::IOComponentEnum::SHORT:
+      case itk::IOComponentEnum::INT:
+      case itk::IOComponentEnum::LONG:
+      case itk::IOComponentEnum::LONGLONG:
+        return "int" + bits;
+      default:
+        mitkThrow() << "nnUNet worker does not support the pixel type " << pixelType.GetComponentTypeAsString();
+    }
+  }
+
+  mitk::PixelType GetLabelPixelType(const std::string &dtype)
+  {
+    if (dtype == "uint8")
+      return mitk::MakeScalarPixelType<unsigned char>();
+    if (dtype == "uint16")
+      return mitk::MakeScalarPixelType<unsigned short>();
+    if (dtype == "int16")
+      return mitk::MakeScalarPixelType<short>();
+    if (dtype == "int32")
+      return mitk::MakeScalarPixelType<int>();
+
+    mitkThrow() << "nnUNet worker returned unsupported label type " << dtype;
+  }
+
+  /** Image description in numpy/SimpleITK conventions: shape is (z, y, x), direction is row-major.*/
+  nlohmann::json DescribeImage(const mitk::Image *image)
+  {
+    const auto geometry = image->GetGeometry();
+    const auto spacing = geometry->GetSpacing();
+    const auto origin = geometry->GetOrigin();
+    const auto matrix = geometry->GetIndexToWorldTransform()->GetMatrix();
+
+    nlohmann::json description;
+    description["dtype"] = GetDType(image->GetPixelType());
+    description["shape"] = { image->GetDimension(2), image->GetDimension(1), image->GetDimension(0) };
+    description["spacing"] = { spacing[0], spacing[1], spacing[2] };
+    description["origin"] = { origin[0], origin[1], origin[2] };
+    auto &direction = description["direction"] = nlohmann::json::array();
+    for (unsigned int row = 0; row < 3; ++row)
+    {
+      for (unsigned int column = 0; column < 3; ++column)
+        direction.push_back(matrix[row][column] / spacing[column]);
+    }
+    return description;
+  }
+
+  std::size_t GetVoxelCount(const mitk::Image *image)
+  {
+    return static_cast<std::size_t>(image->GetDimension(0)) * image->GetDimension(1) * image->GetDimension(2);
+  }
+} // namespace
+
+struct mitk::nnUNetInferenceWorker::Connection
+{
+  SocketType socket = InvalidSocket;
+
+  ~Connection()
+  {
+    if (socket != InvalidSocket)
+      CloseSocket(socket);
+  }
+};
+
+mitk::nnUNetInferenceWorker::nnUNetInferenceWorker()
+  : m_StartTimeout(300.0), m_ResponseTimeout(3600.0), m_Process(nullptr)
+{
+}
+
+mitk::nnUNetInferenceWorker::~nnUNetInferenceWorker()
+{
+  try
+  {
+    this->Stop();
+  }
+  catch (...)
+  {
+    MITK_ERROR << "Could not stop nnUNet worker.";
+  }
+}
+
+void mitk::nnUNetInferenceWorker::Start(const std::string &executionPath, const ArgumentListType &argumentList)
+{
+  std::lock_guard<std::mutex> guard(m_Mutex);
+  this->Stop_unlocked();
+
+  InitializeSockets();
+
+  // listen on an ephemeral loopback port; the worker connects back to it
+  Connection listener;
+  listener.socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (listener.socket == InvalidSocket)
+    mitkThrow() << "Cannot create socket for nnUNet worker.";
+
+  sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  socklen_t addressLength = sizeof(address);
+
+  if (0 != bind(listener.socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) ||
+      0 != listen(listener.socket, 1) ||
+      0 != getsockname(listener.socket, reinterpret_cast<sockaddr *>(&address), &addressLength))
+    mitkThrow() << "Cannot listen for nnUNet worker connection.";
+
+  const auto token = GenerateToken();
+
+  ArgumentListType arguments = argumentList;
+  arguments.push_back("--port");
+  arguments.push_back(std::to_string(ntohs(address.sin_port)));
+  arguments.push_back("--token");
+  arguments.push_back(token);
+
+  std::vector<const char *> rawArguments;
+  for (const auto &argument : arguments)
+    rawArguments.push_back(argument.c_str());
+  rawArguments.push_back(nullptr);
+
+  m_Process = itksysProcess_New();
+  itksysProcess_SetCommand(m_Process, rawArguments.data());
+  itksysProcess_SetWorkingDirectory(m_Process, executionPath.c_str());
+  // output is not read while the worker is idle, thus it must not block on full pipes
+  itksysProcess_SetPipeShared(m_Process, itksysProcess_Pipe_STDOUT, 1);
+  itksysProcess_SetPipeShared(m_Process, itksysProcess_Pipe_STDERR, 1);
+  itksysProcess_Execute(m_Process);
+
+  if (itksysProcess_GetState(m_Process) != itksysProcess_State_Executing)
+  {
+    const std::string error = itksysProcess_GetErrorString(m_Process);
+    this->Stop_unlocked();
+    mitkThrow() << "Cannot launch nnUNet worker: " << error;
+  }
+
+  // wait for the connection, but do not wait for a worker that already died (e.g. missing python packages)
+  auto connection = std::make_unique<Connection>();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(m_StartTimeout);
+  while (connection->socket == InvalidSocket)
+  {
+    if (WaitForData(listener.socket, 0.1))
+    {
+      connection->socket = accept(listener.socket, nullptr, nullptr);
+      continue;
+    }
+
+    double noWait = 0.0;
+    if (itksysProcess_WaitForExit(m_Process, &noWait) || std::chrono::steady_clock::now() > deadline)
+    {
+      this->Stop_unlocked();
+      mitkThrow() << "nnUNet worker did not connect.";
+    }
+  }
+
+  int noDelay = 1;
+  setsockopt(connection->socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&noDelay), sizeof(noDelay));
+
+  try
+  {
+    if (!WaitForData(connection->socket, m_StartTimeout))
+      mitkThrow() << "nnUNet worker did not send hello.";
+
+    std::vector<char> payload;
+    const auto hello = ReceiveWorkerMessage(connection->socket, payload, 0, m_StartTimeout);
+    if (hello.value("command", "") != "hello" || hello.value("token", "") != token)
+      mitkThrow() << "Unexpected connection instead of nnUNet worker.";
+    if (hello.value("version", 0u) != ProtocolVersion)
+      mitkThrow() << "nnUNet worker protocol version " << hello.value("version", 0u) << " is not supported.";
+  }
+  catch (const mitk::Exception &)
+  {
+    this->Stop_unlocked();
+    throw;
+  }
+
+  m_Connection = std::move(connection);
+}
+
+bool mitk::nnUNetInferenceWorker::IsRunning() const
+{
+  std::lock_guard<std::mutex> guard(m_Mutex);
+  return nullptr != m_Connection;
+}
+
+void mitk::nnUNetInferenceWorker::Stop()
+{
+  std::lock_guard<std::mutex> guard(m_Mutex);
+  this->Stop_unlocked();
+}
+
+void mitk::nnUNetInferenceWorker::Stop_unlocked()
+{
+  if (nullptr != m_Connection)
+  {
+    try
+    {
+      SendWorkerMessage(m_Connection->socket, { { "command", "shutdown" } });
+    }
+    catch (const mitk::Exception &)
+    {
+      // worker is already gone
+    }
+    m_Connection.reset();
+  }
+
+  if (nullptr != m_Process)
+  {
+    if (itksysProcess_GetState(m_Process) == itksysProcess_State_Executing)
+    {
+      double timeout = 5.0;
+      if (!itksysProcess_WaitForExit(m_Process, &timeout))
+      {
+        itksysProcess_Kill(m_Process);
+        itksysProcess_WaitForExit(m_Process, nullptr);
+      }
+    }
+    itksysProcess_Delete(m_Process);
+    m_Process = nullptr;
+  }
+}
+
+mitk::Image::Pointer mitk::nnUNetInferenceWorker::Predict(const std::vector<const Image *> &modalities,
+                                                          const std::vector<ModelParams> &models,
+                                                          bool mirror,
+                                                          bool mixedPrecision,
+                                                          const std::string &postProcessingJson)
+{
+  if (modalities.empty() || models.empty())
+    mitkThrow() << "nnUNet worker needs at least one image and one model.";
+
+  std::lock_guard<std::mutex> guard(m_Mutex);
+  if (nullptr == m_Connection)
+    mitkThrow() << "nnUNet worker is not running.";
+
+  const Image *reference = modalities.front();
+  const auto voxelCount = GetVoxelCount(reference);
+
+  nlohmann::json request;
+  request["command"] = "predict";
+  request["mirror"] = mirror;
+  request["mixedPrecision"] = mixedPrecision;
+  request["postProcessingJson"] = postProcessingJson;
+
+  auto &modelDescriptions = request["models"] = nlohmann::json::array();
+  for (const auto &model : models)
+  {
+    modelDescriptions.push_back({ { "task", model.task },
+                                  { "model", model.model },
+                                  { "trainer", model.trainer },
+                                  { "planId", model.planId },
+                                  { "folds", model.folds } });
+  }
+
+  // the accessors keep the buffers locked until they are sent
+  std::vector<std::unique_ptr<ImageReadAccessor>> accessors;
+  std::vector<Buffer> buffers;
+  auto &imageDescriptions = request["images"] = nlohmann::json::array();
+  for (const auto image : modalities)
+  {
+    if (GetVoxelCount(image) != voxelCount)
+      mitkThrow() << "All modalities of a nnUNet prediction must have the same size.";
+
+    imageDescriptions.push_back(DescribeImage(image));
+    accessors.push_back(std::make_unique<ImageReadAccessor>(image));
+    buffers.push_back({ static_cast<const char *>(accessors.back()->GetData()),
+                        voxelCount * image->GetPixelType().GetSize() });
+  }
+
+  std::vector<char> payload;
+  nlohmann::json response;
+  try
+  {
+    SendWorkerMessage(m_Connection->socket, request, buffers);
+    accessors.clear();
+
+    // results stream back after any number of progress messages
+    while (true)
+    {
+      // the largest label type the worker may return is int32
+      response = ReceiveWorkerMessage(m_Connection->socket, payload, voxelCount * sizeof(int), m_ResponseTimeout);
+      const auto status = response.value("status", "");
+      if (status == "progress")
+      {
+        const auto message = response.value("message", "");
+        MITK_INFO << message;
+        this->InvokeEvent(ExternalProcessStdOutEvent(message));
+      }
+      else if (status == "error")
+      {
+        mitkThrow() << "nnUNet worker failed: " << response.value("message", "");
+      }
+      else if (status == "result")
+      {
+        break;
+      }
+      else
+      {
+        mitkThrow() << "Unexpected message from nnUNet worker: " << response.dump();
+      }
+    }
+  }
+  catch (const mitk::Exception &)
+  {
+    // a broken connection cannot be resynchronized; errors reported by the worker keep it alive
+    if (response.value("status", "") != "error")
+      this->Stop_unlocked();
+    throw;
+  }
+
+  const auto labelType = GetLabelPixelType(response.value("image", nlohmann::json::object()).value("dtype", ""));
+  if (payload.size() != voxelCount * labelType.GetSize())
+    mitkThrow() << "nnUNet worker returned " << payload.size() << " bytes instead of "
+                << voxelCount * labelType.GetSize() << ".";
+
+  auto result = Image::New();
+  result->Initialize(labelType, *reference->GetGeometry());
+  {
+    ImageWriteAccessor accessor(result);
+    std::memcpy(accessor.GetData(), payload.data(), payload.size());
+  }
+  return result;
+}
@@ -0,0 +1,111 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitknnUnetInferenceWorker_h_Included
+#define mitknnUnetInferenceWorker_h_Included
+
+#include "mitkProcessExecutor.h"
+#include <MitkSegmentationExports.h>
+#include <mitkImage.h>
+
+#include <memory>
+#include <mutex>
+
+namespace mitk
+{
+  struct ModelParams;
+
+  /**
+   * @brief Long-lived nnUNet inference process that keeps the models resident between predictions.
+   *
+   * Start() launches the worker script and waits until it connects back to a socket on the loopback interface. The
+   * images of a prediction are sent as raw voxel buffers together with their geometry, the label image is streamed
+   * back the same way. Thus neither the process startup, the loading of the models nor any file IO is repeated.
+   *
+   * Protocol: every message consists of the length of a JSON header (8 byte, little endian), the UTF-8 encoded header
+   * and the raw buffers whose byte sizes are listed in the "buffers" entry of the header. The worker starts with a
+   * "hello" message containing the token passed on its command line. Afterwards it answers every "predict" request
+   * with any number of "progress" messages, followed by either a "result" or an "error" message.
+   * See Resources/nnUNet/nnunet_worker.py for the reference implementation of the worker side.
+   *
+   * Progress messages of the worker are passed on as ExternalProcessStdOutEvent.
+   */
+  class MITKSEGMENTATION_EXPORT nnUNetInferenceWorker : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(nnUNetInferenceWorker, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    using ArgumentListType = ProcessExecutor::ArgumentListType;
+
+    /** Seconds to wait for the worker to connect after the process was launched.*/
+    itkSetMacro(StartTimeout, double);
+    itkGetConstMacro(StartTimeout, double);
+
+    /** Seconds Predict() waits for the next message of the worker (a progress message resets the timeout). The
+     * worker is stopped if it does not respond in time. A value <= 0 waits forever. Default: 3600.*/
+    itkSetMacro(ResponseTimeout, double);
+    itkGetConstMacro(ResponseTimeout, double);
+
+    /**
+     * @brief Launches the worker process and waits for its connection. A running worker is stopped before.
+     * The arguments "--port <port> --token <token>" are appended to the argument list.
+     *
+     * @param executionPath Working directory of the process.
+     * @param argumentList Executable (already converted by ProcessExecutor::GetOSDependendExecutableName) and its
+     * arguments.
+     * @throw mitk::Exception if the process cannot be launched or does not connect in time.
+     */
+    void Start(const std::string &executionPath, const ArgumentListType &argumentList);
+
+    /** Indicates if the worker process is connected and can accept requests.*/
+    bool IsRunning() const;
+
+    /** Asks the worker to shut down and kills the process if it does not exit in time.*/
+    void Stop();
+
+    /**
+     * @brief Predicts the segmentation of the passed modalities with the (ensemble of) models.
+     *
+     * @param modalities 2D or 3D scalar images with identical dimensions. The geometry of the first image is used for
+     * the result.
+     * @param models Models to predict with; the softmax outputs of several models are averaged.
+     * @param mirror Use mirroring as test time augmentation.
+     * @param mixedPrecision Use mixed precision.
+     * @param postProcessingJson Optional postprocessing json of an ensemble.
+     * @throw mitk::Exception if the request fails. The worker is stopped if the connection is broken, the worker does
+     * not respond within ResponseTimeout or announces a result larger than the passed images.
+     */
+    Image::Pointer Predict(const std::vector<const Image *> &modalities,
+                           const std::vector<ModelParams> &models,
+                           bool mirror,
+                           bool mixedPrecision,
+                           const std::string &postProcessingJson = "");
+
+  protected:
+    nnUNetInferenceWorker();
+    ~nnUNetInferenceWorker() override;
+
+  private:
+    struct Connection;
+
+    void Stop_unlocked();
+
+    double m_StartTimeout;
+    double m_ResponseTimeout;
+    itksysProcess *m_Process;
+    std::unique_ptr<Connection> m_Connection;
+    mutable std::mutex m_Mutex;
+  };
+} // namespace mitk
+
+#endif
@@ -19,6 +19,7 @@ found in the LICENSE file.
 #include <usModule.h>
 #include <usModuleContext.h>
 #include <usModuleResource.h>
+#include <usModuleResourceStream.h>
 
 namespace mitk
 {
@@ -32,9 +33,19 @@ mitk::nnUNetTool::nnUNetTool()
 
 mitk::nnUNetTool::~nnUNetTool()
 {
+  this->StopWorker();
   itksys::SystemTools::RemoveADirectory(this->GetMitkTempDir());
 }
 
+void mitk::nnUNetTool::StopWorker()
+{
+  if (m_Worker.IsNotNull())
+  {
+    m_Worker->Stop();
+  }
+  m_WorkerConfiguration.clear();
+}
+
 void mitk::nnUNetTool::Activated()
 {
   Superclass::Activated();
@@ -126,8 +137,131 @@ namespace
   }
 } // namespace
 
+std::string mitk::nnUNetTool::GetWorkerScriptPath()
+{
+  if (!this->GetWorkerScript().empty())
+  {
+    return this->GetWorkerScript();
+  }
+
+  const std::string scriptPath = this->GetMitkTempDir() + IOUtil::GetDirectorySeparator() + "nnunet_worker.py";
+  if (!itksys::SystemTools::FileExists(scriptPath))
+  {
+    us::ModuleResource resource = us::GetModuleContext()->GetModule()->GetResource("nnUNet/nnunet_worker.py");
+    if (!resource.IsValid())
+    {
+      mitkThrow() << "nnUNet worker script resource is missing.";
+    }
+    us::ModuleResourceStream resourceStream(resource, std::ios_base::binary);
+    std::ofstream scriptStream(scriptPath, std::ios_base::binary);
+    scriptStream << resourceStream.rdbuf();
+    if (!scriptStream)
+    {
+      mitkThrow() << "Cannot write nnUNet worker script to " << scriptPath;
+    }
+  }
+  return scriptPath;
+}
+
+mitk::Image::Pointer mitk::nnUNetTool::PredictWithWorker(const Image *inputAtTimeStep)
+{
+  for (const ModelParams &modelparam : m_ParamQ)
+  {
+    if (modelparam.model.find("cascade") != std::string::npos)
+    {
+      // cascades need the low resolution prediction of the previous stage
+      return nullptr;
+    }
+  }
+
+  std::vector<const Image *> modalities;
+  if (this->GetMultiModal())
+  {
+    for (const auto &modalImage : m_OtherModalPaths)
+    {
+      modalities.push_back(modalImage.GetPointer());
+    }
+  }
+  else
+  {
+    modalities.push_back(inputAtTimeStep);
+  }
+
+  // the environment of the worker is fixed at its start
+  const std::string configuration = this->GetPythonPath() + '\n' + this->GetModelDirectory() + '\n' +
+                                    std::to_string(this->GetGpuId()) + '\n' + this->GetWorkerScript();
+
+  try
+  {
+    if (m_Worker.IsNull())
+    {
+      m_Worker = nnUNetInferenceWorker::New();
+    }
+
+    if (!m_Worker->IsRunning() || configuration != m_WorkerConfiguration)
+    {
+      std::string resultsFolderEnv = "RESULTS_FOLDER=" + this->GetModelDirectory();
+      itksys::SystemTools::PutEnv(resultsFolderEnv.c_str());
+      std::string cudaEnv = "CUDA_VISIBLE_DEVICES=" + std::to_string(this->GetGpuId());
+      itksys::SystemTools::PutEnv(cudaEnv.c_str());
+
+#ifdef _WIN32
+      const std::string python = "python";
+#else
+      const std::string python = "python3";
+#endif
+      ProcessExecutor::ArgumentListType args;
+      args.push_back(ProcessExecutor::GetOSDependendExecutableName(python));
+      args.push_back(this->GetWorkerScriptPath());
+
+      m_WorkerConfiguration.clear();
+      m_Worker->Start(this->GetPythonPath(), args);
+      m_WorkerConfiguration = configuration;
+    }
+
+    const std::string postProcessingJson = this->GetEnsemble() ? this->GetPostProcessingJsonDirectory() : "";
+    return m_Worker->Predict(
+      modalities, m_ParamQ, this->GetMirror(), this->GetMixedPrecision(), postProcessingJson);
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_WARN << "nnUNet worker could not be used, falling back to one-shot prediction: " << e.GetDescription();
+  }
+  return nullptr;
+}
+
+void mitk::nnUNetTool::SetPredictionResult(Image *outputImage, const Image *inputAtTimeStep, LabelSetImage *previewImage)
+{
+  previewImage->InitializeByLabeledImage(outputImage);
+  previewImage->SetGeometry(inputAtTimeStep->GetGeometry());
+  m_InputBuffer = inputAtTimeStep;
+  m_OutputBuffer = mitk::LabelSetImage::New();
+  m_OutputBuffer->InitializeByLabeledImage(outputImage);
+  m_OutputBuffer->SetGeometry(inputAtTimeStep->GetGeometry());
+}
+
 void mitk::nnUNetTool::DoUpdatePreview(const Image* inputAtTimeStep, const Image* /*oldSegAtTimeStep*/, LabelSetImage* previewImage, TimeStepType /*timeStep*/)
 {
+  if (this->GetPersistentWorker())
+  {
+    auto outputImage = this->PredictWithWorker(inputAtTimeStep);
+    if (outputImage.IsNotNull())
+    {
+      try
+      {
+        this->SetPredictionResult(outputImage, inputAtTimeStep, previewImage);
+      }
+      catch (const mitk::Exception &e)
+      {
+        /*
+        Can't throw mitk exception to the caller. Refer: T28691
+        */
+        MITK_ERROR << e.GetDescription();
+      }
+      return;
+    }
+  }
+
   std::string inDir, outDir, inputImagePath, outputImagePath, scriptPath;
 
   ProcessExecutor::Pointer spExec = ProcessExecutor::New();
@@ -302,12 +436,7 @@ void mitk::nnUNetTool::DoUpdatePreview(const Image* inputAtTimeStep, const Image
   try
   {
     Image::Pointer outputImage = IOUtil::Load<Image>(outputImagePath);
-    previewImage->InitializeByLabeledImage(outputImage);
-    previewImage->SetGeometry(inputAtTimeStep->GetGeometry());
-    m_InputBuffer = inputAtTimeStep;
-    m_OutputBuffer = mitk::LabelSetImage::New();
-    m_OutputBuffer->InitializeByLabeledImage(outputImage);
-    m_OutputBuffer->SetGeometry(inputAtTimeStep->GetGeometry());
+    this->SetPredictionResult(outputImage, inputAtTimeStep, previewImage);
   }
   catch (const mitk::Exception &e)
   {
@@ -15,6 +15,7 @@ found in the LICENSE file.
 
 #include "mitkSegWithPreviewTool.h"
 #include "mitkCommon.h"
+#include "mitknnUnetInferenceWorker.h"
 #include "mitkToolManager.h"
 #include <MitkSegmentationExports.h>
 #include <mitkStandardFileLocations.h>
@@ -120,6 +121,27 @@ namespace mitk
     itkSetMacro(GpuId, unsigned int);
     itkGetConstMacro(GpuId, unsigned int);
 
+    /**
+     * @brief Predict with a long-lived worker process that keeps the models loaded (see nnUNetInferenceWorker)
+     * instead of starting nnUNet_predict for every update. The one-shot prediction remains the fallback, if the
+     * worker cannot be used.
+     */
+    itkSetMacro(PersistentWorker, bool);
+    itkGetConstMacro(PersistentWorker, bool);
+    itkBooleanMacro(PersistentWorker);
+
+    /**
+     * @brief Path of the worker script used in persistent worker mode. If empty, the script shipped as resource of
+     * this module is used.
+     */
+    itkSetMacro(WorkerScript, std::string);
+    itkGetConstMacro(WorkerScript, std::string);
+
+    /**
+     * @brief Stops the persistent worker and thus releases the loaded models.
+     */
+    void StopWorker();
+
     /**
      * @brief vector of ModelParams.
      * Size > 1 only for ensemble prediction.
@@ -184,6 +206,8 @@ namespace mitk
      * 3. Iterates through the parameter queue (m_ParamQ) and executes "nnUNet_predict" command with the parameters
      * 4. Expects an output image to be saved in the temporary directory by the python proces. Loads it as
      *    LabelSetImage and sets to previewImage.
+     * In persistent worker mode the images are passed to the worker directly instead; the steps above are only
+     * executed if the worker fails.
      *
      * @param inputAtTimeStep
      * @param oldSegAtTimeStep
@@ -193,6 +217,16 @@ namespace mitk
     void DoUpdatePreview(const Image* inputAtTimeStep, const Image* oldSegAtTimeStep, LabelSetImage* previewImage, TimeStepType timeStep) override;
 
   private:
+    /**
+     * @brief Predicts with the persistent worker and (re)starts it if needed.
+     * @return The label image or nullptr, if the worker cannot be used for the current parameters.
+     */
+    Image::Pointer PredictWithWorker(const Image *inputAtTimeStep);
+
+    std::string GetWorkerScriptPath();
+
+    void SetPredictionResult(Image *outputImage, const Image *inputAtTimeStep, LabelSetImage *previewImage);
+
     std::string m_MitkTempDir;
     std::string m_nnUNetDirectory;
     std::string m_ModelDirectory;
@@ -206,6 +240,10 @@ namespace mitk
     bool m_MultiModal;
     bool m_Ensemble = false;
     bool m_Predict;
+    bool m_PersistentWorker = false;
+    std::string m_WorkerScript;
+    nnUNetInferenceWorker::Pointer m_Worker;
+    std::string m_WorkerConfiguration;
     LabelSetImage::Pointer m_OutputBuffer;
     unsigned int m_GpuId;
     const std::string m_TEMPLATE_FILENAME = "XXXXXX_000_0000.nii.gz";
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+"""Persistent nnUNet (v1) inference worker of the MITK nnUNet tool.
+
+The worker connects to the MITK process (see mitk::nnUNetInferenceWorker) and
+answers prediction requests until it is asked to shut down. Loaded models stay
+in memory between requests, images are exchanged as raw voxel buffers.
+
+Every message consists of the length of a JSON header (8 byte, little endian),
+the UTF-8 encoded header and the raw buffers whose byte sizes are listed in
+the "buffers" entry of the header.
+"""
+
+import argparse
+import json
+import socket
+import struct
+import sys
+import traceback
+from os.path import join
+
+import numpy as np
+
+PROTOCOL_VERSION = 1
+MAXIMUM_CHUNK_SIZE = 1 << 24
+
+
+def receive_exactly(connection, size):
+    buffer = bytearray(size)
+    view = memoryview(buffer)
+    position = 0
+    while position < size:
+        received = connection.recv_into(view[position:], min(size - position, MAXIMUM_CHUNK_SIZE))
+        if received == 0:
+            raise ConnectionError("Connection to MITK closed.")
+        position += received
+    return buffer
+
+
+def receive_message(connection):
+    (length,) = struct.unpack("<Q", receive_exactly(connection, 8))
+    header = json.loads(receive_exactly(connection, length).decode("utf-8"))
+    buffers = [receive_exactly(connection, size) for size in header.get("buffers", [])]
+    return header, buffers
+
+
+def send_message(connection, header, arrays=()):
+    buffers = [memoryview(np.ascontiguousarray(array)).cast("B") for array in arrays]
+    header = dict(header, buffers=[len(buffer) for buffer in buffers])
+    text = json.dumps(header).encode("utf-8")
+    connection.sendall(struct.pack("<Q", len(text)) + text)
+    for buffer in buffers:
+        connection.sendall(buffer)
+
+
+class ModelCache:
+    """Keeps the trainers and checkpoints of all requested models."""
+
+    def __init__(self):
+        self.models = {}
+
+    def get(self, model, mixed_precision, progress):
+        folds = model.get("folds", [])
+        key = (model["task"], model["model"], model["trainer"], model["planId"], tuple(folds), mixed_precision)
+        if key not in self.models:
+            progress("Loading nnUNet model %s %s %s" % (model["task"], model["model"], model["trainer"]))
+            self.models[key] = self.load(model, folds, mixed_precision)
+        return self.models[key]
+
+    @staticmethod
+    def load(model, folds, mixed_precision):
+        from nnunet.paths import network_training_output_dir
+        from nnunet.training.model_restore import load_model_and_checkpoint_files
+        from nnunet.utilities.task_name_id_conversion import convert_id_to_task_name
+
+        task = model["task"]
+        if not task.startswith("Task"):
+            task = convert_id_to_task_name(int(task))
+        folder = join(network_training_output_dir, model["model"], task, model["trainer"] + "__" + model["planId"])
+
+        if not folds:
+            folds = None
+        elif folds != ["all"]:
+            folds = [int(fold) for fold in folds]
+
+        return load_model_and_checkpoint_files(folder, folds, mixed_precision=mixed_precision,
+                                               checkpoint_name="model_final_checkpoint")
+
+
+def create_case(images, buffers):
+    """Creates data and properties like nnunet.preprocessing.cropping.load_case_from_list_of_files."""
+    data = np.stack([np.frombuffer(buffer, dtype=image["dtype"]).reshape(image["shape"])
+                     for image, buffer in zip(images, buffers)]).astype(np.float32)
+    reference = images[0]
+    properties = {
+        "original_size_of_raw_data": np.array(data.shape[1:]),
+        "original_spacing": np.array(reference["spacing"])[[2, 1, 0]],
+        "list_of_data_files": [],
+        "seg_file": None,
+        "itk_origin": tuple(reference["origin"]),
+        "itk_spacing": tuple(reference["spacing"]),
+        "itk_direction": tuple(reference["direction"]),
+    }
+    return data, properties
+
+
+def predict_softmax(trainer, params, data, properties, mirror, mixed_precision):
+    """Predicts the softmax of all folds in the cropped, original spacing (like nnUNet_predict with --save_npz)."""
+    import nnunet
+    from nnunet.preprocessing.cropping import ImageCropper
+    from nnunet.preprocessing.preprocessing import get_do_separate_z, get_lowres_axis, resample_data_or_seg
+    from nnunet.training.model_restore import recursive_find_python_class
+
+    preprocessor_name = trainer.plans.get("preprocessor_name", "GenericPreprocessor")
+    preprocessor_class = recursive_find_python_class([join(nnunet.__path__[0], "preprocessing")], preprocessor_name,
+                                                     current_module="nnunet.preprocessing")
+    preprocessor = preprocessor_class(trainer.normalization_schemes, trainer.use_mask_for_norm,
+                                      trainer.transpose_forward, trainer.intensity_properties)
+
+    data, seg, properties = ImageCropper.crop(data, dict(properties), None)
+    transpose = (0, *[i + 1 for i in trainer.transpose_forward])
+    data, seg = data.transpose(transpose), seg.transpose(transpose)
+    data, seg, properties = preprocessor.resample_and_normalize(
+        data, trainer.plans["plans_per_stage"][trainer.stage]["current_spacing"], properties, seg,
+        force_separate_z=None)
+    data = data.astype(np.float32)
+
+    softmax = []
+    for checkpoint in params:
+        trainer.load_checkpoint_ram(checkpoint, False)
+        softmax.append(trainer.predict_preprocessed_data_return_seg_and_softmax(
+            data, do_mirroring=mirror, mirror_axes=trainer.data_aug_params["mirror_axes"], use_sliding_window=True,
+            step_size=0.5, use_gaussian=True, all_in_gpu=False, mixed_precision=mixed_precision)[1][None])
+    softmax = np.vstack(softmax).mean(0)
+
+    transpose_backward = trainer.plans.get("transpose_backward")
+    if transpose_backward is not None:
+        softmax = softmax.transpose([0] + [i + 1 for i in transpose_backward])
+
+    shape_after_cropping = properties["size_after_cropping"]
+    if np.any(np.array(softmax.shape[1:]) != np.array(shape_after_cropping)):
+        lowres_axis = None
+        if get_do_separate_z(properties["original_spacing"]):
+            lowres_axis = get_lowres_axis(properties["original_spacing"])
+        elif get_do_separate_z(properties["spacing_after_resampling"]):
+            lowres_axis = get_lowres_axis(properties["spacing_after_resampling"])
+        do_separate_z = lowres_axis is not None and len(lowres_axis) == 1
+        softmax = resample_data_or_seg(softmax, shape_after_cropping, is_seg=False, axis=lowres_axis, order=1,
+                                       do_separate_z=do_separate_z, order_z=0)
+    return softmax, properties
+
+
+def predict(header, buffers, cache, progress):
+    models = header["models"]
+    mirror = header.get("mirror", True)
+    mixed_precision = header.get("mixedPrecision", True)
+    data, properties = create_case(header["images"], buffers)
+
+    softmax = None
+    for model in models:
+        if "cascade" in model["model"]:
+            raise ValueError("Cascade models are not supported by the persistent worker.")
+        trainer, params = cache.get(model, mixed_precision, progress)
+        progress("Predicting with nnUNet model %s %s" % (model["task"], model["model"]))
+        model_softmax, cropped_properties = predict_softmax(trainer, params, data, properties, mirror,
+                                                            mixed_precision)
+        softmax = model_softmax if softmax is None else softmax + model_softmax
+    segmentation = (softmax / len(models)).argmax(0)
+
+    # revert the cropping
+    shape = cropped_properties["original_size_of_raw_data"]
+    bbox = cropped_properties.get("crop_bbox")
+    if bbox is not None:
+        result = np.zeros(shape, dtype=segmentation.dtype)
+        result[tuple(slice(bbox[c][0], min(bbox[c][0] + segmentation.shape[c], shape[c])) for c in range(3))] = \
+            segmentation
+        segmentation = result
+
+    post_processing_json = header.get("postProcessingJson", "")
+    if post_processing_json:
+        from nnunet.postprocessing.connected_components import load_postprocessing, \
+            remove_all_but_the_largest_connected_component
+        for_which_classes, min_valid_object_size = load_postprocessing(post_processing_json)
+        volume_per_voxel = float(np.prod(properties["itk_spacing"], dtype=np.float64))
+        segmentation = remove_all_but_the_largest_connected_component(
+            segmentation, for_which_classes, volume_per_voxel, min_valid_object_size)[0]
+
+    return segmentation.astype(np.uint8 if segmentation.max() < 256 else np.uint16)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Persistent nnUNet inference worker of MITK.")
+    parser.add_argument("--port", type=int, required=True)
+    parser.add_argument("--token", required=True)
+    args = parser.parse_args()
+
+    connection = socket.create_connection(("127.0.0.1", args.port))
+    connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    send_message(connection, {"command": "hello", "token": args.token, "version": PROTOCOL_VERSION})
+
+    def progress(message):
+        send_message(connection, {"status": "progress", "message": message})
+
+    cache = ModelCache()
+    while True:
+        try:
+            header, buffers = receive_message(connection)
+        except ConnectionError:
+            break
+
+        command = header.get("command")
+        if command == "shutdown":
+            break
+        if command != "predict":
+            send_message(connection, {"status": "error", "message": "Unknown command %s" % command})
+            continue
+
+        try:
+            segmentation = predict(header, buffers, cache, progress)
+        except Exception as e:
+            traceback.print_exc()
+            send_message(connection, {"status": "error", "message": str(e)})
+            continue
+        send_message(connection, {"status": "result",
+                                  "image": {"dtype": segmentation.dtype.name, "shape": list(segmentation.shape)}},
+                     [segmentation])
+
+    connection.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,664 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkBitMask.h"
+#include <mitkExceptionMacro.h>
+#include <mitkImageAccessByItk.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+  using WordType = mitk::BitMask::WordType;
+  const unsigned int WordBits = 64;
+
+  unsigned int CountTrailingZeros(WordType word)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return __builtin_ctzll(word);
+#endif
+  }
+
+  unsigned int CountBits(WordType word)
+  {
+#if defined(_MSC_VER)
+    return static_cast<unsigned int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+  }
+
+  /** Returns the first voxel >= position of the row with the given value or size if there is none.*/
+  unsigned int FindNext(const WordType *row, unsigned int size, unsigned int position, bool value)
+  {
+    while (position < size)
+    {
+      WordType word = row[position / WordBits];
+      if (!value)
+        word = ~word;
+      word &= ~WordType(0) << (position % WordBits);
+      if (word != 0)
+        return std::min(size, (position / WordBits) * WordBits + CountTrailingZeros(word));
+      position = (position / WordBits + 1) * WordBits;
+    }
+    return size;
+  }
+
+  /** Sets the voxels first..last (inclusive) of the row.*/
+  void SetRange(WordType *row, unsigned int first, unsigned int last)
+  {
+    const unsigned int firstWord = first / WordBits;
+    const unsigned int lastWord = last / WordBits;
+    const WordType firstMask = ~WordType(0) << (first % WordBits);
+    const WordType lastMask = ~WordType(0) >> (WordBits - 1 - last % WordBits);
+    if (firstWord == lastWord)
+    {
+      row[firstWord] |= firstMask & lastMask;
+      return;
+    }
+    row[firstWord] |= firstMask;
+    for (unsigned int w = firstWord + 1; w < lastWord; ++w)
+      row[w] = ~WordType(0);
+    row[lastWord] |= lastMask;
+  }
+
+  /** ORs the union of the blocks i - radius..i + radius of the input into block i of the output, for n consecutive
+  * blocks of blockWords words (van Herk/Gil-Werman: two passes per window size 2 * radius + 1).*/
+  void DilateBlocks(const WordType *input, WordType *output, std::size_t n, std::size_t blockWords, unsigned int radius)
+  {
+    const std::size_t length = n + 2 * radius;
+    const std::size_t window = 2 * radius + 1;
+    std::vector<WordType> prefix(length * blockWords);
+    std::vector<WordType> suffix(length * blockWords);
+
+    // Padded block i is input block i - radius, blocks outside of the input are empty
+    auto inputBlock = [&](std::size_t i) -> const WordType * {
+      return (i < radius || i >= n + radius) ? nullptr : input + (i - radius) * blockWords;
+    };
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      const WordType *block = inputBlock(i);
+      WordType *current = prefix.data() + i * blockWords;
+      const WordType *previous = (i % window == 0) ? nullptr : current - blockWords;
+      for (std::size_t b = 0; b < blockWords; ++b)
+        current[b] = (previous ? previous[b] : 0) | (block ? block[b] : 0);
+    }
+    for (std::size_t i = length; i-- > 0;)
+    {
+      const WordType *block = inputBlock(i);
+      WordType *current = suffix.data() + i * blockWords;
+      const WordType *next = (i % window == window - 1 || i == length - 1) ? nullptr : current + blockWords;
+      for (std::size_t b = 0; b < blockWords; ++b)
+        current[b] = (next ? next[b] : 0) | (block ? block[b] : 0);
+    }
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const WordType *first = suffix.data() + i * blockWords;
+      const WordType *last = prefix.data() + (i + 2 * radius) * blockWords;
+      WordType *out = output + i * blockWords;
+      for (std::size_t b = 0; b < blockWords; ++b)
+        out[b] |= first[b] | last[b];
+    }
+  }
+
+  std::int64_t FloorDivide(std::int64_t numerator, std::int64_t denominator)
+  {
+    std::int64_t quotient = numerator / denominator;
+    if ((numerator % denominator != 0) && ((numerator < 0) != (denominator < 0)))
+      --quotient;
+    return quotient;
+  }
+
+  /** One pass of the squared distance transform along a line:
+  * out(p) = min_q values(q) + weight * (p - q)^2. Values larger than maximum are set to maximum + 1.*/
+  void TransformLine(std::vector<std::int64_t> &values, std::int64_t weight, std::int64_t maximum,
+    std::vector<std::size_t> &sites, std::vector<std::size_t> &starts)
+  {
+    const std::int64_t infinity = maximum + 1;
+    const std::size_t n = values.size();
+    auto f = [&](std::size_t x, std::size_t site) {
+      const std::int64_t d = std::int64_t(x) - std::int64_t(site);
+      return values[site] + weight * d * d;
+    };
+
+    // Lower envelope of the parabolas of all sites (Meijster et al.)
+    std::size_t q = 0;
+    bool empty = true;
+    for (std::size_t u = 0; u < n; ++u)
+    {
+      if (values[u] >= infinity)
+        continue;
+      if (empty)
+      {
+        sites[0] = u;
+        starts[0] = 0;
+        empty = false;
+        continue;
+      }
+      while (!empty && f(starts[q], sites[q]) > f(starts[q], u))
+      {
+        if (q == 0)
+          empty = true;
+        else
+          --q;
+      }
+      if (empty)
+      {
+        q = 0;
+        sites[0] = u;
+        starts[0] = 0;
+        empty = false;
+      }
+      else
+      {
+        const std::int64_t s = std::int64_t(sites[q]);
+        const std::int64_t separation = 1 + FloorDivide(weight * (std::int64_t(u) * std::int64_t(u) - s * s) + values[u] - values[sites[q]],
+          2 * weight * (std::int64_t(u) - s));
+        if (separation < std::int64_t(n))
+        {
+          ++q;
+          sites[q] = u;
+          starts[q] = static_cast<std::size_t>(separation);
+        }
+      }
+    }
+    if (empty)
+      return;
+
+    std::vector<std::int64_t> result(n);
+    for (std::size_t x = n; x-- > 0;)
+    {
+      result[x] = std::min(f(x, sites[q]), infinity);
+      if (x == starts[q] && q > 0)
+        --q;
+    }
+    values.swap(result);
+  }
+
+  template <typename TPixel, unsigned int VDimension>
+  void PackItkImage(const itk::Image<TPixel, VDimension> *itkImage, mitk::BitMask &mask, bool &isBinary)
+  {
+    const auto &size = mask.GetSize();
+    const TPixel *buffer = itkImage->GetBufferPointer();
+    isBinary = true;
+    for (unsigned int z = 0; z < size[2]; ++z)
+    {
+      for (unsigned int y = 0; y < size[1]; ++y)
+      {
+        const TPixel *row = buffer + (std::size_t(z) * size[1] + y) * size[0];
+        for (unsigned int x = 0; x < size[0]; ++x)
+        {
+          if (row[x] != TPixel(0))
+          {
+            mask.SetVoxel(x, y, z, true);
+            if (row[x] != TPixel(1))
+              isBinary = false;
+          }
+        }
+      }
+    }
+  }
+
+  template <typename TPixel, unsigned int VDimension>
+  void UnpackItkImage(itk::Image<TPixel, VDimension> *itkImage, const mitk::BitMask &mask)
+  {
+    const auto &size = mask.GetSize();
+    TPixel *buffer = itkImage->GetBufferPointer();
+    for (unsigned int z = 0; z < size[2]; ++z)
+    {
+      for (unsigned int y = 0; y < size[1]; ++y)
+      {
+        TPixel *row = buffer + (std::size_t(z) * size[1] + y) * size[0];
+        const WordType *words = mask.GetRow(y, z);
+        for (unsigned int x = 0; x < size[0]; ++x)
+          row[x] = ((words[x / WordBits] >> (x % WordBits)) & 1) ? TPixel(1) : TPixel(0);
+      }
+    }
+  }
+}
+
+mitk::BitMask::BitMask() : BitMask(SizeType({ { 0, 0, 0 } }))
+{
+}
+
+mitk::BitMask::BitMask(const SizeType &size)
+  : m_Size(size),
+    m_WordsPerRow((size[0] + WordBits - 1) / WordBits),
+    m_Words(m_WordsPerRow * size[1] * size[2], 0)
+{
+}
+
+mitk::BitMask mitk::BitMask::FromImage(const Image *image, bool *isBinary)
+{
+  if (nullptr == image)
+    mitkThrow() << "Image is nullptr!";
+
+  const auto dimension = image->GetDimension();
+  if (dimension < 2 || dimension > 3)
+    mitkThrow() << "BitMask supports 2D and 3D images only, image has " << dimension << " dimensions!";
+
+  SizeType size = { { image->GetDimension(0), image->GetDimension(1), dimension > 2 ? image->GetDimension(2) : 1 } };
+  BitMask mask(size);
+  bool binary = true;
+  AccessByItk_n(image, PackItkImage, (mask, binary));
+
+  if (nullptr != isBinary)
+    *isBinary = binary;
+  return mask;
+}
+
+mitk::Image::Pointer mitk::BitMask::ToImage(const Image *referenceImage) const
+{
+  if (nullptr == referenceImage)
+    mitkThrow() << "Reference image is nullptr!";
+  return this->ToImage(referenceImage, referenceImage->GetPixelType());
+}
+
+mitk::Image::Pointer mitk::BitMask::ToImage(const Image *referenceImage, const PixelType &pixelType) const
+{
+  if (nullptr == referenceImage)
+    mitkThrow() << "Reference image is nullptr!";
+
+  const auto dimension = referenceImage->GetDimension();
+  if (dimension < 2 || dimension > 3 || referenceImage->GetDimension(0) != m_Size[0] ||
+      referenceImage->GetDimension(1) != m_Size[1] || (dimension > 2 ? referenceImage->GetDimension(2) : 1) != m_Size[2])
+    mitkThrow() << "Reference image does not match the size of the mask!";
+
+  auto image = Image::New();
+  image->Initialize(pixelType, dimension, referenceImage->GetDimensions());
+  image->SetClonedTimeGeometry(referenceImage->GetTimeGeometry());
+  AccessByItk_1(image, UnpackItkImage, *this);
+  return image;
+}
+
+std::size_t mitk::BitMask::GetNumberOfVoxels() const
+{
+  return std::size_t(m_Size[0]) * m_Size[1] * m_Size[2];
+}
+
+std::size_t mitk::BitMask::GetNumberOfForegroundVoxels() const
+{
+  std::size_t count = 0;
+  for (auto word : m_Words)
+    count += CountBits(word);
+  return count;
+}
+
+bool mitk::BitMask::GetVoxel(unsigned int x, unsigned int y, unsigned int z) const
+{
+  return (this->GetRow(y, z)[x / WordBits] >> (x % WordBits)) & 1;
+}
+
+void mitk::BitMask::SetVoxel(unsigned int x, unsigned int y, unsigned int z, bool foreground)
+{
+  const WordType bit = WordType(1) << (x % WordBits);
+  if (foreground)
+    this->GetRow(y, z)[x / WordBits] |= bit;
+  else
+    this->GetRow(y, z)[x / WordBits] &= ~bit;
+}
+
+const mitk::BitMask::WordType *mitk::BitMask::GetRow(unsigned int y, unsigned int z) const
+{
+  return m_Words.data() + (std::size_t(z) * m_Size[1] + y) * m_WordsPerRow;
+}
+
+mitk::BitMask::WordType *mitk::BitMask::GetRow(unsigned int y, unsigned int z)
+{
+  return m_Words.data() + (std::size_t(z) * m_Size[1] + y) * m_WordsPerRow;
+}
+
+void mitk::BitMask::CheckSize(const BitMask &other) const
+{
+  if (m_Size != other.m_Size)
+    mitkThrow() << "Masks have different sizes!";
+}
+
+void mitk::BitMask::ClearPadding()
+{
+  if (m_Size[0] % WordBits == 0)
+    return;
+
+  const WordType mask = (WordType(1) << (m_Size[0] % WordBits)) - 1;
+  for (std::size_t i = m_WordsPerRow - 1; i < m_Words.size(); i += m_WordsPerRow)
+    m_Words[i] &= mask;
+}
+
+mitk::BitMask &mitk::BitMask::operator&=(const BitMask &other)
+{
+  this->CheckSize(other);
+  const WordType *otherWords = other.m_Words.data();
+  WordType *words = m_Words.data();
+  for (std::size_t i = 0; i < m_Words.size(); ++i)
+    words[i] &= otherWords[i];
+  return *this;
+}
+
+mitk::BitMask &mitk::BitMask::operator|=(const BitMask &other)
+{
+  this->CheckSize(other);
+  const WordType *otherWords = other.m_Words.data();
+  WordType *words = m_Words.data();
+  for (std::size_t i = 0; i < m_Words.size(); ++i)
+    words[i] |= otherWords[i];
+  return *this;
+}
+
+mitk::BitMask &mitk::BitMask::operator^=(const BitMask &other)
+{
+  this->CheckSize(other);
+  const WordType *otherWords = other.m_Words.data();
+  WordType *words = m_Words.data();
+  for (std::size_t i = 0; i < m_Words.size(); ++i)
+    words[i] ^= otherWords[i];
+  return *this;
+}
+
+mitk::BitMask &mitk::BitMask::Subtract(const BitMask &other)
+{
+  this->CheckSize(other);
+  const WordType *otherWords = other.m_Words.data();
+  WordType *words = m_Words.data();
+  for (std::size_t i = 0; i < m_Words.size(); ++i)
+    words[i] &= ~otherWords[i];
+  return *this;
+}
+
+void mitk::BitMask::Invert()
+{
+  WordType *words = m_Words.data();
+  for (std::size_t i = 0; i < m_Words.size(); ++i)
+    words[i] = ~words[i];
+  this->ClearPadding();
+}
+
+bool mitk::BitMask::operator==(const BitMask &other) const
+{
+  return m_Size == other.m_Size && m_Words == other.m_Words;
+}
+
+bool mitk::BitMask::IsSupportedBallRadius(const RadiusType &radius) const
+{
+  // All values of the distance transform (weight * distance^2 + 2 * threshold) have to fit into 62 bits
+  long double threshold = 1;
+  for (unsigned int i = 0; i < 3; ++i)
+    threshold *= (2.0L * radius[i] + 1) * (2.0L * radius[i] + 1);
+
+  const long double limit = std::ldexp(1.0L, 62);
+  if (3 * threshold >= limit)
+    return false;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const long double weight = 4 * threshold / ((2.0L * radius[i] + 1) * (2.0L * radius[i] + 1));
+    if (radius[i] > 0 && weight * m_Size[i] * m_Size[i] + 3 * threshold >= limit)
+      return false;
+  }
+  return true;
+}
+
+mitk::BitMask mitk::BitMask::Dilate(const RadiusType &radius, StructuringElementType element) const
+{
+  BitMask result(m_Size);
+  if (element == Ball)
+    this->ApplyBall(radius, false, result);
+  else
+    this->DilateCross(radius, result);
+  return result;
+}
+
+mitk::BitMask mitk::BitMask::Erode(const RadiusType &radius, StructuringElementType element) const
+{
+  BitMask result(m_Size);
+  if (element == Ball)
+  {
+    this->ApplyBall(radius, true, result);
+    return result;
+  }
+
+  // A voxel remains foreground if the element does not reach a background voxel. Voxels outside of the mask are
+  // foreground, so the erosion is the inverted dilation of the inverted mask.
+  BitMask inverted = *this;
+  inverted.Invert();
+  inverted.DilateCross(radius, result);
+  result.Invert();
+  return result;
+}
+
+mitk::BitMask mitk::BitMask::Opening(const RadiusType &radius, StructuringElementType element) const
+{
+  return this->Erode(radius, element).Dilate(radius, element);
+}
+
+mitk::BitMask mitk::BitMask::Closing(const RadiusType &radius, StructuringElementType element) const
+{
+  // Pad the mask with background, so the erosion does not treat voxels outside of the mask as foreground
+  SizeType paddedSize;
+  for (unsigned int i = 0; i < 3; ++i)
+    paddedSize[i] = m_Size[i] + 2 * radius[i];
+
+  BitMask padded(paddedSize);
+  for (unsigned int z = 0; z < m_Size[2]; ++z)
+  {
+    for (unsigned int y = 0; y < m_Size[1]; ++y)
+    {
+      const WordType *row = this->GetRow(y, z);
+      for (unsigned int x = FindNext(row, m_Size[0], 0, true); x < m_Size[0];)
+      {
+        const unsigned int end = FindNext(row, m_Size[0], x, false);
+        SetRange(padded.GetRow(y + radius[1], z + radius[2]), x + radius[0], end - 1 + radius[0]);
+        x = FindNext(row, m_Size[0], end, true);
+      }
+    }
+  }
+
+  const BitMask closed = padded.Dilate(radius, element).Erode(radius, element);
+
+  BitMask result(m_Size);
+  for (unsigned int z = 0; z < m_Size[2]; ++z)
+  {
+    for (unsigned int y = 0; y < m_Size[1]; ++y)
+    {
+      const WordType *row = closed.GetRow(y + radius[1], z + radius[2]);
+      for (unsigned int x = FindNext(row, paddedSize[0], radius[0], true); x < m_Size[0] + radius[0];)
+      {
+        const unsigned int end = std::min(FindNext(row, paddedSize[0], x, false), m_Size[0] + radius[0]);
+        SetRange(result.GetRow(y, z), x - radius[0], end - 1 - radius[0]);
+        x = FindNext(row, paddedSize[0], end, true);
+      }
+    }
+  }
+  return result;
+}
+
+void mitk::BitMask::DilateCross(const RadiusType &radius, BitMask &result) const
+{
+  // The cross is the union of the center and one line per axis
+  result.m_Words = m_Words;
+
+  if (radius[0] > 0)
+  {
+    for (unsigned int z = 0; z < m_Size[2]; ++z)
+    {
+      for (unsigned int y = 0; y < m_Size[1]; ++y)
+      {
+        const WordType *row = this->GetRow(y, z);
+        WordType *resultRow = result.GetRow(y, z);
+        for (unsigned int x = FindNext(row, m_Size[0], 0, true); x < m_Size[0];)
+        {
+          const unsigned int end = FindNext(row, m_Size[0], x, false);
+          SetRange(resultRow, x > radius[0] ? x - radius[0] : 0, std::min(end - 1 + radius[0], m_Size[0] - 1));
+          x = FindNext(row, m_Size[0], end, true);
+        }
+      }
+    }
+  }
+
+  if (radius[1] > 0)
+  {
+    const std::size_t sliceWords = m_WordsPerRow * m_Size[1];
+    for (unsigned int z = 0; z < m_Size[2]; ++z)
+      DilateBlocks(m_Words.data() + z * sliceWords, result.m_Words.data() + z * sliceWords, m_Size[1], m_WordsPerRow, radius[1]);
+  }
+
+  if (radius[2] > 0)
+    DilateBlocks(m_Words.data(), result.m_Words.data(), m_Size[2], m_WordsPerRow * m_Size[1], radius[2]);
+}
+
+void mitk::BitMask::ApplyBall(const RadiusType &radius, bool erode, BitMask &result) const
+{
+  if (!this->IsSupportedBallRadius(radius))
+    mitkThrow() << "Radius (" << radius[0] << ", " << radius[1] << ", " << radius[2] << ") is too large for a ball!";
+
+  // Only voxels within the radius of the bounding box of the foreground can change: a dilation can only reach them,
+  // an erosion only needs the background voxels within them (voxels outside of the mask are foreground).
+  std::array<unsigned int, 3> minimum = m_Size;
+  std::array<unsigned int, 3> maximum = { { 0, 0, 0 } };
+  bool hasForeground = false;
+  for (unsigned int z = 0; z < m_Size[2]; ++z)
+  {
+    for (unsigned int y = 0; y < m_Size[1]; ++y)
+    {
+      const WordType *row = this->GetRow(y, z);
+      const unsigned int first = FindNext(row, m_Size[0], 0, true);
+      if (first >= m_Size[0])
+        continue;
+      unsigned int last = first;
+      for (unsigned int x = first; x < m_Size[0];)
+      {
+        const unsigned int end = FindNext(row, m_Size[0], x, false);
+        last = end - 1;
+        x = FindNext(row, m_Size[0], end, true);
+      }
+      hasForeground = true;
+      minimum = { { std::min(minimum[0], first), std::min(minimum[1], y), std::min(minimum[2], z) } };
+      maximum = { { std::max(maximum[0], last), std::max(maximum[1], y), std::max(maximum[2], z) } };
+    }
+  }
+  if (!hasForeground)
+    return;
+
+  std::array<unsigned int, 3> regionStart;
+  std::array<std::size_t, 3> regionSize;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    regionStart[i] = minimum[i] > radius[i] ? minimum[i] - radius[i] : 0;
+    regionSize[i] = std::min<std::size_t>(std::size_t(maximum[i]) + radius[i] + 1, m_Size[i]) - regionStart[i];
+  }
+
+  // A voxel is within the ball around a foreground voxel if sum_i (2 d_i)^2 / (2 r_i + 1)^2 <= 1. Multiplied
+  // with the product of all denominators, the distances are integers.
+  std::int64_t threshold = 1;
+  for (unsigned int i = 0; i < 3; ++i)
+    threshold *= std::int64_t(2 * radius[i] + 1) * (2 * radius[i] + 1);
+  const std::int64_t infinity = threshold + 1;
+
+  // The transform is calculated slice by slice, so only one slice of distances is kept instead of the whole region.
+  // The first pass (along z) is the distance to the nearest site within the radius in the same column: sites that are
+  // farther away are beyond the threshold anyway. It is read directly from the words of the neighboring slices.
+  const std::int64_t weightZ =
+    radius[2] > 0 ? 4 * threshold / (std::int64_t(2 * radius[2] + 1) * (2 * radius[2] + 1)) : 0;
+  const std::array<std::size_t, 2> strides = { { 1, regionSize[0] } };
+  std::vector<std::int64_t> distances(regionSize[0] * regionSize[1]);
+  std::vector<WordType> found(m_WordsPerRow);
+  std::vector<std::int64_t> line;
+  std::vector<std::size_t> sites;
+  std::vector<std::size_t> starts;
+
+  for (std::size_t z = 0; z < regionSize[2]; ++z)
+  {
+    // Distances to the foreground (dilation) or to the background (erosion) voxels along z
+    std::fill(distances.begin(), distances.end(), infinity);
+    for (std::size_t y = 0; y < regionSize[1]; ++y)
+    {
+      std::fill(found.begin(), found.end(), 0);
+      std::int64_t *distanceRow = distances.data() + y * regionSize[0];
+      for (unsigned int d = 0; d <= radius[2]; ++d)
+      {
+        for (int side = 0; side < (d == 0 ? 1 : 2); ++side)
+        {
+          if (side == 0 ? z + d >= regionSize[2] : z < d)
+            continue;
+
+          const std::size_t siteZ = regionStart[2] + (side == 0 ? z + d : z - d);
+          const WordType *row = this->GetRow(regionStart[1] + y, static_cast<unsigned int>(siteZ));
+          for (std::size_t w = 0; w < m_WordsPerRow; ++w)
+          {
+            WordType newSites = (erode ? ~row[w] : row[w]) & ~found[w];
+            found[w] |= newSites;
+            while (newSites != 0)
+            {
+              const std::size_t x = w * WordBits + CountTrailingZeros(newSites);
+              newSites &= newSites - 1;
+              if (x >= regionStart[0] && x < regionStart[0] + regionSize[0])
+                distanceRow[x - regionStart[0]] = weightZ * d * d;
+            }
+          }
+        }
+      }
+    }
+
+    // Separable transform of the slice, axes with radius 0 are skipped (the element does not extend along them)
+    for (unsigned int axis = 0; axis < 2; ++axis)
+    {
+      if (radius[axis] == 0)
+        continue;
+
+      const std::int64_t weight = 4 * threshold / (std::int64_t(2 * radius[axis] + 1) * (2 * radius[axis] + 1));
+      const std::size_t n = regionSize[axis];
+      line.resize(n);
+      sites.resize(n);
+      starts.resize(n);
+      const std::size_t numberOfLines = distances.size() / n;
+      for (std::size_t l = 0; l < numberOfLines; ++l)
+      {
+        // Index of the first voxel of line l (all indices with coordinate 0 along the axis)
+        const std::size_t lower = l % strides[axis];
+        const std::size_t first = lower + (l / strides[axis]) * strides[axis] * n;
+        bool hasSite = false;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          line[i] = distances[first + i * strides[axis]];
+          hasSite = hasSite || line[i] < infinity;
+        }
+        if (!hasSite)
+          continue;
+        TransformLine(line, weight, threshold, sites, starts);
+        for (std::size_t i = 0; i < n; ++i)
+          distances[first + i * strides[axis]] = line[i];
+      }
+    }
+
+    for (std::size_t y = 0; y < regionSize[1]; ++y)
+    {
+      WordType *row = result.GetRow(regionStart[1] + y, regionStart[2] + z);
+      for (std::size_t x = 0; x < regionSize[0]; ++x)
+      {
+        const bool reached = distances[y * regionSize[0] + x] <= threshold;
+        if (erode ? !reached && this->GetVoxel(regionStart[0] + x, regionStart[1] + y, regionStart[2] + z) : reached)
+        {
+          const std::size_t position = regionStart[0] + x;
+          row[position / WordBits] |= WordType(1) << (position % WordBits);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,130 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkBitMask_h
+#define mitkBitMask_h
+
+#include <MitkSegmentationExports.h>
+#include <mitkImage.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace mitk
+{
+  /** \brief Binary 2D or 3D mask that stores one bit per voxel.
+   *
+   * The voxels of each row (along x) are packed into 64 bit words, so boolean operations process 64 voxels per
+   * instruction (and are vectorized by the compiler). The bits of a row that exceed the image size are always zero.
+   *
+   * The morphological operations match the ITK binary filters used by MorphologicalOperations, but their cost does not
+   * grow with the radius of the structuring element:
+   * - Ball elements (voxels with \f$ \sum_i (d_i / (r_i + 0.5))^2 \leq 1 \f$, like itk::BinaryBallStructuringElement)
+   *   are applied by thresholding an exact, separable squared distance transform (integer arithmetic).
+   * - Cross elements (like itk::BinaryCrossStructuringElement) are the union of one line per axis. Lines along x are
+   *   applied to the runs of a row, lines along y and z with the van Herk/Gil-Werman algorithm on whole words.
+   *
+   * Voxels outside of the mask are background for a dilation and foreground for an erosion (like the ITK filters).
+   */
+  class MITKSEGMENTATION_EXPORT BitMask
+  {
+  public:
+    using WordType = std::uint64_t;
+    using SizeType = std::array<unsigned int, 3>;
+    using RadiusType = std::array<unsigned int, 3>;
+
+    enum StructuringElementType
+    {
+      Ball,
+      Cross
+    };
+
+    BitMask();
+    /** Creates a mask of the given size (z is 1 for 2D masks) without foreground voxels.*/
+    explicit BitMask(const SizeType &size);
+
+    /** \brief Creates a mask of a 2D or 3D image (a single time step) in which all non-zero voxels are foreground.
+     *
+     * Throws an mitk::Exception for images with more than three dimensions.
+     * \param[in] image The image that is packed.
+     * \param[out] isBinary Optional, set to true if all voxels of the image are 0 or 1, i.e. the image can be restored
+     *             from the mask.
+     */
+    static BitMask FromImage(const Image *image, bool *isBinary = nullptr);
+
+    /** \brief Creates an image with the geometry of the reference image and the foreground voxels set to 1.
+     *
+     * The image has the pixel type of the reference image if no pixel type is given.
+     */
+    Image::Pointer ToImage(const Image *referenceImage) const;
+    Image::Pointer ToImage(const Image *referenceImage, const PixelType &pixelType) const;
+
+    const SizeType &GetSize() const { return m_Size; }
+    std::size_t GetNumberOfVoxels() const;
+    std::size_t GetNumberOfForegroundVoxels() const;
+
+    bool GetVoxel(unsigned int x, unsigned int y, unsigned int z) const;
+    void SetVoxel(unsigned int x, unsigned int y, unsigned int z, bool foreground);
+
+    /** The words of the row (y, z), the voxel x is bit x % 64 of word x / 64.*/
+    const WordType *GetRow(unsigned int y, unsigned int z) const;
+    std::size_t GetNumberOfWordsPerRow() const { return m_WordsPerRow; }
+
+    ///@{
+    /** \brief Word-parallel boolean operations. Both masks must have the same size, else an mitk::Exception is thrown.
+     */
+    BitMask &operator&=(const BitMask &other);
+    BitMask &operator|=(const BitMask &other);
+    BitMask &operator^=(const BitMask &other);
+    /** Removes the foreground voxels of other (this AND NOT other).*/
+    BitMask &Subtract(const BitMask &other);
+    /** Inverts all voxels.*/
+    void Invert();
+    ///@}
+
+    bool operator==(const BitMask &other) const;
+    bool operator!=(const BitMask &other) const { return !(*this == other); }
+
+    ///@{
+    /** \brief Morphological operations with the given element and radius per axis.
+     *
+     * A radius of zero restricts the element to the plane of the voxel, e.g. (r, r, 0) is an axial element.
+     * The closing is calculated on a mask padded by the radius, like itk::BinaryMorphologicalClosingImageFilter
+     * with SafeBorder. Throws an mitk::Exception if the radius of a ball is too large, see IsSupportedBallRadius().
+     */
+    BitMask Dilate(const RadiusType &radius, StructuringElementType element) const;
+    BitMask Erode(const RadiusType &radius, StructuringElementType element) const;
+    BitMask Opening(const RadiusType &radius, StructuringElementType element) const;
+    BitMask Closing(const RadiusType &radius, StructuringElementType element) const;
+    ///@}
+
+    /** Indicates if the squared distances of a ball with this radius fit into 64 bit integers for this mask size.*/
+    bool IsSupportedBallRadius(const RadiusType &radius) const;
+
+  private:
+    WordType *GetRow(unsigned int y, unsigned int z);
+    void CheckSize(const BitMask &other) const;
+    /** Clears the bits of every row that exceed the image size.*/
+    void ClearPadding();
+
+    /** Dilates or erodes with a ball by thresholding the distance transform, which is calculated slice by slice.*/
+    void ApplyBall(const RadiusType &radius, bool erode, BitMask &result) const;
+    void DilateCross(const RadiusType &radius, BitMask &result) const;
+
+    SizeType m_Size;
+    std::size_t m_WordsPerRow;
+    std::vector<WordType> m_Words;
+  };
+}
+
+#endif
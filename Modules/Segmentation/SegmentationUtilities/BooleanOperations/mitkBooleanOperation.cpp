@@ -14,6 +14,7 @@ found in the LICENSE file.
 #include <itkAndImageFilter.h>
 #include <itkNotImageFilter.h>
 #include <itkOrImageFilter.h>
+#include <mitkBitMask.h>
 #include <mitkExceptionMacro.h>
 #include <mitkImageCast.h>
 #include <mitkImageTimeSelector.h>
@@ -41,6 +42,43 @@ static ImageType::Pointer CastTo3DItkImage(mitk::Image::Pointer segmentation, mi
   return result;
 }
 
+static mitk::Image::Pointer CombineBitMasks(mitk::BooleanOperation::Type type,
+                                            mitk::Image::Pointer segmentationA,
+                                            mitk::Image::Pointer segmentationB,
+                                            mitk::TimePointType time)
+{
+  // Segmentations that only contain the values 0 and 1 are combined word-parallel as bit masks
+  auto imageA = Get3DSegmentation(segmentationA, time);
+  bool isBinary = false;
+  auto maskA = mitk::BitMask::FromImage(imageA, &isBinary);
+  if (!isBinary)
+    return nullptr;
+
+  auto maskB = mitk::BitMask::FromImage(Get3DSegmentation(segmentationB, time), &isBinary);
+  if (!isBinary)
+    return nullptr;
+
+  switch (type)
+  {
+    case mitk::BooleanOperation::Difference:
+      maskA.Subtract(maskB);
+      break;
+
+    case mitk::BooleanOperation::Intersection:
+      maskA &= maskB;
+      break;
+
+    case mitk::BooleanOperation::Union:
+      maskA |= maskB;
+      break;
+
+    default:
+      mitkThrow() << "Unknown boolean operation type '" << type << "'!";
+  }
+
+  return maskA.ToImage(imageA, mitk::MakeScalarPixelType<mitk::Label::PixelType>());
+}
+
 mitk::BooleanOperation::BooleanOperation(Type type,
                                          mitk::Image::Pointer segmentationA,
                                          mitk::Image::Pointer segmentationB,
@@ -74,22 +112,27 @@ mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetResult() const
 
 mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetDifference() const
 {
-  auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
-  auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
+  auto tempResult = CombineBitMasks(Difference, m_SegmentationA, m_SegmentationB, m_TimePoint);
 
-  auto notFilter = itk::NotImageFilter<ImageType, ImageType>::New();
-  notFilter->SetInput(input2);
+  if (tempResult.IsNull())
+  {
+    auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
+    auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
+
+    auto notFilter = itk::NotImageFilter<ImageType, ImageType>::New();
+    notFilter->SetInput(input2);
 
-  auto andFilter = itk::AndImageFilter<ImageType, ImageType>::New();
-  andFilter->SetInput1(input1);
-  andFilter->SetInput2(notFilter->GetOutput());
+    auto andFilter = itk::AndImageFilter<ImageType, ImageType>::New();
+    andFilter->SetInput1(input1);
+    andFilter->SetInput2(notFilter->GetOutput());
 
-  andFilter->UpdateLargestPossibleRegion();
+    andFilter->UpdateLargestPossibleRegion();
 
-  auto tempResult = Image::New();
-  CastToMitkImage<ImageType>(andFilter->GetOutput(), tempResult);
+    tempResult = Image::New();
+    CastToMitkImage<ImageType>(andFilter->GetOutput(), tempResult);
 
-  tempResult->DisconnectPipeline();
+    tempResult->DisconnectPipeline();
+  }
 
   auto result = mitk::LabelSetImage::New();
   result->InitializeByLabeledImage(tempResult);
@@ -99,19 +142,24 @@ mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetDifference() const
 
 mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetIntersection() const
 {
-  auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
-  auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
+  auto tempResult = CombineBitMasks(Intersection, m_SegmentationA, m_SegmentationB, m_TimePoint);
 
-  auto andFilter = itk::AndImageFilter<ImageType, ImageType>::New();
-  andFilter->SetInput1(input1);
-  andFilter->SetInput2(input2);
+  if (tempResult.IsNull())
+  {
+    auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
+    auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
 
-  andFilter->UpdateLargestPossibleRegion();
+    auto andFilter = itk::AndImageFilter<ImageType, ImageType>::New();
+    andFilter->SetInput1(input1);
+    andFilter->SetInput2(input2);
 
-  auto tempResult = Image::New();
-  CastToMitkImage<ImageType>(andFilter->GetOutput(), tempResult);
+    andFilter->UpdateLargestPossibleRegion();
 
-  tempResult->DisconnectPipeline();
+    tempResult = Image::New();
+    CastToMitkImage<ImageType>(andFilter->GetOutput(), tempResult);
+
+    tempResult->DisconnectPipeline();
+  }
 
   auto result = mitk::LabelSetImage::New();
   result->InitializeByLabeledImage(tempResult);
@@ -121,19 +169,24 @@ mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetIntersection() const
 
 mitk::LabelSetImage::Pointer mitk::BooleanOperation::GetUnion() const
 {
-  auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
-  auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
+  auto tempResult = CombineBitMasks(Union, m_SegmentationA, m_SegmentationB, m_TimePoint);
+
+  if (tempResult.IsNull())
+  {
+    auto input1 = CastTo3DItkImage(m_SegmentationA, m_TimePoint);
+    auto input2 = CastTo3DItkImage(m_SegmentationB, m_TimePoint);
 
-  auto orFilter = itk::OrImageFilter<ImageType, ImageType>::New();
-  orFilter->SetInput1(input1);
-  orFilter->SetInput2(input2);
+    auto orFilter = itk::OrImageFilter<ImageType, ImageType>::New();
+    orFilter->SetInput1(input1);
+    orFilter->SetInput2(input2);
 
-  orFilter->UpdateLargestPossibleRegion();
+    orFilter->UpdateLargestPossibleRegion();
 
-  auto tempResult = Image::New();
-  CastToMitkImage<ImageType>(orFilter->GetOutput(), tempResult);
+    tempResult = Image::New();
+    CastToMitkImage<ImageType>(orFilter->GetOutput(), tempResult);
 
-  tempResult->DisconnectPipeline();
+    tempResult->DisconnectPipeline();
+  }
 
   auto result = mitk::LabelSetImage::New();
   result->InitializeByLabeledImage(tempResult);
@@ -18,11 +18,73 @@ found in the LICENSE file.
 #include <itkBinaryFillholeImageFilter.h>
 #include <itkBinaryMorphologicalClosingImageFilter.h>
 #include <itkBinaryMorphologicalOpeningImageFilter.h>
+#include <mitkBitMask.h>
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
 #include <mitkImageReadAccessor.h>
 #include <mitkImageTimeSelector.h>
 
+namespace
+{
+  typedef mitk::BitMask (mitk::BitMask::*BitMaskOperationType)(const mitk::BitMask::RadiusType &,
+                                                              mitk::BitMask::StructuringElementType) const;
+
+  /** Performs the operation on a bit-packed copy of a 2D or 3D image that only contains the values 0 and 1 (the
+   * usual case for segmentations). The result equals the ITK filter, but its cost does not grow with the radius.
+   * Returns false if the image has to be processed by the ITK filter.
+   */
+  bool ApplyToBitMask(mitk::Image::Pointer &image,
+                      int factor,
+                      mitk::MorphologicalOperations::StructuralElementType structuralElementFlags,
+                      BitMaskOperationType operation)
+  {
+    const auto dimension = image->GetDimension();
+    if (factor < 0 || dimension < 2 || dimension > 3)
+      return false;
+
+    bool isBinary = false;
+    auto mask = mitk::BitMask::FromImage(image, &isBinary);
+    if (!isBinary)
+      return false;
+
+    // Same element size as MorphologicalOperations::CreateStructuringElement()
+    const auto f = static_cast<unsigned int>(factor);
+    mitk::BitMask::RadiusType radius = { { 0, 0, 0 } };
+    switch (structuralElementFlags)
+    {
+      case mitk::MorphologicalOperations::Ball_Axial:
+      case mitk::MorphologicalOperations::Cross_Axial:
+        radius = { { f, f, 0 } };
+        break;
+      case mitk::MorphologicalOperations::Ball_Coronal:
+      case mitk::MorphologicalOperations::Cross_Coronal:
+        radius = { { f, 0, f } };
+        break;
+      case mitk::MorphologicalOperations::Ball_Sagittal:
+      case mitk::MorphologicalOperations::Cross_Sagittal:
+        radius = { { 0, f, f } };
+        break;
+      case mitk::MorphologicalOperations::Ball:
+      case mitk::MorphologicalOperations::Cross:
+        radius = { { f, f, f } };
+        break;
+    }
+    if (dimension == 2)
+      radius[2] = 0;
+
+    const auto element = (structuralElementFlags & (mitk::MorphologicalOperations::Ball_Axial |
+                                                    mitk::MorphologicalOperations::Ball_Coronal |
+                                                    mitk::MorphologicalOperations::Ball_Sagittal))
+                           ? mitk::BitMask::Ball
+                           : mitk::BitMask::Cross;
+    if (element == mitk::BitMask::Ball && !mask.IsSupportedBallRadius(radius))
+      return false;
+
+    image = (mask.*operation)(radius, element).ToImage(image);
+    return true;
+  }
+}
+
 void mitk::MorphologicalOperations::Closing(mitk::Image::Pointer &image,
                                             int factor,
                                             mitk::MorphologicalOperations::StructuralElementType structuralElement)
@@ -46,7 +108,8 @@ void mitk::MorphologicalOperations::Closing(mitk::Image::Pointer &image,
       mitk::Image::Pointer img3D = timeSelector->GetOutput();
       img3D->DisconnectPipeline();
 
-      AccessByItk_3(img3D, itkClosing, img3D, factor, structuralElement);
+      if (!ApplyToBitMask(img3D, factor, structuralElement, &mitk::BitMask::Closing))
+        AccessByItk_3(img3D, itkClosing, img3D, factor, structuralElement);
 
       mitk::ImageReadAccessor accessor(img3D);
       image->SetVolume(accessor.GetData(), t);
@@ -54,7 +117,8 @@ void mitk::MorphologicalOperations::Closing(mitk::Image::Pointer &image,
   }
   else
   {
-    AccessByItk_3(image, itkClosing, image, factor, structuralElement);
+    if (!ApplyToBitMask(image, factor, structuralElement, &mitk::BitMask::Closing))
+      AccessByItk_3(image, itkClosing, image, factor, structuralElement);
   }
 
   MITK_INFO << "Finished Closing";
@@ -83,7 +147,8 @@ void mitk::MorphologicalOperations::Erode(mitk::Image::Pointer &image,
       mitk::Image::Pointer img3D = timeSelector->GetOutput();
       img3D->DisconnectPipeline();
 
-      AccessByItk_3(img3D, itkErode, img3D, factor, structuralElement);
+      if (!ApplyToBitMask(img3D, factor, structuralElement, &mitk::BitMask::Erode))
+        AccessByItk_3(img3D, itkErode, img3D, factor, structuralElement);
 
       mitk::ImageReadAccessor accessor(img3D);
       image->SetVolume(accessor.GetData(), t);
@@ -91,7 +156,8 @@ void mitk::MorphologicalOperations::Erode(mitk::Image::Pointer &image,
   }
   else
   {
-    AccessByItk_3(image, itkErode, image, factor, structuralElement);
+    if (!ApplyToBitMask(image, factor, structuralElement, &mitk::BitMask::Erode))
+      AccessByItk_3(image, itkErode, image, factor, structuralElement);
   }
 
   MITK_INFO << "Finished Erode";
@@ -120,7 +186,8 @@ void mitk::MorphologicalOperations::Dilate(mitk::Image::Pointer &image,
       mitk::Image::Pointer img3D = timeSelector->GetOutput();
       img3D->DisconnectPipeline();
 
-      AccessByItk_3(img3D, itkDilate, img3D, factor, structuralElement);
+      if (!ApplyToBitMask(img3D, factor, structuralElement, &mitk::BitMask::Dilate))
+        AccessByItk_3(img3D, itkDilate, img3D, factor, structuralElement);
 
       mitk::ImageReadAccessor accessor(img3D);
       image->SetVolume(accessor.GetData(), t);
@@ -128,7 +195,8 @@ void mitk::MorphologicalOperations::Dilate(mitk::Image::Pointer &image,
   }
   else
   {
-    AccessByItk_3(image, itkDilate, image, factor, structuralElement);
+    if (!ApplyToBitMask(image, factor, structuralElement, &mitk::BitMask::Dilate))
+      AccessByItk_3(image, itkDilate, image, factor, structuralElement);
   }
 
   MITK_INFO << "Finished Dilate";
@@ -157,7 +225,8 @@ void mitk::MorphologicalOperations::Opening(mitk::Image::Pointer &image,
       mitk::Image::Pointer img3D = timeSelector->GetOutput();
       img3D->DisconnectPipeline();
 
-      AccessByItk_3(img3D, itkOpening, img3D, factor, structuralElement);
+      if (!ApplyToBitMask(img3D, factor, structuralElement, &mitk::BitMask::Opening))
+        AccessByItk_3(img3D, itkOpening, img3D, factor, structuralElement);
 
       mitk::ImageReadAccessor accessor(img3D);
       image->SetVolume(accessor.GetData(), t);
@@ -165,7 +234,8 @@ void mitk::MorphologicalOperations::Opening(mitk::Image::Pointer &image,
   }
   else
   {
-    AccessByItk_3(image, itkOpening, image, factor, structuralElement);
+    if (!ApplyToBitMask(image, factor, structuralElement, &mitk::BitMask::Opening))
+      AccessByItk_3(image, itkOpening, image, factor, structuralElement);
   }
 
   MITK_INFO << "Finished Opening";
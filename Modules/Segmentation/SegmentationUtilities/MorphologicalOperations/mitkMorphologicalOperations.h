@@ -19,6 +19,9 @@ found in the LICENSE file.
 namespace mitk
 {
   /** \brief Encapsulates several morphological operations that can be performed on segmentations.
+    *
+    * Images that only contain the values 0 and 1 are processed as mitk::BitMask, all other images by the ITK
+    * binary morphology filters (foreground value 1). Both give the same result.
     */
   class MITKSEGMENTATION_EXPORT MorphologicalOperations
   {
@@ -12,9 +12,16 @@ set(MODULE_TESTS
   mitkToolManagerProviderTest.cpp
   mitkManualSegmentationToSurfaceFilterTest.cpp #new cpp unit style
   mitkToolInteractionTest.cpp
+  mitkSegWithPreviewToolTest.cpp
+  mitkImageLiveWireContourModelFilterTest.cpp
+  mitknnUNetInferenceWorkerTest.cpp
+  mitkBitMaskTest.cpp
 )
 
+# Benchmarks are built into the test driver, but not registered with ctest.
+# Run them explicitly, e.g. MitkSegmentationTestDriver mitkImageLiveWireContourModelFilterBenchmarkTest
 set(MODULE_CUSTOM_TESTS
+  mitkImageLiveWireContourModelFilterBenchmarkTest.cpp
 )
 
 set(MODULE_TESTIMAGE
@@ -0,0 +1,566 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkBitMask.h>
+#include <mitkBooleanOperation.h>
+#include <mitkImageCast.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkMorphologicalOperations.h>
+
+#include <itkAndImageFilter.h>
+#include <itkBinaryBallStructuringElement.h>
+#include <itkBinaryCrossStructuringElement.h>
+#include <itkBinaryDilateImageFilter.h>
+#include <itkBinaryErodeImageFilter.h>
+#include <itkBinaryFillholeImageFilter.h>
+#include <itkBinaryMorphologicalClosingImageFilter.h>
+#include <itkBinaryMorphologicalOpeningImageFilter.h>
+#include <itkNotImageFilter.h>
+#include <itkOrImageFilter.h>
+#include <itkXorImageFilter.h>
+
+#include <random>
+
+class mitkBitMaskTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkBitMaskTestSuite);
+
+  MITK_TEST(BooleanOperations);
+  MITK_TEST(Invert_KeepsPadding);
+  MITK_TEST(Morphology_Ball);
+  MITK_TEST(Morphology_Cross);
+  MITK_TEST(ImageRoundTrip);
+  MITK_TEST(MorphologicalOperations_MatchItkFilters);
+  MITK_TEST(FillHoles_MatchesItkFilter);
+  MITK_TEST(BooleanOperations_MatchItkFilters);
+  MITK_TEST(Closing_LargeRadii_IsExtensive);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef std::array<int, 3> OffsetType;
+  typedef itk::Image<unsigned char, 3> ItkImageType;
+
+  enum OperationType
+  {
+    Erode,
+    Dilate,
+    Opening,
+    Closing
+  };
+
+  std::mt19937 m_Generator;
+
+  mitk::BitMask CreateRandomMask(const mitk::BitMask::SizeType &size, double probability)
+  {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    mitk::BitMask mask(size);
+    for (unsigned int z = 0; z < size[2]; ++z)
+      for (unsigned int y = 0; y < size[1]; ++y)
+        for (unsigned int x = 0; x < size[0]; ++x)
+          mask.SetVoxel(x, y, z, uniform(m_Generator) < probability);
+    return mask;
+  }
+
+  /** Offsets of the element, defined like itk::BinaryBallStructuringElement and itk::BinaryCrossStructuringElement.*/
+  static std::vector<OffsetType> GetElementOffsets(const mitk::BitMask::RadiusType &radius, mitk::BitMask::StructuringElementType element)
+  {
+    std::vector<OffsetType> offsets;
+    const int rx = radius[0], ry = radius[1], rz = radius[2];
+    for (int z = -rz; z <= rz; ++z)
+    {
+      for (int y = -ry; y <= ry; ++y)
+      {
+        for (int x = -rx; x <= rx; ++x)
+        {
+          bool inside = false;
+          if (element == mitk::BitMask::Ball)
+          {
+            const double dx = x / (rx + 0.5), dy = y / (ry + 0.5), dz = z / (rz + 0.5);
+            inside = dx * dx + dy * dy + dz * dz <= 1;
+          }
+          else
+          {
+            inside = (y == 0 && z == 0) || (x == 0 && z == 0) || (x == 0 && y == 0);
+          }
+          if (inside)
+            offsets.push_back({ { x, y, z } });
+        }
+      }
+    }
+    return offsets;
+  }
+
+  static bool GetVoxel(const mitk::BitMask &mask, int x, int y, int z, bool outside)
+  {
+    const auto &size = mask.GetSize();
+    if (x < 0 || y < 0 || z < 0 || x >= int(size[0]) || y >= int(size[1]) || z >= int(size[2]))
+      return outside;
+    return mask.GetVoxel(x, y, z);
+  }
+
+  static bool IsDilated(const mitk::BitMask &mask, const std::vector<OffsetType> &offsets, int x, int y, int z)
+  {
+    for (const auto &offset : offsets)
+      if (GetVoxel(mask, x + offset[0], y + offset[1], z + offset[2], false))
+        return true;
+    return false;
+  }
+
+  static bool IsEroded(const mitk::BitMask &mask, const std::vector<OffsetType> &offsets, int x, int y, int z)
+  {
+    for (const auto &offset : offsets)
+      if (!GetVoxel(mask, x + offset[0], y + offset[1], z + offset[2], true))
+        return false;
+    return true;
+  }
+
+  /** Compares all operations with the voxel-wise definitions for random masks and radii.*/
+  void CheckMorphology(mitk::BitMask::StructuringElementType element)
+  {
+    for (int run = 0; run < 40; ++run)
+    {
+      const mitk::BitMask::SizeType size = { { 1u + unsigned(m_Generator() % 100), 1u + unsigned(m_Generator() % 12), 1u + unsigned(m_Generator() % 8) } };
+      const auto mask = this->CreateRandomMask(size, 0.05 + (run % 4) * 0.15);
+      const mitk::BitMask::RadiusType radius = { { unsigned(m_Generator() % 4), unsigned(m_Generator() % 3), unsigned(m_Generator() % 3) } };
+      const auto offsets = GetElementOffsets(radius, element);
+
+      const auto dilated = mask.Dilate(radius, element);
+      const auto eroded = mask.Erode(radius, element);
+      const auto opened = mask.Opening(radius, element);
+      const auto closed = mask.Closing(radius, element);
+
+      for (int z = 0; z < int(size[2]); ++z)
+      {
+        for (int y = 0; y < int(size[1]); ++y)
+        {
+          for (int x = 0; x < int(size[0]); ++x)
+          {
+            bool expectedOpened = false;
+            bool expectedClosed = true;
+            for (const auto &offset : offsets)
+            {
+              const int ox = x - offset[0], oy = y - offset[1], oz = z - offset[2];
+              const bool isInside = ox >= 0 && oy >= 0 && oz >= 0 && ox < int(size[0]) && oy < int(size[1]) && oz < int(size[2]);
+              if (isInside && IsEroded(mask, offsets, ox, oy, oz))
+                expectedOpened = true;
+              if (!IsDilated(mask, offsets, x + offset[0], y + offset[1], z + offset[2]))
+                expectedClosed = false;
+            }
+
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Dilation should match the definition.", IsDilated(mask, offsets, x, y, z), dilated.GetVoxel(x, y, z));
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Erosion should match the definition.", IsEroded(mask, offsets, x, y, z), eroded.GetVoxel(x, y, z));
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Opening should match the definition.", expectedOpened, opened.GetVoxel(x, y, z));
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Closing should match the definition.", expectedClosed, closed.GetVoxel(x, y, z));
+          }
+        }
+      }
+    }
+  }
+
+  static mitk::Image::Pointer CreateImage(const mitk::BitMask &mask, unsigned char foregroundValue)
+  {
+    const auto &size = mask.GetSize();
+    unsigned int dimensions[3] = { size[0], size[1], size[2] };
+    auto image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, dimensions);
+
+    mitk::ImagePixelWriteAccessor<unsigned char, 3> accessor(image);
+    for (unsigned int z = 0; z < size[2]; ++z)
+      for (unsigned int y = 0; y < size[1]; ++y)
+        for (unsigned int x = 0; x < size[0]; ++x)
+          accessor.SetPixelByIndex({ { x, y, z } }, mask.GetVoxel(x, y, z) ? foregroundValue : 0);
+    return image;
+  }
+
+  /** Random mask with a block that touches the faces x = 0, y = 0, z = 0 and the last slice.*/
+  mitk::BitMask CreateBorderMask(const mitk::BitMask::SizeType &size, double probability)
+  {
+    auto mask = this->CreateRandomMask(size, probability);
+    for (unsigned int z = 0; z < size[2]; ++z)
+      for (unsigned int y = 0; y < size[1] / 2; ++y)
+        for (unsigned int x = 0; x < 8; ++x)
+          mask.SetVoxel(x, y, z, true);
+    return mask;
+  }
+
+  static ItkImageType::Pointer CreateItkImage(const mitk::BitMask &mask)
+  {
+    ItkImageType::Pointer itkImage;
+    mitk::CastToItkImage(CreateImage(mask, 1), itkImage);
+    return itkImage;
+  }
+
+  static mitk::BitMask ToBitMask(const ItkImageType *itkImage)
+  {
+    mitk::Image::Pointer image;
+    mitk::CastToMitkImage(itkImage, image);
+    return mitk::BitMask::FromImage(image);
+  }
+
+  static void CheckVoxels(const std::string &message, const mitk::BitMask &expected, const mitk::BitMask &actual)
+  {
+    CPPUNIT_ASSERT_MESSAGE(message + ": sizes should match.", expected.GetSize() == actual.GetSize());
+    const auto &size = expected.GetSize();
+    for (unsigned int z = 0; z < size[2]; ++z)
+      for (unsigned int y = 0; y < size[1]; ++y)
+        for (unsigned int x = 0; x < size[0]; ++x)
+          CPPUNIT_ASSERT_EQUAL_MESSAGE(message + " at (" + std::to_string(x) + ", " + std::to_string(y) + ", " +
+                                         std::to_string(z) + ")",
+                                       expected.GetVoxel(x, y, z), actual.GetVoxel(x, y, z));
+  }
+
+  /** Radius of the ITK element, like MorphologicalOperations::CreateStructuringElement().*/
+  static ItkImageType::SizeType GetItkRadius(mitk::MorphologicalOperations::StructuralElementType element, unsigned int factor)
+  {
+    ItkImageType::SizeType radius;
+    radius.Fill(0);
+    switch (element)
+    {
+      case mitk::MorphologicalOperations::Ball_Axial:
+      case mitk::MorphologicalOperations::Cross_Axial:
+        radius[0] = factor;
+        radius[1] = factor;
+        break;
+      case mitk::MorphologicalOperations::Ball_Coronal:
+      case mitk::MorphologicalOperations::Cross_Coronal:
+        radius[0] = factor;
+        radius[2] = factor;
+        break;
+      case mitk::MorphologicalOperations::Ball_Sagittal:
+      case mitk::MorphologicalOperations::Cross_Sagittal:
+        radius[1] = factor;
+        radius[2] = factor;
+        break;
+      case mitk::MorphologicalOperations::Ball:
+      case mitk::MorphologicalOperations::Cross:
+        radius.Fill(factor);
+        break;
+    }
+    return radius;
+  }
+
+  /** The ITK filter MorphologicalOperations used for all images before the bit mask path was added.*/
+  template <class TKernel>
+  static mitk::BitMask ApplyItkMorphology(const mitk::BitMask &mask, OperationType operation, const ItkImageType::SizeType &radius)
+  {
+    TKernel kernel;
+    kernel.SetRadius(radius);
+    kernel.CreateStructuringElement();
+
+    auto input = CreateItkImage(mask);
+    switch (operation)
+    {
+      case Erode:
+      {
+        auto filter = itk::BinaryErodeImageFilter<ItkImageType, ItkImageType, TKernel>::New();
+        filter->SetKernel(kernel);
+        filter->SetInput(input);
+        filter->SetErodeValue(1);
+        filter->UpdateLargestPossibleRegion();
+        return ToBitMask(filter->GetOutput());
+      }
+      case Dilate:
+      {
+        auto filter = itk::BinaryDilateImageFilter<ItkImageType, ItkImageType, TKernel>::New();
+        filter->SetKernel(kernel);
+        filter->SetInput(input);
+        filter->SetDilateValue(1);
+        filter->UpdateLargestPossibleRegion();
+        return ToBitMask(filter->GetOutput());
+      }
+      case Opening:
+      {
+        auto filter = itk::BinaryMorphologicalOpeningImageFilter<ItkImageType, ItkImageType, TKernel>::New();
+        filter->SetKernel(kernel);
+        filter->SetInput(input);
+        filter->SetForegroundValue(1);
+        filter->SetBackgroundValue(0);
+        filter->UpdateLargestPossibleRegion();
+        return ToBitMask(filter->GetOutput());
+      }
+      default:
+      {
+        auto filter = itk::BinaryMorphologicalClosingImageFilter<ItkImageType, ItkImageType, TKernel>::New();
+        filter->SetKernel(kernel);
+        filter->SetInput(input);
+        filter->SetForegroundValue(1);
+        filter->UpdateLargestPossibleRegion();
+        return ToBitMask(filter->GetOutput());
+      }
+    }
+  }
+
+  static mitk::BitMask ApplyMorphologicalOperation(const mitk::BitMask &mask,
+                                                   OperationType operation,
+                                                   int factor,
+                                                   mitk::MorphologicalOperations::StructuralElementType element)
+  {
+    auto image = CreateImage(mask, 1);
+    switch (operation)
+    {
+      case Erode:
+        mitk::MorphologicalOperations::Erode(image, factor, element);
+        break;
+      case Dilate:
+        mitk::MorphologicalOperations::Dilate(image, factor, element);
+        break;
+      case Opening:
+        mitk::MorphologicalOperations::Opening(image, factor, element);
+        break;
+      case Closing:
+        mitk::MorphologicalOperations::Closing(image, factor, element);
+        break;
+    }
+    return mitk::BitMask::FromImage(image);
+  }
+
+  static mitk::BitMask ApplyBooleanOperation(mitk::BooleanOperation::Type type, const mitk::BitMask &a, const mitk::BitMask &b)
+  {
+    mitk::BooleanOperation operation(type, CreateImage(a, 1), CreateImage(b, 1));
+    return mitk::BitMask::FromImage(operation.GetResult());
+  }
+
+public:
+  void setUp() override
+  {
+    m_Generator.seed(42);
+  }
+
+  void BooleanOperations()
+  {
+    const mitk::BitMask::SizeType size = { { 131, 7, 5 } };
+    const auto a = this->CreateRandomMask(size, 0.5);
+    const auto b = this->CreateRandomMask(size, 0.5);
+
+    auto intersection = a;
+    intersection &= b;
+    auto combined = a;
+    combined |= b;
+    auto exclusive = a;
+    exclusive ^= b;
+    auto difference = a;
+    difference.Subtract(b);
+
+    std::size_t count = 0;
+    for (unsigned int z = 0; z < size[2]; ++z)
+    {
+      for (unsigned int y = 0; y < size[1]; ++y)
+      {
+        for (unsigned int x = 0; x < size[0]; ++x)
+        {
+          const bool va = a.GetVoxel(x, y, z), vb = b.GetVoxel(x, y, z);
+          count += va ? 1 : 0;
+          CPPUNIT_ASSERT_EQUAL_MESSAGE("AND should match the voxels.", va && vb, intersection.GetVoxel(x, y, z));
+          CPPUNIT_ASSERT_EQUAL_MESSAGE("OR should match the voxels.", va || vb, combined.GetVoxel(x, y, z));
+          CPPUNIT_ASSERT_EQUAL_MESSAGE("XOR should match the voxels.", va != vb, exclusive.GetVoxel(x, y, z));
+          CPPUNIT_ASSERT_EQUAL_MESSAGE("AND NOT should match the voxels.", va && !vb, difference.GetVoxel(x, y, z));
+        }
+      }
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Foreground count should match the voxels.", count, a.GetNumberOfForegroundVoxels());
+
+    mitk::BitMask other(mitk::BitMask::SizeType({ { 131, 7, 4 } }));
+    CPPUNIT_ASSERT_THROW_MESSAGE("Masks of different size should not be combined.", intersection &= other, mitk::Exception);
+  }
+
+  void Invert_KeepsPadding()
+  {
+    auto mask = this->CreateRandomMask({ { 70, 3, 2 } }, 0.3);
+    const auto original = mask;
+    mask.Invert();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Inverted mask should contain all other voxels.", original.GetNumberOfVoxels() - original.GetNumberOfForegroundVoxels(), mask.GetNumberOfForegroundVoxels());
+    mask.Invert();
+    CPPUNIT_ASSERT_MESSAGE("Inverting twice should restore the mask.", original == mask);
+  }
+
+  void Morphology_Ball()
+  {
+    this->CheckMorphology(mitk::BitMask::Ball);
+  }
+
+  void Morphology_Cross()
+  {
+    this->CheckMorphology(mitk::BitMask::Cross);
+  }
+
+  void ImageRoundTrip()
+  {
+    const auto mask = this->CreateRandomMask({ { 65, 9, 4 } }, 0.4);
+    auto image = CreateImage(mask, 1);
+
+    bool isBinary = false;
+    CPPUNIT_ASSERT_MESSAGE("Mask of the image should equal the original mask.", mask == mitk::BitMask::FromImage(image, &isBinary));
+    CPPUNIT_ASSERT_MESSAGE("Image with the values 0 and 1 should be binary.", isBinary);
+
+    auto restored = mask.ToImage(image);
+    mitk::ImagePixelReadAccessor<unsigned char, 3> accessor(restored);
+    for (unsigned int z = 0; z < 4; ++z)
+      for (unsigned int y = 0; y < 9; ++y)
+        for (unsigned int x = 0; x < 65; ++x)
+          CPPUNIT_ASSERT_EQUAL_MESSAGE("Restored image should contain the mask.", mask.GetVoxel(x, y, z) ? 1 : 0, int(accessor.GetPixelByIndex({ { x, y, z } })));
+
+    mitk::BitMask::FromImage(CreateImage(mask, 2), &isBinary);
+    CPPUNIT_ASSERT_MESSAGE("Image with other values should not be binary.", !isBinary);
+  }
+
+  /** Compares the bit mask path of MorphologicalOperations with the ITK filters on the same 0/1 image, for sparse
+   * and dense masks whose foreground touches the image border.*/
+  void MorphologicalOperations_MatchItkFilters()
+  {
+    const std::vector<mitk::MorphologicalOperations::StructuralElementType> elements = {
+      mitk::MorphologicalOperations::Ball,         mitk::MorphologicalOperations::Ball_Axial,
+      mitk::MorphologicalOperations::Ball_Coronal, mitk::MorphologicalOperations::Ball_Sagittal,
+      mitk::MorphologicalOperations::Cross,        mitk::MorphologicalOperations::Cross_Axial,
+      mitk::MorphologicalOperations::Cross_Coronal, mitk::MorphologicalOperations::Cross_Sagittal };
+    const char *operationNames[] = { "Erode", "Dilate", "Opening", "Closing" };
+
+    for (double probability : { 0.1, 0.7 })
+    {
+      const auto mask = this->CreateBorderMask({ { 70, 23, 9 } }, probability);
+
+      for (auto element : elements)
+      {
+        const bool isBall = 0 != (element & mitk::MorphologicalOperations::Ball);
+        for (int factor = 1; factor <= 3; ++factor)
+        {
+          const auto radius = GetItkRadius(element, factor);
+          for (auto operation : { Erode, Dilate, Opening, Closing })
+          {
+            const auto expected = isBall
+              ? ApplyItkMorphology<itk::BinaryBallStructuringElement<unsigned char, 3>>(mask, operation, radius)
+              : ApplyItkMorphology<itk::BinaryCrossStructuringElement<unsigned char, 3>>(mask, operation, radius);
+
+            CheckVoxels(std::string(operationNames[operation]) + " with element " + std::to_string(element) +
+                          " and factor " + std::to_string(factor) + " should match the ITK filter",
+                        expected,
+                        ApplyMorphologicalOperation(mask, operation, factor, element));
+          }
+        }
+      }
+    }
+  }
+
+  void FillHoles_MatchesItkFilter()
+  {
+    // Hollow boxes: one enclosed by the mask, one open to the image border
+    auto mask = this->CreateRandomMask({ { 70, 23, 9 } }, 0.05);
+    for (unsigned int z = 1; z < 8; ++z)
+    {
+      for (unsigned int y = 2; y < 20; ++y)
+      {
+        for (unsigned int x = 2; x < 30; ++x)
+          mask.SetVoxel(x, y, z, z == 1 || z == 7 || y == 2 || y == 19 || x == 2 || x == 29);
+        for (unsigned int x = 40; x < 70; ++x)
+          mask.SetVoxel(x, y, z, z == 1 || z == 7 || y == 2 || y == 19 || x == 40);
+      }
+    }
+
+    auto filter = itk::BinaryFillholeImageFilter<ItkImageType>::New();
+    filter->SetInput(CreateItkImage(mask));
+    filter->SetForegroundValue(1);
+    filter->UpdateLargestPossibleRegion();
+    const auto expected = ToBitMask(filter->GetOutput());
+
+    auto image = CreateImage(mask, 1);
+    mitk::MorphologicalOperations::FillHoles(image);
+
+    CheckVoxels("Fill holes should match the ITK filter", expected, mitk::BitMask::FromImage(image));
+    CPPUNIT_ASSERT_MESSAGE("Enclosed hole should be filled.", expected.GetVoxel(10, 10, 4));
+    CPPUNIT_ASSERT_MESSAGE("Box open to the border should not be filled.", !expected.GetVoxel(50, 10, 4));
+  }
+
+  /** Compares the word-parallel operations (directly and by BooleanOperation) with the ITK filters.*/
+  void BooleanOperations_MatchItkFilters()
+  {
+    const mitk::BitMask::SizeType size = { { 131, 7, 5 } };
+    const auto a = this->CreateBorderMask(size, 0.5);
+    const auto b = this->CreateRandomMask(size, 0.5);
+    const auto itkA = CreateItkImage(a);
+    const auto itkB = CreateItkImage(b);
+
+    auto andFilter = itk::AndImageFilter<ItkImageType, ItkImageType>::New();
+    andFilter->SetInput1(itkA);
+    andFilter->SetInput2(itkB);
+    andFilter->UpdateLargestPossibleRegion();
+
+    auto orFilter = itk::OrImageFilter<ItkImageType, ItkImageType>::New();
+    orFilter->SetInput1(itkA);
+    orFilter->SetInput2(itkB);
+    orFilter->UpdateLargestPossibleRegion();
+
+    auto xorFilter = itk::XorImageFilter<ItkImageType, ItkImageType>::New();
+    xorFilter->SetInput1(itkA);
+    xorFilter->SetInput2(itkB);
+    xorFilter->UpdateLargestPossibleRegion();
+
+    auto notFilter = itk::NotImageFilter<ItkImageType, ItkImageType>::New();
+    notFilter->SetInput(itkB);
+
+    auto andNotFilter = itk::AndImageFilter<ItkImageType, ItkImageType>::New();
+    andNotFilter->SetInput1(itkA);
+    andNotFilter->SetInput2(notFilter->GetOutput());
+    andNotFilter->UpdateLargestPossibleRegion();
+
+    auto intersection = a;
+    intersection &= b;
+    auto combined = a;
+    combined |= b;
+    auto exclusive = a;
+    exclusive ^= b;
+    auto difference = a;
+    difference.Subtract(b);
+    auto inverted = b;
+    inverted.Invert();
+
+    CheckVoxels("AND should match the ITK filter", ToBitMask(andFilter->GetOutput()), intersection);
+    CheckVoxels("OR should match the ITK filter", ToBitMask(orFilter->GetOutput()), combined);
+    CheckVoxels("XOR should match the ITK filter", ToBitMask(xorFilter->GetOutput()), exclusive);
+    CheckVoxels("NOT should match the ITK filter", ToBitMask(notFilter->GetOutput()), inverted);
+    CheckVoxels("AND NOT should match the ITK filters", ToBitMask(andNotFilter->GetOutput()), difference);
+
+    CheckVoxels("Intersection should match the ITK filter",
+                ToBitMask(andFilter->GetOutput()),
+                ApplyBooleanOperation(mitk::BooleanOperation::Intersection, a, b));
+    CheckVoxels("Union should match the ITK filter",
+                ToBitMask(orFilter->GetOutput()),
+                ApplyBooleanOperation(mitk::BooleanOperation::Union, a, b));
+    CheckVoxels("Difference should match the ITK filters",
+                ToBitMask(andNotFilter->GetOutput()),
+                ApplyBooleanOperation(mitk::BooleanOperation::Difference, a, b));
+  }
+
+  void Closing_LargeRadii_IsExtensive()
+  {
+    mitk::BitMask mask(mitk::BitMask::SizeType({ { 256, 256, 128 } }));
+    for (int z = 40; z < 90; ++z)
+      for (int y = 60; y < 200; ++y)
+        for (int x = 50; x < 210; ++x)
+          mask.SetVoxel(x, y, z, (x - 50) * (x - 210) + (y - 60) * (y - 200) + 3 * (z - 40) * (z - 90) < 0);
+
+    for (unsigned int radius : { 1u, 4u, 8u, 16u })
+    {
+      for (auto element : { mitk::BitMask::Ball, mitk::BitMask::Cross })
+      {
+        auto removed = mask;
+        removed.Subtract(mask.Closing({ { radius, radius, radius } }, element));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Closing should not remove foreground voxels.", std::size_t(0), removed.GetNumberOfForegroundVoxels());
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkBitMask)
@@ -0,0 +1,123 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Benchmark, not part of the ctest set. Run it explicitly:
+//   MitkSegmentationTestDriver mitkImageLiveWireContourModelFilterBenchmarkTest
+
+#include <mitkImageLiveWireContourModelFilter.h>
+
+#include <mitkITKImageImport.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+class mitkImageLiveWireContourModelFilterBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageLiveWireContourModelFilterBenchmarkTestSuite);
+  MITK_TEST(HoverLatencyOn1024Slice);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::ImageLiveWireContourModelFilter::InternalImageType InternalImageType;
+
+  /** The noisy slice with a bright disk and a dark bar of mitkImageLiveWireContourModelFilterTest.*/
+  static InternalImageType::Pointer CreateSlice(unsigned int size)
+  {
+    InternalImageType::SizeType imageSize;
+    imageSize.Fill(size);
+
+    auto image = InternalImageType::New();
+    image->SetRegions(imageSize);
+    image->Allocate();
+
+    std::mt19937 generator(42);
+    std::normal_distribution<float> noise(0.0f, 5.0f);
+
+    const double center = size / 2.0;
+    const double radius = size / 3.0;
+
+    for (unsigned int y = 0; y < size; ++y)
+    {
+      for (unsigned int x = 0; x < size; ++x)
+      {
+        float value = 100.0f;
+        if ((x - center) * (x - center) + (y - center) * (y - center) < radius * radius)
+          value = 200.0f;
+        if (x > size / 5 && x < size / 4)
+          value = 20.0f;
+
+        InternalImageType::IndexType index;
+        index[0] = x;
+        index[1] = y;
+        image->SetPixel(index, value + noise(generator));
+      }
+    }
+
+    return image;
+  }
+
+  static mitk::Point3D IndexToWorld(const mitk::Image *image, double x, double y)
+  {
+    mitk::Point3D index;
+    index[0] = x;
+    index[1] = y;
+    index[2] = 0.0;
+
+    mitk::Point3D world;
+    image->GetGeometry()->IndexToWorld(index, world);
+    return world;
+  }
+
+public:
+  void HoverLatencyOn1024Slice()
+  {
+    auto image = mitk::GrabItkImageMemory(CreateSlice(1024).GetPointer());
+
+    auto filter = mitk::ImageLiveWireContourModelFilter::New();
+    filter->SetInput(image);
+    filter->SetStartPoint(IndexToWorld(image, 512, 170));
+
+    // the mouse circles around the disk, starting at the anchor
+    const unsigned int numberOfMoves = 200;
+    std::vector<double> durations;
+
+    for (unsigned int i = 0; i <= numberOfMoves; ++i)
+    {
+      const double angle = 2.0 * 3.14159265358979 * i / numberOfMoves;
+      filter->SetEndPoint(IndexToWorld(image, 512 + 342 * std::sin(angle), 512 - 342 * std::cos(angle)));
+
+      const auto start = std::chrono::steady_clock::now();
+      filter->Update();
+      durations.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+      CPPUNIT_ASSERT(filter->GetOutput()->GetNumberOfVertices() > 0);
+    }
+
+    const double firstUpdate = durations.front();
+    durations.erase(durations.begin());
+    std::sort(durations.begin(), durations.end());
+
+    double mean = 0.0;
+    for (auto duration : durations)
+      mean += duration / durations.size();
+
+    MITK_INFO << "LiveWire on 1024x1024 slice: first update (costs and search) " << firstUpdate << " ms, hover mean "
+              << mean << " ms, median " << durations[durations.size() / 2] << " ms, max " << durations.back()
+              << " ms";
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageLiveWireContourModelFilterBenchmark)
@@ -0,0 +1,243 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkImageLiveWireContourModelFilter.h>
+
+#include <mitkITKImageImport.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkShortestPathImageFilter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+class mitkImageLiveWireContourModelFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageLiveWireContourModelFilterTestSuite);
+
+  MITK_TEST(Engine_FindsPathsAsShortAsShortestPathImageFilter);
+  MITK_TEST(Engine_ReusesSearchTreeOfAnchor);
+  MITK_TEST(Filter_AvoidsRepulsivePoints);
+  MITK_TEST(Filter_FollowsMovingEndPointOn1024Slice);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::ImageLiveWireContourModelFilter::InternalImageType InternalImageType;
+  typedef mitk::ImageLiveWireContourModelFilter::CostFunctionType CostFunctionType;
+  typedef mitk::ImageLiveWireContourModelFilter::ShortestPathEngineType EngineType;
+  typedef mitk::ImageLiveWireContourModelFilter::ShortestPathType PathType;
+
+  /** A noisy slice showing a bright disk and a dark bar, i.e. with edges a live wire should snap to.*/
+  static InternalImageType::Pointer CreateSlice(unsigned int size)
+  {
+    InternalImageType::SizeType imageSize;
+    imageSize.Fill(size);
+
+    auto image = InternalImageType::New();
+    image->SetRegions(imageSize);
+    image->Allocate();
+
+    std::mt19937 generator(42);
+    std::normal_distribution<float> noise(0.0f, 5.0f);
+
+    const double center = size / 2.0;
+    const double radius = size / 3.0;
+
+    for (unsigned int y = 0; y < size; ++y)
+    {
+      for (unsigned int x = 0; x < size; ++x)
+      {
+        float value = 100.0f;
+        if ((x - center) * (x - center) + (y - center) * (y - center) < radius * radius)
+          value = 200.0f;
+        if (x > size / 5 && x < size / 4)
+          value = 20.0f;
+
+        InternalImageType::IndexType index;
+        index[0] = x;
+        index[1] = y;
+        image->SetPixel(index, value + noise(generator));
+      }
+    }
+
+    return image;
+  }
+
+  static double GetPathCosts(CostFunctionType *costFunction, const PathType &path)
+  {
+    double costs = 0.0;
+    for (std::size_t i = 1; i < path.size(); ++i)
+      costs += costFunction->GetCost(path[i - 1], path[i]);
+    return costs;
+  }
+
+  static PathType GetReferencePath(InternalImageType *image,
+                                   const InternalImageType::IndexType &start,
+                                   const InternalImageType::IndexType &end)
+  {
+    auto costFunction = CostFunctionType::New();
+    costFunction->SetImage(image);
+    costFunction->SetStartIndex(start);
+    costFunction->SetEndIndex(end);
+
+    auto filter = itk::ShortestPathImageFilter<InternalImageType, InternalImageType>::New();
+    filter->SetInput(image);
+    filter->SetCostFunction(costFunction);
+    filter->SetFullNeighborsMode(true);
+    filter->SetMakeOutputImage(false);
+    filter->SetStartIndex(start);
+    filter->SetEndIndex(end);
+    filter->Update();
+
+    return filter->GetVectorPath();
+  }
+
+  static mitk::Point3D IndexToWorld(const mitk::Image *image, double x, double y)
+  {
+    mitk::Point3D index;
+    index[0] = x;
+    index[1] = y;
+    index[2] = 0.0;
+
+    mitk::Point3D world;
+    image->GetGeometry()->IndexToWorld(index, world);
+    return world;
+  }
+
+public:
+  void Engine_FindsPathsAsShortAsShortestPathImageFilter()
+  {
+    auto image = CreateSlice(96);
+
+    auto costFunction = CostFunctionType::New();
+    costFunction->SetImage(image);
+
+    auto engine = EngineType::New();
+    engine->SetCostFunction(costFunction);
+
+    const InternalImageType::IndexType anchor = {{10, 48}};
+    engine->SetAnchorIndex(anchor);
+
+    const InternalImageType::IndexType targets[] = {{{85, 48}}, {{48, 5}}, {{12, 50}}, {{90, 90}}, {{0, 0}}};
+
+    for (const auto &target : targets)
+    {
+      PathType path;
+      CPPUNIT_ASSERT(engine->GetPath(target, path));
+      CPPUNIT_ASSERT(path.front() == anchor);
+      CPPUNIT_ASSERT(path.back() == target);
+
+      for (std::size_t i = 1; i < path.size(); ++i)
+      {
+        CPPUNIT_ASSERT(std::abs(path[i][0] - path[i - 1][0]) <= 1 && std::abs(path[i][1] - path[i - 1][1]) <= 1);
+      }
+
+      const auto referencePath = GetReferencePath(image, anchor, target);
+      const auto costs = GetPathCosts(costFunction, path);
+      const auto referenceCosts = GetPathCosts(costFunction, referencePath);
+
+      // ties may be broken differently, but the path must not be more expensive
+      CPPUNIT_ASSERT(costs <= referenceCosts + 1e-6 * std::max(1.0, referenceCosts));
+    }
+  }
+
+  void Engine_ReusesSearchTreeOfAnchor()
+  {
+    auto image = CreateSlice(128);
+
+    auto costFunction = CostFunctionType::New();
+    costFunction->SetImage(image);
+
+    auto engine = EngineType::New();
+    engine->SetCostFunction(costFunction);
+    engine->SetAnchorIndex({{64, 64}});
+
+    PathType path;
+    CPPUNIT_ASSERT(engine->GetPath({{0, 0}}, path));
+    const auto settledNodes = engine->GetNumberOfSettledNodes();
+    CPPUNIT_ASSERT(settledNodes > 0);
+
+    // a target closer to the anchor is already settled
+    CPPUNIT_ASSERT(engine->GetPath({{70, 70}}, path));
+    CPPUNIT_ASSERT_EQUAL(settledNodes, engine->GetNumberOfSettledNodes());
+
+    // targets outside of the image are rejected
+    CPPUNIT_ASSERT(!engine->GetPath({{128, 0}}, path));
+    CPPUNIT_ASSERT(path.empty());
+
+    // a new anchor starts a new search
+    engine->SetAnchorIndex({{0, 0}});
+    CPPUNIT_ASSERT(engine->GetPath({{1, 1}}, path));
+    CPPUNIT_ASSERT(engine->GetNumberOfSettledNodes() < settledNodes);
+
+    // modifying the cost function invalidates the costs and the search tree
+    costFunction->SetUseCostMap(true);
+    CPPUNIT_ASSERT(engine->GetPath({{1, 1}}, path));
+    CPPUNIT_ASSERT(engine->GetNumberOfSettledNodes() < settledNodes);
+  }
+
+  void Filter_AvoidsRepulsivePoints()
+  {
+    auto image = mitk::GrabItkImageMemory(CreateSlice(96).GetPointer());
+
+    auto filter = mitk::ImageLiveWireContourModelFilter::New();
+    filter->SetInput(image);
+    filter->SetStartPoint(IndexToWorld(image, 10, 48));
+    filter->SetEndPoint(IndexToWorld(image, 85, 48));
+    filter->Update();
+
+    const auto numberOfVertices = filter->GetOutput()->GetNumberOfVertices();
+    CPPUNIT_ASSERT(numberOfVertices > 2);
+
+    itk::Index<2> repulsivePoint;
+    image->GetGeometry()->WorldToIndex(filter->GetOutput()->GetVertexAt(numberOfVertices / 2)->Coordinates,
+                                       repulsivePoint);
+
+    filter->AddRepulsivePoint(repulsivePoint);
+    filter->Modified();
+    filter->Update();
+
+    auto output = filter->GetOutput();
+    for (auto iter = output->IteratorBegin(); iter != output->IteratorEnd(); ++iter)
+    {
+      itk::Index<2> index;
+      image->GetGeometry()->WorldToIndex((*iter)->Coordinates, index);
+      CPPUNIT_ASSERT(index != repulsivePoint);
+    }
+  }
+
+  void Filter_FollowsMovingEndPointOn1024Slice()
+  {
+    auto image = mitk::GrabItkImageMemory(CreateSlice(1024).GetPointer());
+
+    auto filter = mitk::ImageLiveWireContourModelFilter::New();
+    filter->SetInput(image);
+    filter->SetStartPoint(IndexToWorld(image, 512, 170));
+
+    // the mouse circles around the disk, starting at the anchor
+    const unsigned int numberOfMoves = 200;
+
+    for (unsigned int i = 0; i <= numberOfMoves; ++i)
+    {
+      const double angle = 2.0 * 3.14159265358979 * i / numberOfMoves;
+      filter->SetEndPoint(IndexToWorld(image, 512 + 342 * std::sin(angle), 512 - 342 * std::cos(angle)));
+      filter->Update();
+
+      CPPUNIT_ASSERT(filter->GetOutput()->GetNumberOfVertices() > 0);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageLiveWireContourModelFilter)
@@ -0,0 +1,175 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkBinaryThresholdTool.h"
+#include "mitkToolManager.h"
+
+#include <mitkIOUtil.h>
+#include <mitkImageStatisticsHolder.h>
+#include <mitkStandaloneDataStorage.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <chrono>
+#include <thread>
+
+class mitkSegWithPreviewToolTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSegWithPreviewToolTestSuite);
+
+  MITK_TEST(BackgroundUpdate_EqualsSynchronousUpdate);
+  MITK_TEST(BackgroundUpdate_SupersedesStaleRequests);
+  MITK_TEST(CancelBackgroundPreviewUpdate_DiscardsResults);
+  MITK_TEST(ConfirmSegmentation_CompletesBackgroundUpdate);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::DataStorage::Pointer m_DataStorage;
+  mitk::ToolManager::Pointer m_ToolManager;
+  mitk::BinaryThresholdTool* m_Tool = nullptr;
+  mitk::DataNode::Pointer m_WorkingNode;
+
+  double m_Minimum = 0.;
+  double m_Maximum = 0.;
+
+  /** Delivers background results like the UI event loop would do, until the latest request is finished.*/
+  bool ProcessResultsUntilFinished()
+  {
+    const auto start = std::chrono::steady_clock::now();
+
+    while (m_Tool->IsBackgroundPreviewUpdatePending())
+    {
+      if (std::chrono::steady_clock::now() - start > std::chrono::seconds(60))
+        return false;
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      m_Tool->ProcessBackgroundPreviewResults();
+    }
+
+    return true;
+  }
+
+  mitk::Image::Pointer ComputeSynchronousPreview(double lower, double upper)
+  {
+    m_Tool->BackgroundPreviewUpdateOff();
+    m_Tool->SetThresholdValues(lower, upper);
+    return m_Tool->GetPreviewSegmentation()->Clone().GetPointer();
+  }
+
+public:
+  void setUp() override
+  {
+    m_DataStorage = mitk::StandaloneDataStorage::New();
+    m_ToolManager = mitk::ToolManager::New(m_DataStorage);
+    m_ToolManager->InitializeTools();
+    m_ToolManager->RegisterClient();
+
+    auto image = mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("Pic3D.nrrd"));
+    m_Minimum = image->GetStatistics()->GetScalarValueMin();
+    m_Maximum = image->GetStatistics()->GetScalarValueMax();
+
+    auto referenceNode = mitk::DataNode::New();
+    referenceNode->SetData(image);
+
+    const auto toolID = m_ToolManager->GetToolIdByToolType<mitk::BinaryThresholdTool>();
+    m_Tool = dynamic_cast<mitk::BinaryThresholdTool*>(m_ToolManager->GetToolById(toolID));
+    CPPUNIT_ASSERT(nullptr != m_Tool);
+
+    mitk::Color color;
+    color.SetRed(1);
+    color.SetGreen(0);
+    color.SetBlue(0);
+    m_WorkingNode = m_Tool->CreateEmptySegmentationNode(image, "test", color);
+
+    m_DataStorage->Add(referenceNode);
+    m_DataStorage->Add(m_WorkingNode);
+    m_ToolManager->SetReferenceData(referenceNode);
+    m_ToolManager->SetWorkingData(m_WorkingNode);
+    m_ToolManager->ActivateTool(toolID);
+  }
+
+  void tearDown() override
+  {
+    m_ToolManager->ActivateTool(-1);
+    m_Tool = nullptr;
+    m_WorkingNode = nullptr;
+    m_ToolManager = nullptr;
+    m_DataStorage = nullptr;
+  }
+
+  void BackgroundUpdate_EqualsSynchronousUpdate()
+  {
+    const double lower = m_Minimum + (m_Maximum - m_Minimum) * 0.3;
+    const double upper = m_Minimum + (m_Maximum - m_Minimum) * 0.7;
+
+    auto expected = this->ComputeSynchronousPreview(lower, upper);
+
+    this->ComputeSynchronousPreview(m_Maximum, m_Maximum);
+    m_Tool->BackgroundPreviewUpdateOn();
+    m_Tool->SetThresholdValues(lower, upper);
+
+    CPPUNIT_ASSERT(m_Tool->IsBackgroundPreviewUpdatePending());
+    CPPUNIT_ASSERT(this->ProcessResultsUntilFinished());
+
+    MITK_ASSERT_EQUAL(expected, m_Tool->GetPreviewSegmentation(), "Background preview equals synchronous preview.");
+  }
+
+  void BackgroundUpdate_SupersedesStaleRequests()
+  {
+    const double lower = m_Minimum + (m_Maximum - m_Minimum) * 0.5;
+    auto expected = this->ComputeSynchronousPreview(lower, m_Maximum);
+
+    m_Tool->BackgroundPreviewUpdateOn();
+
+    // simulates a slider that is moved while the previews are computed
+    for (int i = 0; i < 20; ++i)
+    {
+      m_Tool->SetThresholdValues(m_Minimum + (m_Maximum - m_Minimum) * i / 40., m_Maximum);
+    }
+    m_Tool->SetThresholdValues(lower, m_Maximum);
+
+    CPPUNIT_ASSERT(this->ProcessResultsUntilFinished());
+    MITK_ASSERT_EQUAL(expected, m_Tool->GetPreviewSegmentation(), "Only the latest request determines the preview.");
+  }
+
+  void CancelBackgroundPreviewUpdate_DiscardsResults()
+  {
+    auto expected = this->ComputeSynchronousPreview(m_Minimum, m_Maximum);
+
+    m_Tool->BackgroundPreviewUpdateOn();
+    m_Tool->SetThresholdValues(m_Maximum, m_Maximum);
+    m_Tool->CancelBackgroundPreviewUpdate(true);
+
+    CPPUNIT_ASSERT(!m_Tool->IsBackgroundPreviewUpdatePending());
+
+    m_Tool->ProcessBackgroundPreviewResults();
+    MITK_ASSERT_EQUAL(expected, m_Tool->GetPreviewSegmentation(), "Cancelled update does not change the preview.");
+  }
+
+  void ConfirmSegmentation_CompletesBackgroundUpdate()
+  {
+    const double lower = m_Minimum + (m_Maximum - m_Minimum) * 0.4;
+    auto expected = this->ComputeSynchronousPreview(lower, m_Maximum);
+
+    this->ComputeSynchronousPreview(m_Maximum, m_Maximum);
+    m_Tool->BackgroundPreviewUpdateOn();
+    m_Tool->KeepActiveAfterAcceptOn();
+    m_Tool->SetThresholdValues(lower, m_Maximum);
+    m_Tool->ConfirmSegmentation();
+
+    CPPUNIT_ASSERT(!m_Tool->IsBackgroundPreviewUpdatePending());
+    MITK_ASSERT_EQUAL(expected, m_Tool->GetPreviewSegmentation(), "Confirmation waits for a complete preview.");
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSegWithPreviewTool)
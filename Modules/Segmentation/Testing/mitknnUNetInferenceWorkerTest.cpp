@@ -0,0 +1,260 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitknnUnetInferenceWorker.h"
+#include "mitknnUnetTool.h"
+
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkCommand.h>
+#include <itksys/SystemTools.hxx>
+
+class mitknnUNetInferenceWorkerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitknnUNetInferenceWorkerTestSuite);
+
+  MITK_TEST(StartAndStop);
+  MITK_TEST(Start_InvalidWorker);
+  MITK_TEST(Predict_KeepsModelsLoaded);
+  MITK_TEST(Predict_MultiModal);
+  MITK_TEST(Predict_WorkerError);
+  MITK_TEST(Predict_ResponseTimeout);
+  MITK_TEST(Predict_OversizedResult);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::string m_Python;
+  mitk::nnUNetInferenceWorker::Pointer m_Worker;
+  std::vector<mitk::ModelParams> m_Models;
+  unsigned int m_LoadMessages = 0;
+
+  static void OnProgress(itk::Object *, const itk::EventObject &e, void *clientData)
+  {
+    const auto *event = dynamic_cast<const mitk::ExternalProcessStdOutEvent *>(&e);
+    if (nullptr != event && event->GetOutput().find("Loading") != std::string::npos)
+      ++*static_cast<unsigned int *>(clientData);
+  }
+
+  /** Creates an image with the values -1, 0, 1, -1, ... (shifted by offset).*/
+  mitk::Image::Pointer CreateImage(int offset)
+  {
+    const unsigned int dimensions[3] = { 7, 5, 3 };
+    auto image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<short>(), 3, dimensions);
+
+    mitk::Vector3D spacing;
+    spacing[0] = 0.5;
+    spacing[1] = 1.0;
+    spacing[2] = 2.5;
+    image->GetGeometry()->SetSpacing(spacing);
+
+    mitk::ImageWriteAccessor accessor(image);
+    auto data = static_cast<short *>(accessor.GetData());
+    for (int i = 0; i < 7 * 5 * 3; ++i)
+      data[i] = static_cast<short>((i + offset) % 3 - 1);
+
+    return image;
+  }
+
+  /** Checks the result against the expected number of positive modalities per voxel.*/
+  void CheckResult(const mitk::Image *result, const std::vector<int> &offsets)
+  {
+    CPPUNIT_ASSERT(nullptr != result);
+    CPPUNIT_ASSERT(result->GetPixelType() == mitk::MakeScalarPixelType<unsigned char>());
+    CPPUNIT_ASSERT_EQUAL(7u, result->GetDimension(0));
+    CPPUNIT_ASSERT_EQUAL(5u, result->GetDimension(1));
+    CPPUNIT_ASSERT_EQUAL(3u, result->GetDimension(2));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5, result->GetGeometry()->GetSpacing()[2], mitk::eps);
+
+    mitk::ImageReadAccessor accessor(result);
+    auto data = static_cast<const unsigned char *>(accessor.GetData());
+    for (int i = 0; i < 7 * 5 * 3; ++i)
+    {
+      int expected = 0;
+      for (auto offset : offsets)
+        expected += (i + offset) % 3 == 2 ? 1 : 0;
+      CPPUNIT_ASSERT_EQUAL(expected, static_cast<int>(data[i]));
+    }
+  }
+
+  void StartWorker()
+  {
+    mitk::nnUNetInferenceWorker::ArgumentListType args = { m_Python, MITK_NNUNET_DUMMY_WORKER };
+    m_Worker->Start(itksys::SystemTools::GetFilenamePath(m_Python), args);
+  }
+
+public:
+  void setUp() override
+  {
+#ifdef _WIN32
+    m_Python = itksys::SystemTools::FindProgram("python");
+#else
+    m_Python = itksys::SystemTools::FindProgram("python3");
+#endif
+    m_Worker = mitk::nnUNetInferenceWorker::New();
+    m_Worker->SetStartTimeout(60.0);
+    m_LoadMessages = 0;
+
+    auto command = itk::CStyleCommand::New();
+    command->SetCallback(&OnProgress);
+    command->SetClientData(&m_LoadMessages);
+    m_Worker->AddObserver(mitk::ExternalProcessStdOutEvent(""), command);
+
+    mitk::ModelParams model;
+    model.task = "Task002_Heart";
+    model.model = "3d_fullres";
+    model.trainer = "nnUNetTrainerV2";
+    model.planId = "nnUNetPlansv2.1";
+    model.folds = { "0" };
+    m_Models = { model };
+  }
+
+  void tearDown() override
+  {
+    m_Worker->Stop();
+    m_Worker = nullptr;
+  }
+
+  void StartAndStop()
+  {
+    if (m_Python.empty())
+    {
+      MITK_WARN << "Python interpreter not found, test skipped.";
+      return;
+    }
+
+    CPPUNIT_ASSERT(!m_Worker->IsRunning());
+    this->StartWorker();
+    CPPUNIT_ASSERT(m_Worker->IsRunning());
+    m_Worker->Stop();
+    CPPUNIT_ASSERT(!m_Worker->IsRunning());
+
+    // restart after stop
+    this->StartWorker();
+    CPPUNIT_ASSERT(m_Worker->IsRunning());
+  }
+
+  void Start_InvalidWorker()
+  {
+    if (m_Python.empty())
+    {
+      MITK_WARN << "Python interpreter not found, test skipped.";
+      return;
+    }
+
+    mitk::nnUNetInferenceWorker::ArgumentListType args = { m_Python, "non_existing_nnunet_worker.py" };
+    CPPUNIT_ASSERT_THROW(m_Worker->Start(itksys::SystemTools::GetFilenamePath(m_Python), args), mitk::Exception);
+    CPPUNIT_ASSERT(!m_Worker->IsRunning());
+
+    auto image = this->CreateImage(0);
+    CPPUNIT_ASSERT_THROW(m_Worker->Predict({ image.GetPointer() }, m_Models, false, false), mitk::Exception);
+  }
+
+  void Predict_KeepsModelsLoaded()
+  {
+    if (m_Python.empty())
+    {
+      MITK_WARN << "Python interpreter not found, test skipped.";
+      return;
+    }
+
+    this->StartWorker();
+    auto image = this->CreateImage(0);
+
+    auto result = m_Worker->Predict({ image.GetPointer() }, m_Models, true, true);
+    this->CheckResult(result, { 0 });
+
+    image = this->CreateImage(1);
+    result = m_Worker->Predict({ image.GetPointer() }, m_Models, true, true);
+    this->CheckResult(result, { 1 });
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Model is only loaded once.", 1u, m_LoadMessages);
+    CPPUNIT_ASSERT(m_Worker->IsRunning());
+  }
+
+  void Predict_MultiModal()
+  {
+    if (m_Python.empty())
+    {
+      MITK_WARN << "Python interpreter not found, test skipped.";
+      return;
+    }
+
+    this->StartWorker();
+    auto image0 = this->CreateImage(0);
+    auto image1 = this->CreateImage(2);
+
+    auto result = m_Worker->Predict({ image0.GetPointer(), image1.GetPointer() }, m_Models, false, false);
+    this->CheckResult(result, { 0, 2 });
+  }
+
+  void Predict_WorkerError()
+  {
+    if (m_Python.empty())
+    {
+      MITK_WARN << "Python interpreter not found, test skipped.";
+      return;
+    }
+
+    this->StartWorker();
+    auto image = this->CreateImage(0);
+
+    auto failingModels = m_Models;
+    failingModels.front().task = "fail";
+    CPPUNIT_ASSERT_THROW(m_Worker->Predict({ image.GetPointer() }, failingModels, false, false), mitk::Exception);
+    CPPUNIT_ASSERT_MESSAGE("Reported errors keep the worker alive.", m_Worker->IsRunning());
+
+    auto result = m_Worker->Predict({ image.GetPointer() }, m_Models, false, false);
+    this->CheckResult(result, { 0 });
+  }
+
+  void Predict_ResponseTimeout()
+  {
+    if (m_Python.empty())
+    {
+      MITK_WARN << "Python interpreter not found, test skipped.";
+      return;
+    }
+
+    this->StartWorker();
+    m_Worker->SetResponseTimeout(1.0);
+    auto image = this->CreateImage(0);
+
+    auto hangingModels = m_Models;
+    hangingModels.front().task = "hang";
+    CPPUNIT_ASSERT_THROW(m_Worker->Predict({ image.GetPointer() }, hangingModels, false, false), mitk::Exception);
+    CPPUNIT_ASSERT_MESSAGE("Unresponsive worker is stopped.", !m_Worker->IsRunning());
+  }
+
+  void Predict_OversizedResult()
+  {
+    if (m_Python.empty())
+    {
+      MITK_WARN << "Python interpreter not found, test skipped.";
+      return;
+    }
+
+    this->StartWorker();
+    auto image = this->CreateImage(0);
+
+    auto oversizedModels = m_Models;
+    oversizedModels.front().task = "oversized";
+    CPPUNIT_ASSERT_THROW(m_Worker->Predict({ image.GetPointer() }, oversizedModels, false, false), mitk::Exception);
+    CPPUNIT_ASSERT_MESSAGE("Worker with invalid result is stopped.", !m_Worker->IsRunning());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitknnUNetInferenceWorker)
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Stand-in for the persistent nnUNet worker (Resources/nnUNet/nnunet_worker.py) in tests.
+
+Implements the same protocol without nnUNet or numpy. The "segmentation" of a
+voxel is the number of modalities with a positive value. A model is "loaded"
+(reported as progress message) only on its first request. The task "fail"
+reports an error, the task "hang" never answers and the task "oversized" announces
+a result larger than any image.
+"""
+
+import argparse
+import array
+import json
+import socket
+import struct
+import sys
+import time
+
+PROTOCOL_VERSION = 1
+
+TYPE_CODES = {"uint8": "B", "int8": "b", "uint16": "H", "int16": "h", "uint32": "I", "int32": "i",
+              "uint64": "Q", "int64": "q", "float32": "f", "float64": "d"}
+
+
+def receive_exactly(connection, size):
+    data = bytearray()
+    while len(data) < size:
+        chunk = connection.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("Connection to MITK closed.")
+        data += chunk
+    return bytes(data)
+
+
+def receive_message(connection):
+    (length,) = struct.unpack("<Q", receive_exactly(connection, 8))
+    header = json.loads(receive_exactly(connection, length).decode("utf-8"))
+    buffers = [receive_exactly(connection, size) for size in header.get("buffers", [])]
+    return header, buffers
+
+
+def send_message(connection, header, buffers=()):
+    header = dict(header, buffers=[len(buffer) for buffer in buffers])
+    text = json.dumps(header).encode("utf-8")
+    connection.sendall(struct.pack("<Q", len(text)) + text)
+    for buffer in buffers:
+        connection.sendall(buffer)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--port", type=int, required=True)
+    parser.add_argument("--token", required=True)
+    args = parser.parse_args()
+
+    connection = socket.create_connection(("127.0.0.1", args.port))
+    send_message(connection, {"command": "hello", "token": args.token, "version": PROTOCOL_VERSION})
+
+    loaded_models = set()
+    while True:
+        try:
+            header, buffers = receive_message(connection)
+        except ConnectionError:
+            break
+
+        if header.get("command") == "shutdown":
+            break
+
+        for model in header["models"]:
+            if model["task"] == "fail":
+                send_message(connection, {"status": "error", "message": "Requested failure"})
+                break
+            if model["task"] == "hang":
+                time.sleep(3600)
+            if model["task"] == "oversized":
+                # header only, the announced buffer is never sent
+                text = json.dumps({"status": "result", "image": {"dtype": "uint8"}, "buffers": [1 << 62]})
+                connection.sendall(struct.pack("<Q", len(text)) + text.encode("utf-8"))
+                break
+            key = (model["task"], model["model"], model["trainer"], model["planId"], tuple(model["folds"]))
+            if key not in loaded_models:
+                loaded_models.add(key)
+                send_message(connection, {"status": "progress", "message": "Loading model %s" % model["task"]})
+        else:
+            labels = None
+            for image, buffer in zip(header["images"], buffers):
+                values = array.array(TYPE_CODES[image["dtype"]], buffer)
+                positive = [1 if value > 0 else 0 for value in values]
+                labels = positive if labels is None else [a + b for a, b in zip(labels, positive)]
+            shape = header["images"][0]["shape"]
+            send_message(connection, {"status": "result", "image": {"dtype": "uint8", "shape": shape}},
+                         [bytes(labels)])
+
+    connection.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -130,6 +130,8 @@ void QmitkBinaryThresholdToolGUIBase::ConnectNewTool(mitk::SegWithPreviewTool* n
 
   if (nullptr != tool)
   {
+    // slider moves must not block the UI, the preview is computed in the background
+    tool->BackgroundPreviewUpdateOn();
     tool->IntervalBordersChanged +=
       mitk::MessageDelegate3<QmitkBinaryThresholdToolGUIBase, double, double, bool>(
         this, &QmitkBinaryThresholdToolGUIBase::OnThresholdingIntervalBordersChanged);
@@ -32,7 +32,9 @@ QmitkSegWithPreviewToolGUIBase::~QmitkSegWithPreviewToolGUIBase()
 {
   if (m_Tool.IsNotNull())
   {
+    m_Tool->BackgroundPreviewUpdateOff();
     m_Tool->CurrentlyBusy -= mitk::MessageDelegate1<QmitkSegWithPreviewToolGUIBase, bool>(this, &QmitkSegWithPreviewToolGUIBase::BusyStateChanged);
+    m_Tool->BackgroundPreviewResultsAvailable -= mitk::MessageDelegate<QmitkSegWithPreviewToolGUIBase>(this, &QmitkSegWithPreviewToolGUIBase::OnBackgroundPreviewResultsAvailable);
   }
 }
 
@@ -114,13 +116,18 @@ void QmitkSegWithPreviewToolGUIBase::OnAcceptPreview()
 
 void QmitkSegWithPreviewToolGUIBase::DisconnectOldTool(mitk::SegWithPreviewTool* oldTool)
 {
+  //nobody would process the results of background updates anymore
+  oldTool->BackgroundPreviewUpdateOff();
   oldTool->CurrentlyBusy -= mitk::MessageDelegate1<QmitkSegWithPreviewToolGUIBase, bool>(this, &QmitkSegWithPreviewToolGUIBase::BusyStateChanged);
+  oldTool->BackgroundPreviewResultsAvailable -= mitk::MessageDelegate<QmitkSegWithPreviewToolGUIBase>(this, &QmitkSegWithPreviewToolGUIBase::OnBackgroundPreviewResultsAvailable);
 }
 
 void QmitkSegWithPreviewToolGUIBase::ConnectNewTool(mitk::SegWithPreviewTool* newTool)
 {
   newTool->CurrentlyBusy +=
     mitk::MessageDelegate1<QmitkSegWithPreviewToolGUIBase, bool>(this, &QmitkSegWithPreviewToolGUIBase::BusyStateChanged);
+  newTool->BackgroundPreviewResultsAvailable +=
+    mitk::MessageDelegate<QmitkSegWithPreviewToolGUIBase>(this, &QmitkSegWithPreviewToolGUIBase::OnBackgroundPreviewResultsAvailable);
 
   m_CheckProcessAll->setVisible(newTool->GetTargetSegmentationNode()->GetData()->GetTimeSteps() > 1);
 
@@ -145,6 +152,18 @@ void QmitkSegWithPreviewToolGUIBase::BusyStateChanged(bool isBusy)
   this->EnableWidgets(!isBusy);
  }
 
+void QmitkSegWithPreviewToolGUIBase::OnBackgroundPreviewResultsAvailable()
+{
+  // called on the worker thread of the tool; the queued call is dropped if this GUI is destroyed in between
+  QMetaObject::invokeMethod(this, [this]()
+  {
+    if (m_Tool.IsNotNull())
+    {
+      m_Tool->ProcessBackgroundPreviewResults();
+    }
+  }, Qt::QueuedConnection);
+}
+
 void QmitkSegWithPreviewToolGUIBase::EnableWidgets(bool enabled)
 {
   if (nullptr != m_MainLayout)
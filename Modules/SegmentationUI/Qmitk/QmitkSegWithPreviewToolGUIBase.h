@@ -60,6 +60,10 @@ protected:
 
   void BusyStateChanged(bool isBusy) override;
 
+  /**Called by the worker thread of the tool, if background preview results are available.
+   Schedules their transfer into the preview on the UI thread.*/
+  void OnBackgroundPreviewResultsAvailable();
+
   using EnableConfirmSegBtnFunctionType = std::function<bool(bool)>;
   EnableConfirmSegBtnFunctionType m_EnableConfirmSegBtnFnc;
 
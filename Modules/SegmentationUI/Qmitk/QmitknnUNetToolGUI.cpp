@@ -623,6 +623,7 @@ void QmitknnUNetToolGUI::OnPreviewRequested()
       tool->SetMirror(m_Controls.mirrorBox->isChecked());
       tool->SetMixedPrecision(m_Controls.mixedPrecisionBox->isChecked());
       tool->SetNoPip(false);
+      tool->SetPersistentWorker(m_Controls.persistentWorkerCheckBox->isChecked());
       bool doCache = m_Controls.enableCachingCheckBox->isChecked();
       // Spinboxes
       tool->SetGpuId(FetchSelectedGPUFromUI());
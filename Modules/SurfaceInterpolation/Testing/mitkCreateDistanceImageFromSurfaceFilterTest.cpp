@@ -14,9 +14,12 @@ found in the LICENSE file.
 #include <mitkCreateDistanceImageFromSurfaceFilter.h>
 #include <mitkIOUtil.h>
 #include <mitkImageAccessByItk.h>
+#include <mitkImageReadAccessor.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
+#include <algorithm>
+
 #include <vtkDebugLeaks.h>
 
 class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixture
@@ -26,6 +29,8 @@ class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixtu
   // Basically tests the same as the other test below
   // MITK_TEST(TestCreateDistanceImageForLiver);
   MITK_TEST(TestCreateDistanceImageForTube);
+  MITK_TEST(TestCompactSolverAgreesWithDenseSolver);
+  MITK_TEST(TestCompactSolverSupportIsBoundedByNeighbors);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -128,6 +133,106 @@ public:
     CPPUNIT_ASSERT_MESSAGE("HolesDistanceImages are not equal!",
                            mitk::Equal(*(holesDistanceImageReference), *(holeDistanceImage), 0.0001, true));
   }
+
+  mitk::Image::Pointer CreateTubeDistanceImage(mitk::CreateDistanceImageFromSurfaceFilter::RBFSolverType solver,
+                                               unsigned int maximumNumberOfSupportNeighbors = 200,
+                                               double *supportRadius = nullptr)
+  {
+    std::vector<mitk::Surface::Pointer> contours;
+
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+      std::stringstream s;
+      s << "SurfaceInterpolation/InterpolateWithHoles/ContourWithHoles_" << i << ".vtk";
+      contours.push_back(mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath(s.str())));
+    }
+
+    mitk::Image::Pointer segmentationImage =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/SegmentationWithHoles.nrrd"));
+
+    auto normalsFilter = mitk::ComputeContourSetNormalsFilter::New();
+    auto interpolateSurfaceFilter = mitk::CreateDistanceImageFromSurfaceFilter::New();
+
+    normalsFilter->SetSegmentationBinaryImage(segmentationImage);
+    itk::ImageBase<3>::Pointer itkImage = itk::ImageBase<3>::New();
+    AccessFixedDimensionByItk_1(segmentationImage, GetImageBase, 3, itkImage);
+    interpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
+    interpolateSurfaceFilter->SetRBFSolver(solver);
+    interpolateSurfaceFilter->SetMaximumNumberOfSupportNeighbors(maximumNumberOfSupportNeighbors);
+
+    for (unsigned int j = 0; j < contours.size(); j++)
+    {
+      normalsFilter->SetInput(j, contours.at(j));
+      interpolateSurfaceFilter->SetInput(j, normalsFilter->GetOutput(j));
+    }
+
+    interpolateSurfaceFilter->Update();
+
+    if (mitk::CreateDistanceImageFromSurfaceFilter::CompactRBFSolver == solver)
+    {
+      CPPUNIT_ASSERT(interpolateSurfaceFilter->GetSupportRadius() > interpolateSurfaceFilter->GetDistanceImageSpacing());
+    }
+
+    if (nullptr != supportRadius)
+      *supportRadius = interpolateSurfaceFilter->GetSupportRadius();
+
+    return interpolateSurfaceFilter->GetOutput();
+  }
+
+  void TestCompactSolverAgreesWithDenseSolver()
+  {
+    auto denseImage = this->CreateTubeDistanceImage(mitk::CreateDistanceImageFromSurfaceFilter::DenseRBFSolver);
+    auto compactImage = this->CreateTubeDistanceImage(mitk::CreateDistanceImageFromSurfaceFilter::CompactRBFSolver);
+
+    CPPUNIT_ASSERT(mitk::Equal(*denseImage->GetGeometry(), *compactImage->GetGeometry(), mitk::eps, true));
+
+    mitk::ImageReadAccessor denseAccessor(denseImage);
+    mitk::ImageReadAccessor compactAccessor(compactImage);
+    auto denseData = static_cast<const double *>(denseAccessor.GetData());
+    auto compactData = static_cast<const double *>(compactAccessor.GetData());
+
+    const auto spacing = denseImage->GetGeometry()->GetSpacing()[0];
+    const auto numberOfPixels = denseImage->GetDimension(0) * denseImage->GetDimension(1) * denseImage->GetDimension(2);
+    unsigned int numberOfDenseInsidePixels = 0;
+    unsigned int numberOfCompactInsidePixels = 0;
+    unsigned int numberOfDisagreeingPixels = 0;
+
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      if (denseData[i] < 0)
+        ++numberOfDenseInsidePixels;
+
+      if (compactData[i] < 0)
+        ++numberOfCompactInsidePixels;
+
+      // Both solvers interpolate the same contours, so their zero level sets must not be further apart than one
+      // pixel: every pixel farther than one pixel from the dense zero level set has to be on the same side.
+      if (std::abs(denseData[i]) > spacing && (denseData[i] < 0) != (compactData[i] < 0))
+        ++numberOfDisagreeingPixels;
+    }
+
+    CPPUNIT_ASSERT(numberOfDenseInsidePixels > 0);
+    CPPUNIT_ASSERT(numberOfDisagreeingPixels < numberOfDenseInsidePixels / 100);
+    CPPUNIT_ASSERT(std::abs(static_cast<int>(numberOfCompactInsidePixels) - static_cast<int>(numberOfDenseInsidePixels)) <
+                   static_cast<int>(numberOfDenseInsidePixels / 20));
+  }
+
+  void TestCompactSolverSupportIsBoundedByNeighbors()
+  {
+    double unboundedSupportRadius = 0.0;
+    this->CreateTubeDistanceImage(mitk::CreateDistanceImageFromSurfaceFilter::CompactRBFSolver, 0, &unboundedSupportRadius);
+
+    double boundedSupportRadius = 0.0;
+    auto boundedImage = this->CreateTubeDistanceImage(mitk::CreateDistanceImageFromSurfaceFilter::CompactRBFSolver, 10, &boundedSupportRadius);
+
+    CPPUNIT_ASSERT(boundedSupportRadius < unboundedSupportRadius);
+
+    mitk::ImageReadAccessor accessor(boundedImage);
+    auto data = static_cast<const double *>(accessor.GetData());
+    const auto numberOfPixels = boundedImage->GetDimension(0) * boundedImage->GetDimension(1) * boundedImage->GetDimension(2);
+
+    CPPUNIT_ASSERT(std::any_of(data, data + numberOfPixels, [](double value) { return value < 0; }));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkCreateDistanceImageFromSurfaceFilter)
@@ -20,9 +20,137 @@ found in the LICENSE file.
 #include "vtkSmartPointer.h"
 
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkNeighborhoodIterator.h"
+#include "itkMultiThreaderBase.h"
 
-#include <queue>
+#include <Eigen/Sparse>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <unordered_map>
+
+namespace
+{
+  /** Wendland's C2 function, positive definite in 3D. r is the distance divided by the support radius. */
+  inline double WendlandC2(double r)
+  {
+    const double t = 1.0 - r;
+    return t * t * t * t * (4.0 * r + 1.0);
+  }
+
+  /** Median over a sample of the centers of the distance to their k-th nearest center. */
+  double EstimateNeighborhoodRadius(const mitk::CreateDistanceImageFromSurfaceFilter::CenterList &centers, std::size_t k)
+  {
+    const auto numberOfCenters = centers.size();
+
+    if (0 == k || numberOfCenters <= k)
+      return std::numeric_limits<double>::max();
+
+    const auto numberOfSamples = std::min<std::size_t>(numberOfCenters, 256);
+    std::vector<double> radii(numberOfSamples);
+
+    itk::MultiThreaderBase::New()->ParallelizeArray(0, numberOfSamples, [&](itk::SizeValueType sample)
+    {
+      const auto &center = centers[sample * numberOfCenters / numberOfSamples];
+      std::vector<double> squaredDistances(numberOfCenters);
+
+      for (std::size_t i = 0; i < numberOfCenters; ++i)
+        squaredDistances[i] = (centers[i] - center).squared_magnitude();
+
+      // Index 0 is the center itself
+      std::nth_element(squaredDistances.begin(), squaredDistances.begin() + k, squaredDistances.end());
+      radii[sample] = std::sqrt(squaredDistances[k]);
+    }, nullptr);
+
+    std::nth_element(radii.begin(), radii.begin() + numberOfSamples / 2, radii.end());
+    return radii[numberOfSamples / 2];
+  }
+
+  /** Sides of the plane of a contour without neighboring contour, see CreateDistanceImageFromSurfaceFilter::EstimateLocalDistance(). */
+  enum OpenSide : unsigned char
+  {
+    OpenAbove = 1,
+    OpenBelow = 2
+  };
+}
+
+/** Uniform grid of cubic cells with the support radius as edge length.
+ * All centers within the support radius of a point are found in the 27 cells around it. */
+class mitk::CreateDistanceImageFromSurfaceFilter::CenterGrid
+{
+public:
+  CenterGrid(const CenterList &centers, double cellSize) : m_Centers(centers), m_CellSize(cellSize)
+  {
+    m_Origin = centers.front();
+
+    for (const auto &center : centers)
+    {
+      for (unsigned int dim = 0; dim < 3; ++dim)
+        m_Origin[dim] = std::min(m_Origin[dim], center[dim]);
+    }
+
+    for (std::size_t i = 0; i < centers.size(); ++i)
+      m_Cells[this->GetKey(this->GetCell(centers[i]))].push_back(i);
+  }
+
+  /** Calls function(centerIndex, distance) for all centers closer than radius to p, in ascending center index order per cell. */
+  template <typename TFunction>
+  void ForEachCenterWithin(const PointType &p, double radius, TFunction function) const
+  {
+    const auto cell = this->GetCell(p);
+    const auto squaredRadius = radius * radius;
+
+    for (long x = cell[0] - 1; x <= cell[0] + 1; ++x)
+    {
+      for (long y = cell[1] - 1; y <= cell[1] + 1; ++y)
+      {
+        for (long z = cell[2] - 1; z <= cell[2] + 1; ++z)
+        {
+          auto finding = m_Cells.find(this->GetKey({ { x, y, z } }));
+
+          if (m_Cells.end() == finding)
+            continue;
+
+          for (const auto i : finding->second)
+          {
+            const auto squaredDistance = (p - m_Centers[i]).squared_magnitude();
+
+            if (squaredDistance < squaredRadius)
+              function(i, std::sqrt(squaredDistance));
+          }
+        }
+      }
+    }
+  }
+
+private:
+  typedef std::array<long, 3> CellType;
+
+  CellType GetCell(const PointType &p) const
+  {
+    CellType cell;
+
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      cell[dim] = static_cast<long>(std::floor((p[dim] - m_Origin[dim]) / m_CellSize));
+
+    return cell;
+  }
+
+  static std::int64_t GetKey(const CellType &cell)
+  {
+    // 21 bits per dimension are plenty for any image extent divided by the support radius
+    return ((static_cast<std::int64_t>(cell[0]) & 0x1FFFFF) << 42) | ((static_cast<std::int64_t>(cell[1]) & 0x1FFFFF) << 21) |
+           (static_cast<std::int64_t>(cell[2]) & 0x1FFFFF);
+  }
+
+  const CenterList &m_Centers;
+  double m_CellSize;
+  PointType m_Origin;
+  std::unordered_map<std::int64_t, std::vector<std::size_t>> m_Cells;
+};
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 {
@@ -105,7 +233,11 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 }
 
 mitk::CreateDistanceImageFromSurfaceFilter::CreateDistanceImageFromSurfaceFilter()
-  : m_DistanceImageSpacing(0.0), m_DistanceImageDefaultBufferValue(0.0)
+  : m_DistanceImageSpacing(0.0),
+    m_DistanceImageDefaultBufferValue(0.0),
+    m_RBFSolver(DenseRBFSolver),
+    m_MaximumNumberOfSupportNeighbors(200),
+    m_SupportRadius(0.0)
 {
   m_DistanceImageVolume = 50000;
   this->m_UseProgressBar = false;
@@ -130,7 +262,15 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(1);
 
-  m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+  if (CompactRBFSolver == m_RBFSolver)
+  {
+    this->SolveCompactEquationSystem();
+  }
+  else
+  {
+    m_SupportRadius = 0.0;
+    m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+  }
 
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(2);
@@ -143,6 +283,11 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 
   m_Centers.clear();
   m_Normals.clear();
+  m_CenterInputIndices.clear();
+  m_ContourPlaneNormals.clear();
+  m_OpenSides.clear();
+  m_CapRadii.clear();
+  m_CenterGrid.reset();
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
@@ -168,6 +313,8 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   PointType currentPoint;
   PointType normal;
 
+  std::set<std::array<double, 3>> uniquePoints;
+
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
     auto currentSurface = this->GetInput(i);
@@ -199,9 +346,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
         currentPoint.copy_in(p);
 
-        int count = std::count(m_Centers.begin(), m_Centers.end(), currentPoint);
-
-        if (count == 0)
+        if (uniquePoints.insert({ { p[0], p[1], p[2] } }).second)
         {
           double currentNormal[3];
           currentCellNormals->GetTuple(cell[j], currentNormal);
@@ -211,6 +356,8 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
           m_Normals.push_back(normal);
 
           m_Centers.push_back(currentPoint);
+
+          m_CenterInputIndices.push_back(i);
         }
 
       } // end for all points
@@ -264,10 +411,17 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   // Now we have created all centers and all function values. Next step is to create the solution matrix
   numberOfCenters = m_Centers.size();
 
-  m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
-
   m_Weights.resize(numberOfCenters);
 
+  // The compact solver assembles a sparse matrix instead
+  if (CompactRBFSolver == m_RBFSolver)
+  {
+    m_SolutionMatrix.resize(0, 0);
+    return;
+  }
+
+  m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
+
   PointType p1;
   PointType p2;
   double norm;
@@ -300,11 +454,10 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   */
 
   typedef itk::ImageRegionIteratorWithIndex<DistanceImageType> ImageIterator;
-  typedef itk::NeighborhoodIterator<DistanceImageType> NeighborhoodImageIterator;
 
-  std::queue<DistanceImageType::IndexType> narrowbandPoints;
   PointType currentPoint = m_Centers.at(0);
-  double distance = this->CalculateDistanceValue(currentPoint);
+  double distance = 0.0;
+  this->EvaluateDistanceValue(currentPoint, distance);
 
   // create itk::Point from vnl_vector
   DistanceImageType::PointType currentPointAsPoint;
@@ -316,49 +469,82 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   DistanceImageType::IndexType currentIndex;
   m_DistanceImageITK->TransformPhysicalPointToIndex(currentPointAsPoint, currentIndex);
 
-  assert(
-    m_DistanceImageITK->GetLargestPossibleRegion().IsInside(currentIndex)); // we are quite certain this should hold
+  const auto region = m_DistanceImageITK->GetLargestPossibleRegion();
+
+  assert(region.IsInside(currentIndex)); // we are quite certain this should hold
 
-  narrowbandPoints.push(currentIndex);
   m_DistanceImageITK->SetPixel(currentIndex, distance);
 
-  NeighborhoodImageIterator::RadiusType radius;
-  radius.Fill(1);
-  NeighborhoodImageIterator nIt(radius, m_DistanceImageITK, m_DistanceImageITK->GetLargestPossibleRegion());
-  unsigned int relativeNbIdx[] = {4, 10, 12, 14, 16, 22};
+  // Each pixel is evaluated at most once. The narrow band is grown front by front, so the
+  // expensive evaluations of a front can be done in parallel.
+  std::vector<bool> evaluated(region.GetNumberOfPixels(), false);
+  evaluated[m_DistanceImageITK->ComputeOffset(currentIndex)] = true;
+
+  std::vector<DistanceImageType::IndexType> front = { currentIndex };
+  std::vector<DistanceImageType::IndexType> candidates;
+  std::vector<double> candidateDistances;
+  std::vector<char> candidateAccepted;
 
-  bool isInBounds = false;
-  while (!narrowbandPoints.empty())
+  auto multiThreader = itk::MultiThreaderBase::New();
+
+  while (!front.empty())
   {
-    nIt.SetLocation(narrowbandPoints.front());
-    narrowbandPoints.pop();
+    candidates.clear();
 
-    unsigned int *relativeNb = &relativeNbIdx[0];
-    for (int i = 0; i < 6; i++)
+    for (const auto &index : front)
     {
-      nIt.GetPixel(*relativeNb, isInBounds);
-      if (isInBounds && nIt.GetPixel(*relativeNb) == m_DistanceImageDefaultBufferValue)
+      for (unsigned int dim = 0; dim < 3; ++dim)
       {
-        currentIndex = nIt.GetIndex(*relativeNb);
+        for (int step = -1; step <= 1; step += 2)
+        {
+          auto neighbor = index;
+          neighbor[dim] += step;
 
-        // Transform the currently checked point from index-coordinates to
-        // world-coordinates
-        m_DistanceImageITK->TransformIndexToPhysicalPoint(currentIndex, currentPointAsPoint);
+          if (!region.IsInside(neighbor))
+            continue;
 
-        // create a vnl_vector
-        currentPoint[0] = currentPointAsPoint[0];
-        currentPoint[1] = currentPointAsPoint[1];
-        currentPoint[2] = currentPointAsPoint[2];
+          const auto offset = m_DistanceImageITK->ComputeOffset(neighbor);
 
-        // and check the distance
-        distance = this->CalculateDistanceValue(currentPoint);
-        if (std::fabs(distance) <= m_DistanceImageSpacing * 2)
-        {
-          nIt.SetPixel(*relativeNb, distance);
-          narrowbandPoints.push(currentIndex);
+          if (!evaluated[offset])
+          {
+            evaluated[offset] = true;
+            candidates.push_back(neighbor);
+          }
         }
       }
-      relativeNb++;
+    }
+
+    candidateDistances.resize(candidates.size());
+    candidateAccepted.assign(candidates.size(), 0);
+
+    multiThreader->ParallelizeArray(0, candidates.size(), [&](itk::SizeValueType i)
+    {
+      // Transform the currently checked point from index-coordinates to world-coordinates
+      DistanceImageType::PointType candidatePointAsPoint;
+      m_DistanceImageITK->TransformIndexToPhysicalPoint(candidates[i], candidatePointAsPoint);
+
+      PointType candidatePoint;
+      candidatePoint[0] = candidatePointAsPoint[0];
+      candidatePoint[1] = candidatePointAsPoint[1];
+      candidatePoint[2] = candidatePointAsPoint[2];
+
+      // and check the distance
+      if (this->EvaluateDistanceValue(candidatePoint, candidateDistances[i]) &&
+          std::fabs(candidateDistances[i]) <= m_DistanceImageSpacing * 2)
+      {
+        candidateAccepted[i] = 1;
+      }
+    }, nullptr);
+
+    front.clear();
+
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      if (candidateAccepted[i])
+      {
+        m_DistanceImageITK->SetPixel(candidates[i], candidateDistances[i]);
+        front.push_back(candidates[i]);
+      }
     }
   }
 
@@ -419,14 +605,214 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   CastToMitkImage(m_DistanceImageITK, resultImage);
 }
 
-double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p)
+void mitk::CreateDistanceImageFromSurfaceFilter::SolveCompactEquationSystem()
+{
+  const auto numberOfCenters = m_Centers.size();
+  const auto numberOfContourPoints = m_CenterInputIndices.size();
+
+  // The support has to bridge the gap between neighboring contours, otherwise the base distance
+  // is undetermined in between. The gap is the largest distance of a contour point to the closest
+  // point of another contour. It is searched with doubling radius until all points are resolved.
+  double extent = 0.0;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+    extent = std::max(extent, m_DistanceImageITK->GetLargestPossibleRegion().GetSize()[dim] * m_DistanceImageSpacing);
+
+  const CenterList contourPoints(m_Centers.begin(), m_Centers.begin() + numberOfContourPoints);
+  std::vector<double> gaps(numberOfContourPoints, -1.0);
+
+  for (double radius = 4.0 * m_DistanceImageSpacing; radius < 2.0 * extent; radius *= 2.0)
+  {
+    const CenterGrid contourGrid(contourPoints, radius);
+    bool isResolved = true;
+
+    for (std::size_t i = 0; i < numberOfContourPoints; ++i)
+    {
+      if (gaps[i] >= 0.0)
+        continue;
+
+      contourGrid.ForEachCenterWithin(contourPoints[i], radius, [&](std::size_t j, double d) {
+        if (m_CenterInputIndices[j] != m_CenterInputIndices[i] && (gaps[i] < 0.0 || d < gaps[i]))
+          gaps[i] = d;
+      });
+
+      isResolved = isResolved && gaps[i] >= 0.0;
+    }
+
+    if (isResolved)
+      break;
+  }
+
+  const double largestGap = numberOfContourPoints > 0 ? *std::max_element(gaps.begin(), gaps.end()) : 0.0;
+
+  // Densely sampled contours with a wide gap in between would put nearly all centers into the support of
+  // each other and make the equation system dense. The support is therefore limited to the radius that
+  // contains m_MaximumNumberOfSupportNeighbors centers around a typical center.
+  const double neighborhoodRadius = EstimateNeighborhoodRadius(m_Centers, m_MaximumNumberOfSupportNeighbors);
+  m_SupportRadius = std::max(std::min(2.0 * largestGap, neighborhoodRadius), 6.0 * m_DistanceImageSpacing);
+
+  if (m_SupportRadius < largestGap)
+  {
+    MITK_WARN << "Support radius of the compact RBF solver limited to " << m_SupportRadius << " by "
+              << m_MaximumNumberOfSupportNeighbors << " neighbors, the largest gap between contours is " << largestGap
+              << ". Contours farther apart are closed separately.";
+  }
+
+  // The contour planes are the planes of least variance of the contour points of each input
+  const auto numberOfInputs = m_CenterInputIndices.empty() ? 0 : *std::max_element(m_CenterInputIndices.begin(), m_CenterInputIndices.end()) + 1;
+  std::vector<Eigen::Vector3d> sums(numberOfInputs, Eigen::Vector3d::Zero());
+  std::vector<Eigen::Matrix3d> squaredSums(numberOfInputs, Eigen::Matrix3d::Zero());
+  std::vector<std::size_t> counts(numberOfInputs, 0);
+
+  for (std::size_t i = 0; i < numberOfContourPoints; ++i)
+  {
+    const Eigen::Vector3d point(contourPoints[i][0], contourPoints[i][1], contourPoints[i][2]);
+    const auto input = m_CenterInputIndices[i];
+    sums[input] += point;
+    squaredSums[input] += point * point.transpose();
+    ++counts[input];
+  }
+
+  m_ContourPlaneNormals.assign(numberOfInputs, PointType(0.0, 0.0, 1.0));
+
+  for (std::size_t input = 0; input < numberOfInputs; ++input)
+  {
+    if (0 == counts[input])
+      continue;
+
+    const Eigen::Vector3d mean = sums[input] / counts[input];
+    const Eigen::Matrix3d covariance = squaredSums[input] / counts[input] - mean * mean.transpose();
+    const Eigen::Vector3d normal = Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d>(covariance).eigenvectors().col(0);
+
+    m_ContourPlaneNormals[input] = PointType(normal[0], normal[1], normal[2]);
+  }
+
+  // A side of a contour plane is open if no other contour is within the support on this side.
+  // The surface is closed there with a rounded cap of half the gap to the next contour.
+  const CenterGrid supportGrid(contourPoints, m_SupportRadius);
+  m_OpenSides.assign(numberOfContourPoints, OpenAbove | OpenBelow);
+  m_CapRadii.resize(numberOfContourPoints);
+
+  for (std::size_t i = 0; i < numberOfContourPoints; ++i)
+  {
+    const auto &planeNormal = m_ContourPlaneNormals[m_CenterInputIndices[i]];
+
+    supportGrid.ForEachCenterWithin(contourPoints[i], m_SupportRadius, [&](std::size_t j, double) {
+      if (m_CenterInputIndices[j] == m_CenterInputIndices[i])
+        return;
+
+      const auto height = dot_product(planeNormal, contourPoints[j] - contourPoints[i]);
+
+      if (height > 0.0)
+        m_OpenSides[i] &= ~OpenAbove;
+      else if (height < 0.0)
+        m_OpenSides[i] &= ~OpenBelow;
+    });
+
+    m_CapRadii[i] = std::max(0.5 * gaps[i], 2.0 * m_DistanceImageSpacing);
+  }
+
+  m_CenterGrid.reset(new CenterGrid(m_Centers, m_SupportRadius));
+
+  // assemble the sparse, symmetric positive definite interpolation matrix
+  std::vector<std::vector<Eigen::Triplet<double>>> tripletsPerCenter(numberOfCenters);
+
+  itk::MultiThreaderBase::New()->ParallelizeArray(0, numberOfCenters, [&](itk::SizeValueType i)
+  {
+    m_CenterGrid->ForEachCenterWithin(m_Centers[i], m_SupportRadius, [&](std::size_t j, double d)
+    {
+      tripletsPerCenter[i].emplace_back(static_cast<int>(i), static_cast<int>(j), WendlandC2(d / m_SupportRadius));
+    });
+  }, nullptr);
+
+  std::vector<Eigen::Triplet<double>> triplets;
+  for (const auto &centerTriplets : tripletsPerCenter)
+    triplets.insert(triplets.end(), centerTriplets.begin(), centerTriplets.end());
+
+  Eigen::SparseMatrix<double> matrix(numberOfCenters, numberOfCenters);
+  matrix.setFromTriplets(triplets.begin(), triplets.end());
+
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(matrix);
+
+  if (Eigen::Success != solver.info())
+  {
+    itkExceptionMacro("mitk::CreateDistanceImageFromSurfaceFilter: Factorization of the sparse RBF equation system failed.");
+  }
+
+  // The RBF interpolates the residuals of the base distance, which is evaluated with zero weights
+  m_Weights.setZero();
+  Eigen::VectorXd residuals(numberOfCenters);
+
+  itk::MultiThreaderBase::New()->ParallelizeArray(0, numberOfCenters, [&](itk::SizeValueType i)
+  {
+    double baseDistance = 0.0;
+    this->EvaluateDistanceValue(m_Centers[i], baseDistance);
+    residuals[i] = m_FunctionValues[i] - baseDistance;
+  }, nullptr);
+
+  m_Weights = solver.solve(residuals);
+}
+
+double mitk::CreateDistanceImageFromSurfaceFilter::EstimateLocalDistance(std::size_t i, const PointType &p) const
+{
+  const auto offset = p - m_Centers[i];
+
+  // Signed distance to the tangent of the contour within the contour plane
+  const auto distance = dot_product(m_Normals[i], offset);
+  const auto height = dot_product(m_ContourPlaneNormals[m_CenterInputIndices[i]], offset);
+
+  if (!(height > 0.0 && (m_OpenSides[i] & OpenAbove)) && !(height < 0.0 && (m_OpenSides[i] & OpenBelow)))
+    return distance;
+
+  // Beyond the outermost contour: distance to a cap whose edge is rounded with the cap radius
+  const auto depth = -distance;
+  const auto capRadius = m_CapRadii[i];
+  const auto capDistance = depth >= capRadius
+    ? std::fabs(height) - capRadius
+    : std::sqrt((depth - capRadius) * (depth - capRadius) + height * height) - capRadius;
+
+  return std::max(distance, capDistance);
+}
+
+bool mitk::CreateDistanceImageFromSurfaceFilter::EvaluateDistanceValue(const PointType &p, double &distance) const
+{
+  if (CompactRBFSolver != m_RBFSolver)
+  {
+    distance = this->CalculateDistanceValue(p);
+    return true;
+  }
+
+  const auto numberOfContourPoints = m_CenterInputIndices.size();
+  double baseWeightSum = 0.0;
+  double baseDistance = 0.0;
+  double interpolatedResidual = 0.0;
+
+  m_CenterGrid->ForEachCenterWithin(p, m_SupportRadius, [&](std::size_t i, double d)
+  {
+    const auto phi = WendlandC2(d / m_SupportRadius);
+    interpolatedResidual += m_Weights[i] * phi;
+
+    if (i < numberOfContourPoints)
+    {
+      baseWeightSum += phi;
+      baseDistance += phi * this->EstimateLocalDistance(i, p);
+    }
+  });
+
+  if (baseWeightSum <= 0.0)
+    return false;
+
+  distance = baseDistance / baseWeightSum + interpolatedResidual;
+  return true;
+}
+
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p) const
 {
   double distanceValue(0);
   PointType p1;
   PointType p2;
   double norm;
 
-  CenterList::iterator centerIter;
+  CenterList::const_iterator centerIter;
 
   unsigned int count(0);
   for (centerIter = m_Centers.begin(); centerIter != m_Centers.end(); centerIter++)
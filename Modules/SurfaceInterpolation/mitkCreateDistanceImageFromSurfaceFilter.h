@@ -25,6 +25,8 @@ found in the LICENSE file.
 
 #include <Eigen/Dense>
 
+#include <memory>
+
 namespace mitk
 {
   /**
@@ -57,6 +59,25 @@ namespace mitk
          adjusted by calling SetDistanceImageVolume(unsigned int volume) which specifies the number ob pixels enclosed
   by the image.
 
+         Two solvers for the RBF interpolation are available (see SetRBFSolver()):
+         - DenseRBFSolver uses the globally supported basis function Phi(r) = r. It solves the dense equation system
+           by LU decomposition and sums over all centers for each evaluated pixel. Cost grows cubically with the
+           number of contour points.
+         - CompactRBFSolver uses the compactly supported Wendland function Phi(r) = (1-r/s)^4 (4r/s+1). A compactly
+           supported interpolant alone decays to zero away from the centers, so it is added to a base distance: the
+           partition of unity (weighted by Phi) of the signed distances to the tangents of the contour points. Beyond
+           the outermost contours these local distances close the surface with a rounded cap of half the gap to the
+           next contour. The RBF interpolates the residuals of the base at the centers. The support radius s is twice
+           the largest gap between neighboring contours, but at most the radius around a typical center that contains
+           SetMaximumNumberOfSupportNeighbors() centers. Thus the equation system stays sparse and is solved by sparse
+           Cholesky factorization. Contours farther apart than s are not bridged, but closed separately. Pixels are
+           evaluated using only the centers within the support. Pixels farther away than s from all centers are left
+           undetermined.
+
+         In both modes the values are on the scale of the distance to the surface. The distance function is only
+         evaluated in a narrow band around the zero level set, which is grown front by front from the contour points
+         and evaluated in parallel.
+
   \ingroup Process
 
   $Author: fetzer$
@@ -66,6 +87,12 @@ namespace mitk
   public:
     typedef vnl_vector_fixed<double, 3> PointType;
 
+    enum RBFSolverType
+    {
+      DenseRBFSolver,
+      CompactRBFSolver
+    };
+
     typedef itk::Image<double, 3> DistanceImageType;
     typedef DistanceImageType::IndexType IndexType;
 
@@ -99,6 +126,25 @@ namespace mitk
     */
     itkSetMacro(DistanceImageVolume, unsigned int);
 
+    /**
+    \brief Select the RBF solver, see class documentation. Default is DenseRBFSolver.
+    */
+    itkSetMacro(RBFSolver, RBFSolverType);
+    itkGetConstMacro(RBFSolver, RBFSolverType);
+
+    /**
+    \brief Upper bound of the number of centers within the support of a typical center for the CompactRBFSolver,
+           which bounds the number of nonzeros per row of the equation system. 0 means unbounded. Default is 200.
+    */
+    itkSetMacro(MaximumNumberOfSupportNeighbors, unsigned int);
+    itkGetConstMacro(MaximumNumberOfSupportNeighbors, unsigned int);
+
+    /**
+    \brief Support radius of the compactly supported basis function used in the last update
+           (0 for DenseRBFSolver).
+    */
+    itkGetConstMacro(SupportRadius, double);
+
     void PrintEquationSystem();
 
     // Resets the filter, i.e. removes all inputs and outputs
@@ -127,8 +173,24 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
+    /** Spatial hash of the centers, used by the CompactRBFSolver. */
+    class CenterGrid;
+
     void CreateSolutionMatrixAndFunctionValues();
-    double CalculateDistanceValue(PointType p);
+    void SolveCompactEquationSystem();
+    double CalculateDistanceValue(PointType p) const;
+
+    /**
+    \brief Local distance estimate of the contour point with index i at p, used for the base distance of the
+           CompactRBFSolver.
+    */
+    double EstimateLocalDistance(std::size_t i, const PointType &p) const;
+
+    /**
+    \brief Evaluates the interpolated distance function at p.
+    \return False if the value is undetermined, i.e. p is outside of the support of all centers.
+    */
+    bool EvaluateDistanceValue(const PointType &p, double &distance) const;
 
     void FillDistanceImage();
 
@@ -157,6 +219,12 @@ namespace mitk
     // Datastructures for the interpolation
     CenterList m_Centers;
     NormalList m_Normals;
+    std::vector<unsigned int> m_CenterInputIndices;
+
+    // Datastructures of the base distance of the CompactRBFSolver, per input and per contour point
+    std::vector<PointType> m_ContourPlaneNormals;
+    std::vector<unsigned char> m_OpenSides;
+    std::vector<double> m_CapRadii;
 
     Eigen::MatrixXd m_SolutionMatrix;
     Eigen::VectorXd m_FunctionValues;
@@ -171,6 +239,11 @@ namespace mitk
 
     bool m_UseProgressBar;
     unsigned int m_ProgressStepSize;
+
+    RBFSolverType m_RBFSolver;
+    unsigned int m_MaximumNumberOfSupportNeighbors;
+    double m_SupportRadius;
+    std::unique_ptr<CenterGrid> m_CenterGrid;
   };
 
 } // namespace
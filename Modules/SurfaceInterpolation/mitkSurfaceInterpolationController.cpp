@@ -380,6 +380,16 @@ void mitk::SurfaceInterpolationController::SetDistanceImageVolume(unsigned int d
   m_InterpolateSurfaceFilter->SetDistanceImageVolume(distImgVolume);
 }
 
+void mitk::SurfaceInterpolationController::SetRBFSolver(CreateDistanceImageFromSurfaceFilter::RBFSolverType solver)
+{
+  m_InterpolateSurfaceFilter->SetRBFSolver(solver);
+}
+
+mitk::CreateDistanceImageFromSurfaceFilter::RBFSolverType mitk::SurfaceInterpolationController::GetRBFSolver() const
+{
+  return m_InterpolateSurfaceFilter->GetRBFSolver();
+}
+
 mitk::Image::Pointer mitk::SurfaceInterpolationController::GetCurrentSegmentation()
 {
   return m_SelectedSegmentation;
@@ -140,6 +140,14 @@ namespace mitk
      */
     void SetDistanceImageVolume(unsigned int distImageVolume);
 
+    /**
+     * Selects the solver used for the radial basis function interpolation of the surface.
+     * CompactRBFSolver is considerably faster for many contour points, see CreateDistanceImageFromSurfaceFilter.
+     */
+    void SetRBFSolver(CreateDistanceImageFromSurfaceFilter::RBFSolverType solver);
+
+    CreateDistanceImageFromSurfaceFilter::RBFSolverType GetRBFSolver() const;
+
     /**
      * @brief Get the current selected segmentation for which the interpolation is performed
      * @return the current segmentation image
@@ -0,0 +1,372 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkUSImageRecorder.h"
+#include "mitkUSImageRecordingReader.h"
+#include "mitkUSImageRecordingFormat.h"
+#include "mitkUSImageLoggingFilter.h"
+#include "mitkUSImageSource.h"
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include <mitkIOUtil.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace mitk
+{
+  /** Delivers 2D frames with a gradient that moves with the frame number, like a video source. */
+  class SyntheticUSImageSource : public USImageSource
+  {
+  public:
+    mitkClassMacro(SyntheticUSImageSource, USImageSource);
+    itkFactorylessNewMacro(Self);
+
+    static unsigned char GetPixelValue(unsigned int x, unsigned int y, unsigned int frame)
+    {
+      return static_cast<unsigned char>((x + 2 * y + 3 * frame) % 256);
+    }
+
+  protected:
+    using USImageSource::GetNextRawImage;
+
+    void GetNextRawImage(std::vector<mitk::Image::Pointer> &images) override
+    {
+      unsigned int dimensions[2] = { 64, 48 };
+
+      auto image = mitk::Image::New();
+      image->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 2, dimensions);
+
+      mitk::Vector3D spacing;
+      mitk::FillVector3D(spacing, 0.3, 0.2, 1.0);
+      image->GetGeometry()->SetSpacing(spacing);
+
+      mitk::Point3D origin;
+      mitk::FillVector3D(origin, 10.0, 20.0, 0.0);
+      image->GetGeometry()->SetOrigin(origin);
+
+      {
+        mitk::ImagePixelWriteAccessor<unsigned char, 2> accessor(image);
+        itk::Index<2> index;
+
+        for (unsigned int y = 0; y < dimensions[1]; ++y)
+        {
+          for (unsigned int x = 0; x < dimensions[0]; ++x)
+          {
+            index[0] = x;
+            index[1] = y;
+            accessor.SetPixelByIndex(index, GetPixelValue(x, y, m_Frame));
+          }
+        }
+      }
+
+      ++m_Frame;
+      images = { image };
+    }
+
+  private:
+    unsigned int m_Frame = 0;
+  };
+}
+
+class mitkUSImageRecorderTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkUSImageRecorderTestSuite);
+  MITK_TEST(TestRecordAndRead);
+  MITK_TEST(TestUncompressedRecording);
+  MITK_TEST(TestImageSeries);
+  MITK_TEST(TestCompressionChangeDuringRecording);
+  MITK_TEST(TestRecordingWithoutIndex);
+  MITK_TEST(TestInvalidChunkSize);
+  MITK_TEST(TestIncompatibleFrame);
+  MITK_TEST(TestEmptyRecording);
+  MITK_TEST(TestInvalidPath);
+  MITK_TEST(TestLoggingFilterRecording);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static constexpr unsigned int NumberOfFrames = 30;
+
+  mitk::SyntheticUSImageSource::Pointer m_Source;
+  mitk::USImageRecorder::Pointer m_Recorder;
+  mitk::USImageRecordingReader::Pointer m_Reader;
+  std::string m_Filename;
+
+  static double GetTimestamp(unsigned int frame)
+  {
+    return 100.0 + 33.3 * frame;
+  }
+
+  void Record(unsigned int numberOfFrames)
+  {
+    m_Recorder->StartRecording(m_Filename);
+
+    for (unsigned int i = 0; i < numberOfFrames; ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Frame should be accepted", m_Recorder->AddFrame(m_Source->GetNextImage()[0], GetTimestamp(i)));
+
+      if (5 == i)
+        m_Recorder->AddMessage("needle visible");
+    }
+
+    m_Recorder->StopRecording();
+  }
+
+  void CheckFrame(mitk::Image *image, unsigned int frame)
+  {
+    CPPUNIT_ASSERT_MESSAGE("Frame should exist", image != nullptr);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong dimension", 2u, image->GetDimension());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong size", 64u, image->GetDimension(0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong size", 48u, image->GetDimension(1));
+    CPPUNIT_ASSERT_MESSAGE("Wrong pixel type", mitk::MakeScalarPixelType<unsigned char>() == image->GetPixelType());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Wrong spacing", 0.2, image->GetGeometry()->GetSpacing()[1], mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Wrong origin", 20.0, image->GetGeometry()->GetOrigin()[1], mitk::eps);
+
+    mitk::ImagePixelReadAccessor<unsigned char, 2> accessor(image);
+    itk::Index<2> index;
+
+    for (unsigned int y = 0; y < 48; ++y)
+    {
+      for (unsigned int x = 0; x < 64; ++x)
+      {
+        index[0] = x;
+        index[1] = y;
+
+        if (mitk::SyntheticUSImageSource::GetPixelValue(x, y, frame) != accessor.GetPixelByIndex(index))
+          CPPUNIT_FAIL("Wrong pixel value");
+      }
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Source = mitk::SyntheticUSImageSource::New();
+    m_Recorder = mitk::USImageRecorder::New();
+    m_Recorder->SetFramesPerChunk(4);
+    m_Recorder->SetNumberOfBufferedFrames(NumberOfFrames);
+    m_Reader = mitk::USImageRecordingReader::New();
+    m_Filename = mitk::IOUtil::CreateTemporaryFile("USImageRecorderTest_XXXXXX.usr");
+  }
+
+  void tearDown() override
+  {
+    m_Reader = nullptr;
+    m_Recorder = nullptr;
+    m_Source = nullptr;
+    std::remove(m_Filename.c_str());
+  }
+
+  void TestRecordAndRead()
+  {
+    this->Record(NumberOfFrames);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of recorded frames", std::size_t(NumberOfFrames), m_Recorder->GetNumberOfRecordedFrames());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Frames should not be dropped", std::size_t(0), m_Recorder->GetNumberOfDroppedFrames());
+
+    std::ifstream file(m_Filename, std::ios::binary | std::ios::ate);
+    CPPUNIT_ASSERT_MESSAGE("Recording should be compressed", static_cast<std::size_t>(file.tellg()) < NumberOfFrames * 64 * 48 / 2);
+
+    m_Reader->Open(m_Filename);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of frames", std::size_t(NumberOfFrames), m_Reader->GetNumberOfFrames());
+
+    for (unsigned int i = 0; i < NumberOfFrames; ++i)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Wrong timestamp", GetTimestamp(i), m_Reader->GetTimestamp(i), mitk::eps);
+
+    // Random access in both directions and across chunks
+    this->CheckFrame(m_Reader->GetFrame(17), 17);
+    this->CheckFrame(m_Reader->GetFrame(3), 3);
+    this->CheckFrame(m_Reader->GetFrame(29), 29);
+    this->CheckFrame(m_Reader->GetFrame(0), 0);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong message", std::string("needle visible"), m_Reader->GetFrameMessage(5));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Frame should have no message", std::string(), m_Reader->GetFrameMessage(6));
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong frame for timestamp", std::size_t(12), m_Reader->FindFrame(GetTimestamp(12) + 10.0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong frame for timestamp", std::size_t(0), m_Reader->FindFrame(0.0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong frame for timestamp", std::size_t(NumberOfFrames - 1), m_Reader->FindFrame(1.0e6));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE("Reading a frame that does not exist should throw",
+                                 m_Reader->GetFrame(NumberOfFrames),
+                                 mitk::Exception);
+  }
+
+  void TestUncompressedRecording()
+  {
+    m_Recorder->CompressionOff();
+    this->Record(NumberOfFrames);
+
+    std::ifstream file(m_Filename, std::ios::binary | std::ios::ate);
+    CPPUNIT_ASSERT_MESSAGE("Uncompressed recording should contain all pixels", static_cast<std::size_t>(file.tellg()) > NumberOfFrames * 64 * 48);
+
+    m_Reader->Open(m_Filename);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of frames", std::size_t(NumberOfFrames), m_Reader->GetNumberOfFrames());
+    this->CheckFrame(m_Reader->GetFrame(13), 13);
+  }
+
+  void TestImageSeries()
+  {
+    this->Record(NumberOfFrames);
+    m_Reader->Open(m_Filename);
+
+    auto series = m_Reader->GetImageSeries(10, 5);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong dimension", 4u, series->GetDimension());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of time steps", 5u, series->GetTimeSteps());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Wrong time bound", GetTimestamp(10), series->GetTimeGeometry()->GetMinimumTimePoint(0), mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Wrong time bound", GetTimestamp(13), series->GetTimeGeometry()->GetMinimumTimePoint(3), mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Wrong spacing", 0.3, series->GetGeometry(4)->GetSpacing()[0], mitk::eps);
+
+    mitk::ImagePixelReadAccessor<unsigned char, 4> accessor(series);
+    itk::Index<4> index;
+    index[0] = 7;
+    index[1] = 11;
+    index[2] = 0;
+
+    for (unsigned int t = 0; t < 5; ++t)
+    {
+      index[3] = t;
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong pixel value", mitk::SyntheticUSImageSource::GetPixelValue(7, 11, 10 + t), accessor.GetPixelByIndex(index));
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of time steps", NumberOfFrames, m_Reader->GetImageSeries()->GetTimeSteps());
+  }
+
+  void TestCompressionChangeDuringRecording()
+  {
+    m_Recorder->StartRecording(m_Filename);
+
+    for (unsigned int i = 0; i < NumberOfFrames; ++i)
+    {
+      // Changes apply to the next recording, the running one stays compressed
+      if (10 == i)
+        m_Recorder->CompressionOff();
+
+      CPPUNIT_ASSERT_MESSAGE("Frame should be accepted", m_Recorder->AddFrame(m_Source->GetNextImage()[0], GetTimestamp(i)));
+    }
+
+    m_Recorder->StopRecording();
+
+    std::ifstream file(m_Filename, std::ios::binary | std::ios::ate);
+    CPPUNIT_ASSERT_MESSAGE("Recording should be compressed", static_cast<std::size_t>(file.tellg()) < NumberOfFrames * 64 * 48 / 2);
+
+    m_Reader->Open(m_Filename);
+    this->CheckFrame(m_Reader->GetFrame(25), 25);
+  }
+
+  void TestRecordingWithoutIndex()
+  {
+    this->Record(NumberOfFrames);
+
+    // Cut off the trailer, like for a recording that was not stopped
+    std::string content;
+    {
+      std::ifstream file(m_Filename, std::ios::binary);
+      content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+      std::ofstream file(m_Filename, std::ios::binary | std::ios::trunc);
+      file.write(content.data(), content.size() - 16);
+    }
+
+    m_Reader->Open(m_Filename);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Frames should be recovered from the chunks", std::size_t(NumberOfFrames), m_Reader->GetNumberOfFrames());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Wrong timestamp", GetTimestamp(21), m_Reader->GetTimestamp(21), mitk::eps);
+    this->CheckFrame(m_Reader->GetFrame(21), 21);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Messages are only stored with the index", std::string(), m_Reader->GetFrameMessage(5));
+  }
+
+  void TestInvalidChunkSize()
+  {
+    this->Record(NumberOfFrames);
+
+    // Let the first chunk claim more data than the file contains
+    {
+      std::fstream file(m_Filename, std::ios::binary | std::ios::in | std::ios::out);
+      const std::uint64_t storedSize = std::uint64_t(1) << 62;
+      file.seekp(sizeof(mitk::USImageRecordingFormat::FileHeader) + offsetof(mitk::USImageRecordingFormat::ChunkHeader, StoredSize));
+      file.write(reinterpret_cast<const char *>(&storedSize), sizeof(storedSize));
+    }
+
+    m_Reader->Open(m_Filename);
+    CPPUNIT_ASSERT_THROW_MESSAGE("Reading a chunk that exceeds the recording should throw",
+                                 m_Reader->GetFrame(0),
+                                 mitk::Exception);
+    this->CheckFrame(m_Reader->GetFrame(NumberOfFrames - 1), NumberOfFrames - 1);
+  }
+
+  void TestIncompatibleFrame()
+  {
+    m_Recorder->StartRecording(m_Filename);
+    CPPUNIT_ASSERT_MESSAGE("Frame should be accepted", m_Recorder->AddFrame(m_Source->GetNextImage()[0], GetTimestamp(0)));
+
+    unsigned int dimensions[2] = { 32, 32 };
+    auto otherImage = mitk::Image::New();
+    otherImage->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 2, dimensions);
+
+    CPPUNIT_ASSERT_MESSAGE("Frame of another size should be dropped", !m_Recorder->AddFrame(otherImage, GetTimestamp(1)));
+    CPPUNIT_ASSERT_MESSAGE("Frame should be accepted", m_Recorder->AddFrame(m_Source->GetNextImage()[0], GetTimestamp(2)));
+    m_Recorder->StopRecording();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of dropped frames", std::size_t(1), m_Recorder->GetNumberOfDroppedFrames());
+    CPPUNIT_ASSERT_MESSAGE("Frame after stopping should be dropped", !m_Recorder->AddFrame(m_Source->GetNextImage()[0], GetTimestamp(3)));
+
+    m_Reader->Open(m_Filename);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of frames", std::size_t(2), m_Reader->GetNumberOfFrames());
+    this->CheckFrame(m_Reader->GetFrame(1), 1);
+  }
+
+  void TestEmptyRecording()
+  {
+    this->Record(0);
+
+    m_Reader->Open(m_Filename);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Recording should be empty", std::size_t(0), m_Reader->GetNumberOfFrames());
+  }
+
+  void TestInvalidPath()
+  {
+    CPPUNIT_ASSERT_THROW_MESSAGE("Recording to an invalid path should throw",
+                                 m_Recorder->StartRecording(m_Filename + "/invalid/recording.usr"),
+                                 mitk::Exception);
+    CPPUNIT_ASSERT_THROW_MESSAGE("Reading a file that is not a recording should throw",
+                                 m_Reader->Open(m_Filename),
+                                 mitk::Exception);
+  }
+
+  void TestLoggingFilterRecording()
+  {
+    auto filter = mitk::USImageLoggingFilter::New();
+    filter->StartRecording(m_Filename);
+
+    for (int i = 0; i < 5; ++i)
+    {
+      filter->SetInput(m_Source->GetNextImage()[0]);
+      filter->Update();
+    }
+
+    filter->AddMessageToCurrentImage("last frame");
+    filter->StopRecording();
+
+    m_Reader->Open(m_Filename);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong number of frames", std::size_t(5), m_Reader->GetNumberOfFrames());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Wrong message", std::string("last frame"), m_Reader->GetFrameMessage(4));
+    CPPUNIT_ASSERT_MESSAGE("Timestamps should increase", m_Reader->GetTimestamp(4) >= m_Reader->GetTimestamp(0));
+    this->CheckFrame(m_Reader->GetFrame(2), 2);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkUSImageRecorder)
@@ -22,7 +22,8 @@ found in the LICENSE file.
 
 
 mitk::USImageLoggingFilter::USImageLoggingFilter() : m_SystemTimeClock(RealTimeClock::New()),
-                                                     m_ImageExtension(".nrrd")
+                                                     m_ImageExtension(".nrrd"),
+                                                     m_Recorder(USImageRecorder::New())
 {
 }
 
@@ -41,6 +42,13 @@ void mitk::USImageLoggingFilter::GenerateData()
     return;
     }
 
+  //while recording, the image is copied to the ring buffer of the recorder instead of being cloned
+  if (m_Recorder->IsRecording())
+    {
+    m_Recorder->AddFrame(inputImage, m_SystemTimeClock->GetCurrentStamp());
+    return;
+    }
+
   //a clone is needed for a output and to store it.
   mitk::Image::Pointer inputClone = inputImage->Clone();
 
@@ -79,6 +87,12 @@ void mitk::USImageLoggingFilter::GenerateData()
 
 void mitk::USImageLoggingFilter::AddMessageToCurrentImage(std::string message)
 {
+  if (m_Recorder->IsRecording())
+    {
+    m_Recorder->AddMessage(message);
+    return;
+    }
+
   m_LoggedMessages.insert(std::make_pair(static_cast<int>(m_LoggedImages.size()-1),message));
 }
 
@@ -159,3 +173,13 @@ bool mitk::USImageLoggingFilter::SetImageFilesExtension(std::string extension)
   }
   return false;
  }
+
+void mitk::USImageLoggingFilter::StartRecording(const std::string& filename)
+{
+  m_Recorder->StartRecording(filename);
+}
+
+void mitk::USImageLoggingFilter::StopRecording()
+{
+  m_Recorder->StopRecording();
+}
@@ -17,6 +17,7 @@ found in the LICENSE file.
 #include <MitkUSExports.h>
 #include <mitkImageToImageFilter.h>
 #include <mitkRealTimeClock.h>
+#include "mitkUSImageRecorder.h"
 
 
 namespace mitk {
@@ -25,6 +26,9 @@ namespace mitk {
    *  add messages. All data (images, timestamps and messages) is written to the harddisc when
    *  the method SaveImages(...) is called.
    *
+   *  For long acquisitions, StartRecording(...) streams the images into a single recording file instead
+   *  (see mitk::USImageRecorder), so memory usage does not grow with the number of images.
+   *
    *  Caution: only supports logging of one input at the moment, multiple inputs are ignored!
    *
    *  \ingroup US
@@ -72,6 +76,21 @@ namespace mitk {
      */
     bool SetImageFilesExtension(std::string extension);
 
+    /** Streams all images of subsequent Update() calls into the given recording file instead of keeping
+     *  clones in memory. Messages are stored in the recording, too. Images logged before are kept for
+     *  SaveImages(...). The recording can be read by mitk::USImageRecordingReader.
+     *  @throw mitk::Exception Throws an exception if the recording file cannot be created.
+     */
+    void StartRecording(const std::string& filename);
+
+    /** Writes the remaining images of the recording and closes the recording file.
+     *  @throw mitk::Exception Throws an exception if the recording could not be written completely.
+     */
+    void StopRecording();
+
+    /** Recorder used by StartRecording(...), e.g. to set the size of its ring buffer or the compression. */
+    itkGetObjectMacro(Recorder, USImageRecorder);
+
 
   protected:
     USImageLoggingFilter();
@@ -84,6 +103,7 @@ namespace mitk {
     std::map<int, std::string> m_LoggedMessages; ///< (Optional) messages for every logged image
     std::vector<double> m_LoggedMITKSystemTimes; ///< Logged system times for every logged image
     std::string m_ImageExtension; ///< stores the image extension, default is ".nrrd"
+    USImageRecorder::Pointer m_Recorder; ///< streams the images to a file while recording
 
   };
 } // namespace mitk
@@ -0,0 +1,404 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkUSImageRecorder.h"
+
+#include <mitkExceptionMacro.h>
+#include <mitkImageReadAccessor.h>
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+  template <typename T>
+  void WriteValue(std::ostream &stream, const T &value)
+  {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+}
+
+mitk::USImageRecorder::USImageRecorder()
+  : m_NumberOfBufferedFrames(64),
+    m_FramesPerChunk(16),
+    m_Compression(true),
+    m_RecordingFramesPerChunk(1),
+    m_RecordingCompression(true),
+    m_IsRecording(false),
+    m_IsInitialized(false),
+    m_Header(CreateHeader(nullptr)),
+    m_FrameSize(0),
+    m_First(0),
+    m_Count(0),
+    m_NumberOfFramesInFlight(0),
+    m_StopRequested(false),
+    m_NumberOfRecordedFrames(0),
+    m_NumberOfDroppedFrames(0)
+{
+}
+
+mitk::USImageRecorder::~USImageRecorder()
+{
+  try
+  {
+    this->StopRecording();
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_ERROR << e.GetDescription();
+  }
+}
+
+void mitk::USImageRecorder::StartRecording(const std::string &filename)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (m_IsRecording)
+    mitkThrow() << "Cannot start recording to " << filename << ", a recording is already running.";
+
+  m_File.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+  if (!m_File.is_open())
+    mitkThrow() << "Cannot create recording file " << filename << ".";
+
+  // The ring buffer is allocated for the first frame, when the frame size is known
+  m_IsInitialized = false;
+  m_Error.clear();
+  m_PixelType = nullptr;
+  m_Header = CreateHeader(nullptr);
+  m_FrameSize = 0;
+  m_RingBuffer.clear();
+  m_RingTimestamps.assign(std::max(1u, m_NumberOfBufferedFrames), 0.0);
+  m_RecordingFramesPerChunk = std::max<std::size_t>(1, std::min<std::size_t>(m_FramesPerChunk, m_RingTimestamps.size()));
+  m_RecordingCompression = m_Compression;
+  m_First = 0;
+  m_Count = 0;
+  m_NumberOfFramesInFlight = 0;
+  m_StopRequested = false;
+  m_NumberOfRecordedFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_Index.clear();
+  m_Messages.clear();
+
+  m_IsRecording = true;
+  m_Writer = std::thread(&USImageRecorder::WriterThread, this);
+}
+
+void mitk::USImageRecorder::StopRecording()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    if (!m_IsRecording)
+      return;
+
+    // No new frames are accepted, but frames that are being copied into the ring buffer are still written
+    m_IsRecording = false;
+    m_FramesAvailable.wait(lock, [this] { return 0 == m_NumberOfFramesInFlight; });
+    m_StopRequested = true;
+  }
+
+  m_FramesAvailable.notify_all();
+  m_Writer.join();
+
+  if (m_Error.empty())
+  {
+    if (!m_IsInitialized)
+      WriteValue(m_File, m_Header);
+
+    this->WriteIndex();
+  }
+
+  m_File.close();
+
+  if (m_Error.empty() && m_File.fail())
+    m_Error = "Cannot write the index of the recording.";
+
+  m_RingBuffer = std::vector<char>();
+
+  if (!m_Error.empty())
+    mitkThrow() << m_Error;
+}
+
+bool mitk::USImageRecorder::IsRecording() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_IsRecording;
+}
+
+mitk::USImageRecordingFormat::FileHeader mitk::USImageRecorder::CreateHeader(const Image *image)
+{
+  USImageRecordingFormat::FileHeader header = {};
+  std::copy(std::begin(USImageRecordingFormat::FileMagic), std::end(USImageRecordingFormat::FileMagic), header.Magic);
+  header.Version = USImageRecordingFormat::Version;
+
+  if (nullptr == image)
+    return header;
+
+  const auto pixelType = image->GetPixelType();
+  header.ComponentType = static_cast<std::uint32_t>(pixelType.GetComponentType());
+  header.PixelType = static_cast<std::uint32_t>(pixelType.GetPixelType());
+  header.NumberOfComponents = static_cast<std::uint32_t>(pixelType.GetNumberOfComponents());
+  header.BytesPerPixel = static_cast<std::uint32_t>(pixelType.GetSize());
+  header.Dimension = std::min(image->GetDimension(), 3u);
+
+  for (unsigned int i = 0; i < 3; ++i)
+    header.Dimensions[i] = i < header.Dimension ? image->GetDimension(i) : 1;
+
+  const auto *transform = image->GetGeometry()->GetIndexToWorldTransform();
+  const auto &matrix = transform->GetMatrix();
+  const auto &offset = transform->GetOffset();
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    for (unsigned int j = 0; j < 3; ++j)
+      header.Matrix[3 * i + j] = matrix[i][j];
+
+    header.Offset[i] = offset[i];
+  }
+
+  return header;
+}
+
+void mitk::USImageRecorder::InitializeRecording(const Image *image)
+{
+  m_PixelType = std::make_unique<PixelType>(image->GetPixelType());
+  m_Header = CreateHeader(image);
+  m_FrameSize = std::size_t(m_Header.BytesPerPixel) * m_Header.Dimensions[0] * m_Header.Dimensions[1] * m_Header.Dimensions[2];
+  m_RingBuffer.resize(m_RingTimestamps.size() * m_FrameSize);
+
+  WriteValue(m_File, m_Header);
+  m_IsInitialized = true;
+}
+
+bool mitk::USImageRecorder::IsCompatibleFrame(const Image *image) const
+{
+  if (image->GetPixelType() != *m_PixelType)
+    return false;
+
+  const auto header = CreateHeader(image);
+
+  if (header.Dimension != m_Header.Dimension || !std::equal(header.Dimensions, header.Dimensions + 3, m_Header.Dimensions))
+    return false;
+
+  auto isEqual = [](double a, double b) { return std::abs(a - b) < mitk::eps; };
+
+  return std::equal(header.Matrix, header.Matrix + 9, m_Header.Matrix, isEqual) &&
+         std::equal(header.Offset, header.Offset + 3, m_Header.Offset, isEqual);
+}
+
+bool mitk::USImageRecorder::AddFrame(const Image *image, double timestamp)
+{
+  if (nullptr == image || !image->IsInitialized())
+    return false;
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  if (!m_IsRecording)
+    return false;
+
+  if (!m_IsInitialized)
+  {
+    this->InitializeRecording(image);
+  }
+  else if (!this->IsCompatibleFrame(image))
+  {
+    MITK_WARN << "Frame does not match the pixel type, size or geometry of the recording. Frame is dropped.";
+    ++m_NumberOfDroppedFrames;
+    return false;
+  }
+
+  if (m_Count + m_NumberOfFramesInFlight == m_RingTimestamps.size())
+  {
+    ++m_NumberOfDroppedFrames;
+    return false;
+  }
+
+  // The writer does not touch slots behind the buffered frames, so the pixel data is copied without lock.
+  // The slot stays the same if the writer releases frames in the meantime. The frame is in flight until it
+  // is buffered, StopRecording() and the writer wait for it, so the ring buffer is not released meanwhile.
+  const auto slot = (m_First + m_Count + m_NumberOfFramesInFlight) % m_RingTimestamps.size();
+  ++m_NumberOfFramesInFlight;
+  lock.unlock();
+
+  try
+  {
+    ImageReadAccessor accessor(image, image->GetVolumeData(0));
+    std::memcpy(m_RingBuffer.data() + slot * m_FrameSize, accessor.GetData(), m_FrameSize);
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_WARN << "Cannot access frame: " << e.GetDescription() << " Frame is dropped.";
+    lock.lock();
+    --m_NumberOfFramesInFlight;
+    ++m_NumberOfDroppedFrames;
+    m_FramesAvailable.notify_all();
+    return false;
+  }
+
+  lock.lock();
+  m_RingTimestamps[slot] = timestamp;
+  --m_NumberOfFramesInFlight;
+  ++m_Count;
+  ++m_NumberOfRecordedFrames;
+
+  // StopRecording() and the writer may both wait for the frame
+  m_FramesAvailable.notify_all();
+  return true;
+}
+
+void mitk::USImageRecorder::AddMessage(const std::string &message)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (!m_IsRecording)
+  {
+    MITK_WARN << "No recording is running. Message is ignored.";
+    return;
+  }
+
+  if (0 == m_NumberOfRecordedFrames)
+  {
+    MITK_WARN << "No frame was recorded yet. Message is ignored.";
+    return;
+  }
+
+  m_Messages.insert(std::make_pair(m_NumberOfRecordedFrames - 1, message));
+}
+
+std::size_t mitk::USImageRecorder::GetNumberOfRecordedFrames() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfRecordedFrames;
+}
+
+std::size_t mitk::USImageRecorder::GetNumberOfDroppedFrames() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfDroppedFrames;
+}
+
+void mitk::USImageRecorder::WriterThread()
+{
+  const std::size_t ringSize = m_RingTimestamps.size();
+  const std::size_t framesPerChunk = m_RecordingFramesPerChunk;
+
+  std::vector<char> chunk;
+  std::vector<double> timestamps;
+
+  while (true)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_FramesAvailable.wait(lock, [&] {
+      return m_Count >= framesPerChunk || (m_StopRequested && (0 < m_Count || 0 == m_NumberOfFramesInFlight));
+    });
+
+    // Exit only when all frames are written, including frames that were in flight when the stop was requested
+    if (0 == m_Count)
+      return;
+
+    // Buffered frames are only modified by the producer after they were released, so copy them without lock
+    const auto numberOfFrames = std::min(m_Count, framesPerChunk);
+    const auto first = m_First;
+    lock.unlock();
+
+    chunk.resize(numberOfFrames * m_FrameSize);
+    timestamps.resize(numberOfFrames);
+
+    for (std::size_t i = 0; i < numberOfFrames; ++i)
+    {
+      const auto slot = (first + i) % ringSize;
+      std::memcpy(chunk.data() + i * m_FrameSize, m_RingBuffer.data() + slot * m_FrameSize, m_FrameSize);
+      timestamps[i] = m_RingTimestamps[slot];
+    }
+
+    lock.lock();
+    m_First = (m_First + numberOfFrames) % ringSize;
+    m_Count -= numberOfFrames;
+    lock.unlock();
+
+    // After an error, frames are still consumed so that the producer is not blocked
+    if (m_Error.empty())
+      this->WriteChunk(chunk.data(), timestamps);
+  }
+}
+
+void mitk::USImageRecorder::WriteChunk(const char *data, const std::vector<double> &timestamps)
+{
+  const auto size = timestamps.size() * m_FrameSize;
+
+  USImageRecordingFormat::ChunkHeader header = {};
+  header.Marker = USImageRecordingFormat::ChunkMarker;
+  header.NumberOfFrames = static_cast<std::uint32_t>(timestamps.size());
+  header.Codec = static_cast<std::uint32_t>(USImageRecordingFormat::ChunkCodec::Raw);
+  header.StoredSize = size;
+
+  // Chunks that do not get smaller (e.g. noise) are stored raw
+  if (m_RecordingCompression && size <= static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE))
+  {
+    m_CompressedChunk.resize(LZ4_compressBound(static_cast<int>(size)));
+
+    const auto compressedSize = LZ4_compress_default(data, m_CompressedChunk.data(), static_cast<int>(size), static_cast<int>(m_CompressedChunk.size()));
+
+    if (0 < compressedSize && static_cast<std::size_t>(compressedSize) < size)
+    {
+      header.Codec = static_cast<std::uint32_t>(USImageRecordingFormat::ChunkCodec::LZ4);
+      header.StoredSize = static_cast<std::uint64_t>(compressedSize);
+      data = m_CompressedChunk.data();
+    }
+  }
+
+  const auto offset = static_cast<std::uint64_t>(m_File.tellp());
+
+  WriteValue(m_File, header);
+  m_File.write(reinterpret_cast<const char *>(timestamps.data()), timestamps.size() * sizeof(double));
+  m_File.write(data, header.StoredSize);
+
+  if (m_File.fail())
+  {
+    m_Error = "Cannot write frames to the recording file.";
+    return;
+  }
+
+  for (std::size_t i = 0; i < timestamps.size(); ++i)
+    m_Index.push_back({ timestamps[i], offset, static_cast<std::uint32_t>(i) });
+}
+
+void mitk::USImageRecorder::WriteIndex()
+{
+  const auto indexOffset = static_cast<std::uint64_t>(m_File.tellp());
+
+  WriteValue(m_File, USImageRecordingFormat::IndexMarker);
+  WriteValue(m_File, static_cast<std::uint64_t>(m_Index.size()));
+
+  for (const auto &entry : m_Index)
+  {
+    WriteValue(m_File, entry.Timestamp);
+    WriteValue(m_File, entry.ChunkOffset);
+    WriteValue(m_File, entry.FrameInChunk);
+  }
+
+  WriteValue(m_File, static_cast<std::uint64_t>(m_Messages.size()));
+
+  for (const auto &message : m_Messages)
+  {
+    WriteValue(m_File, message.first);
+    WriteValue(m_File, static_cast<std::uint64_t>(message.second.size()));
+    m_File.write(message.second.data(), message.second.size());
+  }
+
+  WriteValue(m_File, indexOffset);
+  m_File.write(USImageRecordingFormat::TrailerMagic, sizeof(USImageRecordingFormat::TrailerMagic));
+}
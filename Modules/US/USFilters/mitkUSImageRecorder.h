@@ -0,0 +1,156 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkUSImageRecorder_h
+#define mitkUSImageRecorder_h
+
+#include <MitkUSExports.h>
+#include <mitkImage.h>
+#include "mitkUSImageRecordingFormat.h"
+
+#include <itkObject.h>
+
+#include <array>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mitk
+{
+  /** \brief Streams ultrasound frames into a single chunked recording file.
+   *
+   * AddFrame() copies the pixel data of a frame into a ring buffer that is allocated once for the
+   * first frame. A background thread collects the buffered frames into chunks, compresses them with
+   * LZ4 (optional) and appends them to the recording file. The timestamps of all frames and the
+   * messages are written as index when the recording is stopped. The memory needed for a recording
+   * is therefore bounded by the ring buffer, independent of the length of the recording.
+   *
+   * If the writer cannot keep up and the ring buffer is full, frames are dropped instead of blocking
+   * the caller (see GetNumberOfDroppedFrames()).
+   *
+   * All frames of a recording must have the pixel type, size and geometry of the first frame, other
+   * frames are dropped. Only the first time step of a frame is recorded. AddFrame() must be called from
+   * a single thread. StartRecording(), StopRecording() and AddMessage() may be called from other threads;
+   * StopRecording() waits for a frame that is being added.
+   *
+   * Recordings are read by mitk::USImageRecordingReader.
+   *
+   * \ingroup US
+   */
+  class MITKUS_EXPORT USImageRecorder : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(USImageRecorder, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** Number of frames the ring buffer can hold (default 64). Changes apply to the next recording. */
+    itkSetMacro(NumberOfBufferedFrames, unsigned int);
+    itkGetConstMacro(NumberOfBufferedFrames, unsigned int);
+
+    /** Number of frames that are compressed and written together (default 16). Changes apply to the next recording. */
+    itkSetMacro(FramesPerChunk, unsigned int);
+    itkGetConstMacro(FramesPerChunk, unsigned int);
+
+    /** LZ4 compression of the chunks (default on). Changes apply to the next recording. */
+    itkSetMacro(Compression, bool);
+    itkGetConstMacro(Compression, bool);
+    itkBooleanMacro(Compression);
+
+    /** \brief Creates the recording file and starts the writer.
+     *  \exception mitk::Exception if a recording is running or if the file cannot be created.
+     */
+    void StartRecording(const std::string &filename);
+
+    /** \brief Writes all buffered frames and the index and closes the recording file.
+     *  \exception mitk::Exception if the recording could not be written completely.
+     */
+    void StopRecording();
+
+    bool IsRecording() const;
+
+    /** \brief Copies the frame into the ring buffer.
+     *  \param timestamp Time of the frame in ms, e.g. of a mitk::RealTimeClock.
+     *  \return false if the frame was dropped (no recording, full ring buffer or incompatible frame).
+     */
+    bool AddFrame(const Image *image, double timestamp);
+
+    /** \brief Attaches a message to the last recorded frame. Ignored if no recording is running. */
+    void AddMessage(const std::string &message);
+
+    /** Number of frames accepted by AddFrame() in the current or last recording. */
+    std::size_t GetNumberOfRecordedFrames() const;
+
+    /** Number of frames dropped by AddFrame() in the current or last recording. */
+    std::size_t GetNumberOfDroppedFrames() const;
+
+  protected:
+    USImageRecorder();
+    ~USImageRecorder() override;
+
+  private:
+    /** Prepares the header and the ring buffer for frames like the given image. */
+    void InitializeRecording(const Image *image);
+    bool IsCompatibleFrame(const Image *image) const;
+    static USImageRecordingFormat::FileHeader CreateHeader(const Image *image);
+
+    void WriterThread();
+    void WriteChunk(const char *data, const std::vector<double> &timestamps);
+    void WriteIndex();
+
+    unsigned int m_NumberOfBufferedFrames;
+    unsigned int m_FramesPerChunk;
+    bool m_Compression;
+
+    /** Settings of the running recording, taken over by StartRecording() and only read by the writer. */
+    std::size_t m_RecordingFramesPerChunk;
+    bool m_RecordingCompression;
+
+    std::ofstream m_File;
+    std::thread m_Writer;
+    bool m_IsRecording;
+    bool m_IsInitialized;
+    std::string m_Error;
+
+    std::unique_ptr<PixelType> m_PixelType;
+    USImageRecordingFormat::FileHeader m_Header;
+    std::size_t m_FrameSize;
+
+    /** Ring buffer of m_NumberOfBufferedFrames frames. Frames [m_First, m_First + m_Count) are buffered. */
+    std::vector<char> m_RingBuffer;
+    std::vector<double> m_RingTimestamps;
+    std::size_t m_First;
+    std::size_t m_Count;
+    /** Frames whose slots are reserved by AddFrame() but whose pixel data is still copied without lock. */
+    std::size_t m_NumberOfFramesInFlight;
+    bool m_StopRequested;
+
+    /** Guards the recording state, the ring buffer positions, the counters and m_Messages. */
+    mutable std::mutex m_Mutex;
+    /** Signals buffered frames to the writer and finished frames in flight to StopRecording(). */
+    std::condition_variable m_FramesAvailable;
+
+    std::size_t m_NumberOfRecordedFrames;
+    std::size_t m_NumberOfDroppedFrames;
+
+    /** Only accessed by the writer thread while recording. */
+    std::vector<USImageRecordingFormat::FrameIndexEntry> m_Index;
+    std::vector<char> m_CompressedChunk;
+    /** Messages by frame, modified under m_Mutex while recording. */
+    std::map<std::uint64_t, std::string> m_Messages;
+  };
+}
+
+#endif
@@ -0,0 +1,91 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkUSImageRecordingFormat_h
+#define mitkUSImageRecordingFormat_h
+
+#include <cstdint>
+
+namespace mitk
+{
+  /** \brief Layout of the files written by USImageRecorder and read by USImageRecordingReader.
+   *
+   * All values are stored in the byte order of the recording machine.
+   *
+   * \code
+   * FileHeader
+   * Chunk header, timestamps of the frames of the chunk (double), frame data (raw or LZ4 block)
+   * ...
+   * Index marker, number of frames, per frame: timestamp (double), chunk offset (uint64), frame in chunk (uint32)
+   * Number of messages, per message: frame (uint64), length (uint64), characters
+   * Offset of the index marker (uint64), TrailerMagic
+   * \endcode
+   *
+   * The index is only written when the recording is stopped. Without index, the frames are found by
+   * walking the chunk headers, which also recovers recordings that were interrupted. The messages are
+   * only stored with the index, so they are lost for such recordings.
+   *
+   * \ingroup US
+   */
+  namespace USImageRecordingFormat
+  {
+    constexpr char FileMagic[8] = { 'M', 'I', 'T', 'K', 'U', 'S', 'R', 'C' };
+    constexpr char TrailerMagic[8] = { 'M', 'I', 'T', 'K', 'U', 'S', 'I', 'X' };
+    constexpr std::uint32_t Version = 1;
+    constexpr std::uint32_t ChunkMarker = 0x4B4E4843; // "CHNK"
+    constexpr std::uint32_t IndexMarker = 0x58444E49; // "INDX"
+
+    enum class ChunkCodec : std::uint32_t
+    {
+      Raw = 0,
+      LZ4 = 1
+    };
+
+    struct FileHeader
+    {
+      char Magic[8];
+      std::uint32_t Version;
+      /** itk::IOComponentEnum and itk::IOPixelEnum of the frames. */
+      std::uint32_t ComponentType;
+      std::uint32_t PixelType;
+      std::uint32_t NumberOfComponents;
+      std::uint32_t BytesPerPixel;
+      /** Dimension (2 or 3) and size of the frames. */
+      std::uint32_t Dimension;
+      std::uint32_t Dimensions[3];
+      std::uint32_t Reserved;
+      /** Index to world transform of the frames. */
+      double Matrix[9];
+      double Offset[3];
+    };
+
+    struct ChunkHeader
+    {
+      std::uint32_t Marker;
+      std::uint32_t NumberOfFrames;
+      std::uint32_t Codec;
+      std::uint32_t Reserved;
+      /** Number of bytes of the frame data as stored in the file. */
+      std::uint64_t StoredSize;
+    };
+
+    struct FrameIndexEntry
+    {
+      double Timestamp;
+      /** Position of the header of the chunk that contains the frame. */
+      std::uint64_t ChunkOffset;
+      std::uint32_t FrameInChunk;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,428 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkUSImageRecordingReader.h"
+
+#include <mitkArbitraryTimeGeometry.h>
+#include <mitkExceptionMacro.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <itkRawImageIO.h>
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+  template <typename T>
+  bool ReadValue(std::istream &stream, T &value)
+  {
+    return static_cast<bool>(stream.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+}
+
+mitk::USImageRecordingReader::USImageRecordingReader()
+  : m_FileSize(0),
+    m_Header(),
+    m_FrameSize(0),
+    m_ChunkOffset(NoChunk)
+{
+}
+
+mitk::USImageRecordingReader::~USImageRecordingReader()
+{
+}
+
+void mitk::USImageRecordingReader::Open(const std::string &filename)
+{
+  this->Close();
+
+  m_File.open(filename, std::ios::in | std::ios::binary);
+
+  if (!m_File.is_open())
+    mitkThrow() << "Cannot open recording " << filename << ".";
+
+  m_File.seekg(0, std::ios::end);
+  m_FileSize = static_cast<std::uint64_t>(m_File.tellg());
+  m_File.seekg(0, std::ios::beg);
+
+  if (!ReadValue(m_File, m_Header) ||
+      !std::equal(std::begin(USImageRecordingFormat::FileMagic), std::end(USImageRecordingFormat::FileMagic), m_Header.Magic))
+  {
+    this->Close();
+    mitkThrow() << filename << " is not an ultrasound recording.";
+  }
+
+  if (USImageRecordingFormat::Version != m_Header.Version)
+  {
+    const auto version = m_Header.Version;
+    this->Close();
+    mitkThrow() << "Version " << version << " of recording " << filename << " is not supported.";
+  }
+
+  if (0 != m_Header.Dimension)
+  {
+    // The pixel type is restored from the ITK pixel and component type, like for images read by ITK
+    auto imageIO = itk::RawImageIO<unsigned char, 2>::New();
+    imageIO->SetComponentType(static_cast<itk::IOComponentEnum>(m_Header.ComponentType));
+    imageIO->SetPixelType(static_cast<itk::IOPixelEnum>(m_Header.PixelType));
+    imageIO->SetNumberOfComponents(m_Header.NumberOfComponents);
+    m_PixelType = std::make_unique<PixelType>(MakePixelType(imageIO));
+
+    if (m_PixelType->GetSize() != m_Header.BytesPerPixel || 3 < m_Header.Dimension)
+    {
+      this->Close();
+      mitkThrow() << "Recording " << filename << " has an invalid frame layout.";
+    }
+
+    m_FrameSize = std::size_t(m_Header.BytesPerPixel) * m_Header.Dimensions[0] * m_Header.Dimensions[1] * m_Header.Dimensions[2];
+  }
+
+  if (!this->ReadIndex())
+  {
+    MITK_WARN << "Recording " << filename << " has no valid index, it was probably not stopped properly. Frames are indexed from the chunks, messages are lost.";
+    this->RebuildIndex();
+  }
+}
+
+void mitk::USImageRecordingReader::Close()
+{
+  m_File.close();
+  m_File.clear();
+  m_FileSize = 0;
+  m_Header = USImageRecordingFormat::FileHeader();
+  m_PixelType = nullptr;
+  m_FrameSize = 0;
+  m_Index.clear();
+  m_Messages.clear();
+  m_ChunkOffset = NoChunk;
+  m_Chunk = std::vector<char>();
+  m_CompressedChunk = std::vector<char>();
+}
+
+bool mitk::USImageRecordingReader::ReadIndex()
+{
+  const std::uint64_t trailerSize = sizeof(std::uint64_t) + sizeof(USImageRecordingFormat::TrailerMagic);
+
+  if (m_FileSize < sizeof(USImageRecordingFormat::FileHeader) + trailerSize)
+    return false;
+
+  std::uint64_t indexOffset = 0;
+  char magic[sizeof(USImageRecordingFormat::TrailerMagic)];
+
+  m_File.seekg(m_FileSize - trailerSize, std::ios::beg);
+
+  if (!ReadValue(m_File, indexOffset) || !m_File.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), USImageRecordingFormat::TrailerMagic) ||
+      indexOffset > m_FileSize - trailerSize)
+  {
+    m_File.clear();
+    return false;
+  }
+
+  m_File.seekg(indexOffset, std::ios::beg);
+
+  std::uint32_t marker = 0;
+  std::uint64_t numberOfFrames = 0;
+
+  // Each index entry needs 20 bytes, which also bounds corrupt frame counts
+  if (!ReadValue(m_File, marker) || USImageRecordingFormat::IndexMarker != marker ||
+      !ReadValue(m_File, numberOfFrames) || numberOfFrames > (m_FileSize - indexOffset) / 20 ||
+      (0 != numberOfFrames && 0 == m_Header.Dimension))
+  {
+    m_File.clear();
+    return false;
+  }
+
+  std::vector<USImageRecordingFormat::FrameIndexEntry> index(numberOfFrames);
+
+  for (auto &entry : index)
+  {
+    if (!ReadValue(m_File, entry.Timestamp) || !ReadValue(m_File, entry.ChunkOffset) || !ReadValue(m_File, entry.FrameInChunk))
+    {
+      m_File.clear();
+      return false;
+    }
+  }
+
+  std::uint64_t numberOfMessages = 0;
+
+  if (!ReadValue(m_File, numberOfMessages))
+  {
+    m_File.clear();
+    return false;
+  }
+
+  std::map<std::uint64_t, std::string> messages;
+
+  for (std::uint64_t i = 0; i < numberOfMessages; ++i)
+  {
+    std::uint64_t frame = 0;
+    std::uint64_t length = 0;
+
+    if (!ReadValue(m_File, frame) || !ReadValue(m_File, length) || length > m_FileSize - indexOffset)
+    {
+      m_File.clear();
+      return false;
+    }
+
+    std::string message(length, '\0');
+
+    if (!m_File.read(&message[0], length))
+    {
+      m_File.clear();
+      return false;
+    }
+
+    messages[frame] = message;
+  }
+
+  m_Index.swap(index);
+  m_Messages.swap(messages);
+
+  return true;
+}
+
+void mitk::USImageRecordingReader::RebuildIndex()
+{
+  m_Index.clear();
+  m_Messages.clear();
+
+  if (0 == m_Header.Dimension)
+    return;
+
+  std::uint64_t offset = sizeof(USImageRecordingFormat::FileHeader);
+  std::vector<double> timestamps;
+
+  while (offset + sizeof(USImageRecordingFormat::ChunkHeader) <= m_FileSize)
+  {
+    USImageRecordingFormat::ChunkHeader header;
+    m_File.seekg(offset, std::ios::beg);
+
+    if (!ReadValue(m_File, header) || USImageRecordingFormat::ChunkMarker != header.Marker)
+      break;
+
+    const auto dataOffset = offset + sizeof(header) + header.NumberOfFrames * sizeof(double);
+
+    // The last chunk may be incomplete
+    if (dataOffset > m_FileSize || header.StoredSize > m_FileSize - dataOffset)
+      break;
+
+    timestamps.resize(header.NumberOfFrames);
+
+    if (!m_File.read(reinterpret_cast<char *>(timestamps.data()), timestamps.size() * sizeof(double)))
+      break;
+
+    for (std::uint32_t i = 0; i < header.NumberOfFrames; ++i)
+      m_Index.push_back({ timestamps[i], offset, i });
+
+    offset = dataOffset + header.StoredSize;
+  }
+
+  m_File.clear();
+}
+
+std::size_t mitk::USImageRecordingReader::GetNumberOfFrames() const
+{
+  return m_Index.size();
+}
+
+void mitk::USImageRecordingReader::CheckFrame(std::size_t frame) const
+{
+  if (frame >= m_Index.size())
+    mitkThrow() << "Frame " << frame << " does not exist, the recording has " << m_Index.size() << " frames.";
+}
+
+double mitk::USImageRecordingReader::GetTimestamp(std::size_t frame) const
+{
+  this->CheckFrame(frame);
+  return m_Index[frame].Timestamp;
+}
+
+std::string mitk::USImageRecordingReader::GetFrameMessage(std::size_t frame) const
+{
+  this->CheckFrame(frame);
+
+  const auto iter = m_Messages.find(frame);
+  return iter != m_Messages.end() ? iter->second : std::string();
+}
+
+std::size_t mitk::USImageRecordingReader::FindFrame(double timestamp) const
+{
+  const auto iter = std::upper_bound(m_Index.begin(), m_Index.end(), timestamp,
+    [](double value, const USImageRecordingFormat::FrameIndexEntry &entry) { return value < entry.Timestamp; });
+
+  return iter != m_Index.begin() ? static_cast<std::size_t>(iter - m_Index.begin()) - 1 : 0;
+}
+
+void mitk::USImageRecordingReader::ReadChunk(std::uint64_t offset)
+{
+  if (offset == m_ChunkOffset)
+    return;
+
+  m_ChunkOffset = NoChunk;
+
+  USImageRecordingFormat::ChunkHeader header;
+  m_File.seekg(offset, std::ios::beg);
+
+  if (!ReadValue(m_File, header) || USImageRecordingFormat::ChunkMarker != header.Marker)
+  {
+    m_File.clear();
+    mitkThrow() << "Recording contains no chunk at position " << offset << ".";
+  }
+
+  // The sizes in the header are checked before anything is allocated, so that a damaged or manipulated
+  // file cannot request more memory than the chunk can hold.
+  const bool isCompressed = static_cast<std::uint32_t>(USImageRecordingFormat::ChunkCodec::LZ4) == header.Codec;
+  const std::uint64_t timestampsOffset = offset + sizeof(header);
+  const std::uint64_t timestampsSize = std::uint64_t(header.NumberOfFrames) * sizeof(double);
+
+  if (0 == m_FrameSize || timestampsOffset > m_FileSize || timestampsSize > m_FileSize - timestampsOffset ||
+      header.StoredSize > m_FileSize - timestampsOffset - timestampsSize ||
+      header.NumberOfFrames > std::numeric_limits<std::uint64_t>::max() / m_FrameSize)
+  {
+    mitkThrow() << "The chunk at position " << offset << " exceeds the recording.";
+  }
+
+  const std::uint64_t size = header.NumberOfFrames * m_FrameSize;
+
+  // Raw chunks store exactly the frame data. LZ4 chunks are only written for chunks up to
+  // LZ4_MAX_INPUT_SIZE and LZ4 cannot expand the stored data by more than a factor of 255.
+  if (isCompressed ? size > static_cast<std::uint64_t>(LZ4_MAX_INPUT_SIZE) || size / 255 > header.StoredSize
+                   : size != header.StoredSize)
+  {
+    mitkThrow() << "The chunk at position " << offset << " has an invalid size.";
+  }
+
+  m_File.seekg(timestampsSize, std::ios::cur);
+  m_Chunk.resize(size);
+
+  if (isCompressed)
+  {
+    m_CompressedChunk.resize(header.StoredSize);
+
+    if (!m_File.read(m_CompressedChunk.data(), m_CompressedChunk.size()) ||
+        static_cast<int>(size) != LZ4_decompress_safe(m_CompressedChunk.data(), m_Chunk.data(), static_cast<int>(header.StoredSize), static_cast<int>(size)))
+    {
+      m_File.clear();
+      mitkThrow() << "Cannot decompress the chunk at position " << offset << ".";
+    }
+  }
+  else if (!m_File.read(m_Chunk.data(), size))
+  {
+    m_File.clear();
+    mitkThrow() << "Cannot read the chunk at position " << offset << ".";
+  }
+
+  m_ChunkOffset = offset;
+}
+
+void mitk::USImageRecordingReader::CopyFrame(std::size_t frame, void *target)
+{
+  const auto &entry = m_Index[frame];
+  this->ReadChunk(entry.ChunkOffset);
+
+  if (std::uint64_t(entry.FrameInChunk + 1) * m_FrameSize > m_Chunk.size())
+    mitkThrow() << "Frame " << frame << " is not part of its chunk.";
+
+  std::memcpy(target, m_Chunk.data() + entry.FrameInChunk * m_FrameSize, m_FrameSize);
+}
+
+mitk::AffineTransform3D::Pointer mitk::USImageRecordingReader::CreateFrameTransform() const
+{
+  auto transform = AffineTransform3D::New();
+  AffineTransform3D::MatrixType matrix;
+  AffineTransform3D::OutputVectorType offset;
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    for (unsigned int j = 0; j < 3; ++j)
+      matrix[i][j] = m_Header.Matrix[3 * i + j];
+
+    offset[i] = m_Header.Offset[i];
+  }
+
+  transform->SetMatrix(matrix);
+  transform->SetOffset(offset);
+
+  return transform;
+}
+
+mitk::Image::Pointer mitk::USImageRecordingReader::GetFrame(std::size_t frame)
+{
+  this->CheckFrame(frame);
+
+  auto image = Image::New();
+  image->Initialize(*m_PixelType, m_Header.Dimension, m_Header.Dimensions);
+
+  {
+    ImageWriteAccessor accessor(image, image->GetVolumeData(0));
+    this->CopyFrame(frame, accessor.GetData());
+  }
+
+  image->GetGeometry()->SetIndexToWorldTransform(this->CreateFrameTransform());
+
+  return image;
+}
+
+mitk::Image::Pointer mitk::USImageRecordingReader::GetImageSeries(std::size_t firstFrame, std::size_t numberOfFrames)
+{
+  if (0 == numberOfFrames)
+    mitkThrow() << "Cannot create an image series without frames.";
+
+  this->CheckFrame(firstFrame);
+  this->CheckFrame(firstFrame + numberOfFrames - 1);
+
+  std::array<unsigned int, 4> dimensions = { { m_Header.Dimensions[0], m_Header.Dimensions[1], m_Header.Dimensions[2],
+                                               static_cast<unsigned int>(numberOfFrames) } };
+
+  auto image = Image::New();
+  image->Initialize(*m_PixelType, 4, dimensions.data());
+
+  for (std::size_t t = 0; t < numberOfFrames; ++t)
+  {
+    ImageWriteAccessor accessor(image, image->GetVolumeData(static_cast<int>(t)));
+    this->CopyFrame(firstFrame + t, accessor.GetData());
+  }
+
+  // Each time step lasts until the next frame, the last one as long as its predecessor
+  auto frameGeometry = image->GetGeometry()->Clone();
+  frameGeometry->SetIndexToWorldTransform(this->CreateFrameTransform());
+  auto timeGeometry = ArbitraryTimeGeometry::New();
+  timeGeometry->ClearAllGeometries();
+  timeGeometry->ReserveSpaceForGeometries(numberOfFrames);
+
+  for (std::size_t t = 0; t < numberOfFrames; ++t)
+  {
+    const auto minimumTimePoint = m_Index[firstFrame + t].Timestamp;
+    auto maximumTimePoint = minimumTimePoint + 1.0;
+
+    if (t + 1 < numberOfFrames)
+      maximumTimePoint = m_Index[firstFrame + t + 1].Timestamp;
+    else if (1 < numberOfFrames)
+      maximumTimePoint = minimumTimePoint + minimumTimePoint - m_Index[firstFrame + t - 1].Timestamp;
+
+    timeGeometry->AppendNewTimeStepClone(frameGeometry, minimumTimePoint, std::max(maximumTimePoint, minimumTimePoint));
+  }
+
+  image->SetTimeGeometry(timeGeometry);
+
+  return image;
+}
+
+mitk::Image::Pointer mitk::USImageRecordingReader::GetImageSeries()
+{
+  return this->GetImageSeries(0, this->GetNumberOfFrames());
+}
@@ -0,0 +1,110 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkUSImageRecordingReader_h
+#define mitkUSImageRecordingReader_h
+
+#include <MitkUSExports.h>
+#include <mitkImage.h>
+#include "mitkUSImageRecordingFormat.h"
+
+#include <itkObject.h>
+
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace mitk
+{
+  /** \brief Random access to the frames of a recording written by mitk::USImageRecorder.
+   *
+   * Open() only reads the header and the timestamp index. Frames are decompressed on demand chunk by
+   * chunk; the last decompressed chunk is kept, so playing back consecutive frames decompresses every
+   * chunk once. Recordings without index (e.g. if the application crashed during recording) are
+   * indexed by walking the chunks; their messages cannot be recovered.
+   *
+   * The reader is not thread-safe.
+   *
+   * \ingroup US
+   */
+  class MITKUS_EXPORT USImageRecordingReader : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(USImageRecordingReader, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** \brief Opens the recording and reads its index.
+     *  \exception mitk::Exception if the file cannot be read or is not a recording.
+     */
+    void Open(const std::string &filename);
+    void Close();
+
+    std::size_t GetNumberOfFrames() const;
+
+    /** \brief Timestamp of the frame as passed to USImageRecorder::AddFrame(). */
+    double GetTimestamp(std::size_t frame) const;
+
+    /** \brief Message attached to the frame, empty if there is none.
+     *
+     * Recordings without index (see USImageRecordingFormat) have no messages.
+     */
+    std::string GetFrameMessage(std::size_t frame) const;
+
+    /** \brief Last frame recorded at or before the timestamp (the first frame for earlier timestamps). */
+    std::size_t FindFrame(double timestamp) const;
+
+    /** \brief Returns the frame as 2D or 3D image with the geometry of the recorded frames.
+     *  \exception mitk::Exception if the frame does not exist or cannot be decompressed.
+     */
+    Image::Pointer GetFrame(std::size_t frame);
+
+    /** \brief Returns the frames as one image with a time step per frame (3D+t).
+     *
+     * The time geometry uses the timestamps of the frames as time bounds.
+     *  \exception mitk::Exception if a frame does not exist or cannot be decompressed.
+     */
+    Image::Pointer GetImageSeries(std::size_t firstFrame, std::size_t numberOfFrames);
+    Image::Pointer GetImageSeries();
+
+  protected:
+    USImageRecordingReader();
+    ~USImageRecordingReader() override;
+
+  private:
+    bool ReadIndex();
+    void RebuildIndex();
+
+    /** Decompresses the chunk at the offset into m_Chunk, unless it is the cached chunk. */
+    void ReadChunk(std::uint64_t offset);
+    void CheckFrame(std::size_t frame) const;
+    void CopyFrame(std::size_t frame, void *target);
+    AffineTransform3D::Pointer CreateFrameTransform() const;
+
+    std::ifstream m_File;
+    std::uint64_t m_FileSize;
+    USImageRecordingFormat::FileHeader m_Header;
+    std::unique_ptr<PixelType> m_PixelType;
+    std::size_t m_FrameSize;
+
+    std::vector<USImageRecordingFormat::FrameIndexEntry> m_Index;
+    std::map<std::uint64_t, std::string> m_Messages;
+
+    static constexpr std::uint64_t NoChunk = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t m_ChunkOffset;
+    std::vector<char> m_Chunk;
+    std::vector<char> m_CompressedChunk;
+  };
+}
+
+#endif
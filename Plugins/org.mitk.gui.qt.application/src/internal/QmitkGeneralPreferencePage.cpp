@@ -16,10 +16,13 @@ found in the LICENSE file.
 
 #include <QCheckBox>
 #include <QFormLayout>
+#include <QSpinBox>
 
 #include <berryIPreferencesService.h>
 #include <berryPlatform.h>
 
+#include <mitkUndoController.h>
+
 QmitkGeneralPreferencePage::QmitkGeneralPreferencePage()
   : m_MainControl(nullptr)
 {
@@ -41,9 +44,16 @@ void QmitkGeneralPreferencePage::CreateQtControl(QWidget* parent)
   m_GlobalReinitOnNodeDelete = new QCheckBox;
   m_GlobalReinitOnNodeVisibilityChanged = new QCheckBox;
 
+  m_UndoMemoryLimit = new QSpinBox;
+  m_UndoMemoryLimit->setRange(0, 1024 * 1024);
+  m_UndoMemoryLimit->setSuffix(" MB");
+  m_UndoMemoryLimit->setSpecialValueText("Unlimited");
+  m_UndoMemoryLimit->setToolTip("Memory the undo history may occupy before older steps are swapped to disk");
+
   auto formLayout = new QFormLayout;
   formLayout->addRow("&Call global reinit if node is deleted", m_GlobalReinitOnNodeDelete);
   formLayout->addRow("&Call global reinit if node visibility is changed", m_GlobalReinitOnNodeVisibilityChanged);
+  formLayout->addRow("&Undo memory limit", m_UndoMemoryLimit);
 
   m_MainControl->setLayout(formLayout);
   Update();
@@ -58,6 +68,9 @@ bool QmitkGeneralPreferencePage::PerformOk()
 {
   m_GeneralPreferencesNode->PutBool("Call global reinit if node is deleted", m_GlobalReinitOnNodeDelete->isChecked());
   m_GeneralPreferencesNode->PutBool("Call global reinit if node visibility is changed", m_GlobalReinitOnNodeVisibilityChanged->isChecked());
+  m_GeneralPreferencesNode->PutInt("Undo memory limit", m_UndoMemoryLimit->value());
+
+  mitk::UndoController::SetUndoMemoryLimit(static_cast<std::size_t>(m_UndoMemoryLimit->value()) * 1024 * 1024);
 
   return true;
 }
@@ -71,4 +84,5 @@ void QmitkGeneralPreferencePage::Update()
 {
   m_GlobalReinitOnNodeDelete->setChecked(m_GeneralPreferencesNode->GetBool("Call global reinit if node is deleted", true));
   m_GlobalReinitOnNodeVisibilityChanged->setChecked(m_GeneralPreferencesNode->GetBool("Call global reinit if node visibility is changed", false));
+  m_UndoMemoryLimit->setValue(m_GeneralPreferencesNode->GetInt("Undo memory limit", 0));
 }
@@ -18,6 +18,7 @@ found in the LICENSE file.
 
 class QWidget;
 class QCheckBox;
+class QSpinBox;
 
 class QmitkGeneralPreferencePage : public QObject, public berry::IQtPreferencePage
 {
@@ -64,6 +65,7 @@ protected:
 
     QCheckBox* m_GlobalReinitOnNodeDelete;
     QCheckBox* m_GlobalReinitOnNodeVisibilityChanged;
+    QSpinBox* m_UndoMemoryLimit;
 
     berry::IPreferences::Pointer m_GeneralPreferencesNode;
 };
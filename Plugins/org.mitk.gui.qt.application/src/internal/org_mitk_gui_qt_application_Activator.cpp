@@ -12,6 +12,7 @@ found in the LICENSE file.
 
 #include "org_mitk_gui_qt_application_Activator.h"
 
+#include "QmitkDataNodeGlobalReinitAction.h"
 #include "QmitkGeneralPreferencePage.h"
 #include "QmitkEditorsPreferencePage.h"
 
@@ -19,6 +20,10 @@ found in the LICENSE file.
 
 #include "QmitkShowPreferencePageHandler.h"
 
+#include <mitkUndoController.h>
+
+#include <berryPlatform.h>
+
 namespace mitk
 {
 
@@ -38,6 +43,14 @@ namespace mitk
 
     this->m_PrefServiceTracker.reset(new ctkServiceTracker<berry::IPreferencesService*>(context));
     this->m_PrefServiceTracker->open();
+
+    // Apply the undo memory limit of the general preferences (in MB, see QmitkGeneralPreferencePage).
+    berry::IPreferencesService* prefService = berry::Platform::GetPreferencesService();
+    if (nullptr != prefService)
+    {
+      auto generalPreferences = prefService->GetSystemPreferences()->Node(QmitkDataNodeGlobalReinitAction::ACTION_ID);
+      mitk::UndoController::SetUndoMemoryLimit(static_cast<std::size_t>(generalPreferences->GetInt("Undo memory limit", 0)) * 1024 * 1024);
+    }
   }
 
   void org_mitk_gui_qt_application_Activator::stop(ctkPluginContext* context)
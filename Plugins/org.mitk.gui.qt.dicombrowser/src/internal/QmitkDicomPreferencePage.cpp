@@ -17,6 +17,8 @@ found in the LICENSE file.
 #include <berryPlatform.h>
 #include "mitkPluginActivator.h"
 
+#include <mitkBaseDICOMReaderService.h>
+
 #include <QLabel>
 #include <QPushButton>
 #include <QFormLayout>
@@ -71,6 +73,12 @@ void QmitkDicomPreferencePage::CreateQtControl(QWidget* parent)
   displayOptionsLayout->addWidget(m_PathDefault);
 
   formLayout->addRow("Local database path:",displayOptionsLayout);
+
+  m_TagScanIndexEdit = new QLineEdit(m_MainControl);
+  m_TagScanIndexEdit->setToolTip("Index of the tags scanned when DICOM files are loaded. Files that did not change "
+                                 "since they were loaded the last time are not scanned again. Leave empty to disable the index.");
+  formLayout->addRow("Tag scan index file:", m_TagScanIndexEdit);
+
   m_MainControl->setLayout(formLayout);
 
   connect(m_PathDefault, SIGNAL(clicked()), this, SLOT(DefaultButtonPushed()));
@@ -91,6 +99,8 @@ void QmitkDicomPreferencePage::PerformCancel()
 bool QmitkDicomPreferencePage::PerformOk()
 {
   m_DicomPreferencesNode->Put("default dicom path",m_PathEdit->text());
+  m_DicomPreferencesNode->Put("tag scan index file", m_TagScanIndexEdit->text());
+  mitk::BaseDICOMReaderService::SetTagScanIndexFileName(m_TagScanIndexEdit->text().toStdString());
   return true;
 }
 
@@ -98,6 +108,7 @@ void QmitkDicomPreferencePage::Update()
 {
   QString path = m_DicomPreferencesNode->Get("default dicom path", CreateDefaultPath());
   m_PathEdit->setText(path);
+  m_TagScanIndexEdit->setText(m_DicomPreferencesNode->Get("tag scan index file", mitk::PluginActivator::GetDefaultTagScanIndexFileName()));
 }
 
 void QmitkDicomPreferencePage::DefaultButtonPushed()
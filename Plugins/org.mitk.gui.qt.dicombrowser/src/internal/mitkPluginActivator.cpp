@@ -15,6 +15,16 @@ found in the LICENSE file.
 #include "QmitkDicomPreferencePage.h"
 #include <usModuleInitialization.h>
 
+#include <mitkBaseDICOMReaderService.h>
+
+#include <berryIPreferences.h>
+#include <berryIPreferencesService.h>
+#include <berryPlatform.h>
+
+#include <ctkPluginContext.h>
+
+#include <QFileInfo>
+
 US_INITIALIZE_MODULE
 
 namespace mitk {
@@ -25,6 +35,14 @@ void PluginActivator::start(ctkPluginContext* context)
   BERRY_REGISTER_EXTENSION_CLASS(QmitkDicomBrowser, context)
   BERRY_REGISTER_EXTENSION_CLASS(QmitkDicomPreferencePage, context)
   pluginContext = context;
+
+  auto prefService = berry::Platform::GetPreferencesService();
+
+  if (nullptr != prefService)
+  {
+    auto tagScanIndexFileName = prefService->GetSystemPreferences()->Node("/org.mitk.views.dicomreader")->Get("tag scan index file", GetDefaultTagScanIndexFileName());
+    BaseDICOMReaderService::SetTagScanIndexFileName(tagScanIndexFileName.toStdString());
+  }
 }
 
 void PluginActivator::stop(ctkPluginContext* context)
@@ -36,4 +54,9 @@ ctkPluginContext* PluginActivator::getContext()
 {
     return pluginContext;
 }
+
+QString PluginActivator::GetDefaultTagScanIndexFileName()
+{
+  return pluginContext->getDataFile("tagscan.index").absoluteFilePath();
+}
 }
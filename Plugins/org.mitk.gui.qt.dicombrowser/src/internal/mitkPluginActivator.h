@@ -29,6 +29,9 @@ public:
   void start(ctkPluginContext* context) override;
   void stop(ctkPluginContext* context) override;
   static ctkPluginContext* getContext();
+
+  /** The tag scan index is kept in the data directory of the plugin, unless the preferences name another file.*/
+  static QString GetDefaultTagScanIndexFileName();
 private:
     static ctkPluginContext* pluginContext;
 }; // PluginActivator